@@ -51,4 +51,13 @@
 
 #define MBEDTLS_AES_ROM_TABLES
 
+/* The Simba SSL module counts the memory allocated by mbedTLS, and
+   optionally allocates the record buffers from a pool. */
+#define MBEDTLS_PLATFORM_MEMORY
+
+#include <config.h>
+#include "config_default.h"
+
+#define MBEDTLS_SSL_MAX_CONTENT_LEN CONFIG_SSL_RECORD_SIZE_MAX
+
 #endif
@@ -37,20 +37,25 @@
 // Enables/disable memory read caching of nucleus file system operations.
 // If enabled, memory area must be provided for cache in SPIFFS_mount.
 #ifndef  SPIFFS_CACHE
-#define SPIFFS_CACHE                    1
+#define SPIFFS_CACHE                    CONFIG_SPIFFS_CACHE
 #endif
 #if SPIFFS_CACHE
 // Enables memory write caching for file descriptors in hydrogen
 #ifndef  SPIFFS_CACHE_WR
-#define SPIFFS_CACHE_WR                 1
+#define SPIFFS_CACHE_WR                 CONFIG_SPIFFS_CACHE_WRITE
 #endif
 
 // Enable/disable statistics on caching. Debug/test purpose only.
 #ifndef  SPIFFS_CACHE_STATS
-#define SPIFFS_CACHE_STATS              1
+#define SPIFFS_CACHE_STATS              CONFIG_SPIFFS_CACHE_STATS
 #endif
 #endif
 
+// Enables/disable an in memory object index header lookup table. If
+// enabled, memory for it may be given with SPIFFS_set_lookup_index.
+#ifndef SPIFFS_LOOKUP_INDEX
+#define SPIFFS_LOOKUP_INDEX             CONFIG_SPIFFS_LOOKUP_INDEX
+#endif
 // Always check header of each accessed page to ensure consistent state.
 // If enabled it will increase number of reads, will increase flash.
 #ifndef SPIFFS_PAGE_CHECK
@@ -80,11 +80,23 @@ s32_t spiffs_mount(spiffs *fs, spiffs_config *config, u8_t *work,
     void *cache, u32_t cache_size,
     spiffs_check_callback check_cb_f) {
   void *user_data;
+#if SPIFFS_LOOKUP_INDEX
+  struct spiffs_lookup_index_entry_t *lookup_index_p;
+  u32_t lookup_index_size;
+#endif
   SPIFFS_LOCK(fs);
   user_data = fs->user_data;
+#if SPIFFS_LOOKUP_INDEX
+  lookup_index_p = fs->lookup_index_p;
+  lookup_index_size = fs->lookup_index_size;
+#endif
   memset(fs, 0, sizeof(spiffs));
   memcpy(&fs->cfg, config, sizeof(spiffs_config));
   fs->user_data = user_data;
+#if SPIFFS_LOOKUP_INDEX
+  fs->lookup_index_p = lookup_index_p;
+  fs->lookup_index_size = lookup_index_size;
+#endif
   fs->block_count = SPIFFS_CFG_PHYS_SZ(fs) / SPIFFS_CFG_LOG_BLOCK_SZ(fs);
   fs->work = &work[0];
   fs->lu_work = &work[SPIFFS_CFG_LOG_PAGE_SZ(fs)];
@@ -129,6 +141,11 @@ s32_t spiffs_mount(spiffs *fs, spiffs_config *config, u8_t *work,
   res = spiffs_obj_lu_scan(fs);
   SPIFFS_API_CHECK_RES_UNLOCK(fs, res);
 
+#if SPIFFS_LOOKUP_INDEX
+  res = spiffs_lookup_index_build(fs);
+  SPIFFS_API_CHECK_RES_UNLOCK(fs, res);
+#endif
+
   SPIFFS_DBG("page index byte len:         %i\n", SPIFFS_CFG_LOG_PAGE_SZ(fs));
   SPIFFS_DBG("object lookup pages:         %i\n", SPIFFS_OBJ_LOOKUP_PAGES(fs));
   SPIFFS_DBG("page pages per block:        %i\n", SPIFFS_PAGES_PER_BLOCK(fs));
@@ -984,6 +1001,13 @@ s32_t spiffs_check(spiffs *fs) {
 
   res = spiffs_obj_lu_scan(fs);
 
+#if SPIFFS_LOOKUP_INDEX
+  // the check may have moved or deleted pages without events
+  if (res == SPIFFS_OK) {
+    res = spiffs_lookup_index_build(fs);
+  }
+#endif
+
   SPIFFS_UNLOCK(fs);
   return res;
 #endif // SPIFFS_READ_ONLY
@@ -1103,6 +1127,22 @@ s32_t spiffs_set_file_callback_func(spiffs *fs, spiffs_file_callback cb_func) {
   return 0;
 }
 
+#if SPIFFS_LOOKUP_INDEX
+s32_t spiffs_set_lookup_index(spiffs *fs, void *buf, u32_t size) {
+  s32_t res = SPIFFS_OK;
+  SPIFFS_LOCK(fs);
+  fs->lookup_index_p = (struct spiffs_lookup_index_entry_t *)buf;
+  fs->lookup_index_size = (buf == 0 ? 0 : size / sizeof(struct spiffs_lookup_index_entry_t));
+  fs->lookup_index_length = 0;
+  fs->lookup_index_valid = 0;
+  if (SPIFFS_CHECK_CFG(fs) && SPIFFS_CHECK_MOUNT(fs)) {
+    res = spiffs_lookup_index_build(fs);
+  }
+  SPIFFS_UNLOCK(fs);
+  return res;
+}
+#endif
+
 #if SPIFFS_TEST_VISUALISATION
 s32_t spiffs_vis(spiffs *fs) {
   s32_t res = SPIFFS_OK;
@@ -522,6 +522,222 @@ static s32_t spiffs_obj_lu_find_id_and_span_v(
   }
 }
 
+#if SPIFFS_LOOKUP_INDEX
+
+// The lookup index is a table in ram with the object index header
+// page and a name hash of each object, kept up to date by the object
+// event callback. Lookups in the table are verified by reading the
+// page header. If the table is found to be stale, or is too small for
+// all objects, it is invalidated and lookups fall back to scanning
+// the object lookup pages.
+
+static u16_t spiffs_lookup_index_hash(const u8_t *name) {
+  // FNV-1a folded to 16 bits
+  u32_t hash = 2166136261UL;
+  u32_t i;
+  for (i = 0; i < SPIFFS_OBJ_NAME_LEN && name[i] != '\0'; i++) {
+    hash ^= name[i];
+    hash *= 16777619UL;
+  }
+  return (u16_t)(hash ^ (hash >> 16));
+}
+
+static struct spiffs_lookup_index_entry_t *spiffs_lookup_index_find(
+    spiffs *fs,
+    spiffs_obj_id obj_id) {
+  u32_t i;
+  for (i = 0; i < fs->lookup_index_length; i++) {
+    if (fs->lookup_index_p[i].obj_id == obj_id) {
+      return &fs->lookup_index_p[i];
+    }
+  }
+  return 0;
+}
+
+// Add or update the entry of given object, reading its name from
+// given object index header page
+static s32_t spiffs_lookup_index_set(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_page_ix pix) {
+  s32_t res;
+  spiffs_page_object_ix_header objix_hdr;
+  struct spiffs_lookup_index_entry_t *entry_p;
+  res = _spiffs_rd(fs, SPIFFS_OP_T_OBJ_LU2 | SPIFFS_OP_C_READ,
+      0, SPIFFS_PAGE_TO_PADDR(fs, pix), sizeof(spiffs_page_object_ix_header), (u8_t *)&objix_hdr);
+  SPIFFS_CHECK_RES(res);
+  obj_id &= ~SPIFFS_OBJ_ID_IX_FLAG;
+  entry_p = spiffs_lookup_index_find(fs, obj_id);
+  if (entry_p == 0) {
+    if (fs->lookup_index_length == fs->lookup_index_size) {
+      SPIFFS_DBG("lookup index: full, invalidating\n");
+      fs->lookup_index_valid = 0;
+      return SPIFFS_OK;
+    }
+    entry_p = &fs->lookup_index_p[fs->lookup_index_length];
+    fs->lookup_index_length++;
+    entry_p->obj_id = obj_id;
+  }
+  entry_p->pix = pix;
+  entry_p->name_hash = spiffs_lookup_index_hash(objix_hdr.name);
+  return SPIFFS_OK;
+}
+
+static void spiffs_lookup_index_event(
+    spiffs *fs,
+    int ev,
+    spiffs_obj_id obj_id_raw,
+    spiffs_span_ix spix,
+    spiffs_page_ix pix) {
+  struct spiffs_lookup_index_entry_t *entry_p;
+  if (!fs->lookup_index_valid || spix != 0 || (obj_id_raw & SPIFFS_OBJ_ID_IX_FLAG) == 0) {
+    return;
+  }
+  if (ev == SPIFFS_EV_IX_NEW || ev == SPIFFS_EV_IX_UPD) {
+    if (spiffs_lookup_index_set(fs, obj_id_raw, pix) != SPIFFS_OK) {
+      fs->lookup_index_valid = 0;
+    }
+  } else if (ev == SPIFFS_EV_IX_DEL) {
+    entry_p = spiffs_lookup_index_find(fs, obj_id_raw & ~SPIFFS_OBJ_ID_IX_FLAG);
+    // only remove the entry if its page is deleted, not a stale
+    // copy of it
+    if (entry_p != 0 && entry_p->pix == pix) {
+      fs->lookup_index_length--;
+      *entry_p = fs->lookup_index_p[fs->lookup_index_length];
+    }
+  }
+}
+
+static s32_t spiffs_lookup_index_build_v(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_block_ix bix,
+    int ix_entry,
+    const void *user_const_p,
+    void *user_var_p) {
+  (void)user_const_p;
+  (void)user_var_p;
+  s32_t res;
+  spiffs_page_header ph;
+  spiffs_page_ix pix = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PIX(fs, bix, ix_entry);
+  if (obj_id == SPIFFS_OBJ_ID_FREE || obj_id == SPIFFS_OBJ_ID_DELETED ||
+      (obj_id & SPIFFS_OBJ_ID_IX_FLAG) == 0) {
+    return SPIFFS_VIS_COUNTINUE;
+  }
+  res = _spiffs_rd(fs, SPIFFS_OP_T_OBJ_LU2 | SPIFFS_OP_C_READ,
+      0, SPIFFS_PAGE_TO_PADDR(fs, pix), sizeof(spiffs_page_header), (u8_t *)&ph);
+  SPIFFS_CHECK_RES(res);
+  if (ph.span_ix == 0 &&
+      (ph.flags & (SPIFFS_PH_FLAG_DELET | SPIFFS_PH_FLAG_FINAL | SPIFFS_PH_FLAG_IXDELE)) ==
+          (SPIFFS_PH_FLAG_DELET | SPIFFS_PH_FLAG_IXDELE)) {
+    res = spiffs_lookup_index_set(fs, obj_id, pix);
+    SPIFFS_CHECK_RES(res);
+    if (!fs->lookup_index_valid) {
+      return SPIFFS_VIS_END;
+    }
+  }
+  return SPIFFS_VIS_COUNTINUE;
+}
+
+// Builds the lookup index by scanning all object lookup pages
+s32_t spiffs_lookup_index_build(
+    spiffs *fs) {
+  s32_t res;
+  fs->lookup_index_length = 0;
+  fs->lookup_index_valid = 0;
+  if (fs->lookup_index_p == 0) {
+    return SPIFFS_OK;
+  }
+  fs->lookup_index_valid = 1;
+  res = spiffs_obj_lu_find_entry_visitor(fs,
+      0,
+      0,
+      SPIFFS_VIS_NO_WRAP,
+      0,
+      spiffs_lookup_index_build_v,
+      0,
+      0,
+      0,
+      0);
+  if (res == SPIFFS_VIS_END) {
+    res = SPIFFS_OK;
+  }
+  if (res != SPIFFS_OK) {
+    fs->lookup_index_valid = 0;
+  }
+  SPIFFS_DBG("lookup index: %i objects, valid %i\n", fs->lookup_index_length, fs->lookup_index_valid);
+  return res;
+}
+
+// Finds the object index header page of given object in the lookup
+// index. Invalidates the index if it is found to be stale.
+static s32_t spiffs_lookup_index_find_by_id(
+    spiffs *fs,
+    spiffs_obj_id obj_id,
+    spiffs_page_ix *pix) {
+  s32_t res;
+  spiffs_page_header ph;
+  struct spiffs_lookup_index_entry_t *entry_p;
+  entry_p = spiffs_lookup_index_find(fs, obj_id & ~SPIFFS_OBJ_ID_IX_FLAG);
+  if (entry_p == 0) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  res = _spiffs_rd(fs, SPIFFS_OP_T_OBJ_LU2 | SPIFFS_OP_C_READ,
+      0, SPIFFS_PAGE_TO_PADDR(fs, entry_p->pix), sizeof(spiffs_page_header), (u8_t *)&ph);
+  SPIFFS_CHECK_RES(res);
+  if (ph.obj_id != obj_id || ph.span_ix != 0) {
+    fs->lookup_index_valid = 0;
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  if ((ph.flags & (SPIFFS_PH_FLAG_FINAL | SPIFFS_PH_FLAG_DELET | SPIFFS_PH_FLAG_USED | SPIFFS_PH_FLAG_IXDELE)) !=
+      (SPIFFS_PH_FLAG_DELET | SPIFFS_PH_FLAG_IXDELE)) {
+    return SPIFFS_ERR_NOT_FOUND;
+  }
+  if (pix) {
+    *pix = entry_p->pix;
+  }
+  return SPIFFS_OK;
+}
+
+// Finds the object index header page of the object with given name
+// in the lookup index. Invalidates the index if it is found to be
+// stale.
+static s32_t spiffs_lookup_index_find_by_name(
+    spiffs *fs,
+    const u8_t name[SPIFFS_OBJ_NAME_LEN],
+    spiffs_page_ix *pix) {
+  s32_t res;
+  u32_t i;
+  u16_t name_hash = spiffs_lookup_index_hash(name);
+  spiffs_page_object_ix_header objix_hdr;
+  struct spiffs_lookup_index_entry_t *entry_p;
+  for (i = 0; i < fs->lookup_index_length; i++) {
+    entry_p = &fs->lookup_index_p[i];
+    if (entry_p->name_hash != name_hash) {
+      continue;
+    }
+    res = _spiffs_rd(fs, SPIFFS_OP_T_OBJ_LU2 | SPIFFS_OP_C_READ,
+        0, SPIFFS_PAGE_TO_PADDR(fs, entry_p->pix), sizeof(spiffs_page_object_ix_header), (u8_t *)&objix_hdr);
+    SPIFFS_CHECK_RES(res);
+    if (objix_hdr.p_hdr.obj_id != (entry_p->obj_id | SPIFFS_OBJ_ID_IX_FLAG) ||
+        objix_hdr.p_hdr.span_ix != 0) {
+      fs->lookup_index_valid = 0;
+      return SPIFFS_ERR_NOT_FOUND;
+    }
+    if ((objix_hdr.p_hdr.flags & (SPIFFS_PH_FLAG_DELET | SPIFFS_PH_FLAG_FINAL | SPIFFS_PH_FLAG_IXDELE)) ==
+            (SPIFFS_PH_FLAG_DELET | SPIFFS_PH_FLAG_IXDELE) &&
+        strcmp((const char*)name, (char*)objix_hdr.name) == 0) {
+      if (pix) {
+        *pix = entry_p->pix;
+      }
+      return SPIFFS_OK;
+    }
+  }
+  return SPIFFS_ERR_NOT_FOUND;
+}
+
+#endif // SPIFFS_LOOKUP_INDEX
+
 // Find object lookup entry containing given id and span index
 // Iterate over object lookup pages in each block until a given object id entry is found
 s32_t spiffs_obj_lu_find_id_and_span(
@@ -534,6 +750,19 @@ s32_t spiffs_obj_lu_find_id_and_span(
   spiffs_block_ix bix;
   int entry;
 
+#if SPIFFS_LOOKUP_INDEX
+  if (fs->lookup_index_valid &&
+      (obj_id & SPIFFS_OBJ_ID_IX_FLAG) &&
+      spix == 0 &&
+      exclusion_pix == 0) {
+    res = spiffs_lookup_index_find_by_id(fs, obj_id, pix);
+    // fall back to scanning if the index was found stale
+    if (fs->lookup_index_valid) {
+      return res;
+    }
+  }
+#endif
+
   res = spiffs_obj_lu_find_entry_visitor(fs,
       fs->cursor_block_ix,
       fs->cursor_obj_lu_entry,
@@ -905,6 +1134,10 @@ void spiffs_cb_object_event(
     }
   }
 
+#if SPIFFS_LOOKUP_INDEX
+  spiffs_lookup_index_event(fs, ev, obj_id_raw, spix, new_pix);
+#endif
+
   // callback to user if object index header
   if (fs->file_cb_f && spix == 0 && (obj_id_raw & SPIFFS_OBJ_ID_IX_FLAG)) {
     spiffs_fileop_type op;
@@ -1462,6 +1695,16 @@ s32_t spiffs_object_find_object_index_header_by_name(
   spiffs_block_ix bix;
   int entry;
 
+#if SPIFFS_LOOKUP_INDEX
+  if (fs->lookup_index_valid) {
+    res = spiffs_lookup_index_find_by_name(fs, name, pix);
+    // fall back to scanning if the index was found stale
+    if (fs->lookup_index_valid) {
+      return res;
+    }
+  }
+#endif
+
   res = spiffs_obj_lu_find_entry_visitor(fs,
       fs->cursor_block_ix,
       fs->cursor_obj_lu_entry,
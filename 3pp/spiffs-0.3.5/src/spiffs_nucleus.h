@@ -677,6 +677,11 @@ s32_t spiffs_object_find_object_index_header_by_name(
     const u8_t name[SPIFFS_OBJ_NAME_LEN],
     spiffs_page_ix *pix);
 
+#if SPIFFS_LOOKUP_INDEX
+s32_t spiffs_lookup_index_build(
+    spiffs *fs);
+#endif
+
 // ---------------
 
 s32_t spiffs_gc_check(
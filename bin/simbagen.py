@@ -145,6 +145,8 @@ const FAR struct setting_t settings[] = {{
     {{ NULL, 0, 0, 0 }}
 }};
 
+const FAR uint16_t settings_by_name[] = {{ {by_name} }};
+
 const FAR uint8_t settings_default[CONFIG_SETTINGS_AREA_SIZE] = {{{default_data}}};
 """
 
@@ -468,9 +470,18 @@ class Settings(object):
         default_data = ', '.join([str(byte)
                                   for byte in bytearray(self.as_binary())])
 
+        # Indexes of the settings sorted by name, terminated by the
+        # index of the terminating entry.
+        setting_names = list(self.settings.keys())
+        by_name = sorted(range(len(setting_names)),
+                         key=lambda index: setting_names[index])
+        by_name.append(len(setting_names))
+        by_name = ', '.join([str(index) for index in by_name])
+
         return SETTINGS_FMT.format(names='\n'.join(names),
                                    functions='\n'.join(functions),
                                    array='\n'.join(array),
+                                   by_name=by_name,
                                    default_data=default_data)
 
 
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+#
+# Decode a binary log stream written by log_binary_drain() into the
+# same text format as the log module prints.
+#
+
+import sys
+import re
+import argparse
+import struct
+
+
+RECORD_TYPE_INFO = 1
+RECORD_TYPE_STRING = 2
+RECORD_TYPE_ENTRY = 3
+RECORD_TYPE_DROPPED = 4
+
+ENTRY_LEVEL_TRUNCATED = 0x80
+
+LEVELS = ['fatal', 'error', 'warning', 'info', 'debug']
+
+RE_SPECIFIER = re.compile(r'%([-0]?)([0-9]*)(l?)(.)', re.DOTALL)
+
+
+class Info(object):
+
+    def __init__(self, payload):
+        if payload[0:4] != b'slog':
+            raise Exception('Bad binary log stream magic {}.'.format(
+                payload[0:4]))
+
+        self.version = payload[4]
+        self.byte_order = '<' if payload[5] == 1 else '>'
+        self.sizeof_int = payload[6]
+        self.sizeof_long = payload[7]
+        self.sizeof_id = payload[8]
+        self.sizeof_double = payload[9]
+
+    def unpack_integer(self, data, size, signed):
+        fmt = {1: 'b', 2: 'h', 4: 'i', 8: 'q'}[size]
+
+        if not signed:
+            fmt = fmt.upper()
+
+        return struct.unpack(self.byte_order + fmt, data[:size])[0]
+
+    def unpack_id(self, data):
+        return self.unpack_integer(data, self.sizeof_id, False)
+
+
+class Decoder(object):
+
+    def __init__(self):
+        self.info = None
+        self.strings = {}
+
+    def string(self, identity):
+        return self.strings.get(identity, '<unknown 0x{:x}>'.format(identity))
+
+    def format_message(self, fmt, args, truncated):
+        """Format given format string with given raw arguments, the same
+        way as the device would have formatted it.
+
+        """
+
+        info = self.info
+        output = ''
+        pos = 0
+
+        for mo in RE_SPECIFIER.finditer(fmt):
+            flags, width, length, specifier = mo.groups()
+            output += fmt[pos:mo.start()]
+            pos = mo.end()
+
+            if specifier in 'cdiux':
+                if length:
+                    size = info.sizeof_long
+                else:
+                    size = info.sizeof_int
+
+                if len(args) < size:
+                    output += '?'
+                    continue
+
+                value = info.unpack_integer(args,
+                                            size,
+                                            specifier in 'di')
+                args = args[size:]
+
+                if specifier == 'c':
+                    value = chr(value & 0xff)
+                elif specifier == 'x':
+                    value = '{:x}'.format(value & ((1 << (8 * size)) - 1))
+                else:
+                    value = str(value)
+            elif specifier == 'f' and info.sizeof_double > 0:
+                if len(args) < info.sizeof_double:
+                    output += '?'
+                    continue
+
+                fmt_double = {4: 'f', 8: 'd'}[info.sizeof_double]
+                value = struct.unpack(info.byte_order + fmt_double,
+                                      args[:info.sizeof_double])[0]
+                args = args[info.sizeof_double:]
+                value = '{:.6f}'.format(value)
+            elif specifier in 'sS':
+                if len(args) < 1:
+                    output += '?'
+                    continue
+
+                size = args[0]
+                value = args[1:1 + size].decode('ascii', 'replace')
+                args = args[1 + size:]
+            else:
+                output += specifier
+                continue
+
+            width = int(width or '0')
+
+            if flags == '-':
+                value = value.ljust(width)
+            elif flags == '0':
+                if value.startswith('-'):
+                    value = '-' + value[1:].rjust(width - 1, '0')
+                else:
+                    value = value.rjust(width, '0')
+            else:
+                value = value.rjust(width)
+
+            output += value
+
+        output += fmt[pos:]
+
+        if truncated:
+            output += '<truncated>'
+
+        return output
+
+    def decode_entry(self, payload):
+        info = self.info
+        sizeof_id = info.sizeof_id
+        level = payload[0]
+        fmt = self.string(info.unpack_id(payload[1:]))
+        name = self.string(info.unpack_id(payload[1 + sizeof_id:]))
+        thread = self.string(info.unpack_id(payload[1 + 2 * sizeof_id:]))
+        offset = 1 + 3 * sizeof_id
+        seconds = info.unpack_integer(payload[offset:], 4, True)
+        nanoseconds = info.unpack_integer(payload[offset + 4:], 4, True)
+        args = payload[offset + 8:]
+        truncated = (level & ENTRY_LEVEL_TRUNCATED) != 0
+        level &= ~ENTRY_LEVEL_TRUNCATED
+
+        try:
+            level = LEVELS[level]
+        except IndexError:
+            level = str(level)
+
+        return '{}.{:03d}:{}:{}:{}: {}'.format(
+            seconds,
+            nanoseconds // 1000000,
+            level,
+            thread,
+            name,
+            self.format_message(fmt, args, truncated))
+
+    def decode(self, data):
+        """Decode given data and return the decoded text and the number of
+        bytes consumed. Incomplete records are left in the data.
+
+        """
+
+        output = ''
+        pos = 0
+
+        while len(data) - pos >= 3:
+            kind = data[pos]
+
+            if self.info is None:
+                byte_order = '<'
+            else:
+                byte_order = self.info.byte_order
+
+            size = struct.unpack(byte_order + 'H', data[pos + 1:pos + 3])[0]
+
+            # The byte order is not known until the info record has
+            # been decoded. The info record payload is 10 bytes.
+            if self.info is None and kind == RECORD_TYPE_INFO:
+                size = 10
+
+            if len(data) - pos - 3 < size:
+                break
+
+            payload = data[pos + 3:pos + 3 + size]
+            pos += (3 + size)
+
+            if kind == RECORD_TYPE_INFO:
+                self.info = Info(payload)
+            elif self.info is None:
+                raise Exception('Missing binary log stream info record.')
+            elif kind == RECORD_TYPE_STRING:
+                identity = self.info.unpack_id(payload)
+                string = payload[self.info.sizeof_id:]
+                self.strings[identity] = string.decode('ascii', 'replace')
+            elif kind == RECORD_TYPE_ENTRY:
+                output += self.decode_entry(payload)
+            elif kind == RECORD_TYPE_DROPPED:
+                thread = self.string(self.info.unpack_id(payload))
+                count = self.info.unpack_integer(
+                    payload[self.info.sizeof_id:], 4, False)
+                output += 'Dropped {} log entries in thread {}.\n'.format(
+                    count,
+                    thread)
+            else:
+                raise Exception('Bad record type {}.'.format(kind))
+
+        return output, pos
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode a binary log stream.')
+    parser.add_argument('infile',
+                        nargs='?',
+                        default='-',
+                        help='Binary log stream file, or - for stdin.')
+    args = parser.parse_args()
+
+    if args.infile == '-':
+        fin = sys.stdin.buffer
+    else:
+        fin = open(args.infile, 'rb')
+
+    decoder = Decoder()
+    data = b''
+
+    while True:
+        chunk = fin.read1(4096) if hasattr(fin, 'read1') else fin.read(4096)
+
+        if not chunk:
+            break
+
+        data += chunk
+        output, consumed = decoder.decode(data)
+        data = data[consumed:]
+        sys.stdout.write(output)
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+#
+# Convert a thread trace printed by the file system command
+# /kernel/thrd/trace/dump into the Chrome trace event format, viewable
+# in chrome://tracing and https://ui.perfetto.dev.
+#
+
+import sys
+import re
+import json
+import argparse
+
+
+RE_THREAD = re.compile(r'^thread (0x[0-9a-f]+) (.*)$')
+RE_DROPPED = re.compile(r'^dropped (\d+)$')
+RE_TRACE = re.compile(r'^trace (\d+) (\w+) (0x[0-9a-f]+) (.*)$')
+
+PID = 1
+
+
+class Decoder(object):
+
+    def __init__(self):
+        self.threads = {}
+        self.events = []
+        self.running = None
+        self.previous_time = None
+        self.offset = 0
+        self.start = None
+
+    def tid(self, address):
+        """Returns the Chrome trace thread id of given thread address,
+        adding unknown threads on the fly.
+
+        """
+
+        if address not in self.threads:
+            self.add_thread(address, address)
+
+        return self.threads[address]['tid']
+
+    def thread_name(self, address):
+        self.tid(address)
+
+        return self.threads[address]['name']
+
+    def add_thread(self, address, name):
+        if address in self.threads:
+            return
+
+        tid = len(self.threads) + 1
+        self.threads[address] = {'tid': tid, 'name': name}
+        self.events.append({
+            'name': 'thread_name',
+            'ph': 'M',
+            'pid': PID,
+            'tid': tid,
+            'args': {'name': name}
+        })
+
+    def timestamp(self, time_us):
+        """Convert given 32 bits wrapping time to microseconds since the
+        first event.
+
+        """
+
+        if self.previous_time is not None and time_us < self.previous_time:
+            self.offset += (1 << 32)
+
+        self.previous_time = time_us
+        time_us += self.offset
+
+        if self.start is None:
+            self.start = time_us
+
+        return time_us - self.start
+
+    def begin_running(self, address, ts):
+        self.events.append({
+            'name': 'running',
+            'ph': 'B',
+            'pid': PID,
+            'tid': self.tid(address),
+            'ts': ts
+        })
+        self.running = address
+
+    def end_running(self, ts):
+        if self.running is None:
+            return
+
+        self.events.append({
+            'name': 'running',
+            'ph': 'E',
+            'pid': PID,
+            'tid': self.tid(self.running),
+            'ts': ts
+        })
+        self.running = None
+
+    def instant(self, name, address, ts, args):
+        self.events.append({
+            'name': name,
+            'ph': 'i',
+            's': 't',
+            'pid': PID,
+            'tid': self.tid(address),
+            'ts': ts,
+            'args': args
+        })
+
+    def decode_trace(self, time_us, kind, address, arg):
+        ts = self.timestamp(time_us)
+
+        if kind == 'swap':
+            # The swapped out thread was running since the start of
+            # the trace if not known.
+            if self.running is None:
+                self.begin_running(arg, 0)
+
+            self.end_running(ts)
+            self.begin_running(address, ts)
+        elif kind == 'suspend':
+            self.instant('suspend', address, ts, {})
+        elif kind == 'resume':
+            self.instant('resume',
+                         address,
+                         ts,
+                         {'by': self.thread_name(arg)})
+        elif kind == 'timer':
+            self.instant('timer', address, ts, {'callback': arg})
+        elif kind == 'marker':
+            self.instant(arg, address, ts, {})
+        else:
+            raise Exception('Bad trace event type {}.'.format(kind))
+
+    def decode_line(self, line):
+        line = line.strip()
+        mo = RE_THREAD.match(line)
+
+        if mo:
+            # Only the last dump is converted.
+            if self.previous_time is not None:
+                self.__init__()
+
+            self.add_thread(mo.group(1), mo.group(2))
+            return
+
+        mo = RE_DROPPED.match(line)
+
+        if mo:
+            sys.stderr.write('warning: {} events were dropped\n'.format(
+                mo.group(1)))
+            return
+
+        mo = RE_TRACE.match(line)
+
+        if mo:
+            self.decode_trace(int(mo.group(1)),
+                              mo.group(2),
+                              mo.group(3),
+                              mo.group(4))
+
+    def decode(self, fin):
+        """Decode given trace dump. Lines that are not part of the dump,
+        for example shell prompts, are ignored.
+
+        """
+
+        for line in fin:
+            self.decode_line(line)
+
+        if self.previous_time is not None:
+            self.end_running(self.timestamp(self.previous_time))
+
+        return {'traceEvents': self.events, 'displayTimeUnit': 'ns'}
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert a thread trace dump to a Chrome trace.')
+    parser.add_argument('infile',
+                        nargs='?',
+                        default='-',
+                        help='Trace dump file, or - for stdin.')
+    parser.add_argument('-o', '--outfile',
+                        default='-',
+                        help='Chrome trace JSON file, or - for stdout.')
+    args = parser.parse_args()
+
+    if args.infile == '-':
+        fin = sys.stdin
+    else:
+        fin = open(args.infile, 'r', errors='replace')
+
+    trace = Decoder().decode(fin)
+
+    if args.outfile == '-':
+        json.dump(trace, sys.stdout, indent=1)
+        sys.stdout.write('\n')
+    else:
+        with open(args.outfile, 'w') as fout:
+            json.dump(trace, fout, indent=1)
+
+
+if __name__ == "__main__":
+    main()
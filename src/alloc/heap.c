@@ -215,25 +215,33 @@ int heap_free(struct heap_t *self_p,
 
     header_p = &((struct heap_buffer_header_t *)buf_p)[-1];
 
-    mutex_lock(&self_p->mutex);
-
-    if (header_p->count > 0) {
-        header_p->count--;
-        count = header_p->count;
+    /* Only the last free of a shared buffer takes the mutex. */
+    count = ATOMIC_LOAD(&header_p->count);
 
-        /* Free when count is zero. */
-        if (count == 0) {
-            if (header_p->u.fixed_p != NULL) {
-                count = free_fixed_size(self_p, header_p);
-            } else {
-                count = free_dynamic_buffer(self_p, header_p);
-            }
+    while (count > 0) {
+        if (ATOMIC_CAS(&header_p->count, &count, count - 1)) {
+            break;
         }
-    } else {
-        count = -1;
     }
 
-    mutex_unlock(&self_p->mutex);
+    if (count <= 0) {
+        return (-1);
+    }
+
+    count--;
+
+    /* Free when count is zero. */
+    if (count == 0) {
+        mutex_lock(&self_p->mutex);
+
+        if (header_p->u.fixed_p != NULL) {
+            count = free_fixed_size(self_p, header_p);
+        } else {
+            count = free_dynamic_buffer(self_p, header_p);
+        }
+
+        mutex_unlock(&self_p->mutex);
+    }
 
     return (count);
 }
@@ -249,10 +257,7 @@ int heap_share(struct heap_t *self_p,
     struct heap_buffer_header_t *header_p;
 
     header_p = &((struct heap_buffer_header_t *)buf_p)[-1];
-
-    mutex_lock(&self_p->mutex);
-    header_p->count += count;
-    mutex_unlock(&self_p->mutex);
+    ATOMIC_ADD(&header_p->count, count);
 
     return (0);
 }
@@ -234,6 +234,60 @@ ssize_t circular_buffer_array_two(struct circular_buffer_t *self_p,
     return (size);
 }
 
+ssize_t circular_buffer_unused_array(struct circular_buffer_t *self_p,
+                                     void **buf_pp,
+                                     size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    size_t first_chunk_size;
+
+    /* One byte is always unused to tell a full buffer from an empty
+       one. */
+    if (self_p->writepos >= self_p->readpos) {
+        first_chunk_size = (self_p->size - self_p->writepos);
+
+        if (self_p->readpos == 0) {
+            first_chunk_size--;
+        }
+    } else {
+        first_chunk_size = (self_p->readpos - self_p->writepos - 1);
+    }
+
+    if (size > first_chunk_size) {
+        size = first_chunk_size;
+    }
+
+    if (size > 0) {
+        *buf_pp = &self_p->buf_p[self_p->writepos];
+    }
+
+    return (size);
+}
+
+ssize_t circular_buffer_skip_back(struct circular_buffer_t *self_p,
+                                  size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    size_t unused_size;
+
+    unused_size = circular_buffer_unused_size(self_p);
+
+    if (size > unused_size) {
+        size = unused_size;
+    }
+
+    self_p->writepos += size;
+
+    if (self_p->writepos >= self_p->size) {
+        self_p->writepos -= self_p->size;
+    }
+
+    return (size);
+}
+
 ssize_t circular_buffer_find(struct circular_buffer_t *self_p,
                              char value)
 {
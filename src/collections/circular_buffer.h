@@ -150,6 +150,35 @@ ssize_t circular_buffer_array_two(struct circular_buffer_t *self_p,
                                   void **buf_pp,
                                   size_t size);
 
+/**
+ * Get a pointer to the next byte to write to the buffer. The array
+ * ends at the end of the buffer memory or at the first unread byte,
+ * whichever comes first. Write data to the array and then call
+ * `circular_buffer_skip_back()` to add it to the buffer.
+ *
+ * @param[in] self_p Circular buffer.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t circular_buffer_unused_array(struct circular_buffer_t *self_p,
+                                     void **buf_pp,
+                                     size_t size);
+
+/**
+ * Add given number of bytes, already written to the array returned
+ * by `circular_buffer_unused_array()`, to the back of the buffer.
+ *
+ * @param[in] self_p Circular buffer.
+ * @param[in] size Number of bytes to add.
+ *
+ * @return Number of added bytes or negative error code.
+ */
+ssize_t circular_buffer_skip_back(struct circular_buffer_t *self_p,
+                                  size_t size);
+
 /**
  * Find the offset of the first location of given character.
  *
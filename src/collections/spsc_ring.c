@@ -0,0 +1,275 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+/**
+ * Get the number of unused bytes from the producer's point of
+ * view. The consumer position is only read if the cached copy of it
+ * does not give enough unused bytes.
+ */
+static size_t producer_unused_size(struct spsc_ring_t *self_p,
+                                   size_t size)
+{
+    size_t unused_size;
+
+    unused_size = (self_p->mask + 1
+                   - (self_p->producer.head - self_p->producer.tail));
+
+    if (unused_size < size) {
+        self_p->producer.tail = ATOMIC_LOAD_ISR(&self_p->consumer.tail);
+        unused_size = (self_p->mask + 1
+                       - (self_p->producer.head - self_p->producer.tail));
+    }
+
+    return (unused_size);
+}
+
+/**
+ * Get the number of used bytes from the consumer's point of view. The
+ * producer position is only read if the cached copy of it does not
+ * give enough used bytes.
+ */
+static size_t consumer_used_size(struct spsc_ring_t *self_p,
+                                 size_t size)
+{
+    size_t used_size;
+
+    used_size = (self_p->consumer.head - self_p->consumer.tail);
+
+    if (used_size < size) {
+        self_p->consumer.head = ATOMIC_LOAD_ISR(&self_p->producer.head);
+        used_size = (self_p->consumer.head - self_p->consumer.tail);
+    }
+
+    return (used_size);
+}
+
+int spsc_ring_init(struct spsc_ring_t *self_p,
+                   void *buf_p,
+                   size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN(size > 0, EINVAL);
+
+    size_t length;
+
+    /* The positions are masked instead of wrapped, so the length
+       must be a power of two. */
+    length = 1;
+
+    while (((length << 1) != 0) && ((length << 1) <= size)) {
+        length <<= 1;
+    }
+
+    self_p->buf_p = buf_p;
+    self_p->mask = (length - 1);
+    self_p->producer.head = 0;
+    self_p->producer.tail = 0;
+    self_p->consumer.tail = 0;
+    self_p->consumer.head = 0;
+
+    return (0);
+}
+
+ssize_t spsc_ring_write(struct spsc_ring_t *self_p,
+                        const void *buf_p,
+                        size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    size_t unused_size;
+    size_t pos;
+    size_t first_chunk_size;
+    const char *b_p;
+
+    unused_size = producer_unused_size(self_p, size);
+
+    if (size > unused_size) {
+        size = unused_size;
+    }
+
+    b_p = buf_p;
+    pos = (self_p->producer.head & self_p->mask);
+    first_chunk_size = (self_p->mask + 1 - pos);
+
+    if (first_chunk_size > size) {
+        first_chunk_size = size;
+    }
+
+    memcpy(&self_p->buf_p[pos], &b_p[0], first_chunk_size);
+    memcpy(&self_p->buf_p[0], &b_p[first_chunk_size], size - first_chunk_size);
+
+    /* Publish the data to the consumer. */
+    ATOMIC_STORE_ISR(&self_p->producer.head, self_p->producer.head + size);
+
+    return (size);
+}
+
+ssize_t spsc_ring_read(struct spsc_ring_t *self_p,
+                       void *buf_p,
+                       size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    size_t used_size;
+    size_t pos;
+    size_t first_chunk_size;
+    char *b_p;
+
+    used_size = consumer_used_size(self_p, size);
+
+    if (size > used_size) {
+        size = used_size;
+    }
+
+    b_p = buf_p;
+    pos = (self_p->consumer.tail & self_p->mask);
+    first_chunk_size = (self_p->mask + 1 - pos);
+
+    if (first_chunk_size > size) {
+        first_chunk_size = size;
+    }
+
+    memcpy(&b_p[0], &self_p->buf_p[pos], first_chunk_size);
+    memcpy(&b_p[first_chunk_size], &self_p->buf_p[0], size - first_chunk_size);
+
+    /* Give the space back to the producer. */
+    ATOMIC_STORE_ISR(&self_p->consumer.tail, self_p->consumer.tail + size);
+
+    return (size);
+}
+
+ssize_t spsc_ring_used_size(struct spsc_ring_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (consumer_used_size(self_p, self_p->mask + 1));
+}
+
+ssize_t spsc_ring_unused_size(struct spsc_ring_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (producer_unused_size(self_p, self_p->mask + 1));
+}
+
+ssize_t spsc_ring_array_one(struct spsc_ring_t *self_p,
+                            void **buf_pp,
+                            size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    size_t used_size;
+    size_t pos;
+
+    used_size = consumer_used_size(self_p, size);
+    pos = (self_p->consumer.tail & self_p->mask);
+
+    if (size > used_size) {
+        size = used_size;
+    }
+
+    if (size > self_p->mask + 1 - pos) {
+        size = (self_p->mask + 1 - pos);
+    }
+
+    if (size > 0) {
+        *buf_pp = &self_p->buf_p[pos];
+    }
+
+    return (size);
+}
+
+ssize_t spsc_ring_skip_front(struct spsc_ring_t *self_p,
+                             size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    size_t used_size;
+
+    used_size = consumer_used_size(self_p, size);
+
+    if (size > used_size) {
+        size = used_size;
+    }
+
+    ATOMIC_STORE_ISR(&self_p->consumer.tail, self_p->consumer.tail + size);
+
+    return (size);
+}
+
+ssize_t spsc_ring_unused_array(struct spsc_ring_t *self_p,
+                               void **buf_pp,
+                               size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    size_t unused_size;
+    size_t pos;
+
+    unused_size = producer_unused_size(self_p, size);
+    pos = (self_p->producer.head & self_p->mask);
+
+    if (size > unused_size) {
+        size = unused_size;
+    }
+
+    if (size > self_p->mask + 1 - pos) {
+        size = (self_p->mask + 1 - pos);
+    }
+
+    if (size > 0) {
+        *buf_pp = &self_p->buf_p[pos];
+    }
+
+    return (size);
+}
+
+ssize_t spsc_ring_skip_back(struct spsc_ring_t *self_p,
+                            size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    size_t unused_size;
+
+    unused_size = producer_unused_size(self_p, size);
+
+    if (size > unused_size) {
+        size = unused_size;
+    }
+
+    ATOMIC_STORE_ISR(&self_p->producer.head, self_p->producer.head + size);
+
+    return (size);
+}
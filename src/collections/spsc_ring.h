@@ -0,0 +1,182 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __COLLECTIONS_SPSC_RING_H__
+#define __COLLECTIONS_SPSC_RING_H__
+
+#include "simba.h"
+
+/**
+ * Single producer, single consumer ring buffer. The producer and the
+ * consumer may access the ring at the same time without any lock, as
+ * long as there is only one of each. The producer and consumer
+ * positions are kept in separate cache lines.
+ *
+ * On targets without lock-free atomic operations (see
+ * ATOMIC_LOCK_FREE) all functions must be called with the system lock
+ * taken.
+ */
+struct spsc_ring_t {
+    char *buf_p;
+    size_t mask;
+    struct {
+        size_t head;
+        size_t tail;
+    } producer __attribute__((aligned(CONFIG_CACHE_LINE_SIZE)));
+    struct {
+        size_t tail;
+        size_t head;
+    } consumer __attribute__((aligned(CONFIG_CACHE_LINE_SIZE)));
+};
+
+/**
+ * Initialize given ring buffer. Only the largest power of two bytes
+ * of given memory buffer are used.
+ *
+ * @param[in] self_p Ring buffer to initialize.
+ * @param[in] buf_p Memory buffer.
+ * @param[in] size Size of the memory buffer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int spsc_ring_init(struct spsc_ring_t *self_p,
+                   void *buf_p,
+                   size_t size);
+
+/**
+ * Write data to given ring buffer. May only be called by the
+ * producer.
+ *
+ * @param[in] self_p Ring buffer.
+ * @param[in] buf_p Memory buffer to write.
+ * @param[in] size Size of the memory buffer.
+ *
+ * @return Number of bytes written or negative error code. Less than
+ *         given size is written if the ring buffer is full.
+ */
+ssize_t spsc_ring_write(struct spsc_ring_t *self_p,
+                        const void *buf_p,
+                        size_t size);
+
+/**
+ * Read data from given ring buffer. May only be called by the
+ * consumer.
+ *
+ * @param[in] self_p Ring buffer.
+ * @param[in] buf_p Memory buffer to read into.
+ * @param[in] size Size of the memory buffer.
+ *
+ * @return Number of bytes read or negative error code. The ring
+ *         buffer is empty if zero(0) is returned.
+ */
+ssize_t spsc_ring_read(struct spsc_ring_t *self_p,
+                       void *buf_p,
+                       size_t size);
+
+/**
+ * Get the number of used bytes in given ring buffer. May only be
+ * called by the consumer.
+ *
+ * @param[in] self_p Ring buffer.
+ *
+ * @return Number of used bytes or negative error code.
+ */
+ssize_t spsc_ring_used_size(struct spsc_ring_t *self_p);
+
+/**
+ * Get the number of unused bytes in given ring buffer. May only be
+ * called by the producer.
+ *
+ * @param[in] self_p Ring buffer.
+ *
+ * @return Number of unused bytes or negative error code.
+ */
+ssize_t spsc_ring_unused_size(struct spsc_ring_t *self_p);
+
+/**
+ * Get a pointer to the next bytes to read from given ring buffer. The
+ * array ends at the end of the buffer memory or at the last written
+ * byte, whichever comes first. Call `spsc_ring_skip_front()` to
+ * remove the bytes once done with them. May only be called by the
+ * consumer.
+ *
+ * @param[in] self_p Ring buffer.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t spsc_ring_array_one(struct spsc_ring_t *self_p,
+                            void **buf_pp,
+                            size_t size);
+
+/**
+ * Remove given number of bytes from the front of given ring
+ * buffer. May only be called by the consumer.
+ *
+ * @param[in] self_p Ring buffer.
+ * @param[in] size Number of bytes to remove.
+ *
+ * @return Number of removed bytes or negative error code.
+ */
+ssize_t spsc_ring_skip_front(struct spsc_ring_t *self_p,
+                             size_t size);
+
+/**
+ * Get a pointer to the next byte to write to given ring buffer. The
+ * array ends at the end of the buffer memory or at the first unread
+ * byte, whichever comes first. Write data to the array and then call
+ * `spsc_ring_skip_back()` to add it to the ring buffer. May only be
+ * called by the producer.
+ *
+ * @param[in] self_p Ring buffer.
+ * @param[out] buf_pp A pointer to the start of the array. Only valid
+ *                    if the return value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes in array or negative error code.
+ */
+ssize_t spsc_ring_unused_array(struct spsc_ring_t *self_p,
+                               void **buf_pp,
+                               size_t size);
+
+/**
+ * Add given number of bytes, already written to the array returned
+ * by `spsc_ring_unused_array()`, to the back of given ring
+ * buffer. May only be called by the producer.
+ *
+ * @param[in] self_p Ring buffer.
+ * @param[in] size Number of bytes to add.
+ *
+ * @return Number of added bytes or negative error code.
+ */
+ssize_t spsc_ring_skip_back(struct spsc_ring_t *self_p,
+                            size_t size);
+
+#endif
@@ -697,6 +697,25 @@
 #    endif
 #endif
 
+/**
+ * Enable the block_device driver.
+ */
+#ifndef CONFIG_BLOCK_DEVICE
+#    if defined(BOARD_ARDUINO_NANO) || defined(BOARD_ARDUINO_UNO) || defined(BOARD_ARDUINO_PRO_MICRO) || defined(FAMILY_SPC5) || defined(CONFIG_MINIMAL_SYSTEM)
+#        define CONFIG_BLOCK_DEVICE                         0
+#    else
+#        define CONFIG_BLOCK_DEVICE                         1
+#    endif
+#endif
+
+/**
+ * Default number of blocks the block_device driver reads ahead of a
+ * sequential read.
+ */
+#ifndef CONFIG_BLOCK_DEVICE_READ_AHEAD
+#    define CONFIG_BLOCK_DEVICE_READ_AHEAD                  4
+#endif
+
 /**
  * Enable the sd driver.
  */
@@ -1499,6 +1518,66 @@
 #    endif
 #endif
 
+/**
+ * Size of the log entry buffer on the stack. An entry that fits in
+ * the buffer is formatted once and written to each handler in a
+ * single channel write.
+ */
+#ifndef CONFIG_LOG_OUTPUT_BUFFER_MAX
+#    if defined(BOARD_ARDUINO_NANO) || defined(BOARD_ARDUINO_UNO) || defined(BOARD_ARDUINO_PRO_MICRO) || defined(CONFIG_MINIMAL_SYSTEM)
+#        define CONFIG_LOG_OUTPUT_BUFFER_MAX                32
+#    else
+#        define CONFIG_LOG_OUTPUT_BUFFER_MAX               128
+#    endif
+#endif
+
+/**
+ * Binary logging. Threads with a binary log buffer write raw log
+ * entries instead of formatted text. The entries are drained to a
+ * channel and decoded on the host.
+ */
+#ifndef CONFIG_LOG_BINARY
+#    define CONFIG_LOG_BINARY                               0
+#endif
+
+/**
+ * Maximum size in bytes of a binary log entry, including the
+ * header. Arguments that do not fit are not recorded.
+ */
+#ifndef CONFIG_LOG_BINARY_ENTRY_MAX
+#    define CONFIG_LOG_BINARY_ENTRY_MAX                    96
+#endif
+
+/**
+ * Maximum number of bytes of a string argument in a binary log entry.
+ */
+#ifndef CONFIG_LOG_BINARY_STRING_MAX
+#    define CONFIG_LOG_BINARY_STRING_MAX                   32
+#endif
+
+/**
+ * Number of string addresses the binary log drain remembers as
+ * already written to the output channel.
+ */
+#ifndef CONFIG_LOG_BINARY_STRINGS_MAX
+#    define CONFIG_LOG_BINARY_STRINGS_MAX                  64
+#endif
+
+/**
+ * Binary log drain thread period in milliseconds.
+ */
+#ifndef CONFIG_LOG_BINARY_DRAIN_PERIOD_MS
+#    define CONFIG_LOG_BINARY_DRAIN_PERIOD_MS             100
+#endif
+
+/**
+ * Asynchronous log handlers. Entries are added to a lock-free ring
+ * and written to the output channel by a drain thread.
+ */
+#ifndef CONFIG_LOG_ASYNC
+#    define CONFIG_LOG_ASYNC                                0
+#endif
+
 /**
  * Debug file system command to list all log objects.
  */
@@ -1674,6 +1753,45 @@
 #    define CONFIG_FS_COMMAND_ARGS_MAX                     16
 #endif
 
+/**
+ * Number of buckets in the hash table used by ``fs_call()`` to find
+ * commands, or zero to search the sorted command list linearly. Must
+ * be a power of two. Each registered command uses one more pointer
+ * when enabled.
+ */
+#ifndef CONFIG_FS_COMMAND_HASH_SIZE
+#    if defined(BOARD_ARDUINO_NANO) || defined(BOARD_ARDUINO_UNO) || defined(BOARD_ARDUINO_PRO_MICRO) || defined(FAMILY_SPC5) || defined(CONFIG_MINIMAL_SYSTEM)
+#        define CONFIG_FS_COMMAND_HASH_SIZE                 0
+#    else
+#        define CONFIG_FS_COMMAND_HASH_SIZE                32
+#    endif
+#endif
+
+/**
+ * Number of shards of each counter. Threads increment different
+ * shards, which are summed when the counter is read, so parallel
+ * threads do not write the same cache line. More than one shard
+ * requires 64 bits lock-free atomic operations and thread local
+ * storage, and is only useful on Linux, where thread pool workers run
+ * in parallel.
+ */
+#ifndef CONFIG_FS_COUNTER_SHARDS
+#    if defined(ARCH_LINUX)
+#        define CONFIG_FS_COUNTER_SHARDS                    8
+#    else
+#        define CONFIG_FS_COUNTER_SHARDS                    1
+#    endif
+#endif
+
+/**
+ * Number of buckets in a histogram. Bucket zero counts the value
+ * zero, and bucket N counts values from 2^(N-1) up to 2^N - 1. The
+ * last bucket also counts all larger values.
+ */
+#ifndef CONFIG_FS_HISTOGRAM_BUCKETS
+#    define CONFIG_FS_HISTOGRAM_BUCKETS                    16
+#endif
+
 /**
  * Debug file system command to append to a file.
  */
@@ -1784,6 +1902,18 @@
 #    endif
 #endif
 
+/**
+ * Priority inheritance for mutexes. A thread holding a mutex runs with
+ * the priority of the highest priority thread waiting for it.
+ */
+#ifndef CONFIG_MUTEX_PRIORITY_INHERITANCE
+#    if defined(BOARD_ARDUINO_NANO) || defined(BOARD_ARDUINO_UNO) || defined(BOARD_ARDUINO_PRO_MICRO) || defined(CONFIG_MINIMAL_SYSTEM)
+#        define CONFIG_MUTEX_PRIORITY_INHERITANCE           0
+#    else
+#        define CONFIG_MUTEX_PRIORITY_INHERITANCE           1
+#    endif
+#endif
+
 /**
  * Start the monitor thread to gather statistics of the scheulder.
  */
@@ -1836,6 +1966,27 @@
 #    define CONFIG_SETTINGS_BLOB                            1
 #endif
 
+/**
+ * Keep a copy of the settings area in RAM. Reads are served from RAM
+ * instead of from the non-volatile memory, writes of unchanged values
+ * are skipped, and writes between settings_begin() and
+ * settings_commit() are written to the non-volatile memory in a
+ * single call to nvm_vwrite(). Uses CONFIG_SETTINGS_AREA_SIZE bytes
+ * of RAM.
+ */
+#ifndef CONFIG_SETTINGS_SHADOW
+#    define CONFIG_SETTINGS_SHADOW                          0
+#endif
+
+/**
+ * Maximum number of modified address ranges in the settings RAM
+ * shadow waiting to be committed. Neighbouring ranges are merged
+ * when full.
+ */
+#ifndef CONFIG_SETTINGS_SHADOW_DIRTY_RANGES_MAX
+#    define CONFIG_SETTINGS_SHADOW_DIRTY_RANGES_MAX         4
+#endif
+
 /**
  * Maximum number of characters in a shell command.
  */
@@ -1890,6 +2041,37 @@
 #    endif
 #endif
 
+/**
+ * SPIFFS read cache of recently used pages.
+ */
+#ifndef CONFIG_SPIFFS_CACHE
+#    define CONFIG_SPIFFS_CACHE                             1
+#endif
+
+/**
+ * SPIFFS write cache in each file descriptor. Requires
+ * ``CONFIG_SPIFFS_CACHE``.
+ */
+#ifndef CONFIG_SPIFFS_CACHE_WRITE
+#    define CONFIG_SPIFFS_CACHE_WRITE                       1
+#endif
+
+/**
+ * SPIFFS cache hit and miss counters.
+ */
+#ifndef CONFIG_SPIFFS_CACHE_STATS
+#    define CONFIG_SPIFFS_CACHE_STATS                       1
+#endif
+
+/**
+ * SPIFFS in memory lookup index of the object index header page of
+ * each file, to find files without scanning the flash. See
+ * spiffs_set_lookup_index().
+ */
+#ifndef CONFIG_SPIFFS_LOOKUP_INDEX
+#    define CONFIG_SPIFFS_LOOKUP_INDEX                      1
+#endif
+
 /**
  * FAT16 is a file system.
  */
@@ -2029,6 +2211,36 @@
 #    endif
 #endif
 
+/**
+ * Number of SPIFFS cache pages of the started file system.
+ */
+#ifndef CONFIG_START_FILESYSTEM_SPIFFS_CACHE_PAGES
+#    define CONFIG_START_FILESYSTEM_SPIFFS_CACHE_PAGES      5
+#endif
+
+/**
+ * Number of SPIFFS file descriptors of the started file system.
+ */
+#ifndef CONFIG_START_FILESYSTEM_SPIFFS_FILE_DESCRIPTORS
+#    if defined(ARCH_ESP) || defined(ARCH_ESP32)
+#        define CONFIG_START_FILESYSTEM_SPIFFS_FILE_DESCRIPTORS  5
+#    else
+#        define CONFIG_START_FILESYSTEM_SPIFFS_FILE_DESCRIPTORS  4
+#    endif
+#endif
+
+/**
+ * Maximum number of files in the SPIFFS lookup index of the started
+ * file system, or zero(0) to not use a lookup index.
+ */
+#ifndef CONFIG_START_FILESYSTEM_SPIFFS_LOOKUP_INDEX_SIZE
+#    if defined(ARCH_ESP) || defined(ARCH_ESP32)
+#        define CONFIG_START_FILESYSTEM_SPIFFS_LOOKUP_INDEX_SIZE 32
+#    else
+#        define CONFIG_START_FILESYSTEM_SPIFFS_LOOKUP_INDEX_SIZE  0
+#    endif
+#endif
+
 /**
  * Configure a default file system start address.
  */
@@ -2113,11 +2325,23 @@
 #    define CONFIG_NVM_EEPROM_SOFT_BLOCK_1_SIZE         16384
 #endif
 
+/**
+ * Non-volatile software EEPROM append log size in each chunk, or
+ * zero(0) to copy the whole chunk on every write. Must be a multiple
+ * of 8. Small writes are appended to the log until it is full. The
+ * make variable ``EEPROM_SOFT_CHUNK_SIZE`` must be set to the chunk
+ * size if the log is used.
+ */
+#ifndef CONFIG_NVM_EEPROM_SOFT_LOG_SIZE
+#    define CONFIG_NVM_EEPROM_SOFT_LOG_SIZE                 0
+#endif
+
 /**
  * Non-volatile software EEPROM chunk size. Must be a power of two.
  */
 #ifndef CONFIG_NVM_EEPROM_SOFT_CHUNK_SIZE
-#    define CONFIG_NVM_EEPROM_SOFT_CHUNK_SIZE (CONFIG_NVM_SIZE + 8)
+#    define CONFIG_NVM_EEPROM_SOFT_CHUNK_SIZE               \
+    (CONFIG_NVM_SIZE + 8 + CONFIG_NVM_EEPROM_SOFT_LOG_SIZE)
 #endif
 
 /**
@@ -2286,6 +2510,19 @@
 #    endif
 #endif
 
+/**
+ * Cache line size in bytes. Data written by different CPUs is placed
+ * in separate cache lines to avoid false sharing. One(1) for targets
+ * without a data cache.
+ */
+#ifndef CONFIG_CACHE_LINE_SIZE
+#    if defined(ARCH_LINUX) || defined(ARCH_ARM64)
+#        define CONFIG_CACHE_LINE_SIZE                     64
+#    else
+#        define CONFIG_CACHE_LINE_SIZE                      1
+#    endif
+#endif
+
 /**
  * System tick frequency in Hertz.
  */
@@ -2323,6 +2560,39 @@
 #    endif
 #endif
 
+/**
+ * Record wait and hold times of named mutexes, semaphores and
+ * reader-writer locks, and the time each thread spends ready to run,
+ * listed by the file system command ``/kernel/thrd/contention``. The
+ * lock-free fast paths of the locks are disabled, as the statistics
+ * are updated with the system lock taken.
+ */
+#ifndef CONFIG_THRD_CONTENTION
+#    define CONFIG_THRD_CONTENTION                          0
+#endif
+
+/**
+ * Record context switches, suspends, resumes, timer expiries and user
+ * markers in a ring buffer, printed by the file system command
+ * ``/kernel/thrd/trace/dump``. Convert the output to the Chrome trace
+ * format with ``make/tracedecoder.py``.
+ */
+#ifndef CONFIG_THRD_TRACE
+#    define CONFIG_THRD_TRACE                               0
+#endif
+
+/**
+ * Number of events in the trace ring buffer. The oldest events are
+ * overwritten when full.
+ */
+#ifndef CONFIG_THRD_TRACE_ENTRIES_MAX
+#    if defined(ARCH_LINUX)
+#        define CONFIG_THRD_TRACE_ENTRIES_MAX            4096
+#    else
+#        define CONFIG_THRD_TRACE_ENTRIES_MAX             128
+#    endif
+#endif
+
 /**
  * Default thread log mask.
  */
@@ -2380,6 +2650,25 @@
 #    endif
 #endif
 
+/**
+ * Run thread pool workers as native threads in parallel with the
+ * Simba threads, instead of as Simba threads.
+ */
+#ifndef CONFIG_THRD_POOL_NATIVE
+#    if defined(ARCH_LINUX)
+#        define CONFIG_THRD_POOL_NATIVE                     1
+#    else
+#        define CONFIG_THRD_POOL_NATIVE                     0
+#    endif
+#endif
+
+/**
+ * Maximum number of jobs in the deque of each thread pool worker.
+ */
+#ifndef CONFIG_THRD_POOL_DEQUE_MAX
+#    define CONFIG_THRD_POOL_DEQUE_MAX                     16
+#endif
+
 /**
  * Count the number of times each thread has been scheduled.
  */
@@ -2477,6 +2766,70 @@
 #    endif
 #endif
 
+/**
+ * Maximum number of sessions in the server side SSL session cache,
+ * used to resume the sessions of reconnecting clients with an
+ * abbreviated handshake. Set to zero(0) to disable the cache.
+ */
+#ifndef CONFIG_SSL_SESSION_CACHE_MAX
+#    define CONFIG_SSL_SESSION_CACHE_MAX                    4
+#endif
+
+/**
+ * Issue session tickets to clients in server side SSL sockets, so
+ * clients can resume their sessions without a server side cache
+ * entry.
+ */
+#ifndef CONFIG_SSL_SESSION_TICKETS
+#    define CONFIG_SSL_SESSION_TICKETS                      1
+#endif
+
+/**
+ * Lifetime of cached sessions and session tickets in seconds.
+ */
+#ifndef CONFIG_SSL_SESSION_LIFETIME
+#    define CONFIG_SSL_SESSION_LIFETIME                 86400
+#endif
+
+/**
+ * Maximum number of server hostnames a client side SSL context
+ * remembers the session of, to resume it when reconnecting. Set to
+ * zero(0) to disable client side session resumption.
+ */
+#ifndef CONFIG_SSL_CLIENT_SESSIONS_MAX
+#    define CONFIG_SSL_CLIENT_SESSIONS_MAX                  2
+#endif
+
+/**
+ * Maximum number of simultaneously open SSL sockets. The connection
+ * states of all sockets are allocated statically.
+ */
+#ifndef CONFIG_SSL_SOCKETS_MAX
+#    define CONFIG_SSL_SOCKETS_MAX                          2
+#endif
+
+/**
+ * Maximum SSL record payload size in bytes, and thereby the size of
+ * the input and output record buffers of each SSL socket. Client
+ * side sockets request a maximum fragment length of this size from
+ * the server if smaller than 16384, so it should be one of 512,
+ * 1024, 2048, 4096 and 16384. Servers not supporting the maximum
+ * fragment length extension may send records that do not fit.
+ */
+#ifndef CONFIG_SSL_RECORD_SIZE_MAX
+#    define CONFIG_SSL_RECORD_SIZE_MAX                  16384
+#endif
+
+/**
+ * Statically allocate the input and output record buffers of
+ * ``CONFIG_SSL_SOCKETS_MAX`` SSL sockets, instead of allocating them
+ * on the heap for each connection. Requires mbedTLS to be built with
+ * ``MBEDTLS_PLATFORM_MEMORY``.
+ */
+#ifndef CONFIG_SSL_RECORD_BUFFER_POOL
+#    define CONFIG_SSL_RECORD_BUFFER_POOL                   0
+#endif
+
 /**
  * Sleep in the test harness before executing the first testcase.
  */
@@ -2552,6 +2905,47 @@
 #    define CONFIG_HTTP_SERVER_REQUEST_BUFFER_SIZE        128
 #endif
 
+/**
+ * Size of the websocket frame buffer on the stack. Small frames are
+ * written and read with a single socket call using this buffer, and
+ * discarded payload data is read into it.
+ */
+#ifndef CONFIG_HTTP_WEBSOCKET_BUFFER_SIZE
+#    define CONFIG_HTTP_WEBSOCKET_BUFFER_SIZE              64
+#endif
+
+/**
+ * Maximum number of clients served concurrently by a TFTP server. A
+ * client is a stackless task using a few hundred bytes of RAM plus
+ * its packet buffer, see CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX.
+ */
+#ifndef CONFIG_TFTP_SERVER_CLIENTS_MAX
+#    define CONFIG_TFTP_SERVER_CLIENTS_MAX                  2
+#endif
+
+/**
+ * Maximum TFTP block size accepted in the blksize option (RFC
+ * 2348). The packet buffer of each client is this size plus four
+ * bytes. The default on targets with a network interface is the
+ * largest block fitting in an Ethernet frame.
+ */
+#ifndef CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX
+#    if defined(ARCH_LINUX) || defined(FAMILY_ESP) || defined(FAMILY_ESP32)
+#        define CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX        1428
+#    else
+#        define CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX         512
+#    endif
+#endif
+
+/**
+ * Maximum number of TFTP blocks sent or received before waiting for,
+ * or sending, an acknowledgement, as accepted in the windowsize
+ * option (RFC 7440).
+ */
+#ifndef CONFIG_TFTP_SERVER_WINDOW_SIZE_MAX
+#    define CONFIG_TFTP_SERVER_WINDOW_SIZE_MAX             16
+#endif
+
 /**
  * Use lookup tables for CRC calculations. It is faster, but uses more
  * memory.
@@ -2669,6 +3063,14 @@
 #    define CONFIG_EEPROM_SOFT_OVERWRITE_IDENTICAL_DATA     0
 #endif
 
+/**
+ * Binary search for the latest chunk when mounting a software
+ * eeprom, instead of reading the header of every chunk.
+ */
+#ifndef CONFIG_EEPROM_SOFT_MOUNT_BINARY_SEARCH
+#    define CONFIG_EEPROM_SOFT_MOUNT_BINARY_SEARCH          1
+#endif
+
 /**
  * Configuration validation.
  */
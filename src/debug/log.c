@@ -39,6 +39,14 @@ struct module_t {
     struct fs_command_t cmd_list;
     struct fs_command_t cmd_set_log_mask;
 #endif
+#if CONFIG_LOG_BINARY == 1
+    struct {
+        void *chout_p;
+        struct log_binary_buffer_t *buffers_p;
+        int8_t info_written;
+        uintptr_t strings[CONFIG_LOG_BINARY_STRINGS_MAX];
+    } binary;
+#endif
 };
 
 static FAR const char level_fatal[] = "fatal";
@@ -59,6 +67,556 @@ static const char FAR *level_as_string[] = {
 /* The module state. */
 static struct module_t module;
 
+#if CONFIG_LOG_BINARY == 1
+
+/* Offsets in a binary entry, after the size. */
+#define ENTRY_LEVEL_OFFSET                                  0
+#define ENTRY_FORMAT_OFFSET                                 1
+#define ENTRY_NAME_OFFSET          (1 + sizeof(uintptr_t))
+#define ENTRY_THREAD_OFFSET        (1 + 2 * sizeof(uintptr_t))
+#define ENTRY_TIME_OFFSET          (1 + 3 * sizeof(uintptr_t))
+#define ENTRY_ARGS_OFFSET          (9 + 3 * sizeof(uintptr_t))
+
+/* Set in the level if all arguments did not fit in the entry. */
+#define ENTRY_LEVEL_TRUNCATED                            0x80
+
+/**
+ * Copy given data to the ring buffer at given position.
+ */
+static void binary_ring_write(struct log_binary_buffer_t *self_p,
+                              size_t pos,
+                              const void *buf_p,
+                              size_t size)
+{
+    size_t offset;
+    size_t n;
+
+    offset = (pos & (self_p->size - 1));
+    n = MIN(size, self_p->size - offset);
+    memcpy(&self_p->buf_p[offset], buf_p, n);
+    memcpy(&self_p->buf_p[0], (const uint8_t *)buf_p + n, size - n);
+}
+
+/**
+ * Copy data from the ring buffer at given position.
+ */
+static void binary_ring_read(struct log_binary_buffer_t *self_p,
+                             size_t pos,
+                             void *buf_p,
+                             size_t size)
+{
+    size_t offset;
+    size_t n;
+
+    offset = (pos & (self_p->size - 1));
+    n = MIN(size, self_p->size - offset);
+    memcpy(buf_p, &self_p->buf_p[offset], n);
+    memcpy((uint8_t *)buf_p + n, &self_p->buf_p[0], size - n);
+}
+
+static int binary_encode_id(uint8_t *buf_p, uintptr_t id)
+{
+    memcpy(buf_p, &id, sizeof(id));
+
+    return (sizeof(id));
+}
+
+/**
+ * Encode the raw arguments of given format string.
+ *
+ * @return Number of encoded bytes, or -1 if all arguments did not
+ *         fit in given buffer.
+ */
+static int binary_encode_args(uint8_t *buf_p,
+                              size_t size,
+                              far_string_t fmt_p,
+                              va_list *ap_p)
+{
+    char c;
+    char length;
+    int int_value;
+    long long_value;
+    const char *s_p;
+    size_t pos;
+    size_t n;
+#if CONFIG_FLOAT == 1
+    double double_value;
+#endif
+
+    pos = 0;
+
+    while ((c = *fmt_p++) != '\0') {
+        if (c != '%') {
+            continue;
+        }
+
+        c = *fmt_p++;
+
+        /* Skip flags and width. */
+        while ((c == '-') || ((c >= '0') && (c <= '9'))) {
+            c = *fmt_p++;
+        }
+
+        length = 0;
+
+        if (c == 'l') {
+            length = 1;
+            c = *fmt_p++;
+        }
+
+        switch (c) {
+
+        case 'c':
+        case 'i':
+        case 'd':
+        case 'u':
+        case 'x':
+            if (length == 0) {
+                int_value = va_arg(*ap_p, int);
+                n = sizeof(int_value);
+
+                if (pos + n > size) {
+                    return (-1);
+                }
+
+                memcpy(&buf_p[pos], &int_value, n);
+            } else {
+                long_value = va_arg(*ap_p, long);
+                n = sizeof(long_value);
+
+                if (pos + n > size) {
+                    return (-1);
+                }
+
+                memcpy(&buf_p[pos], &long_value, n);
+            }
+
+            pos += n;
+            break;
+
+#if CONFIG_FLOAT == 1
+        case 'f':
+            double_value = va_arg(*ap_p, double);
+            n = sizeof(double_value);
+
+            if (pos + n > size) {
+                return (-1);
+            }
+
+            memcpy(&buf_p[pos], &double_value, n);
+            pos += n;
+            break;
+#endif
+
+        case 'S':
+#if defined(FAR_SPECIAL_ADDRESS)
+            {
+                FAR const char *far_string_p;
+
+                far_string_p = va_arg(*ap_p, FAR const char *);
+
+                if (far_string_p == NULL) {
+                    far_string_p = FSTR("(null)");
+                }
+
+                n = MIN(std_strlen(far_string_p),
+                        CONFIG_LOG_BINARY_STRING_MAX);
+
+                if (pos + 1 + n > size) {
+                    return (-1);
+                }
+
+                buf_p[pos++] = n;
+
+                while (n > 0) {
+                    buf_p[pos++] = *far_string_p++;
+                    n--;
+                }
+            }
+
+            break;
+#endif
+
+        case 's':
+            s_p = va_arg(*ap_p, const char *);
+
+            if (s_p == NULL) {
+                s_p = "(null)";
+            }
+
+            n = MIN(strlen(s_p), CONFIG_LOG_BINARY_STRING_MAX);
+
+            if (pos + 1 + n > size) {
+                return (-1);
+            }
+
+            buf_p[pos++] = n;
+            memcpy(&buf_p[pos], s_p, n);
+            pos += n;
+            break;
+
+        case '\0':
+            return (pos);
+
+        default:
+            break;
+        }
+    }
+
+    return (pos);
+}
+
+/**
+ * Write a binary log entry to given buffer. Called by the thread
+ * owning the buffer.
+ *
+ * @return true(1) if the entry was written, otherwise false(0).
+ */
+static int binary_record(struct log_binary_buffer_t *self_p,
+                         int level,
+                         const char *name_p,
+                         far_string_t fmt_p,
+                         va_list *ap_p)
+{
+    uint8_t entry[CONFIG_LOG_BINARY_ENTRY_MAX];
+    uint8_t *payload_p;
+    struct time_t now;
+    int res;
+    uint16_t size;
+    size_t head;
+
+    payload_p = &entry[sizeof(size)];
+    time_get(&now);
+
+    payload_p[ENTRY_LEVEL_OFFSET] = level;
+    binary_encode_id(&payload_p[ENTRY_FORMAT_OFFSET], (uintptr_t)fmt_p);
+    binary_encode_id(&payload_p[ENTRY_NAME_OFFSET], (uintptr_t)name_p);
+    binary_encode_id(&payload_p[ENTRY_THREAD_OFFSET],
+                     (uintptr_t)thrd_get_name());
+    memcpy(&payload_p[ENTRY_TIME_OFFSET], &now.seconds, 4);
+    memcpy(&payload_p[ENTRY_TIME_OFFSET + 4], &now.nanoseconds, 4);
+
+    res = binary_encode_args(&payload_p[ENTRY_ARGS_OFFSET],
+                             (sizeof(entry)
+                              - sizeof(size)
+                              - ENTRY_ARGS_OFFSET),
+                             fmt_p,
+                             ap_p);
+
+    if (res < 0) {
+        /* Keep the header only. */
+        payload_p[ENTRY_LEVEL_OFFSET] |= ENTRY_LEVEL_TRUNCATED;
+        res = 0;
+    }
+
+    size = (ENTRY_ARGS_OFFSET + res);
+    memcpy(&entry[0], &size, sizeof(size));
+    size += sizeof(size);
+
+    head = self_p->head;
+
+    if ((self_p->size - (head - self_p->tail)) < size) {
+        self_p->dropped++;
+
+        return (0);
+    }
+
+    binary_ring_write(self_p, head, &entry[0], size);
+
+    /* The entry must be written before it is published. */
+    COMPILER_BARRIER();
+    self_p->head = (head + size);
+
+    return (1);
+}
+
+/**
+ * Write a record header with given type and payload size.
+ */
+static ssize_t binary_write_header(int type, size_t size)
+{
+    uint8_t header[3];
+    uint16_t record_size;
+
+    record_size = size;
+    header[0] = type;
+    memcpy(&header[1], &record_size, sizeof(record_size));
+    chan_write(module.binary.chout_p, &header[0], sizeof(header));
+
+    return (sizeof(header));
+}
+
+static ssize_t binary_write_record(int type, const void *buf_p, size_t size)
+{
+    ssize_t res;
+
+    res = binary_write_header(type, size);
+    chan_write(module.binary.chout_p, buf_p, size);
+
+    return (res + size);
+}
+
+/**
+ * Write the stream information record, needed by the decoder to parse
+ * the other records.
+ */
+static ssize_t binary_write_info(void)
+{
+    uint8_t info[10];
+    uint16_t byte_order;
+
+    byte_order = 1;
+
+    info[0] = 's';
+    info[1] = 'l';
+    info[2] = 'o';
+    info[3] = 'g';
+    info[4] = 1;
+    info[5] = *(uint8_t *)&byte_order;
+    info[6] = sizeof(int);
+    info[7] = sizeof(long);
+    info[8] = sizeof(uintptr_t);
+#if CONFIG_FLOAT == 1
+    info[9] = sizeof(double);
+#else
+    info[9] = 0;
+#endif
+
+    return (binary_write_record(LOG_BINARY_RECORD_TYPE_INFO,
+                                &info[0],
+                                sizeof(info)));
+}
+
+/**
+ * Write a string record if given string has not already been
+ * written. Exactly one of the far and the ram string is given.
+ */
+static ssize_t binary_write_string(far_string_t fstr_p, const char *str_p)
+{
+    uintptr_t id;
+    size_t size;
+    size_t n;
+    int i;
+    int index;
+    char buf[16];
+
+    if (fstr_p != NULL) {
+        id = (uintptr_t)fstr_p;
+    } else {
+        id = (uintptr_t)str_p;
+    }
+
+    /* Look for the string in the hash table. */
+    index = ((id >> 2) % CONFIG_LOG_BINARY_STRINGS_MAX);
+
+    for (i = 0; i < CONFIG_LOG_BINARY_STRINGS_MAX; i++) {
+        if (module.binary.strings[index] == id) {
+            return (0);
+        }
+
+        if (module.binary.strings[index] == 0) {
+            module.binary.strings[index] = id;
+            break;
+        }
+
+        index++;
+
+        if (index == CONFIG_LOG_BINARY_STRINGS_MAX) {
+            index = 0;
+        }
+    }
+
+    /* The string is written every time if the table is full. */
+    if (fstr_p != NULL) {
+        size = std_strlen(fstr_p);
+    } else {
+        size = strlen(str_p);
+    }
+
+    binary_write_header(LOG_BINARY_RECORD_TYPE_STRING, sizeof(id) + size);
+    chan_write(module.binary.chout_p, &id, sizeof(id));
+    n = 0;
+
+    if (str_p != NULL) {
+        chan_write(module.binary.chout_p, str_p, size);
+    } else {
+        while (n < size) {
+            for (i = 0; (i < sizeof(buf)) && (n < size); i++, n++) {
+                buf[i] = fstr_p[n];
+            }
+
+            chan_write(module.binary.chout_p, &buf[0], i);
+        }
+    }
+
+    return (3 + sizeof(id) + size);
+}
+
+static ssize_t binary_drain_buffer(struct log_binary_buffer_t *self_p)
+{
+    uint8_t entry[CONFIG_LOG_BINARY_ENTRY_MAX];
+    uint8_t dropped[sizeof(uintptr_t) + 4];
+    uint16_t size;
+    size_t head;
+    size_t tail;
+    uint32_t count;
+    uintptr_t id;
+    ssize_t res;
+
+    res = 0;
+
+    /* Report dropped entries. */
+    count = (self_p->dropped - self_p->dropped_reported);
+
+    if (count > 0) {
+        self_p->dropped_reported += count;
+        res += binary_write_string(NULL, self_p->thrd_p->name_p);
+        binary_encode_id(&dropped[0], (uintptr_t)self_p->thrd_p->name_p);
+        memcpy(&dropped[sizeof(uintptr_t)], &count, sizeof(count));
+        res += binary_write_record(LOG_BINARY_RECORD_TYPE_DROPPED,
+                                   &dropped[0],
+                                   sizeof(dropped));
+    }
+
+    head = self_p->head;
+    tail = self_p->tail;
+
+    /* Read the head before the entries. */
+    COMPILER_BARRIER();
+
+    while (tail != head) {
+        binary_ring_read(self_p, tail, &size, sizeof(size));
+        binary_ring_read(self_p, tail + sizeof(size), &entry[0], size);
+        tail += (sizeof(size) + size);
+
+        /* The entry must be read before its space is released. */
+        COMPILER_BARRIER();
+        self_p->tail = tail;
+
+        /* Write strings not yet known by the decoder. */
+        memcpy(&id, &entry[ENTRY_FORMAT_OFFSET], sizeof(id));
+        res += binary_write_string((far_string_t)id, NULL);
+        memcpy(&id, &entry[ENTRY_NAME_OFFSET], sizeof(id));
+        res += binary_write_string(NULL, (const char *)id);
+        memcpy(&id, &entry[ENTRY_THREAD_OFFSET], sizeof(id));
+        res += binary_write_string(NULL, (const char *)id);
+
+        res += binary_write_record(LOG_BINARY_RECORD_TYPE_ENTRY,
+                                   &entry[0],
+                                   size);
+    }
+
+    return (res);
+}
+
+#endif
+
+#if CONFIG_LOG_ASYNC == 1
+
+/**
+ * Claim the entry at given position in given ring, if it is the
+ * oldest entry.
+ *
+ * @return The claimed entry, or NULL.
+ */
+static struct log_async_entry_t *async_claim(struct log_async_t *self_p,
+                                             size_t pos)
+{
+    struct log_async_entry_t *entry_p;
+
+    entry_p = &self_p->entries_p[pos & self_p->mask];
+
+    if (ATOMIC_LOAD(&entry_p->sequence) != pos + 1) {
+        return (NULL);
+    }
+
+    if (!ATOMIC_CAS(&self_p->dequeue_pos, &pos, pos + 1)) {
+        return (NULL);
+    }
+
+    return (entry_p);
+}
+
+/**
+ * Make given claimed entry available to the producers again.
+ */
+static void async_release(struct log_async_t *self_p,
+                          struct log_async_entry_t *entry_p,
+                          size_t pos)
+{
+    ATOMIC_STORE(&entry_p->sequence, pos + self_p->mask + 1);
+}
+
+/**
+ * Add given formatted entry to given ring, and wake up the drain
+ * thread if it is waiting.
+ *
+ * @return true(1) if the entry was added, otherwise false(0).
+ */
+static int async_write(struct log_async_t *self_p,
+                       const char *buf_p,
+                       size_t size)
+{
+    struct log_async_entry_t *entry_p;
+    size_t pos;
+    size_t sequence;
+    size_t oldest_pos;
+    int waiting;
+
+    pos = ATOMIC_LOAD(&self_p->enqueue_pos);
+
+    while (1) {
+        entry_p = &self_p->entries_p[pos & self_p->mask];
+        sequence = ATOMIC_LOAD(&entry_p->sequence);
+
+        if (sequence == pos) {
+            if (ATOMIC_CAS(&self_p->enqueue_pos, &pos, pos + 1)) {
+                break;
+            }
+        } else if ((ssize_t)(sequence - pos) < 0) {
+            /* The ring is full. The oldest entry can only be dropped
+               if the drain thread is not writing it. */
+            ATOMIC_ADD(&self_p->dropped, 1);
+            oldest_pos = (pos - self_p->mask - 1);
+
+            if (self_p->policy == LOG_ASYNC_POLICY_DROP_NEWEST) {
+                return (0);
+            }
+
+            entry_p = async_claim(self_p, oldest_pos);
+
+            if (entry_p == NULL) {
+                return (0);
+            }
+
+            async_release(self_p, entry_p, oldest_pos);
+            pos = ATOMIC_LOAD(&self_p->enqueue_pos);
+        } else {
+            pos = ATOMIC_LOAD(&self_p->enqueue_pos);
+        }
+    }
+
+    entry_p->size = MIN(size, sizeof(entry_p->buf));
+    memcpy(&entry_p->buf[0], buf_p, entry_p->size);
+    ATOMIC_STORE(&entry_p->sequence, pos + 1);
+
+    /* Pairs with the fence in the drain thread before it checks for
+       entries. */
+    ATOMIC_FENCE();
+
+    if (self_p->waiting == 1) {
+        waiting = 1;
+
+        if (ATOMIC_CAS(&self_p->waiting, &waiting, 0)) {
+            sem_give(&self_p->sem, 1);
+        }
+    }
+
+    return (1);
+}
+
+#endif
+
 #if CONFIG_LOG_FS_COMMANDS == 1
 
 /**
@@ -192,6 +750,9 @@ int log_module_init()
 
     module.handler.chout_p = sys_get_stdout();
     module.handler.next_p = NULL;
+#if CONFIG_LOG_ASYNC == 1
+    module.handler.async_p = NULL;
+#endif
 
     module.object.name_p = "log";
     module.object.mask = LOG_UPTO(INFO);
@@ -227,6 +788,10 @@ int log_add_handler(struct log_handler_t *handler_p)
     mutex_lock(&module.mutex);
 
     handler_p->next_p = module.handler.next_p;
+
+    /* Asynchronous handlers are traversed without the lock, so the
+       handler must be initialized before it is added. */
+    COMPILER_BARRIER();
     module.handler.next_p = handler_p;
 
     mutex_unlock(&module.mutex);
@@ -247,15 +812,16 @@ int log_remove_handler(struct log_handler_t *handler_p)
 
     while (curr_p != NULL) {
         if (curr_p == handler_p) {
-            if (prev_p != NULL) {
-                prev_p->next_p = curr_p->next_p;
-            }
-
-            curr_p->next_p = NULL;
+            /* The next pointer of the removed handler is left as is
+               for any thread traversing the list without the lock. */
+            prev_p->next_p = curr_p->next_p;
             mutex_unlock(&module.mutex);
 
             return (0);
         }
+
+        prev_p = curr_p;
+        curr_p = curr_p->next_p;
     }
 
     mutex_unlock(&module.mutex);
@@ -321,6 +887,9 @@ int log_handler_init(struct log_handler_t *self_p,
 
     self_p->chout_p = chout_p;
     self_p->next_p = NULL;
+#if CONFIG_LOG_ASYNC == 1
+    self_p->async_p = NULL;
+#endif
 
     return (0);
 }
@@ -375,6 +944,15 @@ int log_object_print(struct log_object_t *self_p,
     void *chout_p;
     int count;
     const char *name_p;
+    char buf[CONFIG_LOG_OUTPUT_BUFFER_MAX];
+    ssize_t size;
+    ssize_t res;
+#if CONFIG_LOG_BINARY == 1
+    struct log_binary_buffer_t *buffer_p;
+#endif
+#if CONFIG_LOG_ASYNC == 1
+    int sync;
+#endif
 
     /* Level filtering. */
     if (self_p == NULL) {
@@ -392,22 +970,25 @@ int log_object_print(struct log_object_t *self_p,
         name_p = self_p->name_p;
     }
 
-    /* Print the formatted log entry to all handlers. */
-    count = 0;
-    handler_p = &module.handler;
-
-    mutex_lock(&module.mutex);
+#if CONFIG_LOG_BINARY == 1
+    /* Write a binary entry to the thread's buffer, without taking
+       the module lock. */
+    buffer_p = thrd_self()->log_binary_buffer_p;
 
-    time_get(&now);
+    if ((buffer_p != NULL) && (module.binary.chout_p != NULL)) {
+        va_start(ap, fmt_p);
+        res = binary_record(buffer_p, level, name_p, fmt_p, &ap);
+        va_end(ap);
 
-    while (handler_p != NULL) {
-        chout_p = handler_p->chout_p;
+        return (res);
+    }
+#endif
 
-        if (chout_p != NULL) {
-            chan_control(chout_p, CHAN_CONTROL_LOG_BEGIN);
+    time_get(&now);
 
-            /* Write the header. */
-            std_fprintf(chout_p,
+    /* Format the entry once if it fits in the buffer. */
+    size = std_snprintf(&buf[0],
+                        sizeof(buf),
                         FSTR("%lu.%03lu:%S:%s:%s: "),
                         now.seconds,
                         now.nanoseconds / 1000000ul,
@@ -415,10 +996,87 @@ int log_object_print(struct log_object_t *self_p,
                         thrd_get_name(),
                         name_p);
 
-            /* Write the custom message. */
-            va_start(ap, fmt_p);
-            std_vfprintf(chout_p, fmt_p, &ap);
-            va_end(ap);
+    if (size >= 0) {
+        va_start(ap, fmt_p);
+        res = std_vsnprintf(&buf[size], sizeof(buf) - size, fmt_p, &ap);
+        va_end(ap);
+
+        if (res >= 0) {
+            size += res;
+        } else {
+            size = res;
+        }
+    }
+
+    count = 0;
+
+#if CONFIG_LOG_ASYNC == 1
+    /* Add the entry to all asynchronous handlers without taking the
+       lock. */
+    sync = 0;
+    handler_p = &module.handler;
+
+    while (handler_p != NULL) {
+        if (handler_p->async_p != NULL) {
+            if (size >= 0) {
+                async_write(handler_p->async_p, &buf[0], size);
+            } else {
+                async_write(handler_p->async_p, &buf[0], strlen(&buf[0]));
+            }
+
+            count++;
+        } else if (handler_p->chout_p != NULL) {
+            sync = 1;
+        }
+
+        handler_p = handler_p->next_p;
+    }
+
+    if (sync == 0) {
+        return (count);
+    }
+#endif
+
+    /* Print the formatted log entry to all handlers. */
+    handler_p = &module.handler;
+
+    mutex_lock(&module.mutex);
+
+    while (handler_p != NULL) {
+        chout_p = handler_p->chout_p;
+
+#if CONFIG_LOG_ASYNC == 1
+        if (handler_p->async_p != NULL) {
+            chout_p = NULL;
+        }
+#endif
+
+        if (chout_p != NULL) {
+            chan_control(chout_p, CHAN_CONTROL_LOG_BEGIN);
+
+            if (size >= 0) {
+                chan_write(chout_p, &buf[0], size);
+            } else {
+                /* Write the header. */
+                std_fprintf_buffered(chout_p,
+                                     &buf[0],
+                                     sizeof(buf),
+                                     FSTR("%lu.%03lu:%S:%s:%s: "),
+                                     now.seconds,
+                                     now.nanoseconds / 1000000ul,
+                                     level_as_string[level],
+                                     thrd_get_name(),
+                                     name_p);
+
+                /* Write the custom message. */
+                va_start(ap, fmt_p);
+                std_vfprintf_buffered(chout_p,
+                                      &buf[0],
+                                      sizeof(buf),
+                                      fmt_p,
+                                      &ap);
+                va_end(ap);
+            }
 
             chan_control(chout_p, CHAN_CONTROL_LOG_END);
 
@@ -432,3 +1090,256 @@ int log_object_print(struct log_object_t *self_p,
 
     return (count);
 }
+
+#if CONFIG_LOG_BINARY == 1
+
+int log_binary_buffer_init(struct log_binary_buffer_t *self_p,
+                           void *buf_p,
+                           size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN((size > 0) && ((size & (size - 1)) == 0), EINVAL);
+
+    struct thrd_t *thrd_p;
+
+    thrd_p = thrd_self();
+
+    self_p->thrd_p = thrd_p;
+    self_p->buf_p = buf_p;
+    self_p->size = size;
+    self_p->head = 0;
+    self_p->tail = 0;
+    self_p->dropped = 0;
+    self_p->dropped_reported = 0;
+
+    mutex_lock(&module.mutex);
+
+    self_p->next_p = module.binary.buffers_p;
+    module.binary.buffers_p = self_p;
+    thrd_p->log_binary_buffer_p = self_p;
+
+    mutex_unlock(&module.mutex);
+
+    return (0);
+}
+
+int log_binary_buffer_deinit(struct log_binary_buffer_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    struct log_binary_buffer_t **buffer_pp;
+
+    mutex_lock(&module.mutex);
+
+    buffer_pp = &module.binary.buffers_p;
+
+    while (*buffer_pp != NULL) {
+        if (*buffer_pp == self_p) {
+            *buffer_pp = self_p->next_p;
+            break;
+        }
+
+        buffer_pp = &(*buffer_pp)->next_p;
+    }
+
+    if (self_p->thrd_p->log_binary_buffer_p == self_p) {
+        self_p->thrd_p->log_binary_buffer_p = NULL;
+    }
+
+    mutex_unlock(&module.mutex);
+
+    return (0);
+}
+
+int log_binary_set_output_channel(void *chout_p)
+{
+    mutex_lock(&module.mutex);
+
+    module.binary.chout_p = chout_p;
+    module.binary.info_written = 0;
+    memset(&module.binary.strings[0], 0, sizeof(module.binary.strings));
+
+    mutex_unlock(&module.mutex);
+
+    return (0);
+}
+
+ssize_t log_binary_drain(void)
+{
+    struct log_binary_buffer_t *buffer_p;
+    ssize_t res;
+
+    res = 0;
+
+    mutex_lock(&module.mutex);
+
+    if (module.binary.chout_p != NULL) {
+        if (module.binary.info_written == 0) {
+            res += binary_write_info();
+            module.binary.info_written = 1;
+        }
+
+        buffer_p = module.binary.buffers_p;
+
+        while (buffer_p != NULL) {
+            res += binary_drain_buffer(buffer_p);
+            buffer_p = buffer_p->next_p;
+        }
+    }
+
+    mutex_unlock(&module.mutex);
+
+    return (res);
+}
+
+void *log_binary_main(void *arg_p)
+{
+    thrd_set_name("log_binary");
+
+    while (1) {
+        log_binary_drain();
+        thrd_sleep_ms(CONFIG_LOG_BINARY_DRAIN_PERIOD_MS);
+    }
+
+    return (NULL);
+}
+
+#endif
+
+#if CONFIG_LOG_ASYNC == 1
+
+int log_async_init(struct log_async_t *self_p,
+                   void *chout_p,
+                   struct log_async_entry_t *entries_p,
+                   size_t length,
+                   int policy,
+                   far_string_t dropped_path_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(chout_p != NULL, EINVAL);
+    ASSERTN(entries_p != NULL, EINVAL);
+    ASSERTN((length > 0) && ((length & (length - 1)) == 0), EINVAL);
+    ASSERTN((policy == LOG_ASYNC_POLICY_DROP_NEWEST)
+            || (policy == LOG_ASYNC_POLICY_DROP_OLDEST), EINVAL);
+
+    size_t i;
+
+    self_p->chout_p = chout_p;
+    self_p->entries_p = entries_p;
+    self_p->mask = (length - 1);
+    self_p->policy = policy;
+    self_p->enqueue_pos = 0;
+    self_p->dequeue_pos = 0;
+    self_p->dropped = 0;
+    self_p->waiting = 0;
+    sem_init(&self_p->sem, 1, 1);
+    fs_counter_reset(&self_p->dropped_counter);
+
+    for (i = 0; i < length; i++) {
+        entries_p[i].sequence = i;
+    }
+
+    if (dropped_path_p != NULL) {
+        fs_counter_init(&self_p->dropped_counter, dropped_path_p, 0);
+        fs_counter_register(&self_p->dropped_counter);
+    }
+
+    return (0);
+}
+
+ssize_t log_async_drain(struct log_async_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    struct log_async_entry_t *entry_p;
+    size_t pos;
+    ssize_t count;
+
+    count = 0;
+
+    while (1) {
+        pos = ATOMIC_LOAD(&self_p->dequeue_pos);
+        entry_p = async_claim(self_p, pos);
+
+        if (entry_p == NULL) {
+            /* Empty, or the oldest entry was just dropped by a
+               producer. */
+            entry_p = &self_p->entries_p[pos & self_p->mask];
+
+            if (ATOMIC_LOAD(&entry_p->sequence) != pos + 1) {
+                break;
+            }
+
+            continue;
+        }
+
+        /* The entry stays claimed while written, so a slow output
+           channel only fills the ring. */
+        chan_control(self_p->chout_p, CHAN_CONTROL_LOG_BEGIN);
+        chan_write(self_p->chout_p, &entry_p->buf[0], entry_p->size);
+        chan_control(self_p->chout_p, CHAN_CONTROL_LOG_END);
+        async_release(self_p, entry_p, pos);
+        count++;
+    }
+
+    fs_counter_increment(&self_p->dropped_counter,
+                         ATOMIC_EXCHANGE(&self_p->dropped, 0));
+
+    return (count);
+}
+
+uint64_t log_async_get_dropped(struct log_async_t *self_p)
+{
+    return (fs_counter_get(&self_p->dropped_counter)
+            + ATOMIC_LOAD(&self_p->dropped));
+}
+
+void *log_async_main(void *arg_p)
+{
+    struct log_async_t *self_p;
+    struct log_async_entry_t *entry_p;
+    size_t pos;
+    int waiting;
+
+    self_p = arg_p;
+    thrd_set_name("log_async");
+
+    while (1) {
+        log_async_drain(self_p);
+
+        /* Wait for a producer to wake this thread up, unless an entry
+           was added after the drain. */
+        ATOMIC_STORE(&self_p->waiting, 1);
+        ATOMIC_FENCE();
+        pos = ATOMIC_LOAD(&self_p->dequeue_pos);
+        entry_p = &self_p->entries_p[pos & self_p->mask];
+
+        if (ATOMIC_LOAD(&entry_p->sequence) == pos + 1) {
+            waiting = 1;
+
+            if (ATOMIC_CAS(&self_p->waiting, &waiting, 0)) {
+                continue;
+            }
+        }
+
+        sem_take(&self_p->sem, NULL);
+    }
+
+    return (NULL);
+}
+
+int log_handler_init_async(struct log_handler_t *self_p,
+                           struct log_async_t *async_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(async_p != NULL, EINVAL);
+
+    self_p->chout_p = async_p->chout_p;
+    self_p->next_p = NULL;
+    self_p->async_p = async_p;
+
+    return (0);
+}
+
+#endif
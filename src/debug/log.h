@@ -56,9 +56,42 @@
 /** Clear all levels. */
 #define LOG_NONE        0x00
 
+/* Asynchronous log handler overflow policies. */
+#define LOG_ASYNC_POLICY_DROP_NEWEST                        0
+#define LOG_ASYNC_POLICY_DROP_OLDEST                        1
+
+/**
+ * An entry slot in an asynchronous log handler ring.
+ */
+struct log_async_entry_t {
+    volatile size_t sequence;
+    size_t size;
+    char buf[CONFIG_LOG_OUTPUT_BUFFER_MAX];
+};
+
+/**
+ * A bounded multi producer ring of formatted log entries, written to
+ * an output channel by a drain thread.
+ */
+struct log_async_t {
+    void *chout_p;
+    struct log_async_entry_t *entries_p;
+    size_t mask;
+    int policy;
+    volatile size_t enqueue_pos;
+    volatile size_t dequeue_pos;
+    volatile uint32_t dropped;
+    volatile int waiting;
+    struct sem_t sem;
+    struct fs_counter_t dropped_counter;
+};
+
 struct log_handler_t {
     void *chout_p;
     struct log_handler_t *next_p;
+#if CONFIG_LOG_ASYNC == 1
+    struct log_async_t *async_p;
+#endif
 };
 
 struct log_object_t {
@@ -67,6 +100,28 @@ struct log_object_t {
     struct log_object_t *next_p;
 };
 
+/* Binary log stream record types. */
+#define LOG_BINARY_RECORD_TYPE_INFO                         1
+#define LOG_BINARY_RECORD_TYPE_STRING                       2
+#define LOG_BINARY_RECORD_TYPE_ENTRY                        3
+#define LOG_BINARY_RECORD_TYPE_DROPPED                      4
+
+/**
+ * A binary log entry ring buffer owned by a single thread. The owning
+ * thread writes entries and the drain function reads them, without
+ * any locks.
+ */
+struct log_binary_buffer_t {
+    struct thrd_t *thrd_p;
+    uint8_t *buf_p;
+    size_t size;
+    volatile size_t head;
+    volatile size_t tail;
+    volatile uint32_t dropped;
+    uint32_t dropped_reported;
+    struct log_binary_buffer_t *next_p;
+};
+
 /**
  * Initialize the logging module. This function must be called before
  * calling any other function in this module.
@@ -154,6 +209,79 @@ int log_object_print(struct log_object_t *self_p,
 int log_handler_init(struct log_handler_t *self_p,
                      void *chout_p);
 
+#if CONFIG_LOG_ASYNC == 1
+
+/**
+ * Initialize given asynchronous log handler ring. Logging threads
+ * add formatted entries to the ring without taking any lock, and the
+ * drain thread `log_async_main()` writes them to given output
+ * channel. A slow output channel therefore never blocks a logging
+ * thread.
+ *
+ * An entry is truncated to ``CONFIG_LOG_OUTPUT_BUFFER_MAX``
+ * bytes. Entries that do not fit in the ring are dropped according to
+ * given policy and counted.
+ *
+ * @param[out] self_p Ring to initialize.
+ * @param[in] chout_p Output channel.
+ * @param[in] entries_p Entry slots.
+ * @param[in] length Number of entry slots. Must be a power of two.
+ * @param[in] policy Overflow policy, ``LOG_ASYNC_POLICY_DROP_NEWEST``
+ *                   or ``LOG_ASYNC_POLICY_DROP_OLDEST``.
+ * @param[in] dropped_path_p File system counter path of the number
+ *                           of dropped entries, or NULL.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_async_init(struct log_async_t *self_p,
+                   void *chout_p,
+                   struct log_async_entry_t *entries_p,
+                   size_t length,
+                   int policy,
+                   far_string_t dropped_path_p);
+
+/**
+ * Write all entries in given ring to its output channel.
+ *
+ * @param[in] self_p Initialized ring.
+ *
+ * @return Number of written entries, or negative error code.
+ */
+ssize_t log_async_drain(struct log_async_t *self_p);
+
+/**
+ * Get the number of dropped entries in given ring.
+ *
+ * @param[in] self_p Initialized ring.
+ *
+ * @return Number of dropped entries.
+ */
+uint64_t log_async_get_dropped(struct log_async_t *self_p);
+
+/**
+ * Thread entry function that waits for entries in given ring and
+ * writes them to its output channel.
+ *
+ * @param[in] arg_p Ring to drain.
+ *
+ * @return Never returns.
+ */
+void *log_async_main(void *arg_p);
+
+/**
+ * Initialize given log handler to add entries to given asynchronous
+ * log handler ring.
+ *
+ * @param[in] self_p Log handler to initialize.
+ * @param[in] async_p Initialized ring.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_handler_init_async(struct log_handler_t *self_p,
+                           struct log_async_t *async_p);
+
+#endif
+
 /**
  * Add given log handler to the list of log handlers. Log entries will
  * be written to all log handlers in the list.
@@ -165,7 +293,9 @@ int log_handler_init(struct log_handler_t *self_p,
 int log_add_handler(struct log_handler_t *handler_p);
 
 /**
- * Remove given log handler from the list of log handlers.
+ * Remove given log handler from the list of log handlers. A logging
+ * thread may still be using the handler when this function returns,
+ * so do not reinitialize it immediately.
  *
  * @param[in] handler_p Log handler to remove.
  *
@@ -204,4 +334,72 @@ int log_remove_object(struct log_object_t *object_p);
  */
 int log_set_default_handler_output_channel(void *chout_p);
 
+#if CONFIG_LOG_BINARY == 1
+
+/**
+ * Initialize given binary log buffer and attach it to the calling
+ * thread. Entries logged by the thread are written to this buffer
+ * instead of being formatted, once an output channel has been set
+ * with `log_binary_set_output_channel()`.
+ *
+ * An entry only contains the format string address, the log object
+ * and thread name addresses, a timestamp and the raw arguments. The
+ * strings are written to the output channel once by the drain
+ * function, so they must not change while in use. String arguments
+ * are copied into the entry, truncated to
+ * ``CONFIG_LOG_BINARY_STRING_MAX`` bytes.
+ *
+ * Decode the output stream on the host with ``make/logdecoder.py``.
+ *
+ * @param[out] self_p Buffer to initialize.
+ * @param[in] buf_p Buffer memory.
+ * @param[in] size Size of the buffer memory. Must be a power of two.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_binary_buffer_init(struct log_binary_buffer_t *self_p,
+                           void *buf_p,
+                           size_t size);
+
+/**
+ * Detach given binary log buffer from its thread. Entries not yet
+ * drained are discarded.
+ *
+ * @param[in] self_p Initialized buffer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_binary_buffer_deinit(struct log_binary_buffer_t *self_p);
+
+/**
+ * Set the binary log output channel.
+ *
+ * @param[in] chout_p Output channel, or NULL to disable binary logging
+ *                    and format all entries as text.
+ *
+ * @return zero(0) or negative error code.
+ */
+int log_binary_set_output_channel(void *chout_p);
+
+/**
+ * Write all entries in all binary log buffers to the binary log
+ * output channel.
+ *
+ * @return Number of bytes written to the output channel, or negative
+ *         error code.
+ */
+ssize_t log_binary_drain(void);
+
+/**
+ * Thread entry function that drains the binary log buffers every
+ * ``CONFIG_LOG_BINARY_DRAIN_PERIOD_MS`` milliseconds.
+ *
+ * @param[in] arg_p Unused.
+ *
+ * @return Never returns.
+ */
+void *log_binary_main(void *arg_p);
+
+#endif
+
 #endif
@@ -66,7 +66,11 @@ int uart_init(struct uart_driver_t *self_p,
     mutex_init(&self_p->mutex);
 
     /* The base channel is used for both TX and RX. */
+#if defined(UART_PORT_RX_SPSC_QUEUE)
+    spsc_queue_init(&self_p->base, rxbuf_p, size);
+#else
     queue_init(&self_p->base, rxbuf_p, size);
+#endif
     chan_set_write_cb(&self_p->base.base, uart_port_write_cb);
     chan_set_write_isr_cb(&self_p->base.base, uart_port_write_cb_isr);
 
@@ -162,8 +162,13 @@ int uart_set_frame_format(struct uart_driver_t *self_p, int format);
  *
  * @return Number of received bytes or negative error code.
  */
-#define uart_read(self_p, buf_p, size)           \
+#if defined(UART_PORT_RX_SPSC_QUEUE)
+#    define uart_read(self_p, buf_p, size)              \
+    spsc_queue_read(&(self_p)->base, buf_p, size)
+#else
+#    define uart_read(self_p, buf_p, size)              \
     queue_read(&(self_p)->base, buf_p, size)
+#endif
 
 /**
  * Write data to the UART.
@@ -0,0 +1,186 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "file_block_device.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+
+static void busy_wait(int us)
+{
+    struct timespec start;
+    struct timespec now;
+    long elapsed_us;
+
+    if (us <= 0) {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed_us = ((now.tv_sec - start.tv_sec) * 1000000L
+                      + (now.tv_nsec - start.tv_nsec) / 1000L);
+    } while (elapsed_us < us);
+}
+
+static int check_range(struct file_block_device_t *self_p,
+                       uint32_t block,
+                       size_t number_of_blocks)
+{
+    if ((number_of_blocks == 0)
+        || (block >= self_p->number_of_blocks)
+        || (number_of_blocks > self_p->number_of_blocks - block)) {
+        return (-EINVAL);
+    }
+
+    return (0);
+}
+
+int file_block_device_init(struct file_block_device_t *self_p,
+                           const char *path_p,
+                           uint32_t number_of_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(path_p != NULL, EINVAL);
+    ASSERTN(number_of_blocks > 0, EINVAL);
+
+    off_t size;
+
+    /* The file system open flags of Simba shadow the host flags, so
+       stdio is used to open the file. */
+    self_p->file_p = fopen(path_p, "r+b");
+
+    if (self_p->file_p == NULL) {
+        self_p->file_p = fopen(path_p, "w+b");
+
+        if (self_p->file_p == NULL) {
+            return (-EIO);
+        }
+    }
+
+    self_p->fd = fileno(self_p->file_p);
+    size = ((off_t)number_of_blocks * BLOCK_DEVICE_BLOCK_SIZE);
+
+    if (lseek(self_p->fd, 0, SEEK_END) < size) {
+        if (ftruncate(self_p->fd, size) != 0) {
+            fclose(self_p->file_p);
+
+            return (-EIO);
+        }
+    }
+
+    self_p->number_of_blocks = number_of_blocks;
+    self_p->command_latency_us = 0;
+    self_p->block_latency_us = 0;
+
+    return (0);
+}
+
+int file_block_device_close(struct file_block_device_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    if (fclose(self_p->file_p) != 0) {
+        return (-EIO);
+    }
+
+    return (0);
+}
+
+int file_block_device_set_latency(struct file_block_device_t *self_p,
+                                  int command_latency_us,
+                                  int block_latency_us)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(command_latency_us >= 0, EINVAL);
+    ASSERTN(block_latency_us >= 0, EINVAL);
+
+    self_p->command_latency_us = command_latency_us;
+    self_p->block_latency_us = block_latency_us;
+
+    return (0);
+}
+
+ssize_t file_block_device_read(struct file_block_device_t *self_p,
+                               void *dst_p,
+                               uint32_t src_block,
+                               size_t number_of_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+
+    ssize_t size;
+
+    if (check_range(self_p, src_block, number_of_blocks) != 0) {
+        return (-EINVAL);
+    }
+
+    busy_wait(self_p->command_latency_us
+              + number_of_blocks * self_p->block_latency_us);
+    size = (number_of_blocks * BLOCK_DEVICE_BLOCK_SIZE);
+
+    if (pread(self_p->fd,
+              dst_p,
+              size,
+              (off_t)src_block * BLOCK_DEVICE_BLOCK_SIZE) != size) {
+        return (-EIO);
+    }
+
+    return (size);
+}
+
+ssize_t file_block_device_write(struct file_block_device_t *self_p,
+                                uint32_t dst_block,
+                                const void *src_p,
+                                size_t number_of_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(src_p != NULL, EINVAL);
+
+    ssize_t size;
+
+    if (check_range(self_p, dst_block, number_of_blocks) != 0) {
+        return (-EINVAL);
+    }
+
+    busy_wait(self_p->command_latency_us
+              + number_of_blocks * self_p->block_latency_us);
+    size = (number_of_blocks * BLOCK_DEVICE_BLOCK_SIZE);
+
+    if (pwrite(self_p->fd,
+               src_p,
+               size,
+               (off_t)dst_block * BLOCK_DEVICE_BLOCK_SIZE) != size) {
+        return (-EIO);
+    }
+
+    return (size);
+}
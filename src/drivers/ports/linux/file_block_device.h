@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __DRIVERS_FILE_BLOCK_DEVICE_H__
+#define __DRIVERS_FILE_BLOCK_DEVICE_H__
+
+#include "simba.h"
+
+/**
+ * A block device backed by a file on the host, with optional
+ * emulated transfer latency.
+ */
+struct file_block_device_t {
+    void *file_p;
+    int fd;
+    uint32_t number_of_blocks;
+    int command_latency_us;
+    int block_latency_us;
+};
+
+/**
+ * Open given file as a block device. The file is created and resized
+ * to given number of blocks if needed.
+ *
+ * @param[out] self_p Block device to initialize.
+ * @param[in] path_p Path of the file.
+ * @param[in] number_of_blocks Size of the device in blocks of
+ *                             `BLOCK_DEVICE_BLOCK_SIZE` bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int file_block_device_init(struct file_block_device_t *self_p,
+                           const char *path_p,
+                           uint32_t number_of_blocks);
+
+/**
+ * Close given block device.
+ *
+ * @param[in] self_p Initialized block device.
+ *
+ * @return zero(0) or negative error code.
+ */
+int file_block_device_close(struct file_block_device_t *self_p);
+
+/**
+ * Emulate the transfer time of a device, for example an SD card on a
+ * SPI bus. Each read and write busy waits given command latency plus
+ * given latency per block, as the CPU does when transferring blocks
+ * over a SPI bus. Both are zero by default.
+ *
+ * @param[in] self_p Initialized block device.
+ * @param[in] command_latency_us Latency of each read and write in
+ *                               microseconds.
+ * @param[in] block_latency_us Latency of each block in
+ *                             microseconds.
+ *
+ * @return zero(0) or negative error code.
+ */
+int file_block_device_set_latency(struct file_block_device_t *self_p,
+                                  int command_latency_us,
+                                  int block_latency_us);
+
+/**
+ * Read given number of consecutive blocks. Compatible with
+ * `block_device_read_t`.
+ *
+ * @return Number of read bytes or negative error code.
+ */
+ssize_t file_block_device_read(struct file_block_device_t *self_p,
+                               void *dst_p,
+                               uint32_t src_block,
+                               size_t number_of_blocks);
+
+/**
+ * Write given number of consecutive blocks. Compatible with
+ * `block_device_write_t`.
+ *
+ * @return Number of written bytes or negative error code.
+ */
+ssize_t file_block_device_write(struct file_block_device_t *self_p,
+                                uint32_t dst_block,
+                                const void *src_p,
+                                size_t number_of_blocks);
+
+#endif
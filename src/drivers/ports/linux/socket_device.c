@@ -133,7 +133,7 @@ static void *uart_client_main(void *arg_p)
 {
     struct uart_client_t *client_p;
     ssize_t size;
-    uint8_t byte;
+    uint8_t buf[64];
 
     client_p = arg_p;
 
@@ -142,21 +142,17 @@ static void *uart_client_main(void *arg_p)
     fflush(stdout);
 
     while (1) {
-        size = read(client_p->socket, &byte, sizeof(byte));
+        size = read(client_p->socket, &buf[0], sizeof(buf));
 
-        if (size != sizeof(byte)) {
+        if (size <= 0) {
             break;
         }
 
-        sys_lock();
-
+        /* This thread is the only producer, so all received bytes
+           are written to the queue without the system lock. */
         if (client_p->dev_p->drv_p != NULL) {
-            queue_write_isr(&client_p->dev_p->drv_p->base,
-                            &byte,
-                            sizeof(byte));
+            spsc_queue_write(&client_p->dev_p->drv_p->base, &buf[0], size);
         }
-
-        sys_unlock();
     }
 
     close(client_p->socket);
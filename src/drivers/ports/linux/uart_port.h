@@ -36,12 +36,18 @@
  */
 #define UART_PORT_FRAME_FORMAT_DEFAULT 0
 
+/*
+ * Received data is written to a lock-free single producer, single
+ * consumer queue by the socket device thread.
+ */
+#define UART_PORT_RX_SPSC_QUEUE
+
 struct uart_device_t {
     struct uart_driver_t *drv_p;
 };
 
 struct uart_driver_t {
-    struct queue_t base;
+    struct spsc_queue_t base;
     struct uart_device_t *dev_p;
     struct mutex_t mutex;
     long baudrate;
@@ -0,0 +1,599 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#if CONFIG_BLOCK_DEVICE == 1
+
+/* Buffer states. */
+#define STATE_FREE                                          0
+#define STATE_CLEAN                                         1
+#define STATE_DIRTY                                         2
+#define STATE_READ_QUEUED                                   3
+#define STATE_READING                                       4
+#define STATE_WRITING                                       5
+
+static inline uint8_t *buffer_data(struct block_device_t *self_p,
+                                   int index)
+{
+    return (&self_p->data_p[index * BLOCK_DEVICE_BLOCK_SIZE]);
+}
+
+static inline int is_evictable(struct block_device_buffer_t *buffer_p)
+{
+    return ((buffer_p->state == STATE_FREE)
+            || (buffer_p->state == STATE_CLEAN));
+}
+
+/**
+ * Returns the index of the buffer of given block, or -1 if the block
+ * is not buffered.
+ */
+static int find(struct block_device_t *self_p, uint32_t block)
+{
+    int i;
+    struct block_device_buffer_t *buffer_p;
+
+    for (i = 0; i < self_p->number_of_buffers; i++) {
+        buffer_p = &self_p->buffers_p[i];
+
+        if ((buffer_p->state != STATE_FREE) && (buffer_p->block == block)) {
+            return (i);
+        }
+    }
+
+    return (-1);
+}
+
+static int find_state(struct block_device_t *self_p, int state)
+{
+    int i;
+
+    for (i = 0; i < self_p->number_of_buffers; i++) {
+        if (self_p->buffers_p[i].state == state) {
+            return (i);
+        }
+    }
+
+    return (-1);
+}
+
+/**
+ * Returns the number of buffers in given state, starting at given
+ * buffer, with consecutive blocks.
+ */
+static int run_length(struct block_device_t *self_p, int first, int state)
+{
+    int length;
+    struct block_device_buffer_t *buffers_p;
+
+    buffers_p = self_p->buffers_p;
+    length = 1;
+
+    while ((first + length < self_p->number_of_buffers)
+           && (buffers_p[first + length].state == state)
+           && (buffers_p[first + length].block
+               == buffers_p[first].block + length)) {
+        length++;
+    }
+
+    return (length);
+}
+
+static void set_state(struct block_device_t *self_p,
+                      int first,
+                      int length,
+                      int state)
+{
+    int i;
+
+    for (i = first; i < first + length; i++) {
+        self_p->buffers_p[i].state = state;
+    }
+}
+
+static int is_sequential(struct block_device_t *self_p, uint32_t block)
+{
+    return ((block == self_p->next_block)
+            || ((block > 0) && (find(self_p, block - 1) != -1)));
+}
+
+/**
+ * Allocate up to given number of buffers with consecutive indices,
+ * for consecutive blocks starting at given block. Buffers are
+ * allocated round-robin, so that consecutively allocated blocks can
+ * be transferred in one call. An already buffered block ends the
+ * run. Returns the index of the first buffer, or -1 if all buffers
+ * are dirty or in transfer.
+ */
+static int alloc_run(struct block_device_t *self_p,
+                     uint32_t block,
+                     int length,
+                     int *length_p)
+{
+    int i;
+    int first;
+    int n;
+    struct block_device_buffer_t *buffer_p;
+
+    for (i = 0; i < self_p->number_of_buffers; i++) {
+        first = ((self_p->cursor + i) % self_p->number_of_buffers);
+
+        if (is_evictable(&self_p->buffers_p[first])) {
+            break;
+        }
+    }
+
+    if (i == self_p->number_of_buffers) {
+        return (-1);
+    }
+
+    /* Wrap early instead of splitting the run at the end of the
+       buffers. */
+    if ((first + length > self_p->number_of_buffers)
+        && is_evictable(&self_p->buffers_p[0])) {
+        first = 0;
+    }
+
+    n = 0;
+
+    while ((n < length) && (first + n < self_p->number_of_buffers)) {
+        buffer_p = &self_p->buffers_p[first + n];
+
+        if (!is_evictable(buffer_p)) {
+            break;
+        }
+
+        if ((n > 0) && (find(self_p, block + n) != -1)) {
+            break;
+        }
+
+        buffer_p->state = STATE_FREE;
+        buffer_p->block = (block + n);
+        n++;
+    }
+
+    self_p->cursor = ((first + n) % self_p->number_of_buffers);
+    *length_p = n;
+
+    return (first);
+}
+
+/**
+ * Read given buffers, which must be in state reading, from the
+ * device. The mutex is unlocked during the transfer.
+ */
+static int transfer_read(struct block_device_t *self_p,
+                         int first,
+                         int length)
+{
+    ssize_t res;
+    uint32_t block;
+
+    block = self_p->buffers_p[first].block;
+    mutex_unlock(&self_p->mutex);
+    res = self_p->read(self_p->arg_p,
+                       buffer_data(self_p, first),
+                       block,
+                       length);
+    mutex_lock(&self_p->mutex);
+
+    self_p->stats.device_reads++;
+    self_p->stats.device_blocks_read += length;
+
+    if (res == length * BLOCK_DEVICE_BLOCK_SIZE) {
+        set_state(self_p, first, length, STATE_CLEAN);
+        res = 0;
+    } else {
+        set_state(self_p, first, length, STATE_FREE);
+
+        if (res >= 0) {
+            res = -EIO;
+        }
+    }
+
+    cond_broadcast(&self_p->cond);
+
+    return (res);
+}
+
+/**
+ * Write the first run of dirty buffers to the device. The mutex is
+ * unlocked during the transfer. A failed write discards the blocks
+ * and sets the error returned by the next flush.
+ */
+static void write_back_run(struct block_device_t *self_p)
+{
+    ssize_t res;
+    int first;
+    int length;
+    uint32_t block;
+
+    first = find_state(self_p, STATE_DIRTY);
+
+    if (first == -1) {
+        return;
+    }
+
+    length = run_length(self_p, first, STATE_DIRTY);
+    set_state(self_p, first, length, STATE_WRITING);
+    self_p->number_of_dirty -= length;
+    block = self_p->buffers_p[first].block;
+    mutex_unlock(&self_p->mutex);
+    res = self_p->write(self_p->arg_p,
+                        block,
+                        buffer_data(self_p, first),
+                        length);
+    mutex_lock(&self_p->mutex);
+
+    self_p->stats.device_writes++;
+    self_p->stats.device_blocks_written += length;
+
+    if (res == length * BLOCK_DEVICE_BLOCK_SIZE) {
+        set_state(self_p, first, length, STATE_CLEAN);
+    } else {
+        set_state(self_p, first, length, STATE_FREE);
+
+        if (self_p->error == 0) {
+            self_p->error = (res < 0 ? res : -EIO);
+        }
+    }
+
+    if (self_p->number_of_dirty == 0) {
+        self_p->write_back_requested = 0;
+    }
+
+    cond_broadcast(&self_p->cond);
+}
+
+static void wait_for_change(struct block_device_t *self_p)
+{
+    cond_wait(&self_p->cond, &self_p->mutex, NULL);
+}
+
+/**
+ * Called when no buffer can be allocated. Dirty buffers are written
+ * back, by the worker thread if running, otherwise by the calling
+ * thread. Without dirty buffers, wait for a transfer to complete.
+ */
+static void make_room(struct block_device_t *self_p)
+{
+    if (self_p->number_of_dirty == 0) {
+        wait_for_change(self_p);
+    } else if (self_p->worker_running) {
+        self_p->write_back_requested = 1;
+        cond_broadcast(&self_p->cond);
+        wait_for_change(self_p);
+    } else {
+        write_back_run(self_p);
+    }
+}
+
+/**
+ * Queue read-ahead of the blocks following given block for the
+ * worker thread. Nothing is queued if the blocks are already
+ * buffered or if no buffers are available.
+ */
+static void queue_read_ahead(struct block_device_t *self_p,
+                             uint32_t block)
+{
+    int first;
+    int length;
+    uint32_t ahead;
+
+    if (!self_p->worker_running || (self_p->read_ahead == 0)) {
+        return;
+    }
+
+    for (ahead = (block + 1); ahead <= block + self_p->read_ahead; ahead++) {
+        if (find(self_p, ahead) == -1) {
+            break;
+        }
+    }
+
+    if (ahead > block + self_p->read_ahead) {
+        return;
+    }
+
+    first = alloc_run(self_p, ahead, self_p->read_ahead, &length);
+
+    if (first == -1) {
+        return;
+    }
+
+    set_state(self_p, first, length, STATE_READ_QUEUED);
+    self_p->stats.read_ahead_blocks += length;
+    cond_broadcast(&self_p->cond);
+}
+
+int block_device_init(struct block_device_t *self_p,
+                      block_device_read_t read,
+                      block_device_write_t write,
+                      void *arg_p,
+                      struct block_device_buffer_t *buffers_p,
+                      void *data_p,
+                      int number_of_buffers)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(read != NULL, EINVAL);
+    ASSERTN(write != NULL, EINVAL);
+    ASSERTN(buffers_p != NULL, EINVAL);
+    ASSERTN(data_p != NULL, EINVAL);
+    ASSERTN(number_of_buffers > 0, EINVAL);
+
+    int i;
+
+    self_p->read = read;
+    self_p->write = write;
+    self_p->arg_p = arg_p;
+    self_p->buffers_p = buffers_p;
+    self_p->data_p = data_p;
+    self_p->number_of_buffers = number_of_buffers;
+    self_p->cursor = 0;
+    self_p->read_ahead = CONFIG_BLOCK_DEVICE_READ_AHEAD;
+    self_p->write_behind = ((number_of_buffers + 1) / 2);
+    self_p->next_block = 0;
+    self_p->number_of_dirty = 0;
+    self_p->write_back_requested = 0;
+    self_p->worker_running = 0;
+    self_p->error = 0;
+    memset(&self_p->stats, 0, sizeof(self_p->stats));
+
+    for (i = 0; i < number_of_buffers; i++) {
+        buffers_p[i].block = 0;
+        buffers_p[i].state = STATE_FREE;
+    }
+
+    mutex_init(&self_p->mutex);
+    cond_init(&self_p->cond);
+
+    return (0);
+}
+
+int block_device_set_read_ahead(struct block_device_t *self_p,
+                                int number_of_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(number_of_blocks >= 0, EINVAL);
+
+    mutex_lock(&self_p->mutex);
+    self_p->read_ahead = number_of_blocks;
+    mutex_unlock(&self_p->mutex);
+
+    return (0);
+}
+
+ssize_t block_device_read(struct block_device_t *self_p,
+                          void *dst_p,
+                          uint32_t src_block)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+
+    ssize_t res;
+    int first;
+    int length;
+    int sequential;
+
+    mutex_lock(&self_p->mutex);
+
+    sequential = is_sequential(self_p, src_block);
+
+    while (1) {
+        first = find(self_p, src_block);
+
+        if (first == -1) {
+            /* Read the block, and the following blocks if
+               sequential, in one transfer. */
+            length = 1;
+
+            if (sequential) {
+                length += self_p->read_ahead;
+            }
+
+            first = alloc_run(self_p, src_block, length, &length);
+
+            if (first != -1) {
+                break;
+            }
+
+            /* The mutex may be released while making room, and the
+               block buffered by someone else meanwhile. */
+            make_room(self_p);
+            continue;
+        }
+
+        switch (self_p->buffers_p[first].state) {
+
+        case STATE_CLEAN:
+        case STATE_DIRTY:
+        case STATE_WRITING:
+            memcpy(dst_p, buffer_data(self_p, first), BLOCK_DEVICE_BLOCK_SIZE);
+            self_p->stats.hits++;
+            res = BLOCK_DEVICE_BLOCK_SIZE;
+            goto out;
+
+        default:
+            wait_for_change(self_p);
+            break;
+        }
+    }
+
+    self_p->stats.misses++;
+    set_state(self_p, first, length, STATE_READING);
+    res = transfer_read(self_p, first, length);
+
+    if (res == 0) {
+        memcpy(dst_p, buffer_data(self_p, first), BLOCK_DEVICE_BLOCK_SIZE);
+        res = BLOCK_DEVICE_BLOCK_SIZE;
+    }
+
+ out:
+    self_p->next_block = (src_block + 1);
+
+    if ((res == BLOCK_DEVICE_BLOCK_SIZE) && sequential) {
+        queue_read_ahead(self_p, src_block);
+    }
+
+    mutex_unlock(&self_p->mutex);
+
+    return (res);
+}
+
+ssize_t block_device_write(struct block_device_t *self_p,
+                           uint32_t dst_block,
+                           const void *src_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(src_p != NULL, EINVAL);
+
+    int index;
+    int length;
+
+    mutex_lock(&self_p->mutex);
+
+    while (1) {
+        index = find(self_p, dst_block);
+
+        if (index == -1) {
+            index = alloc_run(self_p, dst_block, 1, &length);
+
+            if (index == -1) {
+                make_room(self_p);
+                continue;
+            }
+        }
+
+        if (is_evictable(&self_p->buffers_p[index])) {
+            self_p->buffers_p[index].state = STATE_DIRTY;
+            self_p->number_of_dirty++;
+        }
+
+        if (self_p->buffers_p[index].state == STATE_DIRTY) {
+            break;
+        }
+
+        /* Wait for the transfer of the block to complete. */
+        wait_for_change(self_p);
+    }
+
+    memcpy(buffer_data(self_p, index), src_p, BLOCK_DEVICE_BLOCK_SIZE);
+
+    /* Start writing behind. */
+    if (self_p->number_of_dirty >= self_p->write_behind) {
+        if (self_p->worker_running) {
+            cond_broadcast(&self_p->cond);
+        } else {
+            while (self_p->number_of_dirty > 0) {
+                write_back_run(self_p);
+            }
+        }
+    }
+
+    mutex_unlock(&self_p->mutex);
+
+    return (BLOCK_DEVICE_BLOCK_SIZE);
+}
+
+int block_device_flush(struct block_device_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    int res;
+
+    mutex_lock(&self_p->mutex);
+
+    while (1) {
+        if (self_p->number_of_dirty > 0) {
+            write_back_run(self_p);
+        } else if (find_state(self_p, STATE_WRITING) != -1) {
+            wait_for_change(self_p);
+        } else {
+            break;
+        }
+    }
+
+    self_p->stats.flushes++;
+    res = self_p->error;
+    self_p->error = 0;
+
+    mutex_unlock(&self_p->mutex);
+
+    return (res);
+}
+
+int block_device_get_stats(struct block_device_t *self_p,
+                           struct block_device_stats_t *stats_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(stats_p != NULL, EINVAL);
+
+    mutex_lock(&self_p->mutex);
+    *stats_p = self_p->stats;
+    mutex_unlock(&self_p->mutex);
+
+    return (0);
+}
+
+void *block_device_main(void *arg_p)
+{
+    ASSERTNRN(arg_p != NULL, EINVAL);
+
+    struct block_device_t *self_p;
+    int first;
+    int length;
+
+    self_p = arg_p;
+
+    thrd_set_name("block_device");
+
+    mutex_lock(&self_p->mutex);
+    self_p->worker_running = 1;
+
+    while (1) {
+        first = find_state(self_p, STATE_READ_QUEUED);
+
+        if (first != -1) {
+            /* Read ahead. Errors are ignored as the blocks are read
+               again by the reader. */
+            length = run_length(self_p, first, STATE_READ_QUEUED);
+            set_state(self_p, first, length, STATE_READING);
+            transfer_read(self_p, first, length);
+        } else if ((self_p->number_of_dirty >= self_p->write_behind)
+                   || ((self_p->number_of_dirty > 0)
+                       && self_p->write_back_requested)) {
+            write_back_run(self_p);
+        } else {
+            wait_for_change(self_p);
+        }
+    }
+
+    return (NULL);
+}
+
+#endif
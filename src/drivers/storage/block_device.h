@@ -0,0 +1,214 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __DRIVERS_BLOCK_DEVICE_H__
+#define __DRIVERS_BLOCK_DEVICE_H__
+
+#include "simba.h"
+
+/**
+ * Block size in bytes.
+ */
+#define BLOCK_DEVICE_BLOCK_SIZE                           512
+
+/**
+ * Read given number of consecutive blocks from the device.
+ *
+ * @return Number of read bytes or negative error code.
+ */
+typedef ssize_t (*block_device_read_t)(void *arg_p,
+                                       void *dst_p,
+                                       uint32_t src_block,
+                                       size_t number_of_blocks);
+
+/**
+ * Write given number of consecutive blocks to the device.
+ *
+ * @return Number of written bytes or negative error code.
+ */
+typedef ssize_t (*block_device_write_t)(void *arg_p,
+                                        uint32_t dst_block,
+                                        const void *src_p,
+                                        size_t number_of_blocks);
+
+/**
+ * Buffer metadata. The state of all buffers together forms the
+ * request queue of the device.
+ */
+struct block_device_buffer_t {
+    uint32_t block;
+    int8_t state;
+};
+
+struct block_device_stats_t {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t read_ahead_blocks;
+    uint32_t device_reads;
+    uint32_t device_blocks_read;
+    uint32_t device_writes;
+    uint32_t device_blocks_written;
+    uint32_t flushes;
+};
+
+struct block_device_t {
+    block_device_read_t read;
+    block_device_write_t write;
+    void *arg_p;
+    struct block_device_buffer_t *buffers_p;
+    uint8_t *data_p;
+    int number_of_buffers;
+    int cursor;
+    int read_ahead;
+    int write_behind;
+    uint32_t next_block;
+    int number_of_dirty;
+    int write_back_requested;
+    int worker_running;
+    int error;
+    struct mutex_t mutex;
+    struct cond_t cond;
+    struct block_device_stats_t stats;
+};
+
+/**
+ * Initialize given block device. Blocks read from and written to the
+ * device are buffered in given buffers, which are used as a cache
+ * with read-ahead and write-behind. Consecutive blocks in
+ * consecutive buffers are transferred to and from the device in a
+ * single call to `read()` or `write()`.
+ *
+ * Transfers are performed by the calling thread, unless a thread
+ * running `block_device_main()` is started. That thread reads ahead
+ * and writes behind asynchronously.
+ *
+ * @param[out] self_p Block device to initialize.
+ * @param[in] read Multiple block read function.
+ * @param[in] write Multiple block write function.
+ * @param[in] arg_p Argument passed as the first argument to `read()`
+ *                  and `write()`.
+ * @param[in] buffers_p Buffer metadata array.
+ * @param[in] data_p Buffer data of `number_of_buffers *
+ *                   BLOCK_DEVICE_BLOCK_SIZE` bytes.
+ * @param[in] number_of_buffers Number of buffers. Should be at least
+ *                              twice the read-ahead plus two for
+ *                              sequential reads to be fully
+ *                              buffered.
+ *
+ * @return zero(0) or negative error code.
+ */
+int block_device_init(struct block_device_t *self_p,
+                      block_device_read_t read,
+                      block_device_write_t write,
+                      void *arg_p,
+                      struct block_device_buffer_t *buffers_p,
+                      void *data_p,
+                      int number_of_buffers);
+
+/**
+ * Set the number of blocks read ahead of a sequential read. Defaults
+ * to `CONFIG_BLOCK_DEVICE_READ_AHEAD`. A read is sequential if it
+ * follows the previously read block, or if the preceding block is
+ * buffered.
+ *
+ * @param[in] self_p Initialized block device.
+ * @param[in] number_of_blocks Number of blocks to read ahead, or
+ *                             zero(0) to disable read-ahead.
+ *
+ * @return zero(0) or negative error code.
+ */
+int block_device_set_read_ahead(struct block_device_t *self_p,
+                                int number_of_blocks);
+
+/**
+ * Read given block. Compatible with `fat16_read_t`.
+ *
+ * @param[in] self_p Initialized block device.
+ * @param[out] dst_p Buffer of `BLOCK_DEVICE_BLOCK_SIZE` bytes to
+ *                   read into.
+ * @param[in] src_block Block to read.
+ *
+ * @return Number of read bytes or negative error code.
+ */
+ssize_t block_device_read(struct block_device_t *self_p,
+                          void *dst_p,
+                          uint32_t src_block);
+
+/**
+ * Write given block. The block is copied to a buffer and written to
+ * the device later, at the latest by `block_device_flush()`. Errors
+ * of delayed writes are returned by `block_device_flush()`.
+ * Compatible with `fat16_write_t`.
+ *
+ * @param[in] self_p Initialized block device.
+ * @param[in] dst_block Block to write.
+ * @param[in] src_p Buffer of `BLOCK_DEVICE_BLOCK_SIZE` bytes to
+ *                  write.
+ *
+ * @return Number of written bytes or negative error code.
+ */
+ssize_t block_device_write(struct block_device_t *self_p,
+                           uint32_t dst_block,
+                           const void *src_p);
+
+/**
+ * Write all buffered blocks to the device and wait for the writes to
+ * complete. This is a barrier; all blocks written before the call
+ * are on the device when it returns.
+ *
+ * @param[in] self_p Initialized block device.
+ *
+ * @return zero(0) or the negative error code of the first failed
+ *         write since the previous flush. The blocks of a failed
+ *         write are discarded.
+ */
+int block_device_flush(struct block_device_t *self_p);
+
+/**
+ * Get statistics of given block device.
+ *
+ * @param[in] self_p Initialized block device.
+ * @param[out] stats_p Statistics.
+ *
+ * @return zero(0) or negative error code.
+ */
+int block_device_get_stats(struct block_device_t *self_p,
+                           struct block_device_stats_t *stats_p);
+
+/**
+ * Block device thread entry function, performing read-ahead and
+ * write-behind asynchronously. Spawn a thread with this function and
+ * the block device as argument to use it. Never returns.
+ *
+ * @param[in] arg_p Initialized block device.
+ *
+ * @return Never returns.
+ */
+void *block_device_main(void *arg_p);
+
+#endif
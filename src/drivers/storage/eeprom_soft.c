@@ -39,12 +39,62 @@
 
 #define BUFFER_SIZE                                         8
 
+#define LOG_RECORD_HEADER_SIZE  sizeof(struct log_record_header_t)
+#define LOG_ENTRY_HEADER_SIZE   sizeof(struct log_entry_header_t)
+
+/**
+ * Size of a log record with given number of entry bytes, padded to a
+ * multiple of the buffer size.
+ */
+#define LOG_RECORD_SIZE(size)                                   \
+    (LOG_RECORD_HEADER_SIZE + BUFFER_SIZE * DIV_CEIL(size, BUFFER_SIZE))
+
+#if CONFIG_EEPROM_SOFT_CRC == CONFIG_EEPROM_SOFT_CRC_32
+#    define CRC_INIT                                        0
+#elif CONFIG_EEPROM_SOFT_CRC == CONFIG_EEPROM_SOFT_CRC_CCITT
+#    define CRC_INIT                                   0xffff
+#endif
+
 struct chunk_header_t {
     uint32_t crc;
     uint16_t revision;
     uint16_t valid;
 } PACKED;
 
+/**
+ * A log record of one write, followed by one entry per written
+ * address range. The header is written before the entries, so a
+ * record torn by a power loss does not match its CRC.
+ */
+struct log_record_header_t {
+    uint32_t crc;
+    uint16_t size;
+    uint16_t valid;
+} PACKED;
+
+/**
+ * A log entry header, followed by the written data.
+ */
+struct log_entry_header_t {
+    uint16_t address;
+    uint16_t size;
+} PACKED;
+
+struct log_writer_t {
+    uintptr_t address;
+    size_t pos;
+    uint8_t buf[BUFFER_SIZE];
+};
+
+static uint32_t crc_update(uint32_t crc, const void *buf_p, size_t size)
+{
+#if CONFIG_EEPROM_SOFT_CRC == CONFIG_EEPROM_SOFT_CRC_32
+    return (crc_32(crc, buf_p, size));
+#elif CONFIG_EEPROM_SOFT_CRC == CONFIG_EEPROM_SOFT_CRC_CCITT
+    return (crc_ccitt(crc, buf_p, size));
+#endif
+}
+
 /**
  * Calculate the crc of the chunk at given address.
  */
@@ -64,13 +114,18 @@ static uint32_t calculate_chunk_crc(struct eeprom_soft_driver_t *self_p,
     offset = CHUNK_HEADER_SIZE;
 
     while (offset < self_p->chunk_size) {
-        size = flash_read(self_p->flash_p,
-                          &buf[0],
-                          address + offset,
-                          sizeof(buf));
+        if (offset < CHUNK_HEADER_SIZE + self_p->eeprom_size) {
+            size = flash_read(self_p->flash_p,
+                              &buf[0],
+                              address + offset,
+                              sizeof(buf));
 
-        if (size != sizeof(buf)) {
-            return (-1);
+            if (size != sizeof(buf)) {
+                return (-1);
+            }
+        } else {
+            /* The log is blank when the header is written. */
+            memset(&buf[0], 0xff, sizeof(buf));
         }
 
 #if CONFIG_EEPROM_SOFT_CRC == CONFIG_EEPROM_SOFT_CRC_32
@@ -222,11 +277,13 @@ static int write_header(struct eeprom_soft_driver_t *self_p,
 {
     ssize_t size;
     struct chunk_header_t header;
+    uint32_t crc;
 
-    if (calculate_chunk_crc(self_p, &header.crc, chunk_address) != 0) {
+    if (calculate_chunk_crc(self_p, &crc, chunk_address) != 0) {
         return (-1);
     }
 
+    header.crc = crc;
     header.revision = revision;
     header.valid = VALID_PATTERN;
 
@@ -242,6 +299,285 @@ static int write_header(struct eeprom_soft_driver_t *self_p,
     return (0);
 }
 
+static uintptr_t log_address(struct eeprom_soft_driver_t *self_p)
+{
+    return (self_p->current.chunk_address
+            + CHUNK_HEADER_SIZE
+            + self_p->eeprom_size);
+}
+
+/**
+ * Apply the writes in the log of the current chunk to given buffer
+ * with data read from given address.
+ */
+static int log_apply(struct eeprom_soft_driver_t *self_p,
+                     uint8_t *dst_p,
+                     uintptr_t src,
+                     size_t size)
+{
+    struct log_record_header_t header;
+    struct log_entry_header_t entry;
+    uintptr_t address;
+    uintptr_t end;
+    uintptr_t begin;
+    uintptr_t stop;
+    size_t offset;
+
+    offset = 0;
+
+    while (offset < self_p->current.log_offset) {
+        address = (log_address(self_p) + offset);
+
+        if (flash_read(self_p->flash_p,
+                       &header,
+                       address,
+                       sizeof(header)) != sizeof(header)) {
+            return (-1);
+        }
+
+        address += sizeof(header);
+        end = (address + header.size);
+
+        while (address < end) {
+            if (flash_read(self_p->flash_p,
+                           &entry,
+                           address,
+                           sizeof(entry)) != sizeof(entry)) {
+                return (-1);
+            }
+
+            address += sizeof(entry);
+
+            /* Copy the part of the entry overlapping the read. */
+            begin = MAX(entry.address, src);
+            stop = MIN(entry.address + entry.size, src + size);
+
+            if (begin < stop) {
+                if (flash_read(self_p->flash_p,
+                               &dst_p[begin - src],
+                               address + (begin - entry.address),
+                               stop - begin) != (stop - begin)) {
+                    return (-1);
+                }
+            }
+
+            address += entry.size;
+        }
+
+        offset += LOG_RECORD_SIZE(header.size);
+    }
+
+    return (0);
+}
+
+static int log_calculate_record_crc(struct eeprom_soft_driver_t *self_p,
+                                    uintptr_t address,
+                                    uint16_t size,
+                                    uint32_t *crc_p)
+{
+    uint8_t buf[BUFFER_SIZE];
+    size_t offset;
+    size_t left;
+    uint32_t crc;
+
+    crc = crc_update(CRC_INIT, &size, sizeof(size));
+
+    for (offset = 0; offset < size; offset += sizeof(buf)) {
+        left = MIN(sizeof(buf), size - offset);
+
+        if (flash_read(self_p->flash_p,
+                       &buf[0],
+                       address + offset,
+                       left) != left) {
+            return (-1);
+        }
+
+        crc = crc_update(crc, &buf[0], left);
+    }
+
+    *crc_p = crc;
+
+    return (0);
+}
+
+/**
+ * Find the end of the log of the current chunk. A torn record, as
+ * left by a power loss during a write, ends the log and marks it as
+ * full, so the next write compacts the chunk.
+ */
+static int log_mount(struct eeprom_soft_driver_t *self_p)
+{
+    struct log_record_header_t header;
+    uintptr_t address;
+    size_t offset;
+    uint32_t crc;
+
+    offset = 0;
+
+    while (offset + sizeof(header) <= self_p->log_size) {
+        address = (log_address(self_p) + offset);
+
+        if (flash_read(self_p->flash_p,
+                       &header,
+                       address,
+                       sizeof(header)) != sizeof(header)) {
+            return (-1);
+        }
+
+        /* A blank header ends the log. */
+        if ((header.crc == 0xffffffff)
+            && (header.size == 0xffff)
+            && (header.valid == 0xffff)) {
+            break;
+        }
+
+        if ((header.valid != VALID_PATTERN)
+            || (offset + LOG_RECORD_SIZE(header.size) > self_p->log_size)
+            || (log_calculate_record_crc(self_p,
+                                         address + sizeof(header),
+                                         header.size,
+                                         &crc) != 0)
+            || (crc != header.crc)) {
+            self_p->current.log_full = 1;
+            break;
+        }
+
+        offset += LOG_RECORD_SIZE(header.size);
+    }
+
+    self_p->current.log_offset = offset;
+
+    return (0);
+}
+
+/**
+ * Buffer given data and write it to flash in buffer sized pieces.
+ */
+static int log_writer_write(struct eeprom_soft_driver_t *self_p,
+                            struct log_writer_t *writer_p,
+                            const void *buf_p,
+                            size_t size)
+{
+    const uint8_t *u8_buf_p;
+    size_t n;
+
+    u8_buf_p = buf_p;
+
+    while (size > 0) {
+        n = MIN(size, sizeof(writer_p->buf) - writer_p->pos);
+        memcpy(&writer_p->buf[writer_p->pos], u8_buf_p, n);
+        writer_p->pos += n;
+        u8_buf_p += n;
+        size -= n;
+
+        if (writer_p->pos == sizeof(writer_p->buf)) {
+            if (flash_write(self_p->flash_p,
+                            writer_p->address,
+                            &writer_p->buf[0],
+                            sizeof(writer_p->buf)) != sizeof(writer_p->buf)) {
+                return (-1);
+            }
+
+            writer_p->address += sizeof(writer_p->buf);
+            writer_p->pos = 0;
+        }
+    }
+
+    return (0);
+}
+
+/**
+ * Append given writes as a record to the log of the current chunk.
+ */
+static int log_append(struct eeprom_soft_driver_t *self_p,
+                      struct iov_uintptr_t *dst_p,
+                      struct iov_t *src_p,
+                      size_t length,
+                      uint16_t size)
+{
+    struct log_record_header_t header;
+    struct log_entry_header_t entry;
+    struct log_writer_t writer;
+    uint32_t crc;
+    size_t i;
+
+    /* The CRC covers the size and the entries. */
+    crc = crc_update(CRC_INIT, &size, sizeof(size));
+
+    for (i = 0; i < length; i++) {
+        entry.address = dst_p[i].address;
+        entry.size = dst_p[i].size;
+        crc = crc_update(crc, &entry, sizeof(entry));
+        crc = crc_update(crc, src_p[i].buf_p, dst_p[i].size);
+    }
+
+    header.crc = crc;
+    header.size = size;
+    header.valid = VALID_PATTERN;
+    writer.address = (log_address(self_p) + self_p->current.log_offset);
+    writer.pos = 0;
+
+    if (log_writer_write(self_p, &writer, &header, sizeof(header)) != 0) {
+        return (-1);
+    }
+
+    for (i = 0; i < length; i++) {
+        entry.address = dst_p[i].address;
+        entry.size = dst_p[i].size;
+
+        if (log_writer_write(self_p, &writer, &entry, sizeof(entry)) != 0) {
+            return (-1);
+        }
+
+        if (log_writer_write(self_p,
+                             &writer,
+                             src_p[i].buf_p,
+                             dst_p[i].size) != 0) {
+            return (-1);
+        }
+    }
+
+    /* Write the last piece padded with erased bytes. */
+    if (writer.pos > 0) {
+        memset(&writer.buf[writer.pos], 0xff, sizeof(writer.buf) - writer.pos);
+
+        if (flash_write(self_p->flash_p,
+                        writer.address,
+                        &writer.buf[0],
+                        sizeof(writer.buf)) != sizeof(writer.buf)) {
+            return (-1);
+        }
+    }
+
+    self_p->current.log_offset += LOG_RECORD_SIZE(size);
+
+    return (0);
+}
+
+/**
+ * Read from the current chunk, including writes in its log.
+ */
+static ssize_t read_data(struct eeprom_soft_driver_t *self_p,
+                         void *dst_p,
+                         uintptr_t src,
+                         size_t size)
+{
+    ssize_t res;
+
+    res = flash_read(self_p->flash_p,
+                     dst_p,
+                     self_p->current.chunk_address + CHUNK_HEADER_SIZE + src,
+                     size);
+
+    if ((res == size) && (self_p->log_size > 0)) {
+        if (log_apply(self_p, dst_p, src, size) != 0) {
+            res = -1;
+        }
+    }
+
+    return (res);
+}
+
 static int are_overlapping(struct iov_uintptr_t *iov_p,
                            size_t offset)
 {
@@ -281,7 +617,6 @@ static int check_identical(struct eeprom_soft_driver_t *self_p,
     ssize_t res;
     size_t i;
     size_t j;
-    uintptr_t address;
 
     /* Compare given data regions to current EEPROM content. */
     for (i = 0; i < length; i++) {
@@ -289,14 +624,10 @@ static int check_identical(struct eeprom_soft_driver_t *self_p,
 
         for (j = 0; j < dst_p[i].size; j++) {
             /* Read from current chunk. */
-            address = (self_p->current.chunk_address
-                       + CHUNK_HEADER_SIZE
-                       + dst_p[i].address
-                       + j);
-            res = flash_read(self_p->flash_p,
-                             &byte,
-                             address,
-                             sizeof(byte));
+            res = read_data(self_p,
+                            &byte,
+                            dst_p[i].address + j,
+                            sizeof(byte));
 
             if (res != sizeof(byte)) {
                 return (-1);
@@ -317,6 +648,158 @@ static int check_identical(struct eeprom_soft_driver_t *self_p,
 
 #endif
 
+/**
+ * Read the header of given chunk. Returns zero if the header has the
+ * valid pattern, otherwise -1.
+ */
+static int read_header(struct eeprom_soft_driver_t *self_p,
+                       uintptr_t chunk_address,
+                       struct chunk_header_t *header_p)
+{
+    if (flash_read(self_p->flash_p,
+                   header_p,
+                   chunk_address,
+                   sizeof(*header_p)) != sizeof(*header_p)) {
+        return (-1);
+    }
+
+    if (header_p->valid != VALID_PATTERN) {
+        return (-1);
+    }
+
+    return (0);
+}
+
+#if CONFIG_EEPROM_SOFT_MOUNT_BINARY_SEARCH == 1
+
+/**
+ * Find the most recently written chunk. Chunks are written in order
+ * within a block, each with the revision of the previous chunk plus
+ * one, and a block is erased before its first chunk is written. The
+ * block with the latest first chunk is therefore the current block,
+ * and its written chunks form a prefix that is binary searched. Only
+ * one header per block plus a logarithmic number of headers in the
+ * current block are read.
+ */
+static int find_latest_chunk(struct eeprom_soft_driver_t *self_p,
+                             const struct eeprom_soft_block_t **block_pp,
+                             uintptr_t *chunk_address_p,
+                             uint16_t *revision_p)
+{
+    int i;
+    int low;
+    int middle;
+    int high;
+    const struct eeprom_soft_block_t *block_p;
+    struct chunk_header_t header;
+    uint16_t latest_revision;
+    const struct eeprom_soft_block_t *latest_block_p;
+
+    latest_revision = 0;
+    latest_block_p = NULL;
+
+    /* Find the block with the latest first chunk. */
+    for (i = 0; i < self_p->number_of_blocks; i++) {
+        block_p = &self_p->blocks_p[i];
+
+        if (read_header(self_p, block_p->address, &header) != 0) {
+            continue;
+        }
+
+        if ((latest_block_p == NULL)
+            || (is_later_revision(header.revision, latest_revision) == 1)) {
+            latest_revision = header.revision;
+            latest_block_p = block_p;
+        }
+    }
+
+    if (latest_block_p == NULL) {
+        return (-1);
+    }
+
+    /* Find the last written chunk in the block. */
+    low = 0;
+    high = (latest_block_p->size / self_p->chunk_size);
+
+    while ((high - low) > 1) {
+        middle = ((low + high) / 2);
+
+        if ((read_header(self_p,
+                         latest_block_p->address + middle * self_p->chunk_size,
+                         &header) == 0)
+            && (header.revision == (uint16_t)(latest_revision + middle))) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    *block_pp = latest_block_p;
+    *chunk_address_p = (latest_block_p->address + low * self_p->chunk_size);
+    *revision_p = (latest_revision + low);
+
+    return (0);
+}
+
+#else
+
+/**
+ * Find the most recently written chunk, as given by the revision, by
+ * reading the header of all chunks.
+ */
+static int find_latest_chunk(struct eeprom_soft_driver_t *self_p,
+                             const struct eeprom_soft_block_t **block_pp,
+                             uintptr_t *chunk_address_p,
+                             uint16_t *revision_p)
+{
+    int i;
+    int j;
+    uintptr_t chunk_address;
+    const struct eeprom_soft_block_t *block_p;
+    int number_of_chunks;
+    struct chunk_header_t header;
+    uint16_t latest_revision;
+    const struct eeprom_soft_block_t *latest_block_p;
+    uintptr_t latest_chunk_address;
+
+    latest_revision = 0;
+    latest_block_p = NULL;
+    latest_chunk_address = 0;
+
+    for (i = 0; i < self_p->number_of_blocks; i++) {
+        block_p = &self_p->blocks_p[i];
+        number_of_chunks = (block_p->size / self_p->chunk_size);
+
+        for (j = 0; j < number_of_chunks; j++) {
+            chunk_address = (block_p->address + j * self_p->chunk_size);
+
+            if (read_header(self_p, chunk_address, &header) != 0) {
+                continue;
+            }
+
+            /* Keep track of the latest revision chunk. */
+            if ((latest_block_p == NULL)
+                || (is_later_revision(header.revision, latest_revision) == 1)) {
+                latest_revision = header.revision;
+                latest_block_p = block_p;
+                latest_chunk_address = chunk_address;
+            }
+        }
+    }
+
+    if (latest_block_p == NULL) {
+        return (-1);
+    }
+
+    *block_pp = latest_block_p;
+    *chunk_address_p = latest_chunk_address;
+    *revision_p = latest_revision;
+
+    return (0);
+}
+
+#endif
+
 static ssize_t vwrite_inner(struct eeprom_soft_driver_t *self_p,
                             struct iov_uintptr_t *dst_p,
                             struct iov_t *src_p,
@@ -334,6 +817,7 @@ static ssize_t vwrite_inner(struct eeprom_soft_driver_t *self_p,
     size_t i;
     uintptr_t dst;
     size_t size;
+    size_t record_size;
 
     if (self_p->current.block_p == NULL) {
         return (-ENOTMOUNTED);
@@ -365,6 +849,29 @@ static ssize_t vwrite_inner(struct eeprom_soft_driver_t *self_p,
 
 #endif
 
+    /* Append to the log of the current chunk if there is room
+       left. */
+    if (self_p->log_size > 0) {
+        record_size = 0;
+
+        for (i = 0; i < length; i++) {
+            record_size += (LOG_ENTRY_HEADER_SIZE + dst_p[i].size);
+        }
+
+        if ((self_p->current.log_full == 0)
+            && (LOG_RECORD_SIZE(record_size)
+                <= (self_p->log_size - self_p->current.log_offset))) {
+            if (log_append(self_p, dst_p, src_p, length, record_size) != 0) {
+                /* Compact on next write. */
+                self_p->current.log_full = 1;
+
+                return (-1);
+            }
+
+            return (iov_uintptr_size(dst_p, length));
+        }
+    }
+
     if (get_blank_chunk(self_p, &block_p, &chunk_address) != 0) {
         return (-1);
     }
@@ -372,10 +879,7 @@ static ssize_t vwrite_inner(struct eeprom_soft_driver_t *self_p,
     /* Write to new chunk. */
     for (offset = 0; offset < self_p->eeprom_size; offset += sizeof(buf)) {
         /* Read from old chunk. */
-        res = flash_read(self_p->flash_p,
-                         &buf[0],
-                         self_p->current.chunk_address + CHUNK_HEADER_SIZE + offset,
-                         sizeof(buf));
+        res = read_data(self_p, &buf[0], offset, sizeof(buf));
 
         if (res != sizeof(buf)) {
             return (-1);
@@ -420,6 +924,8 @@ static ssize_t vwrite_inner(struct eeprom_soft_driver_t *self_p,
     self_p->current.block_p = block_p;
     self_p->current.chunk_address = chunk_address;
     self_p->current.revision = revision;
+    self_p->current.log_offset = 0;
+    self_p->current.log_full = 0;
 
     return (iov_uintptr_size(dst_p, length));
 }
@@ -445,8 +951,11 @@ int eeprom_soft_init(struct eeprom_soft_driver_t *self_p,
     self_p->number_of_blocks = number_of_blocks;
     self_p->chunk_size = chunk_size;
     self_p->eeprom_size = (chunk_size - CHUNK_HEADER_SIZE);
+    self_p->log_size = 0;
     self_p->current.block_p = NULL;
     self_p->current.chunk_address = 0xffffffff;
+    self_p->current.log_offset = 0;
+    self_p->current.log_full = 0;
 
 #if CONFIG_EEPROM_SOFT_SEMAPHORE == 1
     mutex_init(&self_p->mutex);
@@ -455,6 +964,31 @@ int eeprom_soft_init(struct eeprom_soft_driver_t *self_p,
     return (0);
 }
 
+int eeprom_soft_set_log_size(struct eeprom_soft_driver_t *self_p,
+                             size_t size)
+{
+    size_t eeprom_size;
+
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN((size % BUFFER_SIZE) == 0, EINVAL);
+    ASSERTN(CHUNK_HEADER_SIZE + size < self_p->chunk_size, EINVAL);
+    ASSERTN(size <= 0xffff, EINVAL);
+
+    /* Log records store 16 bits addresses and sizes. */
+    eeprom_size = (self_p->chunk_size - CHUNK_HEADER_SIZE - size);
+    if ((size > 0) && (eeprom_size > 0xffff)) {
+        return (-EINVAL);
+    }
+
+    self_p->log_size = size;
+    self_p->eeprom_size = eeprom_size;
+    self_p->current.block_p = NULL;
+    self_p->current.log_offset = 0;
+    self_p->current.log_full = 0;
+
+    return (0);
+}
+
 int eeprom_soft_format(struct eeprom_soft_driver_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
@@ -476,66 +1010,34 @@ int eeprom_soft_mount(struct eeprom_soft_driver_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    int res;
-    int i;
-    int j;
-    uintptr_t chunk_address;
     const struct eeprom_soft_block_t *block_p;
-    int number_of_chunks;
-    struct chunk_header_t header;
-    ssize_t size;
-    uint16_t latest_revision;
-    const struct eeprom_soft_block_t *latest_block_p;
-    uintptr_t latest_chunk_address;
-
-    res = -1;
-    latest_block_p = NULL;
-
-    /* Find the most recently written chunk, as given by the
-       revision. */
-    for (i = 0; i < self_p->number_of_blocks; i++) {
-        block_p = &self_p->blocks_p[i];
-        number_of_chunks = (block_p->size / self_p->chunk_size);
-
-        for (j = 0; j < number_of_chunks; j++) {
-            chunk_address = (block_p->address + j * self_p->chunk_size);
+    uintptr_t chunk_address;
+    uint16_t revision;
 
-            /* Read the header. */
-            size = flash_read(self_p->flash_p,
-                              &header,
-                              chunk_address,
-                              sizeof(header));
+    if (find_latest_chunk(self_p, &block_p, &chunk_address, &revision) != 0) {
+        return (-1);
+    }
 
-            if (size != sizeof(header)) {
-                continue;
-            }
+    /* Make sure the chunk is valid. */
+    if (is_valid_chunk(self_p, chunk_address) != 1) {
+        return (-1);
+    }
 
-            /* Check the valid flag. */
-            if (header.valid != VALID_PATTERN) {
-                continue;
-            }
+    self_p->current.block_p = block_p;
+    self_p->current.chunk_address = chunk_address;
+    self_p->current.revision = revision;
+    self_p->current.log_offset = 0;
+    self_p->current.log_full = 0;
 
-            /* Keep track of the latest revision chunk. */
-            if ((latest_block_p == NULL)
-                || (is_later_revision(header.revision, latest_revision) == 1)) {
-                latest_revision = header.revision;
-                latest_block_p = block_p;
-                latest_chunk_address = chunk_address;
-            }
-        }
-    }
+    if (self_p->log_size > 0) {
+        if (log_mount(self_p) != 0) {
+            self_p->current.block_p = NULL;
 
-    /* Make sure the chunk is valid. */
-    if (latest_block_p != NULL) {
-        if (is_valid_chunk(self_p, latest_chunk_address) == 1) {
-            self_p->current.block_p = latest_block_p;
-            self_p->current.chunk_address = latest_chunk_address;
-            self_p->current.revision = latest_revision;
-            res = 0;
+            return (-1);
         }
     }
 
-    return (res);
+    return (0);
 }
 
 ssize_t eeprom_soft_read(struct eeprom_soft_driver_t *self_p,
@@ -564,8 +1066,7 @@ ssize_t eeprom_soft_read(struct eeprom_soft_driver_t *self_p,
     mutex_lock(&self_p->mutex);
 #endif
 
-    src += (self_p->current.chunk_address + CHUNK_HEADER_SIZE);
-    res = flash_read(self_p->flash_p, dst_p, src, size);
+    res = read_data(self_p, dst_p, src, size);
 
 #if CONFIG_EEPROM_SOFT_SEMAPHORE == 1
     mutex_unlock(&self_p->mutex);
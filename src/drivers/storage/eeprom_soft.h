@@ -42,10 +42,13 @@ struct eeprom_soft_driver_t {
     int number_of_blocks;
     size_t chunk_size;
     size_t eeprom_size;
+    size_t log_size;
     struct {
         const struct eeprom_soft_block_t *block_p;
         uintptr_t chunk_address;
         uint16_t revision;
+        size_t log_offset;
+        int log_full;
     } current;
 #if CONFIG_EEPROM_SOFT_SEMAPHORE == 1
     struct mutex_t mutex;
@@ -83,6 +86,24 @@ int eeprom_soft_init(struct eeprom_soft_driver_t *self_p,
                      int number_of_blocks,
                      size_t chunk_size);
 
+/**
+ * Reserve given number of bytes at the end of each chunk for an
+ * append log. Writes are appended to the log of the current chunk
+ * until it is full, and only then is the chunk copied to a new
+ * chunk, which reduces the number of bytes written to flash for
+ * small writes. The EEPROM size is reduced by the log size. Must be
+ * called before the EEPROM is formatted and mounted.
+ *
+ * @param[in] self_p Initialized driver object.
+ * @param[in] size Log size in bytes. Must be a multiple of 8 and
+ *                 smaller than `chunk_size - 8`. The resulting EEPROM
+ *                 size must be at most 65535 bytes if non-zero.
+ *
+ * @return zero(0) or negative error code.
+ */
+int eeprom_soft_set_log_size(struct eeprom_soft_driver_t *self_p,
+                             size_t size);
+
 /**
  * Mount given software EEPROM.
  *
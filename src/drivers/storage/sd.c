@@ -183,15 +183,12 @@ static int wait_not_busy(struct sd_driver_t *self_p,
 /**
  * Send command index with given argument to SD card.
  */
-static int command_write(struct sd_driver_t *self_p,
-                         uint8_t index,
-                         uint32_t arg)
+static int command_send(struct sd_driver_t *self_p,
+                        uint8_t index,
+                        uint32_t arg)
 {
     struct command_t command;
 
-    /* Wait for the card to be idle. */
-    wait_not_busy(self_p, 300);
-
     /* Initiate the command. */
     command.index = (0x40 | index);
     command.arg = htonl(arg);
@@ -206,6 +203,56 @@ static int command_write(struct sd_driver_t *self_p,
     return (0);
 }
 
+/**
+ * Wait for the card to be idle and then send command index with
+ * given argument to SD card.
+ */
+static int command_write(struct sd_driver_t *self_p,
+                         uint8_t index,
+                         uint32_t arg)
+{
+    /* Wait for the card to be idle. */
+    wait_not_busy(self_p, 300);
+
+    return (command_send(self_p, index, arg));
+}
+
+/**
+ * Stop a multiple block read. The card is sending data when the
+ * command is sent, so it can not wait for the card to be idle
+ * first.
+ */
+static int stop_transmission(struct sd_driver_t *self_p)
+{
+    int i;
+    uint8_t response;
+
+    if (command_send(self_p, CMD_STOP_TRANSMISSION, 0) != 0) {
+        return (-1);
+    }
+
+    /* Skip the stuff byte. */
+    if (spi_get(self_p->spi_p, &response) != 1) {
+        return (-1);
+    }
+
+    for (i = 0; i < RESPONSE_RETRIES; i++) {
+        if (spi_get(self_p->spi_p, &response) != 1) {
+            return (-1);
+        }
+
+        if ((response & R1_RESERVED) == 0) {
+            break;
+        }
+    }
+
+    if (response != 0) {
+        return (-1);
+    }
+
+    return (wait_not_busy(self_p, WRITE_TIMEOUT));
+}
+
 /**
  * Send command index with given argument to SD card and wait for the
  * response a response with only the idle bit set.
@@ -594,4 +641,176 @@ ssize_t sd_write_block(struct sd_driver_t *self_p,
     return (res);
 }
 
+ssize_t sd_read_blocks(struct sd_driver_t *self_p,
+                       void *dst_p,
+                       uint32_t src_block,
+                       size_t number_of_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+    ASSERTN(number_of_blocks > 0, EINVAL);
+
+    ssize_t res;
+    size_t i;
+    uint8_t *u8_dst_p;
+    uint16_t real_crc, expected_crc;
+
+    if (number_of_blocks == 1) {
+        return (sd_read_block(self_p, dst_p, src_block));
+    }
+
+    if (self_p->type != TYPE_SDHC) {
+        src_block <<= 9;
+    }
+
+    u8_dst_p = dst_p;
+
+    spi_take_bus(self_p->spi_p);
+    spi_select(self_p->spi_p);
+
+    /* Issue read multiple block command. */
+    if (command_check_call(self_p,
+                           CMD_READ_MULTIPLE_BLOCK,
+                           src_block,
+                           0) != 0) {
+        res = -SD_ERR_READ_COMMAND;
+        goto out;
+    }
+
+    res = (number_of_blocks * SD_BLOCK_SIZE);
+
+    for (i = 0; i < number_of_blocks; i++) {
+        /* Receive the data block start token. */
+        if (wait_for_data_start_block(self_p) != 0) {
+            res = -SD_ERR_READ_DATA_START_BLOCK;
+            break;
+        }
+
+        /* Receive the data and it's checksum. */
+        spi_read(self_p->spi_p, u8_dst_p, SD_BLOCK_SIZE);
+        spi_read(self_p->spi_p, &expected_crc, sizeof(expected_crc));
+
+        /* Calculate the checksum of the received data. */
+        real_crc = crc_xmodem(0, u8_dst_p, SD_BLOCK_SIZE);
+        expected_crc = ntohs(expected_crc);
+
+        if (real_crc != expected_crc) {
+            res = -SD_ERR_READ_WRONG_DATA_CRC;
+            break;
+        }
+
+        u8_dst_p += SD_BLOCK_SIZE;
+    }
+
+    if ((stop_transmission(self_p) != 0) && (res >= 0)) {
+        res = -SD_ERR_STOP_TRANSMISSION;
+    }
+
+ out:
+    spi_deselect(self_p->spi_p);
+    spi_give_bus(self_p->spi_p);
+
+    return (res);
+}
+
+ssize_t sd_write_blocks(struct sd_driver_t *self_p,
+                        uint32_t dst_block,
+                        const void *src_p,
+                        size_t number_of_blocks)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(src_p != NULL, EINVAL);
+    ASSERTN(number_of_blocks > 0, EINVAL);
+
+    ssize_t res;
+    size_t i;
+    uint16_t crc;
+    uint8_t response;
+    const uint8_t *u8_src_p;
+
+    if (number_of_blocks == 1) {
+        return (sd_write_block(self_p, dst_block, src_p));
+    }
+
+    /* Check for byte address adjustment. */
+    if (self_p->type != TYPE_SDHC) {
+        dst_block <<= 9;
+    }
+
+    u8_src_p = src_p;
+
+    spi_take_bus(self_p->spi_p);
+    spi_select(self_p->spi_p);
+
+    /* Issue write multiple block command. */
+    if (command_check_call(self_p,
+                           CMD_WRITE_MULTIPLE_BLOCK,
+                           dst_block,
+                           0) != 0) {
+        res = -SD_ERR_WRITE_BLOCK;
+        goto out;
+    }
+
+    res = (number_of_blocks * SD_BLOCK_SIZE);
+
+    for (i = 0; i < number_of_blocks; i++) {
+        crc = crc_xmodem(0, u8_src_p, SD_BLOCK_SIZE);
+        crc = htons(crc);
+
+        /* Write the start token, the data and it's checksum. */
+        spi_put(self_p->spi_p, TOKEN_WRITE_MULTIPLE_TOKEN);
+        spi_write(self_p->spi_p, u8_src_p, SD_BLOCK_SIZE);
+        spi_write(self_p->spi_p, &crc, sizeof(crc));
+
+        /* Wait for the data-response token. */
+        spi_get(self_p->spi_p, &response);
+
+        if ((response & TOKEN_DATA_RES_MASK) != TOKEN_DATA_RES_ACCEPTED) {
+            res = -SD_ERR_WRITE_BLOCK_TOKEN_DATA_RES_ACCEPTED;
+            break;
+        }
+
+        /* Wait for the block to be programmed. */
+        if (wait_not_busy(self_p, WRITE_TIMEOUT) != 0) {
+            res = -SD_ERR_WRITE_BLOCK_WAIT_NOT_BUSY;
+            break;
+        }
+
+        u8_src_p += SD_BLOCK_SIZE;
+    }
+
+    /* Stop the transmission and wait for the card to finish
+       programming. */
+    spi_put(self_p->spi_p, TOKEN_STOP_TRAN_TOKEN);
+    spi_get(self_p->spi_p, &response);
+
+    if (wait_not_busy(self_p, WRITE_TIMEOUT) != 0) {
+        if (res >= 0) {
+            res = -SD_ERR_WRITE_BLOCK_WAIT_NOT_BUSY;
+        }
+
+        goto out;
+    }
+
+    if (command_check_call(self_p, CMD_SEND_STATUS, 0, 0) != 0) {
+        if (res >= 0) {
+            res = -SD_ERR_WRITE_BLOCK_SEND_STATUS;
+        }
+
+        goto out;
+    }
+
+    spi_get(self_p->spi_p, &response);
+
+    if (response != 0) {
+        res = -1;
+    }
+
+ out:
+    spi_deselect(self_p->spi_p);
+    spi_give_bus(self_p->spi_p);
+
+    return (res);
+}
+
 #endif
@@ -46,6 +46,7 @@
 #define SD_ERR_WRITE_BLOCK_TOKEN_DATA_RES_ACCEPTED   5012
 #define SD_ERR_WRITE_BLOCK_WAIT_NOT_BUSY             5013
 #define SD_ERR_WRITE_BLOCK_SEND_STATUS               5014
+#define SD_ERR_STOP_TRANSMISSION                     5015
 
 #define SD_BLOCK_SIZE 512
 
@@ -272,4 +273,40 @@ ssize_t sd_write_block(struct sd_driver_t *self_p,
                        uint32_t dst_block,
                        const void *src_p);
 
+/**
+ * Read given number of consecutive blocks from the SD card with a
+ * single multiple block read command. Compatible with
+ * `block_device_read_t`.
+ *
+ * @param[in] self_p Initialized driver object.
+ * @param[out] dst_p Buffer of `number_of_blocks * SD_BLOCK_SIZE`
+ *                   bytes to read into.
+ * @param[in] src_block First block to read from.
+ * @param[in] number_of_blocks Number of blocks to read.
+ *
+ * @return Number of read bytes or negative error code.
+ */
+ssize_t sd_read_blocks(struct sd_driver_t *self_p,
+                       void *dst_p,
+                       uint32_t src_block,
+                       size_t number_of_blocks);
+
+/**
+ * Write given number of consecutive blocks to the SD card with a
+ * single multiple block write command. Compatible with
+ * `block_device_write_t`.
+ *
+ * @param[in] self_p Initialized driver object.
+ * @param[in] dst_block First block to write to.
+ * @param[in] src_p Buffer of `number_of_blocks * SD_BLOCK_SIZE`
+ *                  bytes to write.
+ * @param[in] number_of_blocks Number of blocks to write.
+ *
+ * @return Number of written bytes or negative error code.
+ */
+ssize_t sd_write_blocks(struct sd_driver_t *self_p,
+                        uint32_t dst_block,
+                        const void *src_p,
+                        size_t number_of_blocks);
+
 #endif
@@ -28,43 +28,427 @@
 
 #include "simba.h"
 
+#if defined(ARCH_LINUX) && defined(__x86_64__)
+#    define BASE64_SSSE3 1
+#    include <immintrin.h>
+#else
+#    define BASE64_SSSE3 0
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#    define BASE64_NEON 1
+#    include <arm_neon.h>
+#else
+#    define BASE64_NEON 0
+#endif
+
+/* Decoded value of the padding character. */
+#define PADDING                                          64
+
+/* Decoded value of characters not in the alphabet. */
+#define INVALID                                        0xff
+
+static FAR const char alphabet[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
 /**
- * Index must be a number 0-64.
+ * Encoded character to index 0-63, PADDING for '=' and INVALID for
+ * characters not part of the alphabet.
  */
-static char index_to_encoded(int index)
-{
-    if ((index >= 0) && (index <= 25)) {
-        return ('A' + index - 0);
-    } else if ((index >= 26) && (index <= 51)) {
-        return ('a' + index - 26);
-    } else if ((index >= 52) && (index <= 61)) {
-        return ('0' + index - 52);
-    } else if (index == 62) {
-        return ('+');
-    } else if (index == 63) {
-        return ('/');
-    } else {
-        return ('=');
-    }
-}
-
-static int encoded_to_index(char encoded)
-{
-    if ((encoded >= 'A') && (encoded <= 'Z')) {
-        return (0 + encoded - 'A');
-    } else if ((encoded >= 'a') && (encoded <= 'z')) {
-        return (26 + encoded - 'a');
-    } else if ((encoded >= '0') && (encoded <= '9')) {
-        return (52 + encoded - '0');
-    } else if (encoded == '+') {
-        return (62);
-    } else if (encoded == '/') {
-        return (63);
-    } else if (encoded == '=') {
-        return (0);
+static FAR const uint8_t decode_table[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b,
+    0x3c, 0x3d, 0xff, 0xff, 0xff, 0x40, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16,
+    0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20,
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30,
+    0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+#if BASE64_SSSE3 == 1
+
+/**
+ * Encode 12 bytes into 16 characters. 16 bytes are read from the
+ * source buffer.
+ */
+__attribute__((target("ssse3")))
+static inline void encode_12_ssse3(char *dst_p, const uint8_t *src_p)
+{
+    __m128i in;
+    __m128i indices;
+    __m128i offsets;
+    __m128i less;
+    const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0);
+
+    /* Split the 12 bytes into 16 sextets, one per byte. */
+    in = _mm_loadu_si128((const __m128i *)src_p);
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+                                           4, 5, 3, 4, 1, 2, 0, 1));
+    indices = _mm_or_si128(
+        _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                        _mm_set1_epi32(0x04000040)),
+        _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                        _mm_set1_epi32(0x01000010)));
+
+    /* Map the sextet ranges to offsets into the ASCII table. */
+    offsets = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    offsets = _mm_or_si128(offsets, _mm_and_si128(less, _mm_set1_epi8(13)));
+    offsets = _mm_shuffle_epi8(shift_lut, offsets);
+
+    _mm_storeu_si128((__m128i *)dst_p, _mm_add_epi8(indices, offsets));
+}
+
+/**
+ * Decode 16 characters into 12 bytes. 16 bytes are written to the
+ * destination buffer.
+ *
+ * @return zero(0) or -1 if any character is not part of the
+ *         alphabet.
+ */
+__attribute__((target("ssse3")))
+static inline int decode_16_ssse3(uint8_t *dst_p, const char *src_p)
+{
+    __m128i in;
+    __m128i hi;
+    __m128i lo;
+    __m128i shift;
+    __m128i is_slash;
+    __m128i invalid;
+    __m128i values;
+    const __m128i shift_lut = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71,
+                                            0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_lut = _mm_setr_epi8(0xa8,
+                                           0xf8, 0xf8, 0xf8, 0xf8, 0xf8,
+                                           0xf8, 0xf8, 0xf8, 0xf8,
+                                           0xf0,
+                                           0x54,
+                                           0x50, 0x50, 0x50,
+                                           0x54);
+    const __m128i bitpos_lut = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08,
+                                             0x10, 0x20, 0x40, 0x80,
+                                             0, 0, 0, 0, 0, 0, 0, 0);
+
+    in = _mm_loadu_si128((const __m128i *)src_p);
+    hi = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+    lo = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+
+    /* A character is valid if the bit for its high nibble is set in
+       the mask selected by its low nibble. */
+    invalid = _mm_cmpeq_epi8(_mm_and_si128(_mm_shuffle_epi8(mask_lut, lo),
+                                           _mm_shuffle_epi8(bitpos_lut, hi)),
+                             _mm_setzero_si128());
+
+    if (_mm_movemask_epi8(invalid) != 0) {
+        return (-1);
+    }
+
+    /* Character to sextet. '/' and '+' share the high nibble. */
+    shift = _mm_shuffle_epi8(shift_lut, hi);
+    is_slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    shift = _mm_or_si128(_mm_andnot_si128(is_slash, shift),
+                         _mm_and_si128(is_slash, _mm_set1_epi8(16)));
+    values = _mm_add_epi8(in, shift);
+
+    /* Pack the 16 sextets into 12 bytes. */
+    values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+    values = _mm_shuffle_epi8(values, _mm_setr_epi8(2, 1, 0, 6, 5, 4,
+                                                    10, 9, 8, 14, 13, 12,
+                                                    -1, -1, -1, -1));
+    _mm_storeu_si128((__m128i *)dst_p, values);
+
+    return (0);
+}
+
+/**
+ * Encode as many blocks as possible, four at a time.
+ *
+ * @return Number of encoded blocks.
+ */
+__attribute__((target("ssse3")))
+static size_t encode_ssse3(char *dst_p,
+                           const uint8_t *src_p,
+                           size_t number_of_blocks)
+{
+    size_t i;
+
+    /* Four blocks are encoded but 16 bytes are read. */
+    for (i = 0; i + 6 <= number_of_blocks; i += 4) {
+        encode_12_ssse3(&dst_p[4 * i], &src_p[3 * i]);
+    }
+
+    return (i);
+}
+
+/**
+ * Decode as many blocks as possible, four at a time.
+ *
+ * @return Number of decoded blocks.
+ */
+__attribute__((target("ssse3")))
+static size_t decode_ssse3(uint8_t *dst_p,
+                           const char *src_p,
+                           size_t number_of_blocks)
+{
+    size_t i;
+
+    /* Four blocks are decoded but 16 bytes are written. */
+    for (i = 0; i + 6 <= number_of_blocks; i += 4) {
+        if (decode_16_ssse3(&dst_p[3 * i], &src_p[4 * i]) != 0) {
+            break;
+        }
     }
 
-    return (-1);
+    return (i);
+}
+
+#endif
+
+#if BASE64_NEON == 1
+
+/**
+ * Encode 48 bytes into 64 characters.
+ */
+static void encode_48_neon(char *dst_p, const uint8_t *src_p)
+{
+    uint8x16x4_t table;
+    uint8x16x3_t in;
+    uint8x16x4_t out;
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+
+    table.val[0] = vld1q_u8((const uint8_t *)&alphabet[0]);
+    table.val[1] = vld1q_u8((const uint8_t *)&alphabet[16]);
+    table.val[2] = vld1q_u8((const uint8_t *)&alphabet[32]);
+    table.val[3] = vld1q_u8((const uint8_t *)&alphabet[48]);
+    in = vld3q_u8(src_p);
+
+    out.val[0] = vshrq_n_u8(in.val[0], 2);
+    out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4),
+                                   vshrq_n_u8(in.val[1], 4)),
+                          mask);
+    out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2),
+                                   vshrq_n_u8(in.val[2], 6)),
+                          mask);
+    out.val[3] = vandq_u8(in.val[2], mask);
+
+    out.val[0] = vqtbl4q_u8(table, out.val[0]);
+    out.val[1] = vqtbl4q_u8(table, out.val[1]);
+    out.val[2] = vqtbl4q_u8(table, out.val[2]);
+    out.val[3] = vqtbl4q_u8(table, out.val[3]);
+
+    vst4q_u8((uint8_t *)dst_p, out);
+}
+
+/**
+ * Decode 64 characters into 48 bytes.
+ *
+ * @return zero(0) or -1 if any character is not part of the
+ *         alphabet.
+ */
+static int decode_64_neon(uint8_t *dst_p, const char *src_p)
+{
+    uint8x16x4_t table_low;
+    uint8x16x4_t table_high;
+    uint8x16x4_t in;
+    uint8x16x3_t out;
+    uint8x16_t error;
+    const uint8x16_t offset = vdupq_n_u8(64);
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        table_low.val[i] = vld1q_u8(&decode_table[16 * i]);
+        table_high.val[i] = vld1q_u8(&decode_table[64 + 16 * i]);
+    }
+
+    in = vld4q_u8((const uint8_t *)src_p);
+    error = vdupq_n_u8(0);
+
+    /* Out of range table indexes give zero, so characters 0-127 are
+       found in exactly one of the two tables. Characters 128-255 and
+       all values but 0-63 (including the padding) are errors. */
+    for (i = 0; i < 4; i++) {
+        error = vorrq_u8(error, vandq_u8(in.val[i], vdupq_n_u8(0x80)));
+        in.val[i] = vorrq_u8(vqtbl4q_u8(table_low, in.val[i]),
+                             vqtbl4q_u8(table_high,
+                                        vsubq_u8(in.val[i], offset)));
+        error = vorrq_u8(error, vandq_u8(in.val[i], vdupq_n_u8(0xc0)));
+    }
+
+    if (vmaxvq_u8(error) != 0) {
+        return (-1);
+    }
+
+    out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2),
+                          vshrq_n_u8(in.val[1], 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4),
+                          vshrq_n_u8(in.val[2], 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+    vst3q_u8(dst_p, out);
+
+    return (0);
+}
+
+#endif
+
+/**
+ * Encode given number of three bytes blocks into four characters
+ * each.
+ */
+static void encode_blocks(char *dst_p,
+                          const uint8_t *src_p,
+                          size_t number_of_blocks)
+{
+    uint32_t value;
+#if BASE64_SSSE3 == 1
+    size_t encoded;
+#endif
+
+#if BASE64_NEON == 1
+    while (number_of_blocks >= 16) {
+        encode_48_neon(dst_p, src_p);
+        dst_p += 64;
+        src_p += 48;
+        number_of_blocks -= 16;
+    }
+#endif
+
+#if BASE64_SSSE3 == 1
+    if (__builtin_cpu_supports("ssse3")) {
+        encoded = encode_ssse3(dst_p, src_p, number_of_blocks);
+        dst_p += (4 * encoded);
+        src_p += (3 * encoded);
+        number_of_blocks -= encoded;
+    }
+#endif
+
+    while (number_of_blocks > 0) {
+        value = (((uint32_t)src_p[0] << 16)
+                 | ((uint32_t)src_p[1] << 8)
+                 | src_p[2]);
+        dst_p[0] = alphabet[(value >> 18) & 0x3f];
+        dst_p[1] = alphabet[(value >> 12) & 0x3f];
+        dst_p[2] = alphabet[(value >> 6) & 0x3f];
+        dst_p[3] = alphabet[value & 0x3f];
+        dst_p += 4;
+        src_p += 3;
+        number_of_blocks--;
+    }
+}
+
+/**
+ * Encode the last one or two bytes with padding.
+ */
+static void encode_tail(char *dst_p, const uint8_t *src_p, size_t size)
+{
+    uint32_t value;
+
+    value = ((uint32_t)src_p[0] << 16);
+
+    if (size == 2) {
+        value |= ((uint32_t)src_p[1] << 8);
+    }
+
+    dst_p[0] = alphabet[(value >> 18) & 0x3f];
+    dst_p[1] = alphabet[(value >> 12) & 0x3f];
+    dst_p[2] = (size == 2 ? alphabet[(value >> 6) & 0x3f] : '=');
+    dst_p[3] = '=';
+}
+
+/**
+ * Decode given number of four characters blocks into three bytes
+ * each. Decoding stops at the first block with a character not part
+ * of the alphabet, including padding.
+ *
+ * @return Number of decoded blocks.
+ */
+static size_t decode_blocks(uint8_t *dst_p,
+                            const char *src_p,
+                            size_t number_of_blocks)
+{
+    size_t left;
+    uint32_t value;
+    uint8_t a, b, c, d;
+#if BASE64_SSSE3 == 1
+    size_t decoded;
+#endif
+
+    left = number_of_blocks;
+
+#if BASE64_NEON == 1
+    while (left >= 16) {
+        if (decode_64_neon(dst_p, src_p) != 0) {
+            break;
+        }
+
+        dst_p += 48;
+        src_p += 64;
+        left -= 16;
+    }
+#endif
+
+#if BASE64_SSSE3 == 1
+    if (__builtin_cpu_supports("ssse3")) {
+        decoded = decode_ssse3(dst_p, src_p, left);
+        dst_p += (3 * decoded);
+        src_p += (4 * decoded);
+        left -= decoded;
+    }
+#endif
+
+    while (left > 0) {
+        a = decode_table[(uint8_t)src_p[0]];
+        b = decode_table[(uint8_t)src_p[1]];
+        c = decode_table[(uint8_t)src_p[2]];
+        d = decode_table[(uint8_t)src_p[3]];
+
+        /* Both INVALID and PADDING are greater than 63. */
+        if ((a | b | c | d) > 63) {
+            break;
+        }
+
+        value = (((uint32_t)a << 18)
+                 | ((uint32_t)b << 12)
+                 | ((uint32_t)c << 6)
+                 | d);
+        dst_p[0] = (value >> 16);
+        dst_p[1] = (value >> 8);
+        dst_p[2] = value;
+        dst_p += 3;
+        src_p += 4;
+        left--;
+    }
+
+    return (number_of_blocks - left);
 }
 
 int base64_encode(char *dst_p, const void *src_p, size_t size)
@@ -72,35 +456,16 @@ int base64_encode(char *dst_p, const void *src_p, size_t size)
     ASSERTN(dst_p != NULL, EINVAL);
     ASSERTN(src_p != NULL, EINVAL);
 
-    int i;
-    int j;
-    int index;
+    size_t number_of_blocks;
     const uint8_t *s_p = src_p;
 
-    for (i = 0, j = 0; i < size; i += 3, j += 4) {
-        index = ((s_p[i + 0] & 0xfc) >> 2);
-        dst_p[j + 0] = index_to_encoded(index);
-        index = ((s_p[i + 0] & 0x03) << 4);
-
-        if (i + 1 < size) {
-            index |= ((s_p[i + 1] & 0xf0) >> 4);
-            dst_p[j + 1] = index_to_encoded(index);
-            index = (s_p[i + 1] & 0x0f) << 2;
-            
-            if (i + 2 < size) {
-                index |= ((s_p[i + 2] & 0xc0) >> 6);
-                dst_p[j + 2] = index_to_encoded(index);
-                index = (s_p[i + 2] & 0x3f);
-                dst_p[j + 3] = index_to_encoded(index);
-            } else {
-                dst_p[j + 2] = index_to_encoded(index);
-                dst_p[j + 3] = index_to_encoded(64);
-            }
-        } else {
-            dst_p[j + 1] = index_to_encoded(index);
-            dst_p[j + 2] = index_to_encoded(64);
-            dst_p[j + 3] = index_to_encoded(64);
-        }
+    number_of_blocks = (size / 3);
+    encode_blocks(dst_p, s_p, number_of_blocks);
+
+    if ((size % 3) != 0) {
+        encode_tail(&dst_p[4 * number_of_blocks],
+                    &s_p[3 * number_of_blocks],
+                    size % 3);
     }
 
     return (0);
@@ -111,32 +476,247 @@ int base64_decode(void *dst_p, const char *src_p, size_t size)
     ASSERTN(dst_p != NULL, EINVAL);
     ASSERTN(src_p != NULL, EINVAL);
 
-    int i;
+    size_t i;
     int j;
-    int index[4];
+    size_t number_of_blocks;
+    uint8_t value[4];
     uint8_t *d_p = dst_p;
-    
+
     if ((size % 4) != 0) {
         return (-EINVAL);
     }
 
-    for (i = 0, j = 0; i < size; i += 4, j += 3) {
-        index[0] = encoded_to_index(src_p[i + 0]);
-        index[1] = encoded_to_index(src_p[i + 1]);
-        index[2] = encoded_to_index(src_p[i + 2]);
-        index[3] = encoded_to_index(src_p[i + 3]);
+    number_of_blocks = (size / 4);
+
+    while (number_of_blocks > 0) {
+        i = decode_blocks(d_p, src_p, number_of_blocks);
+        d_p += (3 * i);
+        src_p += (4 * i);
+        number_of_blocks -= i;
+
+        if (number_of_blocks == 0) {
+            break;
+        }
+
+        /* A block with padding or invalid characters. Padding is
+           decoded as zero. */
+        for (j = 0; j < 4; j++) {
+            value[j] = decode_table[(uint8_t)src_p[j]];
+
+            if (value[j] == INVALID) {
+                return (-1);
+            } else if (value[j] == PADDING) {
+                value[j] = 0;
+            }
+        }
+
+        d_p[0] = ((value[0] << 2) | (value[1] >> 4));
+        d_p[1] = ((value[1] << 4) | (value[2] >> 2));
+        d_p[2] = ((value[2] << 6) | value[3]);
+        d_p += 3;
+        src_p += 4;
+        number_of_blocks--;
+    }
+
+    return (0);
+}
+
+int base64_encoder_init(struct base64_encoder_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    self_p->size = 0;
+
+    return (0);
+}
+
+ssize_t base64_encoder_update(struct base64_encoder_t *self_p,
+                              char *dst_p,
+                              const void *src_p,
+                              size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+    ASSERTN(src_p != NULL, EINVAL);
+
+    size_t number_of_blocks;
+    char *d_p;
+    const uint8_t *s_p;
+
+    d_p = dst_p;
+    s_p = src_p;
+
+    /* Complete the buffered block, if any. */
+    if (self_p->size > 0) {
+        while ((self_p->size < 3) && (size > 0)) {
+            self_p->buf[self_p->size++] = *s_p++;
+            size--;
+        }
+
+        if (self_p->size < 3) {
+            return (0);
+        }
+
+        encode_blocks(d_p, &self_p->buf[0], 1);
+        d_p += 4;
+        self_p->size = 0;
+    }
+
+    number_of_blocks = (size / 3);
+    encode_blocks(d_p, s_p, number_of_blocks);
+    d_p += (4 * number_of_blocks);
+    s_p += (3 * number_of_blocks);
+    size -= (3 * number_of_blocks);
+
+    /* Save the remaining bytes for later. */
+    while (size > 0) {
+        self_p->buf[self_p->size++] = *s_p++;
+        size--;
+    }
+
+    return (d_p - dst_p);
+}
+
+ssize_t base64_encoder_finalize(struct base64_encoder_t *self_p,
+                                char *dst_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+
+    if (self_p->size == 0) {
+        return (0);
+    }
+
+    encode_tail(dst_p, &self_p->buf[0], self_p->size);
+    self_p->size = 0;
+
+    return (4);
+}
+
+/**
+ * Decode the last block in the stream, possibly with padding.
+ *
+ * @return Number of decoded bytes, or negative error code.
+ */
+static ssize_t decode_last_block(uint8_t *dst_p, const char *src_p)
+{
+    uint8_t value[4];
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        value[i] = decode_table[(uint8_t)src_p[i]];
+
+        if (value[i] == INVALID) {
+            return (-EINVAL);
+        }
+    }
+
+    /* Only "xx==" and "xxx=" are valid. */
+    if ((value[0] == PADDING) || (value[1] == PADDING)) {
+        return (-EINVAL);
+    }
+
+    dst_p[0] = ((value[0] << 2) | (value[1] >> 4));
 
-        if ((index[0] == -1)
-            || (index[1] == -1)
-            || (index[2] == -1)
-            || (index[3] == -1)) {
-            return (-1);
+    if (value[2] == PADDING) {
+        if (value[3] != PADDING) {
+            return (-EINVAL);
         }
 
-        d_p[j] = ((index[0] << 2) | (index[1] >> 4));
-        d_p[j + 1] = ((index[1] << 4) | (index[2] >> 2));
-        d_p[j + 2] = ((index[2] << 6) | index[3]);
+        return (1);
+    }
+
+    dst_p[1] = ((value[1] << 4) | (value[2] >> 2));
+
+    if (value[3] == PADDING) {
+        return (2);
     }
-    
+
+    dst_p[2] = ((value[2] << 6) | value[3]);
+
+    return (3);
+}
+
+int base64_decoder_init(struct base64_decoder_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    self_p->size = 0;
+    self_p->padded = 0;
+
+    return (0);
+}
+
+ssize_t base64_decoder_update(struct base64_decoder_t *self_p,
+                              void *dst_p,
+                              const char *src_p,
+                              size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(dst_p != NULL, EINVAL);
+    ASSERTN(src_p != NULL, EINVAL);
+
+    size_t number_of_blocks;
+    size_t decoded;
+    ssize_t res;
+    uint8_t *d_p;
+
+    d_p = dst_p;
+
+    while (size > 0) {
+        /* No data may follow the padding. */
+        if (self_p->padded == 1) {
+            return (-EINVAL);
+        }
+
+        /* Decode complete blocks directly from the input. */
+        if (self_p->size == 0) {
+            number_of_blocks = (size / 4);
+            decoded = decode_blocks(d_p, src_p, number_of_blocks);
+            d_p += (3 * decoded);
+            src_p += (4 * decoded);
+            size -= (4 * decoded);
+
+            if (size == 0) {
+                break;
+            }
+        }
+
+        /* Slow path for blocks with padding or invalid characters,
+           and for blocks split between calls. */
+        while ((self_p->size < 4) && (size > 0)) {
+            self_p->buf[self_p->size++] = *src_p++;
+            size--;
+        }
+
+        if (self_p->size < 4) {
+            break;
+        }
+
+        res = decode_last_block(d_p, &self_p->buf[0]);
+
+        if (res < 0) {
+            return (res);
+        }
+
+        d_p += res;
+        self_p->size = 0;
+
+        if (res < 3) {
+            self_p->padded = 1;
+        }
+    }
+
+    return (d_p - (uint8_t *)dst_p);
+}
+
+int base64_decoder_finalize(struct base64_decoder_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    if (self_p->size != 0) {
+        return (-EINVAL);
+    }
+
     return (0);
 }
@@ -31,6 +31,23 @@
 
 #include "simba.h"
 
+/**
+ * Incremental encoder state.
+ */
+struct base64_encoder_t {
+    uint8_t buf[3];
+    uint8_t size;
+};
+
+/**
+ * Incremental decoder state.
+ */
+struct base64_decoder_t {
+    char buf[4];
+    uint8_t size;
+    uint8_t padded;
+};
+
 /**
  * Encode given buffer. The encoded data will be ~33.3% larger than
  * the source data. Choose the destination buffer size accordingly.
@@ -56,4 +73,83 @@ int base64_encode(char *dst_p, const void *src_p, size_t size);
  */
 int base64_decode(void *dst_p, const char *src_p, size_t size);
 
+/**
+ * Initialize given incremental encoder. Use it to encode data that
+ * is not available in a single buffer, for example data read from a
+ * channel in chunks of any size.
+ *
+ * @param[out] self_p Encoder to initialize.
+ *
+ * @return zero(0) or negative error code.
+ */
+int base64_encoder_init(struct base64_encoder_t *self_p);
+
+/**
+ * Encode given chunk of data. Up to two bytes are saved in the
+ * encoder until more data is available, or the encoder is
+ * finalized.
+ *
+ * @param[in] self_p Initialized encoder.
+ * @param[out] dst_p Encoded output data. Must be at least
+ *                   ``4 * ((size + 2) / 3)`` bytes.
+ * @param[in] src_p Input data.
+ * @param[in] size Number of bytes in the input data.
+ *
+ * @return Number of characters written to the output buffer, or
+ *         negative error code.
+ */
+ssize_t base64_encoder_update(struct base64_encoder_t *self_p,
+                              char *dst_p,
+                              const void *src_p,
+                              size_t size);
+
+/**
+ * Encode any saved bytes with padding.
+ *
+ * @param[in] self_p Initialized encoder.
+ * @param[out] dst_p Encoded output data. Must be at least 4 bytes.
+ *
+ * @return Number of characters written to the output buffer, zero(0)
+ *         or four(4), or negative error code.
+ */
+ssize_t base64_encoder_finalize(struct base64_encoder_t *self_p,
+                                char *dst_p);
+
+/**
+ * Initialize given incremental decoder.
+ *
+ * @param[out] self_p Decoder to initialize.
+ *
+ * @return zero(0) or negative error code.
+ */
+int base64_decoder_init(struct base64_decoder_t *self_p);
+
+/**
+ * Decode given chunk of encoded data. Up to three characters are
+ * saved in the decoder until more data is available. Padding is
+ * only allowed in the last block of the stream.
+ *
+ * @param[in] self_p Initialized decoder.
+ * @param[out] dst_p Output data. Must be at least
+ *                   ``3 * ((size + 3) / 4)`` bytes.
+ * @param[in] src_p Encoded input data.
+ * @param[in] size Number of bytes in the encoded input data.
+ *
+ * @return Number of bytes written to the output buffer, or negative
+ *         error code.
+ */
+ssize_t base64_decoder_update(struct base64_decoder_t *self_p,
+                              void *dst_p,
+                              const char *src_p,
+                              size_t size);
+
+/**
+ * Check that the decoded stream ended on a block boundary.
+ *
+ * @param[in] self_p Initialized decoder.
+ *
+ * @return zero(0) or negative error code.
+ */
+int base64_decoder_finalize(struct base64_decoder_t *self_p);
+
 #endif
@@ -28,33 +28,124 @@
 
 #include "simba.h"
 
-static int to_nibble(int ch)
+#if defined(ARCH_LINUX) && defined(__x86_64__)
+#    define HEX_SSSE3 1
+#    include <immintrin.h>
+#else
+#    define HEX_SSSE3 0
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#    define HEX_NEON 1
+#    include <arm_neon.h>
+#else
+#    define HEX_NEON 0
+#endif
+
+/* Decoded value of characters that are not hex digits. */
+#define INVALID                                        0xff
+
+static FAR const char digits[16] = "0123456789abcdef";
+
+/**
+ * Hex digit, upper or lower case, to nibble, or INVALID.
+ */
+static FAR const uint8_t nibbles[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+#if HEX_SSSE3 == 1
+
+/**
+ * Convert as many 16 bytes chunks as possible to hex digits.
+ *
+ * @return Number of converted bytes.
+ */
+__attribute__((target("ssse3")))
+static size_t from_bin_ssse3(char *dst_p, const uint8_t *src_p, size_t size)
 {
-    ch = tolower(ch);
-
-    if ((ch >= '0') && (ch <= '9')) {
-        return (ch - '0');
-    } else if ((ch >= 'a') && (ch <= 'f')) {
-        return (ch - 'a' + 10);
-    } else {
-        return (-EINVAL);
+    size_t i;
+    __m128i in;
+    __m128i hi;
+    __m128i lo;
+    __m128i table;
+
+    table = _mm_loadu_si128((const __m128i *)&digits[0]);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        in = _mm_loadu_si128((const __m128i *)&src_p[i]);
+        hi = _mm_and_si128(_mm_srli_epi16(in, 4), _mm_set1_epi8(0x0f));
+        lo = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+        hi = _mm_shuffle_epi8(table, hi);
+        lo = _mm_shuffle_epi8(table, lo);
+        _mm_storeu_si128((__m128i *)&dst_p[2 * i],
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)&dst_p[2 * i + 16],
+                         _mm_unpackhi_epi8(hi, lo));
     }
+
+    return (i);
 }
 
-static int from_nibble(uint8_t nibble)
+#endif
+
+#if HEX_NEON == 1
+
+/**
+ * Convert 16 bytes to 32 hex digits.
+ */
+static void from_bin_16_neon(char *dst_p, const uint8_t *src_p)
 {
-    if (nibble < 10) {
-        return (nibble + '0');
-    } else {
-        return (nibble + 'a' - 10);
-    }
+    uint8x16_t in;
+    uint8x16_t table;
+    uint8x16x2_t out;
+
+    table = vld1q_u8((const uint8_t *)&digits[0]);
+    in = vld1q_u8(src_p);
+    out.val[0] = vqtbl1q_u8(table, vshrq_n_u8(in, 4));
+    out.val[1] = vqtbl1q_u8(table, vandq_u8(in, vdupq_n_u8(0x0f)));
+    vst2q_u8((uint8_t *)dst_p, out);
 }
 
+#endif
+
 int hex_to_bin(void *dst_p, const char *src_p, size_t size)
 {
     size_t i;
     uint8_t *u8_dst_p;
-    int ch;
+    uint8_t hi;
+    uint8_t lo;
 
     if ((size % 2) != 0) {
         return (-EINVAL);
@@ -64,23 +155,15 @@ int hex_to_bin(void *dst_p, const char *src_p, size_t size)
     size /= 2;
 
     for (i = 0; i < size; i++) {
-        /* First nibble. */
-        ch = to_nibble(src_p[2 * i]);
-
-        if (ch < 0) {
-            return (ch);
-        }
-
-        u8_dst_p[i] = ((uint8_t)ch << 4);
-
-        /* Second nibble. */
-        ch = to_nibble(src_p[2 * i + 1]);
+        hi = nibbles[(uint8_t)src_p[2 * i]];
+        lo = nibbles[(uint8_t)src_p[2 * i + 1]];
 
-        if (ch < 0) {
-            return (ch);
+        /* INVALID is the only value greater than 15. */
+        if ((hi | lo) > 15) {
+            return (-EINVAL);
         }
 
-        u8_dst_p[i] |= (uint8_t)ch;
+        u8_dst_p[i] = ((hi << 4) | lo);
     }
 
     return (size);
@@ -92,10 +175,23 @@ int hex_from_bin(char *dst_p, const void *src_p, size_t size)
     const uint8_t *u8_src_p;
 
     u8_src_p = (const uint8_t *)src_p;
+    i = 0;
 
-    for (i = 0; i < size; i++) {
-        dst_p[2 * i] = from_nibble((u8_src_p[i] >> 4) & 0x0f);
-        dst_p[2 * i + 1] = from_nibble(u8_src_p[i] & 0x0f);
+#if HEX_NEON == 1
+    for (; i + 16 <= size; i += 16) {
+        from_bin_16_neon(&dst_p[2 * i], &u8_src_p[i]);
+    }
+#endif
+
+#if HEX_SSSE3 == 1
+    if (__builtin_cpu_supports("ssse3")) {
+        i = from_bin_ssse3(dst_p, u8_src_p, size);
+    }
+#endif
+
+    for (; i < size; i++) {
+        dst_p[2 * i] = digits[u8_src_p[i] >> 4];
+        dst_p[2 * i + 1] = digits[u8_src_p[i] & 0x0f];
     }
 
     dst_p[2 * size] = '\0';
@@ -226,6 +226,23 @@ static int cache_flush(struct fat16_t *self_p)
     return (0);
 }
 
+/**
+ * Write all blocks buffered by the block device, if any, to the
+ * media.
+ */
+static int device_flush(struct fat16_t *self_p)
+{
+#if CONFIG_BLOCK_DEVICE == 1
+    if (self_p->block_device_p != NULL) {
+        if (block_device_flush(self_p->block_device_p) != 0) {
+            return (-1);
+        }
+    }
+#endif
+
+    return (0);
+}
+
 static inline uint8_t block_of_cluster(uint8_t blocks_per_cluster,
                                        uint32_t position)
 {
@@ -452,10 +469,39 @@ int fat16_init(struct fat16_t *self_p,
     self_p->write = write;
     self_p->arg_p = arg_p;
     self_p->partition = partition;
+    self_p->block_device_p = NULL;
 
     return (0);
 }
 
+#if CONFIG_BLOCK_DEVICE == 1
+
+int fat16_init_block_device(struct fat16_t *self_p,
+                            struct block_device_t *block_device_p,
+                            unsigned int partition)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(block_device_p != NULL, EINVAL);
+
+    int res;
+
+    res = fat16_init(self_p,
+                     (fat16_read_t)block_device_read,
+                     (fat16_write_t)block_device_write,
+                     block_device_p,
+                     partition);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    self_p->block_device_p = block_device_p;
+
+    return (0);
+}
+
+#endif
+
 int fat16_mount(struct fat16_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
@@ -535,7 +581,11 @@ int fat16_unmount(struct fat16_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    return (cache_flush(self_p));
+    if (cache_flush(self_p) != 0) {
+        return (-1);
+    }
+
+    return (device_flush(self_p));
 }
 
 int fat16_format(struct fat16_t *self_p)
@@ -617,7 +667,7 @@ int fat16_format(struct fat16_t *self_p)
         return (-1);
     }
 
-    return (0);
+    return (device_flush(self_p));
 }
 
 int fat16_print(struct fat16_t *self_p, void *chan_p)
@@ -1495,7 +1545,11 @@ int fat16_file_sync(struct fat16_file_t *file_p)
         file_p->flags &= ~F_FILE_DIR_DIRTY;
     }
 
-    return (cache_flush(file_p->fat16_p));
+    if (cache_flush(file_p->fat16_p) != 0) {
+        return (-1);
+    }
+
+    return (device_flush(file_p->fat16_p));
 }
 
 int fat16_dir_open(struct fat16_t *self_p,
@@ -135,6 +135,8 @@
  */
 #define DIR_ATTR_ARCHIVE   0x20
 
+struct block_device_t;
+
 /**
  * Block read function callback.
  */
@@ -513,6 +515,7 @@ struct fat16_t {
     fat16_write_t write;
     void *arg_p;
     unsigned int partition;
+    struct block_device_t *block_device_p;
 
     /* Volume info */
     uint8_t fat_count;             /* number of FATs */
@@ -581,6 +584,22 @@ int fat16_init(struct fat16_t *self_p,
                void *arg_p,
                unsigned int partition);
 
+/**
+ * Initialize a FAT16 volume on given block device. Blocks are read
+ * ahead and written behind by the block device, and
+ * `fat16_file_sync()`, `fat16_file_close()` and `fat16_unmount()`
+ * flush the block device to write all buffered blocks to the media.
+ *
+ * @param[in,out] self_p FAT16 object to initialize.
+ * @param[in] block_device_p Initialized block device.
+ * @param[in] partition Partition to be used. See `fat16_init()`.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fat16_init_block_device(struct fat16_t *self_p,
+                            struct block_device_t *block_device_p,
+                            unsigned int partition);
+
 /**
  * Mount given FAT16 volume.
  *
@@ -31,12 +31,45 @@
 
 #define FS_NAME_MAX                                          64
 
+#if CONFIG_FS_COMMAND_HASH_SIZE > 0
+#    if (CONFIG_FS_COMMAND_HASH_SIZE & (CONFIG_FS_COMMAND_HASH_SIZE - 1)) != 0
+#        error "CONFIG_FS_COMMAND_HASH_SIZE must be a power of two."
+#    endif
+#endif
+
+#if CONFIG_FS_COUNTER_SHARDS > 1
+#    define COUNTER_ADD(ptr_p, value) ATOMIC_ADD(ptr_p, value)
+#    define COUNTER_LOAD(ptr_p) ATOMIC_LOAD(ptr_p)
+#    define COUNTER_STORE(ptr_p, value) ATOMIC_STORE(ptr_p, value)
+#else
+#    define COUNTER_ADD(ptr_p, value) (*(ptr_p) += (value))
+#    define COUNTER_LOAD(ptr_p) (*(ptr_p))
+#    define COUNTER_STORE(ptr_p, value) (*(ptr_p) = (value))
+#endif
+
+/* Counters snapshot format. */
+#define SNAPSHOT_VERSION                                         1
+#define SNAPSHOT_HEADER_SIZE                                     8
+#define SNAPSHOT_TYPE_COUNTER                                    0
+#define SNAPSHOT_TYPE_HISTOGRAM                                  1
+
+/* FNV-1a constants. */
+#define HASH_OFFSET_BASIS                            0x811c9dc5UL
+#define HASH_PRIME                                   0x01000193UL
+
 struct module_t {
     int8_t initialized;
     struct fs_command_t *commands_p;
+#if CONFIG_FS_COMMAND_HASH_SIZE > 0
+    struct fs_command_t *commands_hash[CONFIG_FS_COMMAND_HASH_SIZE];
+#endif
     struct fs_filesystem_t *filesystems_p;
     struct fs_counter_t *counters_p;
+    struct fs_histogram_t *histograms_p;
     struct fs_parameter_t *parameters_p;
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    int next_shard;
+#endif
 #if CONFIG_FS_FS_COMMAND_FILESYSTEMS_LIST == 1
     struct fs_command_t cmd_filesystems_list;
 #endif
@@ -72,24 +105,119 @@ struct module_t {
 static struct module_t module;
 static char empty_path[] = "";
 
+#if CONFIG_FS_COUNTER_SHARDS > 1
+
+/* Shard of the calling thread, assigned on first increment. */
+static __thread int shard_index = -1;
+
+#endif
+
 static int counter_get(struct fs_counter_t *counter_p,
                        void *chout_p)
 {
+    uint64_t value;
+
+    value = fs_counter_get(counter_p);
+
     std_fprintf(chout_p,
                 OSTR("%08lx%08lx\r\n"),
-                (long)(counter_p->value >> 32),
-                (long)(counter_p->value & 0xffffffff));
+                (long)(value >> 32),
+                (long)(value & 0xffffffff));
 
     return (0);
 }
 
 static int counter_set(struct fs_counter_t *counter_p)
 {
-    counter_p->value = 0;
+    return (fs_counter_reset(counter_p));
+}
+
+static int histogram_print(struct fs_histogram_t *histogram_p,
+                           void *chout_p)
+{
+    int i;
+    uint32_t count;
+    uint64_t sum;
+
+    count = 0;
+
+    for (i = 0; i < CONFIG_FS_HISTOGRAM_BUCKETS; i++) {
+        count += COUNTER_LOAD(&histogram_p->buckets[i]);
+    }
+
+    sum = COUNTER_LOAD(&histogram_p->sum);
+
+    std_fprintf(chout_p,
+                OSTR("count: %lu\r\n"
+                     "sum: %08lx%08lx\r\n"
+                     "max: %lu\r\n"),
+                (unsigned long)count,
+                (long)(sum >> 32),
+                (long)(sum & 0xffffffff),
+                (unsigned long)COUNTER_LOAD(&histogram_p->max));
+
+    for (i = 0; i < CONFIG_FS_HISTOGRAM_BUCKETS; i++) {
+        count = COUNTER_LOAD(&histogram_p->buckets[i]);
+
+        if (count == 0) {
+            continue;
+        }
+
+        if (i == 0) {
+            std_fprintf(chout_p, OSTR("0: %lu\r\n"), (unsigned long)count);
+        } else if (i == CONFIG_FS_HISTOGRAM_BUCKETS - 1) {
+            std_fprintf(chout_p,
+                        OSTR("%lu-: %lu\r\n"),
+                        (unsigned long)(1UL << (i - 1)),
+                        (unsigned long)count);
+        } else {
+            std_fprintf(chout_p,
+                        OSTR("%lu-%lu: %lu\r\n"),
+                        (unsigned long)(1UL << (i - 1)),
+                        (unsigned long)((1UL << i) - 1),
+                        (unsigned long)count);
+        }
+    }
 
     return (0);
 }
 
+static uint8_t *snapshot_pack(uint8_t *buf_p, uint64_t value, int size)
+{
+    int i;
+
+    for (i = 0; i < size; i++) {
+        buf_p[i] = (value >> (8 * i));
+    }
+
+    return (&buf_p[size]);
+}
+
+/**
+ * Write given counter or histogram path to given snapshot buffer, if
+ * not NULL. Returns the size of the path entry header.
+ */
+static size_t snapshot_pack_path(uint8_t *buf_p,
+                                 int type,
+                                 far_string_t path_p)
+{
+    size_t length;
+    size_t i;
+
+    length = MIN(std_strlen(path_p), 255);
+
+    if (buf_p != NULL) {
+        buf_p[0] = type;
+        buf_p[1] = length;
+
+        for (i = 0; i < length; i++) {
+            buf_p[2 + i] = path_p[i];
+        }
+    }
+
+    return (2 + length);
+}
+
 static int cmd_parameter_cb(int argc,
                             const char *argv[],
                             void *chout_p,
@@ -404,6 +532,7 @@ static int cmd_counters_reset_cb(int argc,
                                  void *call_arg_p)
 {
     struct fs_counter_t *counter_p;
+    struct fs_histogram_t *histogram_p;
 
     counter_p = module.counters_p;
 
@@ -418,6 +547,13 @@ static int cmd_counters_reset_cb(int argc,
         counter_p = counter_p->next_p;
     }
 
+    histogram_p = module.histograms_p;
+
+    while (histogram_p != NULL) {
+        fs_histogram_reset(histogram_p);
+        histogram_p = histogram_p->next_p;
+    }
+
     return (0);
 }
 
@@ -460,46 +596,40 @@ static int cmd_parameters_list_cb(int argc,
 
 /**
  * Parse one argument from given string. An argument must be in quotes
- * if it contains spaces.
+ * if it contains spaces. Quotes and escaping backslashes are removed
+ * by moving the remaining characters of the argument towards its
+ * beginning, so the string is only traversed once.
  */
 static char *argument_parse(char *command_p, const char **begin_pp)
 {
     int in_quote;
+    char *dst_p;
 
     in_quote = 0;
     *begin_pp = command_p;
+    dst_p = command_p;
 
     while (*command_p != '\0') {
         if (*command_p == '\\') {
             if (command_p[1] == '\"') {
                 /* Remove the \. */
-                memmove(command_p, &command_p[1], strlen(&command_p[1]) + 1);
-            }
-        } else {
-            if (in_quote == 1) {
-                if (*command_p == '\"') {
-                    /* Remove the ". */
-                    memmove(command_p, &command_p[1], strlen(&command_p[1]) + 1);
-                    in_quote = 0;
-                    command_p--;
-                }
-            } else {
-                if (*command_p == '\"') {
-                    /* Remove the ". */
-                    memmove(command_p, &command_p[1], strlen(&command_p[1]) + 1);
-                    in_quote = 1;
-                    command_p--;
-                } else if (*command_p == ' ') {
-                    *command_p = '\0';
-                    command_p++;
-                    break;
-                }
+                command_p++;
             }
+        } else if (*command_p == '\"') {
+            /* Remove the ". */
+            in_quote ^= 1;
+            command_p++;
+            continue;
+        } else if ((in_quote == 0) && (*command_p == ' ')) {
+            command_p++;
+            break;
         }
 
-        command_p++;
+        *dst_p++ = *command_p++;
     }
 
+    *dst_p = '\0';
+
     if (in_quote == 0) {
         return (command_p);
     } else {
@@ -529,8 +659,11 @@ static int command_parse(char *command_p, const char *argv[])
             return (-E2BIG);
         }
 
-        /* Remove white spaces before the next argument. */
-        command_p = std_strip(command_p, NULL);
+        /* Remove white spaces before the next argument. The end of
+           the string is already stripped. */
+        while (isspace((int)*command_p)) {
+            command_p++;
+        }
 
         if ((command_p = argument_parse(command_p, &argv[argc++])) == NULL) {
             return (-1);
@@ -540,6 +673,127 @@ static int command_parse(char *command_p, const char *argv[])
     return (argc);
 }
 
+#if CONFIG_FS_COMMAND_HASH_SIZE > 0
+
+/**
+ * Hash given command path, without its leading slash.
+ */
+static int hash_path(const char *path_p)
+{
+    uint32_t hash;
+
+    hash = HASH_OFFSET_BASIS;
+
+    if (*path_p == '/') {
+        path_p++;
+    }
+
+    while (*path_p != '\0') {
+        hash ^= (uint8_t)*path_p++;
+        hash *= HASH_PRIME;
+    }
+
+    return (hash & (CONFIG_FS_COMMAND_HASH_SIZE - 1));
+}
+
+/**
+ * Hash given far command path, without its leading slash.
+ */
+static int hash_path_f(far_string_t path_p)
+{
+    uint32_t hash;
+
+    hash = HASH_OFFSET_BASIS;
+
+    if (*path_p == '/') {
+        path_p++;
+    }
+
+    while (*path_p != '\0') {
+        hash ^= (uint8_t)*path_p++;
+        hash *= HASH_PRIME;
+    }
+
+    return (hash & (CONFIG_FS_COMMAND_HASH_SIZE - 1));
+}
+
+/**
+ * Add given command last in its hash bucket, so the first registered
+ * command is found if several commands have the same path.
+ */
+static void command_hash_add(struct fs_command_t *command_p)
+{
+    struct fs_command_t **current_pp;
+
+    current_pp = &module.commands_hash[hash_path_f(command_p->path_p)];
+
+    while (*current_pp != NULL) {
+        current_pp = &(*current_pp)->hash_next_p;
+    }
+
+    command_p->hash_next_p = NULL;
+    *current_pp = command_p;
+}
+
+/**
+ * Find the command with given path in the hash table. The leading
+ * slash is optional in given path.
+ */
+static struct fs_command_t *command_find(const char *path_p)
+{
+    struct fs_command_t *current_p;
+    far_string_t command_path_p;
+
+    current_p = module.commands_hash[hash_path(path_p)];
+
+    if (*path_p == '/') {
+        path_p++;
+    }
+
+    while (current_p != NULL) {
+        command_path_p = current_p->path_p;
+
+        if (*command_path_p == '/') {
+            command_path_p++;
+        }
+
+        if (std_strcmp(path_p, command_path_p) == 0) {
+            return (current_p);
+        }
+
+        current_p = current_p->hash_next_p;
+    }
+
+    return (NULL);
+}
+
+#else
+
+/**
+ * Find the command with given path in the sorted command list. The
+ * leading slash is optional in given path.
+ */
+static struct fs_command_t *command_find(const char *path_p)
+{
+    struct fs_command_t *current_p;
+    int skip_slash;
+
+    current_p = module.commands_p;
+    skip_slash = (path_p[0] != '/');
+
+    while (current_p != NULL) {
+        if (std_strcmp(path_p, &current_p->path_p[skip_slash]) == 0) {
+            return (current_p);
+        }
+
+        current_p = current_p->next_p;
+    }
+
+    return (NULL);
+}
+
+#endif
+
 static int cmd_counter_cb(int argc,
                           const char *argv[],
                           void *chout_p,
@@ -554,6 +808,20 @@ static int cmd_counter_cb(int argc,
     }
 }
 
+static int cmd_histogram_cb(int argc,
+                            const char *argv[],
+                            void *chout_p,
+                            void *chin_p,
+                            void *arg_p,
+                            void *call_arg_p)
+{
+    if (argc == 1) {
+        return (histogram_print(arg_p, chout_p));
+    } else {
+        return (fs_histogram_reset(arg_p));
+    }
+}
+
 int fs_module_init()
 {
     /* Return immediately if the module is already initialized. */
@@ -563,8 +831,12 @@ int fs_module_init()
 
     module.initialized = 1;
     module.commands_p = NULL;
+#if CONFIG_FS_COMMAND_HASH_SIZE > 0
+    memset(&module.commands_hash[0], 0, sizeof(module.commands_hash));
+#endif
     module.filesystems_p = NULL;
     module.counters_p = NULL;
+    module.histograms_p = NULL;
     module.parameters_p = NULL;
 
 #if CONFIG_FS_FS_COMMAND_FILESYSTEMS_LIST == 1
@@ -657,7 +929,7 @@ int fs_call(char *command_p,
 {
     ASSERTN(command_p != NULL, EINVAL);
 
-    int argc, skip_slash;
+    int argc;
     const char *argv[CONFIG_FS_COMMAND_ARGS_MAX];
     struct fs_command_t *current_p;
 
@@ -667,21 +939,15 @@ int fs_call(char *command_p,
         return (argc);
     }
 
-    /* Find given command. */
-    current_p = module.commands_p;
-    skip_slash = (argv[0][0] != '/');
-
-    while (current_p != NULL) {
-        if (std_strcmp(argv[0], &current_p->path_p[skip_slash]) == 0) {
-            return (current_p->callback(argc,
-                                        argv,
-                                        chout_p,
-                                        chin_p,
-                                        current_p->arg_p,
-                                        arg_p));
-        }
+    current_p = command_find(argv[0]);
 
-        current_p = current_p->next_p;
+    if (current_p != NULL) {
+        return (current_p->callback(argc,
+                                    argv,
+                                    chout_p,
+                                    chin_p,
+                                    current_p->arg_p,
+                                    arg_p));
     }
 
     std_fprintf(chout_p, OSTR("%s: command not found\r\n"), argv[0]);
@@ -1868,6 +2134,10 @@ int fs_command_register(struct fs_command_t *command_p)
         prev_p->next_p = command_p;
     }
 
+#if CONFIG_FS_COMMAND_HASH_SIZE > 0
+    command_hash_add(command_p);
+#endif
+
     return (0);
 }
 
@@ -1890,7 +2160,12 @@ int fs_counter_init(struct fs_counter_t *self_p,
                     cmd_counter_cb,
                     self_p);
 
+    fs_counter_reset(self_p);
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    self_p->shards[0].value = value;
+#else
     self_p->value = value;
+#endif
     self_p->next_p = NULL;
 
     return (0);
@@ -1901,7 +2176,53 @@ RAM_CODE int fs_counter_increment(struct fs_counter_t *self_p,
 {
     ASSERTN(self_p != NULL, EINVAL);
 
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    if (shard_index == -1) {
+        shard_index = ((unsigned int)ATOMIC_ADD(&module.next_shard, 1)
+                       % CONFIG_FS_COUNTER_SHARDS);
+    }
+
+    ATOMIC_ADD(&self_p->shards[shard_index].value, value);
+#else
     self_p->value += value;
+#endif
+
+    return (0);
+}
+
+uint64_t fs_counter_get(struct fs_counter_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    uint64_t value;
+    int i;
+
+    value = 0;
+
+    for (i = 0; i < CONFIG_FS_COUNTER_SHARDS; i++) {
+        value += ATOMIC_LOAD(&self_p->shards[i].value);
+    }
+
+    return (value);
+#else
+    return (self_p->value);
+#endif
+}
+
+int fs_counter_reset(struct fs_counter_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    int i;
+
+    for (i = 0; i < CONFIG_FS_COUNTER_SHARDS; i++) {
+        ATOMIC_STORE(&self_p->shards[i].value, 0);
+    }
+#else
+    self_p->value = 0;
+#endif
 
     return (0);
 }
@@ -1926,6 +2247,168 @@ int fs_counter_deregister(struct fs_counter_t *counter_p)
     return (0);
 }
 
+int fs_histogram_init(struct fs_histogram_t *self_p,
+                      far_string_t path_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(path_p != NULL, EINVAL);
+
+    fs_command_init(&self_p->command,
+                    path_p,
+                    cmd_histogram_cb,
+                    self_p);
+
+    fs_histogram_reset(self_p);
+    self_p->next_p = NULL;
+
+    return (0);
+}
+
+RAM_CODE int fs_histogram_record(struct fs_histogram_t *self_p,
+                                 uint32_t value)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    int i;
+
+    if (value == 0) {
+        i = 0;
+    } else {
+        /* Number of significant bits in the value. */
+        i = (8 * sizeof(unsigned long) - __builtin_clzl(value));
+        i = MIN(i, CONFIG_FS_HISTOGRAM_BUCKETS - 1);
+    }
+
+    COUNTER_ADD(&self_p->buckets[i], 1);
+    COUNTER_ADD(&self_p->sum, value);
+
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    uint32_t max;
+
+    max = ATOMIC_LOAD(&self_p->max);
+
+    while ((value > max) && !ATOMIC_CAS(&self_p->max, &max, value));
+#else
+    if (value > self_p->max) {
+        self_p->max = value;
+    }
+#endif
+
+    return (0);
+}
+
+int fs_histogram_reset(struct fs_histogram_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    int i;
+
+    for (i = 0; i < CONFIG_FS_HISTOGRAM_BUCKETS; i++) {
+        COUNTER_STORE(&self_p->buckets[i], 0);
+    }
+
+    COUNTER_STORE(&self_p->sum, 0);
+    COUNTER_STORE(&self_p->max, 0);
+
+    return (0);
+}
+
+int fs_histogram_register(struct fs_histogram_t *histogram_p)
+{
+    ASSERTN(histogram_p != NULL, EINVAL);
+
+    /* Insert histogram into the command list and the histogram
+       list. */
+    fs_command_register(&histogram_p->command);
+
+    histogram_p->next_p = module.histograms_p;
+    module.histograms_p = histogram_p;
+
+    return (0);
+}
+
+ssize_t fs_counters_snapshot(void *buf_p, size_t size)
+{
+    struct fs_counter_t *counter_p;
+    struct fs_histogram_t *histogram_p;
+    uint8_t *b_p;
+    size_t snapshot_size;
+    int number_of_entries;
+    int i;
+
+    /* Calculate the snapshot size. */
+    snapshot_size = SNAPSHOT_HEADER_SIZE;
+    number_of_entries = 0;
+    counter_p = module.counters_p;
+
+    while (counter_p != NULL) {
+        snapshot_size += snapshot_pack_path(NULL,
+                                            SNAPSHOT_TYPE_COUNTER,
+                                            counter_p->command.path_p);
+        snapshot_size += 8;
+        number_of_entries++;
+        counter_p = counter_p->next_p;
+    }
+
+    histogram_p = module.histograms_p;
+
+    while (histogram_p != NULL) {
+        snapshot_size += snapshot_pack_path(NULL,
+                                            SNAPSHOT_TYPE_HISTOGRAM,
+                                            histogram_p->command.path_p);
+        snapshot_size += (13 + 4 * CONFIG_FS_HISTOGRAM_BUCKETS);
+        number_of_entries++;
+        histogram_p = histogram_p->next_p;
+    }
+
+    if (buf_p == NULL) {
+        return (snapshot_size);
+    }
+
+    if (size < snapshot_size) {
+        return (-ENOMEM);
+    }
+
+    /* Write the snapshot. */
+    b_p = buf_p;
+    *b_p++ = 'F';
+    *b_p++ = 'S';
+    *b_p++ = 'C';
+    *b_p++ = 'S';
+    b_p = snapshot_pack(b_p, SNAPSHOT_VERSION, 2);
+    b_p = snapshot_pack(b_p, number_of_entries, 2);
+    counter_p = module.counters_p;
+
+    while (counter_p != NULL) {
+        b_p += snapshot_pack_path(b_p,
+                                  SNAPSHOT_TYPE_COUNTER,
+                                  counter_p->command.path_p);
+        b_p = snapshot_pack(b_p, fs_counter_get(counter_p), 8);
+        counter_p = counter_p->next_p;
+    }
+
+    histogram_p = module.histograms_p;
+
+    while (histogram_p != NULL) {
+        b_p += snapshot_pack_path(b_p,
+                                  SNAPSHOT_TYPE_HISTOGRAM,
+                                  histogram_p->command.path_p);
+        *b_p++ = CONFIG_FS_HISTOGRAM_BUCKETS;
+        b_p = snapshot_pack(b_p, COUNTER_LOAD(&histogram_p->sum), 8);
+        b_p = snapshot_pack(b_p, COUNTER_LOAD(&histogram_p->max), 4);
+
+        for (i = 0; i < CONFIG_FS_HISTOGRAM_BUCKETS; i++) {
+            b_p = snapshot_pack(b_p,
+                                COUNTER_LOAD(&histogram_p->buckets[i]),
+                                4);
+        }
+
+        histogram_p = histogram_p->next_p;
+    }
+
+    return (snapshot_size);
+}
+
 int fs_parameter_init(struct fs_parameter_t *self_p,
                       far_string_t path_p,
                       fs_parameter_set_callback_t set_cb,
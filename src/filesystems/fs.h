@@ -220,15 +220,40 @@ struct fs_command_t {
     fs_callback_t callback;
     void *arg_p;
     struct fs_command_t *next_p;
+#if CONFIG_FS_COMMAND_HASH_SIZE > 0
+    struct fs_command_t *hash_next_p;
+#endif
 };
 
+#if CONFIG_FS_COUNTER_SHARDS > 1
+
+/* Counter shard, alone in its cache line. */
+struct fs_counter_shard_t {
+    long long unsigned int value;
+} __attribute__((aligned(CONFIG_CACHE_LINE_SIZE)));
+
+#endif
+
 /* Counter. */
 struct fs_counter_t {
     struct fs_command_t command;
+#if CONFIG_FS_COUNTER_SHARDS > 1
+    struct fs_counter_shard_t shards[CONFIG_FS_COUNTER_SHARDS];
+#else
     long long unsigned int value;
+#endif
     struct fs_counter_t *next_p;
 };
 
+/* Histogram. */
+struct fs_histogram_t {
+    struct fs_command_t command;
+    uint32_t buckets[CONFIG_FS_HISTOGRAM_BUCKETS];
+    long long unsigned int sum;
+    uint32_t max;
+    struct fs_histogram_t *next_p;
+};
+
 /* Parameter. */
 struct fs_parameter_t {
     struct fs_command_t command;
@@ -615,7 +640,8 @@ int fs_command_init(struct fs_command_t *self_p,
 
 /**
  * Register given command. Registered commands are called by the
- * function `fs_call()`.
+ * function `fs_call()`. If several commands are registered with the
+ * same path, the first one is called.
  *
  * @param[in] command_p Command to register.
  *
@@ -646,7 +672,10 @@ int fs_counter_init(struct fs_counter_t *self_p,
                     uint64_t value);
 
 /**
- * Increment given counter.
+ * Increment given counter. With more than one shard,
+ * ``CONFIG_FS_COUNTER_SHARDS``, the shard of the calling thread is
+ * atomically incremented, and the counter may be incremented by
+ * parallel threads.
  *
  * @param[in] self_p Command to initialize.
  * @param[in] value Increment value.
@@ -656,6 +685,24 @@ int fs_counter_init(struct fs_counter_t *self_p,
 int fs_counter_increment(struct fs_counter_t *self_p,
                          uint64_t value);
 
+/**
+ * Get the value of given counter, the sum of its shards.
+ *
+ * @param[in] self_p Counter.
+ *
+ * @return The counter value.
+ */
+uint64_t fs_counter_get(struct fs_counter_t *self_p);
+
+/**
+ * Set given counter to zero. Increments made in parallel may be lost.
+ *
+ * @param[in] self_p Counter.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fs_counter_reset(struct fs_counter_t *self_p);
+
 /**
  * Register given counter.
  *
@@ -674,6 +721,76 @@ int fs_counter_register(struct fs_counter_t *counter_p);
  */
 int fs_counter_deregister(struct fs_counter_t *counter_p);
 
+/**
+ * Initialize given histogram, typically of latencies. The histogram
+ * has ``CONFIG_FS_HISTOGRAM_BUCKETS`` buckets with power of two
+ * bounds, see `fs_histogram_record()`. The histogram command prints
+ * the number of values, their sum, the largest value and the non-empty
+ * buckets. Any argument to the command sets the histogram to zero.
+ *
+ * @param[in] self_p Histogram to initialize.
+ * @param[in] path_p Path to register.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fs_histogram_init(struct fs_histogram_t *self_p,
+                      far_string_t path_p);
+
+/**
+ * Add given value to given histogram. Bucket zero counts the value
+ * zero, and bucket N counts values from 2^(N-1) up to 2^N - 1. The
+ * last bucket also counts all larger values. Like counters, with more
+ * than one counter shard the histogram is atomically updated and may
+ * be updated by parallel threads.
+ *
+ * @param[in] self_p Histogram.
+ * @param[in] value Value to add, for example a latency in
+ *                  microseconds.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fs_histogram_record(struct fs_histogram_t *self_p, uint32_t value);
+
+/**
+ * Set all buckets of given histogram to zero.
+ *
+ * @param[in] self_p Histogram.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fs_histogram_reset(struct fs_histogram_t *self_p);
+
+/**
+ * Register given histogram.
+ *
+ * @param[in] histogram_p Histogram to register.
+ *
+ * @return zero(0) or negative error code.
+ */
+int fs_histogram_register(struct fs_histogram_t *histogram_p);
+
+/**
+ * Write a binary snapshot of all registered counters and histograms
+ * to given buffer, for monitoring tools. All integers are little
+ * endian.
+ *
+ * The snapshot starts with the four characters ``FSCS``, a 16 bits
+ * format version, currently one(1), and the 16 bits number of
+ * entries. Each entry is an 8 bits type and an 8 bits path length
+ * followed by the path, without the null termination. A counter,
+ * type zero(0), is followed by its 64 bits value. A histogram, type
+ * one(1), is followed by the 8 bits number of buckets, the 64 bits
+ * sum of all values, the 32 bits largest value and the 32 bits
+ * buckets.
+ *
+ * @param[out] buf_p Buffer to write the snapshot to, or NULL to only
+ *                   calculate the snapshot size.
+ * @param[in] size Buffer size.
+ *
+ * @return Snapshot size in bytes or negative error code.
+ */
+ssize_t fs_counters_snapshot(void *buf_p, size_t size);
+
 /**
  * Initialize given parameter.
  *
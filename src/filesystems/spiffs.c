@@ -25,3 +25,19 @@
  *
  * This file is part of the Simba project.
  */
+
+#include "simba.h"
+#include "spiffs_nucleus.h"
+
+/* The buffer size macros in spiffs.h must match the SPIFFS
+   structures, or statically allocated buffers are too small. */
+_Static_assert(SPIFFS_FILEDESCS_BUFFER_SIZE(1) == sizeof(spiffs_fd),
+               "SPIFFS_FILEDESCS_BUFFER_SIZE() does not match spiffs_fd.");
+
+#if SPIFFS_CACHE
+_Static_assert(SPIFFS_CACHE_BUFFER_SIZE(0, 0) == sizeof(spiffs_cache),
+               "SPIFFS_CACHE_BUFFER_SIZE() does not match spiffs_cache.");
+_Static_assert((SPIFFS_CACHE_BUFFER_SIZE(1, 0)
+                - SPIFFS_CACHE_BUFFER_SIZE(0, 0)) == sizeof(spiffs_cache_page),
+               "SPIFFS_CACHE_BUFFER_SIZE() does not match spiffs_cache_page.");
+#endif
@@ -269,6 +269,32 @@ struct spiffs_config_t {
 #endif
 };
 
+/** An object in the lookup index. */
+struct spiffs_lookup_index_entry_t {
+    /** Object id, without the index flag. */
+    spiffs_obj_id_t obj_id;
+    /** Object index header page. */
+    spiffs_page_ix_t pix;
+    /** Hash of the object name. */
+    uint16_t name_hash;
+};
+
+/**
+ * Number of bytes needed for given number of file descriptors, as
+ * given by spiffs_buffer_bytes_for_filedescs(), for statically
+ * allocated buffers.
+ */
+#define SPIFFS_FILEDESCS_BUFFER_SIZE(number_of_descs)   \
+    ((number_of_descs) * (3 * sizeof(void *) + 24))
+
+/**
+ * Number of bytes needed for given number of cache pages of given
+ * size, as given by spiffs_buffer_bytes_for_cache(), for statically
+ * allocated buffers.
+ */
+#define SPIFFS_CACHE_BUFFER_SIZE(number_of_pages, page_size)    \
+    (16 + sizeof(void *) + (number_of_pages) * (20 + (page_size)))
+
 struct spiffs_t {
     /** File system configuration. */
     struct spiffs_config_t cfg;
@@ -322,6 +348,17 @@ struct spiffs_t {
 #endif
 #endif
 
+#if SPIFFS_LOOKUP_INDEX
+    /** Lookup index memory, or NULL if not used. */
+    struct spiffs_lookup_index_entry_t *lookup_index_p;
+    /** Maximum number of objects in the lookup index. */
+    uint32_t lookup_index_size;
+    /** Number of objects in the lookup index. */
+    uint32_t lookup_index_length;
+    /** The lookup index has all objects and is up to date. */
+    uint8_t lookup_index_valid;
+#endif
+
     /** Check callback function. */
     spiffs_check_callback_t check_cb_f;
     /** File callback function. */
@@ -849,6 +886,29 @@ int32_t spiffs_tell(struct spiffs_t *self_p,
 int32_t spiffs_set_file_callback_func(struct spiffs_t *self_p,
                                       spiffs_file_callback_t cb_func);
 
+#if SPIFFS_LOOKUP_INDEX
+/**
+ * Use given memory for a lookup index with the object index header
+ * page of each file. The index is built when the file system is
+ * mounted, and lets open, stat and remove find files without
+ * scanning the object lookup pages of all blocks. Each file needs
+ * `sizeof(struct spiffs_lookup_index_entry_t)` bytes. If there are
+ * more files than fit in the index, lookups fall back to scanning.
+ *
+ * Preferably called before spiffs_mount(). The memory is kept when
+ * the file system is mounted again.
+ *
+ * @param[in] self_p The file system struct.
+ * @param[in] buf_p Lookup index memory, or NULL to not use an index.
+ * @param[in] size Lookup index memory size in bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int32_t spiffs_set_lookup_index(struct spiffs_t *self_p,
+                                void *buf_p,
+                                uint32_t size);
+#endif
+
 #if SPIFFS_TEST_VISUALISATION
 /**
  * Prints out a visualization of the filesystem.
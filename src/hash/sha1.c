@@ -28,76 +28,318 @@
 
 #include "simba.h"
 
-static inline uint32_t rotateleft(uint32_t value, int positions)
-{
-    return ((value << positions) | (value >> (32 - positions)));
-}
+#if defined(ARCH_LINUX) && defined(__x86_64__)
+#    define SHA1_SHA_NI 1
+#    include <cpuid.h>
+#    include <immintrin.h>
+#else
+#    define SHA1_SHA_NI 0
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+#    define SHA1_ARMV8_CRYPTO 1
+#    include <arm_neon.h>
+#else
+#    define SHA1_ARMV8_CRYPTO 0
+#endif
+
+#define ROTL(value, positions)                                  \
+    (((value) << (positions)) | ((value) >> (32 - (positions))))
+
+/* Big endian load that works for any alignment. */
+#define LOAD32(buf_p)                           \
+    (((uint32_t)(buf_p)[0] << 24)               \
+     | ((uint32_t)(buf_p)[1] << 16)             \
+     | ((uint32_t)(buf_p)[2] << 8)              \
+     | ((uint32_t)(buf_p)[3]))
+
+/* Rolling 16 words message schedule. */
+#define W0(i) (w[i] = LOAD32(&block_p[4 * (i)]))
+
+#define W(i)                                            \
+    (w[(i) & 15] = ROTL(w[((i) + 13) & 15]              \
+                        ^ w[((i) + 8) & 15]             \
+                        ^ w[((i) + 2) & 15]             \
+                        ^ w[(i) & 15], 1))
+
+#define F0(b, c, d) (((c ^ d) & b) ^ d)
+#define F1(b, c, d) (b ^ c ^ d)
+#define F2(b, c, d) (((b | c) & d) | (b & c))
+#define F3(b, c, d) (b ^ c ^ d)
+
+/* One round. Rotating the variable names instead of moving the
+   values between variables saves four moves per round. */
+#define R(a, b, c, d, e, f, k, wi)                      \
+    e += ROTL(a, 5) + f(b, c, d) + k + wi;              \
+    b = ROTL(b, 30);
+
+#define R5(f, k, w0, w1, w2, w3, w4)            \
+    R(a, b, c, d, e, f, k, w0);                 \
+    R(e, a, b, c, d, f, k, w1);                 \
+    R(d, e, a, b, c, f, k, w2);                 \
+    R(c, d, e, a, b, f, k, w3);                 \
+    R(b, c, d, e, a, f, k, w4)
+
+#define K0 0x5a827999
+#define K1 0x6ed9eba1
+#define K2 0x8f1bbcdc
+#define K3 0xca62c1d6
+
+#if SHA1_SHA_NI == 1
+
+/**
+ * Four rounds using the SHA extensions. The message registers are
+ * rotated by the caller.
+ */
+#define SHA_NI_ROUNDS(e_in, e_out, ma, mb, mc, md, func)        \
+    e_in = _mm_sha1nexte_epu32(e_in, ma);                       \
+    e_out = abcd;                                               \
+    mb = _mm_sha1msg2_epu32(mb, ma);                            \
+    abcd = _mm_sha1rnds4_epu32(abcd, e_in, func);               \
+    md = _mm_sha1msg1_epu32(md, ma);                            \
+    mc = _mm_xor_si128(mc, ma);
 
-static void block_update(struct sha1_t *self_p,
-                         uint8_t *block_p)
+static int8_t sha_ni_supported = -1;
+
+static int is_sha_ni_supported(void)
 {
-    uint32_t a ,b ,c ,d ,e, f, i ,t ,w[80];
-    uint32_t *b_p = (uint32_t *)block_p;
+    unsigned int eax, ebx, ecx, edx;
 
-    for (i = 0; i < 16; i++) {
-        w[i] = ntohl(b_p[i]);
-    }
+    if (sha_ni_supported == -1) {
+        sha_ni_supported = 0;
 
-    for (i = 16; i < 80; i++) {
-        w[i] = rotateleft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 1) {
+            /* SHA extensions are bit 29 in ebx. SSSE3 and SSE4.1
+               are implied on all CPUs with SHA extensions. */
+            sha_ni_supported = ((ebx >> 29) & 1);
+        }
     }
 
-    a = self_p->h[0];
-    b = self_p->h[1];
-    c = self_p->h[2];
-    d = self_p->h[3];
-    e = self_p->h[4];
-
-    for (i = 0; i < 20; i++) {
-        f = ((b & c) ^ (~b & d));
-        t = rotateleft(a, 5) + f + e + 0x5a827999 + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
+    return (sha_ni_supported);
+}
+
+__attribute__((target("sha,sse4.1")))
+static void blocks_update_sha_ni(uint32_t *h_p,
+                                 const uint8_t *buf_p,
+                                 size_t number_of_blocks)
+{
+    __m128i abcd, abcd_saved, e0, e0_saved, e1;
+    __m128i m0, m1, m2, m3;
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL,
+                                        0x08090a0b0c0d0e0fULL);
+
+    abcd = _mm_loadu_si128((const __m128i *)h_p);
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    e0 = _mm_set_epi32(h_p[4], 0, 0, 0);
+
+    while (number_of_blocks > 0) {
+        abcd_saved = abcd;
+        e0_saved = e0;
+
+        /* Rounds 0-3. */
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&buf_p[0]),
+                              mask);
+        e0 = _mm_add_epi32(e0, m0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        /* Rounds 4-7. */
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&buf_p[16]),
+                              mask);
+        e1 = _mm_sha1nexte_epu32(e1, m1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        m0 = _mm_sha1msg1_epu32(m0, m1);
+
+        /* Rounds 8-11. */
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&buf_p[32]),
+                              mask);
+        e0 = _mm_sha1nexte_epu32(e0, m2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        m1 = _mm_sha1msg1_epu32(m1, m2);
+        m0 = _mm_xor_si128(m0, m2);
+
+        /* Rounds 12-67. */
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&buf_p[48]),
+                              mask);
+        SHA_NI_ROUNDS(e1, e0, m3, m0, m1, m2, 0);
+        SHA_NI_ROUNDS(e0, e1, m0, m1, m2, m3, 0);
+        SHA_NI_ROUNDS(e1, e0, m1, m2, m3, m0, 1);
+        SHA_NI_ROUNDS(e0, e1, m2, m3, m0, m1, 1);
+        SHA_NI_ROUNDS(e1, e0, m3, m0, m1, m2, 1);
+        SHA_NI_ROUNDS(e0, e1, m0, m1, m2, m3, 1);
+        SHA_NI_ROUNDS(e1, e0, m1, m2, m3, m0, 1);
+        SHA_NI_ROUNDS(e0, e1, m2, m3, m0, m1, 2);
+        SHA_NI_ROUNDS(e1, e0, m3, m0, m1, m2, 2);
+        SHA_NI_ROUNDS(e0, e1, m0, m1, m2, m3, 2);
+        SHA_NI_ROUNDS(e1, e0, m1, m2, m3, m0, 2);
+        SHA_NI_ROUNDS(e0, e1, m2, m3, m0, m1, 2);
+        SHA_NI_ROUNDS(e1, e0, m3, m0, m1, m2, 3);
+        SHA_NI_ROUNDS(e0, e1, m0, m1, m2, m3, 3);
+
+        /* Rounds 68-71. */
+        e1 = _mm_sha1nexte_epu32(e1, m1);
+        e0 = abcd;
+        m2 = _mm_sha1msg2_epu32(m2, m1);
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+        m3 = _mm_xor_si128(m3, m1);
+
+        /* Rounds 72-75. */
+        e0 = _mm_sha1nexte_epu32(e0, m2);
+        e1 = abcd;
+        m3 = _mm_sha1msg2_epu32(m3, m2);
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+        /* Rounds 76-79. */
+        e1 = _mm_sha1nexte_epu32(e1, m3);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+        /* Add the block result to the state. */
+        e0 = _mm_sha1nexte_epu32(e0, e0_saved);
+        abcd = _mm_add_epi32(abcd, abcd_saved);
+
+        buf_p += 64;
+        number_of_blocks--;
     }
 
-    for (; i < 40; i++) {
-        f = (b ^ c ^ d);
-        t = rotateleft(a, 5) + f + e + 0x6ed9eba1 + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
+    abcd = _mm_shuffle_epi32(abcd, 0x1b);
+    _mm_storeu_si128((__m128i *)h_p, abcd);
+    h_p[4] = _mm_extract_epi32(e0, 3);
+}
+
+#endif
+
+#if SHA1_ARMV8_CRYPTO == 1
+
+static void blocks_update_armv8(uint32_t *h_p,
+                                const uint8_t *buf_p,
+                                size_t number_of_blocks)
+{
+    static const uint32_t k[4] = { K0, K1, K2, K3 };
+    uint32x4_t abcd, abcd_saved, wk;
+    uint32x4_t m[4];
+    uint32_t e, e_next, e_saved;
+    int i;
+
+    abcd = vld1q_u32(h_p);
+    e = h_p[4];
+
+    while (number_of_blocks > 0) {
+        abcd_saved = abcd;
+        e_saved = e;
+
+        for (i = 0; i < 4; i++) {
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&buf_p[16 * i])));
+        }
+
+        /* 20 times four rounds, expanding the message schedule four
+           words at a time in place. */
+        for (i = 0; i < 20; i++) {
+            wk = vaddq_u32(m[i & 3], vdupq_n_u32(k[i / 5]));
+            e_next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+            if (i < 5) {
+                abcd = vsha1cq_u32(abcd, e, wk);
+            } else if ((i >= 10) && (i < 15)) {
+                abcd = vsha1mq_u32(abcd, e, wk);
+            } else {
+                abcd = vsha1pq_u32(abcd, e, wk);
+            }
+
+            e = e_next;
+
+            if (i < 16) {
+                m[i & 3] = vsha1su1q_u32(vsha1su0q_u32(m[i & 3],
+                                                       m[(i + 1) & 3],
+                                                       m[(i + 2) & 3]),
+                                         m[(i + 3) & 3]);
+            }
+        }
+
+        abcd = vaddq_u32(abcd, abcd_saved);
+        e += e_saved;
+        buf_p += 64;
+        number_of_blocks--;
     }
 
-    for (; i < 60; i++) {
-        f = ((b & c) ^ (b & d) ^ (c & d));
-        t = rotateleft(a, 5) + f + e + 0x8f1bbcdc + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
+    vst1q_u32(h_p, abcd);
+    h_p[4] = e;
+}
+
+#endif
+
+/**
+ * Portable implementation. Fully unrolled with a rolling 16 words
+ * message schedule to keep the stack usage and memory traffic low.
+ */
+static void blocks_update_generic(uint32_t *h_p,
+                                  const uint8_t *block_p,
+                                  size_t number_of_blocks)
+{
+    uint32_t a, b, c, d, e;
+    uint32_t w[16];
+
+    while (number_of_blocks > 0) {
+        a = h_p[0];
+        b = h_p[1];
+        c = h_p[2];
+        d = h_p[3];
+        e = h_p[4];
+
+        R5(F0, K0, W0(0), W0(1), W0(2), W0(3), W0(4));
+        R5(F0, K0, W0(5), W0(6), W0(7), W0(8), W0(9));
+        R5(F0, K0, W0(10), W0(11), W0(12), W0(13), W0(14));
+        R5(F0, K0, W0(15), W(16), W(17), W(18), W(19));
+
+        R5(F1, K1, W(20), W(21), W(22), W(23), W(24));
+        R5(F1, K1, W(25), W(26), W(27), W(28), W(29));
+        R5(F1, K1, W(30), W(31), W(32), W(33), W(34));
+        R5(F1, K1, W(35), W(36), W(37), W(38), W(39));
+
+        R5(F2, K2, W(40), W(41), W(42), W(43), W(44));
+        R5(F2, K2, W(45), W(46), W(47), W(48), W(49));
+        R5(F2, K2, W(50), W(51), W(52), W(53), W(54));
+        R5(F2, K2, W(55), W(56), W(57), W(58), W(59));
+
+        R5(F3, K3, W(60), W(61), W(62), W(63), W(64));
+        R5(F3, K3, W(65), W(66), W(67), W(68), W(69));
+        R5(F3, K3, W(70), W(71), W(72), W(73), W(74));
+        R5(F3, K3, W(75), W(76), W(77), W(78), W(79));
+
+        h_p[0] += a;
+        h_p[1] += b;
+        h_p[2] += c;
+        h_p[3] += d;
+        h_p[4] += e;
+
+        block_p += 64;
+        number_of_blocks--;
     }
+}
 
-    for (; i < 80; i++) {
-        f = (b ^ c ^ d);
-        t = rotateleft(a,5) + f + e + 0xca62c1d6 + w[i];
-        e = d;
-        d = c;
-        c = rotateleft(b, 30);
-        b = a;
-        a = t;
+/**
+ * Process given number of 64 bytes blocks using the fastest
+ * available implementation.
+ */
+static void blocks_update(struct sha1_t *self_p,
+                          const uint8_t *buf_p,
+                          size_t number_of_blocks)
+{
+#if SHA1_ARMV8_CRYPTO == 1
+    blocks_update_armv8(&self_p->h[0], buf_p, number_of_blocks);
+#else
+#    if SHA1_SHA_NI == 1
+    if (is_sha_ni_supported()) {
+        blocks_update_sha_ni(&self_p->h[0], buf_p, number_of_blocks);
+
+        return;
     }
+#    endif
 
-    self_p->h[0] += a;
-    self_p->h[1] += b;
-    self_p->h[2] += c;
-    self_p->h[3] += d;
-    self_p->h[4] += e;
+    blocks_update_generic(&self_p->h[0], buf_p, number_of_blocks);
+#endif
 }
 
 int sha1_init(struct sha1_t *self_p)
@@ -122,35 +364,41 @@ int sha1_update(struct sha1_t *self_p,
     ASSERTN(self_p != NULL, EINVAL);
     ASSERTN(buf_p != NULL, EINVAL);
 
-    uint32_t temp;
+    size_t n;
     uint8_t *b_p = buf_p;
 
     self_p->size += size;
 
     /* Prologue: Fill the buffer. */
     if (self_p->block.size > 0) {
-        if ((self_p->block.size + size) >= 64) {
-            temp = (64 - self_p->block.size);
-            memcpy(&self_p->block.buf[self_p->block.size], b_p, temp);
-            size -= temp;
-            b_p += temp;
-            block_update(self_p, self_p->block.buf);
-            self_p->block.size = 0;
+        n = MIN(64 - self_p->block.size, size);
+        memcpy(&self_p->block.buf[self_p->block.size], b_p, n);
+        self_p->block.size += n;
+        size -= n;
+        b_p += n;
+
+        if (self_p->block.size < 64) {
+            return (0);
         }
+
+        blocks_update(self_p, self_p->block.buf, 1);
+        self_p->block.size = 0;
     }
 
-    /* Main loop. */
-    while (size >= 64) {
-        memcpy(&self_p->block.buf[0], b_p, 64);
-        block_update(self_p, self_p->block.buf);
-        size -= 64;
-        b_p += 64;
+    /* Main loop: Process all complete blocks directly from the input
+       buffer. */
+    n = (size / 64);
+
+    if (n > 0) {
+        blocks_update(self_p, b_p, n);
+        size -= (64 * n);
+        b_p += (64 * n);
     }
 
     /* Epilogue: Save left over block in buffer. */
     if (size > 0) {
-        memcpy(&self_p->block.buf[self_p->block.size], b_p, size);
-        self_p->block.size += size;
+        memcpy(&self_p->block.buf[0], b_p, size);
+        self_p->block.size = size;
     }
 
     return (0);
@@ -180,7 +428,7 @@ int sha1_digest(struct sha1_t *self_p,
             memset(&self_p->block.buf[i], 0, 64 - i);
         }
 
-        block_update(self_p, self_p->block.buf);
+        blocks_update(self_p, self_p->block.buf, 1);
         memset(self_p->block.buf, 0, 56);
     }
 
@@ -189,14 +437,15 @@ int sha1_digest(struct sha1_t *self_p,
         self_p->block.buf[56 + i] = ((8 * self_p->size) >> (56 - 8 * i));
     }
 
-    block_update(self_p, self_p->block.buf);
+    blocks_update(self_p, self_p->block.buf, 1);
 
     /* Copy the hash to the output buffer. */
     for (i = 0; i < membersof(self_p->h); i++) {
-        self_p->h[i] = htonl(self_p->h[i]);
+        hash_p[4 * i + 0] = (self_p->h[i] >> 24);
+        hash_p[4 * i + 1] = (self_p->h[i] >> 16);
+        hash_p[4 * i + 2] = (self_p->h[i] >> 8);
+        hash_p[4 * i + 3] = self_p->h[i];
     }
 
-    memcpy(hash_p, self_p->h, 20);
-
     return (0);
 }
@@ -0,0 +1,233 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#define ROTR(value, positions)                                  \
+    (((value) >> (positions)) | ((value) << (32 - (positions))))
+
+/* Big endian load that works for any alignment. */
+#define LOAD32(buf_p)                           \
+    (((uint32_t)(buf_p)[0] << 24)               \
+     | ((uint32_t)(buf_p)[1] << 16)             \
+     | ((uint32_t)(buf_p)[2] << 8)              \
+     | ((uint32_t)(buf_p)[3]))
+
+#define CH(x, y, z) (((x) & ((y) ^ (z))) ^ (z))
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define EP0(x) (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define EP1(x) (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define SIG0(x) (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define SIG1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+
+/* Rolling 16 words message schedule. */
+#define W0(i) (w[i] = LOAD32(&block_p[4 * (i)]))
+
+#define W(i)                                            \
+    (w[(i) & 15] += (SIG1(w[((i) + 14) & 15])           \
+                     + w[((i) + 9) & 15]                \
+                     + SIG0(w[((i) + 1) & 15])))
+
+/* One round. Rotating the variable names instead of moving the
+   values between variables saves seven moves per round. */
+#define R(a, b, c, d, e, f, g, h, i, wi)                        \
+    t = (h + EP1(e) + CH(e, f, g) + k[i] + (wi));               \
+    d += t;                                                     \
+    h = (t + EP0(a) + MAJ(a, b, c));
+
+#define R8(i, wf)                                       \
+    R(a, b, c, d, e, f, g, h, (i) + 0, wf((i) + 0));    \
+    R(h, a, b, c, d, e, f, g, (i) + 1, wf((i) + 1));    \
+    R(g, h, a, b, c, d, e, f, (i) + 2, wf((i) + 2));    \
+    R(f, g, h, a, b, c, d, e, (i) + 3, wf((i) + 3));    \
+    R(e, f, g, h, a, b, c, d, (i) + 4, wf((i) + 4));    \
+    R(d, e, f, g, h, a, b, c, (i) + 5, wf((i) + 5));    \
+    R(c, d, e, f, g, h, a, b, (i) + 6, wf((i) + 6));    \
+    R(b, c, d, e, f, g, h, a, (i) + 7, wf((i) + 7))
+
+static FAR const uint32_t k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static void blocks_update(struct sha256_t *self_p,
+                          const uint8_t *block_p,
+                          size_t number_of_blocks)
+{
+    uint32_t a, b, c, d, e, f, g, h, t;
+    uint32_t w[16];
+    int i;
+
+    while (number_of_blocks > 0) {
+        a = self_p->h[0];
+        b = self_p->h[1];
+        c = self_p->h[2];
+        d = self_p->h[3];
+        e = self_p->h[4];
+        f = self_p->h[5];
+        g = self_p->h[6];
+        h = self_p->h[7];
+
+        R8(0, W0);
+        R8(8, W0);
+
+        for (i = 16; i < 64; i += 8) {
+            R8(i, W);
+        }
+
+        self_p->h[0] += a;
+        self_p->h[1] += b;
+        self_p->h[2] += c;
+        self_p->h[3] += d;
+        self_p->h[4] += e;
+        self_p->h[5] += f;
+        self_p->h[6] += g;
+        self_p->h[7] += h;
+
+        block_p += 64;
+        number_of_blocks--;
+    }
+}
+
+int sha256_init(struct sha256_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    self_p->block.size = 0;
+    self_p->h[0] = 0x6a09e667;
+    self_p->h[1] = 0xbb67ae85;
+    self_p->h[2] = 0x3c6ef372;
+    self_p->h[3] = 0xa54ff53a;
+    self_p->h[4] = 0x510e527f;
+    self_p->h[5] = 0x9b05688c;
+    self_p->h[6] = 0x1f83d9ab;
+    self_p->h[7] = 0x5be0cd19;
+    self_p->size = 0;
+
+    return (0);
+}
+
+int sha256_update(struct sha256_t *self_p,
+                  void *buf_p,
+                  size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    size_t n;
+    uint8_t *b_p = buf_p;
+
+    self_p->size += size;
+
+    /* Prologue: Fill the buffer. */
+    if (self_p->block.size > 0) {
+        n = MIN(64 - self_p->block.size, size);
+        memcpy(&self_p->block.buf[self_p->block.size], b_p, n);
+        self_p->block.size += n;
+        size -= n;
+        b_p += n;
+
+        if (self_p->block.size < 64) {
+            return (0);
+        }
+
+        blocks_update(self_p, self_p->block.buf, 1);
+        self_p->block.size = 0;
+    }
+
+    /* Main loop: Process all complete blocks directly from the input
+       buffer. */
+    n = (size / 64);
+
+    if (n > 0) {
+        blocks_update(self_p, b_p, n);
+        size -= (64 * n);
+        b_p += (64 * n);
+    }
+
+    /* Epilogue: Save left over block in buffer. */
+    if (size > 0) {
+        memcpy(&self_p->block.buf[0], b_p, size);
+        self_p->block.size = size;
+    }
+
+    return (0);
+}
+
+int sha256_digest(struct sha256_t *self_p,
+                  uint8_t *hash_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(hash_p != NULL, EINVAL);
+
+    int i;
+
+    i = self_p->block.size;
+
+    /* Add the last byte 0x80 and zero-padding. */
+    self_p->block.buf[i++] = 0x80;
+
+    if (i > 56) {
+        memset(&self_p->block.buf[i], 0, 64 - i);
+        blocks_update(self_p, self_p->block.buf, 1);
+        i = 0;
+    }
+
+    memset(&self_p->block.buf[i], 0, 56 - i);
+
+    /* Append the message length and do the last block update. */
+    for (i = 0; i < 8; i++) {
+        self_p->block.buf[56 + i] = ((8 * self_p->size) >> (56 - 8 * i));
+    }
+
+    blocks_update(self_p, self_p->block.buf, 1);
+
+    /* Copy the hash to the output buffer. */
+    for (i = 0; i < membersof(self_p->h); i++) {
+        hash_p[4 * i + 0] = (self_p->h[i] >> 24);
+        hash_p[4 * i + 1] = (self_p->h[i] >> 16);
+        hash_p[4 * i + 2] = (self_p->h[i] >> 8);
+        hash_p[4 * i + 3] = self_p->h[i];
+    }
+
+    return (0);
+}
@@ -0,0 +1,254 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+#    define MASK_VECTOR                                     1
+#else
+#    define MASK_VECTOR                                     0
+#endif
+
+typedef uintptr_t mask_word_t __attribute__ ((may_alias));
+
+#if MASK_VECTOR == 1
+typedef uint32_t mask_vector_t
+__attribute__ ((vector_size(16), may_alias));
+#    define MASK_ALIGNMENT                  sizeof(mask_vector_t)
+#else
+#    define MASK_ALIGNMENT                    sizeof(mask_word_t)
+#endif
+
+void http_websocket_mask(void *buf_p,
+                         size_t size,
+                         const uint8_t *masking_key_p,
+                         size_t offset)
+{
+    uint8_t *b_p;
+    uint8_t key[16];
+    mask_word_t word;
+    size_t i;
+#if MASK_VECTOR == 1
+    mask_vector_t vector;
+#endif
+
+    b_p = buf_p;
+
+    /* Bytes up to the first aligned word or vector. */
+    while ((size > 0) && (((uintptr_t)b_p % MASK_ALIGNMENT) != 0)) {
+        *b_p++ ^= masking_key_p[offset % 4];
+        offset++;
+        size--;
+    }
+
+    /* The masking key repeated and rotated to the current offset. */
+    for (i = 0; i < sizeof(key); i++) {
+        key[i] = masking_key_p[(offset + i) % 4];
+    }
+
+#if MASK_VECTOR == 1
+    memcpy(&vector, &key[0], sizeof(vector));
+
+    while (size >= sizeof(vector)) {
+        *(mask_vector_t *)b_p ^= vector;
+        b_p += sizeof(vector);
+        size -= sizeof(vector);
+    }
+#endif
+
+    memcpy(&word, &key[0], sizeof(word));
+
+    while (size >= sizeof(word)) {
+        *(mask_word_t *)b_p ^= word;
+        b_p += sizeof(word);
+        size -= sizeof(word);
+    }
+
+    /* Trailing bytes. The offset is a multiple of four from the
+       rotated key. */
+    for (i = 0; i < size; i++) {
+        b_p[i] ^= key[i];
+    }
+}
+
+ssize_t http_websocket_read_header(struct socket_t *socket_p,
+                                   struct http_websocket_header_t *header_p,
+                                   void *buf_p,
+                                   size_t size)
+{
+    uint8_t buf[HTTP_WEBSOCKET_HEADER_SIZE_MAX
+                + CONFIG_HTTP_WEBSOCKET_BUFFER_SIZE];
+    size_t header_size;
+    size_t n;
+    uint8_t *key_p;
+
+    if (socket_read(socket_p, buf, 2) != 2) {
+        return (-EIO);
+    }
+
+    header_p->fin = (buf[0] & INET_HTTP_WEBSOCKET_FIN);
+    header_p->opcode = (buf[0] & 0x0f);
+    header_p->masked = (buf[1] & INET_HTTP_WEBSOCKET_MASK);
+    header_p->payload_size = (buf[1] & ~INET_HTTP_WEBSOCKET_MASK);
+
+    if (header_p->payload_size == 126) {
+        header_size = 2;
+    } else if (header_p->payload_size == 127) {
+        header_size = 8;
+    } else {
+        header_size = 0;
+    }
+
+    if (header_p->masked) {
+        header_size += 4;
+    }
+
+    /* Read ahead the payload of a small frame. The payload size of
+       longer frames is not yet known. */
+    n = 0;
+
+    if (header_size <= 4) {
+        n = MIN(MIN(header_p->payload_size, size),
+                CONFIG_HTTP_WEBSOCKET_BUFFER_SIZE);
+    }
+
+    if (header_size + n > 0) {
+        if (socket_read(socket_p, &buf[2], header_size + n)
+            != header_size + n) {
+            return (-EIO);
+        }
+    }
+
+    key_p = &buf[2];
+
+    if (header_p->payload_size == 126) {
+        header_p->payload_size = ((uint32_t)(buf[2]) << 8 | buf[3]);
+        key_p += 2;
+    } else if (header_p->payload_size == 127) {
+        header_p->payload_size = ((uint32_t)(buf[6]) << 24
+                                  | (uint32_t)(buf[7]) << 16
+                                  | (uint32_t)(buf[8]) << 8
+                                  | buf[9]);
+        key_p += 8;
+    }
+
+    if (header_p->masked) {
+        memcpy(&header_p->masking_key[0], key_p, 4);
+    } else {
+        memset(&header_p->masking_key[0], 0, 4);
+    }
+
+    if (n > 0) {
+        memcpy(buf_p, &buf[2 + header_size], n);
+
+        if (header_p->masked) {
+            http_websocket_mask(buf_p, n, &header_p->masking_key[0], 0);
+        }
+    }
+
+    return (n);
+}
+
+int http_websocket_discard(struct socket_t *socket_p, size_t size)
+{
+    uint8_t buf[CONFIG_HTTP_WEBSOCKET_BUFFER_SIZE];
+    size_t n;
+
+    while (size > 0) {
+        n = MIN(size, sizeof(buf));
+
+        if (socket_read(socket_p, buf, n) != n) {
+            return (-EIO);
+        }
+
+        size -= n;
+    }
+
+    return (0);
+}
+
+ssize_t http_websocket_write_frame(struct socket_t *socket_p,
+                                   int type,
+                                   int masked,
+                                   const void *buf_p,
+                                   uint32_t size)
+{
+    uint8_t buf[HTTP_WEBSOCKET_HEADER_SIZE_MAX
+                + CONFIG_HTTP_WEBSOCKET_BUFFER_SIZE];
+    size_t header_size;
+    size_t n;
+    uint8_t mask;
+
+    header_size = 2;
+    mask = (masked ? INET_HTTP_WEBSOCKET_MASK : 0);
+    buf[0] = (INET_HTTP_WEBSOCKET_FIN | type);
+
+    if (size < 126) {
+        buf[1] = (mask | size);
+    } else if (size < 65536) {
+        buf[1] = (mask | 126);
+        buf[2] = ((size >> 8) & 0xff);
+        buf[3] = ((size >> 0) & 0xff);
+        header_size += 2;
+    } else {
+        buf[1] = (mask | 127);
+        buf[2] = 0;
+        buf[3] = 0;
+        buf[4] = 0;
+        buf[5] = 0;
+        buf[6] = ((size >> 24) & 0xff);
+        buf[7] = ((size >> 16) & 0xff);
+        buf[8] = ((size >>  8) & 0xff);
+        buf[9] = ((size >>  0) & 0xff);
+        header_size += 8;
+    }
+
+    if (masked) {
+        memset(&buf[header_size], 0, 4);
+        header_size += 4;
+    }
+
+    /* The header and the beginning of the payload in one write. */
+    n = MIN(size, sizeof(buf) - header_size);
+    memcpy(&buf[header_size], buf_p, n);
+
+    if (socket_write(socket_p, buf, header_size + n) != header_size + n) {
+        return (-EIO);
+    }
+
+    /* The rest of the payload. */
+    if (size > n) {
+        if (socket_write(socket_p,
+                         (const uint8_t *)buf_p + n,
+                         size - n) != size - n) {
+            return (-EIO);
+        }
+    }
+
+    return (size);
+}
@@ -0,0 +1,115 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __INET_HTTP_WEBSOCKET_H__
+#define __INET_HTTP_WEBSOCKET_H__
+
+#include "simba.h"
+
+/**
+ * Maximum size of a frame header; two bytes, an eight bytes extended
+ * payload length and a four bytes masking key.
+ */
+#define HTTP_WEBSOCKET_HEADER_SIZE_MAX                     14
+
+/**
+ * A websocket frame header.
+ */
+struct http_websocket_header_t {
+    int fin;
+    int opcode;
+    int masked;
+    uint8_t masking_key[4];
+    uint32_t payload_size;
+};
+
+/**
+ * Mask or unmask given payload data in place. The data is processed a
+ * word at a time, or a vector at a time if supported by the CPU.
+ *
+ * @param[in,out] buf_p Payload data to mask or unmask.
+ * @param[in] size Size of the payload data.
+ * @param[in] masking_key_p Four bytes masking key.
+ * @param[in] offset Offset of given data in the frame payload.
+ */
+void http_websocket_mask(void *buf_p,
+                         size_t size,
+                         const uint8_t *masking_key_p,
+                         size_t offset);
+
+/**
+ * Read a frame header from given socket. The rest of the header and
+ * the payload of a small frame are read in a single socket read,
+ * storing at most given number of unmasked payload bytes in given
+ * buffer.
+ *
+ * @param[in] socket_p Socket to read from.
+ * @param[out] header_p Read frame header.
+ * @param[out] buf_p Buffer to read payload data into.
+ * @param[in] size Size of the buffer.
+ *
+ * @return Number of payload bytes read into the buffer or negative
+ *         error code.
+ */
+ssize_t http_websocket_read_header(struct socket_t *socket_p,
+                                   struct http_websocket_header_t *header_p,
+                                   void *buf_p,
+                                   size_t size);
+
+/**
+ * Read and discard given number of payload bytes.
+ *
+ * @param[in] socket_p Socket to read from.
+ * @param[in] size Number of bytes to discard.
+ *
+ * @return zero(0) or negative error code.
+ */
+int http_websocket_discard(struct socket_t *socket_p, size_t size);
+
+/**
+ * Write a frame with given payload to given socket. The header and
+ * the beginning of the payload are written in a single socket write,
+ * so the header is never sent in a segment of its own.
+ *
+ * @param[in] socket_p Socket to write to.
+ * @param[in] type Message type.
+ * @param[in] masked Masked (client) or unmasked (server) frame. Masked
+ *                   frames use an all zeros masking key, so the
+ *                   payload is sent as is.
+ * @param[in] buf_p Payload to write.
+ * @param[in] size Size of the payload.
+ *
+ * @return Number of payload bytes written or negative error code.
+ */
+ssize_t http_websocket_write_frame(struct socket_t *socket_p,
+                                   int type,
+                                   int masked,
+                                   const void *buf_p,
+                                   uint32_t size);
+
+#endif
@@ -117,6 +117,8 @@ int http_websocket_client_connect(struct http_websocket_client_t *self_p)
         return (-EIO);
     }
 
+    self_p->frame.left = 0;
+
     /* Perform the handshake with the server. */
     std_fprintf(&self_p->server.socket,
                 FSTR("GET %s HTTP/1.1\r\n"
@@ -164,8 +166,10 @@ ssize_t http_websocket_client_read(struct http_websocket_client_t *self_p,
     ASSERTN(buf_p != NULL, EINVAL);
     ASSERTN(size > 0, EINVAL);
 
-    uint8_t buf[16];
+    struct http_websocket_header_t header;
+    uint8_t *b_p = buf_p;
     size_t left = size, n;
+    ssize_t res;
 
     while (left > 0) {
         /* Read buffered frame data. */
@@ -176,44 +180,42 @@ ssize_t http_websocket_client_read(struct http_websocket_client_t *self_p,
                 n = left;
             }
 
-            if (socket_read(&self_p->server.socket, buf_p, n) != n) {
+            if (socket_read(&self_p->server.socket, b_p, n) != n) {
                 return (-EIO);
             }
 
+            if (self_p->frame.masked) {
+                http_websocket_mask(b_p,
+                                    n,
+                                    &self_p->frame.masking_key[0],
+                                    self_p->frame.offset);
+            }
+
             self_p->frame.left -= n;
+            self_p->frame.offset += n;
+            b_p += n;
             left -= n;
         }
 
         if (left > 0) {
-            /* Read the next frame. */
-            if (socket_read(&self_p->server.socket, buf, 2) != 2) {
-                return (-EIO);
+            /* Read the next frame, and the payload if small. */
+            res = http_websocket_read_header(&self_p->server.socket,
+                                             &header,
+                                             b_p,
+                                             left);
+
+            if (res < 0) {
+                return (res);
             }
 
-            self_p->frame.left = (buf[1] & ~INET_HTTP_WEBSOCKET_MASK);
-
-            if (self_p->frame.left == 126) {
-                if (socket_read(&self_p->server.socket, &buf[2], 2) != 2) {
-                    return (-EIO);
-                }
-
-                self_p->frame.left = ((uint32_t)(buf[2]) << 8 | buf[3]);
-            } else if (self_p->frame.left == 127) {
-                if (socket_read(&self_p->server.socket, &buf[2], 8) != 8) {
-                    return (-EIO);
-                }
-
-                self_p->frame.left = ((uint32_t)(buf[6]) << 24
-                                      | (uint32_t)(buf[7]) << 16
-                                      | (uint32_t)(buf[8]) << 8
-                                      | buf[9]);
-            }
-
-            if (buf[1] & INET_HTTP_WEBSOCKET_MASK) {
-                if (socket_read(&self_p->server.socket, buf, 4) != 4) {
-                    return (-EIO);
-                }
-            }
+            self_p->frame.left = (header.payload_size - res);
+            self_p->frame.offset = res;
+            self_p->frame.masked = header.masked;
+            memcpy(&self_p->frame.masking_key[0],
+                   &header.masking_key[0],
+                   sizeof(self_p->frame.masking_key));
+            b_p += res;
+            left -= res;
         }
     }
 
@@ -229,47 +231,9 @@ ssize_t http_websocket_client_write(struct http_websocket_client_t *self_p,
     ASSERTN(buf_p != NULL, EINVAL);
     ASSERTN(size > 0, EINVAL);
 
-    const uint8_t masking_key[4] = { 0x00, 0x00, 0x00, 0x00 };
-    uint8_t header[16];
-    size_t header_size = 2;
-
-    header[0] = (INET_HTTP_WEBSOCKET_FIN | type);
-
-    if (size < 126) {
-        header[1] = (INET_HTTP_WEBSOCKET_MASK | size);
-    } else if (size < 65536) {
-        header[1] = (INET_HTTP_WEBSOCKET_MASK | 126);
-        header[2] = ((size >> 8) & 0xff);
-        header[3] = ((size >> 0) & 0xff);
-        header_size += 2;
-    } else {
-        header[1] = (INET_HTTP_WEBSOCKET_MASK | 127);
-        header[2] = 0;
-        header[3] = 0;
-        header[4] = 0;
-        header[5] = 0;
-        header[6] = ((size >> 24) & 0xff);
-        header[7] = ((size >> 16) & 0xff);
-        header[8] = ((size >>  8) & 0xff);
-        header[9] = ((size >>  0) & 0xff);
-        header_size += 8;
-    }
-
-    header[header_size + 0] = masking_key[0];
-    header[header_size + 1] = masking_key[1];
-    header[header_size + 2] = masking_key[2];
-    header[header_size + 3] = masking_key[3];
-    header_size += 4;
-
-    if (socket_write(&self_p->server.socket,
-                     header,
-                     header_size) != header_size) {
-        return (-EIO);
-    }
-
-    if (socket_write(&self_p->server.socket, buf_p, size) != size) {
-        return (-EIO);
-    }
-
-    return (size);
+    return (http_websocket_write_frame(&self_p->server.socket,
+                                       type,
+                                       1,
+                                       buf_p,
+                                       size));
 }
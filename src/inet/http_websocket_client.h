@@ -39,6 +39,9 @@ struct http_websocket_client_t {
     } server;
     struct {
         size_t left;
+        size_t offset;
+        int masked;
+        uint8_t masking_key[4];
     } frame;
     const char *path_p;
 };
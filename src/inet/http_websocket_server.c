@@ -106,80 +106,50 @@ ssize_t http_websocket_server_read(struct http_websocket_server_t *self_p,
     ASSERTN(buf_p != NULL, EINVAL)
     ASSERTN(size > 0, EINVAL)
 
-    uint8_t buf[16], *b_p = buf_p;
+    struct http_websocket_header_t header;
+    uint8_t *b_p = buf_p;
     size_t payload_left, left = size, n;
-    int fin = 0;
-    uint8_t masking_key[4];
-    int pos;
-    int i;
-
-    while (fin == 0) {
-        /* Read the next frame. */
-        if (socket_read(self_p->socket_p, buf, 2) != 2) {
-            return (-EIO);
-        }
-
-        fin = (buf[0] & INET_HTTP_WEBSOCKET_FIN);
-        payload_left = (buf[1] & ~INET_HTTP_WEBSOCKET_MASK);
+    ssize_t res;
 
-        if (payload_left == 126) {
-            if (socket_read(self_p->socket_p, &buf[2], 2) != 2) {
-                return (-EIO);
-            }
+    header.fin = 0;
 
-            payload_left = ((uint32_t)(buf[2]) << 8 | buf[3]);
-        } else if (payload_left == 127) {
-            if (socket_read(self_p->socket_p, &buf[2], 8) != 8) {
-                return (-EIO);
-            }
+    while (header.fin == 0) {
+        /* Read the next frame, and the payload if small. */
+        res = http_websocket_read_header(self_p->socket_p,
+                                         &header,
+                                         b_p,
+                                         left);
 
-            payload_left = ((uint32_t)(buf[6]) << 24
-                    | (uint32_t)(buf[7]) << 16
-                    | (uint32_t)(buf[8]) << 8
-                    | buf[9]);
+        if (res < 0) {
+            return (res);
         }
 
-        /* Read the mask. */
-        if (buf[1] & INET_HTTP_WEBSOCKET_MASK) {
-            if (socket_read(self_p->socket_p,
-                            &masking_key[0],
-                            sizeof(masking_key)) != sizeof(masking_key)) {
-                return (-EIO);
-            }
-        } else {
-            memset(&masking_key[0], 0, sizeof(masking_key));
-        }
+        b_p += res;
+        left -= res;
+        payload_left = (header.payload_size - res);
 
-        /* Read the payload. */
-        pos = 0;
-
-        while ((payload_left > 0) && (left > 0)) {
-            if (payload_left < left) {
-                n = payload_left;
-            } else {
-                n = left;
-            }
+        /* Read the rest of the payload. */
+        if ((payload_left > 0) && (left > 0)) {
+            n = MIN(payload_left, left);
 
             if (socket_read(self_p->socket_p, b_p, n) != n) {
-                return (-1);
+                return (-EIO);
             }
 
-            for (i = 0; i < n; i++) {
-                *b_p++ ^= masking_key[pos % 4];
-                pos++;
+            if (header.masked) {
+                http_websocket_mask(b_p, n, &header.masking_key[0], res);
             }
 
+            b_p += n;
             left -= n;
             payload_left -= n;
         }
 
         /* Discard leftover data. */
-        while (payload_left > 0) {
-            if (socket_read(self_p->socket_p, buf, 1) != 1) {
-                return (-1);
-            }
+        res = http_websocket_discard(self_p->socket_p, payload_left);
 
-            payload_left--;
+        if (res != 0) {
+            return (res);
         }
     }
 
@@ -195,40 +165,9 @@ ssize_t http_websocket_server_write(struct http_websocket_server_t *self_p,
     ASSERTN(buf_p != NULL, EINVAL)
     ASSERTN(size > 0, EINVAL)
 
-    uint8_t header[16];
-    size_t header_size = 2;
-
-    header[0] = (INET_HTTP_WEBSOCKET_FIN | type);
-
-    if (size < 126) {
-        header[1] = size;
-    } else if (size < 65536) {
-        header[1] = 126;
-        header[2] = ((size >> 8) & 0xff);
-        header[3] = ((size >> 0) & 0xff);
-        header_size += 2;
-    } else {
-        header[1] = 127;
-        header[2] = 0;
-        header[3] = 0;
-        header[4] = 0;
-        header[5] = 0;
-        header[6] = ((size >> 24) & 0xff);
-        header[7] = ((size >> 16) & 0xff);
-        header[8] = ((size >>  8) & 0xff);
-        header[9] = ((size >>  0) & 0xff);
-        header_size += 8;
-    }
-
-    if (socket_write(self_p->socket_p,
-                     header,
-                     header_size) != header_size) {
-        return (-EIO);
-    }
-
-    if (socket_write(self_p->socket_p, buf_p, size) != size) {
-        return (-EIO);
-    }
-
-    return (size);
+    return (http_websocket_write_frame(self_p->socket_p,
+                                       type,
+                                       0,
+                                       buf_p,
+                                       size));
 }
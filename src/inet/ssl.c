@@ -39,37 +39,173 @@
 #include "mbedtls/error.h"
 #include "mbedtls/debug.h"
 #include "mbedtls/timing.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
+#include "mbedtls/platform.h"
+
+#if (CONFIG_SSL_SESSION_CACHE_MAX > 0) && defined(MBEDTLS_SSL_CACHE_C)
+#    define SESSION_CACHE                                   1
+#else
+#    define SESSION_CACHE                                   0
+#endif
+
+#if (CONFIG_SSL_SESSION_TICKETS == 1)           \
+    && defined(MBEDTLS_SSL_TICKET_C)            \
+    && defined(MBEDTLS_SSL_SESSION_TICKETS)
+#    define SESSION_TICKETS                                 1
+#else
+#    define SESSION_TICKETS                                 0
+#endif
+
+#if (CONFIG_SSL_CLIENT_SESSIONS_MAX > 0) && defined(MBEDTLS_SSL_CLI_C)
+#    define CLIENT_SESSIONS                                 1
+#else
+#    define CLIENT_SESSIONS                                 0
+#endif
+
+#if defined(MBEDTLS_PLATFORM_MEMORY)
+#    define PLATFORM_MEMORY                                 1
+#else
+#    define PLATFORM_MEMORY                                 0
+#endif
+
+#if (CONFIG_SSL_RECORD_BUFFER_POOL == 1) && (PLATFORM_MEMORY == 1)
+#    define RECORD_BUFFER_POOL                              1
+#else
+#    define RECORD_BUFFER_POOL                              0
+#endif
+
+/* Size of the pooled input and output record buffers. mbedTLS adds
+   the record header, IV, padding and MAC to the maximum payload
+   size. Larger record buffers, for example with compression, are
+   allocated on the heap. */
+#define RECORD_BUFFER_SIZE         (MBEDTLS_SSL_MAX_CONTENT_LEN + 512)
+
+/* Maximum fragment length requested by client side sockets. */
+#if CONFIG_SSL_RECORD_SIZE_MAX == 512
+#    define MAX_FRAG_LEN                   MBEDTLS_SSL_MAX_FRAG_LEN_512
+#elif CONFIG_SSL_RECORD_SIZE_MAX == 1024
+#    define MAX_FRAG_LEN                  MBEDTLS_SSL_MAX_FRAG_LEN_1024
+#elif CONFIG_SSL_RECORD_SIZE_MAX == 2048
+#    define MAX_FRAG_LEN                  MBEDTLS_SSL_MAX_FRAG_LEN_2048
+#elif CONFIG_SSL_RECORD_SIZE_MAX == 4096
+#    define MAX_FRAG_LEN                  MBEDTLS_SSL_MAX_FRAG_LEN_4096
+#else
+#    define MAX_FRAG_LEN                  MBEDTLS_SSL_MAX_FRAG_LEN_NONE
+#endif
+
+/* Sessions of longer hostnames are not remembered. */
+#define CLIENT_SESSION_HOSTNAME_MAX                        64
+
+#if CLIENT_SESSIONS == 1
+
+/**
+ * The session of the last connection to a server.
+ */
+struct client_session_t {
+    char hostname[CLIENT_SESSION_HOSTNAME_MAX];
+    mbedtls_ssl_session session;
+    int valid;
+    uint32_t last_used;
+};
+
+#endif
+
+/**
+ * Connection state of an SSL socket.
+ */
+struct slot_t {
+    mbedtls_ssl_context ssl;
+    int allocated;
+    struct thrd_t *setup_thrd_p;
+    struct thrd_t *handshake_thrd_p;
+    int resumed;
+};
+
+#if RECORD_BUFFER_POOL == 1
+
+/**
+ * An input or output record buffer.
+ */
+struct record_buffer_t {
+    uint64_t buf[DIV_CEIL(RECORD_BUFFER_SIZE, sizeof(uint64_t))];
+    int allocated;
+};
+
+#endif
+
+#if PLATFORM_MEMORY == 1
+
+/**
+ * Prepended to heap allocations to know their size when freed.
+ */
+union memory_header_t {
+    size_t size;
+    uint64_t align;
+    void *align_p;
+};
+
+#endif
 
 struct module_t {
     int8_t initialized;
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context ctr_drbg;
-    mbedtls_ssl_context ssl;
-    int ssl_allocated;
+    struct slot_t slots[CONFIG_SSL_SOCKETS_MAX];
+#if RECORD_BUFFER_POOL == 1
+    struct record_buffer_t record_buffers[2 * CONFIG_SSL_SOCKETS_MAX];
+#endif
+    struct ssl_memory_usage_t memory;
     mbedtls_ssl_config conf;
     int conf_allocated;
     mbedtls_x509_crt cert;
     mbedtls_pk_context key;
     mbedtls_x509_crt ca_certs;
     mbedtls_timing_delay_context timer;
+#if SESSION_CACHE == 1
+    mbedtls_ssl_cache_context cache;
+#endif
+#if SESSION_TICKETS == 1
+    mbedtls_ssl_ticket_context ticket;
+#endif
+#if CLIENT_SESSIONS == 1
+    struct {
+        struct client_session_t sessions[CONFIG_SSL_CLIENT_SESSIONS_MAX];
+        uint32_t counter;
+    } client;
+#endif
 };
 
 static struct module_t module;
 
 static void *alloc_ssl(void)
 {
-    if (module.ssl_allocated == 1) {
-        return (NULL);
+    int i;
+    void *ssl_p;
+
+    ssl_p = NULL;
+
+    sys_lock();
+
+    for (i = 0; i < membersof(module.slots); i++) {
+        if (!module.slots[i].allocated) {
+            module.slots[i].allocated = 1;
+            ssl_p = &module.slots[i].ssl;
+            break;
+        }
     }
 
-    module.ssl_allocated = 1;
+    sys_unlock();
 
-    return (&module.ssl);
+    return (ssl_p);
 }
 
 static void free_ssl(void *ssl_p)
 {
-    module.ssl_allocated = 0;
+    struct slot_t *slot_p;
+
+    slot_p = container_of(ssl_p, struct slot_t, ssl);
+    slot_p->allocated = 0;
 }
 
 static void *alloc_conf(void)
@@ -88,6 +224,405 @@ static void free_conf(void *conf_p)
     module.conf_allocated = 0;
 }
 
+#if PLATFORM_MEMORY == 1
+
+static void memory_add(size_t size)
+{
+    sys_lock();
+
+    module.memory.current += size;
+
+    if (module.memory.current > module.memory.peak) {
+        module.memory.peak = module.memory.current;
+    }
+
+    sys_unlock();
+}
+
+static void memory_remove(size_t size)
+{
+    sys_lock();
+    module.memory.current -= size;
+    sys_unlock();
+}
+
+#if RECORD_BUFFER_POOL == 1
+
+/**
+ * Check if the current thread is setting up an SSL connection.
+ */
+static int is_setup_thread(void)
+{
+    int i;
+    struct thrd_t *thrd_p;
+
+    thrd_p = thrd_self();
+
+    for (i = 0; i < membersof(module.slots); i++) {
+        if (module.slots[i].setup_thrd_p == thrd_p) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/**
+ * Allocate a record buffer from the pool. Returns NULL if all are in
+ * use.
+ */
+static void *record_buffer_alloc(void)
+{
+    int i;
+    struct record_buffer_t *buffer_p;
+
+    buffer_p = NULL;
+
+    sys_lock();
+
+    for (i = 0; i < membersof(module.record_buffers); i++) {
+        if (!module.record_buffers[i].allocated) {
+            buffer_p = &module.record_buffers[i];
+            buffer_p->allocated = 1;
+            break;
+        }
+    }
+
+    sys_unlock();
+
+    if (buffer_p == NULL) {
+        return (NULL);
+    }
+
+    memory_add(sizeof(buffer_p->buf));
+    memset(&buffer_p->buf[0], 0, sizeof(buffer_p->buf));
+
+    return (&buffer_p->buf[0]);
+}
+
+/**
+ * Free given record buffer. Returns false(0) if the pointer is not a
+ * record buffer in the pool.
+ */
+static int record_buffer_free(void *buf_p)
+{
+    struct record_buffer_t *buffer_p;
+
+    char *begin_p;
+    char *end_p;
+
+    begin_p = (char *)&module.record_buffers[0];
+    end_p = (char *)&module.record_buffers[membersof(module.record_buffers)];
+
+    if (((char *)buf_p < begin_p) || ((char *)buf_p >= end_p)) {
+        return (0);
+    }
+
+    buffer_p = container_of(buf_p, struct record_buffer_t, buf);
+    buffer_p->allocated = 0;
+    memory_remove(sizeof(buffer_p->buf));
+
+    return (1);
+}
+
+#endif
+
+/**
+ * The mbedTLS allocator, counting the allocated memory. If the record
+ * buffer pool is enabled, the input and output record buffers
+ * allocated by mbedtls_ssl_setup() are taken from the pool, while
+ * everything else is allocated on the heap. Other allocations during
+ * the setup are much smaller than a record.
+ */
+static void *memory_calloc(size_t nmemb, size_t size)
+{
+    union memory_header_t *header_p;
+#if RECORD_BUFFER_POOL == 1
+    void *buf_p;
+#endif
+
+    if ((size != 0) && (nmemb > (SIZE_MAX / size))) {
+        return (NULL);
+    }
+
+    size *= nmemb;
+
+#if RECORD_BUFFER_POOL == 1
+    if ((size > MBEDTLS_SSL_MAX_CONTENT_LEN)
+        && (size <= RECORD_BUFFER_SIZE)
+        && is_setup_thread()) {
+        buf_p = record_buffer_alloc();
+
+        if (buf_p != NULL) {
+            return (buf_p);
+        }
+    }
+#endif
+
+    header_p = calloc(1, sizeof(*header_p) + size);
+
+    if (header_p == NULL) {
+        return (NULL);
+    }
+
+    header_p->size = size;
+    memory_add(size);
+
+    return (header_p + 1);
+}
+
+static void memory_free(void *buf_p)
+{
+    union memory_header_t *header_p;
+
+    if (buf_p == NULL) {
+        return;
+    }
+
+#if RECORD_BUFFER_POOL == 1
+    if (record_buffer_free(buf_p)) {
+        return;
+    }
+#endif
+
+    header_p = ((union memory_header_t *)buf_p - 1);
+    memory_remove(header_p->size);
+    free(header_p);
+}
+
+#endif
+
+#if CLIENT_SESSIONS == 1
+
+/**
+ * Find the remembered session of given server. Called with the system
+ * lock taken.
+ */
+static struct client_session_t *client_session_find(const char *hostname_p)
+{
+    int i;
+    struct client_session_t *session_p;
+
+    for (i = 0; i < membersof(module.client.sessions); i++) {
+        session_p = &module.client.sessions[i];
+
+        if (session_p->valid
+            && (strcmp(session_p->hostname, hostname_p) == 0)) {
+            return (session_p);
+        }
+    }
+
+    return (NULL);
+}
+
+/**
+ * Take the remembered session of given server out of the table, so
+ * no other connection uses or replaces it while it is offered.
+ *
+ * @return true(1) if a session was taken, otherwise false(0).
+ */
+static int client_session_take(const char *hostname_p,
+                               mbedtls_ssl_session *session_p)
+{
+    struct client_session_t *entry_p;
+
+    sys_lock();
+
+    entry_p = client_session_find(hostname_p);
+
+    if (entry_p != NULL) {
+        *session_p = entry_p->session;
+        entry_p->valid = 0;
+    }
+
+    sys_unlock();
+
+    return (entry_p != NULL);
+}
+
+/**
+ * Remember the session of given SSL connection to given server,
+ * replacing the least recently used session if all are in use. The
+ * replaced session is freed after the system lock is released, as
+ * freeing memory takes the lock.
+ *
+ * @return true(1) if the connection resumed given offered session,
+ *         otherwise false(0).
+ */
+static int client_session_save(const char *hostname_p,
+                               mbedtls_ssl_context *ssl_p,
+                               const mbedtls_ssl_session *offered_p)
+{
+    int i;
+    int resumed;
+    int replaced;
+    struct client_session_t *entry_p;
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session replaced_session;
+
+    if (strlen(hostname_p) >= CLIENT_SESSION_HOSTNAME_MAX) {
+        return (0);
+    }
+
+    mbedtls_ssl_session_init(&session);
+
+    if (mbedtls_ssl_get_session(ssl_p, &session) != 0) {
+        mbedtls_ssl_session_free(&session);
+
+        return (0);
+    }
+
+    resumed = 0;
+
+    if (offered_p != NULL) {
+        /* A resumed session has the master secret of the offered
+           session, while a full handshake derives a new one. */
+        resumed = (memcmp(&session.master[0],
+                          &offered_p->master[0],
+                          sizeof(session.master)) == 0);
+    }
+
+    sys_lock();
+
+    /* Another connection to the server may have saved its session
+       meanwhile. */
+    entry_p = client_session_find(hostname_p);
+
+    if (entry_p == NULL) {
+        entry_p = &module.client.sessions[0];
+
+        for (i = 0; i < membersof(module.client.sessions); i++) {
+            if (!module.client.sessions[i].valid) {
+                entry_p = &module.client.sessions[i];
+                break;
+            }
+
+            if (module.client.sessions[i].last_used < entry_p->last_used) {
+                entry_p = &module.client.sessions[i];
+            }
+        }
+    }
+
+    replaced = entry_p->valid;
+    replaced_session = entry_p->session;
+    strcpy(&entry_p->hostname[0], hostname_p);
+    entry_p->session = session;
+    entry_p->valid = 1;
+    entry_p->last_used = module.client.counter++;
+
+    sys_unlock();
+
+    if (replaced) {
+        mbedtls_ssl_session_free(&replaced_session);
+    }
+
+    return (resumed);
+}
+
+#endif
+
+/**
+ * Setup given SSL connection. The record buffer pool is only used by
+ * the thread setting up a connection.
+ */
+static int setup(mbedtls_ssl_context *ssl_p)
+{
+    int res;
+    struct slot_t *slot_p;
+
+    slot_p = container_of(ssl_p, struct slot_t, ssl);
+    slot_p->setup_thrd_p = thrd_self();
+    res = mbedtls_ssl_setup(ssl_p, &module.conf);
+    slot_p->setup_thrd_p = NULL;
+
+    return (res);
+}
+
+#if (SESSION_CACHE == 1) || (SESSION_TICKETS == 1)
+
+/**
+ * Mark the session of the server side handshake performed by the
+ * current thread as resumed.
+ */
+static void mark_resumed(void)
+{
+    int i;
+    struct thrd_t *thrd_p;
+
+    thrd_p = thrd_self();
+
+    for (i = 0; i < membersof(module.slots); i++) {
+        if (module.slots[i].handshake_thrd_p == thrd_p) {
+            module.slots[i].resumed = 1;
+        }
+    }
+}
+
+#endif
+
+#if SESSION_CACHE == 1
+
+/**
+ * The session is resumed if found in the session cache.
+ */
+static int session_cache_get(void *data_p, mbedtls_ssl_session *session_p)
+{
+    int res;
+
+    res = mbedtls_ssl_cache_get(data_p, session_p);
+
+    if (res == 0) {
+        mark_resumed();
+    }
+
+    return (res);
+}
+
+#endif
+
+#if SESSION_TICKETS == 1
+
+/**
+ * The session is resumed if the ticket sent by the client is valid.
+ */
+static int session_ticket_parse(void *ticket_p,
+                                mbedtls_ssl_session *session_p,
+                                unsigned char *buf_p,
+                                size_t size)
+{
+    int res;
+
+    res = mbedtls_ssl_ticket_parse(ticket_p, session_p, buf_p, size);
+
+    if (res == 0) {
+        mark_resumed();
+    }
+
+    return (res);
+}
+
+#endif
+
+/**
+ * Perform the handshake with the remote peer. The session cache and
+ * session ticket callbacks mark the session of a server side socket
+ * as resumed.
+ */
+static int handshake(mbedtls_ssl_context *ssl_p, int *resumed_p)
+{
+    int res;
+    struct slot_t *slot_p;
+
+    slot_p = container_of(ssl_p, struct slot_t, ssl);
+    slot_p->resumed = 0;
+    slot_p->handshake_thrd_p = thrd_self();
+    res = mbedtls_ssl_handshake(ssl_p);
+    slot_p->handshake_thrd_p = NULL;
+    *resumed_p = slot_p->resumed;
+
+    return (res);
+}
+
 static int ssl_send(void *ctx_p,
                     const unsigned char *buf_p,
                     size_t len)
@@ -104,6 +639,8 @@ static int ssl_recv(void *ctx_p,
 
 int ssl_module_init()
 {
+    int i;
+
     /* Return immediately if the module is already initialized. */
     if (module.initialized == 1) {
         return (0);
@@ -111,6 +648,28 @@ int ssl_module_init()
 
     module.initialized = 1;
 
+    /* The pools of connection states and record buffers. */
+    for (i = 0; i < membersof(module.slots); i++) {
+        module.slots[i].allocated = 0;
+        module.slots[i].setup_thrd_p = NULL;
+        module.slots[i].handshake_thrd_p = NULL;
+    }
+
+#if RECORD_BUFFER_POOL == 1
+    for (i = 0; i < membersof(module.record_buffers); i++) {
+        module.record_buffers[i].allocated = 0;
+    }
+#endif
+
+#if PLATFORM_MEMORY == 1
+    if (mbedtls_platform_set_calloc_free(memory_calloc, memory_free) != 0) {
+        return (-1);
+    }
+#endif
+
+    module.memory.current = 0;
+    module.memory.peak = 0;
+
     mbedtls_entropy_init(&module.entropy);
     mbedtls_ctr_drbg_init(&module.ctr_drbg);
 
@@ -123,6 +682,55 @@ int ssl_module_init()
         return (-1);
     }
 
+#if SESSION_CACHE == 1
+    mbedtls_ssl_cache_init(&module.cache);
+    mbedtls_ssl_cache_set_max_entries(&module.cache,
+                                      CONFIG_SSL_SESSION_CACHE_MAX);
+#    if defined(MBEDTLS_HAVE_TIME)
+    mbedtls_ssl_cache_set_timeout(&module.cache,
+                                  CONFIG_SSL_SESSION_LIFETIME);
+#    endif
+#endif
+
+#if SESSION_TICKETS == 1
+    mbedtls_ssl_ticket_init(&module.ticket);
+
+    if (mbedtls_ssl_ticket_setup(&module.ticket,
+                                 mbedtls_ctr_drbg_random,
+                                 &module.ctr_drbg,
+                                 MBEDTLS_CIPHER_AES_256_GCM,
+                                 CONFIG_SSL_SESSION_LIFETIME) != 0) {
+        return (-1);
+    }
+#endif
+
+#if CLIENT_SESSIONS == 1
+    for (i = 0; i < membersof(module.client.sessions); i++) {
+        mbedtls_ssl_session_init(&module.client.sessions[i].session);
+        module.client.sessions[i].valid = 0;
+    }
+#endif
+
+    return (0);
+}
+
+int ssl_module_get_memory_usage(struct ssl_memory_usage_t *usage_p)
+{
+    ASSERTN(usage_p != NULL, EINVAL);
+
+    sys_lock();
+    *usage_p = module.memory;
+    sys_unlock();
+
+    return (0);
+}
+
+int ssl_module_reset_memory_peak(void)
+{
+    sys_lock();
+    module.memory.peak = module.memory.current;
+    sys_unlock();
+
     return (0);
 }
 
@@ -148,6 +756,8 @@ int ssl_context_init(struct ssl_context_t *self_p,
 
     self_p->server_side = -1;
     self_p->verify_mode = -1;
+    self_p->session_cache.hits = 0;
+    self_p->session_cache.misses = 0;
 
     return (0);
 }
@@ -244,6 +854,14 @@ int ssl_socket_open(struct ssl_socket_t *self_p,
     int res;
     int authmode;
     int server_side;
+    int resumed;
+#if CLIENT_SESSIONS == 1
+    mbedtls_ssl_session offered;
+    int offered_valid;
+
+    mbedtls_ssl_session_init(&offered);
+    offered_valid = 0;
+#endif
 
     server_side = (flags & SSL_SOCKET_SERVER_SIDE);
     
@@ -265,6 +883,33 @@ int ssl_socket_open(struct ssl_socket_t *self_p,
             mbedtls_ssl_conf_authmode(context_p->conf_p, context_p->verify_mode);
         }
 
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+        /* Ask the server to send records fitting in the record
+           buffers. */
+        if (!server_side && (MAX_FRAG_LEN != MBEDTLS_SSL_MAX_FRAG_LEN_NONE)) {
+            if (mbedtls_ssl_conf_max_frag_len(context_p->conf_p,
+                                              MAX_FRAG_LEN) != 0) {
+                return (-1);
+            }
+        }
+#endif
+
+        /* Session resumption. */
+        if (server_side) {
+#if SESSION_CACHE == 1
+            mbedtls_ssl_conf_session_cache(context_p->conf_p,
+                                           &module.cache,
+                                           session_cache_get,
+                                           mbedtls_ssl_cache_set);
+#endif
+#if SESSION_TICKETS == 1
+            mbedtls_ssl_conf_session_tickets_cb(context_p->conf_p,
+                                                mbedtls_ssl_ticket_write,
+                                                session_ticket_parse,
+                                                &module.ticket);
+#endif
+        }
+
         context_p->server_side = server_side;
     } else if (context_p->server_side != server_side) {
         return (-1);
@@ -287,7 +932,7 @@ int ssl_socket_open(struct ssl_socket_t *self_p,
     /* Inilialize the SSL session. */
     mbedtls_ssl_init(self_p->ssl_p);
 
-    res = mbedtls_ssl_setup(self_p->ssl_p, &module.conf);
+    res = setup(self_p->ssl_p);
 
     if (res != 0) {
         goto err1;
@@ -306,11 +951,26 @@ int ssl_socket_open(struct ssl_socket_t *self_p,
                                          server_hostname_p) != 0) {
                 goto err2;
             }
+
+#if CLIENT_SESSIONS == 1
+            /* Offer the session of the last connection to the
+               server. It is remembered again only if the handshake
+               succeeds. */
+            offered_valid = client_session_take(server_hostname_p,
+                                                &offered);
+
+            if (offered_valid) {
+                if (mbedtls_ssl_set_session(self_p->ssl_p, &offered) != 0) {
+                    mbedtls_ssl_session_free(&offered);
+                    offered_valid = 0;
+                }
+            }
+#endif
         }
     }
-    
+
     /* Perform the handshake with the remote peer. */
-    res = mbedtls_ssl_handshake(self_p->ssl_p);
+    res = handshake(self_p->ssl_p, &resumed);
 
     if (res != 0) {
         goto err2;
@@ -327,9 +987,33 @@ int ssl_socket_open(struct ssl_socket_t *self_p,
         }
     }
 
+#if CLIENT_SESSIONS == 1
+    if ((server_side == 0) && (server_hostname_p != NULL)) {
+        resumed = client_session_save(server_hostname_p,
+                                      self_p->ssl_p,
+                                      offered_valid ? &offered : NULL);
+    }
+
+    if (offered_valid) {
+        mbedtls_ssl_session_free(&offered);
+    }
+#endif
+
+    if (resumed) {
+        context_p->session_cache.hits++;
+    } else {
+        context_p->session_cache.misses++;
+    }
+
     return (0);
 
  err2:
+#if CLIENT_SESSIONS == 1
+    /* A possibly bad offered session is not offered again. */
+    if (offered_valid) {
+        mbedtls_ssl_session_free(&offered);
+    }
+#endif
     mbedtls_ssl_free(self_p->ssl_p);
  err1:
     free_ssl(self_p->ssl_p);
@@ -50,6 +50,24 @@ struct ssl_context_t {
     void *conf_p;
     int server_side;
     int verify_mode;
+    /* Handshakes resuming a previous session (hits), and full
+       handshakes (misses). */
+    struct {
+        uint32_t hits;
+        uint32_t misses;
+    } session_cache;
+};
+
+/**
+ * Memory used by mbedTLS, including the record buffers of open
+ * sockets.
+ */
+struct ssl_memory_usage_t {
+    /* Number of bytes currently in use. */
+    size_t current;
+    /* Maximum number of bytes in use since the module was initialized
+       or the peak was reset. */
+    size_t peak;
 };
 
 struct ssl_socket_t {
@@ -69,6 +87,24 @@ struct ssl_socket_t {
  */
 int ssl_module_init(void);
 
+/**
+ * Get the memory usage of the SSL module. Always zero(0) if mbedTLS
+ * is built without ``MBEDTLS_PLATFORM_MEMORY``.
+ *
+ * @param[out] usage_p Current and peak memory usage.
+ *
+ * @return zero(0) or negative error code.
+ */
+int ssl_module_get_memory_usage(struct ssl_memory_usage_t *usage_p);
+
+/**
+ * Reset the peak memory usage to the current memory usage, for
+ * example to measure the peak memory usage of a single connection.
+ *
+ * @return zero(0) or negative error code.
+ */
+int ssl_module_reset_memory_peak(void);
+
 /**
  * Initialize given SSL context. A SSL context contains settings that
  * lives longer than a socket.
@@ -134,6 +170,20 @@ int ssl_context_set_verify_mode(struct ssl_context_t *self_p,
  * Initialize given SSL socket with given socket and SSL
  * context. Performs the SSL handshake.
  *
+ * Server side sockets resume the sessions of reconnecting clients
+ * from a session cache of ``CONFIG_SSL_SESSION_CACHE_MAX`` entries,
+ * or from a session ticket if ``CONFIG_SSL_SESSION_TICKETS`` is
+ * set. Client side sockets offer the session of the last connection
+ * to the same server hostname, remembering up to
+ * ``CONFIG_SSL_CLIENT_SESSIONS_MAX`` hostnames. Resumed and full
+ * handshakes are counted in the ``session_cache`` member of the
+ * context.
+ *
+ * At most ``CONFIG_SSL_SOCKETS_MAX`` sockets may be open at the same
+ * time. Their connection states and record buffers are allocated
+ * when the module is initialized, so opening a socket does not
+ * allocate the large record buffers on the heap.
+ *
  * @param[out] self_p SSL socket to initialize.
  * @param[in] context_p SSL context to execute in.
  * @param[in] socket_p Socket to wrap in the SSL socket.
@@ -34,6 +34,7 @@
 #define OPCODE_DATA                                        3
 #define OPCODE_ACKNOWLEDGMENT                              4
 #define OPCODE_ERROR                                       5
+#define OPCODE_OPTION_ACKNOWLEDGMENT                       6
 
 /* Error codes. */
 #define ERROR_NOT_DEFINED                                  0
@@ -44,7 +45,13 @@
 #define ERROR_UNKNOWN_TRANSFER_ID                          5
 #define ERROR_FILE_ALREADY_EXISTS                          6
 #define ERROR_NO_SUCH_USER                                 7
-#define ERROR_CODE_MAX                                     8
+#define ERROR_OPTION_NEGOTIATION                           8
+#define ERROR_CODE_MAX                                     9
+
+/* Options. */
+#define OPTION_BLKSIZE                                   0x1
+#define OPTION_TSIZE                                     0x2
+#define OPTION_WINDOWSIZE                                0x4
 
 /* Protocol acces macros. */
 #define OPCODE(buf_p)           ((buf_p[0] << 8) | buf_p[1])
@@ -52,22 +59,14 @@
 #define ERROR_CODE(buf_p)       ((buf_p[2] << 8) | buf_p[3])
 
 /* Sizes. */
-#define DATA_SIZE                                        512
-#define BUFFER_SIZE                          (DATA_SIZE + 4)
+#define BLOCK_SIZE_DEFAULT                               512
+#define BLOCK_SIZE_MIN                                     8
+#define BUFFER_SIZE                  TFTP_SERVER_BUFFER_SIZE
 
-struct client_t {
-    struct tftp_server_t *server_p;
-    struct socket_t socket;
-    uint8_t *buf_p;
-    struct fs_file_t file;
-    const char *filename_p;
-    uint32_t number_of_bytes_transferred;
-    struct {
-        uint16_t block_number;
-        ssize_t size;
-        int retransmit_counter;
-    } data;
-};
+/* Packet handling results. */
+#define PACKET_CONTINUE                                    1
+#define PACKET_DONE                                        0
+#define PACKET_ERROR                                      -1
 
 static const char *error_code_str[ERROR_CODE_MAX + 1] = {
     "not defined",
@@ -78,6 +77,7 @@ static const char *error_code_str[ERROR_CODE_MAX + 1] = {
     "unknown transfer id",
     "file already exists",
     "no such user",
+    "option negotiation failed",
     "invalid error code"
 };
 
@@ -106,22 +106,86 @@ static int find_string(const char **buf_pp,
     return (0);
 }
 
-static int parse_request(const char *buf_p,
-                         size_t size,
+static int parse_request(const char **buf_pp,
+                         size_t *size_p,
                          const char **filename_pp,
                          const char **mode_pp)
 {
-    if (find_string(&buf_p, &size, filename_pp) != 0) {
+    if (find_string(buf_pp, size_p, filename_pp) != 0) {
         return (-1);
     }
 
-    if (find_string(&buf_p, &size, mode_pp) != 0) {
+    if (find_string(buf_pp, size_p, mode_pp) != 0) {
         return (-1);
     }
 
     return (0);
 }
 
+/**
+ * Case insensitive comparison of given option name to given lower
+ * case name.
+ */
+static int is_option(const char *name_p, const char *expected_p)
+{
+    while (*expected_p != '\0') {
+        if (tolower((int)*name_p) != *expected_p) {
+            return (0);
+        }
+
+        name_p++;
+        expected_p++;
+    }
+
+    return (*name_p == '\0');
+}
+
+/**
+ * Parse the options of a request (RFC 2347). Unknown options and
+ * options with bad values are ignored, as the client then uses the
+ * default values.
+ */
+static void parse_options(struct tftp_server_client_t *self_p,
+                          const char *buf_p,
+                          size_t size)
+{
+    const char *name_p;
+    const char *value_p;
+    long value;
+
+    while (find_string(&buf_p, &size, &name_p) == 0) {
+        if (find_string(&buf_p, &size, &value_p) != 0) {
+            break;
+        }
+
+        if (std_strtolb(value_p, &value, 10) == NULL) {
+            continue;
+        }
+
+        if (is_option(name_p, "blksize")) {
+            /* RFC 2348. */
+            if (value >= BLOCK_SIZE_MIN) {
+                self_p->options.block_size =
+                    MIN(value, CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX);
+                self_p->options.requested |= OPTION_BLKSIZE;
+            }
+        } else if (is_option(name_p, "tsize")) {
+            /* RFC 2349. */
+            if (value >= 0) {
+                self_p->options.transfer_size = value;
+                self_p->options.requested |= OPTION_TSIZE;
+            }
+        } else if (is_option(name_p, "windowsize")) {
+            /* RFC 7440. */
+            if ((value >= 1) && (value <= 65535)) {
+                self_p->options.window_size =
+                    MIN(value, CONFIG_TFTP_SERVER_WINDOW_SIZE_MAX);
+                self_p->options.requested |= OPTION_WINDOWSIZE;
+            }
+        }
+    }
+}
+
 static int error_transmit(struct tftp_server_t *server_p,
                           struct inet_addr_t *remote_addr_p,
                           uint8_t *buf_p,
@@ -154,52 +218,134 @@ static int error_transmit(struct tftp_server_t *server_p,
     return (0);
 }
 
-static int client_data_write(struct client_t *self_p)
+static uint8_t *option_format(uint8_t *buf_p,
+                              const char *name_p,
+                              unsigned long value)
+{
+    strcpy((char *)buf_p, name_p);
+    buf_p += (strlen(name_p) + 1);
+    buf_p += (std_sprintf((char *)buf_p, FSTR("%lu"), value) + 1);
+
+    return (buf_p);
+}
+
+/**
+ * Write an option acknowledgement packet with the accepted options.
+ */
+static int client_oack_write(struct tftp_server_client_t *self_p)
 {
+    uint8_t *buf_p;
     size_t size;
 
-    self_p->buf_p[0] = 0;
-    self_p->buf_p[1] = OPCODE_DATA;
-    self_p->buf_p[2] = (self_p->data.block_number >> 8);
-    self_p->buf_p[3] = self_p->data.block_number;
-    size = 4;
+    self_p->buf[0] = 0;
+    self_p->buf[1] = OPCODE_OPTION_ACKNOWLEDGMENT;
+    buf_p = &self_p->buf[2];
 
-    self_p->data.size = fs_read(&self_p->file,
-                                &self_p->buf_p[4],
-                                DATA_SIZE);
+    if (self_p->options.requested & OPTION_BLKSIZE) {
+        buf_p = option_format(buf_p,
+                              "blksize",
+                              self_p->options.block_size);
+    }
+
+    if (self_p->options.requested & OPTION_TSIZE) {
+        buf_p = option_format(buf_p,
+                              "tsize",
+                              self_p->options.transfer_size);
+    }
 
-    if (self_p->data.size < 0) {
-        self_p->data.size = 0;
+    if (self_p->options.requested & OPTION_WINDOWSIZE) {
+        buf_p = option_format(buf_p,
+                              "windowsize",
+                              self_p->options.window_size);
     }
 
-    size += self_p->data.size;
+    size = (buf_p - &self_p->buf[0]);
 
-    if (socket_write(&self_p->socket, self_p->buf_p, size) != size) {
+    if (socket_write(&self_p->socket, self_p->buf, size) != size) {
         return (-1);
     }
 
     return (0);
 }
 
-static int client_data_transmit(struct client_t *self_p)
+/**
+ * Write a window of data packets, starting at the first
+ * unacknowledged block.
+ */
+static int client_data_write(struct tftp_server_client_t *self_p)
+{
+    uint16_t block_number;
+    ssize_t size;
+
+    /* Rewind to the first unacknowledged block when
+       retransmitting. */
+    if (self_p->data.position != self_p->data.offset) {
+        if (fs_seek(&self_p->file,
+                    self_p->data.offset,
+                    FS_SEEK_SET) != 0) {
+            return (-1);
+        }
+
+        self_p->data.position = self_p->data.offset;
+    }
+
+    self_p->data.number_of_blocks = 0;
+    self_p->data.last = 0;
+
+    while (self_p->data.number_of_blocks < self_p->options.window_size) {
+        block_number = (self_p->data.block_number
+                        + self_p->data.number_of_blocks);
+        self_p->buf[0] = 0;
+        self_p->buf[1] = OPCODE_DATA;
+        self_p->buf[2] = (block_number >> 8);
+        self_p->buf[3] = block_number;
+
+        size = fs_read(&self_p->file,
+                       &self_p->buf[4],
+                       self_p->options.block_size);
+
+        if (size < 0) {
+            size = 0;
+        }
+
+        self_p->data.position += size;
+        self_p->data.number_of_blocks++;
+
+        if (socket_write(&self_p->socket,
+                         self_p->buf,
+                         size + 4) != size + 4) {
+            return (-1);
+        }
+
+        /* The last block is not full. */
+        if (size < self_p->options.block_size) {
+            self_p->data.last = 1;
+            break;
+        }
+    }
+
+    return (0);
+}
+
+static int client_data_transmit(struct tftp_server_client_t *self_p)
 {
     self_p->data.retransmit_counter = 0;
 
     return (client_data_write(self_p));
 }
 
-static int client_data_retransmit(struct client_t *self_p)
+static int client_data_retransmit(struct tftp_server_client_t *self_p)
 {
-    if (fs_seek(&self_p->file, -self_p->data.size, FS_SEEK_CUR) != 0) {
-        return (-1);
-    }
-
     self_p->data.retransmit_counter++;
 
+    if (self_p->options.pending) {
+        return (client_oack_write(self_p));
+    }
+
     return (client_data_write(self_p));
 }
 
-static int client_ack_write(struct client_t *self_p)
+static int client_ack_write(struct tftp_server_client_t *self_p)
 {
     uint16_t block_number;
 
@@ -207,278 +353,378 @@ static int client_ack_write(struct client_t *self_p)
        receive. */
     block_number = (self_p->data.block_number - 1);
 
-    self_p->buf_p[0] = 0;
-    self_p->buf_p[1] = OPCODE_ACKNOWLEDGMENT;
-    self_p->buf_p[2] = (block_number >> 8);
-    self_p->buf_p[3] = block_number;
+    self_p->buf[0] = 0;
+    self_p->buf[1] = OPCODE_ACKNOWLEDGMENT;
+    self_p->buf[2] = (block_number >> 8);
+    self_p->buf[3] = block_number;
 
-    if (socket_write(&self_p->socket, self_p->buf_p, 4) != 4) {
+    if (socket_write(&self_p->socket, self_p->buf, 4) != 4) {
         return (-1);
     }
 
     return (0);
 }
 
-static int client_ack_transmit(struct client_t *self_p)
+static int client_ack_transmit(struct tftp_server_client_t *self_p)
 {
     self_p->data.retransmit_counter = 0;
 
     return (client_ack_write(self_p));
 }
 
-static int client_ack_retransmit(struct client_t *self_p)
+static int client_ack_retransmit(struct tftp_server_client_t *self_p)
 {
     self_p->data.retransmit_counter++;
+    self_p->data.number_of_blocks = 0;
+
+    if (self_p->options.pending) {
+        return (client_oack_write(self_p));
+    }
 
     return (client_ack_write(self_p));
 }
 
-static int client_error_transmit(struct client_t *self_p,
+static int client_error_transmit(struct tftp_server_client_t *self_p,
                                  uint16_t error)
 {
     size_t size;
 
-    self_p->buf_p[0] = 0;
-    self_p->buf_p[1] = OPCODE_ERROR;
-    self_p->buf_p[2] = (error >> 8);
-    self_p->buf_p[3] = error;
+    self_p->buf[0] = 0;
+    self_p->buf[1] = OPCODE_ERROR;
+    self_p->buf[2] = (error >> 8);
+    self_p->buf[3] = error;
     size = 4;
 
-    strcpy((char *)&self_p->buf_p[4], error_code_str[error]);
+    strcpy((char *)&self_p->buf[4], error_code_str[error]);
     size += (strlen(error_code_str[error]) + 1);
 
-    if (socket_write(&self_p->socket, &self_p->buf_p[0], size) != size) {
+    if (socket_write(&self_p->socket, &self_p->buf[0], size) != size) {
         return (-1);
     }
 
     return (0);
 }
 
-static int client_read_request_transfer_data(struct client_t *self_p)
+/**
+ * Handle an acknowledgement or error packet of a read request.
+ */
+static int client_read_request_handle_packet(struct tftp_server_client_t *self_p,
+                                             ssize_t size)
 {
     int opcode;
     uint16_t block_number;
+    uint16_t number_of_blocks;
     uint16_t error_code;
-    struct time_t timeout;
-    ssize_t size;
-
-    timeout.seconds = (self_p->server_p->timeout_ms / 1000);
-    timeout.nanoseconds = 1000000L * (self_p->server_p->timeout_ms % 1000);
 
-    if (client_data_transmit(self_p) != 0) {
-        return (-1);
+    /* Acknowlegement and error packets are at least 4 bytes. */
+    if (size < 4) {
+        return (PACKET_ERROR);
     }
 
-    while (1) {
-        /* Waiting for acknowlegement or error. Retransmit outstanding
-           data packet on timeout, or bail. */
-        if (chan_poll(&self_p->socket, &timeout) == NULL) {
-            if (self_p->data.retransmit_counter == 2) {
-                return (-1);
-            }
+    opcode = OPCODE(self_p->buf);
 
-            if (client_data_retransmit(self_p) != 0) {
-                return (-1);
-            }
+    switch (opcode) {
 
-            continue;
-        }
+    case OPCODE_ACKNOWLEDGMENT:
+        block_number = BLOCK_NUMBER(self_p->buf);
 
-        /* Read the incoming packet. */
-        size = socket_read(&self_p->socket, self_p->buf_p, BUFFER_SIZE);
+        /* Block zero acknowledges the options. */
+        if (self_p->options.pending) {
+            if (block_number != 0) {
+                return (PACKET_CONTINUE);
+            }
 
-        /* Acknowlegement and error packets are at least 4 bytes. */
-        if (size < 4) {
-            return (-1);
-        }
+            self_p->options.pending = 0;
 
-        opcode = OPCODE(self_p->buf_p);
+            if (client_data_transmit(self_p) != 0) {
+                return (PACKET_ERROR);
+            }
 
-        switch (opcode) {
+            return (PACKET_CONTINUE);
+        }
 
-        case OPCODE_ACKNOWLEDGMENT:
-            block_number = BLOCK_NUMBER(self_p->buf_p);
+        /* Number of acknowledged blocks in the window. Fewer than
+           sent if the client missed a block. */
+        number_of_blocks = (uint16_t)(block_number
+                                      - self_p->data.block_number
+                                      + 1);
 
-            /* Ignore bad acknowlegement packets. */
-            if (block_number != self_p->data.block_number) {
-                log_object_print(NULL,
-                                 LOG_DEBUG,
-                                 OSTR("ignoring block number %u when"
-                                      " expecting %u\r\n"),
-                                 block_number,
-                                 self_p->data.block_number);
-                continue;
-            }
+        /* Ignore bad acknowlegement packets. */
+        if ((number_of_blocks == 0)
+            || (number_of_blocks > self_p->data.number_of_blocks)) {
+            log_object_print(NULL,
+                             LOG_DEBUG,
+                             OSTR("ignoring block number %u when"
+                                  " expecting %u\r\n"),
+                             block_number,
+                             (uint16_t)(self_p->data.block_number
+                                        + self_p->data.number_of_blocks
+                                        - 1));
+            return (PACKET_CONTINUE);
+        }
 
-            self_p->number_of_bytes_transferred += self_p->data.size;
+        /* The last block is acknowledged. */
+        if (self_p->data.last
+            && (number_of_blocks == self_p->data.number_of_blocks)) {
+            self_p->number_of_bytes_transferred = self_p->data.position;
+            log_object_print(NULL,
+                             LOG_INFO,
+                             OSTR("sent %lu bytes\r\n"),
+                             (unsigned long)self_p->number_of_bytes_transferred);
+            return (PACKET_DONE);
+        }
 
-            /* The last packet is not full. */
-            if (self_p->data.size < DATA_SIZE) {
-                log_object_print(NULL,
-                                 LOG_INFO,
-                                 OSTR("sent %u bytes\r\n"),
-                                 self_p->number_of_bytes_transferred);
-                return (0);
-            }
+        /* Transmit the next window, starting after the last
+           acknowleged block. */
+        self_p->data.block_number += number_of_blocks;
+        self_p->data.offset += (number_of_blocks
+                                * self_p->options.block_size);
 
-            /* The block has been acknowleged. Increment the block
-               number for the next block. */
-            self_p->data.block_number++;
+        if (client_data_transmit(self_p) != 0) {
+            return (PACKET_ERROR);
+        }
 
-            /* Transmit next data packet. */
-            if (client_data_transmit(self_p) != 0) {
-                return (-1);
-            }
-            break;
+        return (PACKET_CONTINUE);
 
-        case OPCODE_ERROR:
-            error_code = ERROR_CODE(self_p->buf_p);
+    case OPCODE_ERROR:
+        error_code = ERROR_CODE(self_p->buf);
 
-            if (error_code > ERROR_CODE_MAX) {
-                error_code = ERROR_CODE_MAX;
-            }
+        if (error_code > ERROR_CODE_MAX) {
+            error_code = ERROR_CODE_MAX;
+        }
 
-            log_object_print(NULL,
-                             LOG_ERROR,
-                             OSTR("error code %u: %s\r\n"),
-                             error_code,
-                             error_code_str[error_code]);
-            return (-1);
+        log_object_print(NULL,
+                         LOG_ERROR,
+                         OSTR("error code %u: %s\r\n"),
+                         error_code,
+                         error_code_str[error_code]);
+        return (PACKET_ERROR);
 
-        default:
-            log_object_print(NULL,
-                             LOG_ERROR,
-                             OSTR("bad opcode %u\r\n"),
-                             opcode);
-            return (-1);
-        }
+    default:
+        log_object_print(NULL,
+                         LOG_ERROR,
+                         OSTR("bad opcode %u\r\n"),
+                         opcode);
+        return (PACKET_ERROR);
     }
-
-    return (0);
 }
 
-static int client_write_request_transfer_data(struct client_t *self_p)
+/**
+ * Handle a data or error packet of a write request.
+ */
+static int client_write_request_handle_packet(struct tftp_server_client_t *self_p,
+                                              ssize_t size)
 {
     int opcode;
     uint16_t block_number;
     int error_code;
-    struct time_t timeout;
-    ssize_t size;
 
-    timeout.seconds = (self_p->server_p->timeout_ms / 1000);
-    timeout.nanoseconds = 1000000L * (self_p->server_p->timeout_ms % 1000);
-
-    if (client_ack_transmit(self_p) != 0) {
-        return (-1);
+    /* Data and error packets are at least 4 bytes. */
+    if (size < 4) {
+        return (PACKET_ERROR);
     }
 
-    while (1) {
-        /* Waiting for data or error. Retransmit the ack packet on
-           timeout, or bail. */
-        if (chan_poll(&self_p->socket, &timeout) == NULL) {
-            if (self_p->data.retransmit_counter == 2) {
-                return (-1);
+    size -= 4;
+
+    opcode = OPCODE(self_p->buf);
+
+    switch (opcode) {
+
+    case OPCODE_DATA:
+        block_number = BLOCK_NUMBER(self_p->buf);
+
+        /* Ignore bad data packets. */
+        if (block_number != self_p->data.block_number) {
+            log_object_print(NULL,
+                             LOG_INFO,
+                             OSTR("ignoring block number %u when"
+                                  " expecting %u\r\n"),
+                             block_number,
+                             self_p->data.block_number);
+
+            /* Acknowledge the last received block once to make the
+               client restart the window after it. */
+            if ((self_p->options.window_size > 1)
+                && !self_p->data.last
+                && !self_p->options.pending) {
+                self_p->data.last = 1;
+                self_p->data.number_of_blocks = 0;
+
+                if (client_ack_transmit(self_p) != 0) {
+                    return (PACKET_ERROR);
+                }
             }
 
-            if (client_ack_retransmit(self_p) != 0) {
-                return (-1);
+            return (PACKET_CONTINUE);
+        }
+
+        if (fs_write(&self_p->file, &self_p->buf[4], size) != size) {
+            return (PACKET_ERROR);
+        }
+
+        self_p->options.pending = 0;
+        self_p->data.last = 0;
+        self_p->data.block_number++;
+        self_p->data.number_of_blocks++;
+        self_p->number_of_bytes_transferred += size;
+
+        /* The last packet is not full. */
+        if (size < self_p->options.block_size) {
+            if (client_ack_transmit(self_p) != 0) {
+                return (PACKET_ERROR);
             }
 
-            continue;
+            log_object_print(NULL,
+                             LOG_INFO,
+                             OSTR("received %lu bytes\r\n"),
+                             (unsigned long)self_p->number_of_bytes_transferred);
+            return (PACKET_DONE);
         }
 
-        /* Read the incoming packet. */
-        size = socket_read(&self_p->socket, self_p->buf_p, BUFFER_SIZE);
+        /* Acknowledge a full window. */
+        if (self_p->data.number_of_blocks == self_p->options.window_size) {
+            self_p->data.number_of_blocks = 0;
 
-        /* Data and error packets are at least 4 bytes. */
-        if (size < 4) {
-            return (-1);
+            if (client_ack_transmit(self_p) != 0) {
+                return (PACKET_ERROR);
+            }
         }
 
-        size -= 4;
+        return (PACKET_CONTINUE);
 
-        opcode = OPCODE(self_p->buf_p);
+    case OPCODE_ERROR:
+        error_code = ERROR_CODE(self_p->buf);
 
-        switch (opcode) {
+        if (error_code > ERROR_CODE_MAX) {
+            error_code = ERROR_CODE_MAX;
+        }
 
-        case OPCODE_DATA:
-            block_number = BLOCK_NUMBER(self_p->buf_p);
+        log_object_print(NULL,
+                         LOG_ERROR,
+                         OSTR("error code %u: %s\r\n"),
+                         error_code,
+                         error_code_str[error_code]);
+        return (PACKET_ERROR);
 
-            /* Ignore bad data packets. */
-            if (block_number != self_p->data.block_number) {
-                log_object_print(NULL,
-                                 LOG_INFO,
-                                 OSTR("ignoring block number %u when"
-                                      " expecting %u\r\n"),
-                                 block_number,
-                                 self_p->data.block_number);
-                continue;
-            }
+    default:
+        log_object_print(NULL,
+                         LOG_ERROR,
+                         OSTR("bad opcode %u\r\n"),
+                         opcode);
+        return (PACKET_ERROR);
+    }
+}
 
-            if (fs_write(&self_p->file, &self_p->buf_p[4], size) != size) {
-                return (-1);
-            }
+static int client_transmit(struct tftp_server_client_t *self_p)
+{
+    /* Acknowledge the options before the transfer starts. */
+    if (self_p->options.requested != 0) {
+        self_p->options.pending = 1;
+        self_p->data.retransmit_counter = 0;
 
-            self_p->data.block_number++;
+        return (client_oack_write(self_p));
+    }
 
-            /* Transmit ack packet. */
-            if (client_ack_transmit(self_p) != 0) {
-                return (-1);
-            }
+    if (self_p->opcode == OPCODE_READ_REQUEST) {
+        return (client_data_transmit(self_p));
+    } else {
+        return (client_ack_transmit(self_p));
+    }
+}
+
+static int client_retransmit(struct tftp_server_client_t *self_p)
+{
+    if (self_p->opcode == OPCODE_READ_REQUEST) {
+        return (client_data_retransmit(self_p));
+    } else {
+        return (client_ack_retransmit(self_p));
+    }
+}
+
+static int client_handle_packet(struct tftp_server_client_t *self_p)
+{
+    ssize_t size;
 
-            self_p->number_of_bytes_transferred += size;
+    /* Read the incoming packet. */
+    size = socket_read(&self_p->socket, self_p->buf, BUFFER_SIZE);
 
-            /* The last packet is not full. */
-            if (size < DATA_SIZE) {
-                log_object_print(NULL,
-                                 LOG_INFO,
-                                 OSTR("received %u bytes\r\n"),
-                                 self_p->number_of_bytes_transferred);
-                return (0);
-            }
-            break;
+    if (self_p->opcode == OPCODE_READ_REQUEST) {
+        return (client_read_request_handle_packet(self_p, size));
+    } else {
+        return (client_write_request_handle_packet(self_p, size));
+    }
+}
+
+static int client_close(struct tftp_server_client_t *self_p)
+{
+    (void)fs_close(&self_p->file);
+    socket_close(&self_p->socket);
 
-        case OPCODE_ERROR:
-            error_code = ERROR_CODE(self_p->buf_p);
+    return (0);
+}
+
+/**
+ * The client task. Transfers data packets of a read request, or
+ * acknowledges data packets of a write request, retransmitting the
+ * last packet on timeout.
+ */
+static int client_main(struct task_t *task_p)
+{
+    struct tftp_server_client_t *self_p;
+
+    self_p = task_p->arg_p;
+
+    TASK_BEGIN(task_p);
+
+    if (client_transmit(self_p) != 0) {
+        goto out;
+    }
+
+    while (1) {
+        /* Waiting for a packet. Retransmit the outstanding packet on
+           timeout, or bail. */
+        TASK_AWAIT_CHAN(task_p, &self_p->socket, &self_p->server_p->timeout);
 
-            if (error_code > ERROR_CODE_MAX) {
-                error_code = ERROR_CODE_MAX;
+        if (task_p->res == -ETIMEDOUT) {
+            if (self_p->data.retransmit_counter == 2) {
+                break;
             }
 
-            log_object_print(NULL,
-                             LOG_ERROR,
-                             OSTR("error code %u: %s\r\n"),
-                             error_code,
-                             error_code_str[error_code]);
-            return (-1);
+            if (client_retransmit(self_p) != 0) {
+                break;
+            }
 
-        default:
-            log_object_print(NULL,
-                             LOG_ERROR,
-                             OSTR("bad opcode %u\r\n"),
-                             opcode);
-            return (-1);
+            continue;
+        }
+
+        if (client_handle_packet(self_p) != PACKET_CONTINUE) {
+            break;
         }
     }
 
-    return (0);
+ out:
+    client_close(self_p);
+
+    TASK_END(task_p);
 }
 
-static int client_open(struct client_t *self_p,
+static int client_open(struct tftp_server_client_t *self_p,
                        struct tftp_server_t *server_p,
-                       uint8_t *buf_p,
                        size_t size,
                        struct inet_addr_t *remote_addr_p)
 {
+    const char *buf_p;
+    const char *filename_p;
     const char *mode_p;
     const char *error_message_p;
+    struct fs_stat_t stat;
+    int flags;
 
     error_message_p = NULL;
+    buf_p = (const char *)&self_p->buf[2];
+    size -= 2;
 
-    if (parse_request((const char *)&buf_p[2],
-                      size - 2,
-                      &self_p->filename_p,
-                      &mode_p) != 0) {
+    if (parse_request(&buf_p, &size, &filename_p, &mode_p) != 0) {
         error_message_p = "malformed request";
         goto err;
     }
@@ -488,17 +734,59 @@ static int client_open(struct client_t *self_p,
         goto err;
     }
 
+    self_p->options.requested = 0;
+    self_p->options.pending = 0;
+    self_p->options.block_size = BLOCK_SIZE_DEFAULT;
+    self_p->options.window_size = 1;
+    self_p->options.transfer_size = 0;
+    parse_options(self_p, buf_p, size);
+
     if (socket_open_udp(&self_p->socket) != 0) {
         goto err;
     }
 
     if (socket_connect(&self_p->socket, remote_addr_p) != 0) {
-        goto err;
+        goto err_connect;
     }
 
-    self_p->buf_p = buf_p;
+    if (self_p->opcode == OPCODE_READ_REQUEST) {
+        flags = FS_READ;
+    } else {
+        flags = (FS_WRITE | FS_CREAT | FS_TRUNC);
+    }
+
+    if (fs_open(&self_p->file, filename_p, flags) != 0) {
+        if (self_p->opcode == OPCODE_READ_REQUEST) {
+            (void)client_error_transmit(self_p, ERROR_FILE_NOT_FOUND);
+        }
+
+        goto err_connect;
+    }
+
+    /* The transfer size of a read request is the file size. */
+    if ((self_p->opcode == OPCODE_READ_REQUEST)
+        && (self_p->options.requested & OPTION_TSIZE)) {
+        if (fs_stat(filename_p, &stat) == 0) {
+            self_p->options.transfer_size = stat.size;
+        } else {
+            self_p->options.requested &= ~OPTION_TSIZE;
+        }
+    }
+
+    log_object_print(NULL,
+                     LOG_INFO,
+                     OSTR("%s '%s'\r\n"),
+                     (self_p->opcode == OPCODE_READ_REQUEST
+                      ? "reading from"
+                      : "writing to"),
+                     filename_p);
+
     self_p->number_of_bytes_transferred = 0;
     self_p->data.block_number = 1;
+    self_p->data.number_of_blocks = 0;
+    self_p->data.last = 0;
+    self_p->data.offset = 0;
+    self_p->data.position = 0;
     self_p->server_p = server_p;
 
     return (0);
@@ -506,137 +794,119 @@ static int client_open(struct client_t *self_p,
  err:
     error_transmit(server_p,
                    remote_addr_p,
-                   buf_p,
+                   self_p->buf,
                    ERROR_NOT_DEFINED,
                    error_message_p);
 
     return (-1);
-}
 
-static int client_close(struct client_t *self_p)
-{
+ err_connect:
     socket_close(&self_p->socket);
 
-    return (0);
+    return (-1);
 }
 
-static int handle_read_request(struct tftp_server_t *self_p,
-                               uint8_t *buf_p,
-                               size_t size,
-                               struct inet_addr_t *remote_addr_p)
+/**
+ * Returns a client that is not serving a request, or NULL if all
+ * clients are busy.
+ */
+static struct tftp_server_client_t *client_alloc(struct tftp_server_t *self_p)
 {
-    int res;
-    struct client_t client;
+    int i;
 
-    res = -1;
-
-    if (client_open(&client, self_p, buf_p, size, remote_addr_p) == 0) {
-        if (fs_open(&client.file, client.filename_p, FS_READ) == 0) {
-            log_object_print(NULL,
-                             LOG_INFO,
-                             OSTR("reading from '%s'\r\n"),
-                             client.filename_p);
-            res = client_read_request_transfer_data(&client);
-            (void)fs_close(&client.file);
-        } else {
-            res = client_error_transmit(&client, ERROR_FILE_NOT_FOUND);
+    for (i = 0; i < membersof(self_p->clients); i++) {
+        if (task_is_done(&self_p->clients[i].task)) {
+            return (&self_p->clients[i]);
         }
-
-        client_close(&client);
     }
 
-    return (res);
+    return (NULL);
 }
 
-static int handle_write_request(struct tftp_server_t *self_p,
-                                uint8_t *buf_p,
-                                size_t size,
-                                struct inet_addr_t *remote_addr_p)
+/**
+ * Reject a request when all clients are busy.
+ */
+static int reject_request(struct tftp_server_t *self_p)
 {
-    int res;
-    struct client_t client;
-
-    res = -1;
-
-    if (client_open(&client, self_p, buf_p, size, remote_addr_p) == 0) {
-        if (fs_open(&client.file,
-                    client.filename_p,
-                    FS_WRITE | FS_CREAT | FS_TRUNC) == 0) {
-            log_object_print(NULL,
-                             LOG_INFO,
-                             OSTR("writing to '%s'\r\n"),
-                             client.filename_p);
-            res = client_write_request_transfer_data(&client);
-            (void)fs_close(&client.file);
-        }
+    uint8_t buf[32];
+    struct inet_addr_t addr;
 
-        client_close(&client);
+    if (socket_recvfrom(&self_p->listener,
+                        &buf[0],
+                        sizeof(buf),
+                        0,
+                        &addr) < 0) {
+        return (-1);
     }
 
-    return (res);
+    log_object_print(NULL,
+                     LOG_INFO,
+                     OSTR("too many clients\r\n"));
+
+    return (error_transmit(self_p,
+                           &addr,
+                           &buf[0],
+                           ERROR_NOT_DEFINED,
+                           "too many clients"));
 }
 
 static int handle_request(struct tftp_server_t *self_p,
-                          uint8_t *buf_p,
+                          struct tftp_server_client_t *client_p,
                           ssize_t size,
                           struct inet_addr_t *remote_addr_p)
 {
-    int opcode;
-    int res;
-
     if (size < 2) {
         return (-1);
     }
 
-    opcode = OPCODE(buf_p);
+    client_p->opcode = OPCODE(client_p->buf);
 
-    switch (opcode) {
+    switch (client_p->opcode) {
 
     case OPCODE_READ_REQUEST:
-        res = handle_read_request(self_p, buf_p, size, remote_addr_p);
-        break;
-
     case OPCODE_WRITE_REQUEST:
-        res = handle_write_request(self_p, buf_p, size, remote_addr_p);
-        break;
+        if (client_open(client_p, self_p, size, remote_addr_p) != 0) {
+            return (-1);
+        }
+
+        return (task_spawn(&client_p->task, &self_p->executor));
 
     default:
         log_object_print(NULL,
                          LOG_INFO,
                          OSTR("bad opcode %u\r\n"),
-                         opcode);
-        res = -1;
-        break;
+                         client_p->opcode);
+        return (-1);
     }
-
-    return (res);
 }
 
-static void *tftp_server_main(void *arg_p)
+/**
+ * The listener task. Spawns a client task per request.
+ */
+static int listener_main(struct task_t *task_p)
 {
     struct tftp_server_t *self_p;
-    uint8_t buf[BUFFER_SIZE];
+    struct tftp_server_client_t *client_p;
     struct inet_addr_t addr;
     ssize_t size;
     char addrbuf[16];
-    struct thrd_environment_variable_t env[1];
 
-    self_p = arg_p;
+    self_p = task_p->arg_p;
 
-    thrd_set_name(self_p->name_p);
+    TASK_BEGIN(task_p);
 
     /* Set current working directory if given. */
     if (self_p->root_p != NULL) {
-        thrd_init_env(&env[0], membersof(env));
+        thrd_init_env(&self_p->env[0], membersof(self_p->env));
         (void)thrd_set_env("CWD", self_p->root_p);
     }
 
     if (socket_open_udp(&self_p->listener) != 0) {
-        return (NULL);
+        return (TASK_DONE);
     }
 
     if (socket_bind(&self_p->listener, &self_p->addr) != 0) {
-        return (NULL);
+        return (TASK_DONE);
     }
 
     log_object_print(NULL,
@@ -647,9 +917,18 @@ static void *tftp_server_main(void *arg_p)
 
     /* Wait for a client. */
     while (1) {
+        TASK_AWAIT_CHAN(task_p, &self_p->listener, NULL);
+
+        client_p = client_alloc(self_p);
+
+        if (client_p == NULL) {
+            (void)reject_request(self_p);
+            continue;
+        }
+
         size = socket_recvfrom(&self_p->listener,
-                               &buf[0],
-                               sizeof(buf) - 1,
+                               &client_p->buf[0],
+                               sizeof(client_p->buf) - 1,
                                0,
                                &addr);
 
@@ -662,11 +941,11 @@ static void *tftp_server_main(void *arg_p)
                          OSTR("connection from %s:%u\r\n"),
                          inet_ntoa(&addr.ip, &addrbuf[0]),
                          addr.port);
-        buf[size] = '\0';
-        handle_request(self_p, &buf[0], size + 1, &addr);
+        client_p->buf[size] = '\0';
+        (void)handle_request(self_p, client_p, size + 1, &addr);
     }
 
-    return (NULL);
+    TASK_END(task_p);
 }
 
 int tftp_server_init(struct tftp_server_t *self_p,
@@ -682,25 +961,42 @@ int tftp_server_init(struct tftp_server_t *self_p,
     ASSERTN(name_p != NULL, EINVAL);
     ASSERTN(stack_p != NULL, EINVAL);
 
+    int i;
+
     self_p->addr = *addr_p;
-    self_p->timeout_ms = timeout_ms;
-    self_p->name_p = name_p;
+    self_p->timeout.seconds = (timeout_ms / 1000);
+    self_p->timeout.nanoseconds = 1000000L * (timeout_ms % 1000);
     self_p->root_p = root_p;
-    self_p->stack_p = stack_p;
-    self_p->stack_size = stack_size;
+    self_p->thrd_p = NULL;
 
-    return (0);
+    for (i = 0; i < membersof(self_p->clients); i++) {
+        task_init(&self_p->clients[i].task, client_main, &self_p->clients[i]);
+    }
+
+    task_init(&self_p->listener_task, listener_main, self_p);
+
+    return (task_executor_init(&self_p->executor,
+                               &self_p->elements[0],
+                               membersof(self_p->elements),
+                               name_p,
+                               0,
+                               stack_p,
+                               stack_size));
 }
 
 int tftp_server_start(struct tftp_server_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    self_p->thrd_p = thrd_spawn(tftp_server_main,
-                                self_p,
-                                0,
-                                self_p->stack_p,
-                                self_p->stack_size);
+    if (task_spawn(&self_p->listener_task, &self_p->executor) != 0) {
+        return (-1);
+    }
+
+    if (task_executor_start(&self_p->executor) != 0) {
+        return (-1);
+    }
 
-    return (self_p->thrd_p != NULL ? 0 : -1);
+    self_p->thrd_p = self_p->executor.thrd_p;
+
+    return (0);
 }
@@ -31,19 +31,62 @@
 
 #include "simba.h"
 
+/* Size of the packet buffer of a client. */
+#define TFTP_SERVER_BUFFER_SIZE    (CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX + 4)
+
+/**
+ * A client is served by a stackless task on the server thread,
+ * instead of by a thread of its own.
+ */
+struct tftp_server_client_t {
+    struct tftp_server_t *server_p;
+    struct task_t task;
+    struct socket_t socket;
+    struct fs_file_t file;
+    int opcode;
+    uint32_t number_of_bytes_transferred;
+    /* Negotiated options. */
+    struct {
+        int requested;
+        int pending;
+        size_t block_size;
+        uint16_t window_size;
+        uint32_t transfer_size;
+    } options;
+    /* Read requests: the window of transmitted blocks, starting at
+       the first unacknowledged block. Write requests: the next
+       expected block. */
+    struct {
+        uint16_t block_number;
+        uint16_t number_of_blocks;
+        /* Last block sent (read), or out of order block
+           acknowledged (write). */
+        int last;
+        uint32_t offset;
+        uint32_t position;
+        int retransmit_counter;
+    } data;
+    uint8_t buf[TFTP_SERVER_BUFFER_SIZE];
+};
+
 struct tftp_server_t {
     struct inet_addr_t addr;
     struct socket_t listener;
-    int timeout_ms;
-    const char *name_p;
+    struct time_t timeout;
     const char *root_p;
-    void *stack_p;
-    size_t stack_size;
     struct thrd_t *thrd_p;
+    struct thrd_environment_variable_t env[1];
+    struct task_executor_t executor;
+    struct chan_list_elem_t elements[CONFIG_TFTP_SERVER_CLIENTS_MAX + 2];
+    struct task_t listener_task;
+    struct tftp_server_client_t clients[CONFIG_TFTP_SERVER_CLIENTS_MAX];
 };
 
 /**
- * Initialize given TFTP server.
+ * Initialize given TFTP server. Up to
+ * ``CONFIG_TFTP_SERVER_CLIENTS_MAX`` clients are served concurrently
+ * by the server thread, and further requests are rejected with an
+ * error packet.
  *
  * @param[in, out] self_p TFTP server to initialize.
  * @param[in] addr_p Ip address and port of the server.
@@ -141,6 +141,10 @@ static void thrd_port_on_suspend_timer_expired(struct thrd_t *thrd_p)
 {
 }
 
+static void thrd_port_on_resume(struct thrd_t *thrd_p)
+{
+}
+
 static void thrd_port_tick(void)
 {
 }
@@ -0,0 +1,140 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include <sched.h>
+
+static __thread struct thrd_pool_worker_t *current_worker_p = NULL;
+
+static void worker_main(struct thrd_pool_worker_t *self_p);
+
+static void *thrd_pool_port_worker_main(void *arg_p)
+{
+    current_worker_p = arg_p;
+    worker_main(arg_p);
+
+    return (NULL);
+}
+
+static int thrd_pool_port_init(struct thrd_pool_t *self_p)
+{
+    pthread_mutex_init(&self_p->port.mutex, NULL);
+    pthread_cond_init(&self_p->port.cond, NULL);
+    self_p->port.sleepers = 0;
+
+    return (0);
+}
+
+static int thrd_pool_port_start_worker(struct thrd_pool_worker_t *worker_p,
+                                       int prio,
+                                       void *stack_p,
+                                       size_t stack_size)
+{
+    if (pthread_create(&worker_p->port.thread,
+                       NULL,
+                       thrd_pool_port_worker_main,
+                       worker_p) != 0) {
+        return (-ENOMEM);
+    }
+
+    return (0);
+}
+
+static void thrd_pool_port_worker_stopped(struct thrd_pool_worker_t *worker_p)
+{
+}
+
+static int thrd_pool_port_join_worker(struct thrd_pool_worker_t *worker_p)
+{
+    pthread_join(worker_p->port.thread, NULL);
+
+    return (0);
+}
+
+static struct thrd_pool_worker_t *thrd_pool_port_get_current_worker(
+    struct thrd_pool_t *self_p)
+{
+    if ((current_worker_p != NULL) && (current_worker_p->pool_p == self_p)) {
+        return (current_worker_p);
+    }
+
+    return (NULL);
+}
+
+static void thrd_pool_port_deque_lock(struct thrd_pool_worker_t *worker_p)
+{
+    while (ATOMIC_EXCHANGE(&worker_p->deque.lock, 1) != 0) {
+        sched_yield();
+    }
+}
+
+static void thrd_pool_port_deque_unlock(struct thrd_pool_worker_t *worker_p)
+{
+    ATOMIC_STORE(&worker_p->deque.lock, 0);
+}
+
+static void thrd_pool_port_wait(struct thrd_pool_t *self_p,
+                                struct thrd_pool_worker_t *worker_p)
+{
+    pthread_mutex_lock(&self_p->port.mutex);
+    ATOMIC_ADD(&self_p->port.sleepers, 1);
+    ATOMIC_FENCE();
+
+    while ((ATOMIC_LOAD(&self_p->pending) == 0)
+           && (ATOMIC_LOAD(&self_p->stopping) == 0)) {
+        pthread_cond_wait(&self_p->port.cond, &self_p->port.mutex);
+    }
+
+    ATOMIC_ADD(&self_p->port.sleepers, -1);
+    pthread_mutex_unlock(&self_p->port.mutex);
+}
+
+static void thrd_pool_port_notify(struct thrd_pool_t *self_p)
+{
+    /* Pairs with the fence in thrd_pool_port_wait(). */
+    ATOMIC_FENCE();
+
+    if (ATOMIC_LOAD(&self_p->port.sleepers) == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&self_p->port.mutex);
+    pthread_cond_signal(&self_p->port.cond);
+    pthread_mutex_unlock(&self_p->port.mutex);
+}
+
+static void thrd_pool_port_notify_all(struct thrd_pool_t *self_p)
+{
+    pthread_mutex_lock(&self_p->port.mutex);
+    pthread_cond_broadcast(&self_p->port.cond);
+    pthread_mutex_unlock(&self_p->port.mutex);
+}
+
+static void thrd_pool_port_yield(void)
+{
+    sched_yield();
+}
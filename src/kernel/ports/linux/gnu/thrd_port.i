@@ -29,6 +29,8 @@
 struct thrd_port_idle_t {
     pthread_mutex_t mutex;
     pthread_cond_t cond;
+    struct thrd_t *thrd_p;
+    int pending;
 };
 
 static struct thrd_t main_thrd;
@@ -46,9 +48,23 @@ static char *thrd_port_get_main_thrd_stack_top(void)
 
 static struct thrd_port_idle_t idle = {
     .mutex = PTHREAD_MUTEX_INITIALIZER,
-    .cond = PTHREAD_COND_INITIALIZER
+    .cond = PTHREAD_COND_INITIALIZER,
+    .thrd_p = NULL,
+    .pending = 0
 };
 
+/**
+ * Wake the idle thread to let it reschedule. A pending flag is used
+ * so a signal given before the idle thread waits is not lost.
+ */
+static void idle_signal(void)
+{
+    pthread_mutex_lock(&idle.mutex);
+    idle.pending = 1;
+    pthread_cond_signal(&idle.cond);
+    pthread_mutex_unlock(&idle.mutex);
+}
+
 static void *thrd_port_main(void *arg_p)
 {
     struct thrd_port_t *port_p;
@@ -111,8 +127,15 @@ static int thrd_port_spawn(struct thrd_t *thrd_p,
 
 static void thrd_port_idle_wait(struct thrd_t *thrd_p)
 {
+    idle.thrd_p = thrd_p;
+
     pthread_mutex_lock(&idle.mutex);
-    pthread_cond_wait(&idle.cond, &idle.mutex);
+
+    while (idle.pending == 0) {
+        pthread_cond_wait(&idle.cond, &idle.mutex);
+    }
+
+    idle.pending = 0;
     pthread_mutex_unlock(&idle.mutex);
 
     /* Add this thread to the ready list and reschedule. */
@@ -125,18 +148,23 @@ static void thrd_port_idle_wait(struct thrd_t *thrd_p)
 
 static void thrd_port_on_suspend_timer_expired(struct thrd_t *thrd_p)
 {
-    /* Signal idle thrd.*/
-    pthread_mutex_lock(&idle.mutex);
-    pthread_cond_signal(&idle.cond);
-    pthread_mutex_unlock(&idle.mutex);
+    idle_signal();
+}
+
+static void thrd_port_on_resume(struct thrd_t *thrd_p)
+{
+    /* A thread outside the scheduler, for example the socket device
+       thread, resumed a thread while the idle thread was
+       running. Wake the idle thread instead of waiting for the next
+       tick. */
+    if (thrd_self() == idle.thrd_p) {
+        idle_signal();
+    }
 }
 
 static void thrd_port_tick(void)
 {
-    /* Signal idle thrd.*/
-    pthread_mutex_lock(&idle.mutex);
-    pthread_cond_signal(&idle.cond);
-    pthread_mutex_unlock(&idle.mutex);
+    idle_signal();
 }
 
 static void thrd_port_cpu_usage_start(struct thrd_t *thrd_p)
@@ -147,6 +175,22 @@ static void thrd_port_cpu_usage_stop(struct thrd_t *thrd_p)
 {
 }
 
+#if (CONFIG_THRD_CONTENTION == 1) || (CONFIG_THRD_TRACE == 1)
+
+/* The system uptime only has tick resolution on Linux. */
+#define THRD_PORT_TIME_US
+
+static uint32_t thrd_port_time_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (1000000UL * now.tv_sec + now.tv_nsec / 1000);
+}
+
+#endif
+
 #if CONFIG_MONITOR_THREAD == 1
 
 static cpu_usage_t thrd_port_cpu_usage_get(struct thrd_t *thrd_p)
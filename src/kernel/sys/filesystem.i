@@ -110,35 +110,30 @@ static int start_filesystem(void)
 #    define LOG_BLOCK_SIZE      4096
 #    define LOG_PAGE_SIZE        256
 
-struct filesystem_t {
-    struct flash_driver_t flash;
-    struct {
-        struct spiffs_t fs;
-        struct spiffs_config_t config;
-        uint8_t workspace[2 * LOG_PAGE_SIZE];
-        uint8_t fdworkspace[192];
-        uint8_t cache[1400];
-    } spiffs;
-    struct {
-        struct fs_filesystem_t fs;
-        struct fs_filesystem_spiffs_config_t config;
-    } fs;
-};
-
 #else
 
 #    define PHYS_ERASE_BLOCK       0x100
 #    define LOG_BLOCK_SIZE           256
 #    define LOG_PAGE_SIZE            128
 
+#endif
+
 struct filesystem_t {
     struct flash_driver_t flash;
     struct {
         struct spiffs_t fs;
         struct spiffs_config_t config;
         uint8_t workspace[2 * LOG_PAGE_SIZE];
-        uint8_t fdworkspace[160];
-        uint8_t cache[728];
+        uint8_t fdworkspace[SPIFFS_FILEDESCS_BUFFER_SIZE(
+                CONFIG_START_FILESYSTEM_SPIFFS_FILE_DESCRIPTORS)];
+        uint8_t cache[SPIFFS_CACHE_BUFFER_SIZE(
+                CONFIG_START_FILESYSTEM_SPIFFS_CACHE_PAGES,
+                LOG_PAGE_SIZE)];
+#if (CONFIG_SPIFFS_LOOKUP_INDEX == 1)                   \
+    && (CONFIG_START_FILESYSTEM_SPIFFS_LOOKUP_INDEX_SIZE > 0)
+        struct spiffs_lookup_index_entry_t lookup_index[
+            CONFIG_START_FILESYSTEM_SPIFFS_LOOKUP_INDEX_SIZE];
+#endif
     } spiffs;
     struct {
         struct fs_filesystem_t fs;
@@ -146,8 +141,6 @@ struct filesystem_t {
     } fs;
 };
 
-#endif
-
 static struct filesystem_t fs;
 
 static int32_t hal_read(struct spiffs_t *fs_p,
@@ -210,6 +203,13 @@ static int start_filesystem(void)
     fs.spiffs.config.log_block_size = LOG_BLOCK_SIZE;
     fs.spiffs.config.log_page_size = LOG_PAGE_SIZE;
 
+#if (CONFIG_SPIFFS_LOOKUP_INDEX == 1)                   \
+    && (CONFIG_START_FILESYSTEM_SPIFFS_LOOKUP_INDEX_SIZE > 0)
+    spiffs_set_lookup_index(&fs.spiffs.fs,
+                            &fs.spiffs.lookup_index[0],
+                            sizeof(fs.spiffs.lookup_index));
+#endif
+
     /* Mount the file system to initialize the runtime variables. */
     res = spiffs_mount(&fs.spiffs.fs,
                        &fs.spiffs.config,
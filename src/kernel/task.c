@@ -0,0 +1,376 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+/* Executor events. */
+#define EVENT_SPAWNED                                     0x1
+
+/* Poll period of channels not fitting in the channel list, and of
+   event channels with other events than the waited for set. */
+#define OVERFLOW_POLL_PERIOD_MS                            10
+
+/* Wait kinds. */
+#define WAIT_KIND_CHAN                                      0
+#define WAIT_KIND_EVENT                                     1
+
+static void start_wait(struct task_t *self_p,
+                       int kind,
+                       void *chan_p,
+                       const struct time_t *timeout_p)
+{
+    struct time_t now;
+
+    self_p->res = 0;
+    self_p->wait.pending = 1;
+    self_p->wait.kind = kind;
+    self_p->wait.chan_p = chan_p;
+    self_p->wait.timeout = (timeout_p != NULL);
+
+    if (timeout_p != NULL) {
+        sys_uptime(&now);
+        time_add(&self_p->wait.deadline,
+                 &now,
+                 (struct time_t *)timeout_p);
+    }
+}
+
+/**
+ * Check if the channel given task waits for has data. An event
+ * channel has data if any of the waited for events is set.
+ */
+static int has_data(struct task_t *task_p)
+{
+    struct event_t *event_p;
+
+    if (task_p->wait.kind == WAIT_KIND_EVENT) {
+        event_p = task_p->wait.chan_p;
+
+        return ((ATOMIC_LOAD(&event_p->mask) & task_p->wait.mask) != 0);
+    }
+
+    return (chan_size(task_p->wait.chan_p) > 0);
+}
+
+/**
+ * Check if given task is ready to be resumed, and if so, set the
+ * result of its wait.
+ */
+static int is_ready(struct task_t *task_p, struct time_t *now_p)
+{
+    if (task_p->wait.pending == 0) {
+        return (1);
+    }
+
+    if (task_p->wait.chan_p != NULL) {
+        if (has_data(task_p)) {
+            task_p->res = 0;
+
+            return (1);
+        }
+    }
+
+    if (task_p->wait.timeout) {
+        if (time_compare(now_p, &task_p->wait.deadline)
+            != time_compare_less_than_t) {
+            task_p->res = -ETIMEDOUT;
+
+            return (1);
+        }
+    } else if (task_p->wait.chan_p == NULL) {
+        /* Yield. */
+        task_p->res = 0;
+
+        return (1);
+    }
+
+    return (0);
+}
+
+static void take_spawned(struct task_executor_t *self_p)
+{
+    struct task_t *task_p;
+    struct task_t *next_p;
+
+    sys_lock();
+    task_p = self_p->spawned_p;
+    self_p->spawned_p = NULL;
+    sys_unlock();
+
+    while (task_p != NULL) {
+        next_p = task_p->next_p;
+        task_p->next_p = self_p->tasks_p;
+        self_p->tasks_p = task_p;
+        task_p = next_p;
+    }
+}
+
+/**
+ * Resume all ready tasks once.
+ */
+static void run_ready(struct task_executor_t *self_p)
+{
+    struct task_t *task_p;
+    struct task_t **prev_pp;
+    struct time_t now;
+
+    sys_uptime(&now);
+    prev_pp = &self_p->tasks_p;
+    task_p = self_p->tasks_p;
+
+    while (task_p != NULL) {
+        if (is_ready(task_p, &now)) {
+            if (task_p->fn(task_p) == TASK_DONE) {
+                *prev_pp = task_p->next_p;
+                ATOMIC_STORE(&task_p->done, 1);
+                task_p = *prev_pp;
+                continue;
+            }
+        }
+
+        prev_pp = &task_p->next_p;
+        task_p = task_p->next_p;
+    }
+}
+
+/**
+ * Wait for a channel, timeout or spawned task.
+ */
+static void executor_poll(struct task_executor_t *self_p)
+{
+    struct task_t *task_p;
+    struct time_t now;
+    struct time_t timeout;
+    struct time_t remaining;
+    int timeout_set;
+
+    sys_uptime(&now);
+    chan_list_init(&self_p->list,
+                   self_p->elements_p,
+                   self_p->number_of_elements);
+    chan_list_add(&self_p->list, &self_p->event);
+    timeout_set = 0;
+
+    for (task_p = self_p->tasks_p; task_p != NULL; task_p = task_p->next_p) {
+        if (is_ready(task_p, &now)) {
+            return;
+        }
+
+        if (task_p->wait.chan_p != NULL) {
+            /* Polling an event channel with other events than the
+               waited for set returns at once, so poll it
+               periodically instead. */
+            if ((chan_size(task_p->wait.chan_p) > 0)
+                || (chan_list_add(&self_p->list,
+                                  task_p->wait.chan_p) != 0)) {
+                remaining.seconds = 0;
+                remaining.nanoseconds = 1000000L * OVERFLOW_POLL_PERIOD_MS;
+
+                if (!timeout_set
+                    || (time_compare(&remaining, &timeout)
+                        == time_compare_less_than_t)) {
+                    timeout = remaining;
+                    timeout_set = 1;
+                }
+            }
+        }
+
+        if (task_p->wait.timeout) {
+            time_subtract(&remaining, &task_p->wait.deadline, &now);
+
+            if (!timeout_set
+                || (time_compare(&remaining, &timeout)
+                    == time_compare_less_than_t)) {
+                timeout = remaining;
+                timeout_set = 1;
+            }
+        }
+    }
+
+    (void)chan_list_poll(&self_p->list, timeout_set ? &timeout : NULL);
+}
+
+static void *executor_main(void *arg_p)
+{
+    struct task_executor_t *self_p;
+
+    self_p = arg_p;
+
+    thrd_set_name(self_p->name_p);
+
+    while (1) {
+        event_clear(&self_p->event, EVENT_SPAWNED);
+        take_spawned(self_p);
+        run_ready(self_p);
+        executor_poll(self_p);
+    }
+
+    return (NULL);
+}
+
+int task_executor_init(struct task_executor_t *self_p,
+                       struct chan_list_elem_t *elements_p,
+                       size_t number_of_elements,
+                       const char *name_p,
+                       int prio,
+                       void *stack_p,
+                       size_t stack_size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(elements_p != NULL, EINVAL);
+    ASSERTN(number_of_elements > 0, EINVAL);
+    ASSERTN(name_p != NULL, EINVAL);
+    ASSERTN(stack_p != NULL, EINVAL);
+
+    self_p->name_p = name_p;
+    self_p->prio = prio;
+    self_p->stack_p = stack_p;
+    self_p->stack_size = stack_size;
+    self_p->thrd_p = NULL;
+    self_p->tasks_p = NULL;
+    self_p->spawned_p = NULL;
+    self_p->elements_p = elements_p;
+    self_p->number_of_elements = number_of_elements;
+
+    return (event_init(&self_p->event));
+}
+
+int task_executor_start(struct task_executor_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    self_p->thrd_p = thrd_spawn(executor_main,
+                                self_p,
+                                self_p->prio,
+                                self_p->stack_p,
+                                self_p->stack_size);
+
+    return (self_p->thrd_p != NULL ? 0 : -1);
+}
+
+int task_init(struct task_t *self_p, task_fn_t fn, void *arg_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(fn != NULL, EINVAL);
+
+    self_p->fn = fn;
+    self_p->arg_p = arg_p;
+    self_p->lc = 0;
+    self_p->res = 0;
+    self_p->wait.pending = 0;
+    self_p->done = 1;
+    self_p->next_p = NULL;
+
+    return (0);
+}
+
+int task_spawn(struct task_t *self_p, struct task_executor_t *executor_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(executor_p != NULL, EINVAL);
+
+    uint32_t mask;
+
+    self_p->lc = 0;
+    self_p->res = 0;
+    self_p->wait.pending = 0;
+    self_p->done = 0;
+
+    sys_lock();
+    self_p->next_p = executor_p->spawned_p;
+    executor_p->spawned_p = self_p;
+    sys_unlock();
+
+    mask = EVENT_SPAWNED;
+
+    return (event_write(&executor_p->event,
+                        &mask,
+                        sizeof(mask)) == sizeof(mask) ? 0 : -1);
+}
+
+int task_is_done(struct task_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (ATOMIC_LOAD(&self_p->done));
+}
+
+int task_await_chan(struct task_t *self_p,
+                    void *chan_p,
+                    const struct time_t *timeout_p)
+{
+    /* Resumed by the executor with the result of the wait. */
+    if (self_p->wait.pending == 1) {
+        self_p->wait.pending = 0;
+
+        return (0);
+    }
+
+    if (chan_p != NULL) {
+        if (chan_size(chan_p) > 0) {
+            self_p->res = 0;
+
+            return (0);
+        }
+    }
+
+    start_wait(self_p, WAIT_KIND_CHAN, chan_p, timeout_p);
+
+    return (1);
+}
+
+int task_await_event(struct task_t *self_p,
+                     struct event_t *event_p,
+                     uint32_t *mask_p,
+                     const struct time_t *timeout_p)
+{
+    if (self_p->wait.pending == 0) {
+        self_p->wait.mask = *mask_p;
+        start_wait(self_p, WAIT_KIND_EVENT, event_p, timeout_p);
+    } else if (self_p->res == -ETIMEDOUT) {
+        self_p->wait.pending = 0;
+        *mask_p = 0;
+
+        return (0);
+    }
+
+    /* The events may have been read by someone else, so keep the
+       deadline and wait again if none of them is set. */
+    *mask_p = self_p->wait.mask;
+
+    if (event_try_read(event_p, mask_p, sizeof(*mask_p)) == sizeof(*mask_p)) {
+        self_p->wait.pending = 0;
+        self_p->res = 0;
+
+        return (0);
+    }
+
+    *mask_p = self_p->wait.mask;
+
+    return (1);
+}
@@ -0,0 +1,245 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __KERNEL_TASK_H__
+#define __KERNEL_TASK_H__
+
+#include "simba.h"
+
+/* Task function return values. */
+#define TASK_WAITING                                        0
+#define TASK_DONE                                           1
+
+/**
+ * Begin the body of a task function. Local variables are not
+ * preserved across the wait macros, so all state that must survive a
+ * wait is stored in the task argument.
+ */
+#define TASK_BEGIN(task_p)                      \
+    switch ((task_p)->lc) {                     \
+    case 0:
+
+/**
+ * End the body of a task function. The task is done.
+ */
+#define TASK_END(task_p)                        \
+    }                                           \
+    (task_p)->lc = 0;                           \
+    return (TASK_DONE)
+
+/**
+ * Return to the executor until given expression is false. The
+ * expression is evaluated each time the executor resumes the task.
+ */
+#define TASK_WAIT_WHILE(task_p, expr)           \
+    do {                                        \
+        (task_p)->lc = __LINE__;                \
+    case __LINE__:                              \
+        if (expr) {                             \
+            return (TASK_WAITING);              \
+        }                                       \
+    } while (0)
+
+/**
+ * Wait for data to be available on given channel, or a timeout. The
+ * result, zero(0) or -ETIMEDOUT, is stored in ``task_p->res``.
+ */
+#define TASK_AWAIT_CHAN(task_p, chan_p, timeout_p)                      \
+    TASK_WAIT_WHILE(task_p, task_await_chan(task_p, chan_p, timeout_p))
+
+/**
+ * Wait for any of the events in the mask pointed to by ``mask_p`` on
+ * given event channel, or a timeout. The mask is overwritten with the
+ * events that occured, or zero(0) on timeout. The mask must not be a
+ * local variable.
+ */
+#define TASK_AWAIT_EVENT(task_p, event_p, mask_p, timeout_p)            \
+    TASK_WAIT_WHILE(task_p, task_await_event(task_p,                    \
+                                             event_p,                   \
+                                             mask_p,                    \
+                                             timeout_p))
+
+/**
+ * Sleep for given time.
+ */
+#define TASK_SLEEP(task_p, timeout_p)                                   \
+    TASK_WAIT_WHILE(task_p, task_await_chan(task_p, NULL, timeout_p))
+
+/**
+ * Let the other ready tasks of the executor run.
+ */
+#define TASK_YIELD(task_p)                                      \
+    TASK_WAIT_WHILE(task_p, task_await_chan(task_p, NULL, NULL))
+
+struct task_t;
+
+/**
+ * Task function, called by the executor each time the task is
+ * resumed. Returns `TASK_WAITING` or `TASK_DONE`, normally using the
+ * task macros.
+ */
+typedef int (*task_fn_t)(struct task_t *self_p);
+
+struct task_t {
+    task_fn_t fn;
+    void *arg_p;
+    /* Local continuation, the line of the last wait. */
+    int lc;
+    /* Result of the last wait. */
+    int res;
+    struct {
+        int pending;
+        int kind;
+        void *chan_p;
+        int timeout;
+        struct time_t deadline;
+        uint32_t mask;
+    } wait;
+    int done;
+    struct task_t *next_p;
+};
+
+struct task_executor_t {
+    const char *name_p;
+    int prio;
+    void *stack_p;
+    size_t stack_size;
+    struct thrd_t *thrd_p;
+    struct task_t *tasks_p;
+    /* Tasks spawned but not yet seen by the executor. */
+    struct task_t *spawned_p;
+    struct event_t event;
+    struct chan_list_t list;
+    struct chan_list_elem_t *elements_p;
+    size_t number_of_elements;
+};
+
+/**
+ * Initialize given executor. The executor is a thread running
+ * stackless tasks, resuming each task when the channel, event or
+ * timeout it waits for is ready. All tasks share the stack of the
+ * executor thread.
+ *
+ * @param[in] self_p Executor to initialize.
+ * @param[in] elements_p Channel list elements used to poll the
+ *                       channels waited for. One element is used by
+ *                       the executor itself.
+ * @param[in] number_of_elements Number of channel list elements. If
+ *                               the tasks wait for more channels the
+ *                               executor polls them every 10 ms.
+ * @param[in] name_p Name of the executor thread.
+ * @param[in] prio Priority of the executor thread.
+ * @param[in] stack_p Executor thread stack.
+ * @param[in] stack_size Executor thread stack size.
+ *
+ * @return zero(0) or negative error code.
+ */
+int task_executor_init(struct task_executor_t *self_p,
+                       struct chan_list_elem_t *elements_p,
+                       size_t number_of_elements,
+                       const char *name_p,
+                       int prio,
+                       void *stack_p,
+                       size_t stack_size);
+
+/**
+ * Start given executor.
+ *
+ * @param[in] self_p Executor to start.
+ *
+ * @return zero(0) or negative error code.
+ */
+int task_executor_start(struct task_executor_t *self_p);
+
+/**
+ * Initialize given task.
+ *
+ * @param[in] self_p Task to initialize.
+ * @param[in] fn Task function.
+ * @param[in] arg_p Task function argument.
+ *
+ * @return zero(0) or negative error code.
+ */
+int task_init(struct task_t *self_p, task_fn_t fn, void *arg_p);
+
+/**
+ * Spawn given task on given executor. The task function is called
+ * from the beginning by the executor thread. May be called from any
+ * thread, including tasks of the executor. A task may be spawned
+ * again once it is done.
+ *
+ * @param[in] self_p Task to spawn.
+ * @param[in] executor_p Executor to run the task.
+ *
+ * @return zero(0) or negative error code.
+ */
+int task_spawn(struct task_t *self_p, struct task_executor_t *executor_p);
+
+/**
+ * Check if given task is done.
+ *
+ * @param[in] self_p Task.
+ *
+ * @return true(1) if the task function has returned `TASK_DONE`,
+ *         otherwise false(0).
+ */
+int task_is_done(struct task_t *self_p);
+
+/**
+ * Wait for data on given channel or a timeout. Used by
+ * `TASK_AWAIT_CHAN()`, `TASK_SLEEP()` and `TASK_YIELD()`.
+ *
+ * @param[in] self_p Task.
+ * @param[in] chan_p Channel to wait for, or NULL to only wait for
+ *                   the timeout.
+ * @param[in] timeout_p Timeout, or NULL to wait forever.
+ *
+ * @return true(1) if the task must wait, otherwise false(0).
+ */
+int task_await_chan(struct task_t *self_p,
+                    void *chan_p,
+                    const struct time_t *timeout_p);
+
+/**
+ * Wait for events on given event channel or a timeout. Used by
+ * `TASK_AWAIT_EVENT()`.
+ *
+ * @param[in] self_p Task.
+ * @param[in] event_p Event channel.
+ * @param[in, out] mask_p Events to wait for, and the events that
+ *                        occured.
+ * @param[in] timeout_p Timeout, or NULL to wait forever.
+ *
+ * @return true(1) if the task must wait, otherwise false(0).
+ */
+int task_await_event(struct task_t *self_p,
+                     struct event_t *event_p,
+                     uint32_t *mask_p,
+                     const struct time_t *timeout_p);
+
+#endif
@@ -41,6 +41,17 @@ enum thrd_state_t {
 #define THRD_STACK_LOW_MAGIC      0x1337
 #define THRD_FILL_PATTERN           0x19
 
+#if CONFIG_THRD_TRACE == 1
+
+struct trace_entry_t {
+    uint32_t time_us;
+    uint8_t type;
+    struct thrd_t *thrd_p;
+    uintptr_t arg;
+};
+
+#endif
+
 struct module_t {
     int8_t initialized;
     struct {
@@ -58,6 +69,26 @@ struct module_t {
 #if CONFIG_THRD_FS_COMMANDS == 1
     struct fs_command_t cmd_list;
     struct fs_command_t cmd_set_log_mask;
+#    if CONFIG_THRD_CONTENTION == 1
+    struct fs_command_t cmd_contention;
+#    endif
+#    if CONFIG_THRD_TRACE == 1
+    struct fs_command_t cmd_trace_dump;
+    struct fs_command_t cmd_trace_clear;
+#    endif
+#endif
+#if CONFIG_THRD_CONTENTION == 1
+    struct thrd_contention_t *contention_p;
+#endif
+#if CONFIG_THRD_TRACE == 1
+    struct {
+        struct trace_entry_t entries[CONFIG_THRD_TRACE_ENTRIES_MAX];
+        /* Index of the next entry to write. */
+        size_t pos;
+        /* Number of events written since cleared. */
+        uint32_t written;
+        int stopped;
+    } trace;
 #endif
 #if CONFIG_MONITOR_THREAD == 1
     struct fs_command_t cmd_monitor_set_period_ms;
@@ -152,6 +183,44 @@ void terminate(void);
 /* Stacks. */
 static THRD_STACK(idle_thrd_stack, CONFIG_THRD_IDLE_STACK_SIZE);
 
+#if (CONFIG_THRD_CONTENTION == 1) || (CONFIG_THRD_TRACE == 1)
+
+#    if !defined(THRD_PORT_TIME_US)
+
+/**
+ * Current time in microseconds, wrapping around at 2^32.
+ */
+static uint32_t thrd_port_time_us(void)
+{
+    struct time_t now;
+
+    sys_uptime_isr(&now);
+
+    return (1000000UL * now.seconds + now.nanoseconds / 1000);
+}
+
+#    endif
+
+#endif
+
+#if CONFIG_THRD_CONTENTION == 1
+
+/**
+ * Add given elapsed time to given total and maximum times.
+ */
+static void contention_add(uint64_t *total_p,
+                           uint32_t *max_p,
+                           uint32_t elapsed_us)
+{
+    *total_p += elapsed_us;
+
+    if (elapsed_us > *max_p) {
+        *max_p = elapsed_us;
+    }
+}
+
+#endif
+
 /**
  * The thread is terminated.
  */
@@ -187,6 +256,12 @@ static void on_suspend_timer_expired(void *arg_p)
     thrd_p->state = THRD_STATE_READY;
     scheduler_ready_push(thrd_p);
 
+#if CONFIG_THRD_TRACE == 1
+    thrd_trace_write_isr(THRD_TRACE_RESUME,
+                         thrd_p,
+                         (uintptr_t)module.scheduler.current_p);
+#endif
+
     thrd_port_on_suspend_timer_expired(thrd_p);
 }
 
@@ -200,6 +275,10 @@ static void on_suspend_timer_expired(void *arg_p)
  */
 static void scheduler_ready_push(struct thrd_t *thrd_p)
 {
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_p->statistics.ready.start_us = thrd_port_time_us();
+#endif
+
     thrd_prio_list_push_isr(&module.scheduler.ready, &thrd_p->scheduler.elem);
 }
 
@@ -230,6 +309,12 @@ static void thrd_reschedule(void)
 
     in_p = scheduler_ready_pop();
 
+#if CONFIG_THRD_CONTENTION == 1
+    contention_add(&in_p->statistics.ready.time_us,
+                   &in_p->statistics.ready.time_max_us,
+                   thrd_port_time_us() - in_p->statistics.ready.start_us);
+#endif
+
     /* Swap threads. */
     in_p->state = THRD_STATE_CURRENT;
 
@@ -237,6 +322,9 @@ static void thrd_reschedule(void)
         module.scheduler.current_p = in_p;
         thrd_port_cpu_usage_stop(out_p);
         thrd_port_cpu_usage_start(in_p);
+#if CONFIG_THRD_TRACE == 1
+        thrd_trace_write_isr(THRD_TRACE_SWAP, in_p, (uintptr_t)out_p);
+#endif
         thrd_port_swap(in_p, out_p);
 #if CONFIG_THRD_SCHEDULED == 1
         out_p->statistics.scheduled++;
@@ -350,6 +438,83 @@ static int cmd_list_cb(int argc,
     return (0);
 }
 
+#if CONFIG_THRD_CONTENTION == 1
+
+static int cmd_contention_cb(int argc,
+                             const char *argv[],
+                             void *chout_p,
+                             void *chin_p,
+                             void *arg_p,
+                             void *call_arg_p)
+{
+    struct thrd_t *thrd_p;
+    struct thrd_contention_t *contention_p;
+
+    std_fprintf(chout_p,
+                OSTR("                NAME  READY-MAX-US  READY-TOTAL-MS\r\n"));
+
+    thrd_p = module.threads_p;
+
+    while (thrd_p != NULL) {
+        std_fprintf(chout_p,
+                    OSTR("%20s %13lu %15lu\r\n"),
+                    thrd_p->name_p,
+                    (unsigned long)thrd_p->statistics.ready.time_max_us,
+                    (unsigned long)(thrd_p->statistics.ready.time_us / 1000));
+        thrd_p = thrd_p->next_p;
+    }
+
+    std_fprintf(chout_p,
+                OSTR("\r\n"
+                     "                NAME    TYPE    HOLDS  HOLD-MAX-US"
+                     "  HOLD-TOTAL-MS    WAITS  WAIT-MAX-US  WAIT-TOTAL-MS"
+                     "\r\n"));
+
+    contention_p = module.contention_p;
+
+    while (contention_p != NULL) {
+        std_fprintf(chout_p,
+                    OSTR("%20s %7s %8lu %12lu %14lu %8lu %12lu %14lu\r\n"),
+                    contention_p->name_p,
+                    contention_p->type_p,
+                    (unsigned long)contention_p->holds,
+                    (unsigned long)contention_p->hold_time_max_us,
+                    (unsigned long)(contention_p->hold_time_us / 1000),
+                    (unsigned long)contention_p->waits,
+                    (unsigned long)contention_p->wait_time_max_us,
+                    (unsigned long)(contention_p->wait_time_us / 1000));
+        contention_p = contention_p->next_p;
+    }
+
+    return (0);
+}
+
+#endif
+
+#if CONFIG_THRD_TRACE == 1
+
+static int cmd_trace_dump_cb(int argc,
+                             const char *argv[],
+                             void *chout_p,
+                             void *chin_p,
+                             void *arg_p,
+                             void *call_arg_p)
+{
+    return (thrd_trace_dump(chout_p));
+}
+
+static int cmd_trace_clear_cb(int argc,
+                              const char *argv[],
+                              void *chout_p,
+                              void *chin_p,
+                              void *arg_p,
+                              void *call_arg_p)
+{
+    return (thrd_trace_clear());
+}
+
+#endif
+
 static int cmd_set_log_mask_cb(int argc,
                                const char *argv[],
                                void *chout_p,
@@ -454,12 +619,28 @@ int thrd_module_init(void)
     thrd_p->statistics.scheduled = 0;
 #endif
 
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_p->statistics.ready.time_us = 0;
+    thrd_p->statistics.ready.time_max_us = 0;
+    thrd_p->statistics.ready.start_us = 0;
+#endif
+
 #if CONFIG_THRD_ENV == 1
     thrd_p->env.variables_p = NULL;
     thrd_p->env.number_of_variables = 0;
     thrd_p->env.max_number_of_variables = 0;
 #endif
 
+#if CONFIG_LOG_BINARY == 1
+    thrd_p->log_binary_buffer_p = NULL;
+#endif
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    thrd_p->inheritance.prio = thrd_p->prio;
+    thrd_p->inheritance.waiting_for_p = NULL;
+    thrd_p->inheritance.mutexes_p = NULL;
+#endif
+
 #if CONFIG_PANIC_ASSERT == 1
     thrd_p->stack_low_magic = THRD_STACK_LOW_MAGIC;
 #endif
@@ -495,6 +676,28 @@ int thrd_module_init(void)
                     NULL);
     fs_command_register(&module.cmd_set_log_mask);
 
+#    if CONFIG_THRD_CONTENTION == 1
+    fs_command_init(&module.cmd_contention,
+                    CSTR("/kernel/thrd/contention"),
+                    cmd_contention_cb,
+                    NULL);
+    fs_command_register(&module.cmd_contention);
+#    endif
+
+#    if CONFIG_THRD_TRACE == 1
+    fs_command_init(&module.cmd_trace_dump,
+                    CSTR("/kernel/thrd/trace/dump"),
+                    cmd_trace_dump_cb,
+                    NULL);
+    fs_command_register(&module.cmd_trace_dump);
+
+    fs_command_init(&module.cmd_trace_clear,
+                    CSTR("/kernel/thrd/trace/clear"),
+                    cmd_trace_clear_cb,
+                    NULL);
+    fs_command_register(&module.cmd_trace_clear);
+#    endif
+
 #    if CONFIG_MONITOR_THREAD == 1
     fs_command_init(&module.cmd_monitor_set_period_ms,
                     CSTR("/kernel/thrd/monitor/set_period_ms"),
@@ -549,12 +752,28 @@ struct thrd_t *thrd_spawn(void *(*main)(void *),
     thrd_p->statistics.scheduled = 0;
 #endif
 
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_p->statistics.ready.time_us = 0;
+    thrd_p->statistics.ready.time_max_us = 0;
+    thrd_p->statistics.ready.start_us = 0;
+#endif
+
 #if CONFIG_THRD_ENV == 1
     thrd_p->env.variables_p = NULL;
     thrd_p->env.number_of_variables = 0;
     thrd_p->env.max_number_of_variables = 0;
 #endif
 
+#if CONFIG_LOG_BINARY == 1
+    thrd_p->log_binary_buffer_p = NULL;
+#endif
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    thrd_p->inheritance.prio = thrd_p->prio;
+    thrd_p->inheritance.waiting_for_p = NULL;
+    thrd_p->inheritance.mutexes_p = NULL;
+#endif
+
 #if CONFIG_PANIC_ASSERT == 1
     thrd_p->stack_low_magic = THRD_STACK_LOW_MAGIC;
 #endif
@@ -725,7 +944,38 @@ int thrd_set_prio(struct thrd_t *thrd_p, int prio)
 {
     ASSERTN(thrd_p != NULL, EINVAL);
 
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    sys_lock();
+
+    thrd_p->inheritance.prio = prio;
+
+    /* An inherited higher priority is kept until the mutexes are
+       unlocked. */
+    if ((thrd_p->inheritance.mutexes_p == NULL) || (prio < thrd_p->prio)) {
+        thrd_p->prio = prio;
+    }
+
+    sys_unlock();
+#else
     thrd_p->prio = prio;
+#endif
+
+    return (0);
+}
+
+int thrd_set_prio_isr(struct thrd_t *thrd_p, int prio)
+{
+    ASSERTN(thrd_p != NULL, EINVAL);
+
+    thrd_p->prio = prio;
+
+    if (thrd_p->state == THRD_STATE_READY) {
+        /* Reinsert without restarting the time spent ready. */
+        thrd_prio_list_remove_isr(&module.scheduler.ready,
+                                  &thrd_p->scheduler.elem);
+        thrd_prio_list_push_isr(&module.scheduler.ready,
+                                &thrd_p->scheduler.elem);
+    }
 
     return (0);
 }
@@ -866,6 +1116,10 @@ int thrd_suspend_isr(const struct time_t *timeout_p)
                 timer_start_isr(&timer);
             }
         }
+
+#if CONFIG_THRD_TRACE == 1
+        thrd_trace_write_isr(THRD_TRACE_SUSPEND, thrd_p, 0);
+#endif
     }
 
     thrd_reschedule();
@@ -890,6 +1144,12 @@ int thrd_resume_isr(struct thrd_t *thrd_p, int err)
         }
 
         scheduler_ready_push(thrd_p);
+        thrd_port_on_resume(thrd_p);
+#if CONFIG_THRD_TRACE == 1
+        thrd_trace_write_isr(THRD_TRACE_RESUME,
+                             thrd_p,
+                             (uintptr_t)module.scheduler.current_p);
+#endif
     } else if (thrd_p->state != THRD_STATE_TERMINATED) {
         thrd_p->state = THRD_STATE_RESUMED;
     } else {
@@ -1026,3 +1286,227 @@ RAM_CODE int thrd_prio_list_remove_isr(struct thrd_prio_list_t *self_p,
 
     return (-1);
 }
+
+int thrd_contention_init(struct thrd_contention_t *self_p,
+                         const char *type_p,
+                         const char *name_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(type_p != NULL, EINVAL);
+
+#if CONFIG_THRD_CONTENTION == 1
+    struct thrd_contention_t *contention_p;
+
+    self_p->type_p = type_p;
+    self_p->name_p = name_p;
+    self_p->holds = 0;
+    self_p->waits = 0;
+    self_p->wait_time_us = 0;
+    self_p->wait_time_max_us = 0;
+    self_p->hold_time_us = 0;
+    self_p->hold_time_max_us = 0;
+    self_p->hold_start_us = 0;
+
+    if (name_p == NULL) {
+        return (0);
+    }
+
+    sys_lock();
+
+    /* Locks may be initialized more than once. */
+    contention_p = module.contention_p;
+
+    while ((contention_p != NULL) && (contention_p != self_p)) {
+        contention_p = contention_p->next_p;
+    }
+
+    if (contention_p == NULL) {
+        self_p->next_p = module.contention_p;
+        module.contention_p = self_p;
+    }
+
+    sys_unlock();
+
+    return (0);
+#else
+    return (-ENOSYS);
+#endif
+}
+
+uint32_t thrd_contention_wait_begin_isr(struct thrd_contention_t *self_p)
+{
+#if CONFIG_THRD_CONTENTION == 1
+    self_p->waits++;
+
+    return (thrd_port_time_us());
+#else
+    return (0);
+#endif
+}
+
+void thrd_contention_wait_end_isr(struct thrd_contention_t *self_p,
+                                  uint32_t start_us)
+{
+#if CONFIG_THRD_CONTENTION == 1
+    contention_add(&self_p->wait_time_us,
+                   &self_p->wait_time_max_us,
+                   thrd_port_time_us() - start_us);
+#endif
+}
+
+void thrd_contention_hold_begin_isr(struct thrd_contention_t *self_p)
+{
+#if CONFIG_THRD_CONTENTION == 1
+    self_p->holds++;
+    self_p->hold_start_us = thrd_port_time_us();
+#endif
+}
+
+void thrd_contention_hold_end_isr(struct thrd_contention_t *self_p)
+{
+#if CONFIG_THRD_CONTENTION == 1
+    contention_add(&self_p->hold_time_us,
+                   &self_p->hold_time_max_us,
+                   thrd_port_time_us() - self_p->hold_start_us);
+#endif
+}
+
+#if CONFIG_THRD_TRACE == 1
+
+static char * const FAR trace_type_fmt[] = {
+    "swap",
+    "suspend",
+    "resume",
+    "timer",
+    "marker"
+};
+
+#endif
+
+void thrd_trace_write_isr(int type, struct thrd_t *thrd_p, uintptr_t arg)
+{
+#if CONFIG_THRD_TRACE == 1
+    struct trace_entry_t *entry_p;
+
+    if (module.trace.stopped) {
+        return;
+    }
+
+    entry_p = &module.trace.entries[module.trace.pos];
+    entry_p->time_us = thrd_port_time_us();
+    entry_p->type = type;
+    entry_p->thrd_p = thrd_p;
+    entry_p->arg = arg;
+    module.trace.pos++;
+
+    if (module.trace.pos == membersof(module.trace.entries)) {
+        module.trace.pos = 0;
+    }
+
+    module.trace.written++;
+#endif
+}
+
+int thrd_trace_marker(const char *name_p)
+{
+    ASSERTN(name_p != NULL, EINVAL);
+
+#if CONFIG_THRD_TRACE == 1
+    sys_lock();
+    thrd_trace_write_isr(THRD_TRACE_MARKER, thrd_self(), (uintptr_t)name_p);
+    sys_unlock();
+
+    return (0);
+#else
+    return (-ENOSYS);
+#endif
+}
+
+int thrd_trace_clear(void)
+{
+#if CONFIG_THRD_TRACE == 1
+    sys_lock();
+    module.trace.pos = 0;
+    module.trace.written = 0;
+    sys_unlock();
+
+    return (0);
+#else
+    return (-ENOSYS);
+#endif
+}
+
+int thrd_trace_dump(void *chan_p)
+{
+    ASSERTN(chan_p != NULL, EINVAL);
+
+#if CONFIG_THRD_TRACE == 1
+    struct thrd_t *thrd_p;
+    struct trace_entry_t *entry_p;
+    size_t pos;
+    size_t length;
+
+    /* Printing switches threads, which must not overwrite the events
+       being printed. */
+    sys_lock();
+    module.trace.stopped = 1;
+    sys_unlock();
+
+    thrd_p = module.threads_p;
+
+    while (thrd_p != NULL) {
+        std_fprintf(chan_p,
+                    OSTR("thread 0x%lx %s\r\n"),
+                    (unsigned long)(uintptr_t)thrd_p,
+                    thrd_p->name_p);
+        thrd_p = thrd_p->next_p;
+    }
+
+    if (module.trace.written > membersof(module.trace.entries)) {
+        std_fprintf(chan_p,
+                    OSTR("dropped %lu\r\n"),
+                    (unsigned long)(module.trace.written
+                                    - membersof(module.trace.entries)));
+        length = membersof(module.trace.entries);
+        pos = module.trace.pos;
+    } else {
+        length = module.trace.written;
+        pos = 0;
+    }
+
+    while (length > 0) {
+        entry_p = &module.trace.entries[pos];
+
+        if (entry_p->type == THRD_TRACE_MARKER) {
+            std_fprintf(chan_p,
+                        OSTR("trace %lu marker 0x%lx %s\r\n"),
+                        (unsigned long)entry_p->time_us,
+                        (unsigned long)(uintptr_t)entry_p->thrd_p,
+                        (const char *)entry_p->arg);
+        } else {
+            std_fprintf(chan_p,
+                        OSTR("trace %lu %s 0x%lx 0x%lx\r\n"),
+                        (unsigned long)entry_p->time_us,
+                        trace_type_fmt[entry_p->type],
+                        (unsigned long)(uintptr_t)entry_p->thrd_p,
+                        (unsigned long)entry_p->arg);
+        }
+
+        pos++;
+
+        if (pos == membersof(module.trace.entries)) {
+            pos = 0;
+        }
+
+        length--;
+    }
+
+    sys_lock();
+    module.trace.stopped = 0;
+    sys_unlock();
+
+    return (0);
+#else
+    return (-ENOSYS);
+#endif
+}
@@ -68,6 +68,13 @@
     } while (0)
 
 
+/* Trace event types. */
+#define THRD_TRACE_SWAP                                     0
+#define THRD_TRACE_SUSPEND                                  1
+#define THRD_TRACE_RESUME                                   2
+#define THRD_TRACE_TIMER                                    3
+#define THRD_TRACE_MARKER                                   4
+
 /**
  * A thread environment variable.
  */
@@ -82,6 +89,14 @@ struct thrd_environment_t {
     size_t max_number_of_variables;
 };
 
+#if CONFIG_LOG_BINARY == 1
+struct log_binary_buffer_t;
+#endif
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+struct mutex_t;
+#endif
+
 struct thrd_t {
     struct {
         struct thrd_prio_list_elem_t elem;
@@ -109,12 +124,33 @@ struct thrd_t {
 #endif
 #if CONFIG_THRD_SCHEDULED == 1
         uint32_t scheduled;
+#endif
+#if CONFIG_THRD_CONTENTION == 1
+        /* Time spent in the ready list. */
+        struct {
+            uint64_t time_us;
+            uint32_t time_max_us;
+            uint32_t start_us;
+        } ready;
 #endif
     } statistics;
 #if CONFIG_THRD_ENV == 1
     struct thrd_environment_t env;
 #endif
     size_t stack_size;
+#if CONFIG_LOG_BINARY == 1
+    struct log_binary_buffer_t *log_binary_buffer_p;
+#endif
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    struct {
+        /* Priority set by the user. The scheduling priority is higher
+           while the thread holds a mutex a higher priority thread is
+           waiting for. */
+        int8_t prio;
+        struct mutex_t *waiting_for_p;
+        struct mutex_t *mutexes_p;
+    } inheritance;
+#endif
 #if CONFIG_PANIC_ASSERT == 1
     uint16_t stack_low_magic;
 #endif
@@ -294,6 +330,18 @@ int thrd_get_log_mask(void);
  */
 int thrd_set_prio(struct thrd_t *thrd_p, int prio);
 
+/**
+ * Set the scheduling priority of given thread, and reinsert it in the
+ * ready list if it is ready to be scheduled. This function must be
+ * called with the system lock taken.
+ *
+ * @param[in] thrd_p Thread to set the priority for.
+ * @param[in] prio Priority.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_set_prio_isr(struct thrd_t *thrd_p, int prio);
+
 /**
  * Get the priority of the current thread.
  *
@@ -476,4 +524,107 @@ struct thrd_prio_list_elem_t *thrd_prio_list_pop_isr(
 int thrd_prio_list_remove_isr(struct thrd_prio_list_t *self_p,
                               struct thrd_prio_list_elem_t *elem_p);
 
+/**
+ * Initialize given lock contention statistics. Named statistics are
+ * listed by the file system command ``/kernel/thrd/contention`` and
+ * must not be freed. Requires ``CONFIG_THRD_CONTENTION``.
+ *
+ * @param[in] self_p Statistics to initialize.
+ * @param[in] type_p Lock type, for example ``"mutex"``.
+ * @param[in] name_p Lock name, or NULL to not list the statistics.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_contention_init(struct thrd_contention_t *self_p,
+                         const char *type_p,
+                         const char *name_p);
+
+/**
+ * Called with the system lock taken before the calling thread is
+ * suspended waiting for a lock.
+ *
+ * @param[in] self_p Lock contention statistics.
+ *
+ * @return Wait start time to pass to
+ *         `thrd_contention_wait_end_isr()`.
+ */
+uint32_t thrd_contention_wait_begin_isr(struct thrd_contention_t *self_p);
+
+/**
+ * Called with the system lock taken when the calling thread has
+ * stopped waiting for a lock.
+ *
+ * @param[in] self_p Lock contention statistics.
+ * @param[in] start_us Wait start time.
+ *
+ * @return void.
+ */
+void thrd_contention_wait_end_isr(struct thrd_contention_t *self_p,
+                                  uint32_t start_us);
+
+/**
+ * Called with the system lock taken when a lock becomes busy.
+ *
+ * @param[in] self_p Lock contention statistics.
+ *
+ * @return void.
+ */
+void thrd_contention_hold_begin_isr(struct thrd_contention_t *self_p);
+
+/**
+ * Called with the system lock taken when a lock is no longer busy.
+ *
+ * @param[in] self_p Lock contention statistics.
+ *
+ * @return void.
+ */
+void thrd_contention_hold_end_isr(struct thrd_contention_t *self_p);
+
+/**
+ * Write an event to the trace ring buffer with the system lock taken
+ * or from isr. Requires ``CONFIG_THRD_TRACE``.
+ *
+ * @param[in] type Event type, one of ``THRD_TRACE_*``.
+ * @param[in] thrd_p Thread the event belongs to.
+ * @param[in] arg Event argument. The thread swapped out for
+ *                ``THRD_TRACE_SWAP``, the resuming thread for
+ *                ``THRD_TRACE_RESUME``, the callback for
+ *                ``THRD_TRACE_TIMER`` and a static string for
+ *                ``THRD_TRACE_MARKER``.
+ *
+ * @return void.
+ */
+void thrd_trace_write_isr(int type, struct thrd_t *thrd_p, uintptr_t arg);
+
+/**
+ * Write a marker event for the calling thread to the trace ring
+ * buffer. Requires ``CONFIG_THRD_TRACE``.
+ *
+ * @param[in] name_p Marker name. Must be a static string as only the
+ *                   pointer is stored.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_marker(const char *name_p);
+
+/**
+ * Remove all events from the trace ring buffer. Requires
+ * ``CONFIG_THRD_TRACE``.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_clear(void);
+
+/**
+ * Print all events in the trace ring buffer to given channel, oldest
+ * first, preceded by the name of each thread. The format is read by
+ * ``make/tracedecoder.py``. No events are recorded while printing.
+ * Requires ``CONFIG_THRD_TRACE``.
+ *
+ * @param[in] chan_p Output channel.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_trace_dump(void *chan_p);
+
 #endif
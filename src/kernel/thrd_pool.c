@@ -0,0 +1,502 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#if CONFIG_THRD_POOL_NATIVE == 1
+#    include "thrd_pool_port.i"
+#else
+
+static void worker_main(struct thrd_pool_worker_t *self_p);
+
+static void *thrd_pool_port_worker_main(void *arg_p)
+{
+    struct thrd_pool_worker_t *self_p;
+
+    self_p = arg_p;
+
+    thrd_set_name("thrd_pool");
+    worker_main(self_p);
+
+#    if CONFIG_THRD_TERMINATE == 0
+    /* Returning would stop the system. */
+    thrd_suspend(NULL);
+#    endif
+
+    return (NULL);
+}
+
+static int thrd_pool_port_init(struct thrd_pool_t *self_p)
+{
+    return (0);
+}
+
+static int thrd_pool_port_start_worker(struct thrd_pool_worker_t *worker_p,
+                                       int prio,
+                                       void *stack_p,
+                                       size_t stack_size)
+{
+    worker_p->port.sleeping = 0;
+    worker_p->port.thrd_p = thrd_spawn(thrd_pool_port_worker_main,
+                                       worker_p,
+                                       prio,
+                                       stack_p,
+                                       stack_size);
+
+    if (worker_p->port.thrd_p == NULL) {
+        return (-ENOMEM);
+    }
+
+    return (0);
+}
+
+static void thrd_pool_port_worker_stopped(struct thrd_pool_worker_t *worker_p)
+{
+    sem_give(&worker_p->pool_p->stopped_sem, 1);
+}
+
+static int thrd_pool_port_join_worker(struct thrd_pool_worker_t *worker_p)
+{
+    return (sem_take(&worker_p->pool_p->stopped_sem, NULL));
+}
+
+static struct thrd_pool_worker_t *thrd_pool_port_get_current_worker(
+    struct thrd_pool_t *self_p)
+{
+    struct thrd_t *thrd_p;
+    int i;
+
+    thrd_p = thrd_self();
+
+    for (i = 0; i < self_p->number_of_workers; i++) {
+        if (self_p->workers_p[i].port.thrd_p == thrd_p) {
+            return (&self_p->workers_p[i]);
+        }
+    }
+
+    return (NULL);
+}
+
+static void thrd_pool_port_deque_lock(struct thrd_pool_worker_t *worker_p)
+{
+    sys_lock();
+}
+
+static void thrd_pool_port_deque_unlock(struct thrd_pool_worker_t *worker_p)
+{
+    sys_unlock();
+}
+
+static void thrd_pool_port_wait(struct thrd_pool_t *self_p,
+                                struct thrd_pool_worker_t *worker_p)
+{
+    sys_lock();
+
+    if ((self_p->pending == 0) && (self_p->stopping == 0)) {
+        worker_p->port.sleeping = 1;
+        thrd_suspend_isr(NULL);
+    }
+
+    sys_unlock();
+}
+
+static void notify_isr(struct thrd_pool_t *self_p, int all)
+{
+    struct thrd_pool_worker_t *worker_p;
+    int i;
+
+    for (i = 0; i < self_p->number_of_workers; i++) {
+        worker_p = &self_p->workers_p[i];
+
+        if (worker_p->port.sleeping == 1) {
+            worker_p->port.sleeping = 0;
+            thrd_resume_isr(worker_p->port.thrd_p, 0);
+
+            if (!all) {
+                break;
+            }
+        }
+    }
+}
+
+static void thrd_pool_port_notify(struct thrd_pool_t *self_p)
+{
+    sys_lock();
+    notify_isr(self_p, 0);
+    sys_unlock();
+}
+
+static void thrd_pool_port_notify_all(struct thrd_pool_t *self_p)
+{
+    sys_lock();
+    notify_isr(self_p, 1);
+    sys_unlock();
+}
+
+static void thrd_pool_port_yield(void)
+{
+    thrd_yield();
+}
+
+#endif
+
+/**
+ * Push given job on the tail of the deque of given worker.
+ *
+ * @return zero(0) if the job was pushed, or negative error code if
+ *         the deque is full.
+ */
+static int deque_push(struct thrd_pool_worker_t *self_p,
+                      struct thrd_pool_future_t *future_p)
+{
+    int res;
+
+    res = -ENOMEM;
+
+    thrd_pool_port_deque_lock(self_p);
+
+    if (self_p->deque.tail - self_p->deque.head
+        < membersof(self_p->deque.futures)) {
+        self_p->deque.futures[self_p->deque.tail
+                              % membersof(self_p->deque.futures)] = future_p;
+        self_p->deque.tail++;
+        res = 0;
+    }
+
+    thrd_pool_port_deque_unlock(self_p);
+
+    return (res);
+}
+
+/**
+ * Pop the most recently pushed job from the deque of given worker.
+ */
+static struct thrd_pool_future_t *deque_pop(struct thrd_pool_worker_t *self_p)
+{
+    struct thrd_pool_future_t *future_p;
+
+    future_p = NULL;
+
+    thrd_pool_port_deque_lock(self_p);
+
+    if (self_p->deque.tail != self_p->deque.head) {
+        self_p->deque.tail--;
+        future_p = self_p->deque.futures[self_p->deque.tail
+                                         % membersof(self_p->deque.futures)];
+    }
+
+    thrd_pool_port_deque_unlock(self_p);
+
+    return (future_p);
+}
+
+/**
+ * Steal the oldest job from the deque of given worker.
+ */
+static struct thrd_pool_future_t *deque_steal(struct thrd_pool_worker_t *self_p)
+{
+    struct thrd_pool_future_t *future_p;
+
+    future_p = NULL;
+
+    thrd_pool_port_deque_lock(self_p);
+
+    if (self_p->deque.tail != self_p->deque.head) {
+        future_p = self_p->deque.futures[self_p->deque.head
+                                         % membersof(self_p->deque.futures)];
+        self_p->deque.head++;
+    }
+
+    thrd_pool_port_deque_unlock(self_p);
+
+    return (future_p);
+}
+
+/**
+ * Take a job from the deque of given worker, or steal one from the
+ * other workers.
+ */
+static struct thrd_pool_future_t *take(struct thrd_pool_worker_t *self_p)
+{
+    struct thrd_pool_t *pool_p;
+    struct thrd_pool_future_t *future_p;
+    int index;
+    int i;
+
+    pool_p = self_p->pool_p;
+
+    if (ATOMIC_LOAD(&pool_p->pending) == 0) {
+        return (NULL);
+    }
+
+    future_p = deque_pop(self_p);
+
+    if (future_p == NULL) {
+        index = (self_p - pool_p->workers_p);
+
+        for (i = 1; i < pool_p->number_of_workers; i++) {
+            future_p = deque_steal(
+                &pool_p->workers_p[(index + i) % pool_p->number_of_workers]);
+
+            if (future_p != NULL) {
+                self_p->statistics.stolen++;
+                break;
+            }
+        }
+    }
+
+    if (future_p != NULL) {
+        ATOMIC_ADD(&pool_p->pending, -1);
+    }
+
+    return (future_p);
+}
+
+/**
+ * Execute given job and resume the thread waiting for it, if any.
+ */
+static void execute(struct thrd_pool_future_t *future_p)
+{
+    future_p->res_p = future_p->fn(future_p->arg_p);
+    ATOMIC_STORE(&future_p->done, 1);
+
+    /* Pairs with the fence in thrd_pool_wait(). */
+    ATOMIC_FENCE();
+
+    if (ATOMIC_LOAD(&future_p->waiter_p) == NULL) {
+        return;
+    }
+
+    sys_lock();
+
+    if (future_p->waiter_p != NULL) {
+        thrd_resume_isr(future_p->waiter_p, 0);
+        future_p->waiter_p = NULL;
+    }
+
+    sys_unlock();
+}
+
+static void worker_main(struct thrd_pool_worker_t *self_p)
+{
+    struct thrd_pool_t *pool_p;
+    struct thrd_pool_future_t *future_p;
+
+    pool_p = self_p->pool_p;
+
+    while (1) {
+        future_p = take(self_p);
+
+        if (future_p != NULL) {
+            execute(future_p);
+            self_p->statistics.executed++;
+        } else if (ATOMIC_LOAD(&pool_p->stopping) == 1) {
+            break;
+        } else {
+            thrd_pool_port_wait(pool_p, self_p);
+        }
+    }
+
+    thrd_pool_port_worker_stopped(self_p);
+}
+
+int thrd_pool_module_init(void)
+{
+    return (0);
+}
+
+int thrd_pool_init(struct thrd_pool_t *self_p,
+                   struct thrd_pool_worker_t *workers_p,
+                   int number_of_workers,
+                   int prio,
+                   void *stacks_p,
+                   size_t stack_size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(workers_p != NULL, EINVAL);
+    ASSERTN(number_of_workers > 0, EINVAL);
+    ASSERTN((stack_size % 8) == 0, EINVAL);
+
+    struct thrd_pool_worker_t *worker_p;
+    int i;
+
+    self_p->workers_p = workers_p;
+    self_p->number_of_workers = number_of_workers;
+    self_p->prio = prio;
+    self_p->stacks_p = stacks_p;
+    self_p->stack_size = stack_size;
+    self_p->pending = 0;
+    self_p->stopping = 0;
+    self_p->next = 0;
+    sem_init(&self_p->stopped_sem, number_of_workers, number_of_workers);
+
+    for (i = 0; i < number_of_workers; i++) {
+        worker_p = &workers_p[i];
+        worker_p->pool_p = self_p;
+        worker_p->deque.head = 0;
+        worker_p->deque.tail = 0;
+        worker_p->deque.lock = 0;
+        worker_p->statistics.executed = 0;
+        worker_p->statistics.stolen = 0;
+    }
+
+    return (thrd_pool_port_init(self_p));
+}
+
+int thrd_pool_start(struct thrd_pool_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    int res;
+    int i;
+
+    for (i = 0; i < self_p->number_of_workers; i++) {
+        res = thrd_pool_port_start_worker(
+            &self_p->workers_p[i],
+            self_p->prio,
+            self_p->stacks_p == NULL ? NULL : (self_p->stacks_p
+                                               + i * self_p->stack_size),
+            self_p->stack_size);
+
+        if (res != 0) {
+            return (res);
+        }
+    }
+
+    return (0);
+}
+
+int thrd_pool_stop(struct thrd_pool_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    int i;
+
+    ATOMIC_STORE(&self_p->stopping, 1);
+    thrd_pool_port_notify_all(self_p);
+
+    for (i = 0; i < self_p->number_of_workers; i++) {
+        thrd_pool_port_join_worker(&self_p->workers_p[i]);
+    }
+
+    return (0);
+}
+
+int thrd_pool_submit(struct thrd_pool_t *self_p,
+                     struct thrd_pool_future_t *future_p,
+                     thrd_pool_fn_t fn,
+                     void *arg_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(future_p != NULL, EINVAL);
+    ASSERTN(fn != NULL, EINVAL);
+
+    struct thrd_pool_worker_t *worker_p;
+    int index;
+    int i;
+
+    future_p->fn = fn;
+    future_p->arg_p = arg_p;
+    future_p->res_p = NULL;
+    future_p->done = 0;
+    future_p->waiter_p = NULL;
+
+    worker_p = thrd_pool_port_get_current_worker(self_p);
+
+    if (worker_p != NULL) {
+        index = (worker_p - self_p->workers_p);
+    } else {
+        index = (ATOMIC_ADD(&self_p->next, 1) % self_p->number_of_workers);
+    }
+
+    for (i = 0; i < self_p->number_of_workers; i++) {
+        worker_p = &self_p->workers_p[(index + i) % self_p->number_of_workers];
+
+        if (deque_push(worker_p, future_p) == 0) {
+            ATOMIC_ADD(&self_p->pending, 1);
+            thrd_pool_port_notify(self_p);
+
+            return (0);
+        }
+    }
+
+    /* All deques are full. */
+    execute(future_p);
+
+    return (0);
+}
+
+void *thrd_pool_wait(struct thrd_pool_t *self_p,
+                     struct thrd_pool_future_t *future_p)
+{
+    ASSERTNRN(self_p != NULL, EINVAL);
+    ASSERTNRN(future_p != NULL, EINVAL);
+
+    struct thrd_pool_worker_t *worker_p;
+    struct thrd_pool_future_t *other_p;
+
+    worker_p = thrd_pool_port_get_current_worker(self_p);
+
+    if (worker_p != NULL) {
+        /* Help executing jobs instead of blocking the worker. */
+        while (ATOMIC_LOAD(&future_p->done) == 0) {
+            other_p = take(worker_p);
+
+            if (other_p != NULL) {
+                execute(other_p);
+                worker_p->statistics.executed++;
+            } else {
+                thrd_pool_port_yield();
+            }
+        }
+    } else if (ATOMIC_LOAD(&future_p->done) == 0) {
+        sys_lock();
+        ATOMIC_STORE(&future_p->waiter_p, thrd_self());
+
+        /* Pairs with the fence in execute(). */
+        ATOMIC_FENCE();
+
+        if (ATOMIC_LOAD(&future_p->done) == 0) {
+            /* Resumed and cleared by the worker. */
+            thrd_suspend_isr(NULL);
+        } else {
+            future_p->waiter_p = NULL;
+        }
+
+        sys_unlock();
+    }
+
+    return (future_p->res_p);
+}
+
+int thrd_pool_is_done(struct thrd_pool_future_t *future_p)
+{
+    ASSERTN(future_p != NULL, EINVAL);
+
+    return (ATOMIC_LOAD(&future_p->done));
+}
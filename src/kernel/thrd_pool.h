@@ -0,0 +1,203 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __KERNEL_THRD_POOL_H__
+#define __KERNEL_THRD_POOL_H__
+
+#include "simba.h"
+
+#if CONFIG_THRD_POOL_NATIVE == 1
+#    include "thrd_pool_port.h"
+#else
+
+struct thrd_pool_port_t {
+    int dummy;
+};
+
+struct thrd_pool_worker_port_t {
+    struct thrd_t *thrd_p;
+    int sleeping;
+};
+
+#endif
+
+/**
+ * Job function. The returned value is the result of the job.
+ */
+typedef void *(*thrd_pool_fn_t)(void *arg_p);
+
+/**
+ * A submitted job and its result.
+ */
+struct thrd_pool_future_t {
+    thrd_pool_fn_t fn;
+    void *arg_p;
+    void *res_p;
+    int done;
+    struct thrd_t *waiter_p;
+};
+
+struct thrd_pool_t;
+
+struct thrd_pool_worker_t {
+    struct thrd_pool_t *pool_p;
+    /* Jobs are pushed and popped by the owning worker at the tail,
+       and stolen by other workers at the head. */
+    struct {
+        struct thrd_pool_future_t *futures[CONFIG_THRD_POOL_DEQUE_MAX];
+        size_t head;
+        size_t tail;
+        int lock;
+    } deque;
+    struct {
+        uint32_t executed;
+        uint32_t stolen;
+    } statistics;
+    struct thrd_pool_worker_port_t port;
+};
+
+struct thrd_pool_t {
+    struct thrd_pool_worker_t *workers_p;
+    int number_of_workers;
+    int prio;
+    char *stacks_p;
+    size_t stack_size;
+    /* Number of jobs in the deques. */
+    int pending;
+    int stopping;
+    unsigned int next;
+    struct sem_t stopped_sem;
+    struct thrd_pool_port_t port;
+};
+
+/**
+ * Initialize the thread pool module. This function must be called
+ * before calling any other function in this module.
+ *
+ * The module will only be initialized once even if this function is
+ * called multiple times.
+ *
+ * @return zero(0) or negative error code
+ */
+int thrd_pool_module_init(void);
+
+/**
+ * Initialize given thread pool. Each worker has a deque of
+ * ``CONFIG_THRD_POOL_DEQUE_MAX`` jobs, and steals jobs from the other
+ * workers when its own deque is empty.
+ *
+ * If ``CONFIG_THRD_POOL_NATIVE`` is set, as it is on Linux, the
+ * workers are native threads running in parallel with each other and
+ * the Simba threads. Jobs must then only use thread safe functions,
+ * and must not call functions that suspend the calling thread, except
+ * `thrd_pool_submit()` and `thrd_pool_wait()`. Otherwise the workers
+ * are Simba threads with given priority and stacks.
+ *
+ * @param[in] self_p Thread pool to initialize.
+ * @param[in] workers_p Workers.
+ * @param[in] number_of_workers Number of workers.
+ * @param[in] prio Priority of the worker threads.
+ * @param[in] stacks_p Worker thread stacks, ``stack_size`` bytes
+ *                     each. Declared with `THRD_STACK()` as a single
+ *                     stack of ``number_of_workers * stack_size``
+ *                     bytes. May be NULL for native workers.
+ * @param[in] stack_size Stack size of each worker, a multiple of 8
+ *                       bytes.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_pool_init(struct thrd_pool_t *self_p,
+                   struct thrd_pool_worker_t *workers_p,
+                   int number_of_workers,
+                   int prio,
+                   void *stacks_p,
+                   size_t stack_size);
+
+/**
+ * Start the workers of given thread pool.
+ *
+ * @param[in] self_p Thread pool to start.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_pool_start(struct thrd_pool_t *self_p);
+
+/**
+ * Stop the workers of given thread pool once all submitted jobs have
+ * been executed. Simba worker threads are terminated if
+ * ``CONFIG_THRD_TERMINATE`` is set, and suspended forever otherwise,
+ * so their stacks cannot be reused.
+ *
+ * @param[in] self_p Thread pool to stop.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_pool_stop(struct thrd_pool_t *self_p);
+
+/**
+ * Submit a job to given thread pool. Jobs submitted by a worker are
+ * added to its own deque, and other jobs are distributed round-robin
+ * over the workers. The job is executed by the calling thread if all
+ * deques are full.
+ *
+ * @param[in] self_p Thread pool.
+ * @param[out] future_p Future of the job, valid until the job has
+ *                      completed.
+ * @param[in] fn Job function.
+ * @param[in] arg_p Job function argument.
+ *
+ * @return zero(0) or negative error code.
+ */
+int thrd_pool_submit(struct thrd_pool_t *self_p,
+                     struct thrd_pool_future_t *future_p,
+                     thrd_pool_fn_t fn,
+                     void *arg_p);
+
+/**
+ * Wait for given job to complete. A worker executes other jobs while
+ * waiting, any other thread is suspended. Only one thread may wait
+ * for a job.
+ *
+ * @param[in] self_p Thread pool.
+ * @param[in] future_p Future of the job to wait for.
+ *
+ * @return The job result.
+ */
+void *thrd_pool_wait(struct thrd_pool_t *self_p,
+                     struct thrd_pool_future_t *future_p);
+
+/**
+ * Check if given job has completed.
+ *
+ * @param[in] future_p Future of the job.
+ *
+ * @return true(1) if the job has completed, otherwise false(0).
+ */
+int thrd_pool_is_done(struct thrd_pool_future_t *future_p);
+
+#endif
@@ -163,6 +163,11 @@ void RAM_CODE timer_tick_isr(void)
         while (list_p->head_p->delta == 0) {
             timer_p = list_p->head_p;
             list_p->head_p = timer_p->next_p;
+#if CONFIG_THRD_TRACE == 1
+            thrd_trace_write_isr(THRD_TRACE_TIMER,
+                                 thrd_self(),
+                                 (uintptr_t)timer_p->callback);
+#endif
             timer_p->callback(timer_p->arg_p);
 
             /* Re-set periodic timers. */
@@ -196,6 +201,11 @@ void RAM_CODE timer_high_resolution_isr(void)
     }
 
     /* Fire the expired timer.*/
+#if CONFIG_THRD_TRACE == 1
+    thrd_trace_write_isr(THRD_TRACE_TIMER,
+                         thrd_self(),
+                         (uintptr_t)timer_p->callback);
+#endif
     timer_p->callback(timer_p->arg_p);
 
     sys_unlock_isr();
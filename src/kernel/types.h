@@ -145,6 +145,129 @@
 #define BITFIELD_GET(name, value)               \
     (((value) & name ## _MASK) >> name ## _POS)
 
+/**
+ * Prevent the compiler from reordering memory accesses across this
+ * point.
+ */
+#define COMPILER_BARRIER() __asm__ __volatile__("" : : : "memory")
+
+/**
+ * Word sized atomic operations. They are lock-free if
+ * ATOMIC_LOCK_FREE is 1, otherwise they are made atomic with the
+ * system lock, and must not be used with the system lock taken or
+ * from interrupt context.
+ *
+ * ATOMIC_CAS() compares the value at given pointer with the value
+ * pointed to by expected_p, and swaps in desired if they are
+ * equal. Otherwise the current value is written to expected_p. Non-zero
+ * is returned if the value was swapped. ATOMIC_FENCE() orders all
+ * memory accesses before it with all accesses after it.
+ */
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE)                 \
+    && (__GCC_ATOMIC_INT_LOCK_FREE == 2)                \
+    && (__GCC_ATOMIC_POINTER_LOCK_FREE == 2)
+#    define ATOMIC_LOCK_FREE                                        1
+#    define ATOMIC_LOAD(ptr_p)                  \
+    __atomic_load_n(ptr_p, __ATOMIC_ACQUIRE)
+#    define ATOMIC_STORE(ptr_p, value)                  \
+    __atomic_store_n(ptr_p, value, __ATOMIC_RELEASE)
+#    define ATOMIC_ADD(ptr_p, value)                    \
+    __atomic_add_fetch(ptr_p, value, __ATOMIC_ACQ_REL)
+#    define ATOMIC_EXCHANGE(ptr_p, value)                       \
+    __atomic_exchange_n(ptr_p, value, __ATOMIC_ACQ_REL)
+#    define ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#    define ATOMIC_CAS(ptr_p, expected_p, desired)                      \
+    __atomic_compare_exchange_n(ptr_p,                                  \
+                                expected_p,                             \
+                                desired,                                \
+                                0,                                      \
+                                __ATOMIC_ACQ_REL,                       \
+                                __ATOMIC_ACQUIRE)
+#else
+#    define ATOMIC_LOCK_FREE                                        0
+#    define ATOMIC_FENCE() COMPILER_BARRIER()
+#    define ATOMIC_LOAD(ptr_p)                          \
+    ({                                                  \
+        __typeof__(*(ptr_p)) atomic_res;                \
+                                                        \
+        sys_lock();                                     \
+        atomic_res = *(ptr_p);                          \
+        sys_unlock();                                   \
+        atomic_res;                                     \
+    })
+#    define ATOMIC_STORE(ptr_p, value)          \
+    do {                                        \
+        sys_lock();                             \
+        *(ptr_p) = (value);                     \
+        sys_unlock();                           \
+    } while (0)
+#    define ATOMIC_ADD(ptr_p, value)                    \
+    ({                                                  \
+        __typeof__(*(ptr_p)) atomic_res;                \
+                                                        \
+        sys_lock();                                     \
+        atomic_res = (*(ptr_p) += (value));             \
+        sys_unlock();                                   \
+        atomic_res;                                     \
+    })
+#    define ATOMIC_EXCHANGE(ptr_p, value)               \
+    ({                                                  \
+        __typeof__(*(ptr_p)) atomic_res;                \
+                                                        \
+        sys_lock();                                     \
+        atomic_res = *(ptr_p);                          \
+        *(ptr_p) = (value);                             \
+        sys_unlock();                                   \
+        atomic_res;                                     \
+    })
+#    define ATOMIC_CAS(ptr_p, expected_p, desired)      \
+    ({                                                  \
+        int atomic_res;                                 \
+                                                        \
+        sys_lock();                                     \
+        atomic_res = (*(ptr_p) == *(expected_p));       \
+                                                        \
+        if (atomic_res) {                               \
+            *(ptr_p) = (desired);                       \
+        } else {                                        \
+            *(expected_p) = *(ptr_p);                   \
+        }                                               \
+                                                        \
+        sys_unlock();                                   \
+        atomic_res;                                     \
+    })
+#endif
+
+/**
+ * Atomic operations for use with the system lock taken, in data
+ * structures that also have lock-free fast paths. They are the lock-free
+ * operations if ATOMIC_LOCK_FREE is 1, and plain memory accesses
+ * otherwise, as there are no fast paths then.
+ */
+#if ATOMIC_LOCK_FREE == 1
+#    define ATOMIC_LOAD_ISR(ptr_p) ATOMIC_LOAD(ptr_p)
+#    define ATOMIC_STORE_ISR(ptr_p, value) ATOMIC_STORE(ptr_p, value)
+#    define ATOMIC_CAS_ISR(ptr_p, expected_p, desired)  \
+    ATOMIC_CAS(ptr_p, expected_p, desired)
+#else
+#    define ATOMIC_LOAD_ISR(ptr_p) (*(ptr_p))
+#    define ATOMIC_STORE_ISR(ptr_p, value) (*(ptr_p) = (value))
+#    define ATOMIC_CAS_ISR(ptr_p, expected_p, desired)  \
+    ({                                                  \
+        int atomic_res;                                 \
+                                                        \
+        atomic_res = (*(ptr_p) == *(expected_p));       \
+                                                        \
+        if (atomic_res) {                               \
+            *(ptr_p) = (desired);                       \
+        } else {                                        \
+            *(expected_p) = *(ptr_p);                   \
+        }                                               \
+                                                        \
+        atomic_res;                                     \
+    })
+#endif
+
 #if defined(SIMBAPP)
 #    define OSTR(string) __simbapp_fmtstr_begin__ string __simbapp_fmtstr_end__
 #    define CSTR(string) __simbapp_cmdstr_begin__ string __simbapp_cmdstr_end__
@@ -169,6 +292,25 @@ struct thrd_prio_list_t {
     struct thrd_prio_list_elem_t *head_p;
 };
 
+/**
+ * Lock contention statistics, recorded if ``CONFIG_THRD_CONTENTION``
+ * is set.
+ */
+struct thrd_contention_t {
+    const char *type_p;
+    const char *name_p;
+    /** Number of times the lock became busy. */
+    uint32_t holds;
+    /** Number of times a thread had to wait for the lock. */
+    uint32_t waits;
+    uint64_t wait_time_us;
+    uint32_t wait_time_max_us;
+    uint64_t hold_time_us;
+    uint32_t hold_time_max_us;
+    uint32_t hold_start_us;
+    struct thrd_contention_t *next_p;
+};
+
 /**
  * Input-output vector.
  */
@@ -59,3 +59,21 @@ static ssize_t nvm_port_write(size_t dst, const void *src_p, size_t size)
 
     return (size);
 }
+
+static ssize_t nvm_port_vwrite(struct iov_uintptr_t *dst_p,
+                               struct iov_t *src_p,
+                               size_t length)
+{
+    size_t i;
+    ssize_t size;
+
+    size = 0;
+
+    for (i = 0; i < length; i++) {
+        size += nvm_port_write(dst_p[i].address,
+                               src_p[i].buf_p,
+                               dst_p[i].size);
+    }
+
+    return (size);
+}
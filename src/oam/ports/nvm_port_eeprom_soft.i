@@ -54,11 +54,20 @@ static int nvm_port_module_init(void)
     module.port.blocks[1].address = (uintptr_t)&nvm_eeprom_soft_block_1[0];
     module.port.blocks[1].size = sizeof(nvm_eeprom_soft_block_1);
 
-    return (eeprom_soft_init(&module.port.eeprom_soft,
-                             &module.port.flash,
-                             &module.port.blocks[0],
-                             membersof(module.port.blocks),
-                             CONFIG_NVM_EEPROM_SOFT_CHUNK_SIZE));
+    res = eeprom_soft_init(&module.port.eeprom_soft,
+                           &module.port.flash,
+                           &module.port.blocks[0],
+                           membersof(module.port.blocks),
+                           CONFIG_NVM_EEPROM_SOFT_CHUNK_SIZE);
+
+#if CONFIG_NVM_EEPROM_SOFT_LOG_SIZE > 0
+    if (res == 0) {
+        res = eeprom_soft_set_log_size(&module.port.eeprom_soft,
+                                       CONFIG_NVM_EEPROM_SOFT_LOG_SIZE);
+    }
+#endif
+
+    return (res);
 }
 
 static int nvm_port_mount()
@@ -28,8 +28,34 @@
 
 #include "simba.h"
 
+#if CONFIG_SETTINGS_SHADOW == 1
+
+struct dirty_range_t {
+    size_t begin;
+    size_t end;
+};
+
+struct module_shadow_t {
+    int8_t loaded;
+    int depth;
+    int number_of_pending_writes;
+    int number_of_dirty_ranges;
+    /* One extra range used when adding a range to a full array. */
+    struct dirty_range_t dirty_ranges[
+        CONFIG_SETTINGS_SHADOW_DIRTY_RANGES_MAX + 1];
+    struct mutex_t mutex;
+    uint8_t buf[CONFIG_SETTINGS_AREA_SIZE];
+};
+
+#endif
+
 struct module_t {
     int8_t initialized;
+    size_t number_of_settings;
+    struct settings_stats_t stats;
+#if CONFIG_SETTINGS_SHADOW == 1
+    struct module_shadow_t shadow;
+#endif
 #if CONFIG_SETTINGS_FS_COMMAND_LIST == 1
     struct fs_command_t cmd_list;
 #endif
@@ -47,27 +73,233 @@ struct module_t {
 static struct module_t module;
 
 extern const FAR struct setting_t settings[];
+extern const FAR uint16_t settings_by_name[];
 const FAR uint8_t settings_default[CONFIG_SETTINGS_AREA_SIZE]
 __attribute__ ((weak)) = { 0xff, };
 
+/**
+ * Binary search for given setting name in the name index generated
+ * by simbagen.py.
+ */
 static const FAR struct setting_t *get_setting_by_name(
     const char *name_p)
 {
     const FAR struct setting_t *setting_p;
+    size_t low;
+    size_t high;
+    size_t middle;
+    int res;
 
-    setting_p = &settings[0];
+    low = 0;
+    high = module.number_of_settings;
 
-    while (setting_p->name_p != NULL) {
-        if (std_strcmp(name_p, setting_p->name_p) == 0) {
+    while (low < high) {
+        middle = ((low + high) / 2);
+        setting_p = &settings[settings_by_name[middle]];
+        res = std_strcmp(name_p, setting_p->name_p);
+
+        if (res == 0) {
             return (setting_p);
+        } else if (res < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
         }
-
-        setting_p++;
     }
 
     return (NULL);
 }
 
+#if CONFIG_SETTINGS_SHADOW == 1
+
+/**
+ * Load the shadow from the non-volatile memory on first use, as the
+ * non-volatile memory may be mounted after this module is
+ * initialized. Called with the shadow mutex locked.
+ */
+static int shadow_load(void)
+{
+    if (module.shadow.loaded == 1) {
+        return (0);
+    }
+
+    if (nvm_read(&module.shadow.buf[0],
+                 0,
+                 sizeof(module.shadow.buf)) != sizeof(module.shadow.buf)) {
+        return (-EIO);
+    }
+
+    module.shadow.loaded = 1;
+
+    return (0);
+}
+
+/**
+ * Add given address range to the sorted ranges to commit. Overlapping
+ * and adjacent ranges are merged. If too many ranges are used the
+ * two closest ranges are merged, which rewrites the unmodified bytes
+ * between them.
+ */
+static void shadow_add_dirty_range(size_t begin, size_t end)
+{
+    struct dirty_range_t *ranges_p;
+    int length;
+    int i;
+    int j;
+    int closest;
+    size_t gap;
+    size_t closest_gap;
+
+    ranges_p = &module.shadow.dirty_ranges[0];
+    length = module.shadow.number_of_dirty_ranges;
+
+    /* Skip ranges ending before the new range. */
+    i = 0;
+
+    while ((i < length) && (ranges_p[i].end < begin)) {
+        i++;
+    }
+
+    /* Merge with all ranges touching the new range. */
+    j = i;
+
+    while ((j < length) && (ranges_p[j].begin <= end)) {
+        begin = MIN(begin, ranges_p[j].begin);
+        end = MAX(end, ranges_p[j].end);
+        j++;
+    }
+
+    /* Replace the merged ranges, if any, with the new range. */
+    memmove(&ranges_p[i + 1],
+            &ranges_p[j],
+            (length - j) * sizeof(*ranges_p));
+    length += (1 - (j - i));
+    ranges_p[i].begin = begin;
+    ranges_p[i].end = end;
+
+    if (length > CONFIG_SETTINGS_SHADOW_DIRTY_RANGES_MAX) {
+        closest = 0;
+        closest_gap = (ranges_p[1].begin - ranges_p[0].end);
+
+        for (i = 1; i < length - 1; i++) {
+            gap = (ranges_p[i + 1].begin - ranges_p[i].end);
+
+            if (gap < closest_gap) {
+                closest = i;
+                closest_gap = gap;
+            }
+        }
+
+        ranges_p[closest].end = ranges_p[closest + 1].end;
+        memmove(&ranges_p[closest + 1],
+                &ranges_p[closest + 2],
+                (length - closest - 2) * sizeof(*ranges_p));
+        length--;
+    }
+
+    module.shadow.number_of_dirty_ranges = length;
+}
+
+/**
+ * Write all modified ranges to the non-volatile memory in a single
+ * call. Called with the shadow mutex locked.
+ */
+static int shadow_commit(void)
+{
+    struct iov_uintptr_t dst[CONFIG_SETTINGS_SHADOW_DIRTY_RANGES_MAX];
+    struct iov_t src[CONFIG_SETTINGS_SHADOW_DIRTY_RANGES_MAX];
+    struct dirty_range_t *range_p;
+    int i;
+    ssize_t res;
+
+    if (module.shadow.number_of_dirty_ranges == 0) {
+        return (0);
+    }
+
+    for (i = 0; i < module.shadow.number_of_dirty_ranges; i++) {
+        range_p = &module.shadow.dirty_ranges[i];
+        dst[i].address = range_p->begin;
+        dst[i].size = (range_p->end - range_p->begin);
+        src[i].buf_p = &module.shadow.buf[range_p->begin];
+        src[i].size = dst[i].size;
+    }
+
+    res = nvm_vwrite(&dst[0], &src[0], module.shadow.number_of_dirty_ranges);
+
+    /* Keep the ranges to retry in the next commit on failure. */
+    if (res < 0) {
+        return (res);
+    }
+
+    module.stats.number_of_nvm_writes++;
+    module.stats.number_of_coalesced_writes +=
+        (module.shadow.number_of_pending_writes - 1);
+    module.shadow.number_of_pending_writes = 0;
+    module.shadow.number_of_dirty_ranges = 0;
+
+    return (0);
+}
+
+static ssize_t shadow_read(void *dst_p, size_t src, size_t size)
+{
+    int res;
+
+    mutex_lock(&module.shadow.mutex);
+
+    res = shadow_load();
+
+    if (res == 0) {
+        memcpy(dst_p, &module.shadow.buf[src], size);
+    }
+
+    mutex_unlock(&module.shadow.mutex);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    return (size);
+}
+
+/**
+ * Write given data to the shadow. It is written to the non-volatile
+ * memory immediately, unless in a batch started by settings_begin().
+ */
+static ssize_t shadow_write(size_t dst, const void *src_p, size_t size)
+{
+    int res;
+
+    mutex_lock(&module.shadow.mutex);
+
+    res = shadow_load();
+
+    if (res == 0) {
+        module.stats.number_of_writes++;
+
+        if (memcmp(&module.shadow.buf[dst], src_p, size) == 0) {
+            module.stats.number_of_unchanged_writes++;
+        } else {
+            memcpy(&module.shadow.buf[dst], src_p, size);
+            shadow_add_dirty_range(dst, dst + size);
+            module.shadow.number_of_pending_writes++;
+
+            if (module.shadow.depth == 0) {
+                res = shadow_commit();
+            }
+        }
+    }
+
+    mutex_unlock(&module.shadow.mutex);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    return (size);
+}
+
+#endif
+
 #if CONFIG_SETTINGS_FS_COMMAND_LIST == 1
 
 static int cmd_list_cb(int argc,
@@ -380,13 +612,20 @@ static int cmd_write_cb(int argc,
 
 #endif
 
+/**
+ * Reset given address range to its default value, as a single batch
+ * of writes.
+ */
 static int reset(size_t address, size_t size)
 {
     size_t i;
     size_t left;
     uint8_t buf[128];
+    int res;
 
+    res = 0;
     left = size;
+    settings_begin();
 
     while (left > 0) {
         if (left < sizeof(buf)) {
@@ -399,15 +638,20 @@ static int reset(size_t address, size_t size)
             buf[i] = settings_default[address + i];
         }
 
-        if (nvm_write(address, &buf[0], size) != size) {
-            return (-1);
+        if (settings_write(address, &buf[0], size) != size) {
+            res = -1;
+            break;
         }
 
         address += size;
         left -= size;
     }
 
-    return (0);
+    if (settings_commit() != 0) {
+        res = -1;
+    }
+
+    return (res);
 }
 
 int settings_module_init(void)
@@ -418,6 +662,15 @@ int settings_module_init(void)
     }
 
     module.initialized = 1;
+    module.number_of_settings = 0;
+
+    while (settings[module.number_of_settings].name_p != NULL) {
+        module.number_of_settings++;
+    }
+
+#if CONFIG_SETTINGS_SHADOW == 1
+    mutex_init(&module.shadow.mutex);
+#endif
 
 #if CONFIG_SETTINGS_FS_COMMAND_LIST == 1
     fs_command_init(&module.cmd_list,
@@ -459,7 +712,13 @@ ssize_t settings_read(void *dst_p, size_t src, size_t size)
     ASSERTN(dst_p != NULL, EINVAL);
     ASSERTN(size > 0, EINVAL);
 
+#if CONFIG_SETTINGS_SHADOW == 1
+    ASSERTN(src + size <= CONFIG_SETTINGS_AREA_SIZE, EINVAL);
+
+    return (shadow_read(dst_p, src, size));
+#else
     return (nvm_read(dst_p, src, size));
+#endif
 }
 
 ssize_t settings_write(size_t dst, const void *src_p, size_t size)
@@ -467,7 +726,52 @@ ssize_t settings_write(size_t dst, const void *src_p, size_t size)
     ASSERTN(src_p != NULL, EINVAL);
     ASSERTN(size > 0, EINVAL);
 
+#if CONFIG_SETTINGS_SHADOW == 1
+    ASSERTN(dst + size <= CONFIG_SETTINGS_AREA_SIZE, EINVAL);
+
+    return (shadow_write(dst, src_p, size));
+#else
+    module.stats.number_of_writes++;
+    module.stats.number_of_nvm_writes++;
+
     return (nvm_write(dst, src_p, size));
+#endif
+}
+
+int settings_begin(void)
+{
+#if CONFIG_SETTINGS_SHADOW == 1
+    mutex_lock(&module.shadow.mutex);
+    module.shadow.depth++;
+    mutex_unlock(&module.shadow.mutex);
+#endif
+
+    return (0);
+}
+
+int settings_commit(void)
+{
+    int res;
+
+    res = 0;
+
+#if CONFIG_SETTINGS_SHADOW == 1
+    mutex_lock(&module.shadow.mutex);
+
+    if (module.shadow.depth == 0) {
+        res = -EINVAL;
+    } else {
+        module.shadow.depth--;
+
+        if (module.shadow.depth == 0) {
+            res = shadow_commit();
+        }
+    }
+
+    mutex_unlock(&module.shadow.mutex);
+#endif
+
+    return (res);
 }
 
 int settings_reset(size_t address, size_t size)
@@ -548,3 +852,12 @@ int settings_reset_all()
 {
     return (reset(0, sizeof(settings_default)));
 }
+
+int settings_get_stats(struct settings_stats_t *stats_p)
+{
+    ASSERTN(stats_p != NULL, EINVAL);
+
+    *stats_p = module.stats;
+
+    return (0);
+}
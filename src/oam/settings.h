@@ -49,6 +49,23 @@ struct setting_t {
     size_t size;
 };
 
+/**
+ * Settings write statistics. The number of non-volatile memory writes
+ * saved by the RAM shadow is the number of unchanged writes plus the
+ * number of coalesced writes.
+ */
+struct settings_stats_t {
+    /* Number of settings writes, including resets. */
+    uint32_t number_of_writes;
+    /* Number of non-volatile memory writes. */
+    uint32_t number_of_nvm_writes;
+    /* Number of writes skipped as the value was unchanged. */
+    uint32_t number_of_unchanged_writes;
+    /* Number of writes merged with other writes into a single
+       non-volatile memory write. */
+    uint32_t number_of_coalesced_writes;
+};
+
 /**
  * Initialize the settings module. This function must be called before
  * calling any other function in this module.
@@ -82,6 +99,29 @@ ssize_t settings_read(void *dst_p, size_t src, size_t size);
  */
 ssize_t settings_write(size_t dst, const void *src_p, size_t size);
 
+/**
+ * Start a batch of settings writes. With the RAM shadow enabled, see
+ * ``CONFIG_SETTINGS_SHADOW``, written values are kept in RAM until
+ * the batch is ended by settings_commit(), and then written to the
+ * non-volatile memory in a single call to nvm_vwrite(). Batches may
+ * be nested, and writes by other threads during a batch are part of
+ * the batch.
+ *
+ * Settings are written immediately if the RAM shadow is disabled.
+ *
+ * @return zero(0) or negative error code.
+ */
+int settings_begin(void);
+
+/**
+ * End a batch of settings writes started by settings_begin(). The
+ * modified settings are written to the non-volatile memory when the
+ * outermost batch ends.
+ *
+ * @return zero(0) or negative error code.
+ */
+int settings_commit(void);
+
 /**
  * Reset given setting to its default value.
  *
@@ -136,4 +176,13 @@ int settings_reset_by_name(const char *name_p,
  */
 int settings_reset_all(void);
 
+/**
+ * Get the settings write statistics.
+ *
+ * @param[out] stats_p Current statistics.
+ *
+ * @return zero(0) or negative error code.
+ */
+int settings_get_stats(struct settings_stats_t *stats_p);
+
 #endif
@@ -90,6 +90,7 @@ typedef intptr_t longptr_t;
 #include "collections/list.h"
 #include "collections/hash_map.h"
 #include "collections/circular_buffer.h"
+#include "collections/spsc_ring.h"
 
 #include "kernel/time.h"
 
@@ -99,14 +100,18 @@ typedef intptr_t longptr_t;
 #include "kernel/sys.h"
 #include "kernel/timer.h"
 #include "kernel/thrd.h"
+#include "kernel/thrd_pool.h"
 
 #include "sync/mutex.h"
 #include "sync/cond.h"
 #include "sync/queue.h"
+#include "sync/spsc_queue.h"
 #include "sync/event.h"
 #include "sync/rwlock.h"
 #include "sync/bus.h"
 
+#include "kernel/task.h"
+
 #include "alloc/heap.h"
 #include "alloc/circular_heap.h"
 
@@ -136,6 +141,7 @@ typedef intptr_t longptr_t;
 
 #include "hash/crc.h"
 #include "hash/sha1.h"
+#include "hash/sha256.h"
 
 #include "inet/types.h"
 #include "inet/inet.h"
@@ -173,6 +179,7 @@ typedef intptr_t longptr_t;
 #ifdef PORT_HAS_SD
 #    include "drivers/storage/sd.h"
 #endif
+#include "drivers/storage/block_device.h"
 #ifdef PORT_HAS_DS18B20
 #    include "drivers/sensors/ds18b20.h"
 #endif
@@ -293,6 +300,7 @@ typedef intptr_t longptr_t;
 
 #include "inet/slip.h"
 #include "inet/http_server.h"
+#include "inet/http_websocket.h"
 #include "inet/http_websocket_server.h"
 #include "inet/http_websocket_client.h"
 #include "inet/tftp_server.h"
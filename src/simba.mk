@@ -33,7 +33,7 @@ ifeq ($(TYPE),suite)
   INC += $(SIMBA_ROOT)/tst/stubs
 
   ALLOC_SRC += heap.c
-  COLLECTIONS_SRC += circular_buffer.c binary_tree.c list.c
+  COLLECTIONS_SRC += circular_buffer.c binary_tree.c list.c spsc_ring.c
   DEBUG_SRC += log.c harness.c
   DRIVERS_SRC += storage/flash.c network/uart.c
   ENCODE_SRC +=
@@ -45,7 +45,8 @@ ifeq ($(TYPE),suite)
   OAM_SRC += console.c settings.c nvm.c
   FILESYSTEMS_SRC += fs.c
   SPIFFS_SRC +=
-  SYNC_SRC += chan.c queue.c rwlock.c sem.c mutex.c bus.c event.c
+  SYNC_SRC += chan.c queue.c rwlock.c sem.c mutex.c bus.c event.c \
+              spsc_queue.c
   TEXT_SRC += std.c
   SCIENCE_SRC +=
 
@@ -100,6 +101,7 @@ COLLECTIONS_SRC ?= \
 	bits.c \
 	circular_buffer.c \
 	hash_map.c \
+	spsc_ring.c \
 	list.c
 
 SRC += $(COLLECTIONS_SRC:%=$(SIMBA_ROOT)/src/collections/%)
@@ -158,6 +160,7 @@ DRIVERS_SRC ?= \
 	sensors/ds18b20.c \
 	sensors/hx711.c \
 	sensors/sht3xd.c \
+	storage/block_device.c \
 	storage/eeprom_i2c.c \
 	storage/eeprom_soft.c \
 	storage/flash.c \
@@ -169,6 +172,7 @@ SRC += $(DRIVERS_SRC:%=$(SIMBA_ROOT)/src/drivers/%)
 
 ifeq ($(FAMILY),linux)
 SRC += $(SIMBA_ROOT)/src/drivers/ports/linux/socket_device.c
+SRC += $(SIMBA_ROOT)/src/drivers/ports/linux/file_block_device.c
 endif
 
 # Encode package.
@@ -182,7 +186,8 @@ SRC += $(ENCODE_SRC:%=$(SIMBA_ROOT)/src/encode/%)
 
 # Hash package.
 HASH_SRC ?= crc.c \
-	    sha1.c
+	    sha1.c \
+	    sha256.c
 
 SRC += $(HASH_SRC:%=$(SIMBA_ROOT)/src/hash/%)
 
@@ -196,6 +201,7 @@ INC += $(SIMBA_ROOT)/3pp/mbedtls/include
 
 INET_SRC_TMP = \
 	http_server.c \
+	http_websocket.c \
 	http_websocket_server.c \
 	http_websocket_client.c \
 	inet.c \
@@ -332,7 +338,9 @@ INC += $(SIMBA_ROOT)/src/kernel/ports/$(ARCH)/$(TOOLCHAIN)
 KERNEL_SRC_TMP = \
 	errno.c \
 	sys.c \
+	task.c \
 	thrd.c \
+	thrd_pool.c \
 	time.c \
 	timer.c
 
@@ -411,7 +419,8 @@ SYNC_SRC ?= bus.c \
 	    mutex.c \
 	    queue.c \
 	    rwlock.c \
-	    sem.c
+	    sem.c \
+	    spsc_queue.c
 
 SRC += $(SYNC_SRC:%=$(SIMBA_ROOT)/src/sync/%)
 
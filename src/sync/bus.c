@@ -28,6 +28,87 @@
 
 #include "simba.h"
 
+/**
+ * Returns the bucket of given message id.
+ */
+static struct bus_listener_t **get_bucket(struct bus_t *self_p, int id)
+{
+    uint32_t hash;
+
+    /* Mix the bits, as ids are often multiples of a power of two. */
+    hash = (uint32_t)id;
+    hash ^= (hash >> 16);
+    hash *= 0x45d9f3b;
+    hash ^= (hash >> 16);
+
+    return (&self_p->buckets_pp[hash & self_p->buckets_mask]);
+}
+
+/**
+ * Returns the first listener with given message id, or NULL if
+ * missing. Must be called with the rwlock taken.
+ */
+static struct bus_listener_t *find_first(struct bus_t *self_p, int id)
+{
+    struct bus_listener_t *curr_p;
+
+    if (self_p->buckets_pp == NULL) {
+        return ((struct bus_listener_t *)binary_tree_search(
+                    &self_p->listeners, id));
+    }
+
+    curr_p = *get_bucket(self_p, id);
+
+    while ((curr_p != NULL) && (curr_p->id != id)) {
+        curr_p = curr_p->next_p;
+    }
+
+    return (curr_p);
+}
+
+/**
+ * Returns the next listener with the same message id as given
+ * listener, or NULL if missing.
+ */
+static struct bus_listener_t *find_next(struct bus_t *self_p,
+                                        struct bus_listener_t *curr_p)
+{
+    int id;
+
+    id = curr_p->id;
+    curr_p = curr_p->next_p;
+
+    /* Listeners in a bucket may have different ids. */
+    if (self_p->buckets_pp != NULL) {
+        while ((curr_p != NULL) && (curr_p->id != id)) {
+            curr_p = curr_p->next_p;
+        }
+    }
+
+    return (curr_p);
+}
+
+static int detach_hash(struct bus_t *self_p,
+                       struct bus_listener_t *listener_p)
+{
+    struct bus_listener_t **curr_pp;
+
+    curr_pp = get_bucket(self_p, listener_p->id);
+
+    while (*curr_pp != NULL) {
+        if (*curr_pp == listener_p) {
+            *curr_pp = listener_p->next_p;
+            listener_p->next_p = NULL;
+
+            return (0);
+        }
+
+        curr_pp = &(*curr_pp)->next_p;
+    }
+
+    return (-1);
+}
+
 int bus_module_init()
 {
     return (0);
@@ -39,6 +120,30 @@ int bus_init(struct bus_t *self_p)
 
     binary_tree_init(&self_p->listeners);
     rwlock_init(&self_p->rwlock);
+    self_p->buckets_pp = NULL;
+    self_p->buckets_mask = 0;
+
+    return (0);
+}
+
+int bus_init_hash(struct bus_t *self_p,
+                  struct bus_listener_t **buckets_pp,
+                  int length)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buckets_pp != NULL, EINVAL);
+    ASSERTN((length > 0) && ((length & (length - 1)) == 0), EINVAL);
+
+    int i;
+
+    bus_init(self_p);
+
+    for (i = 0; i < length; i++) {
+        buckets_pp[i] = NULL;
+    }
+
+    self_p->buckets_pp = buckets_pp;
+    self_p->buckets_mask = (length - 1);
 
     return (0);
 }
@@ -66,11 +171,18 @@ int bus_attach(struct bus_t *self_p,
 
     struct bus_listener_t *head_p;
 
+    struct bus_listener_t **bucket_pp;
+
     rwlock_writer_take(&self_p->rwlock);
 
-    /* Try to insert the node into the tree. It fails if there already
-     * is a node with the same key (id).*/
-    if (binary_tree_insert(&self_p->listeners, &listener_p->base) != 0) {
+    if (self_p->buckets_pp != NULL) {
+        bucket_pp = get_bucket(self_p, listener_p->id);
+        listener_p->next_p = *bucket_pp;
+        *bucket_pp = listener_p;
+    } else if (binary_tree_insert(&self_p->listeners,
+                                  &listener_p->base) != 0) {
+        /* The node was not inserted into the tree as there already is
+           a node with the same key (id). */
         head_p = (struct bus_listener_t *)binary_tree_search(
             &self_p->listeners, listener_p->id);
 
@@ -94,6 +206,13 @@ int bus_detach(struct bus_t *self_p,
 
     rwlock_writer_take(&self_p->rwlock);
 
+    if (self_p->buckets_pp != NULL) {
+        res = detach_hash(self_p, listener_p);
+        rwlock_writer_give(&self_p->rwlock);
+
+        return (res);
+    }
+
     head_p = (struct bus_listener_t *)binary_tree_search(
         &self_p->listeners, listener_p->id);
 
@@ -142,8 +261,7 @@ int bus_write(struct bus_t *self_p,
 
     rwlock_reader_take(&self_p->rwlock);
 
-    curr_p = (struct bus_listener_t *)binary_tree_search(
-        &self_p->listeners, id);
+    curr_p = find_first(self_p, id);
     number_of_receivers = 0;
 
     while (curr_p != NULL) {
@@ -151,10 +269,73 @@ int bus_write(struct bus_t *self_p,
                                                  buf_p,
                                                  size);
         number_of_receivers++;
-        curr_p = curr_p->next_p;
+        curr_p = find_next(self_p, curr_p);
     }
 
     rwlock_reader_give(&self_p->rwlock);
 
     return (number_of_receivers);
 }
+
+int bus_write_zero_copy(struct bus_t *self_p,
+                        int id,
+                        struct heap_t *heap_p,
+                        void *buf_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(heap_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    int number_of_receivers;
+    int res;
+    ssize_t size;
+    struct bus_listener_t *curr_p;
+
+    rwlock_reader_take(&self_p->rwlock);
+
+    /* Share the buffer once per listener before any listener can
+       free it. The reference of the caller is passed to the first
+       listener. */
+    curr_p = find_first(self_p, id);
+    number_of_receivers = 0;
+
+    while (curr_p != NULL) {
+        number_of_receivers++;
+        curr_p = find_next(self_p, curr_p);
+    }
+
+    if (number_of_receivers == 0) {
+        heap_free(heap_p, buf_p);
+    } else if (number_of_receivers > 1) {
+        heap_share(heap_p, buf_p, number_of_receivers - 1);
+    }
+
+    curr_p = find_first(self_p, id);
+    res = 0;
+
+    while (curr_p != NULL) {
+        size = ((struct chan_t *)curr_p->chan_p)->write(curr_p->chan_p,
+                                                        &buf_p,
+                                                        sizeof(buf_p));
+
+        /* Drop the reference of the listener and remember the first
+           error. The other listeners still receive the buffer. */
+        if (size != sizeof(buf_p)) {
+            heap_free(heap_p, buf_p);
+
+            if (res == 0) {
+                res = (size < 0 ? size : -EIO);
+            }
+        }
+
+        curr_p = find_next(self_p, curr_p);
+    }
+
+    rwlock_reader_give(&self_p->rwlock);
+
+    if (res != 0) {
+        return (res);
+    }
+
+    return (number_of_receivers);
+}
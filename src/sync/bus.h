@@ -31,9 +31,15 @@
 
 #include "simba.h"
 
+struct heap_t;
+
 struct bus_t {
     struct rwlock_t rwlock;
     struct binary_tree_t listeners;
+    /* Hash index of listeners, or NULL if the listeners are in the
+       binary tree. */
+    struct bus_listener_t **buckets_pp;
+    int buckets_mask;
 };
 
 struct bus_listener_t {
@@ -63,6 +69,24 @@ int bus_module_init(void);
  */
 int bus_init(struct bus_t *self_p);
 
+/**
+ * Initialize given bus with a hash index of listeners instead of a
+ * binary tree. Finding the listeners of a message id is then a hash
+ * and a walk of a short list, instead of a tree search.
+ *
+ * Listeners of ids with the same hash share a bucket, so use at least
+ * as many buckets as there are ids in use.
+ *
+ * @param[in] self_p Bus to initialize.
+ * @param[in] buckets_pp Array of buckets.
+ * @param[in] length Number of buckets. Must be a power of two.
+ *
+ * @return zero(0) or negative error code.
+ */
+int bus_init_hash(struct bus_t *self_p,
+                  struct bus_listener_t **buckets_pp,
+                  int length);
+
 /**
  * Initialize given listener to receive messages with given id, after
  * the listener is attached to the bus. A listener can only receive
@@ -122,4 +146,30 @@ int bus_write(struct bus_t *self_p,
               const void *buf_p,
               size_t size);
 
+/**
+ * Write given heap buffer to given bus without copying it. A pointer
+ * to the buffer is written to all listeners with given message id,
+ * and the buffer is shared once per listener with `heap_share()`.
+ *
+ * The reference of the caller is passed to the bus, so the caller
+ * must not use the buffer after this call. Each listener reads the
+ * buffer pointer from its channel and calls `heap_free()` when done
+ * with the buffer. The buffer is freed when the last listener has
+ * freed it, or by this function if there are no listeners.
+ *
+ * @param[in] self_p Bus to write the message to.
+ * @param[in] id Message identity.
+ * @param[in] heap_p Heap the buffer was allocated from.
+ * @param[in] buf_p Buffer allocated with `heap_alloc()`.
+ *
+ * @return Number of listeners that received the message, or the
+ *         negative error code of the first failed channel write. The
+ *         reference of a listener whose channel write failed is
+ *         freed, and the other listeners still receive the buffer.
+ */
+int bus_write_zero_copy(struct bus_t *self_p,
+                        int id,
+                        struct heap_t *heap_p,
+                        void *buf_p);
+
 #endif
@@ -312,6 +312,22 @@ void *chan_list_poll(struct chan_list_t *self_p,
             chan_p->list_p = self_p;
         }
 
+        /* Channels written to without the system lock check for a
+           reader after writing, so check once more for data written
+           before the reader was added. */
+        ATOMIC_FENCE();
+
+        for (i = 0; i < self_p->len; i++) {
+            chan_p = self_p->elements_p[i].chan_p;
+
+            if (chan_p->size(chan_p) > 0) {
+                chan_is_polled_isr(chan_p);
+                chan_p->reader_p = NULL;
+
+                goto out;
+            }
+        }
+
         /* No data was available, wait for data to be written to one
            of the channels. */
         if (thrd_suspend_isr(timeout_p) == -ETIMEDOUT) {
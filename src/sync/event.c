@@ -43,6 +43,47 @@ int event_init(struct event_t *self_p)
     return (0);
 }
 
+/**
+ * Remove given events from the event channel.
+ *
+ * @return The removed events that were set.
+ */
+static uint32_t take_isr(struct event_t *self_p, uint32_t mask)
+{
+    uint32_t value;
+
+    value = ATOMIC_LOAD_ISR(&self_p->mask);
+
+    while (!ATOMIC_CAS_ISR(&self_p->mask, &value, value & ~mask));
+
+    return (value & mask);
+}
+
+#if ATOMIC_LOCK_FREE == 1
+
+/**
+ * Remove given events from the event channel without the system lock
+ * if any of them are set.
+ *
+ * @return The removed events, or zero(0) if none was set.
+ */
+static uint32_t take_fast(struct event_t *self_p, uint32_t mask)
+{
+    uint32_t value;
+
+    value = ATOMIC_LOAD(&self_p->mask);
+
+    while ((value & mask) != 0) {
+        if (ATOMIC_CAS(&self_p->mask, &value, value & ~mask)) {
+            return (value & mask);
+        }
+    }
+
+    return (0);
+}
+
+#endif
+
 ssize_t event_read(struct event_t *self_p,
                    void *buf_p,
                    size_t size)
@@ -55,22 +96,34 @@ ssize_t event_read(struct event_t *self_p,
 
     mask_p = (uint32_t *)buf_p;
 
+#if ATOMIC_LOCK_FREE == 1
+    mask = take_fast(self_p, *mask_p);
+
+    if (mask != 0) {
+        *mask_p = mask;
+
+        return (size);
+    }
+#endif
+
     sys_lock();
 
-    mask = (self_p->mask & *mask_p);
+    self_p->reader_mask = *mask_p;
+    self_p->base.reader_p = thrd_self();
+
+    /* Pairs with the fence in event_write(). Events written before
+       the reader was added are found here. */
+    ATOMIC_FENCE();
+    mask = take_isr(self_p, *mask_p);
 
-    /* Event already set? Otherwise wait for it. */
     if (mask != 0) {
-        *mask_p = mask;
+        self_p->base.reader_p = NULL;
     } else {
-        self_p->reader_mask = *mask_p;
-        self_p->base.reader_p = thrd_self();
         thrd_suspend_isr(NULL);
-        *mask_p = (self_p->mask & *mask_p);
+        mask = take_isr(self_p, *mask_p);
     }
 
-    /* Remove read events from the event channel. */
-    self_p->mask &= (~(*mask_p));
+    *mask_p = mask;
 
     sys_unlock();
 
@@ -90,27 +143,45 @@ ssize_t event_try_read(struct event_t *self_p,
 
     mask_p = (uint32_t *)buf_p;
 
+#if ATOMIC_LOCK_FREE == 1
+    mask = take_fast(self_p, *mask_p);
+#else
     sys_lock();
-
-    mask = (self_p->mask & *mask_p);
+    mask = take_isr(self_p, *mask_p);
+    sys_unlock();
+#endif
 
     /* Event set? Otherwise return -EAGAIN. */
     if (mask != 0) {
         res = size;
-        *mask_p = mask;
-
-        /* Remove read events from the event channel. */
-        self_p->mask &= (~(*mask_p));
     } else {
-        *mask_p = 0;
         res = -EAGAIN;
     }
 
-    sys_unlock();
+    *mask_p = mask;
 
     return (res);
 }
 
+/**
+ * Resume the reader if polling, or if waiting for any of the set
+ * events. The events must already be set.
+ */
+static void resume_reader_isr(struct event_t *self_p)
+{
+    if (chan_is_polled_isr(&self_p->base)) {
+        thrd_resume_isr(self_p->base.reader_p, 0);
+        self_p->base.reader_p = NULL;
+    }
+
+    /* Resume reader thread waiting for given event(s). */
+    if ((self_p->base.reader_p != NULL)
+        && ((self_p->reader_mask & ATOMIC_LOAD_ISR(&self_p->mask)) != 0))  {
+        thrd_resume_isr(self_p->base.reader_p, 0);
+        self_p->base.reader_p = NULL;
+    }
+}
+
 ssize_t event_write(struct event_t *self_p,
                     const void *buf_p,
                     size_t size)
@@ -119,9 +190,31 @@ ssize_t event_write(struct event_t *self_p,
     ASSERTN(buf_p != NULL, EINVAL);
     ASSERTN(size == sizeof(uint32_t), EINVAL);
 
+#if ATOMIC_LOCK_FREE == 1
+    uint32_t value;
+
+    /* Fast path. Set the events without the system lock and only
+       take it if there is a reader to resume. */
+    value = ATOMIC_LOAD(&self_p->mask);
+
+    while (!ATOMIC_CAS(&self_p->mask, &value, value | *(uint32_t *)buf_p));
+
+    ATOMIC_FENCE();
+
+    if (ATOMIC_LOAD(&self_p->base.reader_p) == NULL) {
+        return (size);
+    }
+
+    /* The events are already set, and may have been taken since, so
+       only resume the reader. */
+    sys_lock();
+    resume_reader_isr(self_p);
+    sys_unlock();
+#else
     sys_lock();
     size = event_write_isr(self_p, buf_p, size);
     sys_unlock();
+#endif
 
     return (size);
 }
@@ -130,19 +223,13 @@ ssize_t event_write_isr(struct event_t *self_p,
                         const void *buf_p,
                         size_t size)
 {
-    if (chan_is_polled_isr(&self_p->base)) {
-        thrd_resume_isr(self_p->base.reader_p, 0);
-        self_p->base.reader_p = NULL;
-    }
+    uint32_t value;
 
-    self_p->mask |= *(uint32_t *)buf_p;
+    value = ATOMIC_LOAD_ISR(&self_p->mask);
 
-    /* Resume reader thread waiting for given event(s). */
-    if ((self_p->base.reader_p != NULL)
-        && ((self_p->reader_mask & self_p->mask) != 0))  {
-        thrd_resume_isr(self_p->base.reader_p, 0);
-        self_p->base.reader_p = NULL;
-    }
+    while (!ATOMIC_CAS_ISR(&self_p->mask, &value, value | *(uint32_t *)buf_p));
+
+    resume_reader_isr(self_p);
 
     return (size);
 }
@@ -151,16 +238,20 @@ ssize_t event_size(struct event_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    return (self_p->mask != 0);
+    return (ATOMIC_LOAD_ISR(&self_p->mask) != 0);
 }
 
 int event_clear(struct event_t *self_p, uint32_t mask)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
+#if ATOMIC_LOCK_FREE == 1
+    take_fast(self_p, mask);
+#else
     sys_lock();
-    self_p->mask &= ~mask;
+    take_isr(self_p, mask);
     sys_unlock();
+#endif
 
     return (0);
 }
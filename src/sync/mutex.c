@@ -28,15 +28,175 @@
 
 #include "simba.h"
 
+/* Mutex lock states. The fast paths only lock unlocked mutexes and
+   unlock mutexes without waiters. */
+#define MUTEX_STATE_UNLOCKED                                0
+#define MUTEX_STATE_LOCKED                                  1
+#define MUTEX_STATE_WAITERS                                 2
+
+/* The contention statistics are only updated with the system lock
+   taken. */
+#if (ATOMIC_LOCK_FREE == 1) && (CONFIG_THRD_CONTENTION == 0)
+#    define FAST_PATH                                       1
+#else
+#    define FAST_PATH                                       0
+#endif
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+
+/**
+ * Make given thread the owner of given mutex. The mutex is added to
+ * the owner's list of held mutexes by link_owner() once there are
+ * threads waiting for it.
+ */
+static void set_owner(struct mutex_t *self_p, struct thrd_t *thrd_p)
+{
+    ATOMIC_STORE_ISR(&self_p->owner_p, thrd_p);
+    self_p->next_p = NULL;
+}
+
+/**
+ * Add given mutex to its owner's list of held mutexes, unless already
+ * added or the owner is not yet known.
+ */
+static void link_owner(struct mutex_t *self_p)
+{
+    struct thrd_t *owner_p;
+    struct mutex_t *mutex_p;
+
+    owner_p = ATOMIC_LOAD_ISR(&self_p->owner_p);
+
+    if (owner_p == NULL) {
+        return;
+    }
+
+    mutex_p = owner_p->inheritance.mutexes_p;
+
+    while (mutex_p != NULL) {
+        if (mutex_p == self_p) {
+            return;
+        }
+
+        mutex_p = mutex_p->next_p;
+    }
+
+    self_p->next_p = owner_p->inheritance.mutexes_p;
+    owner_p->inheritance.mutexes_p = self_p;
+}
+
+/**
+ * Remove given mutex from its owner's list of held mutexes.
+ */
+static void clear_owner(struct mutex_t *self_p)
+{
+    struct mutex_t **mutex_pp;
+
+    mutex_pp = &self_p->owner_p->inheritance.mutexes_p;
+
+    while (*mutex_pp != NULL) {
+        if (*mutex_pp == self_p) {
+            *mutex_pp = self_p->next_p;
+            break;
+        }
+
+        mutex_pp = &(*mutex_pp)->next_p;
+    }
+
+    ATOMIC_STORE_ISR(&self_p->owner_p, NULL);
+    self_p->next_p = NULL;
+}
+
+/**
+ * Set the priority of given thread to its own priority, or the
+ * priority of the highest priority thread waiting for any of its
+ * mutexes, whichever is higher.
+ */
+static void restore_prio(struct thrd_t *thrd_p)
+{
+    struct mutex_t *mutex_p;
+    struct thrd_prio_list_elem_t *elem_p;
+    int prio;
+
+    prio = thrd_p->inheritance.prio;
+    mutex_p = thrd_p->inheritance.mutexes_p;
+
+    while (mutex_p != NULL) {
+        /* The waiter with the highest priority is first. */
+        elem_p = mutex_p->waiters.head_p;
+
+        if ((elem_p != NULL) && (elem_p->thrd_p->prio < prio)) {
+            prio = elem_p->thrd_p->prio;
+        }
+
+        mutex_p = mutex_p->next_p;
+    }
+
+    if (prio != thrd_p->prio) {
+        thrd_set_prio_isr(thrd_p, prio);
+    }
+}
+
+/**
+ * Raise the priority of the owner of given mutex to given priority,
+ * and continue with the mutex the owner is waiting for, if any.
+ */
+static void inherit_prio(struct mutex_t *self_p, int prio)
+{
+    struct thrd_t *owner_p;
+    struct thrd_prio_list_elem_t *elem_p;
+
+    while (self_p != NULL) {
+        owner_p = self_p->owner_p;
+
+        if ((owner_p == NULL) || (owner_p->prio <= prio)) {
+            break;
+        }
+
+        thrd_set_prio_isr(owner_p, prio);
+        self_p = owner_p->inheritance.waiting_for_p;
+
+        if (self_p == NULL) {
+            break;
+        }
+
+        /* Move the owner to its new position in the wait list. */
+        elem_p = self_p->waiters.head_p;
+
+        while (elem_p != NULL) {
+            if (elem_p->thrd_p == owner_p) {
+                thrd_prio_list_remove_isr(&self_p->waiters, elem_p);
+                thrd_prio_list_push_isr(&self_p->waiters, elem_p);
+                break;
+            }
+
+            elem_p = elem_p->next_p;
+        }
+    }
+}
+
+#endif
+
 int mutex_module_init(void)
 {
     return (0);
 }
 
 int mutex_init(struct mutex_t *self_p)
+{
+    return (mutex_init_named(self_p, NULL));
+}
+
+int mutex_init_named(struct mutex_t *self_p, const char *name_p)
 {
     self_p->is_locked = 0;
     thrd_prio_list_init(&self_p->waiters);
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    self_p->owner_p = NULL;
+    self_p->next_p = NULL;
+#endif
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_contention_init(&self_p->contention, "mutex", name_p);
+#endif
 
     return (0);
 }
@@ -45,6 +205,31 @@ int mutex_lock(struct mutex_t *self_p)
 {
     int res;
 
+#if FAST_PATH == 1
+    int state;
+
+    /* Fast path. Lock an unlocked mutex without the system lock. */
+    state = MUTEX_STATE_UNLOCKED;
+
+    if (ATOMIC_CAS(&self_p->is_locked, &state, MUTEX_STATE_LOCKED)) {
+#    if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+        /* A thread that started waiting before the owner was
+           published could not pass on its priority. Do it now. */
+        ATOMIC_STORE(&self_p->owner_p, thrd_self());
+        ATOMIC_FENCE();
+
+        if (ATOMIC_LOAD(&self_p->is_locked) == MUTEX_STATE_WAITERS) {
+            sys_lock();
+            link_owner(self_p);
+            restore_prio(thrd_self());
+            sys_unlock();
+        }
+#    endif
+
+        return (0);
+    }
+#endif
+
     sys_lock();
     res = mutex_lock_isr(self_p);
     sys_unlock();
@@ -56,8 +241,40 @@ int mutex_unlock(struct mutex_t *self_p)
 {
     int res;
 
+#if FAST_PATH == 1
+    int state;
+
+    /* Fast path. Unlock a mutex no thread is waiting for without the
+       system lock. */
+    state = MUTEX_STATE_LOCKED;
+
+#    if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    /* The owner must be cleared before the mutex is unlocked, as
+       another thread may lock it immediately after. */
+    ATOMIC_STORE(&self_p->owner_p, NULL);
+#    endif
+
+    if (ATOMIC_CAS(&self_p->is_locked, &state, MUTEX_STATE_UNLOCKED)) {
+        return (0);
+    }
+
+#    if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    ATOMIC_STORE(&self_p->owner_p, thrd_self());
+#    endif
+#endif
+
     sys_lock();
     res = mutex_unlock_isr(self_p);
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    /* Let the new owner run at once if it has higher priority than
+       the calling thread's restored priority. */
+    if ((self_p->owner_p != NULL)
+        && (self_p->owner_p->prio < thrd_self()->prio)) {
+        thrd_yield_isr();
+    }
+#endif
+
     sys_unlock();
 
     return (res);
@@ -66,13 +283,49 @@ int mutex_unlock(struct mutex_t *self_p)
 int mutex_lock_isr(struct mutex_t *self_p)
 {
     struct thrd_prio_list_elem_t elem;
+    int state;
+#if CONFIG_THRD_CONTENTION == 1
+    uint32_t start_us;
+#endif
 
-    if (self_p->is_locked == 1) {
-        elem.thrd_p = thrd_self();
-        thrd_prio_list_push_isr(&self_p->waiters, &elem);
-        thrd_suspend_isr(NULL);
-    } else {
-        self_p->is_locked = 1;
+    state = ATOMIC_LOAD_ISR(&self_p->is_locked);
+
+    while (1) {
+        if (state == MUTEX_STATE_UNLOCKED) {
+            if (ATOMIC_CAS_ISR(&self_p->is_locked,
+                               &state,
+                               MUTEX_STATE_LOCKED)) {
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+                set_owner(self_p, thrd_self());
+#endif
+#if CONFIG_THRD_CONTENTION == 1
+                thrd_contention_hold_begin_isr(&self_p->contention);
+#endif
+                break;
+            }
+        } else if ((state == MUTEX_STATE_WAITERS)
+                   || ATOMIC_CAS_ISR(&self_p->is_locked,
+                                     &state,
+                                     MUTEX_STATE_WAITERS)) {
+            elem.thrd_p = thrd_self();
+            thrd_prio_list_push_isr(&self_p->waiters, &elem);
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+            /* Pairs with the fence in the lock fast path. */
+            ATOMIC_FENCE();
+            elem.thrd_p->inheritance.waiting_for_p = self_p;
+            link_owner(self_p);
+            inherit_prio(self_p, elem.thrd_p->prio);
+#endif
+            /* The mutex is handed over by the unlocking thread. */
+#if CONFIG_THRD_CONTENTION == 1
+            start_us = thrd_contention_wait_begin_isr(&self_p->contention);
+#endif
+            thrd_suspend_isr(NULL);
+#if CONFIG_THRD_CONTENTION == 1
+            thrd_contention_wait_end_isr(&self_p->contention, start_us);
+#endif
+            break;
+        }
     }
 
     return (0);
@@ -81,14 +334,54 @@ int mutex_lock_isr(struct mutex_t *self_p)
 int mutex_unlock_isr(struct mutex_t *self_p)
 {
     struct thrd_prio_list_elem_t *elem_p;
+    int state;
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    struct thrd_t *owner_p;
+
+    owner_p = self_p->owner_p;
+
+    if (owner_p != NULL) {
+        clear_owner(self_p);
+    }
+#endif
+
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_contention_hold_end_isr(&self_p->contention);
+#endif
 
     elem_p = thrd_prio_list_pop_isr(&self_p->waiters);
 
     if (elem_p != NULL) {
+        if (self_p->waiters.head_p != NULL) {
+            state = MUTEX_STATE_WAITERS;
+        } else {
+            state = MUTEX_STATE_LOCKED;
+        }
+
+        ATOMIC_STORE_ISR(&self_p->is_locked, state);
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+        elem_p->thrd_p->inheritance.waiting_for_p = NULL;
+        set_owner(self_p, elem_p->thrd_p);
+
+        if (state == MUTEX_STATE_WAITERS) {
+            link_owner(self_p);
+        }
+
+        restore_prio(elem_p->thrd_p);
+#endif
+#if CONFIG_THRD_CONTENTION == 1
+        thrd_contention_hold_begin_isr(&self_p->contention);
+#endif
         thrd_resume_isr(elem_p->thrd_p, 0);
     } else {
-        self_p->is_locked = 0;
+        ATOMIC_STORE_ISR(&self_p->is_locked, MUTEX_STATE_UNLOCKED);
+    }
+
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    if (owner_p != NULL) {
+        restore_prio(owner_p);
     }
+#endif
 
     return (0);
 }
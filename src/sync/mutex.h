@@ -32,10 +32,20 @@
 #include "simba.h"
 
 struct mutex_t {
-    /** Mutex lock state. */
-    int8_t is_locked;
+    /** Mutex lock state. Zero(0) if unlocked, one(1) if locked and
+        two(2) if locked with threads waiting for it. */
+    int is_locked;
     /** Wait list. */
     struct thrd_prio_list_t waiters;
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+    /** Thread holding the mutex. */
+    struct thrd_t *owner_p;
+    /** Next mutex held by the owner. */
+    struct mutex_t *next_p;
+#endif
+#if CONFIG_THRD_CONTENTION == 1
+    struct thrd_contention_t contention;
+#endif
 };
 
 /**
@@ -58,9 +68,27 @@ int mutex_module_init(void);
  */
 int mutex_init(struct mutex_t *self_p);
 
+/**
+ * Initialize given mutex object with given name. The mutex is listed
+ * by the file system command ``/kernel/thrd/contention`` if
+ * ``CONFIG_THRD_CONTENTION`` is set, and must not be freed. The name
+ * is ignored otherwise.
+ *
+ * @param[in] self_p Mutex to initialize.
+ * @param[in] name_p Mutex name.
+ *
+ * @return zero(0) or negative error code.
+ */
+int mutex_init_named(struct mutex_t *self_p, const char *name_p);
+
 /**
  * Lock given mutex.
  *
+ * If ``CONFIG_MUTEX_PRIORITY_INHERITANCE`` is set and the mutex is
+ * locked by a lower priority thread, the owner inherits the priority
+ * of the calling thread until it unlocks the mutex. The priority is
+ * passed on to the owner of any mutex the owner is waiting for.
+ *
  * @param[in] self_p Mutex to lock.
  *
  * @return zero(0) or negative error code.
@@ -309,6 +309,122 @@ RAM_CODE ssize_t queue_write_isr(struct queue_t *self_p,
     return (size - left);
 }
 
+ssize_t queue_reserve(struct queue_t *self_p,
+                      void **buf_pp,
+                      size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    ssize_t res;
+
+    sys_lock();
+    res = queue_reserve_isr(self_p, buf_pp, size);
+    sys_unlock();
+
+    return (res);
+}
+
+RAM_CODE ssize_t queue_reserve_isr(struct queue_t *self_p,
+                                   void **buf_pp,
+                                   size_t size)
+{
+    /* Write is not possible to a stopped queue. */
+    if (self_p->state == QUEUE_STATE_STOPPED) {
+        return (-1);
+    }
+
+    /* Blocked writers' data must be read first. */
+    if ((self_p->buf_p == NULL) || (self_p->writer_p != NULL)) {
+        return (0);
+    }
+
+    return (circular_buffer_unused_array(&self_p->buffer, buf_pp, size));
+}
+
+ssize_t queue_commit(struct queue_t *self_p,
+                     size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    ssize_t res;
+
+    sys_lock();
+    res = queue_commit_isr(self_p, size);
+    sys_unlock();
+
+    return (res);
+}
+
+RAM_CODE ssize_t queue_commit_isr(struct queue_t *self_p,
+                                  size_t size)
+{
+    size_t n;
+
+    /* Commit is not possible to a stopped queue. */
+    if (self_p->state == QUEUE_STATE_STOPPED) {
+        return (-1);
+    }
+
+    if (self_p->buf_p == NULL) {
+        return (0);
+    }
+
+    size = circular_buffer_skip_back(&self_p->buffer, size);
+
+    /* Resume any polling thread. */
+    if (chan_is_polled_isr(&self_p->base)) {
+        thrd_resume_isr(self_p->base.reader_p, 0);
+        self_p->base.reader_p = NULL;
+    }
+
+    /* Move data to the reader, if one is present. */
+    if (self_p->base.reader_p != NULL) {
+        n = circular_buffer_read(&self_p->buffer,
+                                 self_p->reader.buf_p,
+                                 self_p->reader.left);
+        self_p->reader.buf_p += n;
+        self_p->reader.left -= n;
+
+        /* Read buffer full. */
+        if (self_p->reader.left == 0) {
+            /* Wake the reader. */
+            thrd_resume_isr(self_p->base.reader_p, self_p->reader.size);
+            self_p->base.reader_p = NULL;
+        }
+    }
+
+    return (size);
+}
+
+ssize_t queue_peek(struct queue_t *self_p,
+                   void **buf_pp,
+                   size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_pp != NULL, EINVAL);
+
+    ssize_t res;
+
+    res = 0;
+
+    sys_lock();
+
+    /* Data in the queue buffer is read before data in writers. */
+    if (self_p->buf_p != NULL) {
+        res = circular_buffer_array_one(&self_p->buffer, buf_pp, size);
+    }
+
+    if ((res == 0) && (self_p->writer_p != NULL)) {
+        res = MIN(size, self_p->writer_p->left);
+        *buf_pp = self_p->writer_p->buf_p;
+    }
+
+    sys_unlock();
+
+    return (res);
+}
+
 RAM_CODE ssize_t queue_size(struct queue_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
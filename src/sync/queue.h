@@ -176,6 +176,95 @@ ssize_t queue_write_isr(struct queue_t *self_p,
                         const void *buf_p,
                         size_t size);
 
+/**
+ * Reserve space in the queue buffer for the caller to write data
+ * into, instead of writing it with `queue_write()`. The reserved
+ * space is contiguous, so it may be smaller than asked for if the
+ * queue buffer wraps around. Call `queue_commit()` once the data has
+ * been written to the reserved space.
+ *
+ * Only one producer may use the reserve and commit functions of a
+ * queue. Nothing is reserved while threads are blocked in
+ * `queue_write()`, as data must be read in order.
+ *
+ * No other writer may write to the queue, with `queue_write()` or
+ * `queue_write_isr()`, between reserve and commit. Such data is
+ * written to the reserved space, and is overwritten by the reserving
+ * producer.
+ *
+ * @param[in] self_p Queue to reserve space in.
+ * @param[out] buf_pp Start of the reserved space. Only valid if the
+ *                    return value is greater than zero(0).
+ * @param[in] size Number of bytes to reserve.
+ *
+ * @return Number of bytes reserved or negative error code.
+ */
+ssize_t queue_reserve(struct queue_t *self_p,
+                      void **buf_pp,
+                      size_t size);
+
+/**
+ * Same as `queue_reserve()`, but from isr or with the system lock
+ * taken (see `sys_lock()`).
+ *
+ * @param[in] self_p Queue to reserve space in.
+ * @param[out] buf_pp Start of the reserved space.
+ * @param[in] size Number of bytes to reserve.
+ *
+ * @return Number of bytes reserved or negative error code.
+ */
+ssize_t queue_reserve_isr(struct queue_t *self_p,
+                          void **buf_pp,
+                          size_t size);
+
+/**
+ * Add given number of bytes, written to space reserved with
+ * `queue_reserve()`, to the queue. A waiting reader is resumed the
+ * same way as by `queue_write()`.
+ *
+ * The queue must not have been written to since the space was
+ * reserved, see `queue_reserve()`.
+ *
+ * @param[in] self_p Queue to commit to.
+ * @param[in] size Number of bytes to commit.
+ *
+ * @return Number of bytes committed or negative error code.
+ */
+ssize_t queue_commit(struct queue_t *self_p,
+                     size_t size);
+
+/**
+ * Same as `queue_commit()`, but from isr or with the system lock
+ * taken (see `sys_lock()`).
+ *
+ * @param[in] self_p Queue to commit to.
+ * @param[in] size Number of bytes to commit.
+ *
+ * @return Number of bytes committed or negative error code.
+ */
+ssize_t queue_commit_isr(struct queue_t *self_p,
+                         size_t size);
+
+/**
+ * Get a pointer to the next bytes to read from the queue, without
+ * copying or removing them. The bytes are contiguous, so fewer bytes
+ * than stored in the queue may be returned if the queue buffer wraps
+ * around. Remove the bytes with `queue_ignore()` once done with
+ * them, and peek again for more.
+ *
+ * Only one consumer may peek at a queue.
+ *
+ * @param[in] self_p Queue to peek at.
+ * @param[out] buf_pp Start of the bytes. Only valid if the return
+ *                    value is greater than zero(0).
+ * @param[in] size Number of bytes asked for.
+ *
+ * @return Number of bytes or negative error code.
+ */
+ssize_t queue_peek(struct queue_t *self_p,
+                   void **buf_pp,
+                   size_t size);
+
 /**
  * Get the number of bytes currently stored in the queue. May return
  * less bytes than number of bytes stored in the channel.
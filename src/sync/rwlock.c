@@ -28,25 +28,77 @@
 
 #include "simba.h"
 
+/* Set in the state when a writer holds or waits for the lock. The
+   remaining bits are the number of readers holding the lock. */
+#define WRITER                    (1 << (8 * sizeof(int) - 2))
+
+/* The contention statistics are only updated with the system lock
+   taken. */
+#if (ATOMIC_LOCK_FREE == 1) && (CONFIG_THRD_CONTENTION == 0)
+#    define FAST_PATH                                       1
+#else
+#    define FAST_PATH                                       0
+#endif
+
 struct rwlock_elem_t {
     struct thrd_t *thrd_p;
     volatile struct rwlock_elem_t *next_p;
-    volatile struct rwlock_elem_t *prev_p;
 };
 
+/**
+ * Hand over the lock to the first waiting writer.
+ */
+static void resume_writer_isr(struct rwlock_t *self_p)
+{
+    volatile struct rwlock_elem_t *elem_p;
+
+    elem_p = self_p->writers_p;
+    self_p->writers_p = elem_p->next_p;
+    thrd_resume_isr(elem_p->thrd_p, 0);
+}
+
+/**
+ * Set the writer bit in the state to given value, and add given
+ * number of readers.
+ */
+static void update_state_isr(struct rwlock_t *self_p,
+                             int writer,
+                             int number_of_readers)
+{
+    int value;
+    int new_value;
+
+    value = ATOMIC_LOAD_ISR(&self_p->state);
+
+    do {
+        new_value = ((value & ~WRITER) + number_of_readers);
+
+        if (writer) {
+            new_value |= WRITER;
+        }
+    } while (!ATOMIC_CAS_ISR(&self_p->state, &value, new_value));
+}
+
 int rwlock_module_init(void)
 {
     return (0);
 }
 
 int rwlock_init(struct rwlock_t *self_p)
+{
+    return (rwlock_init_named(self_p, NULL));
+}
+
+int rwlock_init_named(struct rwlock_t *self_p, const char *name_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    self_p->number_of_readers = 0;
-    self_p->number_of_writers = 0;
+    self_p->state = 0;
     self_p->readers_p = NULL;
     self_p->writers_p = NULL;
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_contention_init(&self_p->contention, "rwlock", name_p);
+#endif
 
     return (0);
 }
@@ -56,31 +108,78 @@ int rwlock_reader_take(struct rwlock_t *self_p)
     ASSERTN(self_p != NULL, EINVAL);
 
     struct rwlock_elem_t elem;
-    int res = 0;
+    int value;
+#if CONFIG_THRD_CONTENTION == 1
+    uint32_t start_us;
+#endif
+
+#if FAST_PATH == 1
+    /* Fast path. Take the lock without the system lock if no writer
+       holds or waits for it. */
+    value = ATOMIC_LOAD(&self_p->state);
+
+    while ((value & WRITER) == 0) {
+        if (ATOMIC_CAS(&self_p->state, &value, value + 1)) {
+            return (0);
+        }
+    }
+#endif
 
     sys_lock();
 
-    self_p->number_of_readers++;
-
-    /* Wait if the lock is taken by a writer. */
-    if (self_p->number_of_writers > 0) {
-        elem.thrd_p = thrd_self();
-        elem.next_p = self_p->readers_p;
-        elem.prev_p = NULL;
-        self_p->readers_p = &elem;
-
-        thrd_suspend_isr(NULL);
+    /* The writer bit is only changed with the system lock taken. */
+    value = ATOMIC_LOAD_ISR(&self_p->state);
+
+    while (1) {
+        if ((value & WRITER) == 0) {
+            if (ATOMIC_CAS_ISR(&self_p->state, &value, value + 1)) {
+#if CONFIG_THRD_CONTENTION == 1
+                if (value == 0) {
+                    thrd_contention_hold_begin_isr(&self_p->contention);
+                }
+#endif
+                break;
+            }
+        } else {
+            /* Wait for the writer. The reader is added to the number
+               of readers by the writer when resumed. */
+            elem.thrd_p = thrd_self();
+            elem.next_p = self_p->readers_p;
+            self_p->readers_p = &elem;
+#if CONFIG_THRD_CONTENTION == 1
+            start_us = thrd_contention_wait_begin_isr(&self_p->contention);
+#endif
+            thrd_suspend_isr(NULL);
+#if CONFIG_THRD_CONTENTION == 1
+            thrd_contention_wait_end_isr(&self_p->contention, start_us);
+#endif
+            break;
+        }
     }
 
     sys_unlock();
 
-    return (res);
+    return (0);
 }
 
 int rwlock_reader_give(struct rwlock_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
+#if FAST_PATH == 1
+    int value;
+
+    /* Fast path. Give the lock without the system lock if no writer
+       waits for it. */
+    value = ATOMIC_LOAD(&self_p->state);
+
+    while ((value & WRITER) == 0) {
+        if (ATOMIC_CAS(&self_p->state, &value, value - 1)) {
+            return (0);
+        }
+    }
+#endif
+
     sys_lock();
     rwlock_reader_give_isr(self_p);
     sys_unlock();
@@ -92,20 +191,21 @@ int rwlock_reader_give_isr(struct rwlock_t *self_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
 
-    volatile struct rwlock_elem_t *elem_p;
+    int value;
 
-    self_p->number_of_readers--;
+    value = ATOMIC_LOAD_ISR(&self_p->state);
 
-    if ((self_p->number_of_writers > 0)
-        && (self_p->number_of_readers == 0)) {
-        elem_p = self_p->writers_p;
-        self_p->writers_p = elem_p->next_p;
+    while (!ATOMIC_CAS_ISR(&self_p->state, &value, value - 1));
 
-        if (self_p->writers_p != NULL) {
-            self_p->writers_p->prev_p = NULL;
-        }
+#if CONFIG_THRD_CONTENTION == 1
+    if (value == 1) {
+        thrd_contention_hold_end_isr(&self_p->contention);
+    }
+#endif
 
-        thrd_resume_isr(elem_p->thrd_p, 0);
+    /* The last reader hands over the lock to a waiting writer. */
+    if (((value - 1) == WRITER) && (self_p->writers_p != NULL)) {
+        resume_writer_isr(self_p);
     }
 
     return (0);
@@ -116,26 +216,49 @@ int rwlock_writer_take(struct rwlock_t *self_p)
     ASSERTN(self_p != NULL, EINVAL);
 
     struct rwlock_elem_t elem;
-    int res = 0;
+    volatile struct rwlock_elem_t *volatile *elem_pp;
+    int value;
+#if CONFIG_THRD_CONTENTION == 1
+    uint32_t start_us;
+#endif
 
     sys_lock();
 
-    self_p->number_of_writers++;
+    /* Stop new readers from taking the lock. */
+    value = ATOMIC_LOAD_ISR(&self_p->state);
+
+    while (!ATOMIC_CAS_ISR(&self_p->state, &value, value | WRITER));
 
-    /* Wait if the lock is taken by a reader or another writer. */
-    if ((self_p->number_of_readers > 0)
-        || (self_p->number_of_writers > 1)) {
+#if CONFIG_THRD_CONTENTION == 1
+    if (value == 0) {
+        thrd_contention_hold_begin_isr(&self_p->contention);
+    }
+#endif
+
+    if (value != 0) {
+        /* Wait in first-in-first-out order for the readers and
+           writers before this writer. */
         elem.thrd_p = thrd_self();
-        elem.next_p = self_p->writers_p;
-        elem.prev_p = NULL;
-        self_p->writers_p = &elem;
+        elem.next_p = NULL;
+        elem_pp = &self_p->writers_p;
 
+        while (*elem_pp != NULL) {
+            elem_pp = &(*elem_pp)->next_p;
+        }
+
+        *elem_pp = &elem;
+#if CONFIG_THRD_CONTENTION == 1
+        start_us = thrd_contention_wait_begin_isr(&self_p->contention);
+#endif
         thrd_suspend_isr(NULL);
+#if CONFIG_THRD_CONTENTION == 1
+        thrd_contention_wait_end_isr(&self_p->contention, start_us);
+#endif
     }
 
     sys_unlock();
 
-    return (res);
+    return (0);
 }
 
 int rwlock_writer_give(struct rwlock_t *self_p)
@@ -152,32 +275,31 @@ int rwlock_writer_give(struct rwlock_t *self_p)
 int rwlock_writer_give_isr(struct rwlock_t *self_p)
 {
     volatile struct rwlock_elem_t *elem_p;
+    int number_of_readers;
 
-    self_p->number_of_writers--;
-
-    if (self_p->number_of_writers > 0) {
-        elem_p = self_p->writers_p;
-        self_p->writers_p = elem_p->next_p;
-
-        if (self_p->writers_p != NULL) {
-            self_p->writers_p->prev_p = NULL;
-        }
-
-        thrd_resume_isr(elem_p->thrd_p, 0);
-    } else if (self_p->number_of_readers > 0) {
+    if (self_p->readers_p != NULL) {
+        /* Readers waiting for this writer are resumed before any
+           waiting writer, so neither readers nor writers starve. */
         elem_p = self_p->readers_p;
+        self_p->readers_p = NULL;
+        number_of_readers = 0;
 
-        do {
-            self_p->readers_p = elem_p->next_p;
-
-            if (self_p->readers_p != NULL) {
-                self_p->readers_p->prev_p = NULL;
-            }
-
+        while (elem_p != NULL) {
             thrd_resume_isr(elem_p->thrd_p, 0);
-
+            number_of_readers++;
             elem_p = elem_p->next_p;
-        } while (elem_p != NULL);
+        }
+
+        update_state_isr(self_p,
+                         self_p->writers_p != NULL,
+                         number_of_readers);
+    } else if (self_p->writers_p != NULL) {
+        resume_writer_isr(self_p);
+    } else {
+        update_state_isr(self_p, 0, 0);
+#if CONFIG_THRD_CONTENTION == 1
+        thrd_contention_hold_end_isr(&self_p->contention);
+#endif
     }
 
     return (0);
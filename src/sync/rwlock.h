@@ -32,10 +32,17 @@
 #include "simba.h"
 
 struct rwlock_t {
-    int number_of_readers;
-    int number_of_writers;
+    /** Number of readers holding the lock. The second most
+        significant bit is set when a writer holds or waits for the
+        lock. */
+    int state;
+    /** Readers waiting for a writer. */
     volatile struct rwlock_elem_t *readers_p;
+    /** Writers waiting for the lock, in first-in-first-out order. */
     volatile struct rwlock_elem_t *writers_p;
+#if CONFIG_THRD_CONTENTION == 1
+    struct thrd_contention_t contention;
+#endif
 };
 
 /**
@@ -58,10 +65,30 @@ int rwlock_module_init(void);
  */
 int rwlock_init(struct rwlock_t *self_p);
 
+/**
+ * Initialize given reader-writer lock object with given name. The
+ * lock is listed by the file system command
+ * ``/kernel/thrd/contention`` if ``CONFIG_THRD_CONTENTION`` is set,
+ * and must not be freed. The name is ignored otherwise. The lock is
+ * busy while held by any reader or writer.
+ *
+ * @param[in] self_p Reader-writer lock to initialize.
+ * @param[in] name_p Reader-writer lock name.
+ *
+ * @return zero(0) or negative error code.
+ */
+int rwlock_init_named(struct rwlock_t *self_p, const char *name_p);
+
 /**
  * Take given reader-writer lock. Multiple threads can have the reader
  * lock at the same time.
  *
+ * A reader waits if a writer holds or waits for the lock, so readers
+ * cannot starve writers. Readers that waited for a writer are given
+ * the lock before the next writer, so writers cannot starve readers
+ * either. If no writer holds or waits for the lock, it is taken
+ * without the system lock on targets with lock-free atomic operations.
+ *
  * @param[in] self_p Reader-writer lock to take.
  *
  * @return zero(0) or negative error code.
@@ -28,6 +28,88 @@
 
 #include "simba.h"
 
+/* Set in the count when threads are waiting for the
+   semaphore. Resources are only taken and given without the system
+   lock when it is cleared. */
+#define WAITERS                   (1 << (8 * sizeof(int) - 2))
+
+/* The contention statistics are only updated with the system lock
+   taken. */
+#if (ATOMIC_LOCK_FREE == 1) && (CONFIG_THRD_CONTENTION == 0)
+#    define FAST_PATH                                       1
+#else
+#    define FAST_PATH                                       0
+#endif
+
+#if FAST_PATH == 1
+
+/**
+ * Take a resource without the system lock if one is available and no
+ * thread is waiting for the semaphore.
+ *
+ * @return true(1) if a resource was taken, otherwise false(0).
+ */
+static int take_fast(struct sem_t *self_p)
+{
+    int value;
+
+    value = ATOMIC_LOAD(&self_p->count);
+
+    while (((value & WAITERS) == 0) && (value < self_p->count_max)) {
+        if (ATOMIC_CAS(&self_p->count, &value, value + 1)) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+/**
+ * Give resources without the system lock if no thread is waiting for
+ * the semaphore.
+ *
+ * @return true(1) if the resources were given, otherwise false(0).
+ */
+static int give_fast(struct sem_t *self_p, int count)
+{
+    int value;
+    int new_value;
+
+    value = ATOMIC_LOAD(&self_p->count);
+
+    while ((value & WAITERS) == 0) {
+        new_value = (value - count);
+
+        if (new_value < 0) {
+            new_value = 0;
+        }
+
+        if (ATOMIC_CAS(&self_p->count, &value, new_value)) {
+            return (1);
+        }
+    }
+
+    return (0);
+}
+
+#endif
+
+/**
+ * Clear the waiters flag if no thread is waiting for the semaphore.
+ */
+static void clear_waiters_isr(struct sem_t *self_p)
+{
+    int value;
+
+    if (self_p->waiters.head_p != NULL) {
+        return;
+    }
+
+    value = ATOMIC_LOAD_ISR(&self_p->count);
+
+    while (!ATOMIC_CAS_ISR(&self_p->count, &value, value & ~WAITERS));
+}
+
 int sem_module_init(void)
 {
     return (0);
@@ -36,16 +118,32 @@ int sem_module_init(void)
 int sem_init(struct sem_t *self_p,
              int count,
              int count_max)
+{
+    return (sem_init_named(self_p, count, count_max, NULL));
+}
+
+int sem_init_named(struct sem_t *self_p,
+                   int count,
+                   int count_max,
+                   const char *name_p)
 {
     ASSERTN(self_p != NULL, EINVAL);
     ASSERTN((count >= 0) && (count <= count_max), EINVAL);
-    ASSERTN(count_max > 0, EINVAL);
+    ASSERTN((count_max > 0) && (count_max < WAITERS), EINVAL);
 
     self_p->count = count;
     self_p->count_max = count_max;
 
     thrd_prio_list_init(&self_p->waiters);
 
+#if CONFIG_THRD_CONTENTION == 1
+    thrd_contention_init(&self_p->contention, "sem", name_p);
+
+    if (count == count_max) {
+        thrd_contention_hold_begin_isr(&self_p->contention);
+    }
+#endif
+
     return (0);
 }
 
@@ -55,20 +153,50 @@ int sem_take(struct sem_t *self_p,
     ASSERTN(self_p != NULL, EINVAL);
 
     int err = 0;
+    int value;
     struct thrd_prio_list_elem_t elem;
+#if CONFIG_THRD_CONTENTION == 1
+    uint32_t start_us;
+#endif
+
+#if FAST_PATH == 1
+    if (take_fast(self_p)) {
+        return (0);
+    }
+#endif
 
     sys_lock();
 
-    if (self_p->count == self_p->count_max) {
-        elem.thrd_p = thrd_self();
-        thrd_prio_list_push_isr(&self_p->waiters, &elem);
-        err = thrd_suspend_isr(timeout_p);
+    value = ATOMIC_LOAD_ISR(&self_p->count);
+
+    while (1) {
+        if ((value & ~WAITERS) < self_p->count_max) {
+            if (ATOMIC_CAS_ISR(&self_p->count, &value, value + 1)) {
+#if CONFIG_THRD_CONTENTION == 1
+                if (((value & ~WAITERS) + 1) == self_p->count_max) {
+                    thrd_contention_hold_begin_isr(&self_p->contention);
+                }
+#endif
+                break;
+            }
+        } else if (ATOMIC_CAS_ISR(&self_p->count, &value, value | WAITERS)) {
+            elem.thrd_p = thrd_self();
+            thrd_prio_list_push_isr(&self_p->waiters, &elem);
+#if CONFIG_THRD_CONTENTION == 1
+            start_us = thrd_contention_wait_begin_isr(&self_p->contention);
+#endif
+            err = thrd_suspend_isr(timeout_p);
+#if CONFIG_THRD_CONTENTION == 1
+            thrd_contention_wait_end_isr(&self_p->contention, start_us);
+#endif
 
-        if (err == -ETIMEDOUT) {
-            thrd_prio_list_remove_isr(&self_p->waiters, &elem);
+            if (err == -ETIMEDOUT) {
+                thrd_prio_list_remove_isr(&self_p->waiters, &elem);
+                clear_waiters_isr(self_p);
+            }
+
+            break;
         }
-    } else {
-        self_p->count++;
     }
 
     sys_unlock();
@@ -82,6 +210,12 @@ int sem_give(struct sem_t *self_p,
     ASSERTN(self_p != NULL, EINVAL);
     ASSERTN(count >= 0, EINVAL);
 
+#if FAST_PATH == 1
+    if (give_fast(self_p, count)) {
+        return (0);
+    }
+#endif
+
     sys_lock();
     sem_give_isr(self_p, count);
     sys_unlock();
@@ -93,18 +227,40 @@ int sem_give_isr(struct sem_t *self_p,
                  int count)
 {
     struct thrd_prio_list_elem_t *elem_p;
+    int value;
+    int new_value;
 
-    self_p->count -= count;
+    /* The fast paths may change the count concurrently unless the
+       waiters flag is set. */
+    value = ATOMIC_LOAD_ISR(&self_p->count);
 
-    if (self_p->count < 0) {
-        self_p->count = 0;
-    }
+    do {
+        new_value = ((value & ~WAITERS) - count);
+
+        if (new_value < 0) {
+            new_value = 0;
+        }
+
+        new_value |= (value & WAITERS);
+    } while (!ATOMIC_CAS_ISR(&self_p->count, &value, new_value));
 
-    while ((self_p->count < self_p->count_max)
+    /* The flag is set if there are waiters, so the count is stable
+       while handing over resources to them. */
+    while (((new_value & ~WAITERS) < self_p->count_max)
            && ((elem_p = thrd_prio_list_pop_isr(&self_p->waiters)) != NULL)) {
-        self_p->count++;
+        new_value++;
+        ATOMIC_STORE_ISR(&self_p->count, new_value);
         thrd_resume_isr(elem_p->thrd_p, 0);
     }
 
+#if CONFIG_THRD_CONTENTION == 1
+    if (((value & ~WAITERS) == self_p->count_max)
+        && ((new_value & ~WAITERS) < self_p->count_max)) {
+        thrd_contention_hold_end_isr(&self_p->contention);
+    }
+#endif
+
+    clear_waiters_isr(self_p);
+
     return (0);
 }
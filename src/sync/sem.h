@@ -47,12 +47,16 @@
                           .head_p = NULL }
 
 struct sem_t {
-    /** Number of used resources. */
+    /** Number of used resources. The second most significant bit
+        is set when threads are waiting for the semaphore. */
     int count;
     /** Maximum number of resources. */
     int count_max;
     /** Wait list. */
     struct thrd_prio_list_t waiters;
+#if CONFIG_THRD_CONTENTION == 1
+    struct thrd_contention_t contention;
+#endif
 };
 
 /**
@@ -83,6 +87,26 @@ int sem_init(struct sem_t *self_p,
              int count,
              int count_max);
 
+/**
+ * Initialize given semaphore object with given name. The semaphore is
+ * listed by the file system command ``/kernel/thrd/contention`` if
+ * ``CONFIG_THRD_CONTENTION`` is set, and must not be freed. The name
+ * is ignored otherwise. The semaphore is busy while all resources
+ * are taken.
+ *
+ * @param[in] self_p Semaphore to initialize.
+ * @param[in] count Initial taken resource count.
+ * @param[in] count_max Maximum number of resources that can be taken
+ *                      at any given moment.
+ * @param[in] name_p Semaphore name.
+ *
+ * @return zero(0) or negative error code.
+ */
+int sem_init_named(struct sem_t *self_p,
+                   int count,
+                   int count_max,
+                   const char *name_p);
+
 /**
  * Take given semaphore. If the semaphore count is zero the calling
  * thread will be suspended until count is incremented by
@@ -0,0 +1,195 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+static int control(struct spsc_queue_t *self_p, int operation)
+{
+    int res;
+
+    res = 0;
+
+    switch (operation) {
+
+    case CHAN_CONTROL_NON_BLOCKING_READ:
+        self_p->flags |= SPSC_QUEUE_FLAGS_NON_BLOCKING_READ;
+        break;
+
+    case CHAN_CONTROL_BLOCKING_READ:
+        self_p->flags &= ~SPSC_QUEUE_FLAGS_NON_BLOCKING_READ;
+        break;
+
+    default:
+        res = -EINVAL;
+        break;
+    }
+
+    return (res);
+}
+
+/**
+ * Resume the reader or polling thread, if any.
+ */
+static void resume_reader_isr(struct spsc_queue_t *self_p)
+{
+    /* A polling thread is the reader of all polled channels. Only the
+       poll list has to be cleared. */
+    chan_is_polled_isr(&self_p->base);
+
+    if (self_p->base.reader_p != NULL) {
+        thrd_resume_isr(self_p->base.reader_p, 0);
+        self_p->base.reader_p = NULL;
+    }
+}
+
+int spsc_queue_init(struct spsc_queue_t *self_p,
+                    void *buf_p,
+                    size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN(size > 0, EINVAL);
+
+    chan_init(&self_p->base,
+              (chan_read_fn_t)spsc_queue_read,
+              (chan_write_fn_t)spsc_queue_write,
+              (chan_size_fn_t)spsc_queue_size);
+    chan_set_write_isr_cb(&self_p->base,
+                          (chan_write_fn_t)spsc_queue_write_isr);
+    chan_set_control_cb(&self_p->base, (chan_control_fn_t)control);
+
+    spsc_ring_init(&self_p->ring, buf_p, size);
+    self_p->flags = 0;
+
+    return (0);
+}
+
+ssize_t spsc_queue_read(struct spsc_queue_t *self_p,
+                        void *buf_p,
+                        size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+    size_t left;
+    char *c_buf_p;
+
+    left = size;
+    c_buf_p = buf_p;
+
+    while (1) {
+#if ATOMIC_LOCK_FREE == 1
+        /* Fast path. Read without the system lock. */
+        left -= spsc_ring_read(&self_p->ring, &c_buf_p[size - left], left);
+
+        if (left == 0) {
+            break;
+        }
+#endif
+
+        sys_lock();
+
+        self_p->base.reader_p = thrd_self();
+
+        /* Pairs with the fence in spsc_queue_write(). Data written
+           before the reader was added is found here. */
+        ATOMIC_FENCE();
+        left -= spsc_ring_read(&self_p->ring, &c_buf_p[size - left], left);
+
+        if ((left == 0)
+            || (self_p->flags & SPSC_QUEUE_FLAGS_NON_BLOCKING_READ)) {
+            self_p->base.reader_p = NULL;
+            sys_unlock();
+            break;
+        }
+
+        /* The writer resumes this thread and clears the reader. */
+        thrd_suspend_isr(NULL);
+
+        sys_unlock();
+    }
+
+    return (size - left);
+}
+
+ssize_t spsc_queue_write(struct spsc_queue_t *self_p,
+                         const void *buf_p,
+                         size_t size)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+
+#if ATOMIC_LOCK_FREE == 1
+    /* Fast path. Write without the system lock and only take it if
+       there is a reader to resume. */
+    size = spsc_ring_write(&self_p->ring, buf_p, size);
+
+    ATOMIC_FENCE();
+
+    if (ATOMIC_LOAD(&self_p->base.reader_p) != NULL) {
+        sys_lock();
+        resume_reader_isr(self_p);
+        sys_unlock();
+    }
+#else
+    sys_lock();
+    size = spsc_queue_write_isr(self_p, buf_p, size);
+    sys_unlock();
+#endif
+
+    return (size);
+}
+
+ssize_t spsc_queue_write_isr(struct spsc_queue_t *self_p,
+                             const void *buf_p,
+                             size_t size)
+{
+    size = spsc_ring_write(&self_p->ring, buf_p, size);
+
+    ATOMIC_FENCE();
+
+    if (ATOMIC_LOAD_ISR(&self_p->base.reader_p) != NULL) {
+        resume_reader_isr(self_p);
+    }
+
+    return (size);
+}
+
+ssize_t spsc_queue_size(struct spsc_queue_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (spsc_ring_used_size(&self_p->ring));
+}
+
+ssize_t spsc_queue_unused_size(struct spsc_queue_t *self_p)
+{
+    ASSERTN(self_p != NULL, EINVAL);
+
+    return (spsc_ring_unused_size(&self_p->ring));
+}
@@ -0,0 +1,126 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __SYNC_SPSC_QUEUE_H__
+#define __SYNC_SPSC_QUEUE_H__
+
+#include "simba.h"
+
+#define SPSC_QUEUE_FLAGS_NON_BLOCKING_READ                0x1
+
+/**
+ * A byte channel for one producer, typically an interrupt handler,
+ * and one reader thread. Data is passed in a lock-free ring buffer
+ * (see `spsc_ring_t`), and the system lock is only taken to resume
+ * the reader when it waits for data.
+ */
+struct spsc_queue_t {
+    struct chan_t base;
+    struct spsc_ring_t ring;
+    int flags;
+};
+
+/**
+ * Initialize given queue. Only the largest power of two bytes of
+ * given buffer are used.
+ *
+ * @param[in] self_p Queue to initialize.
+ * @param[in] buf_p Buffer for data storage.
+ * @param[in] size Size of given buffer.
+ *
+ * @return zero(0) or negative error code.
+ */
+int spsc_queue_init(struct spsc_queue_t *self_p,
+                    void *buf_p,
+                    size_t size);
+
+/**
+ * Read from given queue. Blocks until size bytes has been read. Only
+ * one thread may read from the queue.
+ *
+ * @param[in] self_p Queue to read from.
+ * @param[out] buf_p Buffer to read into.
+ * @param[in] size Number of bytes to read.
+ *
+ * @return Number of bytes read or negative error code.
+ */
+ssize_t spsc_queue_read(struct spsc_queue_t *self_p,
+                        void *buf_p,
+                        size_t size);
+
+/**
+ * Write bytes to given queue. Never blocks, and data that does not
+ * fit in the queue buffer is not written. Only one thread may write
+ * to the queue, and not at the same time as
+ * `spsc_queue_write_isr()`.
+ *
+ * @param[in] self_p Queue to write to.
+ * @param[in] buf_p Buffer to write from.
+ * @param[in] size Number of bytes to write.
+ *
+ * @return Number of bytes written or negative error code.
+ */
+ssize_t spsc_queue_write(struct spsc_queue_t *self_p,
+                         const void *buf_p,
+                         size_t size);
+
+/**
+ * Same as `spsc_queue_write()`, but from isr or with the system lock
+ * taken (see `sys_lock()`).
+ *
+ * @param[in] self_p Queue to write to.
+ * @param[in] buf_p Buffer to write from.
+ * @param[in] size Number of bytes to write.
+ *
+ * @return Number of bytes written or negative error code.
+ */
+ssize_t spsc_queue_write_isr(struct spsc_queue_t *self_p,
+                             const void *buf_p,
+                             size_t size);
+
+/**
+ * Get the number of bytes currently stored in the queue. May only be
+ * called by the reader.
+ *
+ * @param[in] self_p Queue.
+ *
+ * @return Number of bytes in queue.
+ */
+ssize_t spsc_queue_size(struct spsc_queue_t *self_p);
+
+/**
+ * Get the number of unused bytes in the queue. May only be called by
+ * the writer.
+ *
+ * @param[in] self_p Queue.
+ *
+ * @return Number of unused bytes in queue.
+ */
+ssize_t spsc_queue_unused_size(struct spsc_queue_t *self_p);
+
+#endif
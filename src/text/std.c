@@ -34,18 +34,33 @@
 /* +7 for floating point decimal point and fraction. */
 #define VALUE_BUF_MAX (3 * sizeof(long) + 7)
 
-struct buffered_output_t {
-    void *chan_p;
-    int pos;
-    char buffer[CONFIG_STD_OUTPUT_BUFFER_MAX];
+/**
+ * Formatted output is written to a buffer. The flush function is
+ * called when the buffer is full.
+ */
+struct output_t {
+    char *buf_p;
+    size_t pos;
     size_t size;
+    size_t length;
+    int (*flush)(struct output_t *self_p);
+    void *chan_p;
 };
 
-struct snprintf_output_t {
-    char *dst_p;
-    size_t size;
-    size_t size_max;
-};
+static FAR const char hex_digits[] = "0123456789abcdef";
+
+/* Two decimal digits per division. */
+static FAR const char decimal_digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
 
 /**
  * @return true(1) if the character is part of the string, otherwise
@@ -65,120 +80,144 @@ static int char_in_string(char c, const char *str_p)
 }
 
 /**
- * Put characters to buffer.
+ * The buffer can not be flushed. All data that does not fit is
+ * discarded, but counted.
+ */
+static int snprintf_flush(struct output_t *self_p)
+{
+    return (-1);
+}
+
+/**
+ * Write buffered characters to the channel.
  */
-static void sprintf_putc(char c, void *arg_p)
+static int fprintf_flush(struct output_t *self_p)
 {
-    char **dst_pp = arg_p;
+    chan_write(self_p->chan_p, self_p->buf_p, self_p->pos);
+    self_p->pos = 0;
 
-    *(*dst_pp)++ = c;
+    return (0);
 }
 
 /**
- * Put characters to buffer.
+ * Write buffered characters to the channel from interrupt context or
+ * with the system lock taken.
  */
-static void snprintf_putc(char c, void *arg_p)
+static int fprintf_flush_isr(struct output_t *self_p)
+{
+    chan_write_isr(self_p->chan_p, self_p->buf_p, self_p->pos);
+    self_p->pos = 0;
+
+    return (0);
+}
+
+static void output_init(struct output_t *self_p,
+                        char *buf_p,
+                        size_t size,
+                        int (*flush)(struct output_t *self_p),
+                        void *chan_p)
 {
-    struct snprintf_output_t *output_p;
+    self_p->buf_p = buf_p;
+    self_p->pos = 0;
+    self_p->size = size;
+    self_p->length = 0;
+    self_p->flush = flush;
+    self_p->chan_p = chan_p;
+}
 
-    output_p = arg_p;
+static void output_putc(struct output_t *self_p, char c)
+{
+    self_p->length++;
 
-    if (output_p->size < output_p->size_max) {
-        output_p->dst_p[output_p->size] = c;
+    if (self_p->pos == self_p->size) {
+        if (self_p->flush(self_p) != 0) {
+            return;
+        }
     }
 
-    output_p->size++;
+    self_p->buf_p[self_p->pos++] = c;
 }
 
-/**
- * Put characters to standard output.
- */
-static void fprintf_putc(char c, void *arg_p)
+static void output_write(struct output_t *self_p,
+                         const char *buf_p,
+                         size_t size)
 {
-    struct buffered_output_t *output_p = arg_p;
+    size_t n;
+
+    self_p->length += size;
 
-    output_p->buffer[output_p->pos++] = c;
-    output_p->size++;
+    while (size > 0) {
+        if (self_p->pos == self_p->size) {
+            if (self_p->flush(self_p) != 0) {
+                return;
+            }
+        }
 
-    if (output_p->pos == membersof(output_p->buffer)) {
-        chan_write(output_p->chan_p, output_p->buffer, output_p->pos);
-        output_p->pos = 0;
+        n = MIN(size, self_p->size - self_p->pos);
+        memcpy(&self_p->buf_p[self_p->pos], buf_p, n);
+        self_p->pos += n;
+        buf_p += n;
+        size -= n;
     }
 }
 
-/**
- * Flush output buffer to channel.
- */
-static void output_flush(struct buffered_output_t *output_p)
+static void output_write_far(struct output_t *self_p,
+                             far_string_t buf_p,
+                             size_t size)
 {
-    if (output_p->pos > 0) {
-        chan_write(output_p->chan_p, output_p->buffer, output_p->pos);
-        output_p->pos = 0;
+#if defined(FAR_SPECIAL_ADDRESS)
+    while (size > 0) {
+        output_putc(self_p, *buf_p++);
+        size--;
     }
+#else
+    output_write(self_p, buf_p, size);
+#endif
 }
 
-/**
- * Put characters to standard output from interrupt context or with
- * the system lock taken.
- */
-static void fprintf_putc_isr(char c, void *arg_p)
+static void output_fill(struct output_t *self_p, char c, int size)
 {
-    struct buffered_output_t *output_p = arg_p;
-
-    output_p->buffer[output_p->pos++] = c;
-    output_p->size++;
-
-    if (output_p->pos == membersof(output_p->buffer)) {
-        chan_write_isr(output_p->chan_p, output_p->buffer, output_p->pos);
-        output_p->pos = 0;
+    while (size > 0) {
+        output_putc(self_p, c);
+        size--;
     }
 }
 
 /**
- * Flush output buffer to channel.
+ * Flush any buffered characters.
  */
-static void output_flush_isr(struct buffered_output_t *output_p)
+static void output_flush(struct output_t *self_p)
 {
-    if (output_p->pos > 0) {
-        chan_write_isr(output_p->chan_p, output_p->buffer, output_p->pos);
-        output_p->pos = 0;
+    if (self_p->pos > 0) {
+        self_p->flush(self_p);
     }
 }
 
-static void formats(void (*std_putc)(char c, void *arg_p),
-                    void *arg_p,
+static void formats(struct output_t *output_p,
                     char *str_p,
+                    size_t length,
                     char flags,
                     int width,
                     char negative_sign)
 {
-    char *s_p = str_p;
-
-    while (*s_p++ != '\0') {
-        width--;
-    }
+    width -= length;
 
     /* Right justification. */
     if (flags != '-') {
         if ((negative_sign == 1) && (flags == '0')) {
-            std_putc(*str_p++, arg_p);
+            output_putc(output_p, *str_p++);
+            length--;
         }
 
-        while (width > 0) {
-            std_putc(flags, arg_p);
-            width--;
-        }
+        output_fill(output_p, flags, width);
     }
 
     /* Number */
-    while (*str_p != '\0') {
-        std_putc(*str_p++, arg_p);
-    }
+    output_write(output_p, str_p, length);
 
     /* Left justification. */
-    while (width > 0) {
-        std_putc(' ', arg_p);
-        width--;
+    if (flags == '-') {
+        output_fill(output_p, ' ', width);
     }
 }
 
@@ -190,7 +229,7 @@ static char *formati(char c,
                      char *negative_sign_p)
 {
     unsigned long value;
-    char digit;
+    unsigned int index;
 
     /* Get argument. */
     if (length == 0) {
@@ -211,14 +250,27 @@ static char *formati(char c,
     }
 
     /* Format number into buffer. */
-    do {
-        digit = (char)(value % radix);
-        value /= radix;
-        if (digit > 9) {
-            digit += 39;
+    if (radix == 16) {
+        do {
+            *--str_p = hex_digits[value & 0xf];
+            value >>= 4;
+        } while (value > 0);
+    } else {
+        while (value >= 100) {
+            index = (2 * (value % 100));
+            value /= 100;
+            *--str_p = decimal_digit_pairs[index + 1];
+            *--str_p = decimal_digit_pairs[index];
         }
-        *--str_p = ('0' + digit);
-    } while (value > 0);
+
+        if (value >= 10) {
+            index = (2 * value);
+            *--str_p = decimal_digit_pairs[index + 1];
+            *--str_p = decimal_digit_pairs[index];
+        } else {
+            *--str_p = ('0' + value);
+        }
+    }
 
     if (*negative_sign_p == 1) {
         *--str_p = '-';
@@ -288,22 +340,33 @@ static char *formatf(char c,
 
 #endif
 
-static void vcprintf(void (*std_putc)(char c, void *arg_p),
-                     void *arg_p,
+static void vcprintf(struct output_t *output_p,
                      far_string_t fmt_p,
                      va_list *ap_p)
 {
     char c, flags, length, negative_sign, buf[VALUE_BUF_MAX], *s_p;
     int width;
+    size_t size;
+    far_string_t run_p;
 
-    buf[sizeof(buf) - 1] = '\0';
+    while (1) {
+        /* Write all characters up to next specifier in one run. */
+        run_p = fmt_p;
 
-    while ((c = *fmt_p++) != '\0') {
-        if (c != '%') {
-            std_putc(c, arg_p);
-            continue;
+        while ((*fmt_p != '%') && (*fmt_p != '\0')) {
+            fmt_p++;
+        }
+
+        if (fmt_p != run_p) {
+            output_write_far(output_p, run_p, fmt_p - run_p);
+        }
+
+        if (*fmt_p == '\0') {
+            break;
         }
 
+        fmt_p++;
+
         /* Prototype: %[flags][width][length]specifier  */
 
         /* Parse the flags. */
@@ -352,21 +415,19 @@ static void vcprintf(void (*std_putc)(char c, void *arg_p),
                     far_string_p = FSTR("(null)");
                 }
 
-                s_p = &buf[sizeof(buf) - 1];
-                width -= std_strlen(far_string_p);
+                size = std_strlen(far_string_p);
+                width -= size;
 
                 /* Right justification. */
                 if (flags != '-') {
-                    formats(std_putc, arg_p, s_p, flags, width, negative_sign);
+                    output_fill(output_p, flags, width);
                 }
 
-                while (*far_string_p != '\0') {
-                    std_putc(*far_string_p++, arg_p);
-                }
+                output_write_far(output_p, far_string_p, size);
 
                 /* Left justification. */
                 if (flags == '-') {
-                    formats(std_putc, arg_p, s_p, flags, width, negative_sign);
+                    output_fill(output_p, ' ', width);
                 }
             }
 
@@ -380,44 +441,49 @@ static void vcprintf(void (*std_putc)(char c, void *arg_p),
                 s_p = "(null)";
             }
 
+            size = strlen(s_p);
             break;
 
         case 'c':
-            buf[sizeof(buf) - 2] = (char)va_arg(*ap_p, int);
-            s_p = &buf[sizeof(buf) - 2];
+            buf[0] = (char)va_arg(*ap_p, int);
+            s_p = &buf[0];
+            size = (buf[0] != '\0');
             break;
 
         case 'i':
         case 'd':
         case 'u':
-            s_p = formati(c, &buf[sizeof(buf) - 1], 10, ap_p, length, &negative_sign);
+            s_p = formati(c, &buf[sizeof(buf)], 10, ap_p, length, &negative_sign);
+            size = (&buf[sizeof(buf)] - s_p);
             break;
 
         case 'x':
-            s_p = formati(c, &buf[sizeof(buf) - 1], 16, ap_p, length, &negative_sign);
+            s_p = formati(c, &buf[sizeof(buf)], 16, ap_p, length, &negative_sign);
+            size = (&buf[sizeof(buf)] - s_p);
             break;
 
 #if CONFIG_FLOAT == 1
         case 'f':
-            s_p = formatf(c, &buf[sizeof(buf) - 1], ap_p, length, &negative_sign);
+            s_p = formatf(c, &buf[sizeof(buf)], ap_p, length, &negative_sign);
+            size = (&buf[sizeof(buf)] - s_p);
             break;
 #endif
 
         default:
-            std_putc(c, arg_p);
+            output_putc(output_p, c);
             continue;
         }
 
-        formats(std_putc, arg_p, s_p, flags, width, negative_sign);
+        formats(output_p, s_p, size, flags, width, negative_sign);
     }
 }
 
-static void cvcprintf(struct buffered_output_t *output_p,
+static void cvcprintf(struct output_t *output_p,
                       far_string_t fmt_p,
                       va_list *ap_p)
 {
     chan_control(output_p->chan_p, CHAN_CONTROL_PRINTF_BEGIN);
-    vcprintf(fprintf_putc, output_p, fmt_p, ap_p);
+    vcprintf(output_p, fmt_p, ap_p);
     output_flush(output_p);
     chan_control(output_p->chan_p, CHAN_CONTROL_PRINTF_END);
 }
@@ -478,12 +544,14 @@ ssize_t std_vsprintf(char *dst_p, far_string_t fmt_p, va_list *ap_p)
     ASSERTN(dst_p != NULL, EINVAL);
     ASSERTN(fmt_p != NULL, EINVAL);
 
-    char *d_p = dst_p;
+    struct output_t output;
 
-    vcprintf(sprintf_putc, &d_p, fmt_p, ap_p);
-    sprintf_putc('\0', &d_p);
+    /* The destination buffer is assumed to be big enough. */
+    output_init(&output, dst_p, SIZE_MAX, snprintf_flush, NULL);
+    vcprintf(&output, fmt_p, ap_p);
+    output_putc(&output, '\0');
 
-    return (d_p - dst_p - 1);
+    return (output.length - 1);
 }
 
 ssize_t std_vsnprintf(char *dst_p,
@@ -494,27 +562,24 @@ ssize_t std_vsnprintf(char *dst_p,
     ASSERTN(dst_p != NULL, EINVAL);
     ASSERTN(fmt_p != NULL, EINVAL);
 
-    struct snprintf_output_t output;
+    struct output_t output;
 
     if (size == 0) {
         return (-ENOMEM);
     }
 
-    output.dst_p = dst_p;
-    output.size = 0;
-    output.size_max = size;
-
-    vcprintf(snprintf_putc, &output, fmt_p, ap_p);
-    snprintf_putc('\0', &output);
+    output_init(&output, dst_p, size, snprintf_flush, NULL);
+    vcprintf(&output, fmt_p, ap_p);
+    output_putc(&output, '\0');
 
     /* Force the string to be NULL terminated. */
     dst_p[size - 1] = '\0';
 
-    if (output.size > size) {
+    if (output.length > size) {
         return (-ENOMEM);
     }
 
-    return (output.size - 1);
+    return (output.length - 1);
 }
 
 ssize_t std_printf(far_string_t fmt_p, ...)
@@ -522,17 +587,20 @@ ssize_t std_printf(far_string_t fmt_p, ...)
     ASSERTN(fmt_p != NULL, EINVAL);
 
     va_list ap;
-    struct buffered_output_t output;
+    struct output_t output;
+    char buf[CONFIG_STD_OUTPUT_BUFFER_MAX];
 
-    output.pos = 0;
-    output.size = 0;
-    output.chan_p = sys_get_stdout();
+    output_init(&output,
+                &buf[0],
+                sizeof(buf),
+                fprintf_flush,
+                sys_get_stdout());
 
     va_start(ap, fmt_p);
     cvcprintf(&output, fmt_p, &ap);
     va_end(ap);
 
-    return (output.size);
+    return (output.length);
 }
 
 ssize_t std_vprintf(far_string_t fmt_p, va_list *ap_p)
@@ -540,15 +608,17 @@ ssize_t std_vprintf(far_string_t fmt_p, va_list *ap_p)
     ASSERTN(fmt_p != NULL, EINVAL);
     ASSERTN(ap_p != NULL, EINVAL);
 
-    struct buffered_output_t output;
-
-    output.pos = 0;
-    output.size = 0;
-    output.chan_p = sys_get_stdout();
+    struct output_t output;
+    char buf[CONFIG_STD_OUTPUT_BUFFER_MAX];
 
+    output_init(&output,
+                &buf[0],
+                sizeof(buf),
+                fprintf_flush,
+                sys_get_stdout());
     cvcprintf(&output, fmt_p, ap_p);
 
-    return (output.size);
+    return (output.length);
 }
 
 ssize_t std_fprintf(void *chan_p, far_string_t fmt_p, ...)
@@ -557,17 +627,16 @@ ssize_t std_fprintf(void *chan_p, far_string_t fmt_p, ...)
     ASSERTN(fmt_p != NULL, EINVAL);
 
     va_list ap;
-    struct buffered_output_t output;
+    struct output_t output;
+    char buf[CONFIG_STD_OUTPUT_BUFFER_MAX];
 
-    output.pos = 0;
-    output.size = 0;
-    output.chan_p = chan_p;
+    output_init(&output, &buf[0], sizeof(buf), fprintf_flush, chan_p);
 
     va_start(ap, fmt_p);
     cvcprintf(&output, fmt_p, &ap);
     va_end(ap);
 
-    return (output.size);
+    return (output.length);
 }
 
 ssize_t std_vfprintf(void *chan_p, far_string_t fmt_p, va_list *ap_p)
@@ -576,49 +645,85 @@ ssize_t std_vfprintf(void *chan_p, far_string_t fmt_p, va_list *ap_p)
     ASSERTN(fmt_p != NULL, EINVAL);
     ASSERTN(ap_p != NULL, EINVAL);
 
-    struct buffered_output_t output;
+    struct output_t output;
+    char buf[CONFIG_STD_OUTPUT_BUFFER_MAX];
+
+    output_init(&output, &buf[0], sizeof(buf), fprintf_flush, chan_p);
+    cvcprintf(&output, fmt_p, ap_p);
+
+    return (output.length);
+}
+
+ssize_t std_fprintf_buffered(void *chan_p,
+                             char *buf_p,
+                             size_t size,
+                             far_string_t fmt_p,
+                             ...)
+{
+    va_list ap;
+    ssize_t res;
+
+    va_start(ap, fmt_p);
+    res = std_vfprintf_buffered(chan_p, buf_p, size, fmt_p, &ap);
+    va_end(ap);
+
+    return (res);
+}
+
+ssize_t std_vfprintf_buffered(void *chan_p,
+                              char *buf_p,
+                              size_t size,
+                              far_string_t fmt_p,
+                              va_list *ap_p)
+{
+    ASSERTN(chan_p != NULL, EINVAL);
+    ASSERTN(buf_p != NULL, EINVAL);
+    ASSERTN(size > 0, EINVAL);
+    ASSERTN(fmt_p != NULL, EINVAL);
+    ASSERTN(ap_p != NULL, EINVAL);
 
-    output.pos = 0;
-    output.size = 0;
-    output.chan_p = chan_p;
+    struct output_t output;
 
+    output_init(&output, buf_p, size, fprintf_flush, chan_p);
     cvcprintf(&output, fmt_p, ap_p);
 
-    return (output.size);
+    return (output.length);
 }
 
 ssize_t std_printf_isr(far_string_t fmt_p, ...)
 {
     va_list ap;
-    struct buffered_output_t output;
+    struct output_t output;
+    char buf[CONFIG_STD_OUTPUT_BUFFER_MAX];
 
-    output.pos = 0;
-    output.size = 0;
-    output.chan_p = sys_get_stdout();
+    output_init(&output,
+                &buf[0],
+                sizeof(buf),
+                fprintf_flush_isr,
+                sys_get_stdout());
 
     va_start(ap, fmt_p);
-    vcprintf(fprintf_putc_isr, &output, fmt_p, &ap);
-    output_flush_isr(&output);
+    vcprintf(&output, fmt_p, &ap);
+    output_flush(&output);
     va_end(ap);
 
-    return (output.size);
+    return (output.length);
 }
 
 ssize_t std_fprintf_isr(void *chan_p, far_string_t fmt_p, ...)
 {
     va_list ap;
-    struct buffered_output_t output;
+    struct output_t output;
+    char buf[CONFIG_STD_OUTPUT_BUFFER_MAX];
 
-    output.pos = 0;
-    output.size = 0;
-    output.chan_p = chan_p;
+    output_init(&output, &buf[0], sizeof(buf), fprintf_flush_isr, chan_p);
 
     va_start(ap, fmt_p);
-    vcprintf(fprintf_putc_isr, &output, fmt_p, &ap);
-    output_flush_isr(&output);
+    vcprintf(&output, fmt_p, &ap);
+    output_flush(&output);
     va_end(ap);
 
-    return (output.size);
+    return (output.length);
 }
 
 const char *std_strtolb(const char *str_p,
@@ -180,6 +180,51 @@ ssize_t std_fprintf(void *chan_p, far_string_t fmt_p, ...);
  */
 ssize_t std_vfprintf(void *chan_p, far_string_t fmt_p, va_list *ap_p);
 
+/**
+ * Format and print data to given channel using given output
+ * buffer. The output is written to the channel when the buffer is
+ * full, and when all data has been formatted. A buffer bigger than
+ * the default of ``CONFIG_STD_OUTPUT_BUFFER_MAX`` bytes results in
+ * fewer channel writes. The output is not null terminated.
+ *
+ * See `std_sprintf()` for the the format string specification.
+ *
+ * @param[in] chan_p Output channel.
+ * @param[in] buf_p Output buffer.
+ * @param[in] size Output buffer size in bytes.
+ * @param[in] fmt_p Format string.
+ * @param[in] ... Variable arguments list.
+ *
+ * @return Number of characters written to given channel, or negative
+ *         error code.
+ */
+ssize_t std_fprintf_buffered(void *chan_p,
+                             char *buf_p,
+                             size_t size,
+                             far_string_t fmt_p,
+                             ...);
+
+/**
+ * Format and print data to given channel using given output
+ * buffer. The output is not null terminated.
+ *
+ * See `std_fprintf_buffered()` for details.
+ *
+ * @param[in] chan_p Output channel.
+ * @param[in] buf_p Output buffer.
+ * @param[in] size Output buffer size in bytes.
+ * @param[in] fmt_p Format string.
+ * @param[in] ap_p Variable arguments list.
+ *
+ * @return Number of characters written to given channel, or negative
+ *         error code.
+ */
+ssize_t std_vfprintf_buffered(void *chan_p,
+                              char *buf_p,
+                              size_t size,
+                              far_string_t fmt_p,
+                              va_list *ap_p);
+
 /**
  * Format and print data to standard output from interrupt context or
  * with the system lock taken. The output is not null terminated.
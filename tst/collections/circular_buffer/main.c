@@ -185,6 +185,47 @@ int test_array(void)
     return (0);
 }
 
+int test_unused_array(void)
+{
+    struct circular_buffer_t foo;
+    uint8_t foobuf[8];
+    void *buf_p;
+    char data[8];
+
+    BTASSERT(circular_buffer_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+
+    /* One byte is always unused. */
+    BTASSERT(circular_buffer_unused_array(&foo, &buf_p, 8) == 7);
+    BTASSERT(buf_p == &foobuf[0]);
+    BTASSERT(circular_buffer_unused_array(&foo, &buf_p, 0) == 0);
+
+    /* Write five bytes directly to the buffer. */
+    memcpy(buf_p, "12345", 5);
+    BTASSERT(circular_buffer_skip_back(&foo, 5) == 5);
+    BTASSERT(circular_buffer_used_size(&foo) == 5);
+    BTASSERT(circular_buffer_unused_array(&foo, &buf_p, 8) == 2);
+    BTASSERT(buf_p == &foobuf[5]);
+
+    /* The array ends at the end of the buffer memory after a read. */
+    BTASSERT(circular_buffer_read(&foo, &data[0], 4) == 4);
+    BTASSERT(memcmp(&data[0], "1234", 4) == 0);
+    BTASSERT(circular_buffer_unused_array(&foo, &buf_p, 8) == 3);
+    BTASSERT(buf_p == &foobuf[5]);
+    memcpy(buf_p, "678", 3);
+    BTASSERT(circular_buffer_skip_back(&foo, 3) == 3);
+
+    /* Wrap around. The array ends before the first unread byte. */
+    BTASSERT(circular_buffer_unused_array(&foo, &buf_p, 8) == 3);
+    BTASSERT(buf_p == &foobuf[0]);
+    memcpy(buf_p, "9ab", 3);
+    BTASSERT(circular_buffer_skip_back(&foo, 5) == 3);
+    BTASSERT(circular_buffer_unused_array(&foo, &buf_p, 8) == 0);
+    BTASSERT(circular_buffer_read(&foo, &data[0], 8) == 7);
+    BTASSERT(memcmp(&data[0], "56789ab", 7) == 0);
+
+    return (0);
+}
+
 int test_find(void)
 {
     struct circular_buffer_t foo;
@@ -232,6 +273,7 @@ int main()
         { test_read_write, "test_read_write" },
         { test_skip, "test_skip" },
         { test_array, "test_array" },
+        { test_unused_array, "test_unused_array" },
         { test_find, "test_find" },
         { NULL, NULL }
     };
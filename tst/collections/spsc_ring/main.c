@@ -0,0 +1,142 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+static int test_init(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[20];
+
+    /* Only the largest power of two bytes are used. */
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+    BTASSERTI(spsc_ring_used_size(&foo), ==, 0);
+    BTASSERTI(spsc_ring_unused_size(&foo), ==, 16);
+
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], 1) == 0);
+    BTASSERTI(spsc_ring_unused_size(&foo), ==, 1);
+
+    return (0);
+}
+
+static int test_read_write(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[16];
+    uint8_t buf[32];
+
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+
+    /* Read from empty buffer. */
+    BTASSERTI(spsc_ring_read(&foo, &buf[0], 0), ==, 0);
+    BTASSERTI(spsc_ring_read(&foo, &buf[0], 1), ==, 0);
+
+    /* Write and read some data. */
+    BTASSERTI(spsc_ring_write(&foo, "123", 3), ==, 3);
+    BTASSERTI(spsc_ring_write(&foo, "4567", 4), ==, 4);
+    BTASSERTI(spsc_ring_used_size(&foo), ==, 7);
+    BTASSERTI(spsc_ring_unused_size(&foo), ==, 9);
+    BTASSERTI(spsc_ring_read(&foo, &buf[0], 2), ==, 2);
+    BTASSERTM(&buf[0], "12", 2);
+    BTASSERTI(spsc_ring_read(&foo, &buf[0], 20), ==, 5);
+    BTASSERTM(&buf[0], "34567", 5);
+
+    /* All bytes of the buffer are used, and data wraps around. */
+    memset(&buf[0], 'a', 17);
+    buf[15] = 'b';
+    BTASSERTI(spsc_ring_write(&foo, &buf[0], 17), ==, 16);
+    BTASSERTI(spsc_ring_write(&foo, &buf[0], 1), ==, 0);
+    BTASSERTI(spsc_ring_used_size(&foo), ==, 16);
+    BTASSERTI(spsc_ring_unused_size(&foo), ==, 0);
+    memset(&buf[0], '0', sizeof(buf));
+    BTASSERTI(spsc_ring_read(&foo, &buf[0], 32), ==, 16);
+    BTASSERTM(&buf[0], "aaaaaaaaaaaaaaab", 16);
+    BTASSERTI(spsc_ring_used_size(&foo), ==, 0);
+
+    return (0);
+}
+
+static int test_array(void)
+{
+    struct spsc_ring_t foo;
+    uint8_t foobuf[8];
+    uint8_t buf[8];
+    void *buf_p;
+
+    BTASSERT(spsc_ring_init(&foo, &foobuf[0], sizeof(foobuf)) == 0);
+
+    BTASSERTI(spsc_ring_array_one(&foo, &buf_p, 8), ==, 0);
+
+    /* Write directly to the buffer. */
+    BTASSERTI(spsc_ring_unused_array(&foo, &buf_p, 5), ==, 5);
+    BTASSERT(buf_p == &foobuf[0]);
+    memcpy(buf_p, "12345", 5);
+    BTASSERTI(spsc_ring_skip_back(&foo, 5), ==, 5);
+
+    /* Read directly from the buffer. */
+    BTASSERTI(spsc_ring_array_one(&foo, &buf_p, 3), ==, 3);
+    BTASSERT(buf_p == &foobuf[0]);
+    BTASSERTI(spsc_ring_skip_front(&foo, 3), ==, 3);
+
+    /* The arrays end at the end of the buffer memory. */
+    BTASSERTI(spsc_ring_unused_array(&foo, &buf_p, 8), ==, 3);
+    BTASSERT(buf_p == &foobuf[5]);
+    memcpy(buf_p, "678", 3);
+    BTASSERTI(spsc_ring_skip_back(&foo, 3), ==, 3);
+    BTASSERTI(spsc_ring_unused_array(&foo, &buf_p, 8), ==, 3);
+    BTASSERT(buf_p == &foobuf[0]);
+    BTASSERTI(spsc_ring_write(&foo, "9ab", 3), ==, 3);
+    BTASSERTI(spsc_ring_array_one(&foo, &buf_p, 8), ==, 5);
+    BTASSERTM(buf_p, "45678", 5);
+    BTASSERTI(spsc_ring_skip_front(&foo, 5), ==, 5);
+    BTASSERTI(spsc_ring_array_one(&foo, &buf_p, 8), ==, 3);
+    BTASSERTM(buf_p, "9ab", 3);
+
+    /* Skip more than available. */
+    BTASSERTI(spsc_ring_skip_front(&foo, 5), ==, 3);
+    BTASSERTI(spsc_ring_skip_back(&foo, 9), ==, 8);
+    BTASSERTI(spsc_ring_read(&foo, &buf[0], 8), ==, 8);
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_read_write, "test_read_write" },
+        { test_array, "test_array" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -126,6 +126,439 @@ int test_handler(void)
     return (0);
 }
 
+int test_print_long(void)
+{
+    struct log_object_t foo;
+    struct log_handler_t handler;
+    struct queue_t queue;
+    char queue_buf[512];
+    char buf[512];
+    char message[201];
+    ssize_t size;
+    const char *suffix_p;
+
+    BTASSERT(log_object_init(&foo,
+                             "foo",
+                             LOG_UPTO(INFO)) == 0);
+    BTASSERT(queue_init(&queue, &queue_buf[0], sizeof(queue_buf)) == 0);
+    BTASSERT(log_handler_init(&handler, &queue) == 0);
+    BTASSERT(log_add_handler(&handler) == 0);
+
+    /* A short entry is formatted once for both handlers. */
+    BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("short\r\n")) == 2);
+    size = queue_size(&queue);
+    BTASSERT(queue_read(&queue, &buf[0], size) == size);
+    suffix_p = ":info:main:foo: short\r\n";
+    BTASSERTM(&buf[size - strlen(suffix_p)], suffix_p, strlen(suffix_p));
+
+    /* An entry too long for the log buffer. */
+    memset(&message[0], 'a', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+    BTASSERT(log_object_print(&foo,
+                              LOG_INFO,
+                              FSTR("%s\r\n"),
+                              &message[0]) == 2);
+    size = queue_size(&queue);
+    BTASSERT(queue_read(&queue, &buf[0], size) == size);
+    BTASSERTM(&buf[size - 202], &message[0], 200);
+    BTASSERTM(&buf[size - 2], "\r\n", 2);
+    BTASSERTM(&buf[size - 202 - 16], ":info:main:foo: ", 16);
+
+    BTASSERT(log_remove_handler(&handler) == 0);
+
+    return (0);
+}
+
+#if CONFIG_LOG_BINARY == 1
+
+/**
+ * Read a binary log record from given queue.
+ *
+ * @return Record type.
+ */
+static int read_record(struct queue_t *queue_p,
+                       uint8_t *payload_p,
+                       uint16_t *size_p)
+{
+    uint8_t header[3];
+
+    BTASSERT(queue_read(queue_p, &header[0], sizeof(header)) == 3);
+    memcpy(size_p, &header[1], sizeof(*size_p));
+    BTASSERT(queue_read(queue_p, payload_p, *size_p) == *size_p);
+
+    return (header[0]);
+}
+
+int test_binary(void)
+{
+    struct log_object_t foo;
+    struct log_binary_buffer_t buffer;
+    uint8_t buf[256];
+    struct queue_t queue;
+    uint8_t queue_buf[512];
+    uint8_t payload[128];
+    uint16_t size;
+    uintptr_t id;
+    int value;
+    long long_value;
+    far_string_t fmt_p;
+    size_t args_offset;
+
+    fmt_p = FSTR("x = %d, s = %s, l = %lu\r\n");
+    args_offset = (9 + 3 * sizeof(uintptr_t));
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(queue_init(&queue, &queue_buf[0], sizeof(queue_buf)) == 0);
+    BTASSERT(log_binary_buffer_init(&buffer, &buf[0], sizeof(buf)) == 0);
+    BTASSERT(log_binary_set_output_channel(&queue) == 0);
+
+    /* Record two entries, and write them to the queue. */
+    BTASSERT(log_object_print(&foo, LOG_INFO, fmt_p, -5, "bar", 7L) == 1);
+    BTASSERT(log_object_print(&foo, LOG_INFO, fmt_p, 3, "", 8L) == 1);
+    BTASSERT(log_binary_drain() > 0);
+
+    /* Stream information. */
+    BTASSERT(read_record(&queue, &payload[0], &size) == 1);
+    BTASSERTI(size, ==, 10);
+    BTASSERTM(&payload[0], "slog", 4);
+
+    /* The format string, log object name and thread name. */
+    BTASSERT(read_record(&queue, &payload[0], &size) == 2);
+    memcpy(&id, &payload[0], sizeof(id));
+    BTASSERT(id == (uintptr_t)fmt_p);
+    BTASSERTI(size, ==, sizeof(id) + strlen(fmt_p));
+    BTASSERTM(&payload[sizeof(id)], fmt_p, strlen(fmt_p));
+
+    BTASSERT(read_record(&queue, &payload[0], &size) == 2);
+    BTASSERTI(size, ==, sizeof(id) + 3);
+    BTASSERTM(&payload[sizeof(id)], "foo", 3);
+
+    BTASSERT(read_record(&queue, &payload[0], &size) == 2);
+    BTASSERTI(size, ==, sizeof(id) + 4);
+    BTASSERTM(&payload[sizeof(id)], "main", 4);
+
+    /* The first entry. */
+    BTASSERT(read_record(&queue, &payload[0], &size) == 3);
+    BTASSERTI(size, ==, args_offset + sizeof(int) + 4 + sizeof(long));
+    BTASSERTI(payload[0], ==, LOG_INFO);
+    memcpy(&value, &payload[args_offset], sizeof(value));
+    BTASSERTI(value, ==, -5);
+    BTASSERTI(payload[args_offset + sizeof(int)], ==, 3);
+    BTASSERTM(&payload[args_offset + sizeof(int) + 1], "bar", 3);
+    memcpy(&long_value,
+           &payload[args_offset + sizeof(int) + 4],
+           sizeof(long_value));
+    BTASSERTI(long_value, ==, 7);
+
+    /* The second entry. All strings are already written. */
+    BTASSERT(read_record(&queue, &payload[0], &size) == 3);
+    BTASSERTI(size, ==, args_offset + sizeof(int) + 1 + sizeof(long));
+    BTASSERTI(queue_size(&queue), ==, 0);
+
+    /* Nothing more to drain. */
+    BTASSERT(log_binary_drain() == 0);
+
+    /* Back to text mode. */
+    BTASSERT(log_binary_set_output_channel(NULL) == 0);
+    BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("text\r\n")) == 1);
+    BTASSERT(log_binary_buffer_deinit(&buffer) == 0);
+
+    return (0);
+}
+
+int test_binary_dropped(void)
+{
+    struct log_object_t foo;
+    struct log_binary_buffer_t buffer;
+    uint8_t buf[64];
+    struct queue_t queue;
+    uint8_t queue_buf[256];
+    uint8_t payload[128];
+    uint16_t size;
+    uint32_t count;
+    int i;
+    int recorded;
+    int type;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(queue_init(&queue, &queue_buf[0], sizeof(queue_buf)) == 0);
+    BTASSERT(log_binary_buffer_init(&buffer, &buf[0], sizeof(buf)) == 0);
+    BTASSERT(log_binary_set_output_channel(&queue) == 0);
+
+    /* The buffer only fits a few entries. */
+    recorded = 0;
+
+    for (i = 0; i < 10; i++) {
+        recorded += log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i);
+    }
+
+    BTASSERT(recorded > 0);
+    BTASSERT(recorded < 10);
+    BTASSERT(log_binary_drain() > 0);
+
+    /* Find the dropped record. */
+    do {
+        type = read_record(&queue, &payload[0], &size);
+    } while (type != 4);
+
+    memcpy(&count, &payload[sizeof(uintptr_t)], sizeof(count));
+    BTASSERTI(count, ==, 10 - recorded);
+
+    BTASSERT(log_binary_set_output_channel(NULL) == 0);
+    BTASSERT(log_binary_buffer_deinit(&buffer) == 0);
+
+    return (0);
+}
+
+int test_binary_performance(void)
+{
+    struct log_object_t foo;
+    struct log_binary_buffer_t buffer;
+    static uint8_t buf[8192];
+    int start;
+    int i;
+    long text_us;
+    long binary_us;
+    long drain_us;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(log_set_default_handler_output_channel(chan_null()) == 0);
+
+    /* Text mode. */
+    start = time_micros();
+
+    for (i = 0; i < 100; i++) {
+        log_object_print(&foo,
+                         LOG_INFO,
+                         FSTR("Sample %d of sensor %s is %lu.\r\n"),
+                         i,
+                         "temp",
+                         123456L);
+    }
+
+    text_us = time_micros_elapsed(start, time_micros());
+
+    /* Binary mode. */
+    BTASSERT(log_binary_buffer_init(&buffer, &buf[0], sizeof(buf)) == 0);
+    BTASSERT(log_binary_set_output_channel(chan_null()) == 0);
+    start = time_micros();
+
+    for (i = 0; i < 100; i++) {
+        BTASSERT(log_object_print(&foo,
+                                  LOG_INFO,
+                                  FSTR("Sample %d of sensor %s is %lu.\r\n"),
+                                  i,
+                                  "temp",
+                                  123456L) == 1);
+    }
+
+    binary_us = time_micros_elapsed(start, time_micros());
+    start = time_micros();
+    BTASSERT(log_binary_drain() > 0);
+    drain_us = time_micros_elapsed(start, time_micros());
+
+    std_printf(OSTR("100 log calls: text %ld us, binary %ld us "
+                    "(drain %ld us).\r\n"),
+               text_us,
+               binary_us,
+               drain_us);
+
+    BTASSERT(log_binary_set_output_channel(NULL) == 0);
+    BTASSERT(log_binary_buffer_deinit(&buffer) == 0);
+    BTASSERT(log_set_default_handler_output_channel(sys_get_stdout()) == 0);
+
+    return (0);
+}
+
+#endif
+
+#if CONFIG_LOG_ASYNC == 1
+
+static ssize_t slow_write(void *self_p,
+                          const void *buf_p,
+                          size_t size)
+{
+    thrd_sleep_ms(2);
+
+    return (size);
+}
+
+int test_async(void)
+{
+    static struct log_async_t async;
+    static struct log_async_entry_t entries[4];
+    struct log_object_t foo;
+    struct log_handler_t handler;
+    struct queue_t queue;
+    uint8_t buf[512];
+    char command[64];
+    int i;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(queue_init(&queue, &buf[0], sizeof(buf)) == 0);
+    BTASSERT(log_async_init(&async,
+                            &queue,
+                            &entries[0],
+                            membersof(entries),
+                            LOG_ASYNC_POLICY_DROP_NEWEST,
+                            FSTR("/debug/log/async/dropped")) == 0);
+    BTASSERT(log_handler_init_async(&handler, &async) == 0);
+    BTASSERT(log_set_default_handler_output_channel(NULL) == 0);
+    BTASSERT(log_add_handler(&handler) == 0);
+
+    /* Entries are only written to the output channel when drained. */
+    BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("x = %d\r\n"), 1) == 1);
+    BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("y = %d\r\n"), 2) == 1);
+    BTASSERTI(queue_size(&queue), ==, 0);
+    BTASSERTI(log_async_drain(&async), ==, 2);
+    BTASSERT(harness_expect(&queue, ":info:main:foo: x = 1\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, ":info:main:foo: y = 2\r\n", NULL) > 0);
+    BTASSERTI(queue_size(&queue), ==, 0);
+    BTASSERTI(log_async_drain(&async), ==, 0);
+
+    /* Drop the newest entries when the ring is full. */
+    for (i = 0; i < 6; i++) {
+        BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i) == 1);
+    }
+
+    BTASSERTI(log_async_drain(&async), ==, 4);
+    BTASSERT(harness_expect(&queue, "foo: 0\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, "foo: 1\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, "foo: 2\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, "foo: 3\r\n", NULL) > 0);
+    BTASSERTI(queue_size(&queue), ==, 0);
+    BTASSERT(log_async_get_dropped(&async) == 2);
+
+    /* The dropped counter in the file system. */
+    strcpy(command, "/debug/log/async/dropped");
+    BTASSERT(fs_call(command, NULL, &queue, NULL) == 0);
+    BTASSERT(harness_expect(&queue, "0000000000000002\r\n", NULL) > 0);
+
+    /* Drop the oldest entries when the ring is full. */
+    BTASSERT(log_async_init(&async,
+                            &queue,
+                            &entries[0],
+                            membersof(entries),
+                            LOG_ASYNC_POLICY_DROP_OLDEST,
+                            NULL) == 0);
+
+    for (i = 0; i < 6; i++) {
+        BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i) == 1);
+    }
+
+    BTASSERTI(log_async_drain(&async), ==, 4);
+    BTASSERT(harness_expect(&queue, "foo: 2\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, "foo: 3\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, "foo: 4\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&queue, "foo: 5\r\n", NULL) > 0);
+    BTASSERTI(queue_size(&queue), ==, 0);
+    BTASSERT(log_async_get_dropped(&async) == 2);
+
+    BTASSERT(log_remove_handler(&handler) == 0);
+    BTASSERT(log_set_default_handler_output_channel(sys_get_stdout()) == 0);
+
+    return (0);
+}
+
+int test_async_thread(void)
+{
+    static struct log_async_t async;
+    static struct log_async_entry_t entries[8];
+    static struct queue_t queue;
+    static uint8_t buf[256];
+    static THRD_STACK(stack, 1024);
+    struct log_object_t foo;
+    struct log_handler_t handler;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(queue_init(&queue, &buf[0], sizeof(buf)) == 0);
+    BTASSERT(log_async_init(&async,
+                            &queue,
+                            &entries[0],
+                            membersof(entries),
+                            LOG_ASYNC_POLICY_DROP_NEWEST,
+                            NULL) == 0);
+    BTASSERT(log_handler_init_async(&handler, &async) == 0);
+    BTASSERT(log_add_handler(&handler) == 0);
+    BTASSERT(thrd_spawn(log_async_main,
+                        &async,
+                        0,
+                        stack,
+                        sizeof(stack)) != NULL);
+
+    /* The drain thread writes the entries to the queue. */
+    BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("first\r\n")) == 2);
+    BTASSERT(harness_expect(&queue, ":info:main:foo: first\r\n", NULL) > 0);
+    BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("second\r\n")) == 2);
+    BTASSERT(harness_expect(&queue, ":info:main:foo: second\r\n", NULL) > 0);
+
+    BTASSERT(log_remove_handler(&handler) == 0);
+
+    return (0);
+}
+
+int test_async_latency(void)
+{
+    struct log_object_t foo;
+    struct log_async_t async;
+    struct log_async_entry_t entries[16];
+    struct log_handler_t handler;
+    struct chan_t slow;
+    int start;
+    int i;
+    long sync_us;
+    long async_us;
+
+    BTASSERT(log_object_init(&foo, "foo", LOG_UPTO(INFO)) == 0);
+    BTASSERT(chan_init(&slow,
+                       chan_read_null,
+                       slow_write,
+                       chan_size_null) == 0);
+
+    /* The default handler writes to the slow channel. */
+    BTASSERT(log_set_default_handler_output_channel(&slow) == 0);
+    start = time_micros();
+
+    for (i = 0; i < 10; i++) {
+        BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i) == 1);
+    }
+
+    sync_us = time_micros_elapsed(start, time_micros());
+
+    /* An asynchronous handler writes to the slow channel. */
+    BTASSERT(log_set_default_handler_output_channel(NULL) == 0);
+    BTASSERT(log_async_init(&async,
+                            &slow,
+                            &entries[0],
+                            membersof(entries),
+                            LOG_ASYNC_POLICY_DROP_NEWEST,
+                            NULL) == 0);
+    BTASSERT(log_handler_init_async(&handler, &async) == 0);
+    BTASSERT(log_add_handler(&handler) == 0);
+    start = time_micros();
+
+    for (i = 0; i < 10; i++) {
+        BTASSERT(log_object_print(&foo, LOG_INFO, FSTR("%d\r\n"), i) == 1);
+    }
+
+    async_us = time_micros_elapsed(start, time_micros());
+    BTASSERTI(log_async_drain(&async), ==, 10);
+
+    std_printf(OSTR("10 log calls to a slow channel: synchronous %ld us, "
+                    "asynchronous %ld us.\r\n"),
+               sync_us,
+               async_us);
+
+    BTASSERT(async_us * 10 < sync_us);
+
+    BTASSERT(log_remove_handler(&handler) == 0);
+    BTASSERT(log_set_default_handler_output_channel(sys_get_stdout()) == 0);
+
+    return (0);
+}
+
+#endif
+
 int test_log_mask(void)
 {
     struct log_object_t foo;
@@ -234,6 +667,17 @@ int main()
         { test_print, "test_print" },
         { test_object, "test_object" },
         { test_handler, "test_handler" },
+        { test_print_long, "test_print_long" },
+#if CONFIG_LOG_BINARY == 1
+        { test_binary, "test_binary" },
+        { test_binary_dropped, "test_binary_dropped" },
+        { test_binary_performance, "test_binary_performance" },
+#endif
+#if CONFIG_LOG_ASYNC == 1
+        { test_async, "test_async" },
+        { test_async_thread, "test_async_thread" },
+        { test_async_latency, "test_async_latency" },
+#endif
         { test_log_mask, "test_log_mask" },
         { test_fs, "test_fs" },
         { NULL, NULL }
@@ -31,11 +31,19 @@
 #if defined(ARCH_LINUX)
 #    define DEVICE_INDEX                         0
 #    define FLASH_ADDRESS                   0x0000
-#    define FLASH_SIZE                       0x800
+#    define FLASH_SIZE                      0x4000
 #    define CHUNK_SIZE                       0x100
+#    define LOG_SIZE                          0x80
 
 static uint8_t flash_buf[FLASH_SIZE];
 
+/* Flash access statistics. */
+static struct {
+    size_t number_of_reads;
+    size_t number_of_read_bytes;
+    size_t number_of_written_bytes;
+} flash_stats;
+
 #elif defined(FAMILY_SPC5)
 #    define DEVICE_INDEX                         1
 #    define FLASH_ADDRESS      SPC5_DFLASH_ADDRESS
@@ -297,7 +305,10 @@ static int test_write_flash_read_fails_blank_chunk(void)
     BTASSERT(eeprom_soft_format(&eeprom_soft) == 0);
     BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
 
-    /* Flash read fails checking blank chunk. */
+    /* Flash read fails checking blank chunk, after the identical
+       data check has read one byte. */
+    res = 1;
+    harness_mock_write("flash_read(): return (res)", &res, sizeof(res));
     res = -1;
     harness_mock_write("flash_read(): return (res)", &res, sizeof(res));
 
@@ -342,6 +353,268 @@ static int test_format_flash_erase_fails(void)
     return (0);
 }
 
+static int init_log(size_t log_size)
+{
+    BTASSERT(eeprom_soft_init(&eeprom_soft,
+                              &flash,
+                              &blocks[0],
+                              membersof(blocks),
+                              CHUNK_SIZE) == 0);
+    BTASSERT(eeprom_soft_set_log_size(&eeprom_soft, log_size) == 0);
+    BTASSERT(eeprom_soft_format(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+
+    return (0);
+}
+
+static int test_log_size_too_big_eeprom(void)
+{
+    BTASSERT(eeprom_soft_init(&eeprom_soft,
+                              &flash,
+                              &blocks[0],
+                              membersof(blocks),
+                              0x10008 + LOG_SIZE) == 0);
+
+    /* Log records cannot address an EEPROM bigger than 64 KiB. */
+    BTASSERT(eeprom_soft_set_log_size(&eeprom_soft, LOG_SIZE) == -EINVAL);
+    BTASSERT(eeprom_soft_set_log_size(&eeprom_soft, 0) == 0);
+    BTASSERT(eeprom_soft.eeprom_size == 0x10000 + LOG_SIZE);
+
+    BTASSERT(eeprom_soft_init(&eeprom_soft,
+                              &flash,
+                              &blocks[0],
+                              membersof(blocks),
+                              0x10007 + LOG_SIZE) == 0);
+    BTASSERT(eeprom_soft_set_log_size(&eeprom_soft, LOG_SIZE) == 0);
+    BTASSERT(eeprom_soft.eeprom_size == 0xffff);
+
+    return (0);
+}
+
+static int test_log_write_read(void)
+{
+    uint8_t buf[16];
+    uint8_t byte;
+    struct iov_uintptr_t dst[2];
+    struct iov_t src[2];
+
+    BTASSERT(init_log(LOG_SIZE) == 0);
+    BTASSERT(eeprom_soft.eeprom_size == CHUNK_SIZE - 8 - LOG_SIZE);
+
+    /* The log area is not part of the EEPROM. */
+    BTASSERT(eeprom_soft_read(&eeprom_soft,
+                              &buf[0],
+                              CHUNK_SIZE - 8 - LOG_SIZE,
+                              1) == -EINVAL);
+
+    /* Writes are appended to the log of the first chunk. */
+    byte = 1;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               5,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+    byte = 2;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               6,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+    BTASSERT(eeprom_soft.current.chunk_address == FLASH_ADDRESS);
+    BTASSERT(eeprom_soft.current.log_offset == 32);
+
+    /* A later write overwrites an earlier one. */
+    dst[0].address = 0;
+    dst[0].size = 6;
+    src[0].buf_p = "\x10\x11\x12\x13\x14\x15";
+    dst[1].address = 20;
+    dst[1].size = 3;
+    src[1].buf_p = "\x20\x21\x22";
+    BTASSERT(eeprom_soft_vwrite(&eeprom_soft, &dst[0], &src[0], 2) == 9);
+    BTASSERT(eeprom_soft.current.chunk_address == FLASH_ADDRESS);
+
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 8) == 8);
+    BTASSERTM(&buf[0], "\x10\x11\x12\x13\x14\x15\x02\xff", 8);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 19, 5) == 5);
+    BTASSERTM(&buf[0], "\xff\x20\x21\x22\xff", 5);
+
+    /* Identical data is not written. */
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               20,
+                               "\x20\x21",
+                               2) == 2);
+    BTASSERT(eeprom_soft.current.log_offset == 64);
+
+    /* The log is replayed when mounted. */
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft.current.log_offset == 64);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 8) == 8);
+    BTASSERTM(&buf[0], "\x10\x11\x12\x13\x14\x15\x02\xff", 8);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 19, 5) == 5);
+    BTASSERTM(&buf[0], "\xff\x20\x21\x22\xff", 5);
+
+    return (0);
+}
+
+static int test_log_compact(void)
+{
+    int i;
+    uint8_t byte;
+    uint8_t buf[8];
+
+    BTASSERT(init_log(LOG_SIZE) == 0);
+
+    /* Each one byte write is a 16 bytes record, so the log is full
+       after eight writes. */
+    for (i = 0; i < 8; i++) {
+        byte = i;
+        BTASSERT(eeprom_soft_write(&eeprom_soft,
+                                   i,
+                                   &byte,
+                                   sizeof(byte)) == sizeof(byte));
+        BTASSERT(eeprom_soft.current.chunk_address == FLASH_ADDRESS);
+    }
+
+    BTASSERT(eeprom_soft.current.log_offset == LOG_SIZE);
+
+    /* The ninth write compacts the log into the next chunk. */
+    byte = 8;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               7,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+    BTASSERT(eeprom_soft.current.chunk_address == FLASH_ADDRESS + CHUNK_SIZE);
+    BTASSERT(eeprom_soft.current.revision == 1);
+    BTASSERT(eeprom_soft.current.log_offset == 0);
+
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 8) == 8);
+    BTASSERTM(&buf[0], "\x00\x01\x02\x03\x04\x05\x06\x08", 8);
+
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft.current.chunk_address == FLASH_ADDRESS + CHUNK_SIZE);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 8) == 8);
+    BTASSERTM(&buf[0], "\x00\x01\x02\x03\x04\x05\x06\x08", 8);
+
+    return (0);
+}
+
+static int test_log_torn_record(void)
+{
+    uint8_t byte;
+    uint8_t buf[2];
+    uintptr_t log_address;
+
+    BTASSERT(init_log(LOG_SIZE) == 0);
+
+    byte = 1;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               0,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+    byte = 2;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               1,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+
+    /* Corrupt the data of the second record, as if the power was
+       lost while writing it. */
+    log_address = (FLASH_ADDRESS + CHUNK_SIZE - LOG_SIZE);
+    BTASSERT(flash_buf[log_address + 16 + 8 + 4] == 2);
+    flash_buf[log_address + 16 + 8 + 4] = 0xff;
+
+    /* The torn record is ignored and the log is full. */
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft.current.log_offset == 16);
+    BTASSERT(eeprom_soft.current.log_full == 1);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 2) == 2);
+    BTASSERTM(&buf[0], "\x01\xff", 2);
+
+    /* Next write compacts the chunk. */
+    byte = 3;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               1,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+    BTASSERT(eeprom_soft.current.chunk_address == FLASH_ADDRESS + CHUNK_SIZE);
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 2) == 2);
+    BTASSERTM(&buf[0], "\x01\x03", 2);
+
+    /* A torn record header is ignored as well. */
+    byte = 4;
+    BTASSERT(eeprom_soft_write(&eeprom_soft,
+                               0,
+                               &byte,
+                               sizeof(byte)) == sizeof(byte));
+    flash_buf[FLASH_ADDRESS + 2 * CHUNK_SIZE - LOG_SIZE + 7] = 0xff;
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft.current.log_offset == 0);
+    BTASSERT(eeprom_soft.current.log_full == 1);
+    BTASSERT(eeprom_soft_read(&eeprom_soft, &buf[0], 0, 2) == 2);
+    BTASSERTM(&buf[0], "\x01\x03", 2);
+
+    return (0);
+}
+
+static int write_updates(size_t log_size, int number_of_updates)
+{
+    int i;
+    uint32_t value;
+
+    BTASSERT(init_log(log_size) == 0);
+    memset(&flash_stats, 0, sizeof(flash_stats));
+
+    /* A four bytes counter in a fixed location, as written by for
+       example the settings module. */
+    for (i = 0; i < number_of_updates; i++) {
+        value = i;
+        BTASSERT(eeprom_soft_write(&eeprom_soft,
+                                   16,
+                                   &value,
+                                   sizeof(value)) == sizeof(value));
+    }
+
+    return (0);
+}
+
+static int test_benchmark(void)
+{
+    int i;
+    size_t log_sizes[2] = { 0, LOG_SIZE };
+    size_t number_of_chunks;
+
+    /* Bytes written to flash per update, with and without the
+       log. */
+    for (i = 0; i < membersof(log_sizes); i++) {
+        BTASSERT(write_updates(log_sizes[i], 100) == 0);
+        std_printf(FSTR("Log size %u: %u bytes written to flash "
+                        "per 4 bytes update.\r\n"),
+                   (unsigned int)log_sizes[i],
+                   (unsigned int)(flash_stats.number_of_written_bytes / 100));
+    }
+
+    /* Flash reads when mounting with most chunks of the first block
+       written. */
+    BTASSERT(write_updates(0, 50) == 0);
+    memset(&flash_stats, 0, sizeof(flash_stats));
+    BTASSERT(eeprom_soft_mount(&eeprom_soft) == 0);
+    BTASSERT(eeprom_soft.current.revision == 50);
+    number_of_chunks = (FLASH_SIZE / CHUNK_SIZE);
+
+    std_printf(FSTR("Mount: %u flash reads of %u bytes, of which %u "
+                    "header reads. A full scan reads %u headers.\r\n"),
+               (unsigned int)flash_stats.number_of_reads,
+               (unsigned int)flash_stats.number_of_read_bytes,
+               (unsigned int)(flash_stats.number_of_reads
+                              - (CHUNK_SIZE - 8) / 8),
+               (unsigned int)number_of_chunks);
+
+#if CONFIG_EEPROM_SOFT_MOUNT_BINARY_SEARCH == 1
+    BTASSERT(flash_stats.number_of_reads - (CHUNK_SIZE - 8) / 8 < 16);
+#endif
+
+    return (0);
+}
+
 int __wrap_flash_module_init(void)
 {
     return (0);
@@ -375,10 +648,15 @@ ssize_t __wrap_flash_read(struct flash_driver_t *self_p,
                                  sizeof(res));
 
     if (res2 == -ENOENT) {
-        memcpy(dst_p, &flash_buf[src], size);
         res = size;
     }
 
+    if (res >= 0) {
+        memcpy(dst_p, &flash_buf[src], res);
+        flash_stats.number_of_reads++;
+        flash_stats.number_of_read_bytes += res;
+    }
+
     return (res);
 }
 
@@ -392,6 +670,7 @@ ssize_t __wrap_flash_write(struct flash_driver_t *self_p,
     BTASSERT(size <= CHUNK_SIZE);
 
     memcpy(&flash_buf[dst], src_p, size);
+    flash_stats.number_of_written_bytes += size;
 
     return (size);
 }
@@ -441,6 +720,11 @@ int main()
         },
         { test_write_blank_chunk_not_blank, "test_write_blank_chunk_not_blank" },
         { test_format_flash_erase_fails, "test_format_flash_erase_fails" },
+        { test_log_size_too_big_eeprom, "test_log_size_too_big_eeprom" },
+        { test_log_write_read, "test_log_write_read" },
+        { test_log_compact, "test_log_compact" },
+        { test_log_torn_record, "test_log_torn_record" },
+        { test_benchmark, "test_benchmark" },
 #endif
         { NULL, NULL }
     };
@@ -273,6 +273,39 @@ static int test_read_write(void)
     return (0);
 }
 
+static int test_read_write_blocks(void)
+{
+    int i, res;
+    static uint8_t blocks[4 * SD_BLOCK_SIZE];
+
+    /* Write to and read from blocks 8 to 11 using multiple block
+       commands. */
+    for (i = 0; i < membersof(blocks); i++) {
+        blocks[i] = ((i / 3) & 0xff);
+    }
+
+    BTASSERT((res = sd_write_blocks(&sd, 8, blocks, 4)) == sizeof(blocks),
+             ", res = %d\r\n", res);
+    memset(blocks, 0, sizeof(blocks));
+    BTASSERT((res = sd_read_blocks(&sd, blocks, 8, 4)) == sizeof(blocks),
+             ", res = %d\r\n", res);
+
+    for (i = 0; i < membersof(blocks); i++) {
+        BTASSERT(blocks[i] == ((i / 3) & 0xff));
+    }
+
+    /* Single blocks written with the multiple block command can be
+       read with the single block command. */
+    BTASSERT((res = sd_read_block(&sd, buf, 10)) == SD_BLOCK_SIZE,
+             ", res = %d\r\n", res);
+
+    for (i = 0; i < membersof(buf); i++) {
+        BTASSERT(buf[i] == (((2 * SD_BLOCK_SIZE + i) / 3) & 0xff));
+    }
+
+    return (0);
+}
+
 static int test_write_performance(void)
 {
     int i, block, res;
@@ -350,6 +383,7 @@ int main()
         { test_read_cid, "test_read_cid" },
         { test_read_csd, "test_read_csd" },
         { test_read_write, "test_read_write" },
+        { test_read_write_blocks, "test_read_write_blocks" },
         { test_write_performance, "test_write_performance" },
         { test_read_performance, "test_read_performance" },
         { NULL, NULL }
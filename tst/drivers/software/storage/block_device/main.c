@@ -0,0 +1,593 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "file_block_device.h"
+
+#define DISK_BLOCKS                                     32768
+#define NUMBER_OF_BUFFERS                                  16
+
+/* Emulated SD card over SPI transfer times. */
+#define COMMAND_LATENCY_US                                300
+#define BLOCK_LATENCY_US                                   80
+
+struct device_t {
+    struct block_device_t block_device;
+    struct block_device_buffer_t buffers[NUMBER_OF_BUFFERS];
+    uint8_t data[NUMBER_OF_BUFFERS][BLOCK_DEVICE_BLOCK_SIZE];
+};
+
+static struct file_block_device_t disk;
+static struct device_t inline_device;
+static struct device_t worker_device;
+static THRD_STACK(worker_stack, 2048);
+static uint8_t buf[BLOCK_DEVICE_BLOCK_SIZE];
+static uint8_t file_buf[4 * BLOCK_DEVICE_BLOCK_SIZE];
+
+/* Commands of the raw callbacks. */
+static int raw_reads;
+static int raw_writes;
+
+static ssize_t raw_read(void *arg_p,
+                        void *dst_p,
+                        uint32_t src_block)
+{
+    raw_reads++;
+
+    return (file_block_device_read(arg_p, dst_p, src_block, 1));
+}
+
+static ssize_t raw_write(void *arg_p,
+                         uint32_t dst_block,
+                         const void *src_p)
+{
+    raw_writes++;
+
+    return (file_block_device_write(arg_p, dst_block, src_p, 1));
+}
+
+static ssize_t failing_write(void *arg_p,
+                             uint32_t dst_block,
+                             const void *src_p,
+                             size_t number_of_blocks)
+{
+    return (-EIO);
+}
+
+/* Block read by the write callback below. */
+static uint32_t nested_block;
+static ssize_t nested_res;
+
+/**
+ * Read a block on the first write, while the block device mutex is
+ * released.
+ */
+static ssize_t reading_write(void *arg_p,
+                             uint32_t dst_block,
+                             const void *src_p,
+                             size_t number_of_blocks)
+{
+    static uint8_t nested_buf[BLOCK_DEVICE_BLOCK_SIZE];
+
+    if (nested_res == 0) {
+        nested_res = -1;
+        nested_res = block_device_read(&inline_device.block_device,
+                                       &nested_buf[0],
+                                       nested_block);
+    }
+
+    return (file_block_device_write(arg_p,
+                                    dst_block,
+                                    src_p,
+                                    number_of_blocks));
+}
+
+static void fill(uint8_t *buf_p, uint32_t block, int salt)
+{
+    int i;
+
+    for (i = 0; i < BLOCK_DEVICE_BLOCK_SIZE; i++) {
+        buf_p[i] = (block + i + salt);
+    }
+}
+
+static int is_filled(const uint8_t *buf_p, uint32_t block, int salt)
+{
+    int i;
+
+    for (i = 0; i < BLOCK_DEVICE_BLOCK_SIZE; i++) {
+        if (buf_p[i] != (uint8_t)(block + i + salt)) {
+            return (0);
+        }
+    }
+
+    return (1);
+}
+
+static void device_init(struct device_t *device_p)
+{
+    block_device_init(&device_p->block_device,
+                      (block_device_read_t)file_block_device_read,
+                      (block_device_write_t)file_block_device_write,
+                      &disk,
+                      &device_p->buffers[0],
+                      &device_p->data[0][0],
+                      NUMBER_OF_BUFFERS);
+}
+
+static int test_init(void)
+{
+    BTASSERT(file_block_device_init(&disk, "disk", DISK_BLOCKS) == 0);
+    device_init(&inline_device);
+
+    return (0);
+}
+
+static int test_read_write(void)
+{
+    uint32_t block;
+    struct block_device_t *block_device_p;
+
+    block_device_p = &inline_device.block_device;
+
+    /* Write blocks and read them back from the buffers. */
+    for (block = 0; block < 40; block++) {
+        fill(&buf[0], block, 0);
+        BTASSERT(block_device_write(block_device_p, block, &buf[0])
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        memset(&buf[0], 0, sizeof(buf));
+        BTASSERT(block_device_read(block_device_p, &buf[0], block)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], block, 0));
+    }
+
+    BTASSERT(block_device_flush(block_device_p) == 0);
+
+    /* All blocks are on the disk after the flush. */
+    for (block = 0; block < 40; block++) {
+        BTASSERT(file_block_device_read(&disk, &buf[0], block, 1)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], block, 0));
+    }
+
+    /* Read from the disk. */
+    for (block = 0; block < 40; block += 3) {
+        BTASSERT(block_device_read(block_device_p, &buf[0], block)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], block, 0));
+    }
+
+    /* Out of range. */
+    BTASSERT(block_device_read(block_device_p, &buf[0], DISK_BLOCKS)
+             == -EINVAL);
+
+    return (0);
+}
+
+static int test_read_ahead(void)
+{
+    uint32_t block;
+    struct block_device_t *block_device_p;
+    struct block_device_stats_t stats;
+
+    device_init(&inline_device);
+    block_device_p = &inline_device.block_device;
+    BTASSERT(block_device_set_read_ahead(block_device_p, 4) == 0);
+
+    /* The first read is random, and the following reads are
+       sequential and read four blocks ahead. */
+    for (block = 100; block < 132; block++) {
+        BTASSERT(block_device_read(block_device_p, &buf[0], block)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+    }
+
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.misses, ==, 8);
+    BTASSERTI(stats.hits, ==, 24);
+    BTASSERTI(stats.device_reads, ==, 8);
+    BTASSERTI(stats.device_blocks_read, ==, 1 + 7 * 5);
+
+    /* Random reads do not read ahead. */
+    BTASSERT(block_device_read(block_device_p, &buf[0], 1000)
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERT(block_device_read(block_device_p, &buf[0], 2000)
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.device_reads, ==, 10);
+    BTASSERTI(stats.device_blocks_read, ==, 38);
+
+    /* No read-ahead. */
+    BTASSERT(block_device_set_read_ahead(block_device_p, 0) == 0);
+
+    for (block = 3000; block < 3004; block++) {
+        BTASSERT(block_device_read(block_device_p, &buf[0], block)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+    }
+
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.device_reads, ==, 14);
+    BTASSERTI(stats.device_blocks_read, ==, 42);
+
+    return (0);
+}
+
+static int test_write_behind(void)
+{
+    int i;
+    uint32_t block;
+    struct block_device_t *block_device_p;
+    struct block_device_stats_t stats;
+
+    device_init(&inline_device);
+    block_device_p = &inline_device.block_device;
+
+    /* Seven consecutive blocks are buffered. */
+    for (block = 200; block < 207; block++) {
+        fill(&buf[0], block, 1);
+        BTASSERT(block_device_write(block_device_p, block, &buf[0])
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+    }
+
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.device_writes, ==, 0);
+
+    /* Half of the buffers are dirty after the eighth block, and all
+       are written in one transfer. */
+    fill(&buf[0], block, 1);
+    BTASSERT(block_device_write(block_device_p, block, &buf[0])
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.device_writes, ==, 1);
+    BTASSERTI(stats.device_blocks_written, ==, 8);
+
+    /* Repeated writes of a block are written once. */
+    for (i = 0; i < 3; i++) {
+        fill(&buf[0], 300, i);
+        BTASSERT(block_device_write(block_device_p, 300, &buf[0])
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+    }
+
+    BTASSERT(block_device_flush(block_device_p) == 0);
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.device_writes, ==, 2);
+    BTASSERTI(stats.device_blocks_written, ==, 9);
+    BTASSERTI(stats.flushes, ==, 1);
+
+    BTASSERT(file_block_device_read(&disk, &buf[0], 300, 1)
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERT(is_filled(&buf[0], 300, 2));
+
+    for (block = 200; block < 208; block++) {
+        BTASSERT(file_block_device_read(&disk, &buf[0], block, 1)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], block, 1));
+    }
+
+    /* Flushing nothing. */
+    BTASSERT(block_device_flush(block_device_p) == 0);
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.device_writes, ==, 2);
+
+    return (0);
+}
+
+static int test_write_error(void)
+{
+    struct block_device_t *block_device_p;
+
+    block_device_p = &inline_device.block_device;
+    block_device_init(block_device_p,
+                      (block_device_read_t)file_block_device_read,
+                      failing_write,
+                      &disk,
+                      &inline_device.buffers[0],
+                      &inline_device.data[0][0],
+                      NUMBER_OF_BUFFERS);
+
+    /* The write is buffered and fails on flush. */
+    fill(&buf[0], 400, 0);
+    BTASSERT(block_device_write(block_device_p, 400, &buf[0])
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERTI(block_device_flush(block_device_p), ==, -EIO);
+    BTASSERT(block_device_flush(block_device_p) == 0);
+
+    /* The block was discarded. */
+    BTASSERT(block_device_read(block_device_p, &buf[0], 400)
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERT(!is_filled(&buf[0], 400, 0));
+
+    return (0);
+}
+
+static int test_read_while_making_room(void)
+{
+    int i;
+    struct block_device_t *block_device_p;
+    struct block_device_stats_t stats;
+
+    block_device_p = &inline_device.block_device;
+    block_device_init(block_device_p,
+                      (block_device_read_t)file_block_device_read,
+                      reading_write,
+                      &disk,
+                      &inline_device.buffers[0],
+                      &inline_device.data[0][0],
+                      NUMBER_OF_BUFFERS);
+    BTASSERT(block_device_set_read_ahead(block_device_p, 0) == 0);
+    block_device_p->write_behind = (NUMBER_OF_BUFFERS + 1);
+
+    /* Make all buffers dirty, with one block per write back. */
+    for (i = 0; i < NUMBER_OF_BUFFERS; i++) {
+        fill(&buf[0], 600 + 2 * i, 4);
+        BTASSERT(block_device_write(block_device_p, 600 + 2 * i, &buf[0])
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+    }
+
+    /* The block is read by the write callback while room is made
+       for it, and must then be found in the buffers instead of
+       being read again into another buffer. */
+    nested_block = 700;
+    nested_res = 0;
+    BTASSERT(block_device_read(block_device_p, &buf[0], 700)
+             == BLOCK_DEVICE_BLOCK_SIZE);
+    BTASSERTI(nested_res, ==, BLOCK_DEVICE_BLOCK_SIZE);
+
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERTI(stats.misses, ==, 1);
+    BTASSERTI(stats.hits, ==, 1);
+    BTASSERTI(stats.device_reads, ==, 1);
+
+    BTASSERT(block_device_flush(block_device_p) == 0);
+
+    for (i = 0; i < NUMBER_OF_BUFFERS; i++) {
+        BTASSERT(file_block_device_read(&disk, &buf[0], 600 + 2 * i, 1)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], 600 + 2 * i, 4));
+    }
+
+    return (0);
+}
+
+static int test_worker(void)
+{
+    uint32_t block;
+    struct block_device_t *block_device_p;
+    struct block_device_stats_t stats;
+
+    device_init(&worker_device);
+    block_device_p = &worker_device.block_device;
+    BTASSERT(thrd_spawn(block_device_main,
+                        block_device_p,
+                        0,
+                        worker_stack,
+                        sizeof(worker_stack)) != NULL);
+    thrd_yield();
+    BTASSERT(block_device_p->worker_running == 1);
+
+    /* Write behind. */
+    for (block = 500; block < 564; block++) {
+        fill(&buf[0], block, 3);
+        BTASSERT(block_device_write(block_device_p, block, &buf[0])
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+    }
+
+    BTASSERT(block_device_flush(block_device_p) == 0);
+
+    for (block = 500; block < 564; block++) {
+        BTASSERT(file_block_device_read(&disk, &buf[0], block, 1)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], block, 3));
+    }
+
+    /* Read ahead. */
+    for (block = 500; block < 564; block++) {
+        BTASSERT(block_device_read(block_device_p, &buf[0], block)
+                 == BLOCK_DEVICE_BLOCK_SIZE);
+        BTASSERT(is_filled(&buf[0], block, 3));
+    }
+
+    BTASSERT(block_device_get_stats(block_device_p, &stats) == 0);
+    BTASSERT(stats.read_ahead_blocks > 0);
+    BTASSERT(stats.device_blocks_written >= 64);
+
+    return (0);
+}
+
+/**
+ * Write a file of given size and read it back.
+ */
+static int write_read_file(struct fat16_t *fs_p, size_t size)
+{
+    struct fat16_file_t file;
+    size_t offset;
+    size_t i;
+
+    BTASSERT(fat16_format(fs_p) == 0);
+    BTASSERT(fat16_mount(fs_p) == 0);
+
+    BTASSERT(fat16_file_open(fs_p,
+                             &file,
+                             "DATA.BIN",
+                             O_CREAT | O_WRITE | O_TRUNC) == 0);
+
+    for (offset = 0; offset < size; offset += sizeof(file_buf)) {
+        for (i = 0; i < sizeof(file_buf); i++) {
+            file_buf[i] = (offset + i) / 3;
+        }
+
+        BTASSERT(fat16_file_write(&file, &file_buf[0], sizeof(file_buf))
+                 == sizeof(file_buf));
+    }
+
+    BTASSERT(fat16_file_close(&file) == 0);
+
+    BTASSERT(fat16_file_open(fs_p, &file, "DATA.BIN", O_READ) == 0);
+
+    for (offset = 0; offset < size; offset += sizeof(file_buf)) {
+        BTASSERT(fat16_file_read(&file, &file_buf[0], sizeof(file_buf))
+                 == sizeof(file_buf));
+
+        for (i = 0; i < sizeof(file_buf); i++) {
+            BTASSERT(file_buf[i] == (uint8_t)((offset + i) / 3));
+        }
+    }
+
+    BTASSERT(fat16_file_close(&file) == 0);
+    BTASSERT(fat16_unmount(fs_p) == 0);
+
+    return (0);
+}
+
+static int test_fat16(void)
+{
+    struct fat16_t fs;
+    struct fat16_t raw_fs;
+    struct fat16_file_t file;
+
+    device_init(&inline_device);
+    BTASSERT(fat16_init_block_device(&fs,
+                                     &inline_device.block_device,
+                                     0) == 0);
+    BTASSERT(write_read_file(&fs, 32768) == 0);
+
+    /* The file is on the disk after unmount. */
+    BTASSERT(fat16_init(&raw_fs, raw_read, raw_write, &disk, 0) == 0);
+    BTASSERT(fat16_mount(&raw_fs) == 0);
+    BTASSERT(fat16_file_open(&raw_fs, &file, "DATA.BIN", O_READ) == 0);
+    BTASSERTI(fat16_file_size(&file), ==, 32768);
+    BTASSERT(fat16_file_read(&file, &file_buf[0], 4) == 4);
+    BTASSERTM(&file_buf[0], "\x00\x00\x00\x01", 4);
+    BTASSERT(fat16_file_close(&file) == 0);
+    BTASSERT(fat16_unmount(&raw_fs) == 0);
+
+    return (0);
+}
+
+static int benchmark(const char *name_p, struct fat16_t *fs_p)
+{
+    int start;
+    int elapsed;
+
+    start = time_micros();
+    BTASSERT(write_read_file(fs_p, 131072) == 0);
+    elapsed = time_micros_elapsed(start, time_micros());
+
+    std_printf(OSTR("%-8s %8d us\r\n"), name_p, elapsed);
+
+    return (0);
+}
+
+static int test_benchmark(void)
+{
+    struct fat16_t fs;
+    struct block_device_stats_t stats;
+
+    BTASSERT(file_block_device_set_latency(&disk,
+                                           COMMAND_LATENCY_US,
+                                           BLOCK_LATENCY_US) == 0);
+
+    std_printf(OSTR("Format, write and read a 128 kB file. "
+                    "Command latency %d us and block latency %d us.\r\n"),
+               COMMAND_LATENCY_US,
+               BLOCK_LATENCY_US);
+
+    /* Raw block callbacks. */
+    raw_reads = 0;
+    raw_writes = 0;
+    BTASSERT(fat16_init(&fs, raw_read, raw_write, &disk, 0) == 0);
+    BTASSERT(benchmark("raw", &fs) == 0);
+    std_printf(OSTR("         %d reads, %d writes\r\n"),
+               raw_reads,
+               raw_writes);
+
+    /* Block device without worker thread. */
+    device_init(&inline_device);
+    BTASSERT(fat16_init_block_device(&fs,
+                                     &inline_device.block_device,
+                                     0) == 0);
+    BTASSERT(benchmark("inline", &fs) == 0);
+    BTASSERT(block_device_get_stats(&inline_device.block_device,
+                                    &stats) == 0);
+    std_printf(OSTR("         %lu reads (%lu blocks), "
+                    "%lu writes (%lu blocks)\r\n"),
+               (unsigned long)stats.device_reads,
+               (unsigned long)stats.device_blocks_read,
+               (unsigned long)stats.device_writes,
+               (unsigned long)stats.device_blocks_written);
+
+    /* Block device with worker thread. */
+    memset(&worker_device.block_device.stats,
+           0,
+           sizeof(worker_device.block_device.stats));
+    BTASSERT(fat16_init_block_device(&fs,
+                                     &worker_device.block_device,
+                                     0) == 0);
+    BTASSERT(benchmark("worker", &fs) == 0);
+    BTASSERT(block_device_get_stats(&worker_device.block_device,
+                                    &stats) == 0);
+    std_printf(OSTR("         %lu reads (%lu blocks), "
+                    "%lu writes (%lu blocks)\r\n"),
+               (unsigned long)stats.device_reads,
+               (unsigned long)stats.device_blocks_read,
+               (unsigned long)stats.device_writes,
+               (unsigned long)stats.device_blocks_written);
+
+    BTASSERT(file_block_device_set_latency(&disk, 0, 0) == 0);
+
+    return (0);
+}
+
+static int test_close(void)
+{
+    BTASSERT(file_block_device_close(&disk) == 0);
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_read_write, "test_read_write" },
+        { test_read_ahead, "test_read_ahead" },
+        { test_write_behind, "test_write_behind" },
+        { test_write_error, "test_write_error" },
+        { test_read_while_making_room, "test_read_while_making_room" },
+        { test_worker, "test_worker" },
+        { test_fat16, "test_fat16" },
+        { test_benchmark, "test_benchmark" },
+        { test_close, "test_close" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -143,11 +143,254 @@ static int test_decode(void)
     return (0);
 }
 
+static int test_encode_decode_long(void)
+{
+    int i;
+    size_t size;
+    static uint8_t buf[300];
+    static char encoded[400];
+    static uint8_t decoded[300];
+
+    for (i = 0; i < membersof(buf); i++) {
+        buf[i] = (7 * i + 3);
+    }
+
+    /* All sizes to exercise both the block and the tail code. */
+    for (size = 0; size <= sizeof(buf); size++) {
+        BTASSERT(base64_encode(&encoded[0], &buf[0], size) == 0);
+        memset(&decoded[0], 0, sizeof(decoded));
+        BTASSERT(base64_decode(&decoded[0],
+                               &encoded[0],
+                               4 * ((size + 2) / 3)) == 0);
+        BTASSERT(memcmp(&decoded[0], &buf[0], size) == 0);
+    }
+
+    /* An invalid character after a few valid blocks. */
+    BTASSERT(base64_encode(&encoded[0], &buf[0], 96) == 0);
+    encoded[100] = '*';
+    BTASSERT(base64_decode(&decoded[0], &encoded[0], 128) == -1);
+
+    return (0);
+}
+
+static int test_encoder(void)
+{
+    struct base64_encoder_t encoder;
+    char buf[512];
+    size_t chunk_size;
+    size_t size;
+    size_t offset;
+    ssize_t res;
+
+    for (chunk_size = 1; chunk_size < 70; chunk_size++) {
+        BTASSERT(base64_encoder_init(&encoder) == 0);
+        size = 0;
+
+        for (offset = 0;
+             offset < strlen(decoded_text);
+             offset += chunk_size) {
+            res = base64_encoder_update(
+                &encoder,
+                &buf[size],
+                &decoded_text[offset],
+                MIN(chunk_size, strlen(decoded_text) - offset));
+            BTASSERT(res >= 0);
+            size += res;
+        }
+
+        res = base64_encoder_finalize(&encoder, &buf[size]);
+        BTASSERTI(res, ==, 4);
+        size += res;
+        BTASSERTI(size, ==, strlen(encoded_text));
+        BTASSERTM(&buf[0], &encoded_text[0], size);
+    }
+
+    /* Nothing to finalize. */
+    BTASSERT(base64_encoder_init(&encoder) == 0);
+    BTASSERT(base64_encoder_update(&encoder, &buf[0], "foo", 3) == 4);
+    BTASSERT(base64_encoder_finalize(&encoder, &buf[4]) == 0);
+    BTASSERTM(&buf[0], "Zm9v", 4);
+
+    return (0);
+}
+
+static int test_decoder(void)
+{
+    struct base64_decoder_t decoder;
+    char buf[512];
+    size_t chunk_size;
+    size_t size;
+    size_t offset;
+    ssize_t res;
+
+    for (chunk_size = 1; chunk_size < 70; chunk_size++) {
+        BTASSERT(base64_decoder_init(&decoder) == 0);
+        size = 0;
+
+        for (offset = 0;
+             offset < strlen(encoded_text);
+             offset += chunk_size) {
+            res = base64_decoder_update(
+                &decoder,
+                &buf[size],
+                &encoded_text[offset],
+                MIN(chunk_size, strlen(encoded_text) - offset));
+            BTASSERT(res >= 0);
+            size += res;
+        }
+
+        BTASSERT(base64_decoder_finalize(&decoder) == 0);
+        BTASSERTI(size, ==, strlen(decoded_text));
+        BTASSERTM(&buf[0], &decoded_text[0], size);
+    }
+
+    return (0);
+}
+
+static int test_decoder_invalid(void)
+{
+    struct base64_decoder_t decoder;
+    char buf[8];
+
+    /* Invalid character. */
+    BTASSERT(base64_decoder_init(&decoder) == 0);
+    BTASSERT(base64_decoder_update(&decoder, &buf[0], "Zm9*", 4) == -EINVAL);
+
+    /* Invalid padding. */
+    BTASSERT(base64_decoder_init(&decoder) == 0);
+    BTASSERT(base64_decoder_update(&decoder, &buf[0], "Z===", 4) == -EINVAL);
+
+    BTASSERT(base64_decoder_init(&decoder) == 0);
+    BTASSERT(base64_decoder_update(&decoder, &buf[0], "Zm=v", 4) == -EINVAL);
+
+    /* Data after padding. */
+    BTASSERT(base64_decoder_init(&decoder) == 0);
+    BTASSERT(base64_decoder_update(&decoder, &buf[0], "Zg==", 4) == 1);
+    BTASSERT(base64_decoder_update(&decoder, &buf[1], "Zm9v", 4) == -EINVAL);
+
+    /* Incomplete block. */
+    BTASSERT(base64_decoder_init(&decoder) == 0);
+    BTASSERT(base64_decoder_update(&decoder, &buf[0], "Zm9vYm", 6) == 3);
+    BTASSERT(base64_decoder_finalize(&decoder) == -EINVAL);
+
+    return (0);
+}
+
+static int test_queue_stream(void)
+{
+    struct queue_t queue;
+    struct base64_encoder_t encoder;
+    struct base64_decoder_t decoder;
+    char queue_buf[512];
+    char chunk[16];
+    char encoded[24];
+    char buf[512];
+    size_t offset;
+    size_t size;
+    ssize_t res;
+
+    BTASSERT(queue_init(&queue, &queue_buf[0], sizeof(queue_buf)) == 0);
+    BTASSERT(base64_encoder_init(&encoder) == 0);
+    BTASSERT(base64_decoder_init(&decoder) == 0);
+
+    /* Encode the text in small chunks into the queue. */
+    for (offset = 0; offset < strlen(decoded_text); offset += 11) {
+        res = base64_encoder_update(
+            &encoder,
+            &encoded[0],
+            &decoded_text[offset],
+            MIN(11, strlen(decoded_text) - offset));
+        BTASSERT(res >= 0);
+        BTASSERT(queue_write(&queue, &encoded[0], res) == res);
+    }
+
+    res = base64_encoder_finalize(&encoder, &encoded[0]);
+    BTASSERT(queue_write(&queue, &encoded[0], res) == res);
+
+    /* Read and decode it in chunks of another size. */
+    size = 0;
+
+    while (queue_size(&queue) > 0) {
+        res = MIN(sizeof(chunk), queue_size(&queue));
+        BTASSERT(queue_read(&queue, &chunk[0], res) == res);
+        res = base64_decoder_update(&decoder, &buf[size], &chunk[0], res);
+        BTASSERT(res >= 0);
+        size += res;
+    }
+
+    BTASSERT(base64_decoder_finalize(&decoder) == 0);
+    BTASSERTI(size, ==, strlen(decoded_text));
+    BTASSERTM(&buf[0], &decoded_text[0], size);
+
+    return (0);
+}
+
+static int test_performance(void)
+{
+    static uint8_t buf[1536];
+    static char encoded[2048];
+    int start;
+    int i;
+    long us;
+    unsigned long rate;
+
+    for (i = 0; i < membersof(buf); i++) {
+        buf[i] = i;
+    }
+
+    start = time_micros();
+
+    for (i = 0; i < 256; i++) {
+        BTASSERT(base64_encode(&encoded[0], &buf[0], sizeof(buf)) == 0);
+    }
+
+    us = time_micros_elapsed(start, time_micros());
+
+    if (us == 0) {
+        us = 1;
+    }
+
+    /* Bytes per microsecond is MB/s. Keep two decimals. */
+    rate = ((100UL * 256 * sizeof(buf)) / us);
+    std_printf(OSTR("Encoded %lu bytes in %ld us (%lu.%02lu MB/s).\r\n"),
+               (unsigned long)(256 * sizeof(buf)),
+               us,
+               rate / 100,
+               rate % 100);
+
+    start = time_micros();
+
+    for (i = 0; i < 256; i++) {
+        BTASSERT(base64_decode(&buf[0], &encoded[0], sizeof(encoded)) == 0);
+    }
+
+    us = time_micros_elapsed(start, time_micros());
+
+    if (us == 0) {
+        us = 1;
+    }
+
+    rate = ((100UL * 256 * sizeof(encoded)) / us);
+    std_printf(OSTR("Decoded %lu bytes in %ld us (%lu.%02lu MB/s).\r\n"),
+               (unsigned long)(256 * sizeof(encoded)),
+               us,
+               rate / 100,
+               rate % 100);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_encode, "test_encode" },
         { test_decode, "test_decode" },
+        { test_encode_decode_long, "test_encode_decode_long" },
+        { test_encoder, "test_encoder" },
+        { test_decoder, "test_decoder" },
+        { test_decoder_invalid, "test_decoder_invalid" },
+        { test_queue_stream, "test_queue_stream" },
+        { test_performance, "test_performance" },
         { NULL, NULL }
     };
 
@@ -76,6 +76,31 @@ static int test_from_bin(void)
     return (0);
 }
 
+static int test_from_bin_to_bin_long(void)
+{
+    int i;
+    size_t size;
+    uint8_t buf[100];
+    char encoded[201];
+    uint8_t decoded[100];
+
+    for (i = 0; i < membersof(buf); i++) {
+        buf[i] = (7 * i + 3);
+    }
+
+    /* All sizes to exercise both the vector and the byte code. */
+    for (size = 0; size <= sizeof(buf); size++) {
+        BTASSERTI(hex_from_bin(&encoded[0], &buf[0], size), ==, 2 * size);
+        BTASSERTI(strlen(&encoded[0]), ==, 2 * size);
+        BTASSERTI(hex_to_bin(&decoded[0], &encoded[0], 2 * size), ==, size);
+        BTASSERTM(&decoded[0], &buf[0], size);
+    }
+
+    BTASSERTM(&encoded[0], "030a11181f262d343b", 18);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -83,6 +108,7 @@ int main()
         { test_to_bin_non_hex_character, "test_to_bin_non_hex_character" },
         { test_to_bin_odd_length, "test_to_bin_odd_length" },
         { test_from_bin, "test_from_bin" },
+        { test_from_bin_to_bin_long, "test_from_bin_to_bin_long" },
         { NULL, NULL }
     };
 
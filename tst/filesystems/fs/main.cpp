@@ -36,6 +36,7 @@ static struct fs_command_t bar;
 
 static struct fs_counter_t my_counter;
 static struct fs_counter_t your_counter;
+static struct fs_histogram_t latency_histogram;
 
 static int our_parameter_value = OUR_PARAMETER_DEFAULT;
 static struct fs_parameter_t our_parameter;
@@ -188,6 +189,92 @@ static int tmp_bar(int argc,
 static struct queue_t qout;
 static char qoutbuf[BUFFER_SIZE];
 
+#if defined(ARCH_LINUX)
+
+#define BENCHMARK_MODULES                                   20
+#define BENCHMARK_COMMANDS_PER_MODULE                       20
+#define BENCHMARK_COMMANDS                                     \
+    (BENCHMARK_MODULES * BENCHMARK_COMMANDS_PER_MODULE)
+#define BENCHMARK_ITERATIONS                              2000
+
+static struct fs_command_t benchmark_commands[BENCHMARK_COMMANDS];
+static char benchmark_paths[BENCHMARK_COMMANDS][32];
+static int benchmark_calls[BENCHMARK_COMMANDS];
+
+static int benchmark_cb(int argc,
+                        const char *argv[],
+                        void *out_p,
+                        void *in_p,
+                        void *arg_p,
+                        void *call_arg_p)
+{
+    (*(int *)arg_p)++;
+
+    return (argc);
+}
+
+#if CONFIG_THRD_POOL_NATIVE == 1
+
+#define PARALLEL_WORKERS                                     4
+#define PARALLEL_INCREMENTS                             262144
+
+static struct thrd_pool_t parallel_pool;
+static struct thrd_pool_worker_t parallel_workers[PARALLEL_WORKERS];
+static struct thrd_pool_future_t parallel_futures[PARALLEL_WORKERS];
+static struct fs_counter_t parallel_counter;
+static struct fs_histogram_t parallel_histogram;
+static uint64_t shared_value;
+
+static void *increment_counter(void *arg_p)
+{
+    int i;
+
+    for (i = 0; i < PARALLEL_INCREMENTS; i++) {
+        fs_counter_increment(&parallel_counter, 1);
+    }
+
+    return (NULL);
+}
+
+static void *increment_shared_value(void *arg_p)
+{
+    int i;
+
+    for (i = 0; i < PARALLEL_INCREMENTS; i++) {
+        ATOMIC_ADD(&shared_value, 1);
+    }
+
+    return (NULL);
+}
+
+static void *record_histogram(void *arg_p)
+{
+    uint32_t i;
+
+    for (i = 0; i < PARALLEL_INCREMENTS; i++) {
+        fs_histogram_record(&parallel_histogram, i & 0xff);
+    }
+
+    return (NULL);
+}
+
+#endif
+
+#endif
+
+static struct fs_command_t first_foo;
+static struct fs_command_t second_foo;
+
+static int foo_cb(int argc,
+                  const char *argv[],
+                  void *out_p,
+                  void *in_p,
+                  void *arg_p,
+                  void *call_arg_p)
+{
+    return ((int)(uintptr_t)arg_p);
+}
+
 #if defined(ARCH_LINUX)
 static struct queue_t qin;
 static char qinbuf[32];
@@ -301,6 +388,256 @@ static int test_counter(void)
     return (0);
 }
 
+static int test_histogram(void)
+{
+    char buf[64];
+
+    BTASSERT(fs_histogram_init(&latency_histogram,
+                               FSTR("/my/latency")) == 0);
+    BTASSERT(fs_histogram_register(&latency_histogram) == 0);
+
+    BTASSERT(fs_histogram_record(&latency_histogram, 0) == 0);
+    BTASSERT(fs_histogram_record(&latency_histogram, 1) == 0);
+    BTASSERT(fs_histogram_record(&latency_histogram, 5) == 0);
+    BTASSERT(fs_histogram_record(&latency_histogram, 6) == 0);
+    BTASSERT(fs_histogram_record(&latency_histogram, 7) == 0);
+    BTASSERT(fs_histogram_record(&latency_histogram, 100000) == 0);
+    BTASSERT(latency_histogram.buckets[0] == 1);
+    BTASSERT(latency_histogram.buckets[1] == 1);
+    BTASSERT(latency_histogram.buckets[3] == 3);
+    BTASSERT(latency_histogram.buckets[CONFIG_FS_HISTOGRAM_BUCKETS - 1] == 1);
+
+    strcpy(buf, "my/latency");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == 0);
+    BTASSERT(harness_expect(&qout,
+                            "count: 6\r\n"
+                            "sum: 00000000000186b3\r\n"
+                            "max: 100000\r\n"
+                            "0: 1\r\n"
+                            "1-1: 1\r\n"
+                            "4-7: 3\r\n"
+                            "16384-: 1\r\n",
+                            NULL) > 0);
+
+    /* Any argument resets the histogram. */
+    strcpy(buf, "my/latency reset");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == 0);
+
+    strcpy(buf, "my/latency");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == 0);
+    BTASSERT(harness_expect(&qout,
+                            "count: 0\r\n"
+                            "sum: 0000000000000000\r\n"
+                            "max: 0\r\n",
+                            NULL) > 0);
+
+    /* Counters reset also resets the histograms. */
+    BTASSERT(fs_histogram_record(&latency_histogram, 2) == 0);
+    strcpy(buf, "filesystems/fs/counters/reset");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == 0);
+    BTASSERT(latency_histogram.buckets[2] == 0);
+    BTASSERT(latency_histogram.sum == 0);
+
+    return (0);
+}
+
+/**
+ * Find given entry in given counters snapshot. Returns a pointer to
+ * the entry value, or NULL if missing.
+ */
+static const uint8_t *snapshot_find(const uint8_t *buf_p,
+                                    ssize_t size,
+                                    int type,
+                                    const char *path_p)
+{
+    const uint8_t *end_p;
+    int number_of_entries;
+    int length;
+
+    end_p = &buf_p[size];
+    number_of_entries = (buf_p[6] | (buf_p[7] << 8));
+    buf_p += 8;
+
+    while (number_of_entries > 0) {
+        length = buf_p[1];
+
+        if ((buf_p[0] == type)
+            && (length == (int)strlen(path_p))
+            && (memcmp(&buf_p[2], path_p, length) == 0)) {
+            return (&buf_p[2 + length]);
+        }
+
+        buf_p += (2 + length);
+
+        if (buf_p[-2 - length] == 0) {
+            buf_p += 8;
+        } else {
+            buf_p += (13 + 4 * buf_p[0]);
+        }
+
+        if (buf_p > end_p) {
+            return (NULL);
+        }
+
+        number_of_entries--;
+    }
+
+    return (NULL);
+}
+
+static uint64_t unpack(const uint8_t *buf_p, int size)
+{
+    uint64_t value;
+
+    value = 0;
+
+    while (size > 0) {
+        size--;
+        value <<= 8;
+        value |= buf_p[size];
+    }
+
+    return (value);
+}
+
+static int test_counters_snapshot(void)
+{
+    uint8_t buf[512];
+    const uint8_t *value_p;
+    ssize_t size;
+
+    fs_counter_increment(&my_counter, 0x123456789LL);
+    BTASSERT(fs_histogram_record(&latency_histogram, 3) == 0);
+    BTASSERT(fs_histogram_record(&latency_histogram, 1000) == 0);
+
+    size = fs_counters_snapshot(NULL, 0);
+    BTASSERT(size > 8);
+    BTASSERT(size <= (ssize_t)sizeof(buf));
+    BTASSERT(fs_counters_snapshot(&buf[0], size - 1) == -ENOMEM);
+    BTASSERT(fs_counters_snapshot(&buf[0], sizeof(buf)) == size);
+
+    /* Header. */
+    BTASSERT(memcmp(&buf[0], "FSCS", 4) == 0);
+    BTASSERT(unpack(&buf[4], 2) == 1);
+    BTASSERT(unpack(&buf[6], 2) >= 3);
+
+    /* Counters. */
+    value_p = snapshot_find(&buf[0], size, 0, "/my/counter");
+    BTASSERT(value_p != NULL);
+    BTASSERT(unpack(value_p, 8) == 0x123456789LL);
+
+    value_p = snapshot_find(&buf[0], size, 0, "/your/counter");
+    BTASSERT(value_p != NULL);
+    BTASSERT(unpack(value_p, 8) == 0);
+
+    /* Histogram. */
+    value_p = snapshot_find(&buf[0], size, 1, "/my/latency");
+    BTASSERT(value_p != NULL);
+    BTASSERT(value_p[0] == CONFIG_FS_HISTOGRAM_BUCKETS);
+    BTASSERT(unpack(&value_p[1], 8) == 1003);
+    BTASSERT(unpack(&value_p[9], 4) == 1000);
+    BTASSERT(unpack(&value_p[13 + 4 * 2], 4) == 1);
+    BTASSERT(unpack(&value_p[13 + 4 * 10], 4) == 1);
+
+    BTASSERT(snapshot_find(&buf[0], size, 1, "/my/counter") == NULL);
+
+    strcpy((char *)&buf[0], "filesystems/fs/counters/reset");
+    BTASSERT(fs_call((char *)&buf[0], NULL, &qout, NULL) == 0);
+
+    return (0);
+}
+
+static int test_counter_parallel(void)
+{
+#if defined(ARCH_LINUX) && (CONFIG_THRD_POOL_NATIVE == 1)
+
+    int i;
+    int j;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t count;
+    void *(*jobs[3])(void *) = {
+        increment_counter,
+        increment_shared_value,
+        record_histogram
+    };
+    const char *names[3] = {
+        "counter",
+        "shared",
+        "histogram"
+    };
+
+    BTASSERT(fs_counter_init(&parallel_counter,
+                             FSTR("/parallel/counter"),
+                             0) == 0);
+    BTASSERT(fs_counter_register(&parallel_counter) == 0);
+    BTASSERT(fs_histogram_init(&parallel_histogram,
+                               FSTR("/parallel/histogram")) == 0);
+    BTASSERT(fs_histogram_register(&parallel_histogram) == 0);
+    BTASSERT(thrd_pool_init(&parallel_pool,
+                            &parallel_workers[0],
+                            PARALLEL_WORKERS,
+                            1,
+                            NULL,
+                            0) == 0);
+    BTASSERT(thrd_pool_start(&parallel_pool) == 0);
+
+    std_printf(FSTR("Counter shards: %d\r\n"), CONFIG_FS_COUNTER_SHARDS);
+
+    /* Increment a sharded counter, a single shared atomic value as
+       reference, and a histogram, from all workers in parallel. */
+    for (j = 0; j < 3; j++) {
+        start = time_micros();
+
+        for (i = 0; i < PARALLEL_WORKERS; i++) {
+            BTASSERT(thrd_pool_submit(&parallel_pool,
+                                      &parallel_futures[i],
+                                      jobs[j],
+                                      NULL) == 0);
+        }
+
+        for (i = 0; i < PARALLEL_WORKERS; i++) {
+            thrd_pool_wait(&parallel_pool, &parallel_futures[i]);
+        }
+
+        elapsed = time_micros_elapsed(start, time_micros());
+
+        std_printf(FSTR("%-10s %5lu ns/increment\r\n"),
+                   names[j],
+                   (unsigned long)((1000 * (uint64_t)elapsed)
+                                   / PARALLEL_INCREMENTS));
+    }
+
+    BTASSERT(thrd_pool_stop(&parallel_pool) == 0);
+
+    /* No increment was lost. */
+    BTASSERT(fs_counter_get(&parallel_counter)
+             == PARALLEL_WORKERS * PARALLEL_INCREMENTS);
+    BTASSERT(shared_value == PARALLEL_WORKERS * PARALLEL_INCREMENTS);
+
+    count = 0;
+
+    for (i = 0; i < CONFIG_FS_HISTOGRAM_BUCKETS; i++) {
+        count += parallel_histogram.buckets[i];
+    }
+
+    BTASSERT(count == PARALLEL_WORKERS * PARALLEL_INCREMENTS);
+    BTASSERT(parallel_histogram.max == 0xff);
+    BTASSERT(parallel_histogram.buckets[8]
+             == PARALLEL_WORKERS * PARALLEL_INCREMENTS / 2);
+
+    BTASSERT(fs_counter_reset(&parallel_counter) == 0);
+    BTASSERT(fs_counter_get(&parallel_counter) == 0);
+
+    return (0);
+
+#else
+
+    return (1);
+
+#endif
+}
+
 static int test_parameter(void)
 {
     char buf[256];
@@ -872,6 +1209,167 @@ static int test_cwd(void)
 #endif
 }
 
+static int test_command_same_path(void)
+{
+    char buf[32];
+
+    /* The first registered command is called. */
+    BTASSERT(fs_command_init(&first_foo,
+                             FSTR("/tmp/same/foo"),
+                             foo_cb,
+                             (void *)1) == 0);
+    BTASSERT(fs_command_register(&first_foo) == 0);
+    BTASSERT(fs_command_init(&second_foo,
+                             FSTR("/tmp/same/foo"),
+                             foo_cb,
+                             (void *)2) == 0);
+    BTASSERT(fs_command_register(&second_foo) == 0);
+
+    strcpy(buf, "/tmp/same/foo");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == 1);
+
+    strcpy(buf, "tmp/same/foo");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == 1);
+
+    strcpy(buf, "tmp/same/fo");
+    BTASSERT(fs_call(buf, NULL, &qout, NULL) == -ENOCOMMAND);
+    BTASSERT(harness_expect(&qout, "\n", NULL) > 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+/**
+ * Call given command a number of times and print the time per call.
+ */
+static int benchmark_call(const char *name_p, const char *command_p, int res)
+{
+    int i;
+    char buf[128];
+    uint32_t start;
+    uint32_t elapsed;
+
+    start = time_micros();
+
+    for (i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        strcpy(&buf[0], command_p);
+        BTASSERT(fs_call(&buf[0], NULL, chan_null(), NULL) == res);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+
+    std_printf(FSTR("%-10s %6lu ns/call\r\n"),
+               name_p,
+               (unsigned long)((1000 * (uint64_t)elapsed)
+                               / BENCHMARK_ITERATIONS));
+
+    return (0);
+}
+
+/**
+ * Linear search among the benchmark paths, as a reference for the
+ * command lookup in fs_call().
+ */
+static int benchmark_linear_search(const char *path_p)
+{
+    int i;
+
+    for (i = 0; i < BENCHMARK_COMMANDS; i++) {
+        if (strcmp(path_p, &benchmark_paths[i][0]) == 0) {
+            return (i);
+        }
+    }
+
+    return (-1);
+}
+
+#endif
+
+static int test_benchmark(void)
+{
+#if defined(ARCH_LINUX)
+
+    int i;
+    int j;
+    uint32_t start;
+    uint32_t elapsed;
+    char buf[32];
+
+    /* Register the commands in scattered order. */
+    start = time_micros();
+
+    for (i = 0; i < BENCHMARK_COMMANDS; i++) {
+        j = ((7 * i) % BENCHMARK_COMMANDS);
+        std_sprintf(&benchmark_paths[j][0],
+                    FSTR("/bench/module%02d/command%02d"),
+                    j / BENCHMARK_COMMANDS_PER_MODULE,
+                    j % BENCHMARK_COMMANDS_PER_MODULE);
+        BTASSERT(fs_command_init(&benchmark_commands[j],
+                                 &benchmark_paths[j][0],
+                                 benchmark_cb,
+                                 &benchmark_calls[j]) == 0);
+        BTASSERT(fs_command_register(&benchmark_commands[j]) == 0);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+
+    std_printf(FSTR("Registered %d commands in %lu us.\r\n"),
+               BENCHMARK_COMMANDS,
+               (unsigned long)elapsed);
+
+    /* Each command is dispatched to its callback. */
+    for (i = 0; i < BENCHMARK_COMMANDS; i++) {
+        strcpy(&buf[0], &benchmark_paths[i][1]);
+        BTASSERT(fs_call(&buf[0], NULL, NULL, NULL) == 1);
+        BTASSERT(benchmark_calls[i] == 1);
+    }
+
+    /* The commands are listed in alphabetical order. */
+    BTASSERT(fs_list("/bench/module19", NULL, &qout) == 0);
+    BTASSERT(harness_expect(&qout, "command00\r\n", NULL) > 0);
+    BTASSERT(harness_expect(&qout, "command01\r\n", NULL) > 0);
+    strcpy(&buf[0], "/bench/mod");
+    BTASSERT(fs_auto_complete(&buf[0]) == 3);
+    BTASSERT(strcmp(&buf[0], "/bench/module") == 0);
+
+    std_printf(FSTR("Command hash size: %d\r\n"),
+               CONFIG_FS_COMMAND_HASH_SIZE);
+    BTASSERT(benchmark_call("first",
+                            "/bench/module00/command00",
+                            1) == 0);
+    BTASSERT(benchmark_call("last",
+                            "/bench/module19/command19",
+                            1) == 0);
+    BTASSERT(benchmark_call("missing",
+                            "/bench/module19/command20",
+                            -ENOCOMMAND) == 0);
+    BTASSERT(benchmark_call("arguments",
+                            "/bench/module19/command19 \"a b\" c \\\"d\\\" e",
+                            5) == 0);
+
+    /* Reference linear search of a missing path. */
+    start = time_micros();
+
+    for (i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        BTASSERT(benchmark_linear_search("/bench/module19/command20") == -1);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+
+    std_printf(FSTR("linear     %6lu ns/search\r\n"),
+               (unsigned long)((1000 * (uint64_t)elapsed)
+                               / BENCHMARK_ITERATIONS));
+
+    return (0);
+
+#else
+
+    return (1);
+
+#endif
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -879,6 +1377,8 @@ int main()
         { test_auto_complete, "test_auto_complete" },
         { test_command, "test_command" },
         { test_counter, "test_counter" },
+        { test_histogram, "test_histogram" },
+        { test_counters_snapshot, "test_counters_snapshot" },
         { test_parameter, "test_parameter" },
         { test_list, "test_list" },
         { test_split_merge, "test_split_merge" },
@@ -891,6 +1391,9 @@ int main()
         { test_filesystem_commands, "test_filesystem_commands" },
         { test_read_line, "test_read_line" },
         { test_cwd, "test_cwd" },
+        { test_counter_parallel, "test_counter_parallel" },
+        { test_command_same_path, "test_command_same_path" },
+        { test_benchmark, "test_benchmark" },
         { NULL, NULL }
     };
 
@@ -28,6 +28,12 @@
 
 #include "simba.h"
 
+/* Flash read statistics, for the benchmark. */
+static struct {
+    uint32_t number_of_reads;
+    uint32_t number_of_read_bytes;
+} hal_stats;
+
 #if defined(BOARD_ARDUINO_DUE)
 
 #define PHY_SIZE                                    32768
@@ -61,6 +67,9 @@ static int32_t hal_read(struct spiffs_t *fs_p,
         return (-1);
     }
 
+    hal_stats.number_of_reads++;
+    hal_stats.number_of_read_bytes += size;
+
     return (0);
 }
 
@@ -129,6 +138,9 @@ static int32_t hal_read(struct spiffs_t *fs_p,
         return (-1);
     }
 
+    hal_stats.number_of_reads++;
+    hal_stats.number_of_read_bytes += size;
+
     return (0);
 }
 
@@ -179,9 +191,11 @@ static int32_t hal_read(struct spiffs_t *fs_p,
                         uint32_t size,
                         uint8_t *dst_p)
 {
-    BTASSERT(addr + size < sizeof(fs_storage));
+    BTASSERT(addr + size <= sizeof(fs_storage));
 
     memcpy(dst_p, &fs_storage[addr], size);
+    hal_stats.number_of_reads++;
+    hal_stats.number_of_read_bytes += size;
 
     return (0);
 }
@@ -191,7 +205,7 @@ static int32_t hal_write(struct spiffs_t *fs_p,
                          uint32_t size,
                          uint8_t *src_p)
 {
-    BTASSERT(addr + size < sizeof(fs_storage));
+    BTASSERT(addr + size <= sizeof(fs_storage));
 
     memcpy(&fs_storage[addr], src_p, size);
 
@@ -214,6 +228,38 @@ static int32_t hal_erase(struct spiffs_t *fs_p,
 static struct spiffs_t fs;
 static struct spiffs_config_t config;
 static uint8_t workspace[2 * LOG_PAGE_SIZE];
+static struct spiffs_lookup_index_entry_t lookup_index[96];
+
+static int remount(void *lookup_index_p, size_t size)
+{
+    spiffs_unmount(&fs);
+    BTASSERT(spiffs_set_lookup_index(&fs, lookup_index_p, size) == 0);
+    BTASSERT(spiffs_mount(&fs,
+                          &config,
+                          workspace,
+                          fdworkspace,
+                          sizeof(fdworkspace),
+                          cache,
+                          sizeof(cache),
+                          NULL) == 0);
+
+    return (0);
+}
+
+static int write_file(const char *name_p, const void *buf_p, size_t size)
+{
+    spiffs_file fd;
+
+    fd = spiffs_open(&fs,
+                     name_p,
+                     SPIFFS_CREAT | SPIFFS_TRUNC | SPIFFS_RDWR,
+                     0);
+    BTASSERT(fd >= 0);
+    BTASSERT(spiffs_write(&fs, fd, (void *)buf_p, size) == size);
+    BTASSERT(spiffs_close(&fs, fd) == 0);
+
+    return (0);
+}
 
 static int test_init(void)
 {
@@ -261,6 +307,12 @@ static int test_format(void)
     std_printf(FSTR("buffer_bytes_for_cache = %d\r\n"),
                spiffs_buffer_bytes_for_cache(&fs, 5));
 
+    /* The static buffer size macros are big enough. */
+    BTASSERT(SPIFFS_FILEDESCS_BUFFER_SIZE(5)
+             >= spiffs_buffer_bytes_for_filedescs(&fs, 5));
+    BTASSERT(SPIFFS_CACHE_BUFFER_SIZE(5, LOG_PAGE_SIZE)
+             >= spiffs_buffer_bytes_for_cache(&fs, 5));
+
     return (0);
 }
 
@@ -371,6 +423,223 @@ static int test_read_write_performance(void)
     return (0);
 }
 
+static int test_lookup_index(void)
+{
+    struct spiffs_stat_t stat;
+    char buf[8];
+    spiffs_file fd;
+
+    BTASSERT(remount(&lookup_index[0], sizeof(lookup_index)) == 0);
+    BTASSERT(fs.lookup_index_valid == 1);
+    BTASSERT(fs.lookup_index_length == 1);
+    BTASSERT(spiffs_stat(&fs, "file.txt", &stat) == 0);
+
+    /* Created files are added to the index. */
+    BTASSERT(write_file("a.txt", "a", 2) == 0);
+    BTASSERT(write_file("b.txt", "b", 2) == 0);
+    BTASSERT(fs.lookup_index_length == 3);
+    BTASSERT(spiffs_stat(&fs, "a.txt", &stat) == 0);
+    BTASSERT(stat.size == 2);
+    BTASSERT(spiffs_stat(&fs, "b.txt", &stat) == 0);
+    BTASSERT(spiffs_stat(&fs, "missing.txt", &stat) == SPIFFS_ERR_NOT_FOUND);
+
+    /* Renamed files are found by their new name. */
+    BTASSERT(spiffs_rename(&fs, "a.txt", "c.txt") == 0);
+    BTASSERT(spiffs_stat(&fs, "a.txt", &stat) == SPIFFS_ERR_NOT_FOUND);
+    fd = spiffs_open(&fs, "c.txt", SPIFFS_RDONLY, 0);
+    BTASSERT(fd >= 0);
+    BTASSERT(spiffs_read(&fs, fd, buf, 2) == 2);
+    BTASSERT(strcmp(buf, "a") == 0);
+    BTASSERT(spiffs_close(&fs, fd) == 0);
+
+    /* Removed files are removed from the index. */
+    BTASSERT(spiffs_remove(&fs, "b.txt") == 0);
+    BTASSERT(spiffs_stat(&fs, "b.txt", &stat) == SPIFFS_ERR_NOT_FOUND);
+    BTASSERT(fs.lookup_index_length == 2);
+    BTASSERT(fs.lookup_index_valid == 1);
+
+    /* The index is built again when mounted. */
+    BTASSERT(remount(&lookup_index[0], sizeof(lookup_index)) == 0);
+    BTASSERT(fs.lookup_index_valid == 1);
+    BTASSERT(fs.lookup_index_length == 2);
+    BTASSERT(spiffs_stat(&fs, "c.txt", &stat) == 0);
+
+    /* Lookups fall back to scanning when the index is full. */
+    BTASSERT(remount(&lookup_index[0], 2 * sizeof(lookup_index[0])) == 0);
+    BTASSERT(fs.lookup_index_valid == 1);
+    BTASSERT(write_file("d.txt", "d", 2) == 0);
+    BTASSERT(fs.lookup_index_valid == 0);
+    BTASSERT(spiffs_stat(&fs, "c.txt", &stat) == 0);
+    BTASSERT(spiffs_stat(&fs, "d.txt", &stat) == 0);
+    BTASSERT(spiffs_stat(&fs, "b.txt", &stat) == SPIFFS_ERR_NOT_FOUND);
+
+    BTASSERT(spiffs_remove(&fs, "c.txt") == 0);
+    BTASSERT(spiffs_remove(&fs, "d.txt") == 0);
+    BTASSERT(remount(NULL, 0) == 0);
+
+    return (0);
+}
+
+static void print_result(const char *op_p,
+                         int number_of_ops,
+                         int start)
+{
+    int us;
+
+    us = time_micros_elapsed(start, time_micros());
+
+    std_printf(FSTR("  %-5s %5d.%02d us/op %3lu flash reads/op "
+                    "(%lu bytes)\r\n"),
+               op_p,
+               us / number_of_ops,
+               (100 * us / number_of_ops) % 100,
+               (unsigned long)(hal_stats.number_of_reads / number_of_ops),
+               (unsigned long)(hal_stats.number_of_read_bytes / number_of_ops));
+}
+
+/**
+ * Measure open, read, write and stat of all files, accessed in a
+ * scattered order.
+ */
+static int benchmark(int number_of_files, uint32_t *stat_reads_p)
+{
+    int i;
+    int j;
+    char name[16];
+    char buf[32];
+    struct spiffs_stat_t stat;
+    int start;
+    spiffs_file fd;
+    int number_of_ops;
+
+    number_of_ops = (4 * number_of_files);
+
+    /* Stat. */
+    memset(&hal_stats, 0, sizeof(hal_stats));
+    start = time_micros();
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < number_of_files; i++) {
+            std_sprintf(&name[0], FSTR("bench%d"), (5 * i) % number_of_files);
+            BTASSERT(spiffs_stat(&fs, &name[0], &stat) == 0);
+        }
+    }
+
+    print_result("stat", number_of_ops, start);
+    *stat_reads_p = (hal_stats.number_of_reads / number_of_ops);
+
+    /* Stat of a missing file, as when creating a file. */
+    memset(&hal_stats, 0, sizeof(hal_stats));
+    start = time_micros();
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < number_of_files; i++) {
+            BTASSERT(spiffs_stat(&fs, "missing", &stat) == SPIFFS_ERR_NOT_FOUND);
+        }
+    }
+
+    print_result("miss", number_of_ops, start);
+
+    /* Open and close. */
+    memset(&hal_stats, 0, sizeof(hal_stats));
+    start = time_micros();
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < number_of_files; i++) {
+            std_sprintf(&name[0], FSTR("bench%d"), (5 * i) % number_of_files);
+            fd = spiffs_open(&fs, &name[0], SPIFFS_RDWR, 0);
+            BTASSERT(fd >= 0);
+            BTASSERT(spiffs_close(&fs, fd) == 0);
+        }
+    }
+
+    print_result("open", number_of_ops, start);
+
+    /* Open, read and close. */
+    memset(&hal_stats, 0, sizeof(hal_stats));
+    start = time_micros();
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < number_of_files; i++) {
+            std_sprintf(&name[0], FSTR("bench%d"), (5 * i) % number_of_files);
+            fd = spiffs_open(&fs, &name[0], SPIFFS_RDONLY, 0);
+            BTASSERT(fd >= 0);
+            BTASSERT(spiffs_read(&fs, fd, &buf[0], sizeof(buf)) == sizeof(buf));
+            BTASSERT(spiffs_close(&fs, fd) == 0);
+        }
+    }
+
+    print_result("read", number_of_ops, start);
+
+    /* Open, write and close. */
+    memset(&hal_stats, 0, sizeof(hal_stats));
+    start = time_micros();
+
+    for (j = 0; j < 4; j++) {
+        for (i = 0; i < number_of_files; i++) {
+            std_sprintf(&name[0], FSTR("bench%d"), (5 * i) % number_of_files);
+            fd = spiffs_open(&fs, &name[0], SPIFFS_RDWR, 0);
+            BTASSERT(fd >= 0);
+            BTASSERT(spiffs_write(&fs, fd, &buf[0], 4) == 4);
+            BTASSERT(spiffs_close(&fs, fd) == 0);
+        }
+    }
+
+    print_result("write", number_of_ops, start);
+
+    return (0);
+}
+
+static int test_benchmark(void)
+{
+    int i;
+    int k;
+    int number_of_files;
+    char name[16];
+    char buf[32];
+    uint32_t stat_reads[2];
+
+    memset(&buf[0], 'b', sizeof(buf));
+    number_of_files = 0;
+
+    for (k = 8; k <= 64; k *= 2) {
+        /* Add files. */
+        for (i = number_of_files; i < k; i++) {
+            std_sprintf(&name[0], FSTR("bench%d"), i);
+            BTASSERT(write_file(&name[0], &buf[0], sizeof(buf)) == 0);
+        }
+
+        number_of_files = k;
+
+        std_printf(FSTR("%d files without lookup index:\r\n"), k);
+        BTASSERT(remount(NULL, 0) == 0);
+        BTASSERT(benchmark(k, &stat_reads[0]) == 0);
+
+        std_printf(FSTR("%d files with lookup index:\r\n"), k);
+        BTASSERT(remount(&lookup_index[0], sizeof(lookup_index)) == 0);
+        BTASSERT(fs.lookup_index_valid == 1);
+        BTASSERT(benchmark(k, &stat_reads[1]) == 0);
+        BTASSERT(fs.lookup_index_valid == 1);
+        BTASSERT(stat_reads[1] <= stat_reads[0]);
+
+#if SPIFFS_CACHE_STATS == 1
+        std_printf(FSTR("cache hits: %lu, misses: %lu\r\n"),
+                   (unsigned long)fs.cache_hits,
+                   (unsigned long)fs.cache_misses);
+#endif
+    }
+
+    /* Remove the files. */
+    for (i = 0; i < number_of_files; i++) {
+        std_sprintf(&name[0], FSTR("bench%d"), i);
+        BTASSERT(spiffs_remove(&fs, &name[0]) == 0);
+    }
+
+    BTASSERT(remount(NULL, 0) == 0);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -378,6 +647,8 @@ int main()
         { test_format, "test_format" },
         { test_read_write, "test_read_write" },
         { test_read_write_performance, "test_read_write_performance" },
+        { test_lookup_index, "test_lookup_index" },
+        { test_benchmark, "test_benchmark" },
         { NULL, NULL }
     };
 
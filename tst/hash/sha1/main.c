@@ -116,10 +116,77 @@ int test_sha1(void)
     return (0);
 }
 
+int test_sha1_unaligned(void)
+{
+    struct sha1_t foo;
+    uint8_t hash[20];
+    char buf[65];
+
+    /* Complete blocks are hashed directly from the input buffer, so
+       make sure an unaligned input buffer works. */
+    memset(&buf[0], 'a', sizeof(buf));
+    BTASSERT(sha1_init(&foo) == 0);
+    BTASSERT(sha1_update(&foo, &buf[1], 64) == 0);
+    BTASSERT(sha1_digest(&foo, hash) == 0);
+
+    BTASSERT(memcmp(hash,
+                    "\x00\x98\xba\x82\x4b\x5c\x16\x42\x7b\xd7"
+                    "\xa1\x12\x2a\x5a\x44\x2a\x25\xec\x64\x4d",
+                    20) == 0);
+
+    return (0);
+}
+
+int test_sha1_performance(void)
+{
+    struct sha1_t foo;
+    uint8_t hash[20];
+    static uint8_t buf[4096];
+    int start;
+    int i;
+    size_t size;
+    long us;
+    unsigned long rate;
+
+    for (i = 0; i < membersof(buf); i++) {
+        buf[i] = i;
+    }
+
+    for (size = 64; size <= sizeof(buf); size *= 8) {
+        BTASSERT(sha1_init(&foo) == 0);
+        start = time_micros();
+
+        for (i = 0; i < 256; i++) {
+            BTASSERT(sha1_update(&foo, &buf[0], size) == 0);
+        }
+
+        BTASSERT(sha1_digest(&foo, hash) == 0);
+        us = time_micros_elapsed(start, time_micros());
+
+        if (us == 0) {
+            us = 1;
+        }
+
+        /* Bytes per microsecond is MB/s. Keep two decimals. */
+        rate = ((100UL * 256 * size) / us);
+        std_printf(OSTR("Hashed %lu bytes in chunks of %lu bytes "
+                        "in %ld us (%lu.%02lu MB/s).\r\n"),
+                   (unsigned long)(256 * size),
+                   (unsigned long)size,
+                   us,
+                   rate / 100,
+                   rate % 100);
+    }
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_sha1, "test_sha1" },
+        { test_sha1_unaligned, "test_sha1_unaligned" },
+        { test_sha1_performance, "test_sha1_performance" },
         { NULL, NULL }
     };
 
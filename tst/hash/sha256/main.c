@@ -0,0 +1,182 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+int test_sha256(void)
+{
+    struct sha256_t foo;
+    uint8_t hash[32];
+    int i;
+    struct {
+        char *name_p;
+        char *input_p;
+        char *hash_p;
+    } testdata[] = {
+        {
+            .name_p = "Empty",
+            .input_p = "",
+            .hash_p =
+            "\xe3\xb0\xc4\x42\x98\xfc\x1c\x14\x9a\xfb"
+            "\xf4\xc8\x99\x6f\xb9\x24\x27\xae\x41\xe4"
+            "\x64\x9b\x93\x4c\xa4\x95\x99\x1b\x78\x52\xb8\x55"
+        },
+        {
+            .name_p = "Abc",
+            .input_p = "abc",
+            .hash_p =
+            "\xba\x78\x16\xbf\x8f\x01\xcf\xea\x41\x41"
+            "\x40\xde\x5d\xae\x22\x23\xb0\x03\x61\xa3"
+            "\x96\x17\x7a\x9c\xb4\x10\xff\x61\xf2\x00\x15\xad"
+        },
+        {
+            .name_p = "Dog",
+            .input_p = "The quick brown fox jumps over the lazy dog",
+            .hash_p =
+            "\xd7\xa8\xfb\xb3\x07\xd7\x80\x94\x69\xca"
+            "\x9a\xbc\xb0\x08\x2e\x4f\x8d\x56\x51\xe4"
+            "\x6d\x3c\xdb\x76\x2d\x02\xd0\xbf\x37\xc9\xe5\x92"
+        },
+        {
+            .name_p = "60",
+            .input_p =
+            "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+            .hash_p =
+            "\x11\xee\x39\x12\x11\xc6\x25\x64\x60\xb6"
+            "\xed\x37\x59\x57\xfa\xdd\x80\x61\xca\xfb"
+            "\xb3\x1d\xaf\x96\x7d\xb8\x75\xae\xbd\x5a\xaa\xd4"
+        },
+        {
+            .name_p = "64",
+            .input_p =
+            "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+            .hash_p =
+            "\xff\xe0\x54\xfe\x7a\xe0\xcb\x6d\xc6\x5c"
+            "\x3a\xf9\xb6\x1d\x52\x09\xf4\x39\x85\x1d"
+            "\xb4\x3d\x0b\xa5\x99\x73\x37\xdf\x15\x46\x68\xeb"
+        },
+        {
+            .name_p = "Long",
+            .input_p =
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+            .hash_p =
+            "\x24\x8d\x6a\x61\xd2\x06\x38\xb8\xe5\xc0"
+            "\x26\x93\x0c\x3e\x60\x39\xa3\x3c\xe4\x59"
+            "\x64\xff\x21\x67\xf6\xec\xed\xd4\x19\xdb\x06\xc1"
+        }
+    };
+
+    /* Test vectors. */
+    for (i = 0; i < membersof(testdata); i++) {
+        std_printf(FSTR("%s\r\n"), testdata[i].name_p);
+
+        BTASSERT(sha256_init(&foo) == 0);
+        BTASSERT(sha256_update(&foo,
+                               testdata[i].input_p,
+                               strlen(testdata[i].input_p)) == 0);
+        BTASSERT(sha256_digest(&foo, hash) == 0);
+
+        BTASSERT(memcmp(hash, testdata[i].hash_p, 32) == 0);
+    }
+
+    /* Multiple updates. */
+    BTASSERT(sha256_init(&foo) == 0);
+
+    for (i = 0; i < 400; i++) {
+        BTASSERT(sha256_update(&foo, "1", 1) == 0);
+    }
+
+    BTASSERT(sha256_digest(&foo, hash) == 0);
+
+    BTASSERT(memcmp(hash,
+                    "\xb1\x25\x47\xda\x74\xee\x44\xf5\xba\x82"
+                    "\x9a\x26\xda\xe1\x03\x55\xc7\x61\xee\x17"
+                    "\xe9\x3f\x0c\xb1\xd3\xfc\x5c\xc0\x84\x03\xec\x58",
+                    32) == 0);
+
+    return (0);
+}
+
+int test_sha256_performance(void)
+{
+    struct sha256_t foo;
+    uint8_t hash[32];
+    static uint8_t buf[4096];
+    int start;
+    int i;
+    size_t size;
+    long us;
+    unsigned long rate;
+
+    for (i = 0; i < membersof(buf); i++) {
+        buf[i] = i;
+    }
+
+    for (size = 64; size <= sizeof(buf); size *= 8) {
+        BTASSERT(sha256_init(&foo) == 0);
+        start = time_micros();
+
+        for (i = 0; i < 256; i++) {
+            BTASSERT(sha256_update(&foo, &buf[0], size) == 0);
+        }
+
+        BTASSERT(sha256_digest(&foo, hash) == 0);
+        us = time_micros_elapsed(start, time_micros());
+
+        if (us == 0) {
+            us = 1;
+        }
+
+        /* Bytes per microsecond is MB/s. Keep two decimals. */
+        rate = ((100UL * 256 * size) / us);
+        std_printf(OSTR("Hashed %lu bytes in chunks of %lu bytes "
+                        "in %ld us (%lu.%02lu MB/s).\r\n"),
+                   (unsigned long)(256 * size),
+                   (unsigned long)size,
+                   us,
+                   rate / 100,
+                   rate % 100);
+    }
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_sha256, "test_sha256" },
+        { test_sha256_performance, "test_sha256_performance" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
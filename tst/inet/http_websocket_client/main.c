@@ -31,6 +31,7 @@
 extern void socket_stub_init(void);
 extern void socket_stub_input(void *buf_p, size_t size);
 extern void socket_stub_output(void *buf_p, size_t size);
+extern void socket_stub_calls(int *reads_p, int *writes_p);
 
 static struct http_websocket_client_t foo;
 
@@ -222,6 +223,110 @@ static int test_write(void)
     return (0);
 }
 
+static int test_read_frames(void)
+{
+    int reads;
+    int writes;
+
+    /* Two frames, the first masked. */
+    buf[0] = 0x01; /* TEXT. */
+    buf[1] = 0x85; /* MASK and 5 bytes payload length. */
+    buf[2] = 0x01; /* Masking key 0. */
+    buf[3] = 0x02; /* Masking key 1. */
+    buf[4] = 0x03; /* Masking key 2. */
+    buf[5] = 0x04; /* Masking key 3. */
+    buf[6] = 'g';  /* Payload 0. */
+    buf[7] = 'm';  /* Payload 1. */
+    buf[8] = 'l';  /* Payload 2. */
+    buf[9] = 'f';  /* Payload 3. */
+    buf[10] = '`'; /* Payload 4. */
+    buf[11] = 0x80; /* FIN. */
+    buf[12] = 0x03; /* 3 bytes payload length. */
+    buf[13] = 'f'; /* Payload 0. */
+    buf[14] = 'i'; /* Payload 1. */
+    buf[15] = 'e'; /* Payload 2. */
+    socket_stub_input(buf, 16);
+    socket_stub_calls(&reads, &writes);
+
+    /* The frame header and the payload of a small frame in two
+       socket reads. */
+    BTASSERT(http_websocket_client_read(&foo, buf, 2) == 2);
+    BTASSERTM(buf, "fo", 2);
+    socket_stub_calls(&reads, &writes);
+    BTASSERTI(reads, ==, 2);
+
+    /* Rest of the first frame, unmasked at the right offset, and the
+       second frame. */
+    BTASSERT(http_websocket_client_read(&foo, buf, 6) == 6);
+    BTASSERTM(buf, "obafie", 6);
+
+    return (0);
+}
+
+static int test_write_calls(void)
+{
+    int reads;
+    int writes;
+
+    socket_stub_calls(&reads, &writes);
+
+    /* The header and the payload of a small frame in a single socket
+       write. */
+    BTASSERT(http_websocket_client_write(&foo,
+                                         HTTP_TYPE_TEXT,
+                                         "foo",
+                                         3) == 3);
+    socket_stub_calls(&reads, &writes);
+    BTASSERTI(writes, ==, 1);
+    socket_stub_output(buf, 6 + 3);
+    BTASSERTM(buf, "\x81\x83\x00\x00\x00\x00" "foo", 9);
+
+    return (0);
+}
+
+static int test_message_rate(void)
+{
+    uint8_t frame[2 + 32];
+    int i;
+    int start;
+    int elapsed;
+
+    frame[0] = 0x82; /* FIN & BINARY. */
+    frame[1] = 0x20; /* 32 bytes payload length. */
+    memset(&frame[2], 'x', 32);
+
+    /* Read messages. */
+    start = time_micros();
+
+    for (i = 0; i < 10000; i++) {
+        socket_stub_input(frame, sizeof(frame));
+        BTASSERT(http_websocket_client_read(&foo, buf, 32) == 32);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Read 10000 32 bytes messages in %d us (%u messages/s).\r\n"),
+               elapsed,
+               (unsigned int)(10000ULL * 1000000 / MAX(elapsed, 1)));
+
+    /* Write messages. */
+    start = time_micros();
+
+    for (i = 0; i < 10000; i++) {
+        BTASSERT(http_websocket_client_write(&foo,
+                                             HTTP_TYPE_BINARY,
+                                             &frame[2],
+                                             32) == 32);
+        socket_stub_output(buf, 6 + 32);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Wrote 10000 32 bytes messages in %d us (%u messages/s).\r\n"),
+               elapsed,
+               (unsigned int)(10000ULL * 1000000 / MAX(elapsed, 1)));
+
+    return (0);
+}
+
 static int test_disconnect(void)
 {
     BTASSERT(http_websocket_client_disconnect(&foo) == 0);
@@ -235,6 +340,9 @@ int main()
         { test_connect, "test_connect" },
         { test_read, "test_read" },
         { test_write, "test_write" },
+        { test_read_frames, "test_read_frames" },
+        { test_write_calls, "test_write_calls" },
+        { test_message_rate, "test_message_rate" },
         { test_disconnect, "test_disconnect" },
         { NULL, NULL }
     };
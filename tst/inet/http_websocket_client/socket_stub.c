@@ -31,6 +31,10 @@
 static struct queue_t qinput;
 static struct queue_t qoutput;
 
+/* Number of socket reads and writes. */
+static int reads;
+static int writes;
+
 #if defined(ARCH_LINUX)
 static char qinputbuf[131072];
 static char qoutputbuf[131072];
@@ -129,6 +133,8 @@ ssize_t socket_write(struct socket_t *self_p,
                      const void *buf_p,
                      size_t size)
 {
+    writes++;
+
     return (write(NULL, buf_p, size));
 }
 
@@ -136,6 +142,8 @@ ssize_t socket_read(struct socket_t *self_p,
                     void *buf_p,
                     size_t size)
 {
+    reads++;
+
     return (read(NULL, buf_p, size));
 }
 
@@ -154,3 +162,11 @@ void socket_stub_output(void *buf_p, size_t size)
 {
     chan_read(&qoutput, buf_p, size);
 }
+
+void socket_stub_calls(int *reads_p, int *writes_p)
+{
+    *reads_p = reads;
+    *writes_p = writes;
+    reads = 0;
+    writes = 0;
+}
@@ -31,6 +31,7 @@
 extern void socket_stub_init(void);
 extern void socket_stub_input(void *buf_p, size_t size);
 extern void socket_stub_output(void *buf_p, size_t size);
+extern void socket_stub_calls(int *reads_p, int *writes_p);
 
 static struct socket_t socket;
 static struct http_websocket_server_t server;
@@ -294,6 +295,209 @@ static int test_write(void)
     return (0);
 }
 
+static int test_read_calls(void)
+{
+    int type;
+    int reads;
+    int writes;
+
+    /* Prepare socket input with 1 length byte. */
+    buf[0] = 0x81; /* FIN & TEXT. */
+    buf[1] = 0x83; /* MASK and 1 byte payload length. */
+    buf[2] = 0x01; /* Masking key 0. */
+    buf[3] = 0x02; /* Masking key 1. */
+    buf[4] = 0x03; /* Masking key 2. */
+    buf[5] = 0x04; /* Masking key 3. */
+    buf[6] = 'g';  /* Payload 0. */
+    buf[7] = 'm';  /* Payload 1. */
+    buf[8] = 'l';  /* Payload 2. */
+    socket_stub_input(buf, 9);
+    socket_stub_calls(&reads, &writes);
+
+    /* The frame header and the payload of a small frame in two
+       socket reads. */
+    BTASSERT(http_websocket_server_read(&server,
+                                        &type,
+                                        buf,
+                                        sizeof(buf)) == 3);
+    BTASSERTM(buf, "foo", 3);
+    socket_stub_calls(&reads, &writes);
+    BTASSERTI(reads, ==, 2);
+
+    return (0);
+}
+
+static int test_read_long_masked(void)
+{
+    int type;
+    int i;
+    int reads;
+    int writes;
+
+    /* Prepare socket input with a 300 bytes masked payload. */
+    buf[0] = 0x82; /* FIN & BINARY. */
+    buf[1] = 0xfe; /* MASK and 2 bytes payload length. */
+    buf[2] = 0x01; /* Payload length 0. */
+    buf[3] = 0x2c; /* Payload length 1. */
+    buf[4] = 0x11; /* Masking key 0. */
+    buf[5] = 0x22; /* Masking key 1. */
+    buf[6] = 0x33; /* Masking key 2. */
+    buf[7] = 0x44; /* Masking key 3. */
+
+    for (i = 0; i < 300; i++) {
+        buf[8 + i] = (i ^ buf[4 + (i % 4)]);
+    }
+
+    socket_stub_input(buf, 8 + 300);
+    socket_stub_calls(&reads, &writes);
+
+    /* Read 201 of the 300 bytes. The rest is discarded. */
+    BTASSERT(http_websocket_server_read(&server,
+                                        &type,
+                                        buf,
+                                        201) == 201);
+
+    for (i = 0; i < 201; i++) {
+        BTASSERTI(buf[i], ==, (i & 0xff));
+    }
+
+    /* Two header reads, one payload read and two discard reads. */
+    socket_stub_calls(&reads, &writes);
+    BTASSERTI(reads, ==, 5);
+
+    /* The next message is read correctly. */
+    buf[0] = 0x81; /* FIN & TEXT. */
+    buf[1] = 0x03; /* 1 byte payload length. */
+    buf[2] = 'b';  /* Payload 0. */
+    buf[3] = 'a';  /* Payload 1. */
+    buf[4] = 'r';  /* Payload 2. */
+    socket_stub_input(buf, 5);
+
+    BTASSERT(http_websocket_server_read(&server,
+                                        &type,
+                                        buf,
+                                        sizeof(buf)) == 3);
+    BTASSERTM(buf, "bar", 3);
+
+    return (0);
+}
+
+static int test_write_calls(void)
+{
+    int reads;
+    int writes;
+
+    socket_stub_calls(&reads, &writes);
+
+    /* The header and the payload of a small frame in a single socket
+       write. */
+    BTASSERT(http_websocket_server_write(&server,
+                                         HTTP_TYPE_TEXT,
+                                         "foo",
+                                         3) == 3);
+    socket_stub_calls(&reads, &writes);
+    BTASSERTI(writes, ==, 1);
+    socket_stub_output(buf, 2 + 3);
+    BTASSERTM(buf, "\x81\x03" "foo", 5);
+
+    /* Two writes for larger frames, the first with the header. */
+    memset(buf, 'a', 200);
+    BTASSERT(http_websocket_server_write(&server,
+                                         HTTP_TYPE_BINARY,
+                                         buf,
+                                         200) == 200);
+    socket_stub_calls(&reads, &writes);
+    BTASSERTI(writes, ==, 2);
+    socket_stub_output(buf, 4 + 200);
+    BTASSERTM(buf, "\x82\x7e\x00\xc8" "aaaa", 8);
+    BTASSERTI(buf[203], ==, 'a');
+
+    return (0);
+}
+
+static int test_mask(void)
+{
+    uint8_t data[96];
+    uint8_t expected[96];
+    static const uint8_t masking_key[4] = { 0x12, 0x34, 0x56, 0x78 };
+    size_t begin;
+    size_t size;
+    size_t offset;
+    size_t i;
+
+    /* Compare to masking a byte at a time for all alignments, sizes
+       and payload offsets. */
+    for (begin = 0; begin < 16; begin++) {
+        for (size = 0; size <= 64; size++) {
+            for (offset = 0; offset < 8; offset++) {
+                for (i = 0; i < size; i++) {
+                    data[begin + i] = i;
+                    expected[begin + i] = (i ^ masking_key[(offset + i) % 4]);
+                }
+
+                http_websocket_mask(&data[begin],
+                                    size,
+                                    &masking_key[0],
+                                    offset);
+                BTASSERTM(&data[begin], &expected[begin], size);
+            }
+        }
+    }
+
+    return (0);
+}
+
+static int test_message_rate(void)
+{
+    uint8_t frame[6 + 32];
+    int type;
+    int i;
+    int start;
+    int elapsed;
+
+    frame[0] = 0x82; /* FIN & BINARY. */
+    frame[1] = 0xa0; /* MASK and 32 bytes payload length. */
+    frame[2] = 0x01; /* Masking key 0. */
+    frame[3] = 0x02; /* Masking key 1. */
+    frame[4] = 0x03; /* Masking key 2. */
+    frame[5] = 0x04; /* Masking key 3. */
+    memset(&frame[6], 'x', 32);
+
+    /* Read messages. */
+    start = time_micros();
+
+    for (i = 0; i < 10000; i++) {
+        socket_stub_input(frame, sizeof(frame));
+        BTASSERT(http_websocket_server_read(&server,
+                                            &type,
+                                            buf,
+                                            sizeof(buf)) == 32);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Read 10000 32 bytes messages in %d us (%u messages/s).\r\n"),
+               elapsed,
+               (unsigned int)(10000ULL * 1000000 / MAX(elapsed, 1)));
+
+    /* Write messages. */
+    start = time_micros();
+
+    for (i = 0; i < 10000; i++) {
+        BTASSERT(http_websocket_server_write(&server,
+                                             HTTP_TYPE_BINARY,
+                                             &frame[6],
+                                             32) == 32);
+        socket_stub_output(buf, 2 + 32);
+    }
+
+    elapsed = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Wrote 10000 32 bytes messages in %d us (%u messages/s).\r\n"),
+               elapsed,
+               (unsigned int)(10000ULL * 1000000 / MAX(elapsed, 1)));
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -303,6 +507,11 @@ int main()
         { test_handshake_bad_action, "test_handshake_bad_action" },
         { test_read, "test_read" },
         { test_write, "test_write" },
+        { test_read_calls, "test_read_calls" },
+        { test_read_long_masked, "test_read_long_masked" },
+        { test_write_calls, "test_write_calls" },
+        { test_mask, "test_mask" },
+        { test_message_rate, "test_message_rate" },
         { NULL, NULL }
     };
 
@@ -28,6 +28,13 @@
 
 #include "simba.h"
 
+#include "mbedtls/platform.h"
+
+extern void (*handshake_hook)(void);
+
+static struct ssl_context_t hook_context;
+static struct socket_t hook_socket;
+
 static int test_init(void)
 {
     /* This function may be called multiple times. */
@@ -132,6 +139,8 @@ static int test_server(void)
                              &socket,
                              SSL_SOCKET_SERVER_SIDE,
                              NULL) == 0);
+    BTASSERT(context.session_cache.hits == 0);
+    BTASSERT(context.session_cache.misses == 1);
 
     /* Test a few functions. */
     BTASSERT(chan_size(&ssl_socket) == 0);
@@ -155,6 +164,17 @@ static int test_server(void)
     /* Close the SSL connection. */
     BTASSERT(ssl_socket_close(&ssl_socket) == 0);
 
+    /* The session is resumed from the session cache when the client
+       reconnects. */
+    BTASSERT(ssl_socket_open(&ssl_socket,
+                             &context,
+                             &socket,
+                             SSL_SOCKET_SERVER_SIDE,
+                             NULL) == 0);
+    BTASSERT(context.session_cache.hits == 1);
+    BTASSERT(context.session_cache.misses == 1);
+    BTASSERT(ssl_socket_close(&ssl_socket) == 0);
+
     /* Close the connection. */
     BTASSERT(socket_close(&socket) == 0);
 
@@ -198,25 +218,32 @@ static int test_errors(void)
     struct ssl_context_t context;
     struct ssl_context_t context2;
     struct ssl_socket_t ssl_socket;
-    struct ssl_socket_t ssl_socket2;
+    struct ssl_socket_t ssl_sockets[CONFIG_SSL_SOCKETS_MAX];
     struct socket_t socket;
+    int i;
 
     /* Out of resources. */
     BTASSERT(ssl_context_init(&context, ssl_protocol_tls_v1_0) == 0);
     BTASSERT(ssl_context_init(&context2, ssl_protocol_tls_v1_0) == -1);
 
     /* Out of resources. */
+    for (i = 0; i < CONFIG_SSL_SOCKETS_MAX; i++) {
+        BTASSERT(ssl_socket_open(&ssl_sockets[i],
+                                 &context,
+                                 &socket,
+                                 0,
+                                 NULL) == 0);
+    }
+
     BTASSERT(ssl_socket_open(&ssl_socket,
-                             &context,
-                             &socket,
-                             0,
-                             NULL) == 0);
-    BTASSERT(ssl_socket_open(&ssl_socket2,
                              &context,
                              &socket,
                              0,
                              NULL) == -1);
-    BTASSERT(ssl_socket_close(&ssl_socket) == 0);
+
+    for (i = 0; i < CONFIG_SSL_SOCKETS_MAX; i++) {
+        BTASSERT(ssl_socket_close(&ssl_sockets[i]) == 0);
+    }
 
     /* Setup failure in setup. */
     BTASSERT(ssl_socket_open(&ssl_socket,
@@ -231,7 +258,201 @@ static int test_errors(void)
                              &socket,
                              0,
                              NULL) == -1);
-    
+
+    BTASSERT(ssl_context_destroy(&context) == 0);
+
+    return (0);
+}
+
+static int open_close(struct ssl_context_t *context_p,
+                      struct socket_t *socket_p,
+                      const char *server_hostname_p)
+{
+    struct ssl_socket_t ssl_socket;
+
+    BTASSERT(ssl_socket_open(&ssl_socket,
+                             context_p,
+                             socket_p,
+                             0,
+                             server_hostname_p) == 0);
+    BTASSERT(ssl_socket_close(&ssl_socket) == 0);
+
+    return (0);
+}
+
+static int test_session_resumption(void)
+{
+    struct ssl_context_t context;
+    struct socket_t socket;
+
+    BTASSERT(CONFIG_SSL_CLIENT_SESSIONS_MAX == 2);
+
+    BTASSERT(ssl_context_init(&context, ssl_protocol_tls_v1_0) == 0);
+    BTASSERT(socket_open_tcp(&socket) == 0);
+
+    /* Full handshake with a new server. */
+    BTASSERT(open_close(&context, &socket, "server_a") == 0);
+    BTASSERT(context.session_cache.hits == 0);
+    BTASSERT(context.session_cache.misses == 1);
+
+    /* The session is resumed when reconnecting. */
+    BTASSERT(open_close(&context, &socket, "server_a") == 0);
+    BTASSERT(context.session_cache.hits == 1);
+    BTASSERT(context.session_cache.misses == 1);
+
+    /* Another server, and no server hostname. */
+    BTASSERT(open_close(&context, &socket, "server_b") == 0);
+    BTASSERT(open_close(&context, &socket, NULL) == 0);
+    BTASSERT(context.session_cache.hits == 1);
+    BTASSERT(context.session_cache.misses == 3);
+
+    /* The least recently used session, the one of server_a, is
+       replaced by the session of a third server. */
+    BTASSERT(open_close(&context, &socket, "server_c") == 0);
+    BTASSERT(open_close(&context, &socket, "server_b") == 0);
+    BTASSERT(open_close(&context, &socket, "server_a") == 0);
+    BTASSERT(context.session_cache.hits == 2);
+    BTASSERT(context.session_cache.misses == 5);
+
+    BTASSERT(socket_close(&socket) == 0);
+    BTASSERT(ssl_context_destroy(&context) == 0);
+
+    return (0);
+}
+
+static void connect_to_server_f(void)
+{
+    open_close(&hook_context, &hook_socket, "server_f");
+}
+
+static int test_session_resumption_concurrent(void)
+{
+    BTASSERT(ssl_context_init(&hook_context, ssl_protocol_tls_v1_0) == 0);
+    BTASSERT(socket_open_tcp(&hook_socket) == 0);
+
+    /* Remember the sessions of two servers. */
+    BTASSERT(open_close(&hook_context, &hook_socket, "server_d") == 0);
+    BTASSERT(open_close(&hook_context, &hook_socket, "server_e") == 0);
+    BTASSERT(hook_context.session_cache.misses == 2);
+
+    /* A connection to a third server is made during the handshake
+       with server_d. Its session replaces neither the offered
+       session nor the session of another server than the least
+       recently used one, server_e. */
+    handshake_hook = connect_to_server_f;
+    BTASSERT(open_close(&hook_context, &hook_socket, "server_d") == 0);
+    BTASSERT(handshake_hook == NULL);
+    BTASSERT(hook_context.session_cache.hits == 1);
+    BTASSERT(hook_context.session_cache.misses == 3);
+
+    BTASSERT(open_close(&hook_context, &hook_socket, "server_f") == 0);
+    BTASSERT(open_close(&hook_context, &hook_socket, "server_d") == 0);
+    BTASSERT(hook_context.session_cache.hits == 3);
+    BTASSERT(open_close(&hook_context, &hook_socket, "server_e") == 0);
+    BTASSERT(hook_context.session_cache.misses == 4);
+
+    BTASSERT(socket_close(&hook_socket) == 0);
+    BTASSERT(ssl_context_destroy(&hook_context) == 0);
+
+    return (0);
+}
+
+/**
+ * Open and close given number of SSL connections and print the
+ * elapsed time.
+ */
+static int handshakes(struct ssl_context_t *context_p,
+                      struct socket_t *socket_p,
+                      const char *server_hostname_p,
+                      int number_of_handshakes,
+                      const char *kind_p)
+{
+    int start;
+    int i;
+
+    start = time_micros();
+
+    for (i = 0; i < number_of_handshakes; i++) {
+        BTASSERT(open_close(context_p, socket_p, server_hostname_p) == 0);
+    }
+
+    std_printf(OSTR("%d %s handshakes in %d us.\r\n"),
+               number_of_handshakes,
+               kind_p,
+               time_micros_elapsed(start, time_micros()));
+
+    return (0);
+}
+
+/**
+ * Handshake rate against the stand-in peer of the mbedTLS stub, so
+ * only the overhead of this module is measured.
+ */
+static int test_handshake_rate(void)
+{
+    struct ssl_context_t context;
+    struct socket_t socket;
+
+    BTASSERT(ssl_context_init(&context, ssl_protocol_tls_v1_0) == 0);
+    BTASSERT(socket_open_tcp(&socket) == 0);
+
+    BTASSERT(handshakes(&context, &socket, NULL, 1000, "full") == 0);
+    BTASSERT(handshakes(&context, &socket, "server", 1000, "resumed") == 0);
+
+    BTASSERT(context.session_cache.hits == 999);
+    BTASSERT(context.session_cache.misses == 1001);
+
+    BTASSERT(socket_close(&socket) == 0);
+    BTASSERT(ssl_context_destroy(&context) == 0);
+
+    return (0);
+}
+
+static int test_memory(void)
+{
+    struct ssl_context_t context;
+    struct socket_t socket;
+    struct ssl_memory_usage_t usage;
+    size_t current;
+    void *buf_p;
+
+    BTASSERT(CONFIG_SSL_SOCKETS_MAX == 2);
+    BTASSERT(CONFIG_SSL_RECORD_SIZE_MAX == 4096);
+
+    BTASSERT(ssl_context_init(&context, ssl_protocol_tls_v1_0) == 0);
+    BTASSERT(socket_open_tcp(&socket) == 0);
+
+    BTASSERT(ssl_module_get_memory_usage(&usage) == 0);
+    current = usage.current;
+    BTASSERT(ssl_module_reset_memory_peak() == 0);
+
+    /* Peak memory usage of a connection, with its input and output
+       record buffers. */
+    BTASSERT(open_close(&context, &socket, "server") == 0);
+    BTASSERT(ssl_module_get_memory_usage(&usage) == 0);
+    BTASSERT(usage.current == current);
+    BTASSERT(usage.peak > current + 2 * CONFIG_SSL_RECORD_SIZE_MAX);
+    BTASSERT(usage.peak < current + 2 * 16384);
+
+    std_printf(OSTR("Peak memory per connection: %u bytes.\r\n"),
+               (unsigned int)(usage.peak - current));
+
+    /* Allocations of record size outside of the connection setup are
+       not taken from the record buffer pool. */
+    buf_p = mbedtls_calloc(1, CONFIG_SSL_RECORD_SIZE_MAX + 333);
+    BTASSERT(buf_p != NULL);
+    BTASSERT(ssl_module_get_memory_usage(&usage) == 0);
+    BTASSERT(usage.current == current + CONFIG_SSL_RECORD_SIZE_MAX + 333);
+    mbedtls_free(buf_p);
+
+    /* Nothing is leaked by many connections. */
+    BTASSERT(handshakes(&context, &socket, "server", 100, "resumed") == 0);
+    BTASSERT(ssl_module_get_memory_usage(&usage) == 0);
+    BTASSERT(usage.current == current);
+
+    BTASSERT(socket_close(&socket) == 0);
+    BTASSERT(ssl_context_destroy(&context) == 0);
+
     return (0);
 }
 
@@ -243,6 +464,11 @@ int main()
         { test_server, "test_server" },
         { test_client_server_context, "test_client_server_context" },
         { test_errors, "test_errors" },
+        { test_session_resumption, "test_session_resumption" },
+        { test_session_resumption_concurrent,
+          "test_session_resumption_concurrent" },
+        { test_handshake_rate, "test_handshake_rate" },
+        { test_memory, "test_memory" },
         { NULL, NULL }
     };
 
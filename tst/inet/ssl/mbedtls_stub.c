@@ -39,6 +39,34 @@
 #include "mbedtls/error.h"
 #include "mbedtls/debug.h"
 #include "mbedtls/timing.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
+#include "mbedtls/platform.h"
+
+/* Record buffer size as in mbedTLS without compression. */
+#define BUFFER_LEN                 (MBEDTLS_SSL_MAX_CONTENT_LEN + 333)
+
+/* The stand-in peer resumes the session offered by the client, and
+   sessions found in the server side session cache. */
+static int session_offered = 0;
+static mbedtls_ssl_session cached_session;
+static int session_cached = 0;
+
+/* Called once by the next handshake, to run other connections while
+   the handshake is in progress. */
+void (*handshake_hook)(void) = NULL;
+
+void *(*mbedtls_calloc)(size_t, size_t) = calloc;
+void (*mbedtls_free)(void *) = free;
+
+int mbedtls_platform_set_calloc_free(void *(*calloc_func)(size_t, size_t),
+                                     void (*free_func)(void *))
+{
+    mbedtls_calloc = calloc_func;
+    mbedtls_free = free_func;
+
+    return (0);
+}
 
 void mbedtls_ssl_cookie_init(mbedtls_ssl_cookie_ctx *ctx_p)
 {
@@ -46,11 +74,18 @@ void mbedtls_ssl_cookie_init(mbedtls_ssl_cookie_ctx *ctx_p)
 
 void mbedtls_ssl_init(mbedtls_ssl_context *ssl_p)
 {
+    ssl_p->conf = NULL;
+    ssl_p->session = NULL;
     ssl_p->hostname = NULL;
+    ssl_p->in_buf = NULL;
+    ssl_p->out_buf = NULL;
 }
 
 void mbedtls_ssl_config_init(mbedtls_ssl_config *conf_p)
 {
+    conf_p->f_get_cache = NULL;
+    conf_p->f_set_cache = NULL;
+    conf_p->p_cache = NULL;
 }
 
 void mbedtls_x509_crt_init(mbedtls_x509_crt *crt_p)
@@ -99,6 +134,8 @@ int mbedtls_ssl_config_defaults(mbedtls_ssl_config *conf_p,
                                 int transport,
                                 int preset)
 {
+    conf_p->endpoint = endpoint;
+
     return (0);
 }
 
@@ -135,10 +172,21 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl_p,
 
     counter++;
 
-    if (counter == 5) {
+    if (counter == 7) {
         return (-1);
     }
-    
+
+    ssl_p->conf = conf_p;
+    ssl_p->in_buf = mbedtls_calloc(1, BUFFER_LEN);
+    ssl_p->out_buf = mbedtls_calloc(1, BUFFER_LEN);
+    ssl_p->session = mbedtls_calloc(1, sizeof(*ssl_p->session));
+
+    if ((ssl_p->in_buf == NULL)
+        || (ssl_p->out_buf == NULL)
+        || (ssl_p->session == NULL)) {
+        return (-1);
+    }
+
     return (0);
 }
 
@@ -155,18 +203,54 @@ void mbedtls_ssl_set_bio(mbedtls_ssl_context *ssl_p,
 int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl_p)
 {
     static int counter = 0;
-
+    static uint32_t master = 0;
+    const mbedtls_ssl_config *conf_p;
+    int resume;
+    void (*hook_p)(void);
+
+    conf_p = ssl_p->conf;
+    resume = session_offered;
+    session_offered = 0;
     counter++;
 
-    if (counter == 5) {
+    if (counter == 7) {
         return (-1);
     }
-    
+
+    if (handshake_hook != NULL) {
+        hook_p = handshake_hook;
+        handshake_hook = NULL;
+        hook_p();
+    }
+
+    if (conf_p->endpoint == MBEDTLS_SSL_IS_SERVER) {
+        if (conf_p->f_get_cache != NULL) {
+            resume = (conf_p->f_get_cache(conf_p->p_cache,
+                                          ssl_p->session) == 0);
+        }
+    }
+
+    if (resume) {
+        return (0);
+    }
+
+    /* A full handshake derives a new master secret. */
+    master++;
+    memset(&ssl_p->session->master[0], 0, sizeof(ssl_p->session->master));
+    memcpy(&ssl_p->session->master[0], &master, sizeof(master));
+
+    if (conf_p->f_set_cache != NULL) {
+        conf_p->f_set_cache(conf_p->p_cache, ssl_p->session);
+    }
+
     return (0);
 }
 
 void mbedtls_ssl_free(mbedtls_ssl_context *ssl_p)
 {
+    mbedtls_free(ssl_p->in_buf);
+    mbedtls_free(ssl_p->out_buf);
+    mbedtls_free(ssl_p->session);
 }
 
 int mbedtls_ssl_write(mbedtls_ssl_context *ssl_p,
@@ -235,3 +319,116 @@ int mbedtls_ssl_set_hostname(mbedtls_ssl_context *ssl_p,
     
     return (0);
 }
+
+void mbedtls_ssl_cache_init(mbedtls_ssl_cache_context *cache_p)
+{
+}
+
+void mbedtls_ssl_cache_set_max_entries(mbedtls_ssl_cache_context *cache_p,
+                                       int max)
+{
+}
+
+int mbedtls_ssl_cache_get(void *data_p, mbedtls_ssl_session *session_p)
+{
+    if (!session_cached) {
+        return (1);
+    }
+
+    *session_p = cached_session;
+
+    return (0);
+}
+
+int mbedtls_ssl_cache_set(void *data_p, const mbedtls_ssl_session *session_p)
+{
+    cached_session = *session_p;
+    session_cached = 1;
+
+    return (0);
+}
+
+void mbedtls_ssl_conf_session_cache(mbedtls_ssl_config *conf_p,
+                                    void *p_cache,
+                                    int (*f_get_cache)(void *,
+                                                       mbedtls_ssl_session *),
+                                    int (*f_set_cache)(void *,
+                                                       const mbedtls_ssl_session *))
+{
+    conf_p->p_cache = p_cache;
+    conf_p->f_get_cache = f_get_cache;
+    conf_p->f_set_cache = f_set_cache;
+}
+
+void mbedtls_ssl_ticket_init(mbedtls_ssl_ticket_context *ctx_p)
+{
+}
+
+int mbedtls_ssl_ticket_setup(mbedtls_ssl_ticket_context *ctx_p,
+                             int (*f_rng)(void *, unsigned char *, size_t),
+                             void *p_rng,
+                             mbedtls_cipher_type_t cipher,
+                             uint32_t lifetime)
+{
+    return (0);
+}
+
+int mbedtls_ssl_ticket_write(void *p_ticket,
+                             const mbedtls_ssl_session *session_p,
+                             unsigned char *start_p,
+                             const unsigned char *end_p,
+                             size_t *tlen_p,
+                             uint32_t *lifetime_p)
+{
+    return (-1);
+}
+
+int mbedtls_ssl_ticket_parse(void *p_ticket,
+                             mbedtls_ssl_session *session_p,
+                             unsigned char *buf_p,
+                             size_t len)
+{
+    return (-1);
+}
+
+void mbedtls_ssl_conf_session_tickets_cb(mbedtls_ssl_config *conf_p,
+                                         mbedtls_ssl_ticket_write_t *f_ticket_write,
+                                         mbedtls_ssl_ticket_parse_t *f_ticket_parse,
+                                         void *p_ticket)
+{
+}
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session_p)
+{
+    memset(session_p, 0, sizeof(*session_p));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session_p)
+{
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl_p,
+                            const mbedtls_ssl_session *session_p)
+{
+    *ssl_p->session = *session_p;
+    session_offered = 1;
+
+    return (0);
+}
+
+int mbedtls_ssl_conf_max_frag_len(mbedtls_ssl_config *conf_p,
+                                  unsigned char mfl_code)
+{
+    /* CONFIG_SSL_RECORD_SIZE_MAX is 4096 in this suite. */
+    BTASSERT(mfl_code == MBEDTLS_SSL_MAX_FRAG_LEN_4096);
+
+    return (0);
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl_p,
+                            mbedtls_ssl_session *session_p)
+{
+    *session_p = *ssl_p->session;
+
+    return (0);
+}
@@ -370,6 +370,359 @@ static int test_bad_request(void)
     return (0);
 }
 
+static int write_file(const char *path_p, const char *data_p)
+{
+    struct fs_file_t file;
+    size_t size;
+
+    size = strlen(data_p);
+    BTASSERT(fs_open(&file, path_p, FS_WRITE | FS_CREAT | FS_TRUNC) == 0);
+    BTASSERT(fs_write(&file, data_p, size) == size);
+    BTASSERT(fs_close(&file) == 0);
+
+    return (0);
+}
+
+static int test_concurrent_clients(void)
+{
+    uint8_t buf[32];
+
+    BTASSERT(CONFIG_TFTP_SERVER_CLIENTS_MAX == 2);
+    BTASSERT(write_file("a.txt", "aaaa") == 0);
+    BTASSERT(write_file("b.txt", "bbbbbb") == 0);
+
+    /* Two read requests served at the same time. */
+    socket_stub_input(0, "\x00""\x01""a.txt""\x00""octet""\x00", 14);
+    socket_stub_output(&buf[0], 8);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x01""aaaa", 8) == 0);
+
+    socket_stub_input(0, "\x00""\x01""b.txt""\x00""octet""\x00", 14);
+    socket_stub_output(&buf[0], 10);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x01""bbbbbb", 10) == 0);
+
+    /* A third request is rejected as both clients are busy. */
+    socket_stub_input(0, "\x00""\x01""a.txt""\x00""octet""\x00", 14);
+    socket_stub_output(&buf[0], 21);
+    BTASSERT(buf[0] == 0);
+    BTASSERT(buf[1] == 5);
+    BTASSERT(buf[2] == 0);
+    BTASSERT(buf[3] == 0);
+    BTASSERT(strcmp("too many clients", (char *)&buf[4]) == 0);
+
+    /* Acknowledge the second transfer before the first. */
+    socket_stub_input(7, "\x00""\x04""\x00""\x01", 4);
+    socket_stub_input(6, "\x00""\x04""\x00""\x01", 4);
+
+    thrd_sleep_ms(10);
+
+    BTASSERT(task_is_done(&server.clients[0].task) == 1);
+    BTASSERT(task_is_done(&server.clients[1].task) == 1);
+
+    std_printf(OSTR("Each client uses %u bytes instead of a thread.\r\n"),
+               (unsigned int)sizeof(server.clients[0]));
+
+    return (0);
+}
+
+static int test_options_read(void)
+{
+    uint8_t buf[604];
+    char data[1000];
+    int i;
+    static const char request[] =
+        "\x00""\x01""opt.txt""\x00""octet""\x00"
+        "BLKSIZE""\x00""600""\x00"
+        "tsize""\x00""0""\x00"
+        "windowsize""\x00""2""\x00"
+        "unknown""\x00""1""\x00";
+    static const char oack[] =
+        "\x00""\x06"
+        "blksize""\x00""600""\x00"
+        "tsize""\x00""999""\x00"
+        "windowsize""\x00""2""\x00";
+
+    for (i = 0; i < membersof(data) - 1; i++) {
+        data[i] = ('a' + (i % 26));
+    }
+
+    data[i] = '\0';
+    BTASSERT(write_file("opt.txt", data) == 0);
+
+    /* Read request with options. The file size is reported in the
+       tsize option. */
+    socket_stub_input(0, (void *)&request[0], sizeof(request) - 1);
+    socket_stub_output(&buf[0], sizeof(oack) - 1);
+    BTASSERT(memcmp(&buf[0], &oack[0], sizeof(oack) - 1) == 0);
+
+    /* Acknowledge the options. Both blocks are sent in one
+       window. */
+    socket_stub_input(8, "\x00""\x04""\x00""\x00", 4);
+
+    socket_stub_output(&buf[0], 604);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x01", 4) == 0);
+    BTASSERT(memcmp(&buf[4], &data[0], 600) == 0);
+
+    socket_stub_output(&buf[0], 403);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x02", 4) == 0);
+    BTASSERT(memcmp(&buf[4], &data[600], 399) == 0);
+
+    socket_stub_input(8, "\x00""\x04""\x00""\x02", 4);
+
+    thrd_sleep_ms(10);
+
+    BTASSERT(task_is_done(&server.clients[0].task) == 1);
+
+    return (0);
+}
+
+static int test_window_read(void)
+{
+    uint8_t buf[32];
+
+    BTASSERT(write_file("win.txt", "0123456789abcdefghij") == 0);
+
+    socket_stub_input(0,
+                      "\x00""\x01""win.txt""\x00""octet""\x00"
+                      "blksize""\x00""8""\x00"
+                      "windowsize""\x00""4""\x00",
+                      39);
+    socket_stub_output(&buf[0], 25);
+    BTASSERT(memcmp(&buf[0],
+                    "\x00""\x06"
+                    "blksize""\x00""8""\x00"
+                    "windowsize""\x00""4""\x00",
+                    25) == 0);
+
+    /* A window ends at the last block. */
+    socket_stub_input(9, "\x00""\x04""\x00""\x00", 4);
+
+    socket_stub_output(&buf[0], 12);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x01""01234567", 12) == 0);
+    socket_stub_output(&buf[0], 12);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x02""89abcdef", 12) == 0);
+    socket_stub_output(&buf[0], 8);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x03""ghij", 8) == 0);
+
+    /* Block two was lost. The client acknowledges block one and the
+       window restarts at block two. */
+    socket_stub_input(9, "\x00""\x04""\x00""\x01", 4);
+
+    socket_stub_output(&buf[0], 12);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x02""89abcdef", 12) == 0);
+    socket_stub_output(&buf[0], 8);
+    BTASSERT(memcmp(&buf[0], "\x00""\x03""\x00""\x03""ghij", 8) == 0);
+
+    /* Bad acknowledgement outside the window. */
+    socket_stub_input(9, "\x00""\x04""\x00""\x05", 4);
+    socket_stub_input(9, "\x00""\x04""\x00""\x03", 4);
+
+    thrd_sleep_ms(10);
+
+    BTASSERT(task_is_done(&server.clients[0].task) == 1);
+
+    return (0);
+}
+
+static int test_window_write(void)
+{
+    struct fs_file_t file;
+    uint8_t buf[64];
+
+    socket_stub_input(0,
+                      "\x00""\x02""wwin.txt""\x00""octet""\x00"
+                      "blksize""\x00""8""\x00"
+                      "tsize""\x00""51""\x00"
+                      "windowsize""\x00""4""\x00",
+                      49);
+
+    /* The tsize value of a write request is echoed. */
+    socket_stub_output(&buf[0], 34);
+    BTASSERT(memcmp(&buf[0],
+                    "\x00""\x06"
+                    "blksize""\x00""8""\x00"
+                    "tsize""\x00""51""\x00"
+                    "windowsize""\x00""4""\x00",
+                    34) == 0);
+
+    /* The first block acknowledges the options. One acknowledgement
+       per full window. */
+    socket_stub_input(10, "\x00""\x03""\x00""\x01""aaaaaaaa", 12);
+    socket_stub_input(10, "\x00""\x03""\x00""\x02""bbbbbbbb", 12);
+    socket_stub_input(10, "\x00""\x03""\x00""\x03""cccccccc", 12);
+    socket_stub_input(10, "\x00""\x03""\x00""\x04""dddddddd", 12);
+
+    socket_stub_output(&buf[0], 4);
+    BTASSERT(memcmp(&buf[0], "\x00""\x04""\x00""\x04", 4) == 0);
+
+    /* Block five is lost. The last received block is acknowledged
+       once to restart the window. */
+    socket_stub_input(10, "\x00""\x03""\x00""\x06""ffffffff", 12);
+    socket_stub_input(10, "\x00""\x03""\x00""\x07""ggg", 7);
+
+    socket_stub_output(&buf[0], 4);
+    BTASSERT(memcmp(&buf[0], "\x00""\x04""\x00""\x04", 4) == 0);
+
+    socket_stub_input(10, "\x00""\x03""\x00""\x05""eeeeeeee", 12);
+    socket_stub_input(10, "\x00""\x03""\x00""\x06""ffffffff", 12);
+    socket_stub_input(10, "\x00""\x03""\x00""\x07""ggg", 7);
+
+    /* The last block is acknowledged immediately. */
+    socket_stub_output(&buf[0], 4);
+    BTASSERT(memcmp(&buf[0], "\x00""\x04""\x00""\x07", 4) == 0);
+
+    thrd_sleep_ms(10);
+
+    BTASSERT(task_is_done(&server.clients[0].task) == 1);
+
+    BTASSERT(fs_open(&file, "wwin.txt", FS_READ) == 0);
+    BTASSERT(fs_read(&file, &buf[0], sizeof(buf)) == 51);
+    BTASSERT(memcmp(&buf[0],
+                    "aaaaaaaabbbbbbbbccccccccdddddddd"
+                    "eeeeeeeeffffffffggg",
+                    51) == 0);
+    BTASSERT(fs_close(&file) == 0);
+
+    return (0);
+}
+
+/**
+ * Read given file with given options, sleeping a while before each
+ * acknowledgement to emulate the round trip time of a real network.
+ */
+static int read_with_latency(int socket,
+                             const char *path_p,
+                             size_t file_size,
+                             int block_size,
+                             int window_size,
+                             uint32_t *elapsed_ms_p)
+{
+    static uint8_t buf[4 + CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX];
+    static char request[64];
+    static char oack[48];
+    static uint8_t acks[2][4];
+    struct time_t start;
+    struct time_t stop;
+    size_t request_size;
+    size_t oack_size;
+    size_t offset;
+    size_t size;
+    uint16_t block_number;
+    int i;
+
+    request_size = (std_sprintf(&request[0],
+                                FSTR("||%s|octet|blksize|%d|windowsize|%d|"),
+                                path_p,
+                                block_size,
+                                window_size));
+    oack_size = (std_sprintf(&oack[0],
+                             FSTR("||blksize|%d|windowsize|%d|"),
+                             block_size,
+                             window_size));
+
+    for (i = 0; i < request_size; i++) {
+        if (request[i] == '|') {
+            request[i] = '\0';
+        }
+    }
+
+    for (i = 0; i < oack_size; i++) {
+        if (oack[i] == '|') {
+            oack[i] = '\0';
+        }
+    }
+
+    request[1] = 1;
+    oack[1] = 6;
+
+    time_get(&start);
+
+    socket_stub_input(0, &request[0], request_size);
+    socket_stub_output(&buf[0], oack_size);
+    BTASSERT(memcmp(&buf[0], &oack[0], oack_size) == 0);
+
+    block_number = 0;
+    offset = 0;
+
+    while (1) {
+        acks[block_number % 2][0] = 0;
+        acks[block_number % 2][1] = 4;
+        acks[block_number % 2][2] = (block_number >> 8);
+        acks[block_number % 2][3] = block_number;
+        thrd_sleep_ms(5);
+        socket_stub_input(socket, &acks[block_number % 2][0], 4);
+
+        if (offset > file_size) {
+            break;
+        }
+
+        for (i = 0; (i < window_size) && (offset <= file_size); i++) {
+            block_number++;
+            size = MIN(block_size, file_size - offset);
+            socket_stub_output(&buf[0], size + 4);
+            BTASSERT(buf[1] == 3);
+            BTASSERT(((buf[2] << 8) | buf[3]) == block_number);
+            offset += block_size;
+        }
+    }
+
+    time_get(&stop);
+    time_subtract(&stop, &stop, &start);
+    *elapsed_ms_p = (stop.seconds * 1000 + stop.nanoseconds / 1000000);
+
+    thrd_sleep_ms(20);
+
+    BTASSERT(task_is_done(&server.clients[0].task) == 1);
+
+    return (0);
+}
+
+static int test_transfer_rate(void)
+{
+    struct fs_file_t file;
+    static uint8_t buf[1024];
+    uint32_t elapsed_ms[2];
+    int i;
+
+    for (i = 0; i < membersof(buf); i++) {
+        buf[i] = i;
+    }
+
+    BTASSERT(fs_open(&file, "rate.bin", FS_WRITE | FS_CREAT | FS_TRUNC) == 0);
+
+    for (i = 0; i < 16; i++) {
+        BTASSERT(fs_write(&file, &buf[0], sizeof(buf)) == sizeof(buf));
+    }
+
+    BTASSERT(fs_close(&file) == 0);
+
+    /* Default block size, one block per round trip. */
+    BTASSERT(read_with_latency(11,
+                               "rate.bin",
+                               16384,
+                               512,
+                               1,
+                               &elapsed_ms[0]) == 0);
+
+    /* Largest block size and a window of eight blocks. */
+    BTASSERT(read_with_latency(12,
+                               "rate.bin",
+                               16384,
+                               CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX,
+                               8,
+                               &elapsed_ms[1]) == 0);
+
+    std_printf(OSTR("Transfer rate with 5 ms round trip time:\r\n"
+                    "  blksize 512, windowsize 1: %lu bytes/s\r\n"
+                    "  blksize %d, windowsize 8: %lu bytes/s\r\n"),
+               16384000UL / MAX(elapsed_ms[0], 1),
+               CONFIG_TFTP_SERVER_BLOCK_SIZE_MAX,
+               16384000UL / MAX(elapsed_ms[1], 1));
+
+    BTASSERT(elapsed_ms[1] < elapsed_ms[0]);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -379,6 +732,11 @@ int main()
         { test_read_timeout, "test_read_timeout" },
         { test_write_timeout, "test_write_timeout" },
         { test_bad_request, "test_bad_request" },
+        { test_concurrent_clients, "test_concurrent_clients" },
+        { test_options_read, "test_options_read" },
+        { test_window_read, "test_window_read" },
+        { test_window_write, "test_window_write" },
+        { test_transfer_rate, "test_transfer_rate" },
         { NULL, NULL }
     };
 
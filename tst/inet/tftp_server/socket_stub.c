@@ -28,28 +28,47 @@
 
 #include "simba.h"
 
-static struct queue_t qinput;
 static struct queue_t qoutput;
-static char qinputbuf[256];
 static char qoutputbuf[256];
 static struct event_t accept_events;
 static struct event_t closed_events;
 
-static struct socket_t *sockets[8];
+/* One input queue per socket, as the server polls several sockets. */
+static struct socket_t *sockets[16];
+static struct queue_t qinputs[16];
+static char qinputbufs[16][128];
 static int number_of_sockets = 0;
 
+static struct queue_t *socket_input(void *self_p)
+{
+    int i;
+
+    /* Sockets are reopened by the server, so the last one is the
+       current. */
+    for (i = (number_of_sockets - 1); i >= 0; i--) {
+        if (sockets[i] == self_p) {
+            return (&qinputs[i]);
+        }
+    }
+
+    return (NULL);
+}
+
 static ssize_t read(void *self_p,
                     void *buf_p,
                     size_t size)
 {
     void *ref_buf_p;
     size_t ref_size;
+    struct queue_t *qinput_p;
 
-    queue_read(&qinput, &ref_buf_p, sizeof(ref_buf_p));
-    queue_read(&qinput, &ref_size, sizeof(ref_size));
+    qinput_p = socket_input(self_p);
+    queue_read(qinput_p, &ref_buf_p, sizeof(ref_buf_p));
+    queue_read(qinput_p, &ref_size, sizeof(ref_size));
+    size = MIN(size, ref_size);
     memcpy(buf_p, ref_buf_p, size);
 
-    return (ref_size);
+    return (size);
 }
 
 static ssize_t write(void *self_p,
@@ -61,7 +80,7 @@ static ssize_t write(void *self_p,
 
 static size_t size(void *self_p)
 {
-    return (queue_size(&qinput));
+    return (queue_size(socket_input(self_p)));
 }
 
 int socket_module_init()
@@ -80,6 +99,9 @@ int socket_open_udp(struct socket_t *self_p)
         return (-1);
     }
 
+    queue_init(&qinputs[number_of_sockets],
+               &qinputbufs[number_of_sockets][0],
+               sizeof(qinputbufs[number_of_sockets]));
     sockets[number_of_sockets++] = self_p;
 
     return (chan_init(&self_p->base, read, write, size));
@@ -154,7 +176,7 @@ ssize_t socket_recvfrom(struct socket_t *self_p,
     inet_aton("1.2.3.4", &remote_addr_p->ip);
     remote_addr_p->port = 34345;
 
-    return (read(NULL, buf_p, size));
+    return (read(self_p, buf_p, size));
 }
 
 ssize_t socket_write(struct socket_t *self_p,
@@ -168,12 +190,11 @@ ssize_t socket_read(struct socket_t *self_p,
                     void *buf_p,
                     size_t size)
 {
-    return (read(NULL, buf_p, size));
+    return (read(self_p, buf_p, size));
 }
 
 void socket_stub_init()
 {
-    queue_init(&qinput, qinputbuf, sizeof(qinputbuf));
     queue_init(&qoutput, qoutputbuf, sizeof(qoutputbuf));
     event_init(&accept_events);
     event_init(&closed_events);
@@ -209,8 +230,8 @@ void socket_stub_input(int socket, void *buf_p, size_t size)
         socket_p->base.reader_p = NULL;
     }
 
-    chan_write_isr(&qinput, &buf_p, sizeof(buf_p));
-    chan_write_isr(&qinput, &size, sizeof(size));
+    chan_write_isr(&qinputs[socket], &buf_p, sizeof(buf_p));
+    chan_write_isr(&qinputs[socket], &size, sizeof(size));
 
     sys_unlock();
 }
@@ -230,6 +251,10 @@ void socket_stub_wait_closed()
 
 void socket_stub_close_connection(void)
 {
-    queue_stop(&qinput);
-    queue_start(&qinput);
+    int i;
+
+    for (i = 0; i < number_of_sockets; i++) {
+        queue_stop(&qinputs[i]);
+        queue_start(&qinputs[i]);
+    }
 }
@@ -28,8 +28,11 @@
 
 #include "simba.h"
 
+#define OPERATIONS                                    1000000
+
 static struct sem_t sem;
 static struct mutex_t mutex;
+static struct event_t event;
 static int sem_counter = 0;
 static int mutex_counter = 0;
 #if defined(ARCH_ARM64)
@@ -123,6 +126,86 @@ static void *worker_main(void *arg_p)
     return (NULL);
 }
 
+/**
+ * Returns the number of operations per second given the number of
+ * operations and the time they took.
+ */
+static unsigned long operations_per_second(int operations,
+                                           struct time_t *start_p)
+{
+    struct time_t now;
+    struct time_t diff;
+    unsigned long long elapsed_us;
+
+    time_get(&now);
+    time_subtract(&diff, &now, start_p);
+    elapsed_us = (1000000ULL * diff.seconds + diff.nanoseconds / 1000);
+
+    if (elapsed_us == 0) {
+        elapsed_us = 1;
+    }
+
+    return ((unsigned long)((1000000ULL * operations) / elapsed_us));
+}
+
+static int test_throughput(void)
+{
+    int i;
+    uint32_t mask;
+    struct time_t start;
+    unsigned long mutex_ops;
+    unsigned long sem_ops;
+    unsigned long event_ops;
+
+    /* Uncontended lock and unlock. */
+    mutex_init(&mutex);
+    time_get(&start);
+
+    for (i = 0; i < OPERATIONS; i++) {
+        mutex_lock(&mutex);
+        mutex_unlock(&mutex);
+    }
+
+    mutex_ops = operations_per_second(2 * OPERATIONS, &start);
+
+    /* Uncontended take and give. */
+    sem_init(&sem, 0, 1);
+    time_get(&start);
+
+    for (i = 0; i < OPERATIONS; i++) {
+        sem_take(&sem, NULL);
+        sem_give(&sem, 1);
+    }
+
+    sem_ops = operations_per_second(2 * OPERATIONS, &start);
+
+    /* Write and read without a waiting reader. */
+    event_init(&event);
+    time_get(&start);
+
+    for (i = 0; i < OPERATIONS; i++) {
+        mask = 0x1;
+        event_write(&event, &mask, sizeof(mask));
+        mask = 0x1;
+        event_read(&event, &mask, sizeof(mask));
+    }
+
+    event_ops = operations_per_second(2 * OPERATIONS, &start);
+
+    std_printf(OSTR("mutex: %lu operations per second\r\n"
+                    "sem: %lu operations per second\r\n"
+                    "event: %lu operations per second\r\n"),
+               mutex_ops,
+               sem_ops,
+               event_ops);
+
+    BTASSERTI(mask, ==, 0x1);
+    BTASSERTI(sem.count, ==, 0);
+    BTASSERTI(mutex.is_locked, ==, 0);
+
+    return (0);
+}
+
 static int test_all(void)
 {
     int i;
@@ -130,9 +213,11 @@ static int test_all(void)
     int local_sem_counter;
     int global_mutex_counter;
     int local_mutex_counter;
+    struct time_t start;
 
     sem_init(&sem, 0, 1);
     mutex_init(&mutex);
+    time_get(&start);
 
     thrd_spawn(worker_main,
                &workers[0],
@@ -174,11 +259,15 @@ static int test_all(void)
     std_printf(FSTR("global_sem_counter: %d\r\n"
                     "local_sem_counter: %d\r\n"
                     "global_mutex_counter: %d\r\n"
-                    "local_mutex_counter: %d\r\n"),
+                    "local_mutex_counter: %d\r\n"
+                    "contended: %lu operations per second\r\n"),
                global_sem_counter,
                local_sem_counter,
                global_mutex_counter,
-               local_mutex_counter);
+               local_mutex_counter,
+               operations_per_second(
+                   2 * (global_sem_counter + global_mutex_counter),
+                   &start));
 
     BTASSERTI(global_sem_counter, >, 10000);
     BTASSERTI(global_mutex_counter, >, 10000);
@@ -191,6 +280,7 @@ static int test_all(void)
 int main()
 {
     struct harness_testcase_t testcases[] = {
+        { test_throughput, "test_throughput" },
         { test_all, "test_all" },
         { NULL, NULL }
     };
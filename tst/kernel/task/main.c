@@ -0,0 +1,350 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#if defined(ARCH_LINUX)
+#    define STACK_SIZE                                           8192
+#else
+#    define STACK_SIZE                                            512
+#endif
+
+#define ELEMENTS_MAX                                                4
+#define TASKS_MAX                                                  64
+
+struct echo_t {
+    struct task_t task;
+    struct queue_t input;
+    char inputbuf[8];
+    struct queue_t *output_p;
+    struct time_t timeout;
+    int value;
+};
+
+struct sleeper_t {
+    struct task_t task;
+    struct time_t timeout;
+    int counter;
+};
+
+struct waiter_t {
+    struct task_t task;
+    struct event_t *event_p;
+    uint32_t mask;
+    int res;
+    int calls;
+};
+
+static struct task_executor_t executor;
+static struct chan_list_elem_t elements[ELEMENTS_MAX];
+static THRD_STACK(stack, STACK_SIZE);
+static struct queue_t output;
+static char outputbuf[64];
+static struct echo_t echoes[6];
+static struct sleeper_t sleepers[TASKS_MAX];
+static int done_counter;
+
+/**
+ * Echo integers read from the input queue to the output queue, and -1
+ * on timeout.
+ */
+static int echo_main(struct task_t *task_p)
+{
+    struct echo_t *self_p;
+
+    self_p = task_p->arg_p;
+
+    TASK_BEGIN(task_p);
+
+    while (1) {
+        TASK_AWAIT_CHAN(task_p, &self_p->input, &self_p->timeout);
+
+        if (task_p->res == -ETIMEDOUT) {
+            self_p->value = -1;
+        } else {
+            queue_read(&self_p->input, &self_p->value, sizeof(self_p->value));
+        }
+
+        queue_write(self_p->output_p, &self_p->value, sizeof(self_p->value));
+
+        if (self_p->value <= 0) {
+            break;
+        }
+    }
+
+    TASK_END(task_p);
+}
+
+static int sleeper_main(struct task_t *task_p)
+{
+    struct sleeper_t *self_p;
+
+    self_p = task_p->arg_p;
+
+    TASK_BEGIN(task_p);
+
+    for (self_p->counter = 0; self_p->counter < 3; self_p->counter++) {
+        TASK_SLEEP(task_p, &self_p->timeout);
+        TASK_YIELD(task_p);
+    }
+
+    done_counter++;
+
+    TASK_END(task_p);
+}
+
+static int waiter_main(struct task_t *task_p)
+{
+    struct waiter_t *self_p;
+    struct time_t timeout;
+
+    self_p = task_p->arg_p;
+    self_p->calls++;
+    timeout.seconds = 0;
+    timeout.nanoseconds = 50000000;
+
+    TASK_BEGIN(task_p);
+
+    TASK_AWAIT_EVENT(task_p, self_p->event_p, &self_p->mask, &timeout);
+    self_p->res = task_p->res;
+
+    TASK_END(task_p);
+}
+
+static void echo_init(struct echo_t *self_p, int timeout_ms)
+{
+    queue_init(&self_p->input, &self_p->inputbuf[0], sizeof(self_p->inputbuf));
+    self_p->output_p = &output;
+    self_p->timeout.seconds = 0;
+    self_p->timeout.nanoseconds = 1000000L * timeout_ms;
+    task_init(&self_p->task, echo_main, self_p);
+}
+
+static int test_init(void)
+{
+    BTASSERT(queue_init(&output, &outputbuf[0], sizeof(outputbuf)) == 0);
+    BTASSERT(task_executor_init(&executor,
+                                &elements[0],
+                                membersof(elements),
+                                "executor",
+                                0,
+                                stack,
+                                sizeof(stack)) == 0);
+    BTASSERT(task_executor_start(&executor) == 0);
+
+    return (0);
+}
+
+static int test_chan(void)
+{
+    int value;
+
+    echo_init(&echoes[0], 1000);
+    BTASSERT(task_is_done(&echoes[0].task) == 1);
+    BTASSERT(task_spawn(&echoes[0].task, &executor) == 0);
+    BTASSERT(task_is_done(&echoes[0].task) == 0);
+
+    value = 5;
+    BTASSERT(queue_write(&echoes[0].input,
+                         &value,
+                         sizeof(value)) == sizeof(value));
+    BTASSERT(queue_read(&output, &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 5);
+
+    value = 0;
+    BTASSERT(queue_write(&echoes[0].input,
+                         &value,
+                         sizeof(value)) == sizeof(value));
+    BTASSERT(queue_read(&output, &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 0);
+
+    thrd_sleep_ms(10);
+    BTASSERT(task_is_done(&echoes[0].task) == 1);
+
+    return (0);
+}
+
+static int test_timeout(void)
+{
+    int value;
+
+    echo_init(&echoes[0], 10);
+    BTASSERT(task_spawn(&echoes[0].task, &executor) == 0);
+    BTASSERT(queue_read(&output, &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == -1);
+
+    thrd_sleep_ms(10);
+    BTASSERT(task_is_done(&echoes[0].task) == 1);
+
+    return (0);
+}
+
+static int test_event(void)
+{
+    struct event_t event;
+    struct waiter_t waiter;
+    uint32_t mask;
+
+    BTASSERT(event_init(&event) == 0);
+
+    /* Event written after the task started waiting. */
+    waiter.event_p = &event;
+    waiter.mask = 0x6;
+    waiter.res = 1;
+    BTASSERT(task_init(&waiter.task, waiter_main, &waiter) == 0);
+    BTASSERT(task_spawn(&waiter.task, &executor) == 0);
+    thrd_sleep_ms(10);
+    BTASSERT(task_is_done(&waiter.task) == 0);
+
+    mask = 0x3;
+    BTASSERT(event_write(&event, &mask, sizeof(mask)) == sizeof(mask));
+    thrd_sleep_ms(10);
+    BTASSERT(task_is_done(&waiter.task) == 1);
+    BTASSERT(waiter.res == 0);
+    BTASSERT(waiter.mask == 0x2);
+
+    /* Only the waited for event was read. */
+    BTASSERT(event_size(&event) == 1);
+    BTASSERT(event_clear(&event, 0x1) == 0);
+
+    /* Timeout. */
+    waiter.mask = 0x1;
+    BTASSERT(task_spawn(&waiter.task, &executor) == 0);
+    thrd_sleep_ms(100);
+    BTASSERT(task_is_done(&waiter.task) == 1);
+    BTASSERT(waiter.res == -ETIMEDOUT);
+    BTASSERT(waiter.mask == 0);
+
+    /* The executor blocks while only other events than the waited
+       for are set. */
+    mask = 0x1;
+    BTASSERT(event_write(&event, &mask, sizeof(mask)) == sizeof(mask));
+    waiter.mask = 0x2;
+    waiter.calls = 0;
+    BTASSERT(task_spawn(&waiter.task, &executor) == 0);
+    thrd_sleep_ms(20);
+    BTASSERT(task_is_done(&waiter.task) == 0);
+    BTASSERTI(waiter.calls, ==, 1);
+
+    mask = 0x2;
+    BTASSERT(event_write(&event, &mask, sizeof(mask)) == sizeof(mask));
+    thrd_sleep_ms(20);
+    BTASSERT(task_is_done(&waiter.task) == 1);
+    BTASSERT(waiter.res == 0);
+    BTASSERT(waiter.mask == 0x2);
+    BTASSERTI(waiter.calls, ==, 2);
+    BTASSERT(event_clear(&event, 0x1) == 0);
+
+    return (0);
+}
+
+static int test_many_tasks(void)
+{
+    int i;
+
+    done_counter = 0;
+
+    for (i = 0; i < membersof(sleepers); i++) {
+        sleepers[i].timeout.seconds = 0;
+        sleepers[i].timeout.nanoseconds = 1000000L * (1 + (i % 5));
+        BTASSERT(task_init(&sleepers[i].task,
+                           sleeper_main,
+                           &sleepers[i]) == 0);
+        BTASSERT(task_spawn(&sleepers[i].task, &executor) == 0);
+    }
+
+    for (i = 0; i < membersof(sleepers); i++) {
+        while (!task_is_done(&sleepers[i].task)) {
+            thrd_sleep_ms(5);
+        }
+
+        BTASSERT(sleepers[i].counter == 3);
+    }
+
+    BTASSERT(done_counter == TASKS_MAX);
+
+    std_printf(OSTR("%d tasks sharing one %d bytes stack used %u bytes"
+                    " of task state.\r\n"),
+               TASKS_MAX,
+               STACK_SIZE,
+               (unsigned int)sizeof(sleepers));
+
+    return (0);
+}
+
+static int test_overflow(void)
+{
+    int i;
+    int value;
+    int sum;
+
+    /* More channels than channel list elements. */
+    for (i = 0; i < membersof(echoes); i++) {
+        echo_init(&echoes[i], 1000);
+        BTASSERT(task_spawn(&echoes[i].task, &executor) == 0);
+    }
+
+    thrd_sleep_ms(10);
+
+    for (i = 0; i < membersof(echoes); i++) {
+        value = 0;
+        BTASSERT(queue_write(&echoes[i].input,
+                             &value,
+                             sizeof(value)) == sizeof(value));
+    }
+
+    sum = 0;
+
+    for (i = 0; i < membersof(echoes); i++) {
+        BTASSERT(queue_read(&output, &value, sizeof(value)) == sizeof(value));
+        sum += value;
+    }
+
+    BTASSERT(sum == 0);
+
+    return (0);
+}
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_chan, "test_chan" },
+        { test_timeout, "test_timeout" },
+        { test_event, "test_event" },
+        { test_many_tasks, "test_many_tasks" },
+        { test_overflow, "test_overflow" },
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -39,6 +39,18 @@ static THRD_STACK(suspend_resume_stack, 256);
 static THRD_STACK(terminate_stack, 256);
 #endif
 
+#if CONFIG_THRD_CONTENTION == 1
+static THRD_STACK(contention_stack, 1024);
+static struct mutex_t contention_mutex;
+static struct sem_t contention_sem;
+static struct rwlock_t contention_rwlock;
+#endif
+
+#if CONFIG_THRD_TRACE == 1
+static struct queue_t trace_queue;
+static char trace_queue_buf[2048];
+#endif
+
 static void *suspend_resume_main(void *arg_p)
 {
     thrd_set_name("resumer");
@@ -58,6 +70,21 @@ static void *terminate_main(void *arg_p)
     return (NULL);
 }
 
+#if CONFIG_THRD_CONTENTION == 1
+
+static void *contention_main(void *arg_p)
+{
+    thrd_set_name("contention");
+
+    /* Wait for the main thread to unlock the mutex. */
+    mutex_lock(&contention_mutex);
+    mutex_unlock(&contention_mutex);
+
+    return (NULL);
+}
+
+#endif
+
 int test_init(void)
 {
     /* This function may be called multiple times. */
@@ -365,6 +392,109 @@ int test_monitor_thread(void)
     return (0);
 }
 
+#if CONFIG_THRD_CONTENTION == 1
+
+int test_contention(void)
+{
+    struct thrd_t *thrd_p;
+    char command[64];
+
+    BTASSERT(mutex_init_named(&contention_mutex, "contention") == 0);
+    BTASSERT(sem_init_named(&contention_sem, 0, 1, "contention") == 0);
+    BTASSERT(rwlock_init_named(&contention_rwlock, "contention") == 0);
+
+    /* Initializing again does not list the mutex twice. */
+    BTASSERT(mutex_init_named(&contention_mutex, "contention") == 0);
+
+    /* The spawned thread waits for the mutex while the main thread
+       sleeps. */
+    BTASSERT(mutex_lock(&contention_mutex) == 0);
+    thrd_p = thrd_spawn(contention_main,
+                        NULL,
+                        10,
+                        contention_stack,
+                        sizeof(contention_stack));
+    BTASSERT(thrd_p != NULL);
+    BTASSERT(thrd_sleep_ms(20) == 0);
+    BTASSERT(mutex_unlock(&contention_mutex) == 0);
+    BTASSERT(thrd_join(thrd_p) == 0);
+
+    BTASSERT(contention_mutex.contention.holds == 2);
+    BTASSERT(contention_mutex.contention.waits == 1);
+    BTASSERT(contention_mutex.contention.wait_time_max_us >= 5000);
+    BTASSERT(contention_mutex.contention.hold_time_max_us >= 5000);
+
+    /* The semaphore is busy while all resources are taken. */
+    BTASSERT(sem_take(&contention_sem, NULL) == 0);
+    BTASSERT(sem_give(&contention_sem, 1) == 0);
+    BTASSERT(contention_sem.contention.holds == 1);
+    BTASSERT(contention_sem.contention.waits == 0);
+
+    /* The reader-writer lock is busy while held by anyone. */
+    BTASSERT(rwlock_reader_take(&contention_rwlock) == 0);
+    BTASSERT(rwlock_reader_take(&contention_rwlock) == 0);
+    BTASSERT(rwlock_reader_give(&contention_rwlock) == 0);
+    BTASSERT(rwlock_reader_give(&contention_rwlock) == 0);
+    BTASSERT(rwlock_writer_take(&contention_rwlock) == 0);
+    BTASSERT(rwlock_writer_give(&contention_rwlock) == 0);
+    BTASSERT(contention_rwlock.contention.holds == 2);
+    BTASSERT(contention_rwlock.contention.waits == 0);
+
+    strcpy(command, "/kernel/thrd/contention");
+    BTASSERT(fs_call(command, NULL, sys_get_stdout(), NULL) == 0);
+
+    return (0);
+}
+
+#endif
+
+#if CONFIG_THRD_TRACE == 1
+
+int test_trace(void)
+{
+    char buf[2048];
+    char command[64];
+    ssize_t size;
+
+    BTASSERT(queue_init(&trace_queue,
+                        &trace_queue_buf[0],
+                        sizeof(trace_queue_buf)) == 0);
+
+    /* Sleeping suspends the thread and swaps to the idle thread until
+       the timer resumes it. */
+    BTASSERT(thrd_trace_clear() == 0);
+    BTASSERT(thrd_trace_marker("sleep") == 0);
+    BTASSERT(thrd_sleep_ms(1) == 0);
+    BTASSERT(thrd_trace_dump(&trace_queue) == 0);
+
+    size = queue_size(&trace_queue);
+    BTASSERT(size > 0);
+    BTASSERT(size < (ssize_t)sizeof(buf));
+    BTASSERT(queue_read(&trace_queue, &buf[0], size) == size);
+    buf[size] = '\0';
+    std_printf(FSTR("%s"), &buf[0]);
+
+    BTASSERT(strstr(&buf[0], " main\r\n") != NULL);
+    BTASSERT(strstr(&buf[0], " idle\r\n") != NULL);
+    BTASSERT(strstr(&buf[0], " marker ") != NULL);
+    BTASSERT(strstr(&buf[0], " sleep\r\n") != NULL);
+    BTASSERT(strstr(&buf[0], " suspend ") != NULL);
+    BTASSERT(strstr(&buf[0], " swap ") != NULL);
+    BTASSERT(strstr(&buf[0], " timer ") != NULL);
+    BTASSERT(strstr(&buf[0], " resume ") != NULL);
+    BTASSERT(strstr(&buf[0], "dropped") == NULL);
+
+    /* The command prints the same events. */
+    strcpy(command, "/kernel/thrd/trace/dump");
+    BTASSERT(fs_call(command, NULL, sys_get_stdout(), NULL) == 0);
+    strcpy(command, "/kernel/thrd/trace/clear");
+    BTASSERT(fs_call(command, NULL, sys_get_stdout(), NULL) == 0);
+
+    return (0);
+}
+
+#endif
+
 int test_stack_heap(void)
 {
     BTASSERT(thrd_stack_alloc(1) == NULL);
@@ -414,6 +544,12 @@ int main()
         { test_stack_top_bottom, "test_stack_top_bottom" },
 #    if CONFIG_MONITOR_THREAD == 1
         { test_monitor_thread, "test_monitor_thread" },
+#    endif
+#    if CONFIG_THRD_CONTENTION == 1
+        { test_contention, "test_contention" },
+#    endif
+#    if CONFIG_THRD_TRACE == 1
+        { test_trace, "test_trace" },
 #    endif
         { test_stack_heap, "test_stack_heap" },
         { test_prio_list, "test_prio_list" },
@@ -0,0 +1,275 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#if defined(ARCH_LINUX)
+#    define STACK_SIZE                                           8192
+#    define PERFORMANCE_JOBS                                      256
+#    define PERFORMANCE_ITERATIONS                             200000
+#    define PERFORMANCE_WORKERS_MAX                                 4
+#else
+#    define STACK_SIZE                                            512
+#endif
+
+#define WORKERS_MAX                                                 2
+
+static struct thrd_pool_t pool;
+static struct thrd_pool_worker_t workers[WORKERS_MAX];
+static THRD_STACK(stacks, WORKERS_MAX * STACK_SIZE);
+
+static void *square(void *arg_p)
+{
+    long value;
+
+    value = (long)(uintptr_t)arg_p;
+
+    return ((void *)(uintptr_t)(value * value));
+}
+
+/**
+ * Calculate given Fibonacci number by submitting two jobs and waiting
+ * for them.
+ */
+static void *fibonacci(void *arg_p)
+{
+    struct thrd_pool_future_t futures[2];
+    long n;
+    long res;
+
+    n = (long)(uintptr_t)arg_p;
+
+    if (n < 2) {
+        return (arg_p);
+    }
+
+    thrd_pool_submit(&pool, &futures[0], fibonacci, (void *)(uintptr_t)(n - 1));
+    thrd_pool_submit(&pool, &futures[1], fibonacci, (void *)(uintptr_t)(n - 2));
+    res = (long)(uintptr_t)thrd_pool_wait(&pool, &futures[0]);
+    res += (long)(uintptr_t)thrd_pool_wait(&pool, &futures[1]);
+
+    return ((void *)(uintptr_t)res);
+}
+
+static int test_init(void)
+{
+    BTASSERT(thrd_pool_module_init() == 0);
+    BTASSERT(thrd_pool_module_init() == 0);
+    BTASSERT(thrd_pool_init(&pool,
+                            &workers[0],
+                            membersof(workers),
+                            1,
+                            stacks,
+                            STACK_SIZE) == 0);
+    BTASSERT(thrd_pool_start(&pool) == 0);
+
+    return (0);
+}
+
+static int test_submit_wait(void)
+{
+    struct thrd_pool_future_t futures[8];
+    long i;
+
+    for (i = 0; i < membersof(futures); i++) {
+        BTASSERT(thrd_pool_submit(&pool,
+                                  &futures[i],
+                                  square,
+                                  (void *)(uintptr_t)i) == 0);
+    }
+
+    for (i = 0; i < membersof(futures); i++) {
+        BTASSERT((long)(uintptr_t)thrd_pool_wait(&pool, &futures[i]) == i * i);
+        BTASSERT(thrd_pool_is_done(&futures[i]) == 1);
+    }
+
+    return (0);
+}
+
+static int test_nested(void)
+{
+    struct thrd_pool_future_t future;
+
+    /* Workers submit jobs and wait for them. */
+    BTASSERT(thrd_pool_submit(&pool,
+                              &future,
+                              fibonacci,
+                              (void *)(uintptr_t)10) == 0);
+    BTASSERT((long)(uintptr_t)thrd_pool_wait(&pool, &future) == 55);
+
+    return (0);
+}
+
+static int test_full(void)
+{
+    struct thrd_pool_future_t futures[3 * WORKERS_MAX
+                                      * CONFIG_THRD_POOL_DEQUE_MAX];
+    long i;
+
+    /* Jobs are executed by the calling thread when all deques are
+       full. */
+    for (i = 0; i < membersof(futures); i++) {
+        BTASSERT(thrd_pool_submit(&pool,
+                                  &futures[i],
+                                  square,
+                                  (void *)(uintptr_t)i) == 0);
+    }
+
+    for (i = 0; i < membersof(futures); i++) {
+        BTASSERT((long)(uintptr_t)thrd_pool_wait(&pool, &futures[i]) == i * i);
+    }
+
+    return (0);
+}
+
+static int test_stop(void)
+{
+    uint32_t executed;
+    int i;
+
+    BTASSERT(thrd_pool_stop(&pool) == 0);
+
+    executed = 0;
+
+    for (i = 0; i < membersof(workers); i++) {
+        std_printf(OSTR("worker %d: executed %lu, stolen %lu\r\n"),
+                   i,
+                   (unsigned long)workers[i].statistics.executed,
+                   (unsigned long)workers[i].statistics.stolen);
+        executed += workers[i].statistics.executed;
+    }
+
+    BTASSERT(executed > 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX) && (CONFIG_THRD_POOL_NATIVE == 1)
+
+static struct thrd_pool_worker_t
+performance_workers[PERFORMANCE_WORKERS_MAX];
+static struct thrd_pool_future_t performance_futures[PERFORMANCE_JOBS];
+
+/**
+ * A CPU-bound job.
+ */
+static void *checksum(void *arg_p)
+{
+    uint32_t crc;
+    long i;
+
+    crc = (uint32_t)(uintptr_t)arg_p;
+
+    for (i = 0; i < PERFORMANCE_ITERATIONS; i++) {
+        crc = ((crc >> 1) ^ (0xedb88320 & -(crc & 1)));
+    }
+
+    return ((void *)(uintptr_t)crc);
+}
+
+static int test_performance(void)
+{
+    struct thrd_pool_t performance_pool;
+    struct time_t start;
+    struct time_t stop;
+    unsigned long elapsed_ms;
+    unsigned long elapsed_one_ms;
+    int number_of_workers;
+    int i;
+
+    elapsed_one_ms = 0;
+
+    for (number_of_workers = 1;
+         number_of_workers <= PERFORMANCE_WORKERS_MAX;
+         number_of_workers *= 2) {
+        BTASSERT(thrd_pool_init(&performance_pool,
+                                &performance_workers[0],
+                                number_of_workers,
+                                1,
+                                NULL,
+                                0) == 0);
+        BTASSERT(thrd_pool_start(&performance_pool) == 0);
+        time_get(&start);
+
+        for (i = 0; i < PERFORMANCE_JOBS; i++) {
+            BTASSERT(thrd_pool_submit(&performance_pool,
+                                      &performance_futures[i],
+                                      checksum,
+                                      (void *)(uintptr_t)i) == 0);
+        }
+
+        for (i = 0; i < PERFORMANCE_JOBS; i++) {
+            thrd_pool_wait(&performance_pool, &performance_futures[i]);
+        }
+
+        time_get(&stop);
+        BTASSERT(thrd_pool_stop(&performance_pool) == 0);
+        time_subtract(&stop, &stop, &start);
+        elapsed_ms = (1000 * stop.seconds + stop.nanoseconds / 1000000);
+
+        if (elapsed_ms == 0) {
+            elapsed_ms = 1;
+        }
+
+        if (number_of_workers == 1) {
+            elapsed_one_ms = elapsed_ms;
+        }
+
+        std_printf(OSTR("%d worker(s): %lu jobs per second, "
+                        "speedup %lu.%02lu\r\n"),
+                   number_of_workers,
+                   1000UL * PERFORMANCE_JOBS / elapsed_ms,
+                   elapsed_one_ms / elapsed_ms,
+                   (100 * elapsed_one_ms / elapsed_ms) % 100);
+    }
+
+    return (0);
+}
+
+#endif
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_submit_wait, "test_submit_wait" },
+        { test_nested, "test_nested" },
+        { test_full, "test_full" },
+        { test_stop, "test_stop" },
+#if defined(ARCH_LINUX) && (CONFIG_THRD_POOL_NATIVE == 1)
+        { test_performance, "test_performance" },
+#endif
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
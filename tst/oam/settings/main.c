@@ -376,6 +376,129 @@ static int test_read_write_by_name(void)
     return (0);
 }
 
+static int test_get_setting_by_name(void)
+{
+    int32_t int32;
+    char string[SETTING_STRING_ESCAPE_SIZE];
+
+    /* First, last and missing names in the sorted name index. */
+    BTASSERTI(settings_read_by_name("blob",
+                                    &string[0],
+                                    SETTING_BLOB_SIZE), ==, SETTING_BLOB_SIZE);
+    BTASSERTI(settings_read_by_name("string_space",
+                                    &string[0],
+                                    SETTING_STRING_SPACE_SIZE), ==,
+              SETTING_STRING_SPACE_SIZE);
+    BTASSERTI(settings_read_by_name("string_escape",
+                                    &string[0],
+                                    SETTING_STRING_ESCAPE_SIZE), ==,
+              SETTING_STRING_ESCAPE_SIZE);
+    BTASSERTI(settings_read_by_name("max_name_length_40_123456789012345678901",
+                                    &string[0],
+                                    4), ==, 4);
+    BTASSERTI(settings_read_by_name("a", &int32, 4), ==, -EINVAL);
+    BTASSERTI(settings_read_by_name("int", &int32, 4), ==, -EINVAL);
+    BTASSERTI(settings_read_by_name("int320", &int32, 4), ==, -EINVAL);
+    BTASSERTI(settings_read_by_name("zzz", &int32, 4), ==, -EINVAL);
+
+    return (0);
+}
+
+static int test_shadow(void)
+{
+#if CONFIG_SETTINGS_SHADOW == 1
+    struct settings_stats_t before;
+    struct settings_stats_t after;
+    int32_t int32;
+    uint8_t buf[4];
+    uint8_t byte;
+    int i;
+
+    BTASSERTI(settings_get_stats(&before), ==, 0);
+
+    /* Writing an unchanged value does not write to NVM. */
+    int32 = 10;
+    BTASSERTI(settings_write(SETTING_INT32_ADDR, &int32, 4), ==, 4);
+    BTASSERTI(settings_get_stats(&after), ==, 0);
+    BTASSERTI(after.number_of_writes, ==, before.number_of_writes + 1);
+    BTASSERTI(after.number_of_unchanged_writes,
+              ==,
+              before.number_of_unchanged_writes + 1);
+    BTASSERTI(after.number_of_nvm_writes, ==, before.number_of_nvm_writes);
+
+    /* Writes in a batch are written to NVM in a single write. Six
+       ranges do not fit in the four dirty ranges and are merged. */
+    BTASSERTI(settings_begin(), ==, 0);
+
+    int32 = 11;
+    BTASSERTI(settings_write(SETTING_INT32_ADDR, &int32, 4), ==, 4);
+    int32 = 12;
+    BTASSERTI(settings_write(SETTING_INT32_ADDR, &int32, 4), ==, 4);
+
+    /* Nested batch. */
+    BTASSERTI(settings_begin(), ==, 0);
+    BTASSERTI(setting_string_write("s"), ==, 0);
+    BTASSERTI(settings_commit(), ==, 0);
+
+    for (i = 0; i < 4; i++) {
+        byte = (0x10 + i);
+        BTASSERTI(settings_write(0x40 + 8 * i, &byte, 1), ==, 1);
+    }
+
+    BTASSERTI(settings_get_stats(&after), ==, 0);
+    BTASSERTI(after.number_of_nvm_writes, ==, before.number_of_nvm_writes);
+
+    /* Read back from the shadow before the commit. */
+    int32 = 0;
+    BTASSERTI(setting_int32_read(&int32), ==, 0);
+    BTASSERTI(int32, ==, 12);
+    BTASSERTI(nvm_read(&int32, SETTING_INT32_ADDR, 4), ==, 4);
+    BTASSERTI(int32, ==, 10);
+
+    BTASSERTI(settings_commit(), ==, 0);
+
+    BTASSERTI(settings_get_stats(&after), ==, 0);
+    BTASSERTI(after.number_of_writes, ==, before.number_of_writes + 8);
+    BTASSERTI(after.number_of_nvm_writes,
+              ==,
+              before.number_of_nvm_writes + 1);
+    BTASSERTI(after.number_of_coalesced_writes,
+              ==,
+              before.number_of_coalesced_writes + 6);
+
+    /* All values are in NVM. */
+    BTASSERTI(nvm_read(&int32, SETTING_INT32_ADDR, 4), ==, 4);
+    BTASSERTI(int32, ==, 12);
+    BTASSERTI(nvm_read(&buf[0], SETTING_STRING_ADDR, 2), ==, 2);
+    BTASSERTM(&buf[0], "s", 2);
+
+    for (i = 0; i < 4; i++) {
+        BTASSERTI(nvm_read(&byte, 0x40 + 8 * i, 1), ==, 1);
+        BTASSERTI(byte, ==, 0x10 + i);
+    }
+
+    /* Commit without a batch. */
+    BTASSERTI(settings_commit(), ==, -EINVAL);
+
+    /* Restore the values used by later test cases. */
+    int32 = 10;
+    BTASSERTI(setting_int32_write(int32), ==, 0);
+    BTASSERTI(setting_string_write("t"), ==, 0);
+
+    BTASSERTI(settings_get_stats(&after), ==, 0);
+    std_printf(OSTR("writes: %lu, nvm writes: %lu, unchanged: %lu, "
+                    "coalesced: %lu\r\n"),
+               (unsigned long)after.number_of_writes,
+               (unsigned long)after.number_of_nvm_writes,
+               (unsigned long)after.number_of_unchanged_writes,
+               (unsigned long)after.number_of_coalesced_writes);
+
+    return (0);
+#else
+    return (1);
+#endif
+}
+
 static int test_cmd_list_after_updates(void)
 {
 #if CONFIG_SETTINGS_FS_COMMAND_LIST == 1
@@ -415,6 +538,8 @@ int main()
         { test_setting_string_read_write, "test_setting_string_read_write" },
         { test_setting_blob_read_write, "test_setting_blob_read_write" },
         { test_read_write_by_name, "test_read_write_by_name" },
+        { test_get_setting_by_name, "test_get_setting_by_name" },
+        { test_shadow, "test_shadow" },
         { test_cmd_list_after_updates, "test_cmd_list_after_updates" },
         { NULL, NULL }
     };
@@ -328,3 +328,103 @@ ssize_t __attribute__ ((weak)) STUB(circular_buffer_array_two)(struct circular_b
 
     return (res);
 }
+
+int mock_write_circular_buffer_unused_array(void **buf_pp,
+                                            size_t size,
+                                            ssize_t res)
+{
+    harness_mock_write("circular_buffer_unused_array(): return (buf_pp)",
+                       buf_pp,
+                       size);
+
+    harness_mock_write("circular_buffer_unused_array(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("circular_buffer_unused_array(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(circular_buffer_unused_array)(struct circular_buffer_t *self_p,
+                                                                  void **buf_pp,
+                                                                  size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("circular_buffer_unused_array(): return (buf_pp)",
+                      buf_pp,
+                      size);
+
+    harness_mock_assert("circular_buffer_unused_array(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("circular_buffer_unused_array(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_circular_buffer_skip_back(size_t size,
+                                         ssize_t res)
+{
+    harness_mock_write("circular_buffer_skip_back(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("circular_buffer_skip_back(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(circular_buffer_skip_back)(struct circular_buffer_t *self_p,
+                                                               size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("circular_buffer_skip_back(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("circular_buffer_skip_back(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_circular_buffer_find(char value,
+                                    ssize_t res)
+{
+    harness_mock_write("circular_buffer_find(value)",
+                       &value,
+                       sizeof(value));
+
+    harness_mock_write("circular_buffer_find(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(circular_buffer_find)(struct circular_buffer_t *self_p,
+                                                          char value)
+{
+    ssize_t res;
+
+    harness_mock_assert("circular_buffer_find(value)",
+                        &value,
+                        sizeof(value));
+
+    harness_mock_read("circular_buffer_find(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -61,4 +61,14 @@ int mock_write_circular_buffer_array_two(void **buf_pp,
                                          size_t size,
                                          ssize_t res);
 
+int mock_write_circular_buffer_unused_array(void **buf_pp,
+                                            size_t size,
+                                            ssize_t res);
+
+int mock_write_circular_buffer_skip_back(size_t size,
+                                         ssize_t res);
+
+int mock_write_circular_buffer_find(char value,
+                                    ssize_t res);
+
 #endif
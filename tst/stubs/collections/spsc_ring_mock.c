@@ -0,0 +1,330 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "spsc_ring_mock.h"
+
+int mock_write_spsc_ring_init(void *buf_p,
+                              size_t size,
+                              int res)
+{
+    harness_mock_write("spsc_ring_init(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("spsc_ring_init(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(spsc_ring_init)(struct spsc_ring_t *self_p,
+                                                void *buf_p,
+                                                size_t size)
+{
+    int res;
+
+    harness_mock_assert("spsc_ring_init(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("spsc_ring_init(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_write(const void *buf_p,
+                               size_t size,
+                               ssize_t res)
+{
+    harness_mock_write("spsc_ring_write(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("spsc_ring_write(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_write(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_write)(struct spsc_ring_t *self_p,
+                                                     const void *buf_p,
+                                                     size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("spsc_ring_write(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("spsc_ring_write(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_write(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_read(void *buf_p,
+                              size_t size,
+                              ssize_t res)
+{
+    harness_mock_write("spsc_ring_read(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("spsc_ring_read(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_read(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_read)(struct spsc_ring_t *self_p,
+                                                    void *buf_p,
+                                                    size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("spsc_ring_read(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("spsc_ring_read(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_read(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_used_size(ssize_t res)
+{
+    harness_mock_write("spsc_ring_used_size(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_used_size)(struct spsc_ring_t *self_p)
+{
+    ssize_t res;
+
+    harness_mock_read("spsc_ring_used_size(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_unused_size(ssize_t res)
+{
+    harness_mock_write("spsc_ring_unused_size(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_unused_size)(struct spsc_ring_t *self_p)
+{
+    ssize_t res;
+
+    harness_mock_read("spsc_ring_unused_size(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_array_one(void **buf_pp,
+                                   size_t size,
+                                   ssize_t res)
+{
+    harness_mock_write("spsc_ring_array_one(): return (buf_pp)",
+                       buf_pp,
+                       size);
+
+    harness_mock_write("spsc_ring_array_one(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_array_one(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_array_one)(struct spsc_ring_t *self_p,
+                                                         void **buf_pp,
+                                                         size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("spsc_ring_array_one(): return (buf_pp)",
+                      buf_pp,
+                      size);
+
+    harness_mock_assert("spsc_ring_array_one(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_array_one(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_skip_front(size_t size,
+                                    ssize_t res)
+{
+    harness_mock_write("spsc_ring_skip_front(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_skip_front(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_skip_front)(struct spsc_ring_t *self_p,
+                                                          size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("spsc_ring_skip_front(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_skip_front(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_unused_array(void **buf_pp,
+                                      size_t size,
+                                      ssize_t res)
+{
+    harness_mock_write("spsc_ring_unused_array(): return (buf_pp)",
+                       buf_pp,
+                       size);
+
+    harness_mock_write("spsc_ring_unused_array(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_unused_array(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_unused_array)(struct spsc_ring_t *self_p,
+                                                            void **buf_pp,
+                                                            size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("spsc_ring_unused_array(): return (buf_pp)",
+                      buf_pp,
+                      size);
+
+    harness_mock_assert("spsc_ring_unused_array(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_unused_array(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_spsc_ring_skip_back(size_t size,
+                                   ssize_t res)
+{
+    harness_mock_write("spsc_ring_skip_back(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("spsc_ring_skip_back(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(spsc_ring_skip_back)(struct spsc_ring_t *self_p,
+                                                         size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("spsc_ring_skip_back(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("spsc_ring_skip_back(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
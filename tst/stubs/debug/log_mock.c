@@ -247,6 +247,175 @@ int __attribute__ ((weak)) STUB(log_handler_init)(struct log_handler_t *self_p,
     return (res);
 }
 
+int mock_write_log_async_init(void *chout_p,
+                              struct log_async_entry_t *entries_p,
+                              size_t length,
+                              int policy,
+                              far_string_t dropped_path_p,
+                              int res)
+{
+    harness_mock_write("log_async_init(chout_p)",
+                       chout_p,
+                       sizeof(chout_p));
+
+    harness_mock_write("log_async_init(entries_p)",
+                       entries_p,
+                       sizeof(*entries_p));
+
+    harness_mock_write("log_async_init(length)",
+                       &length,
+                       sizeof(length));
+
+    harness_mock_write("log_async_init(policy)",
+                       &policy,
+                       sizeof(policy));
+
+    harness_mock_write("log_async_init(dropped_path_p)",
+                       &dropped_path_p,
+                       sizeof(dropped_path_p));
+
+    harness_mock_write("log_async_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_async_init)(struct log_async_t *self_p,
+                                                void *chout_p,
+                                                struct log_async_entry_t *entries_p,
+                                                size_t length,
+                                                int policy,
+                                                far_string_t dropped_path_p)
+{
+    int res;
+
+    harness_mock_assert("log_async_init(chout_p)",
+                        chout_p,
+                        sizeof(*chout_p));
+
+    harness_mock_assert("log_async_init(entries_p)",
+                        entries_p,
+                        sizeof(*entries_p));
+
+    harness_mock_assert("log_async_init(length)",
+                        &length,
+                        sizeof(length));
+
+    harness_mock_assert("log_async_init(policy)",
+                        &policy,
+                        sizeof(policy));
+
+    harness_mock_assert("log_async_init(dropped_path_p)",
+                        &dropped_path_p,
+                        sizeof(dropped_path_p));
+
+    harness_mock_read("log_async_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_async_drain(ssize_t res)
+{
+    harness_mock_write("log_async_drain(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(log_async_drain)(struct log_async_t *self_p)
+{
+    ssize_t res;
+
+    harness_mock_read("log_async_drain(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_async_get_dropped(uint64_t res)
+{
+    harness_mock_write("log_async_get_dropped(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+uint64_t __attribute__ ((weak)) STUB(log_async_get_dropped)(struct log_async_t *self_p)
+{
+    uint64_t res;
+
+    harness_mock_read("log_async_get_dropped(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_async_main(void *arg_p,
+                              void *res)
+{
+    harness_mock_write("log_async_main(arg_p)",
+                       arg_p,
+                       sizeof(arg_p));
+
+    harness_mock_write("log_async_main(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(log_async_main)(void *arg_p)
+{
+    void *res;
+
+    harness_mock_assert("log_async_main(arg_p)",
+                        arg_p,
+                        sizeof(*arg_p));
+
+    harness_mock_read("log_async_main(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_handler_init_async(struct log_async_t *async_p,
+                                      int res)
+{
+    harness_mock_write("log_handler_init_async(async_p)",
+                       async_p,
+                       sizeof(*async_p));
+
+    harness_mock_write("log_handler_init_async(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_handler_init_async)(struct log_handler_t *self_p,
+                                                        struct log_async_t *async_p)
+{
+    int res;
+
+    harness_mock_assert("log_handler_init_async(async_p)",
+                        async_p,
+                        sizeof(*async_p));
+
+    harness_mock_read("log_handler_init_async(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_log_add_handler(struct log_handler_t *handler_p,
                                int res)
 {
@@ -391,3 +560,149 @@ int __attribute__ ((weak)) STUB(log_set_default_handler_output_channel)(void *ch
 
     return (res);
 }
+
+int mock_write_log_binary_buffer_init(void *buf_p,
+                                      size_t size,
+                                      int res)
+{
+    harness_mock_write("log_binary_buffer_init(buf_p)",
+                       buf_p,
+                       size);
+
+    harness_mock_write("log_binary_buffer_init(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("log_binary_buffer_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_binary_buffer_init)(struct log_binary_buffer_t *self_p,
+                                                        void *buf_p,
+                                                        size_t size)
+{
+    int res;
+
+    harness_mock_assert("log_binary_buffer_init(buf_p)",
+                        buf_p,
+                        size);
+
+    harness_mock_assert("log_binary_buffer_init(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("log_binary_buffer_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_binary_buffer_deinit(int res)
+{
+    harness_mock_write("log_binary_buffer_deinit(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_binary_buffer_deinit)(struct log_binary_buffer_t *self_p)
+{
+    int res;
+
+    harness_mock_read("log_binary_buffer_deinit(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_binary_set_output_channel(void *chout_p,
+                                             int res)
+{
+    harness_mock_write("log_binary_set_output_channel(chout_p)",
+                       chout_p,
+                       sizeof(chout_p));
+
+    harness_mock_write("log_binary_set_output_channel(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(log_binary_set_output_channel)(void *chout_p)
+{
+    int res;
+
+    harness_mock_assert("log_binary_set_output_channel(chout_p)",
+                        chout_p,
+                        sizeof(*chout_p));
+
+    harness_mock_read("log_binary_set_output_channel(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_binary_drain(ssize_t res)
+{
+    harness_mock_write("log_binary_drain()",
+                       NULL,
+                       0);
+
+    harness_mock_write("log_binary_drain(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(log_binary_drain)()
+{
+    ssize_t res;
+
+    harness_mock_assert("log_binary_drain()",
+                        NULL,
+                        0);
+
+    harness_mock_read("log_binary_drain(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_log_binary_main(void *arg_p,
+                               void *res)
+{
+    harness_mock_write("log_binary_main(arg_p)",
+                       arg_p,
+                       sizeof(arg_p));
+
+    harness_mock_write("log_binary_main(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(log_binary_main)(void *arg_p)
+{
+    void *res;
+
+    harness_mock_assert("log_binary_main(arg_p)",
+                        arg_p,
+                        sizeof(*arg_p));
+
+    harness_mock_read("log_binary_main(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
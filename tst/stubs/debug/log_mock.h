@@ -52,6 +52,23 @@ int mock_write_log_object_print(int level,
 int mock_write_log_handler_init(void *chout_p,
                                 int res);
 
+int mock_write_log_async_init(void *chout_p,
+                              struct log_async_entry_t *entries_p,
+                              size_t length,
+                              int policy,
+                              far_string_t dropped_path_p,
+                              int res);
+
+int mock_write_log_async_drain(ssize_t res);
+
+int mock_write_log_async_get_dropped(uint64_t res);
+
+int mock_write_log_async_main(void *arg_p,
+                              void *res);
+
+int mock_write_log_handler_init_async(struct log_async_t *async_p,
+                                      int res);
+
 int mock_write_log_add_handler(struct log_handler_t *handler_p,
                                int res);
 
@@ -67,4 +84,18 @@ int mock_write_log_remove_object(struct log_object_t *object_p,
 int mock_write_log_set_default_handler_output_channel(void *chout_p,
                                                       int res);
 
+int mock_write_log_binary_buffer_init(void *buf_p,
+                                      size_t size,
+                                      int res);
+
+int mock_write_log_binary_buffer_deinit(int res);
+
+int mock_write_log_binary_set_output_channel(void *chout_p,
+                                             int res);
+
+int mock_write_log_binary_drain(ssize_t res);
+
+int mock_write_log_binary_main(void *arg_p,
+                               void *res);
+
 #endif
@@ -126,3 +126,193 @@ int __attribute__ ((weak)) STUB(base64_decode)(void *dst_p,
 
     return (res);
 }
+
+int mock_write_base64_encoder_init(int res)
+{
+    harness_mock_write("base64_encoder_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(base64_encoder_init)(struct base64_encoder_t *self_p)
+{
+    int res;
+
+    harness_mock_read("base64_encoder_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_base64_encoder_update(char *dst_p,
+                                     const void *src_p,
+                                     size_t size,
+                                     ssize_t res)
+{
+    harness_mock_write("base64_encoder_update(): return (dst_p)",
+                       dst_p,
+                       strlen(dst_p) + 1);
+
+    harness_mock_write("base64_encoder_update(src_p)",
+                       src_p,
+                       size);
+
+    harness_mock_write("base64_encoder_update(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("base64_encoder_update(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(base64_encoder_update)(struct base64_encoder_t *self_p,
+                                                           char *dst_p,
+                                                           const void *src_p,
+                                                           size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("base64_encoder_update(): return (dst_p)",
+                      dst_p,
+                      sizeof(*dst_p));
+
+    harness_mock_assert("base64_encoder_update(src_p)",
+                        src_p,
+                        size);
+
+    harness_mock_assert("base64_encoder_update(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("base64_encoder_update(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_base64_encoder_finalize(char *dst_p,
+                                       ssize_t res)
+{
+    harness_mock_write("base64_encoder_finalize(): return (dst_p)",
+                       dst_p,
+                       strlen(dst_p) + 1);
+
+    harness_mock_write("base64_encoder_finalize(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(base64_encoder_finalize)(struct base64_encoder_t *self_p,
+                                                             char *dst_p)
+{
+    ssize_t res;
+
+    harness_mock_read("base64_encoder_finalize(): return (dst_p)",
+                      dst_p,
+                      sizeof(*dst_p));
+
+    harness_mock_read("base64_encoder_finalize(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_base64_decoder_init(int res)
+{
+    harness_mock_write("base64_decoder_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(base64_decoder_init)(struct base64_decoder_t *self_p)
+{
+    int res;
+
+    harness_mock_read("base64_decoder_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_base64_decoder_update(void *dst_p,
+                                     const char *src_p,
+                                     size_t size,
+                                     ssize_t res)
+{
+    harness_mock_write("base64_decoder_update(): return (dst_p)",
+                       dst_p,
+                       size);
+
+    harness_mock_write("base64_decoder_update(src_p)",
+                       src_p,
+                       strlen(src_p) + 1);
+
+    harness_mock_write("base64_decoder_update(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("base64_decoder_update(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(base64_decoder_update)(struct base64_decoder_t *self_p,
+                                                           void *dst_p,
+                                                           const char *src_p,
+                                                           size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("base64_decoder_update(): return (dst_p)",
+                      dst_p,
+                      size);
+
+    harness_mock_assert("base64_decoder_update(src_p)",
+                        src_p,
+                        sizeof(*src_p));
+
+    harness_mock_assert("base64_decoder_update(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("base64_decoder_update(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_base64_decoder_finalize(int res)
+{
+    harness_mock_write("base64_decoder_finalize(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(base64_decoder_finalize)(struct base64_decoder_t *self_p)
+{
+    int res;
+
+    harness_mock_read("base64_decoder_finalize(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -41,4 +41,23 @@ int mock_write_base64_decode(void *dst_p,
                              size_t size,
                              int res);
 
+int mock_write_base64_encoder_init(int res);
+
+int mock_write_base64_encoder_update(char *dst_p,
+                                     const void *src_p,
+                                     size_t size,
+                                     ssize_t res);
+
+int mock_write_base64_encoder_finalize(char *dst_p,
+                                       ssize_t res);
+
+int mock_write_base64_decoder_init(int res);
+
+int mock_write_base64_decoder_update(void *dst_p,
+                                     const char *src_p,
+                                     size_t size,
+                                     ssize_t res);
+
+int mock_write_base64_decoder_finalize(int res);
+
 #endif
@@ -0,0 +1,310 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "task_mock.h"
+
+int mock_write_task_executor_init(struct chan_list_elem_t *elements_p,
+                                  size_t number_of_elements,
+                                  const char *name_p,
+                                  int prio,
+                                  void *stack_p,
+                                  size_t stack_size,
+                                  int res)
+{
+    harness_mock_write("task_executor_init(elements_p)",
+                       elements_p,
+                       sizeof(*elements_p));
+
+    harness_mock_write("task_executor_init(number_of_elements)",
+                       &number_of_elements,
+                       sizeof(number_of_elements));
+
+    harness_mock_write("task_executor_init(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("task_executor_init(prio)",
+                       &prio,
+                       sizeof(prio));
+
+    harness_mock_write("task_executor_init(stack_p)",
+                       stack_p,
+                       sizeof(stack_p));
+
+    harness_mock_write("task_executor_init(stack_size)",
+                       &stack_size,
+                       sizeof(stack_size));
+
+    harness_mock_write("task_executor_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_executor_init)(struct task_executor_t *self_p,
+                                                    struct chan_list_elem_t *elements_p,
+                                                    size_t number_of_elements,
+                                                    const char *name_p,
+                                                    int prio,
+                                                    void *stack_p,
+                                                    size_t stack_size)
+{
+    int res;
+
+    harness_mock_assert("task_executor_init(elements_p)",
+                        elements_p,
+                        sizeof(*elements_p));
+
+    harness_mock_assert("task_executor_init(number_of_elements)",
+                        &number_of_elements,
+                        sizeof(number_of_elements));
+
+    harness_mock_assert("task_executor_init(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_assert("task_executor_init(prio)",
+                        &prio,
+                        sizeof(prio));
+
+    harness_mock_assert("task_executor_init(stack_p)",
+                        stack_p,
+                        sizeof(*stack_p));
+
+    harness_mock_assert("task_executor_init(stack_size)",
+                        &stack_size,
+                        sizeof(stack_size));
+
+    harness_mock_read("task_executor_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_task_executor_start(int res)
+{
+    harness_mock_write("task_executor_start(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_executor_start)(struct task_executor_t *self_p)
+{
+    int res;
+
+    harness_mock_read("task_executor_start(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_task_init(task_fn_t fn,
+                         void *arg_p,
+                         int res)
+{
+    harness_mock_write("task_init(fn)",
+                       &fn,
+                       sizeof(fn));
+
+    harness_mock_write("task_init(arg_p)",
+                       arg_p,
+                       sizeof(arg_p));
+
+    harness_mock_write("task_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_init)(struct task_t *self_p,
+                                           task_fn_t fn,
+                                           void *arg_p)
+{
+    int res;
+
+    harness_mock_assert("task_init(fn)",
+                        &fn,
+                        sizeof(fn));
+
+    harness_mock_assert("task_init(arg_p)",
+                        arg_p,
+                        sizeof(*arg_p));
+
+    harness_mock_read("task_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_task_spawn(struct task_executor_t *executor_p,
+                          int res)
+{
+    harness_mock_write("task_spawn(executor_p)",
+                       executor_p,
+                       sizeof(*executor_p));
+
+    harness_mock_write("task_spawn(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_spawn)(struct task_t *self_p,
+                                            struct task_executor_t *executor_p)
+{
+    int res;
+
+    harness_mock_assert("task_spawn(executor_p)",
+                        executor_p,
+                        sizeof(*executor_p));
+
+    harness_mock_read("task_spawn(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_task_is_done(int res)
+{
+    harness_mock_write("task_is_done(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_is_done)(struct task_t *self_p)
+{
+    int res;
+
+    harness_mock_read("task_is_done(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_task_await_chan(void *chan_p,
+                               const struct time_t *timeout_p,
+                               int res)
+{
+    harness_mock_write("task_await_chan(chan_p)",
+                       chan_p,
+                       sizeof(chan_p));
+
+    harness_mock_write("task_await_chan(timeout_p)",
+                       timeout_p,
+                       sizeof(*timeout_p));
+
+    harness_mock_write("task_await_chan(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_await_chan)(struct task_t *self_p,
+                                                 void *chan_p,
+                                                 const struct time_t *timeout_p)
+{
+    int res;
+
+    harness_mock_assert("task_await_chan(chan_p)",
+                        chan_p,
+                        sizeof(*chan_p));
+
+    harness_mock_assert("task_await_chan(timeout_p)",
+                        timeout_p,
+                        sizeof(*timeout_p));
+
+    harness_mock_read("task_await_chan(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_task_await_event(struct event_t *event_p,
+                                uint32_t *mask_p,
+                                const struct time_t *timeout_p,
+                                int res)
+{
+    harness_mock_write("task_await_event(event_p)",
+                       event_p,
+                       sizeof(*event_p));
+
+    harness_mock_write("task_await_event(): return (mask_p)",
+                       mask_p,
+                       sizeof(*mask_p));
+
+    harness_mock_write("task_await_event(timeout_p)",
+                       timeout_p,
+                       sizeof(*timeout_p));
+
+    harness_mock_write("task_await_event(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(task_await_event)(struct task_t *self_p,
+                                                  struct event_t *event_p,
+                                                  uint32_t *mask_p,
+                                                  const struct time_t *timeout_p)
+{
+    int res;
+
+    harness_mock_assert("task_await_event(event_p)",
+                        event_p,
+                        sizeof(*event_p));
+
+    harness_mock_read("task_await_event(): return (mask_p)",
+                      mask_p,
+                      sizeof(*mask_p));
+
+    harness_mock_assert("task_await_event(timeout_p)",
+                        timeout_p,
+                        sizeof(*timeout_p));
+
+    harness_mock_read("task_await_event(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
@@ -0,0 +1,62 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __TASK_MOCK_H__
+#define __TASK_MOCK_H__
+
+#include "simba.h"
+
+int mock_write_task_executor_init(struct chan_list_elem_t *elements_p,
+                                  size_t number_of_elements,
+                                  const char *name_p,
+                                  int prio,
+                                  void *stack_p,
+                                  size_t stack_size,
+                                  int res);
+
+int mock_write_task_executor_start(int res);
+
+int mock_write_task_init(task_fn_t fn,
+                         void *arg_p,
+                         int res);
+
+int mock_write_task_spawn(struct task_executor_t *executor_p,
+                          int res);
+
+int mock_write_task_is_done(int res);
+
+int mock_write_task_await_chan(void *chan_p,
+                               const struct time_t *timeout_p,
+                               int res);
+
+int mock_write_task_await_event(struct event_t *event_p,
+                                uint32_t *mask_p,
+                                const struct time_t *timeout_p,
+                                int res);
+
+#endif
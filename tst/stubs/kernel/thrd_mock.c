@@ -251,6 +251,35 @@ int __attribute__ ((weak)) STUB(thrd_join)(struct thrd_t *thrd_p)
     return (res);
 }
 
+int mock_write_thrd_terminate(struct thrd_t *thrd_p,
+                              int res)
+{
+    harness_mock_write("thrd_terminate(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("thrd_terminate(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_terminate)(struct thrd_t *thrd_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_terminate(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_read("thrd_terminate(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_thrd_sleep(float seconds,
                           int res)
 {
@@ -558,6 +587,45 @@ int __attribute__ ((weak)) STUB(thrd_set_prio)(struct thrd_t *thrd_p,
     return (res);
 }
 
+int mock_write_thrd_set_prio_isr(struct thrd_t *thrd_p,
+                                 int prio,
+                                 int res)
+{
+    harness_mock_write("thrd_set_prio_isr(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("thrd_set_prio_isr(prio)",
+                       &prio,
+                       sizeof(prio));
+
+    harness_mock_write("thrd_set_prio_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_set_prio_isr)(struct thrd_t *thrd_p,
+                                                   int prio)
+{
+    int res;
+
+    harness_mock_assert("thrd_set_prio_isr(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_assert("thrd_set_prio_isr(prio)",
+                        &prio,
+                        sizeof(prio));
+
+    harness_mock_read("thrd_set_prio_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_thrd_get_prio(int res)
 {
     harness_mock_write("thrd_get_prio()",
@@ -1098,3 +1166,220 @@ int __attribute__ ((weak)) STUB(thrd_prio_list_remove_isr)(struct thrd_prio_list
 
     return (res);
 }
+
+int mock_write_thrd_contention_init(const char *type_p,
+                                    const char *name_p,
+                                    int res)
+{
+    harness_mock_write("thrd_contention_init(type_p)",
+                       type_p,
+                       strlen(type_p) + 1);
+
+    harness_mock_write("thrd_contention_init(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("thrd_contention_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_contention_init)(struct thrd_contention_t *self_p,
+                                                      const char *type_p,
+                                                      const char *name_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_contention_init(type_p)",
+                        type_p,
+                        sizeof(*type_p));
+
+    harness_mock_assert("thrd_contention_init(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_read("thrd_contention_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_contention_wait_begin_isr(uint32_t res)
+{
+    harness_mock_write("thrd_contention_wait_begin_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+uint32_t __attribute__ ((weak)) STUB(thrd_contention_wait_begin_isr)(struct thrd_contention_t *self_p)
+{
+    uint32_t res;
+
+    harness_mock_read("thrd_contention_wait_begin_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_contention_wait_end_isr(uint32_t start_us)
+{
+    harness_mock_write("thrd_contention_wait_end_isr(start_us)",
+                       &start_us,
+                       sizeof(start_us));
+
+    return (0);
+}
+
+void __attribute__ ((weak)) STUB(thrd_contention_wait_end_isr)(struct thrd_contention_t *self_p,
+                                                               uint32_t start_us)
+{
+    harness_mock_assert("thrd_contention_wait_end_isr(start_us)",
+                        &start_us,
+                        sizeof(start_us));
+}
+
+int mock_write_thrd_contention_hold_begin_isr()
+{
+    return (0);
+}
+
+void __attribute__ ((weak)) STUB(thrd_contention_hold_begin_isr)(struct thrd_contention_t *self_p)
+{
+}
+
+int mock_write_thrd_contention_hold_end_isr()
+{
+    return (0);
+}
+
+void __attribute__ ((weak)) STUB(thrd_contention_hold_end_isr)(struct thrd_contention_t *self_p)
+{
+}
+
+int mock_write_thrd_trace_write_isr(int type,
+                                    struct thrd_t *thrd_p,
+                                    uintptr_t arg)
+{
+    harness_mock_write("thrd_trace_write_isr(type)",
+                       &type,
+                       sizeof(type));
+
+    harness_mock_write("thrd_trace_write_isr(thrd_p)",
+                       thrd_p,
+                       sizeof(*thrd_p));
+
+    harness_mock_write("thrd_trace_write_isr(arg)",
+                       &arg,
+                       sizeof(arg));
+
+    return (0);
+}
+
+void __attribute__ ((weak)) STUB(thrd_trace_write_isr)(int type,
+                                                       struct thrd_t *thrd_p,
+                                                       uintptr_t arg)
+{
+    harness_mock_assert("thrd_trace_write_isr(type)",
+                        &type,
+                        sizeof(type));
+
+    harness_mock_assert("thrd_trace_write_isr(thrd_p)",
+                        thrd_p,
+                        sizeof(*thrd_p));
+
+    harness_mock_assert("thrd_trace_write_isr(arg)",
+                        &arg,
+                        sizeof(arg));
+}
+
+int mock_write_thrd_trace_marker(const char *name_p,
+                                 int res)
+{
+    harness_mock_write("thrd_trace_marker(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("thrd_trace_marker(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_marker)(const char *name_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_marker(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_read("thrd_trace_marker(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_clear(int res)
+{
+    harness_mock_write("thrd_trace_clear()",
+                       NULL,
+                       0);
+
+    harness_mock_write("thrd_trace_clear(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_clear)()
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_clear()",
+                        NULL,
+                        0);
+
+    harness_mock_read("thrd_trace_clear(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_trace_dump(void *chan_p,
+                               int res)
+{
+    harness_mock_write("thrd_trace_dump(chan_p)",
+                       chan_p,
+                       sizeof(chan_p));
+
+    harness_mock_write("thrd_trace_dump(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_trace_dump)(void *chan_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_trace_dump(chan_p)",
+                        chan_p,
+                        sizeof(*chan_p));
+
+    harness_mock_read("thrd_trace_dump(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
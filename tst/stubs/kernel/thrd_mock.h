@@ -52,6 +52,9 @@ int mock_write_thrd_yield(int res);
 int mock_write_thrd_join(struct thrd_t *thrd_p,
                          int res);
 
+int mock_write_thrd_terminate(struct thrd_t *thrd_p,
+                              int res);
+
 int mock_write_thrd_sleep(float seconds,
                           int res);
 
@@ -81,6 +84,10 @@ int mock_write_thrd_set_prio(struct thrd_t *thrd_p,
                              int prio,
                              int res);
 
+int mock_write_thrd_set_prio_isr(struct thrd_t *thrd_p,
+                                 int prio,
+                                 int res);
+
 int mock_write_thrd_get_prio(int res);
 
 int mock_write_thrd_init_global_env(struct thrd_environment_variable_t *variables_p,
@@ -135,4 +142,28 @@ int mock_write_thrd_prio_list_pop_isr(struct thrd_prio_list_elem_t *res);
 int mock_write_thrd_prio_list_remove_isr(struct thrd_prio_list_elem_t *elem_p,
                                          int res);
 
+int mock_write_thrd_contention_init(const char *type_p,
+                                    const char *name_p,
+                                    int res);
+
+int mock_write_thrd_contention_wait_begin_isr(uint32_t res);
+
+int mock_write_thrd_contention_wait_end_isr(uint32_t start_us);
+
+int mock_write_thrd_contention_hold_begin_isr();
+
+int mock_write_thrd_contention_hold_end_isr();
+
+int mock_write_thrd_trace_write_isr(int type,
+                                    struct thrd_t *thrd_p,
+                                    uintptr_t arg);
+
+int mock_write_thrd_trace_marker(const char *name_p,
+                                 int res);
+
+int mock_write_thrd_trace_clear(int res);
+
+int mock_write_thrd_trace_dump(void *chan_p,
+                               int res);
+
 #endif
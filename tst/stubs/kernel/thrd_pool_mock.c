@@ -0,0 +1,277 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+#include "thrd_pool_mock.h"
+
+int mock_write_thrd_pool_module_init(int res)
+{
+    harness_mock_write("thrd_pool_module_init()",
+                       NULL,
+                       0);
+
+    harness_mock_write("thrd_pool_module_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_pool_module_init)()
+{
+    int res;
+
+    harness_mock_assert("thrd_pool_module_init()",
+                        NULL,
+                        0);
+
+    harness_mock_read("thrd_pool_module_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_pool_init(struct thrd_pool_worker_t *workers_p,
+                              int number_of_workers,
+                              int prio,
+                              void *stacks_p,
+                              size_t stack_size,
+                              int res)
+{
+    harness_mock_write("thrd_pool_init(workers_p)",
+                       workers_p,
+                       sizeof(*workers_p));
+
+    harness_mock_write("thrd_pool_init(number_of_workers)",
+                       &number_of_workers,
+                       sizeof(number_of_workers));
+
+    harness_mock_write("thrd_pool_init(prio)",
+                       &prio,
+                       sizeof(prio));
+
+    harness_mock_write("thrd_pool_init(stacks_p)",
+                       stacks_p,
+                       sizeof(stacks_p));
+
+    harness_mock_write("thrd_pool_init(stack_size)",
+                       &stack_size,
+                       sizeof(stack_size));
+
+    harness_mock_write("thrd_pool_init(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_pool_init)(struct thrd_pool_t *self_p,
+                                                struct thrd_pool_worker_t *workers_p,
+                                                int number_of_workers,
+                                                int prio,
+                                                void *stacks_p,
+                                                size_t stack_size)
+{
+    int res;
+
+    harness_mock_assert("thrd_pool_init(workers_p)",
+                        workers_p,
+                        sizeof(*workers_p));
+
+    harness_mock_assert("thrd_pool_init(number_of_workers)",
+                        &number_of_workers,
+                        sizeof(number_of_workers));
+
+    harness_mock_assert("thrd_pool_init(prio)",
+                        &prio,
+                        sizeof(prio));
+
+    harness_mock_assert("thrd_pool_init(stacks_p)",
+                        stacks_p,
+                        sizeof(*stacks_p));
+
+    harness_mock_assert("thrd_pool_init(stack_size)",
+                        &stack_size,
+                        sizeof(stack_size));
+
+    harness_mock_read("thrd_pool_init(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_pool_start(int res)
+{
+    harness_mock_write("thrd_pool_start(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_pool_start)(struct thrd_pool_t *self_p)
+{
+    int res;
+
+    harness_mock_read("thrd_pool_start(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_pool_stop(int res)
+{
+    harness_mock_write("thrd_pool_stop(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_pool_stop)(struct thrd_pool_t *self_p)
+{
+    int res;
+
+    harness_mock_read("thrd_pool_stop(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_pool_submit(struct thrd_pool_future_t *future_p,
+                                thrd_pool_fn_t fn,
+                                void *arg_p,
+                                int res)
+{
+    harness_mock_write("thrd_pool_submit(): return (future_p)",
+                       future_p,
+                       sizeof(*future_p));
+
+    harness_mock_write("thrd_pool_submit(fn)",
+                       &fn,
+                       sizeof(fn));
+
+    harness_mock_write("thrd_pool_submit(arg_p)",
+                       arg_p,
+                       sizeof(arg_p));
+
+    harness_mock_write("thrd_pool_submit(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_pool_submit)(struct thrd_pool_t *self_p,
+                                                  struct thrd_pool_future_t *future_p,
+                                                  thrd_pool_fn_t fn,
+                                                  void *arg_p)
+{
+    int res;
+
+    harness_mock_read("thrd_pool_submit(): return (future_p)",
+                      future_p,
+                      sizeof(*future_p));
+
+    harness_mock_assert("thrd_pool_submit(fn)",
+                        &fn,
+                        sizeof(fn));
+
+    harness_mock_assert("thrd_pool_submit(arg_p)",
+                        arg_p,
+                        sizeof(*arg_p));
+
+    harness_mock_read("thrd_pool_submit(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_pool_wait(struct thrd_pool_future_t *future_p,
+                              void *res)
+{
+    harness_mock_write("thrd_pool_wait(future_p)",
+                       future_p,
+                       sizeof(*future_p));
+
+    harness_mock_write("thrd_pool_wait(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+void *__attribute__ ((weak)) STUB(thrd_pool_wait)(struct thrd_pool_t *self_p,
+                                                  struct thrd_pool_future_t *future_p)
+{
+    void *res;
+
+    harness_mock_assert("thrd_pool_wait(future_p)",
+                        future_p,
+                        sizeof(*future_p));
+
+    harness_mock_read("thrd_pool_wait(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_thrd_pool_is_done(struct thrd_pool_future_t *future_p,
+                                 int res)
+{
+    harness_mock_write("thrd_pool_is_done(future_p)",
+                       future_p,
+                       sizeof(*future_p));
+
+    harness_mock_write("thrd_pool_is_done(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(thrd_pool_is_done)(struct thrd_pool_future_t *future_p)
+{
+    int res;
+
+    harness_mock_assert("thrd_pool_is_done(future_p)",
+                        future_p,
+                        sizeof(*future_p));
+
+    harness_mock_read("thrd_pool_is_done(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
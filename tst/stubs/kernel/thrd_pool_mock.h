@@ -0,0 +1,58 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#ifndef __THRD_POOL_MOCK_H__
+#define __THRD_POOL_MOCK_H__
+
+#include "simba.h"
+
+int mock_write_thrd_pool_module_init(int res);
+
+int mock_write_thrd_pool_init(struct thrd_pool_worker_t *workers_p,
+                              int number_of_workers,
+                              int prio,
+                              void *stacks_p,
+                              size_t stack_size,
+                              int res);
+
+int mock_write_thrd_pool_start(int res);
+
+int mock_write_thrd_pool_stop(int res);
+
+int mock_write_thrd_pool_submit(struct thrd_pool_future_t *future_p,
+                                thrd_pool_fn_t fn,
+                                void *arg_p,
+                                int res);
+
+int mock_write_thrd_pool_wait(struct thrd_pool_future_t *future_p,
+                              void *res);
+
+int mock_write_thrd_pool_is_done(struct thrd_pool_future_t *future_p,
+                                 int res);
+
+#endif
@@ -77,6 +77,46 @@ int __attribute__ ((weak)) STUB(bus_init)(struct bus_t *self_p)
     return (res);
 }
 
+int mock_write_bus_init_hash(struct bus_listener_t **buckets_pp,
+                             int length,
+                             int res)
+{
+    harness_mock_write("bus_init_hash(buckets_pp)",
+                       buckets_pp,
+                       sizeof(*buckets_pp));
+
+    harness_mock_write("bus_init_hash(length)",
+                       &length,
+                       sizeof(length));
+
+    harness_mock_write("bus_init_hash(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(bus_init_hash)(struct bus_t *self_p,
+                                               struct bus_listener_t **buckets_pp,
+                                               int length)
+{
+    int res;
+
+    harness_mock_assert("bus_init_hash(buckets_pp)",
+                        buckets_pp,
+                        sizeof(*buckets_pp));
+
+    harness_mock_assert("bus_init_hash(length)",
+                        &length,
+                        sizeof(length));
+
+    harness_mock_read("bus_init_hash(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_bus_listener_init(int id,
                                  void *chan_p,
                                  int res)
@@ -226,3 +266,53 @@ int __attribute__ ((weak)) STUB(bus_write)(struct bus_t *self_p,
 
     return (res);
 }
+
+int mock_write_bus_write_zero_copy(int id,
+                                   struct heap_t *heap_p,
+                                   void *buf_p,
+                                   int res)
+{
+    harness_mock_write("bus_write_zero_copy(id)",
+                       &id,
+                       sizeof(id));
+
+    harness_mock_write("bus_write_zero_copy(heap_p)",
+                       heap_p,
+                       sizeof(*heap_p));
+
+    harness_mock_write("bus_write_zero_copy(buf_p)",
+                       buf_p,
+                       sizeof(buf_p));
+
+    harness_mock_write("bus_write_zero_copy(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(bus_write_zero_copy)(struct bus_t *self_p,
+                                                     int id,
+                                                     struct heap_t *heap_p,
+                                                     void *buf_p)
+{
+    int res;
+
+    harness_mock_assert("bus_write_zero_copy(id)",
+                        &id,
+                        sizeof(id));
+
+    harness_mock_assert("bus_write_zero_copy(heap_p)",
+                        heap_p,
+                        sizeof(*heap_p));
+
+    harness_mock_assert("bus_write_zero_copy(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_read("bus_write_zero_copy(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
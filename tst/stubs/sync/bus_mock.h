@@ -35,6 +35,10 @@ int mock_write_bus_module_init(int res);
 
 int mock_write_bus_init(int res);
 
+int mock_write_bus_init_hash(struct bus_listener_t **buckets_pp,
+                             int length,
+                             int res);
+
 int mock_write_bus_listener_init(int id,
                                  void *chan_p,
                                  int res);
@@ -50,4 +54,9 @@ int mock_write_bus_write(int id,
                          size_t size,
                          int res);
 
+int mock_write_bus_write_zero_copy(int id,
+                                   struct heap_t *heap_p,
+                                   void *buf_p,
+                                   int res);
+
 #endif
@@ -77,6 +77,36 @@ int __attribute__ ((weak)) STUB(mutex_init)(struct mutex_t *self_p)
     return (res);
 }
 
+int mock_write_mutex_init_named(const char *name_p,
+                                int res)
+{
+    harness_mock_write("mutex_init_named(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("mutex_init_named(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(mutex_init_named)(struct mutex_t *self_p,
+                                                  const char *name_p)
+{
+    int res;
+
+    harness_mock_assert("mutex_init_named(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_read("mutex_init_named(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_mutex_lock(int res)
 {
     harness_mock_write("mutex_lock(): return (res)",
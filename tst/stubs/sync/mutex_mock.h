@@ -35,6 +35,9 @@ int mock_write_mutex_module_init(int res);
 
 int mock_write_mutex_init(int res);
 
+int mock_write_mutex_init_named(const char *name_p,
+                                int res);
+
 int mock_write_mutex_lock(int res);
 
 int mock_write_mutex_unlock(int res);
@@ -249,6 +249,186 @@ ssize_t __attribute__ ((weak)) STUB(queue_write_isr)(struct queue_t *self_p,
     return (res);
 }
 
+int mock_write_queue_reserve(void **buf_pp,
+                             size_t size,
+                             ssize_t res)
+{
+    harness_mock_write("queue_reserve(): return (buf_pp)",
+                       buf_pp,
+                       size);
+
+    harness_mock_write("queue_reserve(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_reserve(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(queue_reserve)(struct queue_t *self_p,
+                                                   void **buf_pp,
+                                                   size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("queue_reserve(): return (buf_pp)",
+                      buf_pp,
+                      size);
+
+    harness_mock_assert("queue_reserve(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_reserve(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_queue_reserve_isr(void **buf_pp,
+                                 size_t size,
+                                 ssize_t res)
+{
+    harness_mock_write("queue_reserve_isr(): return (buf_pp)",
+                       buf_pp,
+                       size);
+
+    harness_mock_write("queue_reserve_isr(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_reserve_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(queue_reserve_isr)(struct queue_t *self_p,
+                                                       void **buf_pp,
+                                                       size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("queue_reserve_isr(): return (buf_pp)",
+                      buf_pp,
+                      size);
+
+    harness_mock_assert("queue_reserve_isr(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_reserve_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_queue_commit(size_t size,
+                            ssize_t res)
+{
+    harness_mock_write("queue_commit(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_commit(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(queue_commit)(struct queue_t *self_p,
+                                                  size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("queue_commit(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_commit(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_queue_commit_isr(size_t size,
+                                ssize_t res)
+{
+    harness_mock_write("queue_commit_isr(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_commit_isr(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(queue_commit_isr)(struct queue_t *self_p,
+                                                      size_t size)
+{
+    ssize_t res;
+
+    harness_mock_assert("queue_commit_isr(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_commit_isr(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_queue_peek(void **buf_pp,
+                          size_t size,
+                          ssize_t res)
+{
+    harness_mock_write("queue_peek(): return (buf_pp)",
+                       buf_pp,
+                       size);
+
+    harness_mock_write("queue_peek(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("queue_peek(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(queue_peek)(struct queue_t *self_p,
+                                                void **buf_pp,
+                                                size_t size)
+{
+    ssize_t res;
+
+    harness_mock_read("queue_peek(): return (buf_pp)",
+                      buf_pp,
+                      size);
+
+    harness_mock_assert("queue_peek(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_read("queue_peek(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_queue_size(ssize_t res)
 {
     harness_mock_write("queue_size(): return (res)",
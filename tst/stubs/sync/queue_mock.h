@@ -53,6 +53,24 @@ int mock_write_queue_write_isr(const void *buf_p,
                                size_t size,
                                ssize_t res);
 
+int mock_write_queue_reserve(void **buf_pp,
+                             size_t size,
+                             ssize_t res);
+
+int mock_write_queue_reserve_isr(void **buf_pp,
+                                 size_t size,
+                                 ssize_t res);
+
+int mock_write_queue_commit(size_t size,
+                            ssize_t res);
+
+int mock_write_queue_commit_isr(size_t size,
+                                ssize_t res);
+
+int mock_write_queue_peek(void **buf_pp,
+                          size_t size,
+                          ssize_t res);
+
 int mock_write_queue_size(ssize_t res);
 
 int mock_write_queue_unused_size(ssize_t res);
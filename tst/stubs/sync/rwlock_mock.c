@@ -77,6 +77,36 @@ int __attribute__ ((weak)) STUB(rwlock_init)(struct rwlock_t *self_p)
     return (res);
 }
 
+int mock_write_rwlock_init_named(const char *name_p,
+                                 int res)
+{
+    harness_mock_write("rwlock_init_named(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("rwlock_init_named(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(rwlock_init_named)(struct rwlock_t *self_p,
+                                                   const char *name_p)
+{
+    int res;
+
+    harness_mock_assert("rwlock_init_named(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_read("rwlock_init_named(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_rwlock_reader_take(int res)
 {
     harness_mock_write("rwlock_reader_take(): return (res)",
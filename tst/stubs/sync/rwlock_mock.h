@@ -35,6 +35,9 @@ int mock_write_rwlock_module_init(int res);
 
 int mock_write_rwlock_init(int res);
 
+int mock_write_rwlock_init_named(const char *name_p,
+                                 int res);
+
 int mock_write_rwlock_reader_take(int res);
 
 int mock_write_rwlock_reader_give(int res);
@@ -97,6 +97,56 @@ int __attribute__ ((weak)) STUB(sem_init)(struct sem_t *self_p,
     return (res);
 }
 
+int mock_write_sem_init_named(int count,
+                              int count_max,
+                              const char *name_p,
+                              int res)
+{
+    harness_mock_write("sem_init_named(count)",
+                       &count,
+                       sizeof(count));
+
+    harness_mock_write("sem_init_named(count_max)",
+                       &count_max,
+                       sizeof(count_max));
+
+    harness_mock_write("sem_init_named(name_p)",
+                       name_p,
+                       strlen(name_p) + 1);
+
+    harness_mock_write("sem_init_named(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+int __attribute__ ((weak)) STUB(sem_init_named)(struct sem_t *self_p,
+                                                int count,
+                                                int count_max,
+                                                const char *name_p)
+{
+    int res;
+
+    harness_mock_assert("sem_init_named(count)",
+                        &count,
+                        sizeof(count));
+
+    harness_mock_assert("sem_init_named(count_max)",
+                        &count_max,
+                        sizeof(count_max));
+
+    harness_mock_assert("sem_init_named(name_p)",
+                        name_p,
+                        sizeof(*name_p));
+
+    harness_mock_read("sem_init_named(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_sem_take(struct time_t *timeout_p,
                         int res)
 {
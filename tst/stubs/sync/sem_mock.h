@@ -37,6 +37,11 @@ int mock_write_sem_init(int count,
                         int count_max,
                         int res);
 
+int mock_write_sem_init_named(int count,
+                              int count_max,
+                              const char *name_p,
+                              int res);
+
 int mock_write_sem_take(struct time_t *timeout_p,
                         int res);
 
@@ -409,6 +409,134 @@ ssize_t __attribute__ ((weak)) STUB(std_vfprintf)(void *chan_p,
     return (res);
 }
 
+int mock_write_std_fprintf_buffered(void *chan_p,
+                                    char *buf_p,
+                                    size_t size,
+                                    far_string_t fmt_p,
+                                    ssize_t res)
+{
+    harness_mock_write("std_fprintf_buffered(chan_p)",
+                       chan_p,
+                       size);
+
+    harness_mock_write("std_fprintf_buffered(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("std_fprintf_buffered(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("std_fprintf_buffered(fmt_p)",
+                       &fmt_p,
+                       sizeof(fmt_p));
+
+    harness_mock_write("std_fprintf_buffered(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(std_fprintf_buffered)(void *chan_p,
+                                                          char *buf_p,
+                                                          size_t size,
+                                                          far_string_t fmt_p)
+{
+    ssize_t res;
+
+    harness_mock_assert("std_fprintf_buffered(chan_p)",
+                        chan_p,
+                        size);
+
+    harness_mock_assert("std_fprintf_buffered(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("std_fprintf_buffered(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_assert("std_fprintf_buffered(fmt_p)",
+                        &fmt_p,
+                        sizeof(fmt_p));
+
+    harness_mock_read("std_fprintf_buffered(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
+int mock_write_std_vfprintf_buffered(void *chan_p,
+                                     char *buf_p,
+                                     size_t size,
+                                     far_string_t fmt_p,
+                                     va_list *ap_p,
+                                     ssize_t res)
+{
+    harness_mock_write("std_vfprintf_buffered(chan_p)",
+                       chan_p,
+                       size);
+
+    harness_mock_write("std_vfprintf_buffered(buf_p)",
+                       buf_p,
+                       strlen(buf_p) + 1);
+
+    harness_mock_write("std_vfprintf_buffered(size)",
+                       &size,
+                       sizeof(size));
+
+    harness_mock_write("std_vfprintf_buffered(fmt_p)",
+                       &fmt_p,
+                       sizeof(fmt_p));
+
+    harness_mock_write("std_vfprintf_buffered(ap_p)",
+                       ap_p,
+                       sizeof(*ap_p));
+
+    harness_mock_write("std_vfprintf_buffered(): return (res)",
+                       &res,
+                       sizeof(res));
+
+    return (0);
+}
+
+ssize_t __attribute__ ((weak)) STUB(std_vfprintf_buffered)(void *chan_p,
+                                                           char *buf_p,
+                                                           size_t size,
+                                                           far_string_t fmt_p,
+                                                           va_list *ap_p)
+{
+    ssize_t res;
+
+    harness_mock_assert("std_vfprintf_buffered(chan_p)",
+                        chan_p,
+                        size);
+
+    harness_mock_assert("std_vfprintf_buffered(buf_p)",
+                        buf_p,
+                        sizeof(*buf_p));
+
+    harness_mock_assert("std_vfprintf_buffered(size)",
+                        &size,
+                        sizeof(size));
+
+    harness_mock_assert("std_vfprintf_buffered(fmt_p)",
+                        &fmt_p,
+                        sizeof(fmt_p));
+
+    harness_mock_assert("std_vfprintf_buffered(ap_p)",
+                        ap_p,
+                        sizeof(*ap_p));
+
+    harness_mock_read("std_vfprintf_buffered(): return (res)",
+                      &res,
+                      sizeof(res));
+
+    return (res);
+}
+
 int mock_write_std_printf_isr(far_string_t fmt_p,
                               ssize_t res)
 {
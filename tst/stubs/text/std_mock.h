@@ -69,6 +69,19 @@ int mock_write_std_vfprintf(void *chan_p,
                             va_list *ap_p,
                             ssize_t res);
 
+int mock_write_std_fprintf_buffered(void *chan_p,
+                                    char *buf_p,
+                                    size_t size,
+                                    far_string_t fmt_p,
+                                    ssize_t res);
+
+int mock_write_std_vfprintf_buffered(void *chan_p,
+                                     char *buf_p,
+                                     size_t size,
+                                     far_string_t fmt_p,
+                                     va_list *ap_p,
+                                     ssize_t res);
+
 int mock_write_std_printf_isr(far_string_t fmt_p,
                               ssize_t res);
 
@@ -31,6 +31,18 @@
 #define ID_FOO 0x0
 #define ID_BAR 0x1
 
+#if defined(ARCH_LINUX)
+#    define OPERATIONS                                1000000
+#    define FAN_OUT_OPERATIONS                         100000
+#    define FAN_OUT                                        12
+#    define FRAME_SIZE                                   4096
+#else
+#    define OPERATIONS                                  10000
+#    define FAN_OUT_OPERATIONS                           1000
+#    define FAN_OUT                                         4
+#    define FRAME_SIZE                                     64
+#endif
+
 static int test_init(void)
 {
     /* This function may be called multiple times. */
@@ -163,6 +175,263 @@ static int test_multiple_ids(void)
     return (0);
 }
 
+/**
+ * Returns the number of operations per second given the number of
+ * operations and the time they took.
+ */
+static unsigned long operations_per_second(int operations,
+                                           struct time_t *start_p)
+{
+    struct time_t now;
+    struct time_t diff;
+    unsigned long long elapsed_us;
+
+    time_get(&now);
+    time_subtract(&diff, &now, start_p);
+    elapsed_us = (1000000ULL * diff.seconds + diff.nanoseconds / 1000);
+
+    if (elapsed_us == 0) {
+        elapsed_us = 1;
+    }
+
+    return ((unsigned long)((1000000ULL * operations) / elapsed_us));
+}
+
+static int test_hash(void)
+{
+    struct bus_t bus;
+    struct bus_listener_t *buckets[2];
+    struct bus_listener_t chans[5];
+    struct queue_t queues[2];
+    struct event_t event;
+    struct queue_t dummy;
+    char bufs[2][32];
+    int foo;
+    int value;
+    uint32_t bar;
+    uint32_t mask;
+
+    /* Two buckets so that listeners of different ids share buckets. */
+    BTASSERT(bus_init_hash(&bus, &buckets[0], membersof(buckets)) == 0);
+    BTASSERT(queue_init(&queues[0], bufs[0], sizeof(bufs[0])) == 0);
+    BTASSERT(queue_init(&queues[1], bufs[1], sizeof(bufs[1])) == 0);
+    BTASSERT(event_init(&event) == 0);
+    BTASSERT(bus_listener_init(&chans[0], ID_FOO, &queues[0]) == 0);
+    BTASSERT(bus_listener_init(&chans[1], ID_FOO, &queues[1]) == 0);
+    BTASSERT(bus_listener_init(&chans[2], ID_BAR, &event) == 0);
+    BTASSERT(bus_listener_init(&chans[3], 2, &dummy) == 0);
+    BTASSERT(bus_listener_init(&chans[4], 3, &dummy) == 0);
+
+    foo = 5;
+    BTASSERT(bus_write(&bus, ID_FOO, &foo, sizeof(foo)) == 0);
+
+    BTASSERT(bus_attach(&bus, &chans[0]) == 0);
+    BTASSERT(bus_attach(&bus, &chans[3]) == 0);
+    BTASSERT(bus_attach(&bus, &chans[1]) == 0);
+    BTASSERT(bus_attach(&bus, &chans[4]) == 0);
+    BTASSERT(bus_attach(&bus, &chans[2]) == 0);
+
+    /* Only the listeners of the written id receive the message. */
+    BTASSERT(bus_write(&bus, ID_FOO, &foo, sizeof(foo)) == 2);
+    value = 0;
+    BTASSERT(queue_read(&queues[0], &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 5);
+    value = 0;
+    BTASSERT(queue_read(&queues[1], &value, sizeof(value)) == sizeof(value));
+    BTASSERT(value == 5);
+
+    bar = 0x80;
+    BTASSERT(bus_write(&bus, ID_BAR, &bar, sizeof(bar)) == 1);
+    mask = 0xffffffff;
+    BTASSERT(event_read(&event, &mask, sizeof(mask)) == sizeof(mask));
+    BTASSERT(mask == 0x80);
+
+    BTASSERT(bus_write(&bus, 4, &foo, sizeof(foo)) == 0);
+
+    /* Detach all listeners. */
+    BTASSERT(bus_detach(&bus, &chans[1]) == 0);
+    BTASSERT(bus_detach(&bus, &chans[1]) == -1);
+    BTASSERT(bus_write(&bus, ID_FOO, &foo, sizeof(foo)) == 1);
+    BTASSERT(queue_read(&queues[0], &value, sizeof(value)) == sizeof(value));
+    BTASSERT(bus_detach(&bus, &chans[0]) == 0);
+    BTASSERT(bus_detach(&bus, &chans[2]) == 0);
+    BTASSERT(bus_detach(&bus, &chans[3]) == 0);
+    BTASSERT(bus_detach(&bus, &chans[4]) == 0);
+    BTASSERT(bus_write(&bus, ID_FOO, &foo, sizeof(foo)) == 0);
+
+    return (0);
+}
+
+static int test_zero_copy(void)
+{
+    struct bus_t bus;
+    struct bus_listener_t chans[2];
+    struct queue_t queues[2];
+    void *bufs[2][2];
+    struct heap_t heap;
+    uint32_t heap_buf[64];
+    size_t sizes[HEAP_FIXED_SIZES_MAX] = {
+        16, 16, 16, 16, 16, 16, 16, 16
+    };
+    char *buf_p;
+    char *read_buf_p;
+
+    BTASSERT(heap_init(&heap, &heap_buf[0], sizeof(heap_buf), sizes) == 0);
+    BTASSERT(bus_init(&bus) == 0);
+    BTASSERT(queue_init(&queues[0], bufs[0], sizeof(bufs[0])) == 0);
+    BTASSERT(queue_init(&queues[1], bufs[1], sizeof(bufs[1])) == 0);
+    BTASSERT(bus_listener_init(&chans[0], ID_FOO, &queues[0]) == 0);
+    BTASSERT(bus_listener_init(&chans[1], ID_FOO, &queues[1]) == 0);
+
+    /* The buffer is freed at once if there are no listeners. */
+    buf_p = heap_alloc(&heap, 16);
+    BTASSERT(buf_p != NULL);
+    BTASSERT(bus_write_zero_copy(&bus, ID_FOO, &heap, buf_p) == 0);
+    BTASSERT(heap_alloc(&heap, 16) == buf_p);
+
+    /* Both listeners receive a pointer to the same buffer. */
+    BTASSERT(bus_attach(&bus, &chans[0]) == 0);
+    BTASSERT(bus_attach(&bus, &chans[1]) == 0);
+    strcpy(buf_p, "foo");
+    BTASSERT(bus_write_zero_copy(&bus, ID_FOO, &heap, buf_p) == 2);
+
+    BTASSERT(queue_read(&queues[0],
+                        &read_buf_p,
+                        sizeof(read_buf_p)) == sizeof(read_buf_p));
+    BTASSERT(read_buf_p == buf_p);
+    BTASSERT(strcmp(read_buf_p, "foo") == 0);
+    BTASSERT(heap_free(&heap, read_buf_p) == 1);
+
+    BTASSERT(queue_read(&queues[1],
+                        &read_buf_p,
+                        sizeof(read_buf_p)) == sizeof(read_buf_p));
+    BTASSERT(read_buf_p == buf_p);
+
+    /* Freed by the last listener. */
+    BTASSERT(heap_free(&heap, read_buf_p) == 0);
+    BTASSERT(heap_alloc(&heap, 16) == buf_p);
+
+    /* A failed channel write is returned, and the other listener
+       still receives the buffer. */
+    BTASSERT(queue_stop(&queues[1]) == 0);
+    BTASSERT(bus_write_zero_copy(&bus, ID_FOO, &heap, buf_p) == -1);
+    BTASSERT(queue_read(&queues[0],
+                        &read_buf_p,
+                        sizeof(read_buf_p)) == sizeof(read_buf_p));
+    BTASSERT(read_buf_p == buf_p);
+    BTASSERT(heap_free(&heap, read_buf_p) == 0);
+    BTASSERT(heap_alloc(&heap, 16) == buf_p);
+
+    BTASSERT(bus_detach(&bus, &chans[0]) == 0);
+    BTASSERT(bus_detach(&bus, &chans[1]) == 0);
+
+    return (0);
+}
+
+static int test_performance(void)
+{
+    struct bus_t bus;
+    struct bus_listener_t listener;
+    struct time_t start;
+    int value;
+    int i;
+
+    BTASSERT(bus_init(&bus) == 0);
+    BTASSERT(bus_listener_init(&listener, ID_FOO, chan_null()) == 0);
+    BTASSERT(bus_attach(&bus, &listener) == 0);
+
+    value = 0;
+    time_get(&start);
+
+    for (i = 0; i < OPERATIONS; i++) {
+        bus_write(&bus, ID_FOO, &value, sizeof(value));
+    }
+
+    std_printf(OSTR("bus_write: %lu writes per second\r\n"),
+               operations_per_second(OPERATIONS, &start));
+
+    BTASSERT(bus_write(&bus, ID_FOO, &value, sizeof(value)) == 1);
+    BTASSERT(bus_detach(&bus, &listener) == 0);
+
+    return (0);
+}
+
+static int test_fan_out_performance(void)
+{
+    struct bus_t bus;
+    struct bus_listener_t *buckets[16];
+    struct bus_listener_t listeners[FAN_OUT];
+    struct queue_t queues[FAN_OUT];
+    static char queue_bufs[FAN_OUT][2 * FRAME_SIZE];
+    static char frame[FRAME_SIZE];
+    static char read_frame[FRAME_SIZE];
+    struct heap_t heap;
+    static uint32_t heap_buf[FRAME_SIZE / 2];
+    size_t sizes[HEAP_FIXED_SIZES_MAX] = {
+        FRAME_SIZE, FRAME_SIZE, FRAME_SIZE, FRAME_SIZE,
+        FRAME_SIZE, FRAME_SIZE, FRAME_SIZE, FRAME_SIZE
+    };
+    struct time_t start;
+    unsigned long copy_ops;
+    unsigned long zero_copy_ops;
+    void *buf_p;
+    int i;
+    int j;
+
+    BTASSERT(heap_init(&heap, &heap_buf[0], sizeof(heap_buf), sizes) == 0);
+    BTASSERT(bus_init_hash(&bus, &buckets[0], membersof(buckets)) == 0);
+
+    for (i = 0; i < FAN_OUT; i++) {
+        BTASSERT(queue_init(&queues[i],
+                            &queue_bufs[i][0],
+                            sizeof(queue_bufs[i])) == 0);
+        BTASSERT(bus_listener_init(&listeners[i], ID_FOO, &queues[i]) == 0);
+        BTASSERT(bus_attach(&bus, &listeners[i]) == 0);
+    }
+
+    /* The frame is copied into every listener queue. */
+    time_get(&start);
+
+    for (i = 0; i < FAN_OUT_OPERATIONS; i++) {
+        BTASSERT(bus_write(&bus, ID_FOO, &frame[0], sizeof(frame)) == FAN_OUT);
+
+        for (j = 0; j < FAN_OUT; j++) {
+            queue_read(&queues[j], &read_frame[0], sizeof(read_frame));
+        }
+    }
+
+    copy_ops = operations_per_second(FAN_OUT_OPERATIONS, &start);
+
+    /* A pointer to the frame is written to every listener queue. */
+    time_get(&start);
+
+    for (i = 0; i < FAN_OUT_OPERATIONS; i++) {
+        buf_p = heap_alloc(&heap, FRAME_SIZE);
+        BTASSERT(bus_write_zero_copy(&bus, ID_FOO, &heap, buf_p) == FAN_OUT);
+
+        for (j = 0; j < FAN_OUT; j++) {
+            queue_read(&queues[j], &buf_p, sizeof(buf_p));
+            heap_free(&heap, buf_p);
+        }
+    }
+
+    zero_copy_ops = operations_per_second(FAN_OUT_OPERATIONS, &start);
+
+    std_printf(OSTR("fan-out to %d listeners of %d bytes frames:\r\n"
+                    "  bus_write: %lu frames per second\r\n"
+                    "  bus_write_zero_copy: %lu frames per second\r\n"),
+               FAN_OUT,
+               FRAME_SIZE,
+               copy_ops,
+               zero_copy_ops);
+
+    for (i = 0; i < FAN_OUT; i++) {
+        BTASSERT(bus_detach(&bus, &listeners[i]) == 0);
+    }
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -170,6 +439,10 @@ int main()
         { test_attach_detach, "test_attach_detach" },
         { test_write_read, "test_write_read" },
         { test_multiple_ids, "test_multiple_ids" },
+        { test_hash, "test_hash" },
+        { test_zero_copy, "test_zero_copy" },
+        { test_performance, "test_performance" },
+        { test_fan_out_performance, "test_fan_out_performance" },
         { NULL, NULL }
     };
 
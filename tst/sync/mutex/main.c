@@ -47,6 +47,297 @@ static THRD_STACK(t0_stack, 224);
 static THRD_STACK(t1_stack, 224);
 #endif
 
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+
+#if defined(ARCH_ESP32) || defined(ARCH_PPC)
+#    define STACK_SIZE                                    512
+#elif defined(ARCH_ARM64) || defined(ARCH_MIPS)
+#    define STACK_SIZE                                   1024
+#else
+#    define STACK_SIZE                                    224
+#endif
+
+/* A terminated thread's stack is not reused. */
+static THRD_STACK(sem_low_stack, STACK_SIZE);
+static THRD_STACK(sem_medium_stack, STACK_SIZE);
+static THRD_STACK(sem_high_stack, STACK_SIZE);
+static THRD_STACK(mutex_low_stack, STACK_SIZE);
+static THRD_STACK(mutex_medium_stack, STACK_SIZE);
+static THRD_STACK(mutex_high_stack, STACK_SIZE);
+static THRD_STACK(transitive_low_stack, STACK_SIZE);
+static THRD_STACK(transitive_medium_stack, STACK_SIZE);
+static THRD_STACK(transitive_high_stack, STACK_SIZE);
+
+/* Time the medium priority thread keeps the CPU busy. */
+#define MEDIUM_BUSY_US                                  50000
+
+static struct mutex_t mutex_2;
+static struct sem_t mutex_sem;
+static struct sem_t sem;
+static struct sem_t release_sem;
+static int done_order[3];
+static int done_prio[3];
+static int number_of_done;
+static long latency_us;
+
+/**
+ * Lock and unlock given mutex, or binary semaphore, once.
+ */
+static void lock(void *lock_p, int is_mutex)
+{
+    if (is_mutex) {
+        mutex_lock(lock_p);
+    } else {
+        sem_take(lock_p, NULL);
+    }
+}
+
+static void unlock(void *lock_p, int is_mutex)
+{
+    if (is_mutex) {
+        mutex_unlock(lock_p);
+    } else {
+        sem_give(lock_p, 1);
+    }
+}
+
+static void done(int id)
+{
+    done_order[number_of_done++] = id;
+    done_prio[id] = thrd_get_prio();
+}
+
+static void *low_main(void *arg_p)
+{
+    int i;
+
+    lock(arg_p, arg_p == &mutex);
+    sem_give(&release_sem, 1);
+
+    /* Work with the lock held. Other threads are scheduled if they
+       have higher priority. */
+    for (i = 0; i < 10; i++) {
+        thrd_yield();
+    }
+
+    unlock(arg_p, arg_p == &mutex);
+    done(0);
+
+    return (NULL);
+}
+
+static void *medium_main(void *arg_p)
+{
+    int start;
+
+    sem_take(&sem, NULL);
+    start = time_micros();
+
+    while (time_micros_elapsed(start, time_micros()) < MEDIUM_BUSY_US) {
+        thrd_yield();
+    }
+
+    done(1);
+
+    return (NULL);
+}
+
+static void *high_main(void *arg_p)
+{
+    int start;
+
+    /* Wait for the low priority thread to take the lock, then wake up
+       the medium priority thread. */
+    sem_take(&release_sem, NULL);
+    sem_give(&sem, 1);
+    start = time_micros();
+    lock(arg_p, arg_p == &mutex);
+    latency_us = time_micros_elapsed(start, time_micros());
+    unlock(arg_p, arg_p == &mutex);
+    done(2);
+
+    return (NULL);
+}
+
+/**
+ * A high priority thread waits for a lock held by a low priority
+ * thread, while a medium priority thread keeps the CPU busy. Returns
+ * the time the high priority thread waited for the lock.
+ */
+static long measure_latency(void *lock_p,
+                            void *low_stack_p,
+                            void *medium_stack_p,
+                            void *high_stack_p)
+{
+    struct thrd_t *threads[3];
+    int i;
+
+    number_of_done = 0;
+    BTASSERT(sem_init(&sem, 1, 1) == 0);
+    BTASSERT(sem_init(&release_sem, 1, 1) == 0);
+
+    threads[0] = thrd_spawn(high_main,
+                            lock_p,
+                            -10,
+                            high_stack_p,
+                            sizeof(sem_high_stack));
+    threads[1] = thrd_spawn(medium_main,
+                            NULL,
+                            10,
+                            medium_stack_p,
+                            sizeof(sem_medium_stack));
+    threads[2] = thrd_spawn(low_main,
+                            lock_p,
+                            20,
+                            low_stack_p,
+                            sizeof(sem_low_stack));
+
+    for (i = 0; i < 3; i++) {
+        BTASSERT(threads[i] != NULL);
+        BTASSERT(thrd_join(threads[i]) == 0);
+    }
+
+    return (latency_us);
+}
+
+static int test_priority_inversion(void)
+{
+    long with_us;
+    long without_us;
+
+    /* A binary semaphore has no owner and no priority inheritance. */
+    BTASSERT(sem_init(&mutex_sem, 0, 1) == 0);
+    without_us = measure_latency(&mutex_sem,
+                                 sem_low_stack,
+                                 sem_medium_stack,
+                                 sem_high_stack);
+
+    /* The medium priority thread finishes before the high priority
+       thread gets the semaphore. */
+    BTASSERTI(done_order[0], ==, 1);
+
+    BTASSERT(mutex_init(&mutex) == 0);
+    with_us = measure_latency(&mutex,
+                              mutex_low_stack,
+                              mutex_medium_stack,
+                              mutex_high_stack);
+
+    /* The low priority thread inherits the high priority and releases
+       the mutex before the medium priority thread runs. The medium
+       priority thread then runs before the low priority thread. */
+    BTASSERTI(done_order[0], ==, 2);
+    BTASSERTI(done_order[1], ==, 1);
+    BTASSERTI(done_order[2], ==, 0);
+
+    std_printf(OSTR("High priority thread wait time: "
+                    "%ld us without and %ld us with priority "
+                    "inheritance.\r\n"),
+               without_us,
+               with_us);
+
+    BTASSERT(with_us < without_us);
+    BTASSERT(with_us < MEDIUM_BUSY_US);
+
+    return (0);
+}
+
+static void *transitive_low_main(void *arg_p)
+{
+    mutex_lock(&mutex_2);
+    sem_give(&sem, 1);
+    sem_take(&release_sem, NULL);
+    mutex_unlock(&mutex_2);
+    done(0);
+
+    return (NULL);
+}
+
+static void *transitive_medium_main(void *arg_p)
+{
+    mutex_lock(&mutex);
+    mutex_lock(&mutex_2);
+    mutex_unlock(&mutex_2);
+    mutex_unlock(&mutex);
+    done(1);
+
+    return (NULL);
+}
+
+static void *transitive_high_main(void *arg_p)
+{
+    mutex_lock(&mutex);
+    mutex_unlock(&mutex);
+    done(2);
+
+    return (NULL);
+}
+
+static int test_transitive(void)
+{
+    struct thrd_t *low_p;
+    struct thrd_t *medium_p;
+    struct thrd_t *high_p;
+
+    number_of_done = 0;
+    BTASSERT(mutex_init(&mutex) == 0);
+    BTASSERT(mutex_init(&mutex_2) == 0);
+    BTASSERT(sem_init(&sem, 1, 1) == 0);
+    BTASSERT(sem_init(&release_sem, 1, 1) == 0);
+
+    /* The low priority thread locks mutex 2. */
+    low_p = thrd_spawn(transitive_low_main,
+                       NULL,
+                       30,
+                       transitive_low_stack,
+                       sizeof(transitive_low_stack));
+    BTASSERT(low_p != NULL);
+    BTASSERT(sem_take(&sem, NULL) == 0);
+
+    /* The medium priority thread locks mutex 1 and waits for mutex
+       2. */
+    medium_p = thrd_spawn(transitive_medium_main,
+                          NULL,
+                          20,
+                          transitive_medium_stack,
+                          sizeof(transitive_medium_stack));
+    BTASSERT(medium_p != NULL);
+    thrd_sleep_ms(10);
+    BTASSERTI(medium_p->prio, ==, 20);
+    BTASSERTI(low_p->prio, ==, 20);
+
+    /* The high priority thread waits for mutex 1. Both other threads
+       inherit its priority. */
+    high_p = thrd_spawn(transitive_high_main,
+                        NULL,
+                        -10,
+                        transitive_high_stack,
+                        sizeof(transitive_high_stack));
+    BTASSERT(high_p != NULL);
+    thrd_yield();
+    BTASSERTI(medium_p->prio, ==, -10);
+    BTASSERTI(low_p->prio, ==, -10);
+
+    /* Let the low priority thread unlock mutex 2. */
+    BTASSERT(sem_give(&release_sem, 1) == 0);
+
+    BTASSERT(thrd_join(high_p) == 0);
+    BTASSERT(thrd_join(medium_p) == 0);
+    BTASSERT(thrd_join(low_p) == 0);
+
+    BTASSERTI(done_order[0], ==, 2);
+    BTASSERTI(done_order[1], ==, 1);
+    BTASSERTI(done_order[2], ==, 0);
+
+    /* The priorities were restored when the mutexes were
+       unlocked. */
+    BTASSERTI(done_prio[1], ==, 20);
+    BTASSERTI(done_prio[0], ==, 30);
+
+    return (0);
+}
+
+#endif
+
 static void *mutex_main(void *arg_p)
 {
     int i;
@@ -114,6 +405,10 @@ int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_multi_thread, "test_multi_thread" },
+#if CONFIG_MUTEX_PRIORITY_INHERITANCE == 1
+        { test_priority_inversion, "test_priority_inversion" },
+        { test_transitive, "test_transitive" },
+#endif
         { NULL, NULL }
     };
 
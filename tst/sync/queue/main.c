@@ -32,13 +32,27 @@ static struct queue_t queue[2];
 static struct queue_t buffered_queue;
 static char buffer[8];
 static struct event_t event;
+static struct queue_t reserve_queue;
+static char reserve_buffer[8];
+static char reserve_read_buffer[4];
+static struct queue_t peek_queue;
+
+#if defined(ARCH_LINUX)
+#    define PERFORMANCE_SIZE                 (1024ULL * 1024 * 1024)
+#    define PERFORMANCE_CHUNK_SIZE                            1024
+#else
+#    define PERFORMANCE_SIZE                          (64ULL * 1024)
+#    define PERFORMANCE_CHUNK_SIZE                              32
+#endif
 
 #if defined(ARCH_ARM64)
 static THRD_STACK(t0_stack, 1024);
 static THRD_STACK(t1_stack, 1024);
+static THRD_STACK(t2_stack, 1024);
 #else
 static THRD_STACK(t0_stack, 512);
 static THRD_STACK(t1_stack, 512);
+static THRD_STACK(t2_stack, 512);
 #endif
 
 static void *t0_main(void *arg_p)
@@ -180,6 +194,24 @@ static void *t1_main(void *arg_p)
     return (0);
 }
 
+static void *t2_main(void *arg_p)
+{
+    thrd_set_name("t2");
+
+    /* Test: test_reserve_commit. */
+    BTASSERTN(queue_read(&reserve_queue,
+                         &reserve_read_buffer[0],
+                         sizeof(reserve_read_buffer))
+              == sizeof(reserve_read_buffer));
+
+    /* Test: test_peek. */
+    BTASSERTN(queue_write(&peek_queue, "wxyz", 4) == 4);
+
+    thrd_suspend(NULL);
+
+    return (0);
+}
+
 static int test_init(void)
 {
     BTASSERT(queue_init(&queue[0], NULL, 0) == 0);
@@ -548,6 +580,166 @@ static int test_read_write_zero(void)
     return (0);
 }
 
+static int test_reserve_commit(void)
+{
+    void *buf_p;
+    char data[8];
+
+    BTASSERT(queue_init(&reserve_queue,
+                        &reserve_buffer[0],
+                        sizeof(reserve_buffer)) == 0);
+    BTASSERT(queue_init(&peek_queue, NULL, 0) == 0);
+
+    /* Write four bytes directly into the queue buffer. */
+    BTASSERTI(queue_reserve(&reserve_queue, &buf_p, 8), ==, 7);
+    memcpy(buf_p, "abcd", 4);
+    BTASSERTI(queue_commit(&reserve_queue, 4), ==, 4);
+    BTASSERTI(queue_size(&reserve_queue), ==, 4);
+    BTASSERTI(queue_read(&reserve_queue, &data[0], 4), ==, 4);
+    BTASSERTM(&data[0], "abcd", 4);
+
+    /* Only the space up to the end of the buffer is reserved. */
+    BTASSERTI(queue_reserve(&reserve_queue, &buf_p, 8), ==, 4);
+    BTASSERT(buf_p == &reserve_buffer[4]);
+    memcpy(buf_p, "ef", 2);
+    BTASSERTI(queue_commit(&reserve_queue, 2), ==, 2);
+    BTASSERTI(queue_read(&reserve_queue, &data[0], 2), ==, 2);
+    BTASSERTM(&data[0], "ef", 2);
+
+    /* A reader waiting for data is given the committed data. */
+    BTASSERT(thrd_spawn(t2_main,
+                        NULL,
+                        -1,
+                        t2_stack,
+                        sizeof(t2_stack)) != NULL);
+    BTASSERTI(queue_reserve(&reserve_queue, &buf_p, 4), ==, 2);
+    memcpy(buf_p, "gh", 2);
+    BTASSERTI(queue_commit(&reserve_queue, 2), ==, 2);
+    BTASSERTI(queue_reserve(&reserve_queue, &buf_p, 4), ==, 4);
+    BTASSERT(buf_p == &reserve_buffer[0]);
+    memcpy(buf_p, "ijkl", 4);
+    BTASSERTI(queue_commit(&reserve_queue, 4), ==, 4);
+    thrd_yield();
+    BTASSERTM(&reserve_read_buffer[0], "ghij", 4);
+    BTASSERTI(queue_read(&reserve_queue, &data[0], 2), ==, 2);
+    BTASSERTM(&data[0], "kl", 2);
+
+    /* Nothing can be reserved in or committed to a stopped queue. */
+    BTASSERTI(queue_reserve(&reserve_queue, &buf_p, 4), ==, 4);
+    BTASSERTI(queue_stop(&reserve_queue), ==, 0);
+    BTASSERTI(queue_reserve(&reserve_queue, &buf_p, 4), ==, -1);
+    BTASSERTI(queue_commit(&reserve_queue, 4), ==, -1);
+    BTASSERTI(queue_size(&reserve_queue), ==, 0);
+
+    return (0);
+}
+
+static int test_peek(void)
+{
+    struct queue_t foo;
+    char foo_buffer[8];
+    void *buf_p;
+
+    BTASSERT(queue_init(&foo, &foo_buffer[0], sizeof(foo_buffer)) == 0);
+
+    /* Peek at an empty queue. */
+    BTASSERTI(queue_peek(&foo, &buf_p, 8), ==, 0);
+
+    /* Peek at written data and remove some of it. */
+    BTASSERTI(queue_write(&foo, "12345", 5), ==, 5);
+    BTASSERTI(queue_peek(&foo, &buf_p, 8), ==, 5);
+    BTASSERTM(buf_p, "12345", 5);
+    BTASSERTI(queue_ignore(&foo, 3), ==, 3);
+    BTASSERTI(queue_peek(&foo, &buf_p, 1), ==, 1);
+    BTASSERTM(buf_p, "4", 1);
+
+    /* Data that wraps around is peeked at in two steps. */
+    BTASSERTI(queue_write(&foo, "6789a", 5), ==, 5);
+    BTASSERTI(queue_peek(&foo, &buf_p, 8), ==, 5);
+    BTASSERTM(buf_p, "45678", 5);
+    BTASSERTI(queue_ignore(&foo, 5), ==, 5);
+    BTASSERTI(queue_peek(&foo, &buf_p, 8), ==, 2);
+    BTASSERTM(buf_p, "9a", 2);
+    BTASSERTI(queue_ignore(&foo, 2), ==, 2);
+    BTASSERTI(queue_peek(&foo, &buf_p, 8), ==, 0);
+
+    /* Peek at the data of a blocked writer. Thread t2 is blocked
+       writing to the peek queue. */
+    BTASSERTI(queue_peek(&peek_queue, &buf_p, 8), ==, 4);
+    BTASSERTM(buf_p, "wxyz", 4);
+    BTASSERTI(queue_ignore(&peek_queue, 4), ==, 4);
+    BTASSERTI(queue_peek(&peek_queue, &buf_p, 8), ==, 0);
+
+    return (0);
+}
+
+static int test_performance(void)
+{
+    struct queue_t foo;
+    static char foo_buffer[8 * PERFORMANCE_CHUNK_SIZE];
+    char chunk[PERFORMANCE_CHUNK_SIZE];
+    struct time_t start;
+    struct time_t now;
+    struct time_t diff;
+    unsigned long long copy_us;
+    unsigned long long zero_copy_us;
+    unsigned long long i;
+    ssize_t size;
+    char *buf_p;
+    unsigned int copy_sum;
+    unsigned int zero_copy_sum;
+
+    BTASSERT(queue_init(&foo, &foo_buffer[0], sizeof(foo_buffer)) == 0);
+
+    /* The producer stages data in a buffer that is copied into the
+       queue, and the consumer copies it out of the queue. */
+    copy_sum = 0;
+    time_get(&start);
+
+    for (i = 0; i < PERFORMANCE_SIZE; i += sizeof(chunk)) {
+        memset(&chunk[0], i, sizeof(chunk));
+        queue_write(&foo, &chunk[0], sizeof(chunk));
+        queue_read(&foo, &chunk[0], sizeof(chunk));
+        copy_sum += chunk[sizeof(chunk) - 1];
+    }
+
+    time_get(&now);
+    time_subtract(&diff, &now, &start);
+    copy_us = (1000000ULL * diff.seconds + diff.nanoseconds / 1000);
+
+    /* The producer writes directly into the queue, and the consumer
+       reads directly from it. */
+    zero_copy_sum = 0;
+    time_get(&start);
+
+    for (i = 0; i < PERFORMANCE_SIZE; i += size) {
+        size = queue_reserve(&foo, (void **)&buf_p, PERFORMANCE_CHUNK_SIZE);
+
+        memset(buf_p, i, size);
+        queue_commit(&foo, size);
+        queue_peek(&foo, (void **)&buf_p, size);
+        zero_copy_sum += buf_p[size - 1];
+
+        queue_ignore(&foo, size);
+    }
+
+    time_get(&now);
+    time_subtract(&diff, &now, &start);
+    zero_copy_us = (1000000ULL * diff.seconds + diff.nanoseconds / 1000);
+
+    std_printf(OSTR("write and read: %lu bytes per second\r\n"
+                    "reserve, commit, peek and ignore: "
+                    "%lu bytes per second\r\n"),
+               (unsigned long)((1000000ULL * PERFORMANCE_SIZE)
+                               / (copy_us + 1)),
+               (unsigned long)((1000000ULL * PERFORMANCE_SIZE)
+                               / (zero_copy_us + 1)));
+
+    BTASSERTI(zero_copy_sum, ==, copy_sum);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
@@ -562,6 +754,9 @@ int main()
         { test_non_blocking, "test_non_blocking" },
         { test_ignore, "test_ignore" },
         { test_read_write_zero, "test_read_write_zero" },
+        { test_reserve_commit, "test_reserve_commit" },
+        { test_peek, "test_peek" },
+        { test_performance, "test_performance" },
         { NULL, NULL }
     };
 
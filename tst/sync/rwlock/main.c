@@ -28,23 +28,40 @@
 
 #include "simba.h"
 
+#if defined(ARCH_LINUX)
+#    define OPERATIONS                                1000000
+#else
+#    define OPERATIONS                                  10000
+#endif
+
 #if defined(ARCH_ARM64)
 static THRD_STACK(writer_0_stack, 1024);
 static THRD_STACK(writer_1_stack, 1024);
 static THRD_STACK(writer_2_stack, 1024);
 static THRD_STACK(reader_0_stack, 1024);
 static THRD_STACK(reader_1_stack, 1024);
+static THRD_STACK(fairness_0_stack, 1024);
+static THRD_STACK(fairness_1_stack, 1024);
+static THRD_STACK(fairness_2_stack, 1024);
+static THRD_STACK(fairness_3_stack, 1024);
 #else
 static THRD_STACK(writer_0_stack, 512);
 static THRD_STACK(writer_1_stack, 512);
 static THRD_STACK(writer_2_stack, 512);
 static THRD_STACK(reader_0_stack, 512);
 static THRD_STACK(reader_1_stack, 512);
+static THRD_STACK(fairness_0_stack, 512);
+static THRD_STACK(fairness_1_stack, 512);
+static THRD_STACK(fairness_2_stack, 512);
+static THRD_STACK(fairness_3_stack, 512);
 #endif
 
 
 static volatile int count;
 struct rwlock_t count_lock;
+static struct rwlock_t fairness_lock;
+static int order[2];
+static int order_length;
 
 static void *writer_main(void *arg_p)
 {
@@ -76,6 +93,46 @@ static void *reader_main(void *arg_p)
     return (NULL);
 }
 
+static void *fairness_reader_main(void *arg_p)
+{
+    rwlock_reader_take(&fairness_lock);
+    order[order_length++] = (int)(uintptr_t)arg_p;
+    rwlock_reader_give(&fairness_lock);
+
+    return (NULL);
+}
+
+static void *fairness_writer_main(void *arg_p)
+{
+    rwlock_writer_take(&fairness_lock);
+    order[order_length++] = (int)(uintptr_t)arg_p;
+    rwlock_writer_give(&fairness_lock);
+
+    return (NULL);
+}
+
+/**
+ * Returns the number of operations per second given the number of
+ * operations and the time they took.
+ */
+static unsigned long operations_per_second(int operations,
+                                           struct time_t *start_p)
+{
+    struct time_t now;
+    struct time_t diff;
+    unsigned long long elapsed_us;
+
+    time_get(&now);
+    time_subtract(&diff, &now, start_p);
+    elapsed_us = (1000000ULL * diff.seconds + diff.nanoseconds / 1000);
+
+    if (elapsed_us == 0) {
+        elapsed_us = 1;
+    }
+
+    return ((unsigned long)((1000000ULL * operations) / elapsed_us));
+}
+
 static int test_one_thread(void)
 {
     struct rwlock_t foo;
@@ -137,11 +194,128 @@ static int test_multi_thread(void)
     return (0);
 }
 
+static int test_writer_not_starved(void)
+{
+    struct thrd_t *writer_p;
+    struct thrd_t *reader_p;
+
+    BTASSERT(rwlock_init(&fairness_lock) == 0);
+    order_length = 0;
+
+    BTASSERT(rwlock_reader_take(&fairness_lock) == 0);
+
+    /* The writer waits for the reader. */
+    BTASSERT((writer_p = thrd_spawn(fairness_writer_main,
+                                    (void *)1,
+                                    0,
+                                    fairness_0_stack,
+                                    sizeof(fairness_0_stack))) != NULL);
+    thrd_sleep_ms(10);
+
+    /* New readers wait for the waiting writer. */
+    BTASSERT((reader_p = thrd_spawn(fairness_reader_main,
+                                    (void *)2,
+                                    0,
+                                    fairness_1_stack,
+                                    sizeof(fairness_1_stack))) != NULL);
+    thrd_sleep_ms(10);
+    BTASSERTI(order_length, ==, 0);
+
+    BTASSERT(rwlock_reader_give(&fairness_lock) == 0);
+
+    thrd_join(writer_p);
+    thrd_join(reader_p);
+
+    BTASSERTI(order_length, ==, 2);
+    BTASSERTI(order[0], ==, 1);
+    BTASSERTI(order[1], ==, 2);
+
+    return (0);
+}
+
+static int test_reader_not_starved(void)
+{
+    struct thrd_t *writer_p;
+    struct thrd_t *reader_p;
+
+    BTASSERT(rwlock_init(&fairness_lock) == 0);
+    order_length = 0;
+
+    BTASSERT(rwlock_writer_take(&fairness_lock) == 0);
+
+    /* A reader and then a writer wait for the writer. */
+    BTASSERT((reader_p = thrd_spawn(fairness_reader_main,
+                                    (void *)1,
+                                    0,
+                                    fairness_2_stack,
+                                    sizeof(fairness_2_stack))) != NULL);
+    thrd_sleep_ms(10);
+    BTASSERT((writer_p = thrd_spawn(fairness_writer_main,
+                                    (void *)2,
+                                    0,
+                                    fairness_3_stack,
+                                    sizeof(fairness_3_stack))) != NULL);
+    thrd_sleep_ms(10);
+    BTASSERTI(order_length, ==, 0);
+
+    /* The waiting reader gets the lock before the waiting writer. */
+    BTASSERT(rwlock_writer_give(&fairness_lock) == 0);
+
+    thrd_join(reader_p);
+    thrd_join(writer_p);
+
+    BTASSERTI(order_length, ==, 2);
+    BTASSERTI(order[0], ==, 1);
+    BTASSERTI(order[1], ==, 2);
+
+    return (0);
+}
+
+static int test_performance(void)
+{
+    struct rwlock_t foo;
+    struct time_t start;
+    unsigned long reader_ops;
+    unsigned long writer_ops;
+    int i;
+
+    BTASSERT(rwlock_init(&foo) == 0);
+
+    time_get(&start);
+
+    for (i = 0; i < OPERATIONS; i++) {
+        rwlock_reader_take(&foo);
+        rwlock_reader_give(&foo);
+    }
+
+    reader_ops = operations_per_second(2 * OPERATIONS, &start);
+    time_get(&start);
+
+    for (i = 0; i < OPERATIONS; i++) {
+        rwlock_writer_take(&foo);
+        rwlock_writer_give(&foo);
+    }
+
+    writer_ops = operations_per_second(2 * OPERATIONS, &start);
+
+    std_printf(OSTR("reader: %lu operations per second\r\n"
+                    "writer: %lu operations per second\r\n"),
+               reader_ops,
+               writer_ops);
+
+    BTASSERTI(foo.state, ==, 0);
+
+    return (0);
+}
+
 int main()
 {
     struct harness_testcase_t testcases[] = {
         { test_one_thread, "test_one_thread" },
         { test_multi_thread, "test_multi_thread" },
+        { test_writer_not_starved, "test_writer_not_starved" },
+        { test_reader_not_starved, "test_reader_not_starved" },
+        { test_performance, "test_performance" },
         { NULL, NULL }
     };
 
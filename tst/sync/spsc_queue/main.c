@@ -0,0 +1,283 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2018, Erik Moqvist
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * This file is part of the Simba project.
+ */
+
+#include "simba.h"
+
+#if defined(ARCH_LINUX)
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+
+#if defined(ARCH_LINUX)
+#    define PERFORMANCE_SIZE                         (64 * 1024 * 1024)
+#endif
+
+#define PERFORMANCE_CHUNK_SIZE                                      64
+
+static struct spsc_queue_t foo;
+static char foo_buffer[16];
+
+#if defined(ARCH_ARM64)
+static THRD_STACK(t0_stack, 1024);
+#else
+static THRD_STACK(t0_stack, 512);
+#endif
+
+static void *t0_main(void *arg_p)
+{
+    thrd_set_name("t0");
+
+    /* Test: test_read_write. */
+    thrd_sleep_ms(10);
+    BTASSERTN(spsc_queue_write(&foo, "abc", 3) == 3);
+    thrd_sleep_ms(10);
+    BTASSERTN(spsc_queue_write(&foo, "defgh", 5) == 5);
+
+    /* Test: test_poll. */
+    thrd_sleep_ms(10);
+    BTASSERTN(spsc_queue_write(&foo, "i", 1) == 1);
+
+    thrd_suspend(NULL);
+
+    return (NULL);
+}
+
+static int test_init(void)
+{
+    BTASSERT(spsc_queue_init(&foo, &foo_buffer[0], sizeof(foo_buffer)) == 0);
+    BTASSERT(thrd_spawn(t0_main,
+                        NULL,
+                        1,
+                        t0_stack,
+                        sizeof(t0_stack)) != NULL);
+
+    return (0);
+}
+
+static int test_read_write(void)
+{
+    char buf[8];
+
+    /* Wait for data written by thread t0 in two parts. */
+    BTASSERTI(spsc_queue_read(&foo, &buf[0], 8), ==, 8);
+    BTASSERTM(&buf[0], "abcdefgh", 8);
+    BTASSERTI(spsc_queue_size(&foo), ==, 0);
+
+    return (0);
+}
+
+static int test_poll(void)
+{
+    struct chan_list_t list;
+    struct chan_list_elem_t elements[2];
+    struct queue_t bar;
+    char buf[1];
+
+    BTASSERT(queue_init(&bar, NULL, 0) == 0);
+    BTASSERT(chan_list_init(&list, &elements[0], membersof(elements)) == 0);
+    BTASSERT(chan_list_add(&list, &bar) == 0);
+    BTASSERT(chan_list_add(&list, &foo) == 0);
+
+    /* Wait for data written by thread t0. */
+    BTASSERT(chan_list_poll(&list, NULL) == &foo);
+    BTASSERTI(chan_read(&foo, &buf[0], 1), ==, 1);
+    BTASSERTM(&buf[0], "i", 1);
+
+    BTASSERT(chan_list_destroy(&list) == 0);
+
+    return (0);
+}
+
+static int test_write_isr(void)
+{
+    char buf[16];
+
+    sys_lock();
+    BTASSERTI(spsc_queue_write_isr(&foo, "0123456789abcdefg", 17), ==, 16);
+    sys_unlock();
+
+    BTASSERTI(spsc_queue_size(&foo), ==, 16);
+    BTASSERTI(spsc_queue_unused_size(&foo), ==, 0);
+    BTASSERTI(chan_read(&foo, &buf[0], 16), ==, 16);
+    BTASSERTM(&buf[0], "0123456789abcdef", 16);
+
+    return (0);
+}
+
+static int test_non_blocking_read(void)
+{
+    char buf[4];
+
+    BTASSERTI(chan_control(&foo, CHAN_CONTROL_NON_BLOCKING_READ), ==, 0);
+    BTASSERTI(spsc_queue_read(&foo, &buf[0], 4), ==, 0);
+    BTASSERTI(spsc_queue_write(&foo, "jk", 2), ==, 2);
+    BTASSERTI(spsc_queue_read(&foo, &buf[0], 4), ==, 2);
+    BTASSERTM(&buf[0], "jk", 2);
+    BTASSERTI(chan_control(&foo, CHAN_CONTROL_BLOCKING_READ), ==, 0);
+
+    return (0);
+}
+
+#if defined(ARCH_LINUX)
+
+static struct queue_t performance_queue;
+static struct spsc_queue_t performance_spsc_queue;
+static char performance_buffer[1024];
+
+/**
+ * Write to the queue the same way as the Linux UART receive path did
+ * before using the lock-free queue.
+ */
+static void *queue_producer_main(void *arg_p)
+{
+    char chunk[PERFORMANCE_CHUNK_SIZE];
+    size_t size;
+    size_t n;
+
+    memset(&chunk[0], 0, sizeof(chunk));
+
+    for (size = 0; size < PERFORMANCE_SIZE; size += n) {
+        sys_lock();
+        n = queue_write_isr(&performance_queue, &chunk[0], sizeof(chunk));
+        sys_unlock();
+
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+
+    return (NULL);
+}
+
+static void *spsc_queue_producer_main(void *arg_p)
+{
+    char chunk[PERFORMANCE_CHUNK_SIZE];
+    size_t size;
+    size_t n;
+
+    memset(&chunk[0], 0, sizeof(chunk));
+
+    for (size = 0; size < PERFORMANCE_SIZE; size += n) {
+        n = spsc_queue_write(&performance_spsc_queue,
+                             &chunk[0],
+                             sizeof(chunk));
+
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+
+    return (NULL);
+}
+
+static unsigned long bytes_per_second(struct time_t *start_p)
+{
+    struct time_t now;
+    struct time_t diff;
+    unsigned long long us;
+
+    time_get(&now);
+    time_subtract(&diff, &now, start_p);
+    us = (1000000ULL * diff.seconds + diff.nanoseconds / 1000);
+
+    return ((unsigned long)((1000000ULL * PERFORMANCE_SIZE) / (us + 1)));
+}
+
+static int test_performance(void)
+{
+    pthread_t thrd;
+    struct time_t start;
+    char buf[PERFORMANCE_CHUNK_SIZE];
+    size_t size;
+    unsigned long queue_rate;
+    unsigned long spsc_queue_rate;
+
+    /* A producer outside the scheduler, like the Linux socket device
+       thread, writing to a queue read by a thread. */
+    BTASSERT(queue_init(&performance_queue,
+                        &performance_buffer[0],
+                        sizeof(performance_buffer)) == 0);
+    time_get(&start);
+    BTASSERT(pthread_create(&thrd, NULL, queue_producer_main, NULL) == 0);
+
+    for (size = 0; size < PERFORMANCE_SIZE; size += sizeof(buf)) {
+        BTASSERTI(queue_read(&performance_queue, &buf[0], sizeof(buf)),
+                  ==,
+                  sizeof(buf));
+    }
+
+    queue_rate = bytes_per_second(&start);
+    BTASSERT(pthread_join(thrd, NULL) == 0);
+
+    BTASSERT(spsc_queue_init(&performance_spsc_queue,
+                             &performance_buffer[0],
+                             sizeof(performance_buffer)) == 0);
+    time_get(&start);
+    BTASSERT(pthread_create(&thrd, NULL, spsc_queue_producer_main, NULL) == 0);
+
+    for (size = 0; size < PERFORMANCE_SIZE; size += sizeof(buf)) {
+        BTASSERTI(spsc_queue_read(&performance_spsc_queue,
+                                  &buf[0],
+                                  sizeof(buf)),
+                  ==,
+                  sizeof(buf));
+    }
+
+    spsc_queue_rate = bytes_per_second(&start);
+    BTASSERT(pthread_join(thrd, NULL) == 0);
+
+    std_printf(OSTR("queue_t: %lu bytes per second\r\n"
+                    "spsc_queue_t: %lu bytes per second\r\n"),
+               queue_rate,
+               spsc_queue_rate);
+
+    return (0);
+}
+
+#endif
+
+int main()
+{
+    struct harness_testcase_t testcases[] = {
+        { test_init, "test_init" },
+        { test_read_write, "test_read_write" },
+        { test_poll, "test_poll" },
+        { test_write_isr, "test_write_isr" },
+        { test_non_blocking_read, "test_non_blocking_read" },
+#if defined(ARCH_LINUX)
+        { test_performance, "test_performance" },
+#endif
+        { NULL, NULL }
+    };
+
+    sys_start();
+
+    harness_run(testcases);
+
+    return (0);
+}
@@ -168,6 +168,136 @@ static int test_snprintf(void)
     return (0);
 }
 
+static int test_sprintf_integers(void)
+{
+    char buf[64];
+    ssize_t size;
+
+    size = std_sprintf(&buf[0],
+                       FSTR("%d %d %d %d %d %d %u"),
+                       0, 9, 10, 99, 100, -1000, 12345U);
+    BTASSERTI(size, ==, 25);
+    BTASSERTM(&buf[0], "0 9 10 99 100 -1000 12345", size + 1);
+
+    size = std_sprintf(&buf[0],
+                       FSTR("%ld %ld %lu"),
+                       -2147483647L - 1, 1000000001L, 3000000000UL);
+    BTASSERTI(size, ==, 33);
+    BTASSERTM(&buf[0], "-2147483648 1000000001 3000000000", size + 1);
+
+    size = std_sprintf(&buf[0],
+                       FSTR("%x %04x %-4x| %lx"),
+                       0, 0xab, 0xc, 0x12345678L);
+    BTASSERTI(size, ==, 21);
+    BTASSERTM(&buf[0], "0 00ab c   | 12345678", size + 1);
+
+    return (0);
+}
+
+static int test_fprintf_buffered(void)
+{
+    struct queue_t queue;
+    char queue_buf[128];
+    char buf[16];
+    char output[64];
+    ssize_t size;
+
+    BTASSERT(queue_init(&queue, &queue_buf[0], sizeof(queue_buf)) == 0);
+
+    /* Output bigger than the buffer. */
+    size = std_fprintf_buffered(&queue,
+                                &buf[0],
+                                sizeof(buf),
+                                FSTR("Formatted %d%s to a queue.\r\n"),
+                                42,
+                                " characters");
+    BTASSERTI(size, ==, 37);
+    BTASSERTI(queue_read(&queue, &output[0], size), ==, size);
+    BTASSERTM(&output[0], "Formatted 42 characters to a queue.\r\n", size);
+
+    /* A single character buffer. */
+    size = std_fprintf_buffered(&queue, &buf[0], 1, FSTR("%s"), "foo");
+    BTASSERTI(size, ==, 3);
+    BTASSERTI(queue_read(&queue, &output[0], size), ==, size);
+    BTASSERTM(&output[0], "foo", size);
+
+    return (0);
+}
+
+static int test_performance(void)
+{
+    char buf[128];
+    int start;
+    int i;
+    long us;
+
+    start = time_micros();
+
+    for (i = 0; i < 1000; i++) {
+        BTASSERT(std_snprintf(&buf[0],
+                              sizeof(buf),
+                              FSTR("%lu.%03lu:%s:%s:%s: Temperature is %d "
+                                   "and the counter 0x%08lx.\r\n"),
+                              123456UL,
+                              789UL,
+                              "info",
+                              "main",
+                              "sensor",
+                              -23,
+                              0xdeadbeefUL) > 0);
+    }
+
+    us = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Formatted 1000 log lines with std_snprintf() "
+                    "in %ld us.\r\n"),
+               us);
+
+    start = time_micros();
+
+    for (i = 0; i < 1000; i++) {
+        BTASSERT(std_fprintf_buffered(chan_null(),
+                                      &buf[0],
+                                      sizeof(buf),
+                                      FSTR("%lu.%03lu:%s:%s:%s: Temperature "
+                                           "is %d and the counter 0x%08lx."
+                                           "\r\n"),
+                                      123456UL,
+                                      789UL,
+                                      "info",
+                                      "main",
+                                      "sensor",
+                                      -23,
+                                      0xdeadbeefUL) > 0);
+    }
+
+    us = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Formatted 1000 log lines with std_fprintf_buffered() "
+                    "in %ld us.\r\n"),
+               us);
+
+    start = time_micros();
+
+    for (i = 0; i < 1000; i++) {
+        BTASSERT(std_fprintf(chan_null(),
+                             FSTR("%lu.%03lu:%s:%s:%s: Temperature is %d "
+                                  "and the counter 0x%08lx.\r\n"),
+                             123456UL,
+                             789UL,
+                             "info",
+                             "main",
+                             "sensor",
+                             -23,
+                             0xdeadbeefUL) > 0);
+    }
+
+    us = time_micros_elapsed(start, time_micros());
+    std_printf(OSTR("Formatted 1000 log lines with std_fprintf() "
+                    "in %ld us.\r\n"),
+               us);
+
+    return (0);
+}
+
 static int test_vprintf(void)
 {
     BTASSERT(test_vprintf_wrapper(FSTR("vprintf: %i\r\n"), 1) == 12);
@@ -750,6 +880,9 @@ int main()
         { test_strtodfp, "test_strtodfp" },
         { test_hexdump, "test_hexdump" },
         { test_printf_isr, "test_printf_isr" },
+        { test_sprintf_integers, "test_sprintf_integers" },
+        { test_fprintf_buffered, "test_fprintf_buffered" },
+        { test_performance, "test_performance" },
         { NULL, NULL }
     };
 